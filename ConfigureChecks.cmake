@@ -21,6 +21,8 @@ check_include_files("sys/types.h;ifaddrs.h" HAVE_IFADDRS_H)
 check_include_file("netinet/in.h"           HAVE_NETINET_IN_H)
 check_include_file("netdb.h"                HAVE_NETDB_H)
 check_include_file("pwd.h"                  HAVE_PWD_H)
+check_include_file("sys/mman.h"             HAVE_SYS_MMAN_H)
+check_include_file("sys/sdt.h"              HAVE_SYS_SDT_H)
 check_include_file("sys/select.h"           HAVE_SYS_SELECT_H)
 check_include_file("sys/socket.h"           HAVE_SYS_SOCKET_H)
 check_include_file("sys/time.h"             HAVE_SYS_TIME_H)
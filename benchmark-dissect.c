@@ -0,0 +1,477 @@
+/* benchmark-dissect.c
+ * Replays capture files through epan_dissect_run() to measure
+ * end-to-end dissection throughput.
+ *
+ * Every file is loaded into memory first, then dissected in all four
+ * combinations of protocol tree and column generation, with a warmup
+ * pass and several timed repetitions per combination, so runs are
+ * comparable and not bounded by file I/O.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <locale.h>
+#include <string.h>
+#include <errno.h>
+
+#include <glib.h>
+
+/*
+ * If we have getopt_long() in the system library, include <getopt.h>.
+ * Otherwise, we're using our own getopt_long() (either because the
+ * system has getopt() but not getopt_long(), as with some UN*Xes,
+ * or because it doesn't even have getopt(), as with Windows), so
+ * include our getopt_long()'s header.
+ */
+#ifdef HAVE_GETOPT_LONG
+#include <getopt.h>
+#else
+#include <wsutil/wsgetopt.h>
+#endif
+
+#include <epan/epan.h>
+#include <epan/epan_dissect.h>
+#include <epan/column.h>
+#include <epan/column-info.h>
+#include <epan/column-utils.h>
+#include <epan/frame_data.h>
+#include <epan/prefs.h>
+#include <epan/timestamp.h>
+#include <epan/tvbuff.h>
+
+#include <wsutil/buffer.h>
+#include <wsutil/filesystem.h>
+#include <wsutil/privileges.h>
+#include <wsutil/report_message.h>
+#include <wsutil/wslog.h>
+
+#include <wiretap/wtap.h>
+
+#include "ui/cmdarg_err.h"
+#include "ui/failure_message.h"
+
+/* A packet record held in memory for replay. */
+typedef struct {
+	wtap_rec rec;
+	Buffer buf;
+} replay_record_t;
+
+static const struct {
+	const char *name;
+	gboolean tree;
+	gboolean columns;
+} modes[] = {
+	{ "no-tree/no-columns", FALSE, FALSE },
+	{ "no-tree/columns",    FALSE, TRUE  },
+	{ "tree/no-columns",    TRUE,  FALSE },
+	{ "tree/columns",       TRUE,  TRUE  }
+};
+
+static void
+benchmark_cmdarg_err(const char *fmt, va_list ap)
+{
+	fprintf(stderr, "benchmark-dissect: ");
+	vfprintf(stderr, fmt, ap);
+	fprintf(stderr, "\n");
+}
+
+static void
+benchmark_cmdarg_err_cont(const char *fmt, va_list ap)
+{
+	vfprintf(stderr, fmt, ap);
+	fprintf(stderr, "\n");
+}
+
+static void
+print_usage(FILE *output)
+{
+	fprintf(output, "Usage: benchmark-dissect [options] <infile|indir> ...\n");
+	fprintf(output, "\n");
+	fprintf(output, "Options:\n");
+	fprintf(output, "  -n <count>    timed repetitions per mode (default 5)\n");
+	fprintf(output, "  -w <count>    warmup repetitions per mode (default 1)\n");
+	fprintf(output, "  -h            display this help and exit\n");
+}
+
+/*
+ * Read every packet record of a capture into memory.  Returns NULL and
+ * reports the error if the file can't be opened or read.
+ */
+static GArray *
+load_records(const char *path, int *file_type_subtype, guint64 *data_bytes)
+{
+	wtap *wth;
+	GArray *records;
+	int err = 0;
+	gchar *err_info = NULL;
+	gint64 data_offset;
+	guint i;
+
+	wth = wtap_open_offline(path, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+	if (wth == NULL) {
+		cfile_open_failure_message(path, err, err_info);
+		return NULL;
+	}
+
+	records = g_array_new(FALSE, FALSE, sizeof(replay_record_t));
+	*data_bytes = 0;
+
+	for (;;) {
+		replay_record_t r;
+
+		wtap_rec_init(&r.rec);
+		ws_buffer_init(&r.buf, 1514);
+		if (!wtap_read(wth, &r.rec, &r.buf, &err, &err_info, &data_offset)) {
+			wtap_rec_cleanup(&r.rec);
+			ws_buffer_free(&r.buf);
+			break;
+		}
+		if (r.rec.rec_type != REC_TYPE_PACKET) {
+			wtap_rec_cleanup(&r.rec);
+			ws_buffer_free(&r.buf);
+			continue;
+		}
+		*data_bytes += r.rec.rec_header.packet_header.caplen;
+		g_array_append_val(records, r);
+	}
+
+	if (err != 0) {
+		cfile_read_failure_message(path, err, err_info);
+		for (i = 0; i < records->len; i++) {
+			replay_record_t *r = &g_array_index(records, replay_record_t, i);
+			wtap_rec_cleanup(&r->rec);
+			ws_buffer_free(&r->buf);
+		}
+		g_array_free(records, TRUE);
+		wtap_close(wth);
+		return NULL;
+	}
+
+	*file_type_subtype = wtap_file_type_subtype(wth);
+	wtap_close(wth);
+	return records;
+}
+
+static void
+free_records(GArray *records)
+{
+	guint i;
+
+	for (i = 0; i < records->len; i++) {
+		replay_record_t *r = &g_array_index(records, replay_record_t, i);
+
+		wtap_rec_cleanup(&r->rec);
+		ws_buffer_free(&r->buf);
+	}
+	g_array_free(records, TRUE);
+}
+
+/*
+ * Dissect every loaded record once, first-pass style, in a fresh epan
+ * session so that each repetition does the same amount of work.
+ * Returns the elapsed wall-clock time in seconds.
+ */
+static double
+replay_once(GArray *records, int file_type_subtype, gboolean with_tree,
+    column_info *cinfo)
+{
+	static const struct packet_provider_funcs funcs = {
+		NULL,	/* get_frame_ts */
+		NULL,	/* get_interface_name */
+		NULL,	/* get_interface_description */
+		NULL	/* get_modified_block */
+	};
+	epan_t *session;
+	epan_dissect_t edt;
+	frame_data fd;
+	frame_data ref_frame;
+	const frame_data *fd_ref = NULL;
+	nstime_t elapsed;
+	guint32 cum_bytes = 0;
+	gint64 start;
+	guint i;
+
+	nstime_set_zero(&elapsed);
+	session = epan_new(NULL, &funcs);
+	epan_dissect_init(&edt, session, with_tree, FALSE);
+
+	start = g_get_monotonic_time();
+	for (i = 0; i < records->len; i++) {
+		replay_record_t *r = &g_array_index(records, replay_record_t, i);
+		tvbuff_t *tvb;
+
+		frame_data_init(&fd, i + 1, &r->rec, 0, cum_bytes);
+		frame_data_set_before_dissect(&fd, &elapsed, &fd_ref, NULL);
+		if (fd_ref == &fd) {
+			ref_frame = fd;
+			fd_ref = &ref_frame;
+		}
+		if (cinfo != NULL)
+			col_custom_prime_edt(&edt, cinfo);
+		tvb = tvb_new_real_data(ws_buffer_start_ptr(&r->buf),
+		    r->rec.rec_header.packet_header.caplen,
+		    r->rec.rec_header.packet_header.len);
+		/* epan_dissect_reset() frees the tvb chain. */
+		epan_dissect_run(&edt, file_type_subtype, &r->rec, tvb, &fd,
+		    cinfo);
+		if (cinfo != NULL)
+			epan_dissect_fill_in_columns(&edt, FALSE, TRUE);
+		frame_data_set_after_dissect(&fd, &cum_bytes);
+		epan_dissect_reset(&edt);
+		frame_data_destroy(&fd);
+	}
+
+	epan_dissect_cleanup(&edt);
+	epan_free(session);
+
+	return (double)(g_get_monotonic_time() - start) / 1e6;
+}
+
+static gint
+compare_paths(gconstpointer a, gconstpointer b)
+{
+	return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+static int
+compare_double(const void *a, const void *b)
+{
+	const double da = *(const double *)a, db = *(const double *)b;
+
+	if (da < db)
+		return -1;
+	if (da > db)
+		return 1;
+	return 0;
+}
+
+static gboolean
+benchmark_file(const char *path, guint warmup, guint reps, e_prefs *prefs_p)
+{
+	GArray *records;
+	int file_type_subtype = 0;
+	guint64 data_bytes = 0;
+	double *times;
+	guint m, r;
+
+	records = load_records(path, &file_type_subtype, &data_bytes);
+	if (records == NULL)
+		return FALSE;
+
+	printf("%s: %u packets, %.2f MB\n", path, records->len,
+	    (double)data_bytes / 1e6);
+	if (records->len == 0) {
+		free_records(records);
+		return TRUE;
+	}
+
+	times = g_new(double, reps);
+
+	for (m = 0; m < G_N_ELEMENTS(modes); m++) {
+		column_info cinfo_storage;
+		column_info *cinfo = NULL;
+		double median, best, worst;
+
+		if (modes[m].columns) {
+			memset(&cinfo_storage, 0, sizeof(cinfo_storage));
+			build_column_format_array(&cinfo_storage,
+			    prefs_p->num_cols, TRUE);
+			cinfo = &cinfo_storage;
+		}
+
+		for (r = 0; r < warmup; r++)
+			replay_once(records, file_type_subtype, modes[m].tree,
+			    cinfo);
+		for (r = 0; r < reps; r++)
+			times[r] = replay_once(records, file_type_subtype,
+			    modes[m].tree, cinfo);
+
+		qsort(times, reps, sizeof(double), compare_double);
+		/* Faster run = smaller time, so "best" is times[0]. */
+		median = (double)records->len / times[reps / 2];
+		best = (double)records->len / times[0];
+		worst = (double)records->len / times[reps - 1];
+
+		printf("  %-20s %12.0f packets/s  (best %.0f, worst %.0f, %u runs)\n",
+		    modes[m].name, median, best, worst, reps);
+
+		if (cinfo != NULL)
+			col_cleanup(cinfo);
+	}
+
+	g_free(times);
+	free_records(records);
+	return TRUE;
+}
+
+int
+main(int argc, char **argv)
+{
+	char		*init_progfile_dir_error;
+	static const struct report_message_routines benchmark_report_routines = {
+		failure_message,
+		failure_message,
+		open_failure_message,
+		read_failure_message,
+		write_failure_message,
+		cfile_open_failure_message,
+		cfile_dump_open_failure_message,
+		cfile_read_failure_message,
+		cfile_write_failure_message,
+		cfile_close_failure_message
+	};
+	e_prefs		*prefs_p;
+	guint		 warmup = 1;
+	guint		 reps = 5;
+	int		 opt;
+	int		 i;
+	gboolean	 ok = TRUE;
+
+	cmdarg_err_init(benchmark_cmdarg_err, benchmark_cmdarg_err_cont);
+
+	/* Initialize log handler early so we can have proper logging during startup. */
+	ws_log_init("benchmark-dissect", vcmdarg_err);
+
+	/* Early logging command-line initialization. */
+	ws_log_parse_args(&argc, argv, vcmdarg_err, 1);
+
+	/*
+	 * Get credential information for later use.
+	 */
+	init_process_policies();
+
+	/*
+	 * Attempt to get the pathname of the directory containing the
+	 * executable file.
+	 */
+	init_progfile_dir_error = init_progfile_dir(argv[0]);
+	if (init_progfile_dir_error != NULL) {
+		fprintf(stderr, "benchmark-dissect: Can't get pathname of directory containing the benchmark-dissect program: %s.\n",
+			init_progfile_dir_error);
+		g_free(init_progfile_dir_error);
+	}
+
+	init_report_message("benchmark-dissect", &benchmark_report_routines);
+
+	timestamp_set_type(TS_RELATIVE);
+	timestamp_set_seconds_type(TS_SECONDS_DEFAULT);
+
+	/*
+	 * Libwiretap must be initialized before libwireshark is, so that
+	 * dissection-time handlers for file-type-dependent blocks can
+	 * register using the file type/subtype value for the file type.
+	 */
+	wtap_init(TRUE);
+
+	if (!epan_init(NULL, NULL, FALSE))
+		return 2;
+
+	/*
+	 * Set the C-language locale to the native environment and set the
+	 * code page to UTF-8 on Windows.
+	 */
+#ifdef _WIN32
+	setlocale(LC_ALL, ".UTF-8");
+#else
+	setlocale(LC_ALL, "");
+#endif
+
+	/* Load libwireshark settings from the current profile. */
+	prefs_p = epan_load_settings();
+
+	/* notify all registered modules that have had any of their preferences
+	changed either from one of the preferences file or from the command
+	line that its preferences have changed. */
+	prefs_apply_all();
+
+	while ((opt = getopt(argc, argv, "hn:w:")) != -1) {
+		switch (opt) {
+		case 'n':
+			reps = (guint)strtoul(optarg, NULL, 10);
+			if (reps == 0) {
+				cmdarg_err("The repetition count must be at least 1");
+				return 1;
+			}
+			break;
+		case 'w':
+			warmup = (guint)strtoul(optarg, NULL, 10);
+			break;
+		case 'h':
+			print_usage(stdout);
+			return 0;
+		default:
+			print_usage(stderr);
+			return 1;
+		}
+	}
+
+	if (optind >= argc) {
+		print_usage(stderr);
+		return 1;
+	}
+
+	for (i = optind; i < argc; i++) {
+		if (g_file_test(argv[i], G_FILE_TEST_IS_DIR)) {
+			GDir *dir;
+			GError *dir_err = NULL;
+			GPtrArray *names;
+			const gchar *name;
+			guint j;
+
+			dir = g_dir_open(argv[i], 0, &dir_err);
+			if (dir == NULL) {
+				cmdarg_err("Can't open directory \"%s\": %s",
+				    argv[i], dir_err->message);
+				g_error_free(dir_err);
+				ok = FALSE;
+				continue;
+			}
+			/* Sort the entries so runs are reproducible. */
+			names = g_ptr_array_new_with_free_func(g_free);
+			while ((name = g_dir_read_name(dir)) != NULL)
+				g_ptr_array_add(names,
+				    g_build_filename(argv[i], name, NULL));
+			g_dir_close(dir);
+			g_ptr_array_sort(names, compare_paths);
+
+			for (j = 0; j < names->len; j++) {
+				const gchar *fullpath = (const gchar *)g_ptr_array_index(names, j);
+
+				if (!g_file_test(fullpath, G_FILE_TEST_IS_REGULAR))
+					continue;
+				if (!benchmark_file(fullpath, warmup, reps, prefs_p))
+					ok = FALSE;
+			}
+			g_ptr_array_free(names, TRUE);
+		} else {
+			if (!benchmark_file(argv[i], warmup, reps, prefs_p))
+				ok = FALSE;
+		}
+	}
+
+	epan_cleanup();
+	wtap_cleanup();
+
+	return ok ? 0 : 2;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
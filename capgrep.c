@@ -0,0 +1,484 @@
+/* capgrep.c
+ * Searches capture files for raw byte patterns
+ *
+ * Based on captype.c
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <locale.h>
+#include <errno.h>
+
+/*
+ * If we have getopt_long() in the system library, include <getopt.h>.
+ * Otherwise, we're using our own getopt_long() (either because the
+ * system has getopt() but not getopt_long(), as with some UN*Xes,
+ * or because it doesn't even have getopt(), as with Windows), so
+ * include our getopt_long()'s header.
+ */
+#ifdef HAVE_GETOPT_LONG
+#include <getopt.h>
+#else
+#include <wsutil/wsgetopt.h>
+#endif
+
+#include <glib.h>
+
+#include <wiretap/wtap.h>
+
+#include <ui/cmdarg_err.h>
+#include <wsutil/file_util.h>
+#include <wsutil/filesystem.h>
+#include <wsutil/privileges.h>
+#include <wsutil/strtoi.h>
+#include <cli_main.h>
+#include <ui/version_info.h>
+
+#ifdef HAVE_PLUGINS
+#include <wsutil/plugins.h>
+#endif
+
+#include <wsutil/report_message.h>
+#include <wsutil/str_util.h>
+#include <wsutil/wslog.h>
+
+#include "ui/failure_message.h"
+
+/*
+ * capgrep searches the raw record bytes of capture files for a set of
+ * byte patterns, without dissecting anything: the files are read
+ * sequentially with wiretap and each record's data is run through an
+ * Aho-Corasick automaton holding all the patterns at once, so the scan
+ * cost doesn't grow with the number of patterns.  Files are handed out
+ * to a pool of worker threads, one file per worker, which makes
+ * scanning a directory of captures I/O bound rather than CPU bound.
+ *
+ * Hits are reported one per line as
+ *
+ *    <file>\t<frame>\t<offset>\t<pattern>
+ *
+ * which is easy to post-process with the usual text tools.
+ */
+
+typedef struct {
+  guint8 *bytes;        /* the pattern, lowercased if case-insensitive */
+  guint   len;
+  gchar  *label;        /* as given on the command line */
+} capgrep_pattern_t;
+
+/*
+ * One Aho-Corasick state: the failure-resolved transition table and the
+ * patterns that end in this state.  The automaton is built once, before
+ * the worker threads start, and is read-only afterwards, so the workers
+ * can share it without locking.
+ */
+typedef struct {
+  guint32  next[256];
+  GSList  *outputs;     /* list of capgrep_pattern_t * */
+} ac_state_t;
+
+static GPtrArray *patterns;             /* of capgrep_pattern_t * */
+static GArray    *ac_states;            /* of ac_state_t */
+static gboolean   case_insensitive = FALSE;
+static gboolean   found_any = FALSE;
+static gboolean   read_errors = FALSE;
+static GMutex     output_mutex;
+
+static void
+print_usage(FILE *output)
+{
+  fprintf(output, "\n");
+  fprintf(output, "Usage: capgrep [options] <infile> ...\n");
+  fprintf(output, "\n");
+  fprintf(output, "Options:\n");
+  fprintf(output, "  -s <string>  add a text pattern (may be given multiple times)\n");
+  fprintf(output, "  -x <hex>     add a hex pattern, e.g. -x deadbeef (may be given multiple times)\n");
+  fprintf(output, "  -i           match text patterns case-insensitively\n");
+  fprintf(output, "  -j <n>       scan up to <n> files in parallel (default: number of CPUs)\n");
+  fprintf(output, "  -h           display this help and exit\n");
+  fprintf(output, "  -v           display version info and exit\n");
+}
+
+/*
+ * Report an error in command-line arguments.
+ */
+static void
+capgrep_cmdarg_err(const char *msg_format, va_list ap)
+{
+  fprintf(stderr, "capgrep: ");
+  vfprintf(stderr, msg_format, ap);
+  fprintf(stderr, "\n");
+}
+
+/*
+ * Report additional information for an error in command-line arguments.
+ */
+static void
+capgrep_cmdarg_err_cont(const char *msg_format, va_list ap)
+{
+  vfprintf(stderr, msg_format, ap);
+  fprintf(stderr, "\n");
+}
+
+static void
+add_string_pattern(const gchar *arg)
+{
+  capgrep_pattern_t *pat;
+
+  if (*arg == '\0') {
+    cmdarg_err("empty pattern");
+    exit(1);
+  }
+  pat = g_new0(capgrep_pattern_t, 1);
+  pat->len = (guint)strlen(arg);
+  pat->bytes = (guint8 *)g_strdup(arg);
+  pat->label = g_strdup(arg);
+  g_ptr_array_add(patterns, pat);
+}
+
+static void
+add_hex_pattern(const gchar *arg)
+{
+  capgrep_pattern_t *pat;
+  gsize len = strlen(arg);
+  gsize i;
+  int hi, lo;
+
+  if (len == 0 || (len % 2) != 0) {
+    cmdarg_err("hex pattern \"%s\" must have an even, non-zero number of digits", arg);
+    exit(1);
+  }
+  pat = g_new0(capgrep_pattern_t, 1);
+  pat->len = (guint)(len / 2);
+  pat->bytes = (guint8 *)g_malloc(pat->len);
+  for (i = 0; i < pat->len; i++) {
+    hi = g_ascii_xdigit_value(arg[2 * i]);
+    lo = g_ascii_xdigit_value(arg[2 * i + 1]);
+    if (hi < 0 || lo < 0) {
+      cmdarg_err("hex pattern \"%s\" contains a non-hex digit", arg);
+      exit(1);
+    }
+    pat->bytes[i] = (guint8)((hi << 4) | lo);
+  }
+  pat->label = g_strdup_printf("0x%s", arg);
+  g_ptr_array_add(patterns, pat);
+}
+
+/*
+ * Build the Aho-Corasick automaton from the pattern list: insert the
+ * patterns into a trie, then resolve the failure links breadth-first,
+ * folding them directly into the transition tables so the scan loop is
+ * a single table lookup per byte.
+ */
+static void
+ac_build(void)
+{
+  ac_state_t  empty;
+  ac_state_t *state;
+  guint32    *fail;
+  GQueue     *queue;
+  guint       i, b, p;
+
+  memset(&empty, 0, sizeof empty);
+  ac_states = g_array_new(FALSE, FALSE, sizeof(ac_state_t));
+  g_array_append_val(ac_states, empty);
+
+  /* Trie construction; 0 in next[] means "no transition yet", which is
+     unambiguous since state 0 is the root and never a target here. */
+  for (p = 0; p < patterns->len; p++) {
+    capgrep_pattern_t *pat = (capgrep_pattern_t *)g_ptr_array_index(patterns, p);
+    guint32 s = 0;
+
+    if (case_insensitive) {
+      for (i = 0; i < pat->len; i++)
+        pat->bytes[i] = (guint8)g_ascii_tolower(pat->bytes[i]);
+    }
+    for (i = 0; i < pat->len; i++) {
+      b = pat->bytes[i];
+      if (g_array_index(ac_states, ac_state_t, s).next[b] == 0) {
+        g_array_append_val(ac_states, empty);
+        g_array_index(ac_states, ac_state_t, s).next[b] = ac_states->len - 1;
+      }
+      s = g_array_index(ac_states, ac_state_t, s).next[b];
+    }
+    state = &g_array_index(ac_states, ac_state_t, s);
+    state->outputs = g_slist_prepend(state->outputs, pat);
+  }
+
+  /* Failure resolution, breadth-first from the root. */
+  fail = g_new0(guint32, ac_states->len);
+  queue = g_queue_new();
+  for (b = 0; b < 256; b++) {
+    guint32 s = g_array_index(ac_states, ac_state_t, 0).next[b];
+    if (s != 0)
+      g_queue_push_tail(queue, GUINT_TO_POINTER(s));
+  }
+  while (!g_queue_is_empty(queue)) {
+    guint32 s = GPOINTER_TO_UINT(g_queue_pop_head(queue));
+    ac_state_t *fs = &g_array_index(ac_states, ac_state_t, fail[s]);
+
+    state = &g_array_index(ac_states, ac_state_t, s);
+    state->outputs = g_slist_concat(state->outputs,
+                                    g_slist_copy(fs->outputs));
+    for (b = 0; b < 256; b++) {
+      guint32 t = state->next[b];
+      if (t != 0) {
+        fail[t] = fs->next[b];
+        g_queue_push_tail(queue, GUINT_TO_POINTER(t));
+      } else {
+        state->next[b] = fs->next[b];
+      }
+    }
+  }
+  g_queue_free(queue);
+  g_free(fail);
+}
+
+/*
+ * Run the automaton over one record's bytes, reporting every pattern
+ * occurrence.  The automaton is read-only here; only the report needs
+ * the output lock.
+ */
+static void
+scan_record(const char *filename, guint32 framenum, const guint8 *pd,
+            guint caplen)
+{
+  const ac_state_t *states = &g_array_index(ac_states, ac_state_t, 0);
+  guint32 s = 0;
+  guint   i;
+  GSList *out;
+
+  for (i = 0; i < caplen; i++) {
+    guint8 b = pd[i];
+
+    if (case_insensitive)
+      b = (guint8)g_ascii_tolower(b);
+    s = states[s].next[b];
+    for (out = states[s].outputs; out != NULL; out = out->next) {
+      const capgrep_pattern_t *pat = (const capgrep_pattern_t *)out->data;
+
+      g_mutex_lock(&output_mutex);
+      found_any = TRUE;
+      printf("%s\t%u\t%u\t%s\n", filename, framenum, i + 1 - pat->len,
+             pat->label);
+      g_mutex_unlock(&output_mutex);
+    }
+  }
+}
+
+/*
+ * Worker: open one capture file and scan every record in it.
+ */
+static void
+scan_file(gpointer data, gpointer user_data _U_)
+{
+  const char *filename = (const char *)data;
+  wtap       *wth;
+  wtap_rec    rec;
+  Buffer      buf;
+  int         err;
+  gchar      *err_info;
+  gint64      data_offset;
+  guint32     framenum = 0;
+
+  wth = wtap_open_offline(filename, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+  if (wth == NULL) {
+    g_mutex_lock(&output_mutex);
+    cfile_open_failure_message(filename, err, err_info);
+    read_errors = TRUE;
+    g_mutex_unlock(&output_mutex);
+    return;
+  }
+
+  wtap_rec_init(&rec);
+  ws_buffer_init(&buf, 1514);
+  while (wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset)) {
+    framenum++;
+    if (rec.rec_type == REC_TYPE_PACKET)
+      scan_record(filename, framenum, ws_buffer_start_ptr(&buf),
+                  rec.rec_header.packet_header.caplen);
+  }
+  if (err != 0) {
+    g_mutex_lock(&output_mutex);
+    cfile_read_failure_message(filename, err, err_info);
+    read_errors = TRUE;
+    g_mutex_unlock(&output_mutex);
+  }
+  wtap_rec_cleanup(&rec);
+  ws_buffer_free(&buf);
+  wtap_close(wth);
+}
+
+int
+main(int argc, char *argv[])
+{
+  char  *init_progfile_dir_error;
+  static const struct report_message_routines capgrep_report_routines = {
+      failure_message,
+      failure_message,
+      open_failure_message,
+      read_failure_message,
+      write_failure_message,
+      cfile_open_failure_message,
+      cfile_dump_open_failure_message,
+      cfile_read_failure_message,
+      cfile_write_failure_message,
+      cfile_close_failure_message
+  };
+  int          i;
+  int          opt;
+  guint32      n_workers = 0;
+  GThreadPool *pool;
+  GError      *pool_err = NULL;
+  static const struct option long_options[] = {
+      {"help", no_argument, NULL, 'h'},
+      {"version", no_argument, NULL, 'v'},
+      {0, 0, 0, 0 }
+  };
+
+  /*
+   * Set the C-language locale to the native environment and set the
+   * code page to UTF-8 on Windows.
+   */
+#ifdef _WIN32
+  setlocale(LC_ALL, ".UTF-8");
+#else
+  setlocale(LC_ALL, "");
+#endif
+
+  cmdarg_err_init(capgrep_cmdarg_err, capgrep_cmdarg_err_cont);
+
+  /* Initialize log handler early so we can have proper logging during startup. */
+  ws_log_init("capgrep", vcmdarg_err);
+
+  /* Early logging command-line initialization. */
+  ws_log_parse_args(&argc, argv, vcmdarg_err, 1);
+
+  /* Initialize the version information. */
+  ws_init_version_info("Capgrep (Wireshark)", NULL, NULL, NULL);
+
+#ifdef _WIN32
+  create_app_running_mutex();
+#endif /* _WIN32 */
+
+  /*
+   * Get credential information for later use.
+   */
+  init_process_policies();
+
+  /*
+   * Attempt to get the pathname of the directory containing the
+   * executable file.
+   */
+  init_progfile_dir_error = init_progfile_dir(argv[0]);
+  if (init_progfile_dir_error != NULL) {
+    fprintf(stderr,
+            "capgrep: Can't get pathname of directory containing the capgrep program: %s.\n",
+            init_progfile_dir_error);
+    g_free(init_progfile_dir_error);
+  }
+
+  init_report_message("capgrep", &capgrep_report_routines);
+
+  wtap_init(TRUE);
+
+  patterns = g_ptr_array_new();
+
+  /* Process the options */
+  while ((opt = getopt_long(argc, argv, "s:x:ij:hv", long_options, NULL)) !=-1) {
+
+    switch (opt) {
+
+      case 's':
+        add_string_pattern(optarg);
+        break;
+
+      case 'x':
+        add_hex_pattern(optarg);
+        break;
+
+      case 'i':
+        case_insensitive = TRUE;
+        break;
+
+      case 'j':
+        if (!ws_strtou32(optarg, NULL, &n_workers) || n_workers == 0) {
+          cmdarg_err("invalid worker count \"%s\"", optarg);
+          exit(1);
+        }
+        break;
+
+      case 'h':
+        show_help_header("Search the raw bytes of capture files for patterns.");
+        print_usage(stdout);
+        exit(0);
+        break;
+
+      case 'v':
+        show_version();
+        exit(0);
+        break;
+
+      case '?':              /* Bad flag - print usage message */
+        print_usage(stderr);
+        exit(1);
+        break;
+    }
+  }
+
+  if (optind >= argc) {
+    print_usage(stderr);
+    return 1;
+  }
+  if (patterns->len == 0) {
+    cmdarg_err("no patterns given; use -s and/or -x");
+    return 1;
+  }
+
+  ac_build();
+
+  if (n_workers == 0)
+    n_workers = g_get_num_processors();
+  if (n_workers > (guint32)(argc - optind))
+    n_workers = argc - optind;
+
+  pool = g_thread_pool_new(scan_file, NULL, n_workers, FALSE, &pool_err);
+  if (pool == NULL) {
+    cmdarg_err("can't create worker threads: %s", pool_err->message);
+    g_error_free(pool_err);
+    return 2;
+  }
+  for (i = optind; i < argc; i++)
+    g_thread_pool_push(pool, argv[i], NULL);
+  /* Wait for every queued file to be scanned. */
+  g_thread_pool_free(pool, FALSE, TRUE);
+
+  wtap_cleanup();
+  free_progdirs();
+  if (read_errors)
+    return 2;
+  return found_any ? 0 : 1;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 2
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=2 tabstop=8 expandtab:
+ * :indentSize=2:tabSize=8:noTabs=true:
+ */
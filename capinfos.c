@@ -1163,6 +1163,9 @@ count_decryption_secret(guint32 secrets_type _U_, const void *secrets _U_, guint
   num_decryption_secrets++;
 }
 
+/* Number of records process_cap_file() pulls per wtap_read_batch() call. */
+#define SCAN_BATCH_SIZE 64
+
 static int
 process_cap_file(const char *filename, gboolean need_separator)
 {
@@ -1170,14 +1173,16 @@ process_cap_file(const char *filename, gboolean need_separator)
   int                   err;
   gchar                *err_info;
   gint64                size;
-  gint64                data_offset;
+  gint64                data_offsets[SCAN_BATCH_SIZE];
 
   guint32               packet = 0;
   gint64                bytes  = 0;
   guint32               snaplen_min_inferred = 0xffffffff;
   guint32               snaplen_max_inferred =          0;
-  wtap_rec              rec;
-  Buffer                buf;
+  wtap_rec              recs[SCAN_BATCH_SIZE];
+  Buffer                bufs[SCAN_BATCH_SIZE];
+  guint                 batch_count;
+  guint                 b;
   capture_info          cf_info;
   gboolean              have_times = TRUE;
   nstime_t              start_time;
@@ -1233,100 +1238,120 @@ process_cap_file(const char *filename, gboolean need_separator)
   num_ipv6_addresses = 0;
   num_decryption_secrets = 0;
 
-  /* Tally up data that we need to parse through the file to find */
-  wtap_rec_init(&rec);
-  ws_buffer_init(&buf, 1514);
-  while (wtap_read(cf_info.wth, &rec, &buf, &err, &err_info, &data_offset))  {
-    if (rec.presence_flags & WTAP_HAS_TS) {
-      prev_time = cur_time;
-      cur_time = rec.ts;
-      if (packet == 0) {
-        start_time = rec.ts;
-        start_time_tsprec = rec.tsprec;
-        stop_time  = rec.ts;
-        stop_time_tsprec = rec.tsprec;
-        prev_time  = rec.ts;
-      }
-      if (nstime_cmp(&cur_time, &prev_time) < 0) {
-        order = NOT_IN_ORDER;
-      }
-      if (nstime_cmp(&cur_time, &start_time) < 0) {
-        start_time = cur_time;
-        start_time_tsprec = rec.tsprec;
-      }
-      if (nstime_cmp(&cur_time, &stop_time) > 0) {
-        stop_time = cur_time;
-        stop_time_tsprec = rec.tsprec;
-      }
-    } else {
-      have_times = FALSE; /* at least one packet has no time stamp */
-      if (order != NOT_IN_ORDER)
-        order = ORDER_UNKNOWN;
-    }
-
-    if (rec.rec_type == REC_TYPE_PACKET) {
-      bytes += rec.rec_header.packet_header.len;
-      packet++;
-
-      /* If caplen < len for a rcd, then presumably           */
-      /* 'Limit packet capture length' was done for this rcd. */
-      /* Keep track as to the min/max actual snapshot lengths */
-      /*  seen for this file.                                 */
-      if (rec.rec_header.packet_header.caplen < rec.rec_header.packet_header.len) {
-        if (rec.rec_header.packet_header.caplen < snaplen_min_inferred)
-          snaplen_min_inferred = rec.rec_header.packet_header.caplen;
-        if (rec.rec_header.packet_header.caplen > snaplen_max_inferred)
-          snaplen_max_inferred = rec.rec_header.packet_header.caplen;
-      }
-
-      if ((rec.rec_header.packet_header.pkt_encap > 0) &&
-          (rec.rec_header.packet_header.pkt_encap < WTAP_NUM_ENCAP_TYPES)) {
-        cf_info.encap_counts[rec.rec_header.packet_header.pkt_encap] += 1;
+  /* Everything we tally comes from the record metadata, not the packet
+     data, so let the file reader skip over the data; for formats that
+     support it, that turns the scan into a walk of the record headers. */
+  wtap_set_skip_packet_data(cf_info.wth, TRUE);
+
+  /* Tally up data that we need to parse through the file to find.
+     Records are pulled in batches to keep the per-record call overhead
+     of the read loop off the scan. */
+  for (b = 0; b < SCAN_BATCH_SIZE; b++) {
+    wtap_rec_init(&recs[b]);
+    ws_buffer_init(&bufs[b], 1514);
+  }
+  while ((batch_count = wtap_read_batch(cf_info.wth, recs, bufs,
+                                        SCAN_BATCH_SIZE, &err, &err_info,
+                                        data_offsets)) != 0) {
+    for (b = 0; b < batch_count; b++) {
+      wtap_rec *rec = &recs[b];
+
+      if (rec->presence_flags & WTAP_HAS_TS) {
+        prev_time = cur_time;
+        cur_time = rec->ts;
+        if (packet == 0) {
+          start_time = rec->ts;
+          start_time_tsprec = rec->tsprec;
+          stop_time  = rec->ts;
+          stop_time_tsprec = rec->tsprec;
+          prev_time  = rec->ts;
+        }
+        if (nstime_cmp(&cur_time, &prev_time) < 0) {
+          order = NOT_IN_ORDER;
+        }
+        if (nstime_cmp(&cur_time, &start_time) < 0) {
+          start_time = cur_time;
+          start_time_tsprec = rec->tsprec;
+        }
+        if (nstime_cmp(&cur_time, &stop_time) > 0) {
+          stop_time = cur_time;
+          stop_time_tsprec = rec->tsprec;
+        }
       } else {
-        fprintf(stderr, "capinfos: Unknown packet encapsulation %d in frame %u of file \"%s\"\n",
-                rec.rec_header.packet_header.pkt_encap, packet, filename);
+        have_times = FALSE; /* at least one packet has no time stamp */
+        if (order != NOT_IN_ORDER)
+          order = ORDER_UNKNOWN;
       }
 
-      /* Packet interface_id info */
-      if (rec.presence_flags & WTAP_HAS_INTERFACE_ID) {
-        /* cf_info.num_interfaces is size, not index, so it's one more than max index */
-        if (rec.rec_header.packet_header.interface_id >= cf_info.num_interfaces) {
-          /*
-           * OK, re-fetch the number of interfaces, as there might have
-           * been an interface that was in the middle of packets, and
-           * grow the array to be big enough for the new number of
-           * interfaces.
-           */
-          idb_info = wtap_file_get_idb_info(cf_info.wth);
-
-          cf_info.num_interfaces = idb_info->interface_data->len;
-          g_array_set_size(cf_info.interface_packet_counts, cf_info.num_interfaces);
-
-          g_free(idb_info);
-          idb_info = NULL;
+      if (rec->rec_type == REC_TYPE_PACKET) {
+        bytes += rec->rec_header.packet_header.len;
+        packet++;
+
+        /* If caplen < len for a rcd, then presumably           */
+        /* 'Limit packet capture length' was done for this rcd. */
+        /* Keep track as to the min/max actual snapshot lengths */
+        /*  seen for this file.                                 */
+        if (rec->rec_header.packet_header.caplen < rec->rec_header.packet_header.len) {
+          if (rec->rec_header.packet_header.caplen < snaplen_min_inferred)
+            snaplen_min_inferred = rec->rec_header.packet_header.caplen;
+          if (rec->rec_header.packet_header.caplen > snaplen_max_inferred)
+            snaplen_max_inferred = rec->rec_header.packet_header.caplen;
         }
-        if (rec.rec_header.packet_header.interface_id < cf_info.num_interfaces) {
-          g_array_index(cf_info.interface_packet_counts, guint32,
-                        rec.rec_header.packet_header.interface_id) += 1;
-        }
-        else {
-          cf_info.pkt_interface_id_unknown += 1;
+
+        if ((rec->rec_header.packet_header.pkt_encap > 0) &&
+            (rec->rec_header.packet_header.pkt_encap < WTAP_NUM_ENCAP_TYPES)) {
+          cf_info.encap_counts[rec->rec_header.packet_header.pkt_encap] += 1;
+        } else {
+          fprintf(stderr, "capinfos: Unknown packet encapsulation %d in frame %u of file \"%s\"\n",
+                  rec->rec_header.packet_header.pkt_encap, packet, filename);
         }
-      }
-      else {
-        /* it's for interface_id 0 */
-        if (cf_info.num_interfaces != 0) {
-          g_array_index(cf_info.interface_packet_counts, guint32, 0) += 1;
+
+        /* Packet interface_id info */
+        if (rec->presence_flags & WTAP_HAS_INTERFACE_ID) {
+          /* cf_info.num_interfaces is size, not index, so it's one more than max index */
+          if (rec->rec_header.packet_header.interface_id >= cf_info.num_interfaces) {
+            /*
+             * OK, re-fetch the number of interfaces, as there might have
+             * been an interface that was in the middle of packets, and
+             * grow the array to be big enough for the new number of
+             * interfaces.
+             */
+            idb_info = wtap_file_get_idb_info(cf_info.wth);
+
+            cf_info.num_interfaces = idb_info->interface_data->len;
+            g_array_set_size(cf_info.interface_packet_counts, cf_info.num_interfaces);
+
+            g_free(idb_info);
+            idb_info = NULL;
+          }
+          if (rec->rec_header.packet_header.interface_id < cf_info.num_interfaces) {
+            g_array_index(cf_info.interface_packet_counts, guint32,
+                          rec->rec_header.packet_header.interface_id) += 1;
+          }
+          else {
+            cf_info.pkt_interface_id_unknown += 1;
+          }
         }
         else {
-          cf_info.pkt_interface_id_unknown += 1;
+          /* it's for interface_id 0 */
+          if (cf_info.num_interfaces != 0) {
+            g_array_index(cf_info.interface_packet_counts, guint32, 0) += 1;
+          }
+          else {
+            cf_info.pkt_interface_id_unknown += 1;
+          }
         }
       }
-    }
 
+    } /* for */
+    /* A short batch ended at the end of the file or on an error. */
+    if (batch_count < SCAN_BATCH_SIZE)
+      break;
   } /* while */
-  wtap_rec_cleanup(&rec);
-  ws_buffer_free(&buf);
+  for (b = 0; b < SCAN_BATCH_SIZE; b++) {
+    wtap_rec_cleanup(&recs[b]);
+    ws_buffer_free(&bufs[b]);
+  }
 
   /*
    * Get IDB info strings.
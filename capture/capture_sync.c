@@ -20,9 +20,11 @@
 
 #include <signal.h>
 
+#include <wsutil/pipeline_stats.h>
 #include <wsutil/strtoi.h>
 #include <wsutil/wslog.h>
 #include <wsutil/ws_assert.h>
+#include <wsutil/ws_tracepoints.h>
 
 #ifdef _WIN32
 #include <wsutil/unicode-utils.h>
@@ -1675,6 +1677,52 @@ sync_pipe_input_cb(gint source, gpointer user_data)
     }
 
     /* we got a valid message block from the child, process it */
+
+    /* Runs of SP_PACKET_COUNT messages are common at high packet rates -
+       dumpcap sends one for every batch of packets it writes.  Coalesce
+       the whole run that's already sitting in the pipe into a single
+       update, so we don't go through a callback round trip (and a UI
+       update) per message. */
+    while (indicator == SP_PACKET_COUNT) {
+        guint32 count = 0;
+
+        if (!ws_strtou32(buffer, NULL, &count)) {
+            ws_warning("Invalid packets number: %s", buffer);
+        }
+        npackets += count;
+
+        /* The child writes each message with a single write of no more
+           than PIPE_BUF bytes, so if the pipe is readable, a complete
+           message is waiting. */
+        if (!ws_pipe_data_available(source))
+            break;
+        nread = pipe_read_block(source, &indicator, SP_MAX_MSG_LEN, buffer,
+                                &primary_msg);
+        if (nread <= 0) {
+            /* EOF or error; deliver the packets we've accumulated and
+               pick the EOF or error up on the next callback. */
+            g_free(primary_msg);
+            ws_debug("new packets %u", npackets);
+            WS_TRACEPOINT1(sync_pipe_deliver, npackets);
+            pipeline_stats_record(PIPELINE_STAGE_DELIVER, npackets);
+            cap_session->count += npackets;
+            cap_session->new_packets(cap_session, npackets);
+            return TRUE;
+        }
+    }
+    if (npackets != 0) {
+        ws_debug("new packets %u", npackets);
+        WS_TRACEPOINT1(sync_pipe_deliver, npackets);
+        pipeline_stats_record(PIPELINE_STAGE_DELIVER, npackets);
+        cap_session->count += npackets;
+        cap_session->new_packets(cap_session, npackets);
+    }
+    if (indicator == SP_PACKET_COUNT) {
+        /* The run ended because the pipe drained, not because some
+           other kind of message arrived; we're done for this callback. */
+        return TRUE;
+    }
+
     switch(indicator) {
     case SP_FILE:
         if(!cap_session->new_file(cap_session, buffer)) {
@@ -1701,14 +1749,6 @@ sync_pipe_input_cb(gint source, gpointer user_data)
             return FALSE;
         }
         break;
-    case SP_PACKET_COUNT:
-        if (!ws_strtou32(buffer, NULL, &npackets)) {
-            ws_warning("Invalid packets number: %s", buffer);
-        }
-        ws_debug("new packets %u", npackets);
-        cap_session->count += npackets;
-        cap_session->new_packets(cap_session, npackets);
-        break;
     case SP_ERROR_MSG:
         /* convert primary message */
         pipe_convert_header((guchar*)buffer, 4, &indicator, &primary_len);
@@ -98,7 +98,7 @@ main(int argc, char *argv[])
       cfile_write_failure_message,
       cfile_close_failure_message
   };
-  wtap  *wth;
+  wtap_probe_info probe_info;
   int    err;
   gchar *err_info;
   int    i;
@@ -187,11 +187,8 @@ main(int argc, char *argv[])
   overall_error_status = 0;
 
   for (i = 1; i < argc; i++) {
-    wth = wtap_open_offline(argv[i], WTAP_TYPE_AUTO, &err, &err_info, FALSE);
-
-    if(wth) {
-      printf("%s: %s\n", argv[i], wtap_file_type_subtype_name(wtap_file_type_subtype(wth)));
-      wtap_close(wth);
+    if (wtap_probe_file(argv[i], 0, 0.0, &probe_info, &err, &err_info)) {
+      printf("%s: %s\n", argv[i], wtap_file_type_subtype_name(probe_info.file_type_subtype));
     } else {
       if (err == WTAP_ERR_FILE_UNKNOWN_FORMAT)
         printf("%s: unknown\n", argv[i]);
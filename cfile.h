@@ -60,6 +60,7 @@ struct packet_provider_data {
   frame_data  *prev_cap;
   frame_data_sequence *frames;         /* Sequence of frames, if we're keeping that information */
   GTree       *frames_modified_blocks; /* BST with modified blocks for frames (key = frame_data) */
+  GTree       *frames_shift_offsets;   /* BST with time shift offsets for frames (key = frame_data) */
 };
 
 typedef struct _capture_file {
@@ -91,6 +92,13 @@ typedef struct _capture_file {
   dfilter_t                  *dfcode;               /* Compiled display filter program */
   gchar                      *dfilter;              /* Display filter string */
   gboolean                    redissecting;         /* TRUE if currently redissecting (cf_redissect_packets) */
+  gboolean                    frames_preloaded;     /* TRUE if provider.frames came from a sidecar index */
+  GHashTable                 *dfilter_result_cache; /* Per-filter-text cached filter results (see file.c) */
+  GHashTable                 *field_postings;       /* Field abbrev -> frame-number postings (see frame_index.c) */
+  GHashTable                 *frame_dependencies;   /* Frame number -> depended-upon frame numbers */
+  gboolean                    postings_collecting;  /* TRUE while pass one is filling field_postings */
+  struct ph_stats_live       *pstats_live;          /* Incremental protocol hierarchy counters (see ui/proto_hier_stats.c) */
+  struct summary_stats_live  *sstats_live;          /* Incremental capture file summary aggregates (see ui/summary.c) */
   gboolean                    read_lock;            /* TRUE if currently processing a file (cf_read) */
   rescan_type                 redissection_queued;  /* Queued redissection type. */
   /* search */
@@ -133,6 +141,8 @@ const char *cap_file_provider_get_interface_name(struct packet_provider_data *pr
 const char *cap_file_provider_get_interface_description(struct packet_provider_data *prov, guint32 interface_id);
 wtap_block_t cap_file_provider_get_modified_block(struct packet_provider_data *prov, const frame_data *fd);
 void cap_file_provider_set_modified_block(struct packet_provider_data *prov, frame_data *fd, const wtap_block_t new_block);
+const nstime_t *cap_file_provider_get_shift_offset(struct packet_provider_data *prov, const frame_data *fd);
+void cap_file_provider_set_shift_offset(struct packet_provider_data *prov, frame_data *fd, const nstime_t *shift_offset);
 
 #ifdef __cplusplus
 }
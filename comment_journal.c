@@ -0,0 +1,267 @@
+/* comment_journal.c
+ * Sidecar append-only journal for packet comments
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+#define WS_LOG_DOMAIN LOG_DOMAIN_CAPTURE
+
+#include <string.h>
+#include <stdio.h>
+
+#include <glib.h>
+
+#include <wsutil/file_util.h>
+#include <wsutil/wslog.h>
+
+#include <wiretap/wtap_opttypes.h>
+
+#include <epan/frame_data.h>
+#include <epan/frame_data_sequence.h>
+#include <epan/expert.h>
+
+#include "file.h"
+#include "comment_journal.h"
+
+/*
+ * The journal is a text file: a header line tying it to the capture
+ * file, then one record per comment edit.  A record is the frame number
+ * followed by the frame's complete comment set, each comment base64
+ * encoded (comments may contain newlines).  A record with no comments
+ * means the frame's comments were cleared.  Records are only ever
+ * appended, so persisting an edit is O(1) regardless of capture size;
+ * replay applies them in order, with the last record for a frame
+ * winning.
+ */
+#define COMMENT_JOURNAL_MAGIC   "WSCJ"
+#define COMMENT_JOURNAL_VERSION 1
+
+#define COMMENT_JOURNAL_SUFFIX  ".wscmt"
+
+/* Set while replaying, so that the block modifications made on behalf
+   of the journal aren't appended right back to it. */
+static gboolean cj_replaying;
+
+static gchar *
+comment_journal_filename(const capture_file *cf)
+{
+  return g_strconcat(cf->filename, COMMENT_JOURNAL_SUFFIX, NULL);
+}
+
+/*
+ * Get the fingerprint of the capture file itself, for validating a
+ * journal against it.  Returns FALSE if the file can't be stat'ed.
+ */
+static gboolean
+comment_journal_fingerprint(const capture_file *cf, gint64 *size,
+                            gint64 *mtime)
+{
+  ws_statb64 statb;
+
+  if (ws_stat64(cf->filename, &statb) < 0)
+    return FALSE;
+  *size = statb.st_size;
+  *mtime = (gint64)statb.st_mtime;
+  return TRUE;
+}
+
+void
+comment_journal_record(capture_file *cf, guint32 frame_num,
+                       wtap_block_t pkt_block)
+{
+  gchar   *jnl_name;
+  FILE    *fh;
+  gint64   cap_size, cap_mtime;
+  GString *line;
+  gchar   *comment;
+  gchar   *encoded;
+  guint    n_comments, i;
+
+  if (cj_replaying)
+    return;
+  if (cf->is_tempfile)
+    return;
+  if (!comment_journal_fingerprint(cf, &cap_size, &cap_mtime))
+    return;
+
+  jnl_name = comment_journal_filename(cf);
+  fh = ws_fopen(jnl_name, "ab");
+  if (fh == NULL) {
+    /* The capture's directory may simply not be writable; the comments
+       are still in memory and will be written by the next full save. */
+    g_free(jnl_name);
+    return;
+  }
+
+  /* A fresh journal starts with a header tying it to the capture file
+     as it is right now. */
+  if (fseek(fh, 0, SEEK_END) == 0 && ftell(fh) == 0) {
+    fprintf(fh, "%s %d %" G_GINT64_FORMAT " %" G_GINT64_FORMAT "\n",
+            COMMENT_JOURNAL_MAGIC, COMMENT_JOURNAL_VERSION,
+            cap_size, cap_mtime);
+  }
+
+  line = g_string_new(NULL);
+  g_string_printf(line, "%u", frame_num);
+  n_comments = pkt_block ? wtap_block_count_option(pkt_block, OPT_COMMENT) : 0;
+  for (i = 0; i < n_comments; i++) {
+    if (wtap_block_get_nth_string_option_value(pkt_block, OPT_COMMENT, i,
+                                               &comment) != WTAP_OPTTYPE_SUCCESS)
+      continue;
+    encoded = g_base64_encode((const guchar *)comment, strlen(comment));
+    g_string_append_c(line, ' ');
+    g_string_append(line, encoded);
+    g_free(encoded);
+  }
+
+  if (fprintf(fh, "%s\n", line->str) < 0 || fflush(fh) == EOF) {
+    /* A partial record would make everything after it suspect; drop the
+       whole journal and fall back to the in-memory comments. */
+    fclose(fh);
+    ws_unlink(jnl_name);
+  } else {
+    fclose(fh);
+  }
+  g_string_free(line, TRUE);
+  g_free(jnl_name);
+}
+
+guint
+comment_journal_replay(capture_file *cf)
+{
+  gchar          *jnl_name;
+  gchar          *contents;
+  gchar         **jnl_lines;
+  gchar         **fields;
+  GHashTable     *latest;
+  GHashTableIter  iter;
+  gpointer        key, value;
+  gint64          cap_size, cap_mtime, jnl_size, jnl_mtime;
+  int             version;
+  guint           i, j, restored = 0;
+  guint64         frame_num;
+  frame_data     *fd;
+  wtap_block_t    pkt_block;
+  gsize           decoded_len;
+  guchar         *decoded;
+  guint           old_comments, new_comments;
+
+  if (cf->is_tempfile)
+    return 0;
+
+  jnl_name = comment_journal_filename(cf);
+  if (!g_file_get_contents(jnl_name, &contents, NULL, NULL)) {
+    g_free(jnl_name);
+    return 0;
+  }
+  jnl_lines = g_strsplit(contents, "\n", -1);
+  g_free(contents);
+
+  /* Validate the header; a journal left over from a capture file that
+     has since been rewritten or replaced is stale. */
+  if (!comment_journal_fingerprint(cf, &cap_size, &cap_mtime) ||
+      jnl_lines[0] == NULL ||
+      sscanf(jnl_lines[0],
+             COMMENT_JOURNAL_MAGIC " %d %" G_GINT64_MODIFIER "d %" G_GINT64_MODIFIER "d",
+             &version, &jnl_size, &jnl_mtime) != 3 ||
+      version != COMMENT_JOURNAL_VERSION ||
+      jnl_size != cap_size || jnl_mtime != cap_mtime) {
+    ws_message("Comment journal for \"%s\" is stale or invalid; removing it",
+               cf->filename);
+    ws_unlink(jnl_name);
+    g_strfreev(jnl_lines);
+    g_free(jnl_name);
+    return 0;
+  }
+
+  /* Only the last record for a frame matters. */
+  latest = g_hash_table_new(g_direct_hash, g_direct_equal);
+  for (i = 1; jnl_lines[i] != NULL; i++) {
+    if (sscanf(jnl_lines[i], "%" G_GINT64_MODIFIER "u", &frame_num) != 1)
+      continue;
+    if (frame_num == 0 || frame_num > cf->count)
+      continue;
+    g_hash_table_insert(latest, GUINT_TO_POINTER((guint)frame_num),
+                        jnl_lines[i]);
+  }
+
+  cj_replaying = TRUE;
+  g_hash_table_iter_init(&iter, latest);
+  while (g_hash_table_iter_next(&iter, &key, &value)) {
+    fd = frame_data_sequence_find(cf->provider.frames,
+                                  GPOINTER_TO_UINT(key));
+    if (fd == NULL)
+      continue;
+
+    pkt_block = cf_get_packet_block(cf, fd);
+    if (pkt_block == NULL)
+      pkt_block = wtap_block_create(WTAP_BLOCK_PACKET);
+    old_comments = wtap_block_count_option(pkt_block, OPT_COMMENT);
+
+    /* The record holds the frame's full comment set; replace whatever
+       the block from the file has. */
+    while (wtap_block_count_option(pkt_block, OPT_COMMENT) > 0)
+      wtap_block_remove_nth_option_instance(pkt_block, OPT_COMMENT, 0);
+
+    fields = g_strsplit((const gchar *)value, " ", -1);
+    for (j = 1; fields[j] != NULL; j++) {
+      if (fields[j][0] == '\0')
+        continue;
+      decoded = g_base64_decode(fields[j], &decoded_len);
+      if (decoded == NULL)
+        continue;
+      wtap_block_add_string_option(pkt_block, OPT_COMMENT,
+                                   (const char *)decoded, decoded_len);
+      g_free(decoded);
+    }
+    g_strfreev(fields);
+
+    new_comments = wtap_block_count_option(pkt_block, OPT_COMMENT);
+    cap_file_provider_set_modified_block(&cf->provider, fd, pkt_block);
+    cf->packet_comment_count += new_comments - old_comments;
+    restored++;
+  }
+  cj_replaying = FALSE;
+
+  g_hash_table_destroy(latest);
+  g_strfreev(jnl_lines);
+  g_free(jnl_name);
+
+  if (restored > 0) {
+    /* The replayed comments exist only in the journal, not in the
+       capture file itself, until the next full save merges them. */
+    cf->unsaved_changes = TRUE;
+    expert_update_comment_count(cf->packet_comment_count);
+    ws_info("Replayed comment journal for \"%s\" (%u frames)", cf->filename,
+            restored);
+  }
+  return restored;
+}
+
+void
+comment_journal_delete(capture_file *cf)
+{
+  gchar *jnl_name;
+
+  jnl_name = comment_journal_filename(cf);
+  ws_unlink(jnl_name);
+  g_free(jnl_name);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 2
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=2 tabstop=8 expandtab:
+ * :indentSize=2:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,76 @@
+/* comment_journal.h
+ * Sidecar append-only journal for packet comments
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __COMMENT_JOURNAL_H__
+#define __COMMENT_JOURNAL_H__
+
+#include "cfile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * A comment journal is a sidecar file ("<capture>.wscmt") holding packet
+ * comments that have been added or edited but not yet saved into the
+ * capture file itself.  Saving comments into a pcapng file requires
+ * rewriting the whole file, which for a large capture can take minutes;
+ * the journal lets each edit be persisted immediately with a single
+ * appended record instead.
+ *
+ * Each record holds a frame number and that frame's complete comment
+ * set, so the journal can simply be replayed in order with the last
+ * record for a frame winning.  The journal is validated against the
+ * capture file's size and modification time, replayed into the modified
+ * blocks when the file is opened (leaving the capture marked as having
+ * unsaved changes), and deleted once a full save merges the comments
+ * into standard pcapng options.
+ */
+
+/**
+ * Append a record for a frame whose block was just modified.  Failures
+ * are not fatal; the comments are still in memory and will be written
+ * out by the next full save.
+ */
+extern void comment_journal_record(capture_file *cf, guint32 frame_num,
+                                   wtap_block_t pkt_block);
+
+/**
+ * Replay a sidecar journal for cf->filename, if a valid one exists,
+ * into the provider's modified blocks.  Returns the number of frames
+ * whose comments were restored; if any were, the capture is marked as
+ * having unsaved changes.  A stale journal is deleted.
+ */
+extern guint comment_journal_replay(capture_file *cf);
+
+/**
+ * Delete the sidecar journal for cf->filename.  Call after a successful
+ * save, which merges the comments into the capture file itself.
+ */
+extern void comment_journal_delete(capture_file *cf);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __COMMENT_JOURNAL_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 2
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=2 tabstop=8 expandtab:
+ * :indentSize=2:tabSize=8:noTabs=true:
+ */
@@ -119,7 +119,12 @@ FILE *debug_log;   /* for logging debug messages to  */
                    /*  is defined                    */
 #endif
 
-static GAsyncQueue *pcap_queue;
+/* Protects the queued byte/packet accounting below, which is shared by
+   all capture threads, and is the writer thread's wakeup condition.
+   The queued blocks themselves live in per-source queues (see
+   capture_src), so capture threads never contend with each other. */
+static GMutex pcap_queue_mtx;
+static GCond  pcap_queue_cond;
 static gint64 pcap_queue_bytes;
 static gint64 pcap_queue_packets;
 static gint64 pcap_queue_byte_limit = 0;
@@ -187,6 +192,7 @@ typedef struct _pcapng_pipe_info {
 } pcapng_pipe_info_t;
 
 struct _loop_data; /* forward declaration so we can use it in the cap_pipe_dispatch function pointer */
+struct _pcap_queue_element; /* forward declaration for the per-source write queue head */
 
 /*
  * A source of packets from which we're capturing.
@@ -202,6 +208,8 @@ typedef struct _capture_src {
     gboolean                     pcap_err;
     guint                        interface_id;
     GThread                     *tid;
+    GAsyncQueue                 *write_q;                /**< Blocks captured on this source, awaiting the writer thread */
+    struct _pcap_queue_element  *write_q_head;           /**< Staged head of write_q, owned by the writer's timestamp merge */
     int                          snaplen;
     int                          linktype;
     gboolean                     ts_nsec;                /**< TRUE if we're using nanosecond precision. */
@@ -903,9 +911,54 @@ print_machine_readable_if_capabilities(if_capabilities_t *caps, int queries)
 
 typedef struct {
     char *name;
-    pcap_t *pch;
+    pcap_t *pch;        /* NULL if the counters are read from sysfs */
+#ifdef __linux__
+    guint64 base_recv;  /* sysfs counters at setup time, so that the */
+    guint64 base_drop;  /* reported values start at zero like pcap's */
+#endif
 } if_stat_t;
 
+#ifdef __linux__
+/*
+ * Read one counter from /sys/class/net/<iface>/statistics.
+ */
+static gboolean
+sysfs_get_if_counter(const char *ifname, const char *counter, guint64 *value)
+{
+    gchar *path;
+    gchar *contents;
+    gboolean ok = FALSE;
+
+    path = g_strdup_printf("/sys/class/net/%s/statistics/%s", ifname, counter);
+    if (g_file_get_contents(path, &contents, NULL, NULL)) {
+        *value = g_ascii_strtoull(contents, NULL, 10);
+        g_free(contents);
+        ok = TRUE;
+    }
+    g_free(path);
+    return ok;
+}
+
+/*
+ * Get the counters we report for an interface from sysfs. A capture
+ * handle sees traffic in both directions, so count rx and tx packets;
+ * rx_dropped is the closest match for pcap's kernel drop counter.
+ */
+static gboolean
+sysfs_get_if_counters(const char *ifname, guint64 *recv, guint64 *drop)
+{
+    guint64 rx_packets, tx_packets;
+
+    if (!sysfs_get_if_counter(ifname, "rx_packets", &rx_packets) ||
+        !sysfs_get_if_counter(ifname, "tx_packets", &tx_packets) ||
+        !sysfs_get_if_counter(ifname, "rx_dropped", drop)) {
+        return FALSE;
+    }
+    *recv = rx_packets + tx_packets;
+    return TRUE;
+}
+#endif /* __linux__ */
+
 /* Print the number of packets captured for each interface until we're killed. */
 static int
 print_statistics_loop(gboolean machine_readable)
@@ -941,6 +994,25 @@ print_statistics_loop(gboolean machine_readable)
             ws_debug("Skipping interface %s for stats", if_info->name);
             continue;
         }
+
+        /* Most Linux network devices export their counters in sysfs;
+         * reading those avoids opening a capture handle per interface
+         * just to sample statistics. Interfaces without sysfs counters
+         * fall back to a capture handle below.
+         */
+        {
+            guint64 base_recv, base_drop;
+
+            if (sysfs_get_if_counters(if_info->name, &base_recv, &base_drop)) {
+                if_stat = g_new(if_stat_t, 1);
+                if_stat->name = g_strdup(if_info->name);
+                if_stat->pch = NULL;
+                if_stat->base_recv = base_recv;
+                if_stat->base_drop = base_drop;
+                stat_list = g_list_append(stat_list, if_stat);
+                continue;
+            }
+        }
 #endif
 
 #ifdef HAVE_PCAP_OPEN
@@ -976,6 +1048,20 @@ print_statistics_loop(gboolean machine_readable)
     while (global_ld.go) {
         for (stat_entry = g_list_first(stat_list); stat_entry != NULL; stat_entry = g_list_next(stat_entry)) {
             if_stat = (if_stat_t *)stat_entry->data;
+#ifdef __linux__
+            if (if_stat->pch == NULL) {
+                guint64 recv, drop;
+
+                if (sysfs_get_if_counters(if_stat->name, &recv, &drop)) {
+                    ps.ps_recv = (u_int)(recv - if_stat->base_recv);
+                    ps.ps_drop = (u_int)(drop - if_stat->base_drop);
+                } else {
+                    /* the interface went away; report no activity */
+                    ps.ps_recv = 0;
+                    ps.ps_drop = 0;
+                }
+            } else
+#endif
             pcap_stats(if_stat->pch, &ps);
 
             if (!machine_readable) {
@@ -1001,7 +1087,8 @@ print_statistics_loop(gboolean machine_readable)
     /* XXX - Not reached.  Should we look for 'q' in stdin? */
     for (stat_entry = g_list_first(stat_list); stat_entry != NULL; stat_entry = g_list_next(stat_entry)) {
         if_stat = (if_stat_t *)stat_entry->data;
-        pcap_close(if_stat->pch);
+        if (if_stat->pch != NULL)
+            pcap_close(if_stat->pch);
         g_free(if_stat->name);
         g_free(if_stat);
     }
@@ -3397,15 +3484,22 @@ capture_loop_dispatch(loop_data *ld,
                  * "select()" says we can read from it without blocking; go for
                  * it.
                  *
-                 * We don't have pcap_breakloop(), so we only process one packet
-                 * per pcap_dispatch() call, to allow a signal to stop the
-                 * processing immediately, rather than processing all packets
-                 * in a batch before quitting.
+                 * Process everything that's already been delivered in one
+                 * pcap_dispatch() call rather than one packet at a time.
+                 * With a memory-mapped capture (TPACKET_V3 on Linux) the
+                 * kernel hands us a whole ring block per wakeup, and going
+                 * back through select() after every packet costs two system
+                 * calls per packet - enough to cause drops at high rates.
+                 * This is safe because capture_loop_stop() does a
+                 * pcap_breakloop(), so a signal still stops a batch
+                 * promptly, and the per-packet callbacks ignore packets
+                 * once the "stop capturing" flag is set, so -c and the
+                 * autostop limits remain exact.
                  */
                 if (use_threads) {
-                    inpkts = pcap_dispatch(pcap_src->pcap_h, 1, capture_loop_queue_packet_cb, (u_char *)pcap_src);
+                    inpkts = pcap_dispatch(pcap_src->pcap_h, -1, capture_loop_queue_packet_cb, (u_char *)pcap_src);
                 } else {
-                    inpkts = pcap_dispatch(pcap_src->pcap_h, 1, capture_loop_write_packet_cb, (u_char *)pcap_src);
+                    inpkts = pcap_dispatch(pcap_src->pcap_h, -1, capture_loop_write_packet_cb, (u_char *)pcap_src);
                 }
                 if (inpkts < 0) {
                     if (inpkts == -1) {
@@ -3805,44 +3899,123 @@ pcap_read_handler(void* arg)
     return (NULL);
 }
 
-/* Try to pop an item off the packet queue and if it exists, write it */
+/* Ordering key, in nanoseconds, for the writer's merge across capture
+   sources.  Blocks without a timestamp (SHBs, IDBs, ...) sort first, so
+   they're written as soon as they reach the head of their queue. */
+static guint64
+capture_queue_element_timestamp(const pcap_queue_element *queue_element)
+{
+    if (queue_element->pcap_src->from_pcapng) {
+        if (queue_element->u.bh.block_type == BLOCK_TYPE_EPB) {
+            /* The EPB timestamp follows the interface ID.  Its units are
+               the interface's if_tsresol; we assume the default microsecond
+               resolution, which is what dumpcap itself writes. */
+            guint32 ts_high, ts_low;
+            memcpy(&ts_high, queue_element->pd + sizeof(pcapng_block_header_t) + 4, 4);
+            memcpy(&ts_low, queue_element->pd + sizeof(pcapng_block_header_t) + 8, 4);
+            return ((((guint64)ts_high) << 32) | ts_low) * 1000;
+        }
+        return 0;
+    }
+    if (queue_element->pcap_src->ts_nsec) {
+        return (guint64)queue_element->u.phdr.ts.tv_sec * 1000000000 +
+               queue_element->u.phdr.ts.tv_usec;
+    }
+    return ((guint64)queue_element->u.phdr.ts.tv_sec * 1000000 +
+            queue_element->u.phdr.ts.tv_usec) * 1000;
+}
+
+/* Stage the head block of each source's write queue.  Returns the source
+   whose staged block has the oldest timestamp, or NULL if every queue is
+   empty.  Staged blocks stay staged until the writer consumes them, so
+   each queue is only ever popped in order. */
+static capture_src *
+capture_queue_stage_heads(void)
+{
+    capture_src *pcap_src, *next_src = NULL;
+    guint64      ts, next_ts = 0;
+    guint        i;
+
+    for (i = 0; i < global_ld.pcaps->len; i++) {
+        pcap_src = g_array_index(global_ld.pcaps, capture_src *, i);
+        if (pcap_src->write_q == NULL) {
+            continue;
+        }
+        if (pcap_src->write_q_head == NULL) {
+            pcap_src->write_q_head = (pcap_queue_element *)g_async_queue_try_pop(pcap_src->write_q);
+        }
+        if (pcap_src->write_q_head == NULL) {
+            continue;
+        }
+        ts = capture_queue_element_timestamp(pcap_src->write_q_head);
+        if (next_src == NULL || ts < next_ts) {
+            next_src = pcap_src;
+            next_ts = ts;
+        }
+    }
+    return next_src;
+}
+
+/* Merge the per-source write queues and write the staged block with the
+   oldest timestamp, if any.  Per-source order is preserved by the queues;
+   the merge keeps the output file close to globally timestamp-ordered
+   when capturing from several sources at once. */
 static gboolean
 capture_loop_dequeue_packet(void) {
+    capture_src        *pcap_src;
     pcap_queue_element *queue_element;
 
-    g_async_queue_lock(pcap_queue);
-    queue_element = (pcap_queue_element *)g_async_queue_timeout_pop_unlocked(pcap_queue, WRITER_THREAD_TIMEOUT);
-    if (queue_element) {
-        if (queue_element->pcap_src->from_pcapng) {
-            pcap_queue_bytes -= queue_element->u.bh.block_total_length;
-        } else {
-            pcap_queue_bytes -= queue_element->u.phdr.caplen;
+    pcap_src = capture_queue_stage_heads();
+    if (pcap_src == NULL) {
+        /* Every queue is empty; wait for a capture thread to hand us
+           something, but no longer than the writer timeout.  Capture
+           threads push and signal with the mutex held, so re-staging
+           under the mutex can't miss a wakeup. */
+        g_mutex_lock(&pcap_queue_mtx);
+        pcap_src = capture_queue_stage_heads();
+        if (pcap_src == NULL) {
+            g_cond_wait_until(&pcap_queue_cond, &pcap_queue_mtx,
+                              g_get_monotonic_time() + WRITER_THREAD_TIMEOUT);
+        }
+        g_mutex_unlock(&pcap_queue_mtx);
+        if (pcap_src == NULL) {
+            pcap_src = capture_queue_stage_heads();
+        }
+        if (pcap_src == NULL) {
+            return FALSE;
         }
-        pcap_queue_packets -= 1;
     }
-    g_async_queue_unlock(pcap_queue);
-    if (queue_element) {
-        if (queue_element->pcap_src->from_pcapng) {
-            ws_info("Dequeued a block of type 0x%08x of length %d captured on interface %d.",
-                  queue_element->u.bh.block_type, queue_element->u.bh.block_total_length,
-                  queue_element->pcap_src->interface_id);
+    queue_element = pcap_src->write_q_head;
+    pcap_src->write_q_head = NULL;
 
-            capture_loop_write_pcapng_cb(queue_element->pcap_src,
-                                        &queue_element->u.bh,
-                                        queue_element->pd);
-        } else {
-            ws_info("Dequeued a packet of length %d captured on interface %d.",
-                queue_element->u.phdr.caplen, queue_element->pcap_src->interface_id);
+    g_mutex_lock(&pcap_queue_mtx);
+    if (pcap_src->from_pcapng) {
+        pcap_queue_bytes -= queue_element->u.bh.block_total_length;
+    } else {
+        pcap_queue_bytes -= queue_element->u.phdr.caplen;
+    }
+    pcap_queue_packets -= 1;
+    g_mutex_unlock(&pcap_queue_mtx);
 
-            capture_loop_write_packet_cb((u_char *) queue_element->pcap_src,
-                                        &queue_element->u.phdr,
-                                        queue_element->pd);
-        }
-        g_free(queue_element->pd);
-        g_free(queue_element);
-        return TRUE;
+    if (pcap_src->from_pcapng) {
+        ws_info("Dequeued a block of type 0x%08x of length %d captured on interface %d.",
+              queue_element->u.bh.block_type, queue_element->u.bh.block_total_length,
+              pcap_src->interface_id);
+
+        capture_loop_write_pcapng_cb(pcap_src,
+                                    &queue_element->u.bh,
+                                    queue_element->pd);
+    } else {
+        ws_info("Dequeued a packet of length %d captured on interface %d.",
+            queue_element->u.phdr.caplen, pcap_src->interface_id);
+
+        capture_loop_write_packet_cb((u_char *) pcap_src,
+                                    &queue_element->u.phdr,
+                                    queue_element->pd);
     }
-    return FALSE;
+    g_free(queue_element->pd);
+    g_free(queue_element);
+    return TRUE;
 }
 
 /*
@@ -4035,11 +4208,14 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
     /* WOW, everything is prepared! */
     /* please fasten your seat belts, we will enter now the actual capture loop */
     if (use_threads) {
-        pcap_queue = g_async_queue_new();
         pcap_queue_bytes = 0;
         pcap_queue_packets = 0;
         for (i = 0; i < global_ld.pcaps->len; i++) {
             pcap_src = g_array_index(global_ld.pcaps, capture_src *, i);
+            /* Give each source its own queue, so capture threads only
+               ever contend with the writer, not with each other. */
+            pcap_src->write_q = g_async_queue_new();
+            pcap_src->write_q_head = NULL;
             /* XXX - Add an interface name here? */
             pcap_src->tid = g_thread_new("Capture read", pcap_read_handler, pcap_src);
         }
@@ -4654,17 +4830,18 @@ capture_loop_queue_packet_cb(u_char *pcap_src_p, const struct pcap_pkthdr *phdr,
         return;
     }
     memcpy(queue_element->pd, pd, phdr->caplen);
-    g_async_queue_lock(pcap_queue);
+    g_mutex_lock(&pcap_queue_mtx);
     if (((pcap_queue_byte_limit == 0) || (pcap_queue_bytes < pcap_queue_byte_limit)) &&
         ((pcap_queue_packet_limit == 0) || (pcap_queue_packets < pcap_queue_packet_limit))) {
         limit_reached = FALSE;
-        g_async_queue_push_unlocked(pcap_queue, queue_element);
+        g_async_queue_push(pcap_src->write_q, queue_element);
         pcap_queue_bytes += phdr->caplen;
         pcap_queue_packets += 1;
+        g_cond_signal(&pcap_queue_cond);
     } else {
         limit_reached = TRUE;
     }
-    g_async_queue_unlock(pcap_queue);
+    g_mutex_unlock(&pcap_queue_mtx);
     if (limit_reached) {
         pcap_src->dropped++;
         g_free(queue_element->pd);
@@ -4711,17 +4888,18 @@ capture_loop_queue_pcapng_cb(capture_src *pcap_src, const pcapng_block_header_t
         return;
     }
     memcpy(queue_element->pd, pd, bh->block_total_length);
-    g_async_queue_lock(pcap_queue);
+    g_mutex_lock(&pcap_queue_mtx);
     if (((pcap_queue_byte_limit == 0) || (pcap_queue_bytes < pcap_queue_byte_limit)) &&
         ((pcap_queue_packet_limit == 0) || (pcap_queue_packets < pcap_queue_packet_limit))) {
         limit_reached = FALSE;
-        g_async_queue_push_unlocked(pcap_queue, queue_element);
+        g_async_queue_push(pcap_src->write_q, queue_element);
         pcap_queue_bytes += bh->block_total_length;
         pcap_queue_packets += 1;
+        g_cond_signal(&pcap_queue_cond);
     } else {
         limit_reached = TRUE;
     }
-    g_async_queue_unlock(pcap_queue);
+    g_mutex_unlock(&pcap_queue_mtx);
     if (limit_reached) {
         pcap_src->dropped++;
         g_free(queue_element->pd);
@@ -73,6 +73,7 @@
 #include <ui/exit_codes.h>
 #include <wsutil/filesystem.h>
 #include <wsutil/file_util.h>
+#include <wsutil/glib-compat.h>
 #include <wsutil/wsgcrypt.h>
 #include <wsutil/plugins.h>
 #include <wsutil/privileges.h>
@@ -125,6 +126,10 @@ static int       cur_dup_entry = 0;
 
 static guint32   ignored_bytes  = 0;  /* Used with -I */
 
+/* Capture comparison (--compare) */
+static gboolean  do_compare     = FALSE;
+static double    compare_window = 1.0;  /* seconds */
+
 #define ONE_BILLION 1000000000
 
 /* Weights of different errors we can introduce */
@@ -174,6 +179,7 @@ static gboolean               have_starttime            = FALSE;
 static nstime_t               stoptime                  = NSTIME_INIT_ZERO;
 static gboolean               have_stoptime             = FALSE;
 static gboolean               check_startstop           = FALSE;
+static gboolean               stop_after_stoptime       = FALSE;
 static gboolean               rem_vlan                  = FALSE;
 static gboolean               dup_detect                = FALSE;
 static gboolean               dup_detect_by_time        = FALSE;
@@ -593,6 +599,149 @@ remove_vlan_info(const wtap_packet_header *phdr, guint8* fd, guint32* len) {
     }
 }
 
+/*
+ * For --snap-headers: return the number of bytes occupied by the
+ * link-layer, network-layer and transport-layer headers of a packet,
+ * walking the headers directly in the raw bytes.  Returns 0 if the
+ * headers can't be parsed far enough (unhandled link layer, unknown
+ * payload protocol, truncated header); the caller then leaves the
+ * packet alone rather than risk cutting into something we didn't
+ * understand.
+ */
+static guint32
+header_snap_length(const wtap_packet_header *phdr, const guint8 *pd)
+{
+    guint32 caplen = phdr->caplen;
+    guint32 offset;
+    guint16 etype;
+    guint8  ip_proto;
+
+    switch (phdr->pkt_encap) {
+
+    case WTAP_ENCAP_ETHERNET:
+        if (caplen < 14)
+            return 0;
+        offset = 12;
+        etype = pntoh16(pd + offset);
+        /* Step over VLAN tags. */
+        while (etype == ETHERTYPE_VLAN || etype == ETHERTYPE_IEEE_802_1AD ||
+               etype == ETHERTYPE_QINQ_OLD) {
+            offset += 4;
+            if (caplen < offset + 2)
+                return 0;
+            etype = pntoh16(pd + offset);
+        }
+        if (etype != ETHERTYPE_IP && etype != ETHERTYPE_IPv6)
+            return 0;
+        offset += 2;
+        break;
+
+    case WTAP_ENCAP_RAW_IP:
+        offset = 0;
+        break;
+
+    default:
+        return 0;
+    }
+
+    /* Network layer */
+    if (caplen < offset + 1)
+        return 0;
+    switch (pd[offset] >> 4) {
+
+    case 4:
+    {
+        guint32 hlen;
+
+        if (caplen < offset + 20)
+            return 0;
+        hlen = (pd[offset] & 0x0f) * 4;
+        if (hlen < 20 || caplen < offset + hlen)
+            return 0;
+        ip_proto = pd[offset + 9];
+        /* Later fragments carry payload, not a transport header. */
+        if ((pntoh16(pd + offset + 6) & 0x1fff) != 0)
+            return offset + hlen;
+        offset += hlen;
+        break;
+    }
+
+    case 6:
+    {
+        guint8 nxt;
+
+        if (caplen < offset + 40)
+            return 0;
+        nxt = pd[offset + 6];
+        offset += 40;
+        /* Extension headers belong to the header chain; keep them. */
+        for (;;) {
+            if (nxt == 0 || nxt == 43 || nxt == 60) {
+                /* hop-by-hop options, routing, destination options */
+                if (caplen < offset + 8)
+                    return 0;
+                nxt = pd[offset];
+                offset += (pd[offset + 1] + 1) * 8;
+                if (caplen < offset)
+                    return 0;
+            } else if (nxt == 44) {
+                /* fragment header; only the first fragment is followed
+                   by a transport header */
+                gboolean first;
+
+                if (caplen < offset + 8)
+                    return 0;
+                nxt = pd[offset];
+                first = (pntoh16(pd + offset + 2) & 0xfff8) == 0;
+                offset += 8;
+                if (!first)
+                    return offset;
+            } else {
+                break;
+            }
+        }
+        ip_proto = nxt;
+        break;
+    }
+
+    default:
+        return 0;
+    }
+
+    /* Transport layer */
+    switch (ip_proto) {
+
+    case 6:     /* TCP, keeping the options */
+    {
+        guint32 thlen;
+
+        if (caplen < offset + 20)
+            return 0;
+        thlen = (pd[offset + 12] >> 4) * 4;
+        if (thlen < 20)
+            return 0;
+        /* May exceed caplen for a short snapshot; the caller only
+           truncates, never extends. */
+        return offset + thlen;
+    }
+
+    case 17:    /* UDP */
+        return offset + 8;
+
+    case 132:   /* SCTP common header */
+        return offset + 12;
+
+    case 1:     /* ICMP */
+    case 58:    /* ICMPv6 */
+        return offset + 8;
+
+    default:
+        /* ESP, GRE, tunnels, ...: we don't know where the payload
+           starts, so keep all of it. */
+        return 0;
+    }
+}
+
 static gboolean
 is_duplicate(guint8* fd, guint32 len) {
     int i;
@@ -754,6 +903,288 @@ is_duplicate_rel_time(guint8* fd, guint32 len, const nstime_t *current) {
     return FALSE;
 }
 
+/*
+ * Capture comparison (--compare).
+ *
+ * Both files are read in parallel in timestamp order, much as merging
+ * would interleave them, and every packet is fingerprinted with the same
+ * MD5-over-content digest the duplicate detection above uses (honoring
+ * -I). A packet with no pending partner is parked; a packet whose digest
+ * matches a pending packet from the other file is reported as a match
+ * with its tap-to-tap delay. Pending packets older than the comparison
+ * time window are reported as seen on one side only and discarded, so
+ * memory use is bounded by the window contents, not the file sizes.
+ */
+
+typedef struct _cmp_key_t {
+    guint8     digest[16];
+    guint32    len;
+} cmp_key_t;
+
+typedef struct _cmp_entry_t {
+    cmp_key_t  key;
+    int        side;      /* 0 = first file, 1 = second file */
+    guint32    frame;     /* frame number within its file */
+    nstime_t   ts;
+    gboolean   matched;   /* paired already; kept for lazy removal */
+} cmp_entry_t;
+
+typedef struct _cmp_state_t {
+    GHashTable *pending;  /* cmp_key_t * -> GQueue of unmatched cmp_entry_t * */
+    GQueue      arrivals; /* every pending entry, in arrival order */
+    guint32     count[2];
+    guint32     matched;
+    guint32     only[2];  /* packets never seen in the other file */
+    double      delay_min;
+    double      delay_max;
+    double      delay_sum;
+} cmp_state_t;
+
+static guint
+cmp_key_hash(gconstpointer key)
+{
+    guint hash;
+
+    /* The digest is uniformly distributed; any four bytes of it will do. */
+    memcpy(&hash, ((const cmp_key_t *)key)->digest, sizeof hash);
+    return hash;
+}
+
+static gboolean
+cmp_key_equal(gconstpointer a, gconstpointer b)
+{
+    const cmp_key_t *ka = (const cmp_key_t *)a;
+    const cmp_key_t *kb = (const cmp_key_t *)b;
+
+    return ka->len == kb->len && memcmp(ka->digest, kb->digest, 16) == 0;
+}
+
+static void
+cmp_key_init(cmp_key_t *key, const guint8 *fd, guint32 len)
+{
+    /* Hint to ignore some bytes at the start of the frame for the digest calculation(-I option) */
+    guint32 offset = ignored_bytes;
+
+    if (len <= ignored_bytes)
+        offset = 0;
+
+    gcry_md_hash_buffer(GCRY_MD_MD5, key->digest, &fd[offset], len - offset);
+    key->len = len;
+}
+
+/* Remove an entry from its per-digest queue (not from the arrival queue;
+ * that one is reaped lazily). */
+static void
+cmp_entry_unlink(cmp_state_t *state, cmp_entry_t *entry)
+{
+    GQueue *q = (GQueue *)g_hash_table_lookup(state->pending, &entry->key);
+
+    if (q != NULL) {
+        g_queue_remove(q, entry);
+        if (g_queue_is_empty(q)) {
+            g_queue_free(q);
+            g_hash_table_remove(state->pending, &entry->key);
+        }
+    }
+}
+
+/* Report and drop pending entries that have aged out of the comparison
+ * window; with a NULL current time, drain everything (end of input). */
+static void
+cmp_expire(cmp_state_t *state, const nstime_t *now)
+{
+    cmp_entry_t *entry;
+
+    while ((entry = (cmp_entry_t *)g_queue_peek_head(&state->arrivals)) != NULL) {
+        if (!entry->matched && now != NULL) {
+            nstime_t delta;
+
+            nstime_delta(&delta, now, &entry->ts);
+            if (nstime_to_sec(&delta) <= compare_window)
+                break;
+        }
+        g_queue_pop_head(&state->arrivals);
+        if (!entry->matched) {
+            state->only[entry->side]++;
+            if (verbose)
+                printf("Frame %u (%u bytes) only in file %c\n",
+                       entry->frame, entry->key.len, 'A' + entry->side);
+            cmp_entry_unlink(state, entry);
+        }
+        g_free(entry);
+    }
+}
+
+static void
+cmp_process_packet(cmp_state_t *state, int side, guint32 frame,
+                   const wtap_rec *rec, const guint8 *fd)
+{
+    cmp_key_t    key;
+    GQueue      *q;
+    GList       *l;
+    cmp_entry_t *entry = NULL;
+
+    state->count[side]++;
+    if (rec->presence_flags & WTAP_HAS_TS)
+        cmp_expire(state, &rec->ts);
+
+    cmp_key_init(&key, fd, rec->rec_header.packet_header.caplen);
+
+    /* Find the oldest pending packet from the other file with this digest. */
+    q = (GQueue *)g_hash_table_lookup(state->pending, &key);
+    if (q != NULL) {
+        for (l = q->head; l != NULL; l = l->next) {
+            cmp_entry_t *cand = (cmp_entry_t *)l->data;
+
+            if (cand->side != side) {
+                entry = cand;
+                break;
+            }
+        }
+    }
+
+    if (entry != NULL) {
+        nstime_t delta;
+        double   delay;
+
+        /* Delay is always second file minus first file, whichever of the
+         * two packets was read first. */
+        if (side == 1)
+            nstime_delta(&delta, &rec->ts, &entry->ts);
+        else
+            nstime_delta(&delta, &entry->ts, &rec->ts);
+        delay = nstime_to_sec(&delta);
+
+        state->matched++;
+        state->delay_sum += delay;
+        if (state->matched == 1 || delay < state->delay_min)
+            state->delay_min = delay;
+        if (state->matched == 1 || delay > state->delay_max)
+            state->delay_max = delay;
+
+        if (verbose) {
+            if (side == 1)
+                printf("Frame %u in file A = frame %u in file B, delay %.6f ms\n",
+                       entry->frame, frame, delay * 1000.0);
+            else
+                printf("Frame %u in file A = frame %u in file B, delay %.6f ms\n",
+                       frame, entry->frame, delay * 1000.0);
+        }
+
+        entry->matched = TRUE;
+        cmp_entry_unlink(state, entry);
+    } else {
+        entry = g_new(cmp_entry_t, 1);
+        entry->key = key;
+        entry->side = side;
+        entry->frame = frame;
+        entry->ts = rec->ts;
+        entry->matched = FALSE;
+
+        q = (GQueue *)g_hash_table_lookup(state->pending, &entry->key);
+        if (q == NULL) {
+            q = g_queue_new();
+            g_hash_table_insert(state->pending,
+                                g_memdup2(&entry->key, sizeof entry->key), q);
+        }
+        g_queue_push_tail(q, entry);
+        g_queue_push_tail(&state->arrivals, entry);
+    }
+}
+
+/* Read the next packet record from a file, skipping other record types.
+ * Returns FALSE at end of file or on a read error. */
+static gboolean
+cmp_read_packet(wtap *wth, const char *filename, wtap_rec *rec, Buffer *buf,
+                guint32 *frame)
+{
+    int    read_err      = 0;
+    gchar *read_err_info = NULL;
+    gint64 data_offset;
+
+    while (wtap_read(wth, rec, buf, &read_err, &read_err_info, &data_offset)) {
+        (*frame)++;
+        if (rec->rec_type == REC_TYPE_PACKET)
+            return TRUE;
+    }
+    if (read_err != 0)
+        cfile_read_failure_message(filename, read_err, read_err_info);
+    return FALSE;
+}
+
+static int
+compare_captures(const char *filename_a, const char *filename_b)
+{
+    const char  *filenames[2] = { filename_a, filename_b };
+    wtap        *wth[2]       = { NULL, NULL };
+    wtap_rec     rec[2];
+    Buffer       buf[2];
+    gboolean     have[2];
+    guint32      frame[2]     = { 0, 0 };
+    cmp_state_t  state;
+    int          read_err     = 0;
+    gchar       *read_err_info = NULL;
+    int          i;
+
+    for (i = 0; i < 2; i++) {
+        wth[i] = wtap_open_offline(filenames[i], WTAP_TYPE_AUTO, &read_err,
+                                   &read_err_info, FALSE);
+        if (wth[i] == NULL) {
+            cfile_open_failure_message(filenames[i], read_err, read_err_info);
+            if (i == 1)
+                wtap_close(wth[0]);
+            return INVALID_FILE;
+        }
+    }
+
+    memset(&state, 0, sizeof state);
+    state.pending = g_hash_table_new_full(cmp_key_hash, cmp_key_equal,
+                                          g_free, NULL);
+    g_queue_init(&state.arrivals);
+
+    for (i = 0; i < 2; i++) {
+        wtap_rec_init(&rec[i]);
+        ws_buffer_init(&buf[i], 1514);
+        have[i] = cmp_read_packet(wth[i], filenames[i], &rec[i], &buf[i],
+                                  &frame[i]);
+    }
+
+    /* Interleave the two files in timestamp order so the pending window
+     * only ever covers the comparison time window, not a whole file. */
+    while (have[0] || have[1]) {
+        if (have[0] && have[1])
+            i = (nstime_cmp(&rec[0].ts, &rec[1].ts) <= 0) ? 0 : 1;
+        else
+            i = have[0] ? 0 : 1;
+        cmp_process_packet(&state, i, frame[i], &rec[i],
+                           ws_buffer_start_ptr(&buf[i]));
+        have[i] = cmp_read_packet(wth[i], filenames[i], &rec[i], &buf[i],
+                                  &frame[i]);
+    }
+    cmp_expire(&state, NULL);
+
+    printf("File A: %s, %u packets\n", filename_a, state.count[0]);
+    printf("File B: %s, %u packets\n", filename_b, state.count[1]);
+    printf("Matched: %u\n", state.matched);
+    printf("Only in A: %u\n", state.only[0]);
+    printf("Only in B: %u\n", state.only[1]);
+    if (state.matched > 0) {
+        printf("Delay B-A (ms): min %.6f  mean %.6f  max %.6f\n",
+               state.delay_min * 1000.0,
+               state.delay_sum / state.matched * 1000.0,
+               state.delay_max * 1000.0);
+    }
+
+    g_hash_table_destroy(state.pending);
+    for (i = 0; i < 2; i++) {
+        ws_buffer_free(&buf[i]);
+        wtap_rec_cleanup(&rec[i]);
+        wtap_close(wth[i]);
+    }
+
+    return EXIT_SUCCESS;
+}
+
 static void
 print_usage(FILE *output)
 {
@@ -772,6 +1203,11 @@ print_usage(FILE *output)
     fprintf(output, "                         Time format for -A/-B options is\n");
     fprintf(output, "                         YYYY-MM-DDThh:mm:ss[.nnnnnnnnn][Z|+-hh:mm]\n");
     fprintf(output, "                         Unix epoch timestamps are also supported.\n");
+    fprintf(output, "  --stop-after-stop-time stop reading the input file after the first packet\n");
+    fprintf(output, "                         whose timestamp is at or after the -B stop time,\n");
+    fprintf(output, "                         instead of reading, and discarding, the rest of\n");
+    fprintf(output, "                         the file. Use this only if the input file's\n");
+    fprintf(output, "                         packets are in chronological order.\n");
     fprintf(output, "\n");
     fprintf(output, "Duplicate packet removal:\n");
     fprintf(output, "  --novlan               remove vlan info from packets before checking for duplicates.\n");
@@ -792,8 +1228,22 @@ print_usage(FILE *output)
     fprintf(output, "                         Useful when processing packets captured by multiple radios\n");
     fprintf(output, "                         on the same channel in the vicinity of each other.\n");
     fprintf(output, "\n");
+    fprintf(output, "Capture comparison:\n");
+    fprintf(output, "  --compare[=<time window>]\n");
+    fprintf(output, "                         don't write an output file; instead treat <infile> and\n");
+    fprintf(output, "                         <outfile> as two captures of the same traffic (e.g. from\n");
+    fprintf(output, "                         two taps), match packets by content digest arriving within\n");
+    fprintf(output, "                         <time window> seconds (default 1.0) of each other, and\n");
+    fprintf(output, "                         report per-file loss and per-packet delay. -I is honored\n");
+    fprintf(output, "                         when computing digests; -v prints per-packet results.\n");
+    fprintf(output, "\n");
     fprintf(output, "Packet manipulation:\n");
     fprintf(output, "  -s <snaplen>           truncate each packet to max. <snaplen> bytes of data.\n");
+    fprintf(output, "  --snap-headers         truncate each packet at the end of its transport\n");
+    fprintf(output, "                         header, keeping the link, network and transport\n");
+    fprintf(output, "                         headers (TCP options included) but dropping the\n");
+    fprintf(output, "                         payload. Packets whose headers can't be parsed are\n");
+    fprintf(output, "                         kept in full. -L is honored.\n");
     fprintf(output, "  -C [offset:]<choplen>  chop each packet by <choplen> bytes. Positive values\n");
     fprintf(output, "                         chop at the packet beginning, negative values at the\n");
     fprintf(output, "                         packet end. If an optional offset precedes the length,\n");
@@ -1103,6 +1553,9 @@ main(int argc, char *argv[])
 #define LONGOPT_DISCARD_ALL_SECRETS  LONGOPT_BASE_APPLICATION+5
 #define LONGOPT_CAPTURE_COMMENT      LONGOPT_BASE_APPLICATION+6
 #define LONGOPT_DISCARD_CAPTURE_COMMENT LONGOPT_BASE_APPLICATION+7
+#define LONGOPT_STOP_AFTER_STOPTIME  LONGOPT_BASE_APPLICATION+8
+#define LONGOPT_COMPARE              LONGOPT_BASE_APPLICATION+9
+#define LONGOPT_SNAP_HEADERS         LONGOPT_BASE_APPLICATION+10
 
     static const struct option long_options[] = {
         {"novlan", no_argument, NULL, LONGOPT_NO_VLAN},
@@ -1114,11 +1567,15 @@ main(int argc, char *argv[])
         {"version", no_argument, NULL, 'V'},
         {"capture-comment", required_argument, NULL, LONGOPT_CAPTURE_COMMENT},
         {"discard-capture-comment", no_argument, NULL, LONGOPT_DISCARD_CAPTURE_COMMENT},
+        {"stop-after-stop-time", no_argument, NULL, LONGOPT_STOP_AFTER_STOPTIME},
+        {"compare", optional_argument, NULL, LONGOPT_COMPARE},
+        {"snap-headers", no_argument, NULL, LONGOPT_SNAP_HEADERS},
         {0, 0, 0, 0 }
     };
 
     char         *p;
     guint32       snaplen            = 0; /* No limit               */
+    gboolean      snap_headers       = FALSE;
     chop_t        chop               = {0, 0, 0, 0, 0, 0}; /* No chop */
     gboolean      adjlen             = FALSE;
     wtap_dumper  *pdh                = NULL;
@@ -1274,6 +1731,32 @@ main(int argc, char *argv[])
             break;
         }
 
+        case LONGOPT_STOP_AFTER_STOPTIME:
+        {
+            stop_after_stoptime = TRUE;
+            break;
+        }
+
+        case LONGOPT_COMPARE:
+        {
+            do_compare = TRUE;
+            if (optarg != NULL) {
+                compare_window = get_positive_double(optarg, "compare time window");
+                if (compare_window == 0.0) {
+                    cmdarg_err("The specified compare time window is zero");
+                    ret = INVALID_OPTION;
+                    goto clean_exit;
+                }
+            }
+            break;
+        }
+
+        case LONGOPT_SNAP_HEADERS:
+        {
+            snap_headers = TRUE;
+            break;
+        }
+
         case 'a':
         {
             guint frame_number;
@@ -1531,6 +2014,18 @@ main(int argc, char *argv[])
         goto clean_exit;
     }
 
+    if (do_compare) {
+        /* In compare mode the two file arguments are both inputs and
+         * nothing is written. */
+        if ((argc - optind) != 2) {
+            cmdarg_err("--compare requires exactly two capture files");
+            ret = INVALID_OPTION;
+            goto clean_exit;
+        }
+        ret = compare_captures(argv[optind], argv[optind + 1]);
+        goto clean_exit;
+    }
+
     if (out_file_type_subtype == WTAP_FILE_TYPE_SUBTYPE_UNKNOWN) {
       /* default to pcapng   */
       out_file_type_subtype = wtap_pcapng_file_type_subtype();
@@ -1553,6 +2048,12 @@ main(int argc, char *argv[])
         goto clean_exit;
     }
 
+    if (stop_after_stoptime && !have_stoptime) {
+        fprintf(stderr, "editcap: --stop-after-stop-time requires a -B stop time\n");
+        ret = INVALID_OPTION;
+        goto clean_exit;
+    }
+
     if (split_packet_count != 0 && !nstime_is_unset(&secs_per_block)) {
         fprintf(stderr, "editcap: can't split on both packet count and time interval\n");
         fprintf(stderr, "editcap: at the same time\n");
@@ -1726,6 +2227,17 @@ main(int argc, char *argv[])
 
         rec = &read_rec;
 
+        /*
+         * The -B stop time is an upper bound on the timestamps of the
+         * packets we keep, so if the user has promised us that the input
+         * file is in chronological order, we can stop reading as soon as
+         * we see a packet at or past it, instead of reading, and
+         * discarding, the rest of the file.
+         */
+        if (stop_after_stoptime && (rec->presence_flags & WTAP_HAS_TS) &&
+            nstime_cmp(&rec->ts, &stoptime) >= 0)
+            break;
+
         /* Extra actions for the first packet */
         if (read_count == 1) {
             if (split_packet_count != 0 || !nstime_is_unset(&secs_per_block)) {
@@ -1969,6 +2481,21 @@ main(int argc, char *argv[])
             } /* time stamp adjustment */
 
             if (rec->rec_type == REC_TYPE_PACKET) {
+                if (snap_headers) {
+                    /* Truncate at the end of the transport header. */
+                    guint32 hdrlen = header_snap_length(&rec->rec_header.packet_header, buf);
+
+                    if (hdrlen != 0 && rec->rec_header.packet_header.caplen > hdrlen) {
+                        /* Copy and change rather than modify returned rec */
+                        temp_rec = *rec;
+                        temp_rec.rec_header.packet_header.caplen = hdrlen;
+                        /* If -L, also set reported length */
+                        if (adjlen && temp_rec.rec_header.packet_header.len > hdrlen)
+                            temp_rec.rec_header.packet_header.len = hdrlen;
+                        rec = &temp_rec;
+                    }
+                }
+
                 if (snaplen != 0) {
                     /* Limit capture length to snaplen */
                     if (rec->rec_header.packet_header.caplen > snaplen) {
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
 
 #include <wsutil/strtoi.h>
 #include <wsutil/ws_assert.h>
@@ -86,6 +87,7 @@
 
 #include <wsutil/report_message.h>
 #include <wsutil/file_util.h>
+#include <wsutil/glib-compat.h>
 #include <wsutil/pint.h>
 #include <wsutil/inet_addr.h>
 
@@ -202,6 +204,12 @@ typedef struct _vlan
 static wmem_map_t *ipxnet_hash_table = NULL;
 static wmem_map_t *ipv4_hash_table = NULL;
 static wmem_map_t *ipv6_hash_table = NULL;
+// Most-recently-returned entries from the two tables above. Addresses repeat
+// heavily within a capture (a packet's source and destination addresses are
+// typically looked up several times while it is dissected), so these satisfy
+// most lookups without hashing. They are reset together with the tables.
+static hashipv4_t *ipv4_hash_table_cache = NULL;
+static hashipv6_t *ipv6_hash_table_cache = NULL;
 // Maps guint -> hashvlan_t*
 static wmem_map_t *vlan_hash_table = NULL;
 static wmem_map_t *ss7pc_hash_table = NULL;
@@ -1069,18 +1077,22 @@ host_lookup(const guint addr)
 {
     hashipv4_t * volatile tp;
 
-    tp = (hashipv4_t *)wmem_map_lookup(ipv4_hash_table, GUINT_TO_POINTER(addr));
-    if (tp == NULL) {
-        /*
-         * We don't already have an entry for this host name; create one,
-         * and then try to resolve it.
-         */
-        tp = new_ipv4(addr);
-        fill_dummy_ip4(addr, tp);
-        wmem_map_insert(ipv4_hash_table, GUINT_TO_POINTER(addr), tp);
-    } else if (tp->flags & TRIED_OR_RESOLVED_MASK) {
-        return tp;
+    tp = ipv4_hash_table_cache;
+    if (tp == NULL || tp->addr != addr) {
+        tp = (hashipv4_t *)wmem_map_lookup(ipv4_hash_table, GUINT_TO_POINTER(addr));
+        if (tp == NULL) {
+            /*
+             * We don't already have an entry for this host name; create one,
+             * and then try to resolve it.
+             */
+            tp = new_ipv4(addr);
+            fill_dummy_ip4(addr, tp);
+            wmem_map_insert(ipv4_hash_table, GUINT_TO_POINTER(addr), tp);
+        }
+        ipv4_hash_table_cache = tp;
     }
+    if (tp->flags & TRIED_OR_RESOLVED_MASK)
+        return tp;
 
     /*
      * This hasn't been resolved yet, and we haven't tried to
@@ -1140,22 +1152,26 @@ host_lookup6(const ws_in6_addr *addr)
 {
     hashipv6_t * volatile tp;
 
-    tp = (hashipv6_t *)wmem_map_lookup(ipv6_hash_table, addr);
-    if (tp == NULL) {
-        /*
-         * We don't already have an entry for this host name; create one,
-         * and then try to resolve it.
-         */
-        ws_in6_addr *addr_key;
-
-        addr_key = wmem_new(wmem_epan_scope(), ws_in6_addr);
-        tp = new_ipv6(addr);
-        memcpy(addr_key, addr, 16);
-        fill_dummy_ip6(tp);
-        wmem_map_insert(ipv6_hash_table, addr_key, tp);
-    } else if (tp->flags & TRIED_OR_RESOLVED_MASK) {
-        return tp;
+    tp = ipv6_hash_table_cache;
+    if (tp == NULL || memcmp(tp->addr, addr->bytes, sizeof(tp->addr)) != 0) {
+        tp = (hashipv6_t *)wmem_map_lookup(ipv6_hash_table, addr);
+        if (tp == NULL) {
+            /*
+             * We don't already have an entry for this host name; create one,
+             * and then try to resolve it.
+             */
+            ws_in6_addr *addr_key;
+
+            addr_key = wmem_new(wmem_epan_scope(), ws_in6_addr);
+            tp = new_ipv6(addr);
+            memcpy(addr_key, addr, 16);
+            fill_dummy_ip6(tp);
+            wmem_map_insert(ipv6_hash_table, addr_key, tp);
+        }
+        ipv6_hash_table_cache = tp;
     }
+    if (tp->flags & TRIED_OR_RESOLVED_MASK)
+        return tp;
 
     /*
      * This hasn't been resolved yet, and we haven't tried to
@@ -1606,6 +1622,128 @@ add_manuf_name(const guint8 *addr, unsigned int mask, gchar *name, gchar *longna
     }
 } /* add_manuf_name */
 
+/*
+ * Binary cache of the parsed manuf and wka files.
+ *
+ * Parsing the manuf file (a couple of MB of text) is a measurable slice
+ * of startup, and the result only changes when the file does. So after a
+ * successful parse we dump the records into a flat per-user cache file,
+ * stamped with the size and mtime of both source files, and on the next
+ * start replay the records from the cache instead of parsing. Records
+ * are stored in host byte order; the cache never moves between machines.
+ */
+
+#define ENAME_MANUF_CACHE "manuf.cache"
+
+#define MANUF_CACHE_MAGIC   0x6d616e66  /* "manf" */
+#define MANUF_CACHE_VERSION 1
+
+typedef struct {
+    guint32 magic;
+    guint32 version;
+    guint64 manuf_size;
+    guint64 manuf_mtime;
+    guint64 wka_size;
+    guint64 wka_mtime;
+} manuf_cache_header_t;
+
+static void
+manuf_cache_stamp(manuf_cache_header_t *hdr)
+{
+    ws_statb64 st;
+
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = MANUF_CACHE_MAGIC;
+    hdr->version = MANUF_CACHE_VERSION;
+    if (ws_stat64(g_manuf_path, &st) == 0) {
+        hdr->manuf_size = (guint64)st.st_size;
+        hdr->manuf_mtime = (guint64)st.st_mtime;
+    }
+    if (ws_stat64(g_wka_path, &st) == 0) {
+        hdr->wka_size = (guint64)st.st_size;
+        hdr->wka_mtime = (guint64)st.st_mtime;
+    }
+}
+
+static void
+manuf_cache_append(GByteArray *cache, const ether_t *eth, unsigned int mask)
+{
+    guint32 mask32 = mask;
+
+    g_byte_array_append(cache, eth->addr, 6);
+    g_byte_array_append(cache, (const guint8 *)&mask32, sizeof(mask32));
+    g_byte_array_append(cache, (const guint8 *)eth->name,
+        (guint)strlen(eth->name) + 1);
+    g_byte_array_append(cache, (const guint8 *)eth->longname,
+        (guint)strlen(eth->longname) + 1);
+}
+
+static gboolean
+manuf_cache_load(const char *cache_path, const manuf_cache_header_t *stamp)
+{
+    gchar *contents = NULL;
+    gsize  len = 0;
+    const guint8 *p, *end, *nul;
+
+    if (!g_file_get_contents(cache_path, &contents, &len, NULL))
+        return FALSE;
+
+    if (len < sizeof(manuf_cache_header_t) ||
+        memcmp(contents, stamp, sizeof(manuf_cache_header_t)) != 0) {
+        /* Stale or not ours; reparse. */
+        g_free(contents);
+        return FALSE;
+    }
+
+    p = (const guint8 *)contents + sizeof(manuf_cache_header_t);
+    end = (const guint8 *)contents + len;
+    while (p < end) {
+        const guint8 *addr = p;
+        guint32 mask;
+        gchar *name, *longname;
+
+        if ((gsize)(end - p) < 6 + sizeof(guint32))
+            goto truncated;
+        memcpy(&mask, p + 6, sizeof(mask));
+        p += 6 + sizeof(guint32);
+
+        name = (gchar *)p;
+        nul = (const guint8 *)memchr(p, '\0', end - p);
+        if (nul == NULL)
+            goto truncated;
+        p = nul + 1;
+
+        if (p >= end)
+            goto truncated;
+        longname = (gchar *)p;
+        nul = (const guint8 *)memchr(p, '\0', end - p);
+        if (nul == NULL)
+            goto truncated;
+        p = nul + 1;
+
+        add_manuf_name(addr, mask, name, longname);
+    }
+
+    g_free(contents);
+    return TRUE;
+
+truncated:
+    /* The text parse below re-adds everything, replacing whatever
+       partial records we inserted. */
+    g_free(contents);
+    return FALSE;
+}
+
+static void
+manuf_cache_save(const char *cache_path, const manuf_cache_header_t *stamp,
+    GByteArray *cache)
+{
+    g_byte_array_prepend(cache, (const guint8 *)stamp, sizeof(*stamp));
+    /* Best effort; next start just parses again if this didn't stick. */
+    g_file_set_contents(cache_path, (const gchar *)cache->data, cache->len,
+        NULL);
+}
+
 static hashmanuf_t *
 manuf_name_lookup(const guint8 *addr)
 {
@@ -1707,6 +1845,8 @@ initialize_ethers(void)
 {
     ether_t *eth;
     guint    mask = 0;
+    manuf_cache_header_t cache_stamp;
+    char    *cache_path;
 
     /* hash table initialization */
     wka_hashtable   = wmem_map_new(wmem_epan_scope(), eth_addr_hash, eth_addr_cmp);
@@ -1734,23 +1874,35 @@ initialize_ethers(void)
     if (g_manuf_path == NULL)
         g_manuf_path = get_datafile_path(ENAME_MANUF);
 
-    /* Read it and initialize the hash table */
-    set_ethent(g_manuf_path);
-    while ((eth = get_ethent(&mask, TRUE))) {
-        add_manuf_name(eth->addr, mask, eth->name, eth->longname);
-    }
-    end_ethent();
-
     /* Compute the pathname of the wka file */
     if (g_wka_path == NULL)
         g_wka_path = get_datafile_path(ENAME_WKA);
 
-    /* Read it and initialize the hash table */
-    set_ethent(g_wka_path);
-    while ((eth = get_ethent(&mask, TRUE))) {
-        add_manuf_name(eth->addr, mask, eth->name, eth->longname);
+    /* Replay the binary cache of the parsed files if it's current;
+       otherwise parse the text files and refresh the cache. */
+    manuf_cache_stamp(&cache_stamp);
+    cache_path = get_persconffile_path(ENAME_MANUF_CACHE, FALSE);
+    if (!manuf_cache_load(cache_path, &cache_stamp)) {
+        GByteArray *cache = g_byte_array_new();
+
+        set_ethent(g_manuf_path);
+        while ((eth = get_ethent(&mask, TRUE))) {
+            add_manuf_name(eth->addr, mask, eth->name, eth->longname);
+            manuf_cache_append(cache, eth, mask);
+        }
+        end_ethent();
+
+        set_ethent(g_wka_path);
+        while ((eth = get_ethent(&mask, TRUE))) {
+            add_manuf_name(eth->addr, mask, eth->name, eth->longname);
+            manuf_cache_append(cache, eth, mask);
+        }
+        end_ethent();
+
+        manuf_cache_save(cache_path, &cache_stamp, cache);
+        g_byte_array_free(cache, TRUE);
     }
-    end_ethent();
+    g_free(cache_path);
 
 } /* initialize_ethers */
 
@@ -2965,6 +3117,100 @@ host_name_lookup_process(void) {
     return nro;
 }
 
+void
+queue_async_host_name_lookup(const address *addr)
+{
+    gboolean save_synchrony = resolve_synchronously;
+
+    if (!async_dns_initialized || name_resolve_concurrency == 0)
+        return;
+
+    /*
+     * Force the queued path in host_lookup()/host_lookup6() even if
+     * resolution is otherwise synchronous; the caller is batching
+     * lookups and will collect the answers with
+     * host_name_lookup_drain().
+     */
+    resolve_synchronously = FALSE;
+    switch (addr->type) {
+
+    case AT_IPv4:
+        host_lookup(*(const guint *)addr->data);
+        break;
+
+    case AT_IPv6:
+        host_lookup6((const ws_in6_addr *)addr->data);
+        break;
+
+    default:
+        /* Everything else resolves from local tables; nothing to queue. */
+        break;
+    }
+    resolve_synchronously = save_synchrony;
+}
+
+void
+host_name_lookup_drain(guint timeout_ms)
+{
+    const gint64 deadline = g_get_monotonic_time() + (gint64)timeout_ms * 1000;
+    async_dns_queue_msg_t *caqm;
+    struct timeval tv;
+    int nfds;
+    fd_set rfds, wfds;
+    wmem_list_frame_t* head;
+
+    if (!async_dns_initialized)
+        return;
+
+    for (;;) {
+        /* Keep the concurrency window full. */
+        head = wmem_list_head(async_dns_queue_head);
+        while (head != NULL && async_dns_in_flight <= name_resolve_concurrency) {
+            caqm = (async_dns_queue_msg_t *)wmem_list_frame_data(head);
+            wmem_list_remove_frame(async_dns_queue_head, head);
+            if (caqm->family == AF_INET) {
+                ares_gethostbyaddr(ghba_chan, &caqm->addr.ip4, sizeof(guint32),
+                        AF_INET, c_ares_ghba_cb, caqm);
+                async_dns_in_flight++;
+            } else if (caqm->family == AF_INET6) {
+                ares_gethostbyaddr(ghba_chan, &caqm->addr.ip6, sizeof(ws_in6_addr),
+                        AF_INET6, c_ares_ghba_cb, caqm);
+                async_dns_in_flight++;
+            }
+
+            head = wmem_list_head(async_dns_queue_head);
+        }
+
+        if (async_dns_in_flight == 0)
+            return;
+        if (g_get_monotonic_time() >= deadline)
+            return;
+
+        /*
+         * As in wait_for_sync_resolv(), just poke C-ARES once per
+         * second rather than asking ares_timeout(), which is linear
+         * in the number of outstanding requests - and here there can
+         * be hundreds of them.
+         */
+        tv.tv_sec = 1;
+        tv.tv_usec = 0;
+
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+        nfds = ares_fds(ghba_chan, &rfds, &wfds);
+        if (nfds > 0) {
+            if (select(nfds, &rfds, &wfds, NULL, &tv) == -1) { /* call to select() failed */
+                /* If it's interrupted by a signal, no need to put out a message */
+                if (errno != EINTR)
+                    fprintf(stderr, "Warning: call to select() failed, error is %s\n", g_strerror(errno));
+                return;
+            }
+        }
+        /* Called with empty fd sets this still drives request timeouts. */
+        ares_process(ghba_chan, &rfds, &wfds);
+    }
+}
+
 static void
 _host_name_lookup_cleanup(void) {
     async_dns_queue_head = NULL;
@@ -3095,6 +3341,201 @@ add_manually_resolved(void)
     }
 }
 
+/*
+ * Persistent cache of resolved host names.
+ *
+ * DNS answers are discarded at exit, so reopening captures of the same
+ * address space pays the full lookup latency again every session. After
+ * the tables are torn down we dump the resolved IPv4/IPv6 names into a
+ * flat per-user cache file and replay them on the next start. Each
+ * record keeps the time it was first resolved and is dropped once it is
+ * older than RESOLV_CACHE_TTL, so renamed hosts age out; replayed
+ * records keep their original stamp rather than being refreshed.
+ * Like the manuf cache, records are in host byte order and the file
+ * never moves between machines.
+ */
+
+#define ENAME_RESOLV_CACHE "resolved_names.cache"
+
+#define RESOLV_CACHE_MAGIC   0x72736c76  /* "rslv" */
+#define RESOLV_CACHE_VERSION 1
+#define RESOLV_CACHE_TTL     (7 * 24 * 60 * 60)  /* seconds */
+
+typedef struct {
+    guint32 magic;
+    guint32 version;
+} resolv_cache_header_t;
+
+/* Original resolution times of the records replayed from the cache,
+ * so that saving doesn't restart their TTL. */
+static GHashTable *resolv_cache_ipv4_stamps;
+static GHashTable *resolv_cache_ipv6_stamps;
+
+static void
+resolv_cache_load(void)
+{
+    char   *cache_path;
+    gchar  *contents = NULL;
+    gsize   len = 0;
+    const guint8 *p, *end, *nul;
+    resolv_cache_header_t hdr;
+    guint32 now = (guint32)time(NULL);
+
+    resolv_cache_ipv4_stamps = g_hash_table_new(g_direct_hash, g_direct_equal);
+    resolv_cache_ipv6_stamps = g_hash_table_new_full(ipv6_oat_hash, ipv6_equal,
+        g_free, NULL);
+
+    cache_path = get_persconffile_path(ENAME_RESOLV_CACHE, FALSE);
+    if (!g_file_get_contents(cache_path, &contents, &len, NULL)) {
+        g_free(cache_path);
+        return;
+    }
+    g_free(cache_path);
+
+    hdr.magic = RESOLV_CACHE_MAGIC;
+    hdr.version = RESOLV_CACHE_VERSION;
+    if (len < sizeof(hdr) || memcmp(contents, &hdr, sizeof(hdr)) != 0) {
+        /* Stale format or not ours; start over. */
+        g_free(contents);
+        return;
+    }
+
+    p = (const guint8 *)contents + sizeof(hdr);
+    end = (const guint8 *)contents + len;
+    while (p < end) {
+        guint8  family = *p++;
+        guint32 stamp;
+        gsize   addr_len = (family == 4) ? 4 : 16;
+        const guint8 *addr;
+        const gchar *name;
+
+        if (family != 4 && family != 6)
+            break;  /* corrupted; ignore the rest */
+        if ((gsize)(end - p) < sizeof(stamp) + addr_len)
+            break;
+        memcpy(&stamp, p, sizeof(stamp));
+        p += sizeof(stamp);
+        addr = p;
+        p += addr_len;
+
+        name = (const gchar *)p;
+        nul = (const guint8 *)memchr(p, '\0', end - p);
+        if (nul == NULL)
+            break;
+        p = nul + 1;
+
+        if (now < stamp || now - stamp > RESOLV_CACHE_TTL)
+            continue;  /* expired (or clock went backwards) */
+
+        if (family == 4) {
+            guint32 ip4;
+
+            memcpy(&ip4, addr, sizeof(ip4));
+            add_ipv4_name(ip4, name);
+            g_hash_table_insert(resolv_cache_ipv4_stamps,
+                GUINT_TO_POINTER(ip4), GUINT_TO_POINTER(stamp));
+        } else {
+            ws_in6_addr ip6;
+
+            memcpy(&ip6, addr, sizeof(ip6));
+            add_ipv6_name(&ip6, name);
+            g_hash_table_insert(resolv_cache_ipv6_stamps,
+                g_memdup2(&ip6, sizeof(ip6)), GUINT_TO_POINTER(stamp));
+        }
+    }
+
+    g_free(contents);
+}
+
+typedef struct {
+    GByteArray *cache;
+    guint32     now;
+} resolv_cache_write_t;
+
+static void
+resolv_cache_append(resolv_cache_write_t *w, guint8 family, guint32 stamp,
+    const guint8 *addr, gsize addr_len, const gchar *name)
+{
+    g_byte_array_append(w->cache, &family, 1);
+    g_byte_array_append(w->cache, (const guint8 *)&stamp, sizeof(stamp));
+    g_byte_array_append(w->cache, addr, (guint)addr_len);
+    g_byte_array_append(w->cache, (const guint8 *)name,
+        (guint)strlen(name) + 1);
+}
+
+static void
+resolv_cache_save_ipv4(gpointer key _U_, gpointer value, gpointer user_data)
+{
+    resolv_cache_write_t *w = (resolv_cache_write_t *)user_data;
+    hashipv4_t *tp = (hashipv4_t *)value;
+    gpointer    orig;
+    guint32     stamp;
+
+    if (!(tp->flags & NAME_RESOLVED))
+        return;
+
+    if (g_hash_table_lookup_extended(resolv_cache_ipv4_stamps,
+            GUINT_TO_POINTER(tp->addr), NULL, &orig))
+        stamp = GPOINTER_TO_UINT(orig);
+    else
+        stamp = w->now;
+    resolv_cache_append(w, 4, stamp, (const guint8 *)&tp->addr,
+        sizeof(tp->addr), tp->name);
+}
+
+static void
+resolv_cache_save_ipv6(gpointer key _U_, gpointer value, gpointer user_data)
+{
+    resolv_cache_write_t *w = (resolv_cache_write_t *)user_data;
+    hashipv6_t *tp = (hashipv6_t *)value;
+    gpointer    orig;
+    guint32     stamp;
+
+    if (!(tp->flags & NAME_RESOLVED))
+        return;
+
+    if (g_hash_table_lookup_extended(resolv_cache_ipv6_stamps,
+            tp->addr, NULL, &orig))
+        stamp = GPOINTER_TO_UINT(orig);
+    else
+        stamp = w->now;
+    resolv_cache_append(w, 6, stamp, tp->addr, sizeof(tp->addr), tp->name);
+}
+
+static void
+resolv_cache_save(void)
+{
+    resolv_cache_write_t  w;
+    resolv_cache_header_t hdr;
+    char                 *cache_path;
+
+    if (resolv_cache_ipv4_stamps == NULL) {
+        /* host_name_lookup_init() never ran. */
+        return;
+    }
+
+    hdr.magic = RESOLV_CACHE_MAGIC;
+    hdr.version = RESOLV_CACHE_VERSION;
+    w.cache = g_byte_array_new();
+    w.now = (guint32)time(NULL);
+    g_byte_array_append(w.cache, (const guint8 *)&hdr, sizeof(hdr));
+    wmem_map_foreach(ipv4_hash_table, resolv_cache_save_ipv4, &w);
+    wmem_map_foreach(ipv6_hash_table, resolv_cache_save_ipv6, &w);
+
+    cache_path = get_persconffile_path(ENAME_RESOLV_CACHE, FALSE);
+    /* Best effort; a failed write just costs the next session its
+       warm start. */
+    g_file_set_contents(cache_path, (const gchar *)w.cache->data,
+        w.cache->len, NULL);
+    g_free(cache_path);
+    g_byte_array_free(w.cache, TRUE);
+
+    g_hash_table_destroy(resolv_cache_ipv4_stamps);
+    resolv_cache_ipv4_stamps = NULL;
+    g_hash_table_destroy(resolv_cache_ipv6_stamps);
+    resolv_cache_ipv6_stamps = NULL;
+}
+
 static void
 host_name_lookup_init(void)
 {
@@ -3156,6 +3597,10 @@ host_name_lookup_init(void)
 
     subnet_name_lookup_init();
 
+    /* Replay names resolved in earlier sessions. Loaded before the
+     * manual entries so that those still win on conflict. */
+    resolv_cache_load();
+
     add_manually_resolved();
 
     ss7pc_name_lookup_init();
@@ -3169,9 +3614,13 @@ host_name_lookup_cleanup(void)
 
     _host_name_lookup_cleanup();
 
+    resolv_cache_save();
+
     ipxnet_hash_table = NULL;
     ipv4_hash_table = NULL;
     ipv6_hash_table = NULL;
+    ipv4_hash_table_cache = NULL;
+    ipv6_hash_table_cache = NULL;
     ss7pc_hash_table = NULL;
 
     for(i = 0; i < SUBNETLENGTHSIZE; ++i) {
@@ -194,6 +194,19 @@ WS_DLL_PUBLIC void disable_name_resolution(void);
  */
 WS_DLL_PUBLIC gboolean host_name_lookup_process(void);
 
+/** Queue an asynchronous name lookup for an address, even if resolution
+ *  is otherwise synchronous.  Addresses that don't resolve over the
+ *  network (Ethernet, and so on) are ignored.  This is for callers that
+ *  batch up lookups for a table of addresses and then collect all the
+ *  answers at once with host_name_lookup_drain().
+ */
+WS_DLL_PUBLIC void queue_async_host_name_lookup(const address *addr);
+
+/** Submit all queued asynchronous lookups and wait for the answers,
+ *  giving up after timeout_ms milliseconds.
+ */
+WS_DLL_PUBLIC void host_name_lookup_drain(guint timeout_ms);
+
 /* get_hostname returns the host name or "%d.%d.%d.%d" if not found */
 WS_DLL_PUBLIC const gchar *get_hostname(const guint addr);
 
@@ -185,14 +185,18 @@ cmp_address(const address *addr1, const address *addr2) {
     if (addr1->type < addr2->type) return -1;
     if (addr1->len  > addr2->len) return 1;
     if (addr1->len  < addr2->len) return -1;
-    if (addr1->len == 0) {
+    if (addr1->data == addr2->data) {
         /*
-         * memcmp(NULL, NULL, 0) is *not* guaranteed to work, so
-         * if both addresses are zero-length, don't compare them
-         * (there's nothing to compare, so they're equal).
+         * Same data (including two zero-length addresses, where
+         * memcmp(NULL, NULL, 0) is *not* guaranteed to work); this is
+         * the usual case for interned addresses (see intern_address()).
          */
         return 0;
     }
+    if (addr1->len == 0) {
+        /* Both addresses are zero-length; there's nothing to compare. */
+        return 0;
+    }
     return memcmp(addr1->data, addr2->data, addr1->len);
 }
 
@@ -213,10 +217,14 @@ addresses_equal(const address *addr1, const address *addr2) {
      * memcmp(NULL, NULL, 0) is *not* guaranteed to work, so
      * if both addresses are zero-length, don't compare them
      * (there's nothing to compare, so they're equal).
+     *
+     * The data-pointer comparison answers in one step for interned
+     * addresses (see intern_address()) and zero-length addresses.
      */
     if (addr1->type == addr2->type &&
         addr1->len == addr2->len &&
-        (addr1->len == 0 ||
+        (addr1->data == addr2->data ||
+         addr1->len == 0 ||
          memcmp(addr1->data, addr2->data, addr1->len) == 0))
         return TRUE;
     return FALSE;
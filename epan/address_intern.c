@@ -0,0 +1,118 @@
+/* address_intern.c
+ * Deduplicated, file-scoped storage for address data.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include "address_intern.h"
+
+/* A pool entry; the address bytes follow the struct in the same
+ * allocation, with data pointing at them.  The same struct on the
+ * stack, with data borrowed from the caller, serves as the lookup
+ * probe, so looking up an address allocates nothing. */
+typedef struct {
+	int		 type;
+	int		 len;
+	const guint8	*data;
+} address_intern_key_t;
+
+/* The pool itself, a set of address_intern_key_t.
+ * NULL when no dissection session is active. */
+static GHashTable *address_intern_table;
+
+static guint
+address_intern_hash(gconstpointer k)
+{
+	const address_intern_key_t *key = (const address_intern_key_t *)k;
+	guint hash_val = (guint)key->type;
+	int i;
+
+	/* Same mixing as add_address_to_hash(). */
+	for (i = 0; i < key->len; i++) {
+		hash_val += key->data[i];
+		hash_val += (hash_val << 10);
+		hash_val ^= (hash_val >> 6);
+	}
+	return hash_val;
+}
+
+static gboolean
+address_intern_equal(gconstpointer a, gconstpointer b)
+{
+	const address_intern_key_t *key_a = (const address_intern_key_t *)a;
+	const address_intern_key_t *key_b = (const address_intern_key_t *)b;
+
+	return key_a->type == key_b->type && key_a->len == key_b->len &&
+	    memcmp(key_a->data, key_b->data, key_a->len) == 0;
+}
+
+void
+intern_address(address *to, const address *from)
+{
+	address_intern_key_t probe;
+	address_intern_key_t *entry;
+
+	if (from->len == 0) {
+		/* AT_NONE and other empty addresses; nothing to share. */
+		copy_address_shallow(to, from);
+		return;
+	}
+
+	if (address_intern_table == NULL) {
+		/* No dissection session; hand back an ordinary copy. */
+		copy_address(to, from);
+		return;
+	}
+
+	probe.type = from->type;
+	probe.len = from->len;
+	probe.data = (const guint8 *)from->data;
+	entry = (address_intern_key_t *)g_hash_table_lookup(address_intern_table, &probe);
+	if (entry == NULL) {
+		guint8 *data;
+
+		entry = (address_intern_key_t *)g_malloc(sizeof(*entry) + from->len);
+		data = (guint8 *)(entry + 1);
+		memcpy(data, from->data, from->len);
+		entry->type = from->type;
+		entry->len = from->len;
+		entry->data = data;
+		g_hash_table_add(address_intern_table, entry);
+	}
+	set_address(to, entry->type, entry->len, entry->data);
+}
+
+void
+address_intern_init(void)
+{
+	address_intern_table = g_hash_table_new_full(address_intern_hash,
+	    address_intern_equal, g_free, NULL);
+}
+
+void
+address_intern_cleanup(void)
+{
+	g_hash_table_destroy(address_intern_table);
+	address_intern_table = NULL;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
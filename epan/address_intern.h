@@ -0,0 +1,72 @@
+/* address_intern.h
+ * Deduplicated, file-scoped storage for address data.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __ADDRESS_INTERN_H__
+#define __ADDRESS_INTERN_H__
+
+#include <epan/address.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** @file
+ * A capture holds millions of packets but usually only a handful of
+ * distinct addresses, yet copy_address() and friends clone the 4-16
+ * address bytes for every conversation key and long-lived tap entry.
+ * This pool stores each distinct (type, data) pair once per dissection
+ * session; interning an address hands back a shallow address whose data
+ * pointer is shared with every other interned copy of the same address,
+ * so repeated copies cost a hash lookup instead of an allocation and
+ * equal interned addresses compare by pointer in addresses_equal() and
+ * cmp_address().
+ */
+
+/**
+ * Fill in 'to' with a copy of 'from' whose data is interned in the
+ * session pool.  The data stays valid until the dissection session
+ * ends, so the result may be stored in anything with file scope or
+ * shorter.  'to' does not own the data; calling free_address() on it
+ * is a harmless no-op.
+ *
+ * Outside a dissection session this falls back to an ordinary
+ * copy_address(), whose result free_address() then does free, so
+ * callers may treat the two cases uniformly.
+ *
+ * @param to [in,out] The destination address.
+ * @param from [in] The source address.
+ */
+WS_DLL_PUBLIC void intern_address(address *to, const address *from);
+
+/* Start a new dissection session with an empty pool; called by
+ * init_dissection(). */
+extern void address_intern_init(void);
+
+/* Discard the pool; called by cleanup_dissection(). */
+extern void address_intern_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __ADDRESS_INTERN_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
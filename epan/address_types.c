@@ -827,7 +827,7 @@ address_to_display(wmem_allocator_t *allocator, const address *addr)
     return str;
 }
 
-static void address_with_resolution_to_str_buf(const address* addr, gchar *buf, int buf_len)
+void address_with_resolution_to_str_buf(const address* addr, gchar *buf, int buf_len)
 {
     address_type_t *at;
     int addr_len;
@@ -845,13 +845,13 @@ static void address_with_resolution_to_str_buf(const address* addr, gchar *buf,
         return;
     }
 
-#if 0 /* XXX - If this remains a static function, we've already made this check in the only
-         function that can call it.  If this function becomes "public", need to put this
-         check back in */
     /* No name resolution support, just return address string */
-    if (at->addr_name_res_str == NULL)
-        return address_to_str_buf(addr, buf, buf_len);
-#endif
+    if ((at->addr_name_res_str == NULL) ||
+            (ADDR_RESOLV_MACADDR(addr) && !gbl_resolv_flags.mac_name) ||
+            (ADDR_RESOLV_NETADDR(addr) && !gbl_resolv_flags.network_name)) {
+        address_to_str_buf(addr, buf, buf_len);
+        return;
+    }
 
     /* Copy the resolved name */
     pos = g_strlcpy(buf, at->addr_name_res_str(addr), buf_len);
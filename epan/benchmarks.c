@@ -0,0 +1,390 @@
+/* benchmarks.c
+ * Standalone micro-benchmarks for libwireshark hot paths.
+ *
+ * Build with the wireshark_benchmarks target (EXCLUDE_FROM_ALL, like the
+ * unit test programs).  The program prints a single JSON object on stdout
+ * so CI jobs can archive the numbers and trend them over time:
+ *
+ *   {"benchmarks": [
+ *     {"name": "tvb_get_guint8", "iterations": N,
+ *      "ns_per_op": 1.93, "bytes_per_op": 1},
+ *     ...]}
+ *
+ * Each benchmark uses a fixed iteration count and synthetic input so
+ * that two runs on the same machine measure the same work.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <wsutil/filesystem.h>
+#include <wsutil/privileges.h>
+#include <wsutil/wslog.h>
+#include <wsutil/wmem/wmem.h>
+
+#include <wiretap/wtap.h>
+
+#include "epan.h"
+#include "epan_dissect.h"
+#include "conversation.h"
+#include "frame_data.h"
+#include "tvbuff.h"
+#include "dfilter/dfilter.h"
+
+#define MAX_RESULTS 16
+
+typedef struct {
+	const char *name;
+	guint64 iterations;
+	guint64 bytes_per_op;
+	double ns_per_op;
+} bench_result_t;
+
+static bench_result_t results[MAX_RESULTS];
+static guint n_results;
+
+static gint64 bench_start;
+
+/* Accumulator the benchmark loops feed so the compiler can't discard
+   the measured calls. */
+static volatile guint64 sink;
+
+static void
+bench_begin(void)
+{
+	bench_start = g_get_monotonic_time();
+}
+
+static void
+bench_end(const char *name, guint64 iterations, guint64 bytes_per_op)
+{
+	gint64 elapsed_us = g_get_monotonic_time() - bench_start;
+	bench_result_t *r;
+
+	g_assert(n_results < MAX_RESULTS);
+	r = &results[n_results++];
+	r->name = name;
+	r->iterations = iterations;
+	r->bytes_per_op = bytes_per_op;
+	r->ns_per_op = ((double)elapsed_us * 1000.0) / (double)iterations;
+}
+
+/*
+ * tvb accessors over a plain real-data tvbuff; offsets stay in bounds
+ * so no exception is ever thrown.
+ */
+#define TVB_DATA_LEN 1500
+
+static void
+bench_tvb_accessors(void)
+{
+	guint8 *data = (guint8 *)g_malloc(TVB_DATA_LEN);
+	tvbuff_t *tvb;
+	guint64 acc = 0;
+	guint8 copy_buf[64];
+	const guint iters = 4 * 1000 * 1000;
+	const guint copy_iters = 1000 * 1000;
+	guint i;
+
+	for (i = 0; i < TVB_DATA_LEN; i++)
+		data[i] = i & 0xFF;
+	tvb = tvb_new_real_data(data, TVB_DATA_LEN, TVB_DATA_LEN);
+
+	bench_begin();
+	for (i = 0; i < iters; i++)
+		acc += tvb_get_guint8(tvb, i % TVB_DATA_LEN);
+	bench_end("tvb_get_guint8", iters, 1);
+
+	bench_begin();
+	for (i = 0; i < iters; i++)
+		acc += tvb_get_ntohl(tvb, i % (TVB_DATA_LEN - 4));
+	bench_end("tvb_get_ntohl", iters, 4);
+
+	bench_begin();
+	for (i = 0; i < iters; i++)
+		acc += tvb_get_letoh64(tvb, i % (TVB_DATA_LEN - 8));
+	bench_end("tvb_get_letoh64", iters, 8);
+
+	bench_begin();
+	for (i = 0; i < copy_iters; i++) {
+		tvb_memcpy(tvb, copy_buf, i % (TVB_DATA_LEN - 64), 64);
+		acc += copy_buf[0];
+	}
+	bench_end("tvb_memcpy_64", copy_iters, 64);
+
+	sink += acc;
+	tvb_free(tvb);
+	g_free(data);
+}
+
+/*
+ * wmem allocation in the pattern dissection uses: many small
+ * allocations, then wmem_free_all() when the scope is left.
+ */
+static void
+bench_wmem_allocator(wmem_allocator_type_t type, const char *name)
+{
+	wmem_allocator_t *allocator = wmem_allocator_new(type);
+	const guint iters = 2 * 1000 * 1000;
+	const guint alloc_size = 48;
+	guint64 acc = 0;
+	guint i;
+
+	bench_begin();
+	for (i = 0; i < iters; i++) {
+		acc += GPOINTER_TO_SIZE(wmem_alloc(allocator, alloc_size));
+		if ((i & 0xFFF) == 0xFFF)
+			wmem_free_all(allocator);
+	}
+	bench_end(name, iters, alloc_size);
+
+	sink += acc;
+	wmem_destroy_allocator(allocator);
+}
+
+static void
+bench_wmem_allocators(void)
+{
+	bench_wmem_allocator(WMEM_ALLOCATOR_BLOCK, "wmem_alloc_block");
+	bench_wmem_allocator(WMEM_ALLOCATOR_BLOCK_FAST, "wmem_alloc_block_fast");
+	bench_wmem_allocator(WMEM_ALLOCATOR_SIMPLE, "wmem_alloc_simple");
+}
+
+static void
+bench_dfilter_compile(void)
+{
+	static const char filter[] =
+	    "ip.addr == 192.0.2.1 && tcp.port == 443 && frame.len > 100";
+	const guint iters = 20 * 1000;
+	guint i;
+
+	bench_begin();
+	for (i = 0; i < iters; i++) {
+		dfilter_t *dfcode = NULL;
+		gchar *err_msg = NULL;
+
+		if (!dfilter_compile(filter, &dfcode, &err_msg)) {
+			fprintf(stderr, "benchmarks: dfilter_compile failed: %s\n",
+			    err_msg);
+			g_free(err_msg);
+			exit(2);
+		}
+		dfilter_free(dfcode);
+	}
+	bench_end("dfilter_compile", iters, 0);
+}
+
+/* Canned Ethernet II / IPv4 / TCP frame, 60 bytes on the wire.
+   192.0.2.1:54321 -> 192.0.2.2:443, PSH+ACK, 6 bytes of payload. */
+static const guint8 canned_tcp_frame[] = {
+	0x00, 0x0c, 0x29, 0xaa, 0xbb, 0xcc,	/* dst MAC */
+	0x00, 0x0c, 0x29, 0xdd, 0xee, 0xff,	/* src MAC */
+	0x08, 0x00,				/* IPv4 */
+	0x45, 0x00, 0x00, 0x2e, 0x12, 0x34,	/* IPv4 header */
+	0x40, 0x00, 0x40, 0x06, 0x00, 0x00,
+	0xc0, 0x00, 0x02, 0x01,			/* 192.0.2.1 */
+	0xc0, 0x00, 0x02, 0x02,			/* 192.0.2.2 */
+	0xd4, 0x31, 0x01, 0xbb,			/* TCP 54321 -> 443 */
+	0x00, 0x00, 0x00, 0x01,			/* seq */
+	0x00, 0x00, 0x00, 0x00,			/* ack */
+	0x50, 0x18, 0x20, 0x00,			/* hlen 20, PSH+ACK */
+	0x00, 0x00, 0x00, 0x00,			/* checksum, urg */
+	0xde, 0xad, 0xbe, 0xef, 0x00, 0x01	/* payload */
+};
+
+static frame_data ref_frame;
+
+/*
+ * Full dissection of the canned frame with a protocol tree; the time is
+ * dominated by proto_tree_add_item() and friends.  Afterwards one
+ * dissected packet is kept around to measure dfilter_apply_edt() alone.
+ */
+static void
+bench_dissection(epan_t *session)
+{
+	wtap_rec rec;
+	frame_data fd;
+	nstime_t elapsed;
+	const frame_data *fd_ref = NULL;
+	tvbuff_t *tvb;
+	epan_dissect_t edt;
+	dfilter_t *dfcode = NULL;
+	gchar *err_msg = NULL;
+	const guint iters = 20 * 1000;
+	const guint apply_iters = 1000 * 1000;
+	guint matched = 0;
+	guint i;
+
+	wtap_rec_init(&rec);
+	rec.rec_type = REC_TYPE_PACKET;
+	rec.presence_flags = WTAP_HAS_TS | WTAP_HAS_CAP_LEN;
+	rec.ts.secs = 946684800;
+	rec.ts.nsecs = 0;
+	rec.rec_header.packet_header.caplen = (guint32)sizeof canned_tcp_frame;
+	rec.rec_header.packet_header.len = (guint32)sizeof canned_tcp_frame;
+	rec.rec_header.packet_header.pkt_encap = WTAP_ENCAP_ETHERNET;
+
+	nstime_set_zero(&elapsed);
+
+	bench_begin();
+	for (i = 0; i < iters; i++) {
+		tvb = tvb_new_real_data(canned_tcp_frame,
+		    sizeof canned_tcp_frame, sizeof canned_tcp_frame);
+		frame_data_init(&fd, i + 1, &rec, 0, 0);
+		frame_data_set_before_dissect(&fd, &elapsed, &fd_ref, NULL);
+		if (fd_ref == &fd) {
+			ref_frame = fd;
+			fd_ref = &ref_frame;
+		}
+		epan_dissect_init(&edt, session, TRUE, TRUE);
+		/* epan_dissect_cleanup() frees the tvb chain. */
+		epan_dissect_run(&edt, 0, &rec, tvb, &fd, NULL);
+		epan_dissect_cleanup(&edt);
+		frame_data_destroy(&fd);
+	}
+	bench_end("dissect_tree", iters, sizeof canned_tcp_frame);
+
+	if (!dfilter_compile("tcp.port == 443 && ip.addr == 192.0.2.1",
+	    &dfcode, &err_msg)) {
+		fprintf(stderr, "benchmarks: dfilter_compile failed: %s\n",
+		    err_msg);
+		g_free(err_msg);
+		exit(2);
+	}
+
+	tvb = tvb_new_real_data(canned_tcp_frame,
+	    sizeof canned_tcp_frame, sizeof canned_tcp_frame);
+	frame_data_init(&fd, iters + 1, &rec, 0, 0);
+	frame_data_set_before_dissect(&fd, &elapsed, &fd_ref, NULL);
+	epan_dissect_init(&edt, session, TRUE, FALSE);
+	epan_dissect_prime_with_dfilter(&edt, dfcode);
+	epan_dissect_run(&edt, 0, &rec, tvb, &fd, NULL);
+
+	bench_begin();
+	for (i = 0; i < apply_iters; i++)
+		matched += dfilter_apply_edt(dfcode, &edt) ? 1 : 0;
+	bench_end("dfilter_apply", apply_iters, 0);
+
+	if (matched != apply_iters)
+		fprintf(stderr, "benchmarks: dfilter unexpectedly did not match\n");
+
+	epan_dissect_cleanup(&edt);
+	frame_data_destroy(&fd);
+	dfilter_free(dfcode);
+	wtap_rec_cleanup(&rec);
+}
+
+static void
+bench_conversation_lookup(void)
+{
+	static const guint8 ip_a[4] = { 10, 0, 0, 1 };
+	static const guint8 ip_b[4] = { 10, 0, 0, 2 };
+	const guint n_convs = 1024;
+	const guint iters = 2 * 1000 * 1000;
+	address addr_a, addr_b;
+	guint64 acc = 0;
+	guint i;
+
+	set_address(&addr_a, AT_IPv4, 4, ip_a);
+	set_address(&addr_b, AT_IPv4, 4, ip_b);
+
+	for (i = 0; i < n_convs; i++)
+		conversation_new(1, &addr_a, &addr_b, ENDPOINT_TCP,
+		    1024 + i, 80, 0);
+
+	bench_begin();
+	for (i = 0; i < iters; i++) {
+		acc += (find_conversation(2, &addr_a, &addr_b, ENDPOINT_TCP,
+		    1024 + (i % n_convs), 80, 0) != NULL);
+	}
+	bench_end("find_conversation", iters, 0);
+
+	sink += acc;
+}
+
+static void
+print_results_json(void)
+{
+	guint i;
+
+	printf("{\n  \"benchmarks\": [\n");
+	for (i = 0; i < n_results; i++) {
+		printf("    {\"name\": \"%s\", \"iterations\": %" G_GUINT64_FORMAT
+		    ", \"ns_per_op\": %.2f, \"bytes_per_op\": %" G_GUINT64_FORMAT "}%s\n",
+		    results[i].name, results[i].iterations,
+		    results[i].ns_per_op, results[i].bytes_per_op,
+		    (i + 1 < n_results) ? "," : "");
+	}
+	printf("  ]\n}\n");
+}
+
+int
+main(int argc _U_, char **argv)
+{
+	static const struct packet_provider_funcs funcs = {
+		NULL,	/* get_frame_ts */
+		NULL,	/* get_interface_name */
+		NULL,	/* get_interface_description */
+		NULL	/* get_modified_block */
+	};
+	char *init_progfile_dir_error;
+	epan_t *session;
+
+	ws_log_init("wireshark_benchmarks", NULL);
+
+	init_process_policies();
+	relinquish_special_privs_perm();
+
+	init_progfile_dir_error = init_progfile_dir(argv[0]);
+	if (init_progfile_dir_error != NULL) {
+		fprintf(stderr, "benchmarks: can't get pathname of program: %s\n",
+		    init_progfile_dir_error);
+		g_free(init_progfile_dir_error);
+	}
+
+	wtap_init(FALSE);
+	if (!epan_init(NULL, NULL, FALSE)) {
+		fprintf(stderr, "benchmarks: epan_init failed\n");
+		return 2;
+	}
+
+	session = epan_new(NULL, &funcs);
+
+	bench_tvb_accessors();
+	bench_wmem_allocators();
+	bench_dfilter_compile();
+	bench_dissection(session);
+	bench_conversation_lookup();
+
+	print_results_json();
+
+	epan_free(session);
+	epan_cleanup();
+	wtap_cleanup();
+
+	return 0;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
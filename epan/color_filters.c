@@ -49,6 +49,27 @@ static GSList *color_filter_valid_list   = NULL;
 /* Color Filters can en-/disabled. */
 static gboolean filters_enabled = TRUE;
 
+/*
+ * The active rules compiled into a flat decision list. Each step records
+ * which of the distinct fields referenced by any rule its filter reads
+ * (as a bitmask) and what the filter yields on a tree containing none of
+ * them. Per packet we probe each distinct field once — rules sharing
+ * predicates (ip, tcp, ...) share the probe — and a rule whose fields are
+ * all absent must come out the same as on the empty tree, so most rules
+ * are settled without running their filter program at all.
+ */
+typedef struct {
+    color_filter_t *colorf;        /* rule to return on match; list order */
+    guint64         fields_mask;   /* bits of color_decision_hfids read */
+    gboolean        matches_empty; /* result when none of the fields exist */
+} color_decision_step_t;
+
+#define COLOR_DECISION_MAX_FIELDS 64
+
+static GArray  *color_decision_steps = NULL; /* color_decision_step_t */
+static GArray  *color_decision_hfids = NULL; /* int; index == mask bit */
+static gboolean color_decision_valid = FALSE;
+
 /* Remember if there are temporary coloring filters set to
  * add sensitivity to the "Reset Coloring 1-10" menu item
  */
@@ -197,6 +218,7 @@ color_filters_set_tmp(guint8 filt_nr, const gchar *filter, gboolean disabled, gc
         }
         g_free(name);
     }
+    color_decision_valid = FALSE;
     return TRUE;
 }
 
@@ -303,6 +325,8 @@ color_filters_get(gchar** err_msg, color_filter_add_cb_func add_cb)
     FILE     *f;
     int       ret;
 
+    color_decision_valid = FALSE;
+
     /* start the list with the temporary colorizing rules */
     color_filters_add_tmp(&color_filter_list);
 
@@ -478,6 +502,8 @@ color_filters_apply(GSList *tmp_cfl, GSList *edit_cfl, gchar** err_msg)
         ret = FALSE;
     }
 
+    color_decision_valid = FALSE;
+
     return ret;
 }
 
@@ -513,26 +539,107 @@ color_filters_prime_edt(epan_dissect_t *edt)
         g_slist_foreach(color_filter_list, prime_edt, edt);
 }
 
+/* Return the mask bit for an hfid, assigning one if it's new.
+ * Returns -1 once we're out of bits. */
+static int
+color_decision_hfid_bit(int hfid)
+{
+    guint i;
+
+    for (i = 0; i < color_decision_hfids->len; i++) {
+        if (g_array_index(color_decision_hfids, int, i) == hfid)
+            return (int)i;
+    }
+    if (color_decision_hfids->len >= COLOR_DECISION_MAX_FIELDS)
+        return -1;
+    g_array_append_val(color_decision_hfids, hfid);
+    return (int)(color_decision_hfids->len - 1);
+}
+
+/* Rebuild the decision list from the active rules. */
+static void
+color_decision_list_rebuild(void)
+{
+    GSList     *curr;
+    proto_tree *empty_tree;
+
+    if (color_decision_steps == NULL) {
+        color_decision_steps = g_array_new(FALSE, FALSE, sizeof(color_decision_step_t));
+        color_decision_hfids = g_array_new(FALSE, FALSE, sizeof(int));
+    }
+    g_array_set_size(color_decision_steps, 0);
+    g_array_set_size(color_decision_hfids, 0);
+
+    /* An unprimed tree makes every field read come up empty, which is
+     * exactly how a packet containing none of a rule's fields looks to
+     * the filter engine. */
+    empty_tree = proto_tree_create_root(NULL);
+
+    for (curr = color_filter_list; curr != NULL; curr = g_slist_next(curr)) {
+        color_filter_t        *colorf = (color_filter_t *)curr->data;
+        color_decision_step_t  step;
+        const int             *fields;
+        int                    num_fields, i;
+
+        if (colorf->disabled || colorf->c_colorfilter == NULL)
+            continue;
+
+        step.colorf        = colorf;
+        step.fields_mask   = 0;
+        step.matches_empty = dfilter_apply(colorf->c_colorfilter, empty_tree);
+
+        num_fields = dfilter_interesting_fields(colorf->c_colorfilter, &fields);
+        for (i = 0; i < num_fields; i++) {
+            int bit = color_decision_hfid_bit(fields[i]);
+            if (bit < 0) {
+                /* Too many distinct fields to index. Forcing
+                 * matches_empty keeps this rule always evaluated. */
+                step.matches_empty = TRUE;
+                break;
+            }
+            step.fields_mask |= G_GUINT64_CONSTANT(1) << bit;
+        }
+
+        g_array_append_val(color_decision_steps, step);
+    }
+
+    proto_tree_free(empty_tree);
+    color_decision_valid = TRUE;
+}
+
 /* * Return the color_t for later use */
 const color_filter_t *
 color_filters_colorize_packet(epan_dissect_t *edt)
 {
-    GSList         *curr;
-    color_filter_t *colorf;
+    guint   i;
+    guint64 present_mask;
 
     /* If we have color filters, "search" for the matching one. */
-    if ((edt->tree != NULL) && (color_filters_used())) {
-        curr = color_filter_list;
-
-        while(curr != NULL) {
-            colorf = (color_filter_t *)curr->data;
-            if ( (!colorf->disabled) &&
-                 (colorf->c_colorfilter != NULL) &&
-                 dfilter_apply_edt(colorf->c_colorfilter, edt)) {
-                return colorf;
-            }
-            curr = g_slist_next(curr);
-        }
+    if ((edt->tree == NULL) || !color_filters_used())
+        return NULL;
+
+    if (!color_decision_valid)
+        color_decision_list_rebuild();
+
+    /* Probe each distinct field once up front. */
+    present_mask = 0;
+    for (i = 0; i < color_decision_hfids->len; i++) {
+        int hfid = g_array_index(color_decision_hfids, int, i);
+        if (proto_check_for_protocol_or_field(edt->tree, hfid))
+            present_mask |= G_GUINT64_CONSTANT(1) << i;
+    }
+
+    for (i = 0; i < color_decision_steps->len; i++) {
+        color_decision_step_t *step = &g_array_index(color_decision_steps,
+                                                     color_decision_step_t, i);
+
+        /* None of the rule's fields are present, so its filter comes
+         * out the same as on the empty tree: no match. */
+        if (!step->matches_empty && (step->fields_mask & present_mask) == 0)
+            continue;
+
+        if (dfilter_apply_edt(step->colorf->c_colorfilter, edt))
+            return step->colorf;
     }
 
     return NULL;
@@ -57,6 +57,7 @@ struct epan_column_info {
   col_expr_t          col_expr;             /**< Column expressions and values */
   gboolean            writable;             /**< writable or not @todo Are we still writing to the columns? */
   GRegex             *prime_regex;          /**< Used to prime custom columns */
+  GArray             *custom_prime_hfids;   /**< Deduplicated hf ids of all custom columns */
 };
 
 #ifdef __cplusplus
@@ -26,6 +26,7 @@
 #include "osi-utils.h"
 #include "value_string.h"
 #include "column-info.h"
+#include "frame_class.h"
 #include "proto.h"
 
 #include <epan/strutil.h>
@@ -45,6 +46,29 @@ static char *col_decimal_point;
 /* Used to indicate updated column information, e.g. a new request/response. */
 static gboolean col_data_changed_;
 
+/* Write exactly two decimal digits (for hours/minutes/seconds). */
+static inline char *
+col_write_two_digits(char *p, int val)
+{
+  *p++ = '0' + (val / 10) % 10;
+  *p++ = '0' + val % 10;
+  return p;
+}
+
+/* Write 'digits' decimal digits of a fraction, most significant first. */
+static inline char *
+col_write_frac_digits(char *p, int frac, int digits)
+{
+  char *q = p + digits;
+  int   i;
+
+  for (i = 0; i < digits; i++) {
+    p[digits - 1 - i] = '0' + frac % 10;
+    frac /= 10;
+  }
+  return q;
+}
+
 /* Allocate all the data structures for constructing column data, given
    the number of columns. */
 void
@@ -70,6 +94,7 @@ col_setup(column_info *cinfo, const gint num_cols)
   cinfo->prime_regex = g_regex_new(COL_CUSTOM_PRIME_REGEX,
     (GRegexCompileFlags) (G_REGEX_ANCHORED | G_REGEX_RAW),
     G_REGEX_MATCH_ANCHORED, NULL);
+  cinfo->custom_prime_hfids = NULL;
 }
 
 static void
@@ -118,6 +143,9 @@ col_cleanup(column_info *cinfo)
   g_free(cinfo->col_expr.col_expr_val);
   if (cinfo->prime_regex)
     g_regex_unref(cinfo->prime_regex);
+  if (cinfo->custom_prime_hfids)
+    g_array_free(cinfo->custom_prime_hfids, TRUE);
+  cinfo->custom_prime_hfids = NULL;
 }
 
 /* Initialize the data structures for constructing column data. */
@@ -362,21 +390,14 @@ void col_custom_set_edt(epan_dissect_t *edt, column_info *cinfo)
 void
 col_custom_prime_edt(epan_dissect_t *edt, column_info *cinfo)
 {
-  int i;
-  col_item_t* col_item;
-
   if (!HAVE_CUSTOM_COLS(cinfo))
     return;
 
-  for (i = cinfo->col_first[COL_CUSTOM];
-       i <= cinfo->col_last[COL_CUSTOM]; i++) {
-    col_item = &cinfo->columns[i];
-
-    if (col_item->fmt_matx[COL_CUSTOM] &&
-        col_item->col_custom_dfilter) {
-      epan_dissect_prime_with_dfilter(edt, col_item->col_custom_dfilter);
-    }
-  }
+  /* col_finalize() merged the fields of all custom columns into one
+     deduplicated hf id list, so we walk that list once per packet
+     rather than every column's compiled filter. */
+  if (cinfo->custom_prime_hfids)
+    epan_dissect_prime_with_hfid_array(edt, cinfo->custom_prime_hfids);
 }
 
 void
@@ -1469,19 +1490,40 @@ col_set_delta_time_dis(const frame_data *fd, column_info *cinfo, const int col)
 static void
 set_abs_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
 {
+  /* localtime()/gmtime() and snprintf() both show up in profiles here,
+     and this runs for every packet on every pass. Neighbouring frames
+     usually fall into the same second, so cache the last broken-down
+     time per zone and emit the digits directly. */
+  static time_t    cached_secs[2] = { (time_t)-1, (time_t)-1 };
+  static struct tm cached_tm[2];
+  static gboolean  cached_valid[2];
   struct tm *tmp;
   time_t then;
   int tsprecision;
+  int zone = local ? 1 : 0;
 
   if (fd->has_ts) {
     then = fd->abs_ts.secs;
-    if (local)
-      tmp = localtime(&then);
-    else
-      tmp = gmtime(&then);
+    if (cached_valid[zone] && then == cached_secs[zone]) {
+      tmp = &cached_tm[zone];
+    } else {
+      if (local)
+        tmp = localtime(&then);
+      else
+        tmp = gmtime(&then);
+      if (tmp != NULL) {
+        cached_tm[zone]    = *tmp;
+        cached_secs[zone]  = then;
+        cached_valid[zone] = TRUE;
+        tmp = &cached_tm[zone];
+      }
+    }
   } else
     tmp = NULL;
   if (tmp != NULL) {
+    int frac_digits = 0, frac = 0;
+    char *p;
+
     switch (timestamp_get_precision()) {
     case TS_PREC_FIXED_SEC:
       tsprecision = WTAP_TSPREC_SEC;
@@ -1509,55 +1551,42 @@ set_abs_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean loc
     }
     switch (tsprecision) {
     case WTAP_TSPREC_SEC:
-      snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec);
       break;
     case WTAP_TSPREC_DSEC:
-      snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%01d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
+      frac_digits = 1;
+      frac = fd->abs_ts.nsecs / 100000000;
       break;
     case WTAP_TSPREC_CSEC:
-      snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%02d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
+      frac_digits = 2;
+      frac = fd->abs_ts.nsecs / 10000000;
       break;
     case WTAP_TSPREC_MSEC:
-      snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%03d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
+      frac_digits = 3;
+      frac = fd->abs_ts.nsecs / 1000000;
       break;
     case WTAP_TSPREC_USEC:
-      snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%06d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
+      frac_digits = 6;
+      frac = fd->abs_ts.nsecs / 1000;
       break;
     case WTAP_TSPREC_NSEC:
-      snprintf(buf, COL_MAX_LEN, "%02d:%02d:%02d%s%09d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
+      frac_digits = 9;
+      frac = fd->abs_ts.nsecs;
       break;
     default:
       ws_assert_not_reached();
     }
 
+    p = col_write_two_digits(buf, tmp->tm_hour);
+    *p++ = ':';
+    p = col_write_two_digits(p, tmp->tm_min);
+    *p++ = ':';
+    p = col_write_two_digits(p, tmp->tm_sec);
+    if (frac_digits != 0) {
+      p = g_stpcpy(p, decimal_point);
+      p = col_write_frac_digits(p, frac, frac_digits);
+    }
+    *p = '\0';
+
   } else {
     *buf = '\0';
   }
@@ -1928,6 +1957,60 @@ col_set_time(column_info *cinfo, const gint el, const nstime_t *ts, const char *
   }
 }
 
+/*
+ * The numeric string for an address depends only on its bytes, and a
+ * conversation's two endpoints repeat for run after run of packets, so
+ * cache the formatted strings. Keys are (type, address bytes); the
+ * cache is flushed wholesale when it fills so it can't grow without
+ * bound on address-rich captures. Strings are copied out, never handed
+ * to callers, so flushing is always safe.
+ */
+#define ADDR_STR_CACHE_MAX 4096
+
+static GHashTable *addr_str_cache;
+
+static void
+col_addr_to_str_buf(const address *addr, gchar *buf, gsize buf_len)
+{
+  guint8  keybuf[sizeof(int) + 64];
+  GBytes *lookup_key;
+  gsize   key_len;
+  const char *cached;
+
+  if (addr->len < 0 || addr->len > 64 || addr->data == NULL) {
+    /* Doesn't fit a cache key; just format it. */
+    address_to_str_buf(addr, buf, (int)buf_len);
+    return;
+  }
+
+  if (addr_str_cache == NULL) {
+    addr_str_cache = g_hash_table_new_full(g_bytes_hash, g_bytes_equal,
+        (GDestroyNotify)g_bytes_unref, g_free);
+  }
+
+  memcpy(keybuf, &addr->type, sizeof(int));
+  memcpy(keybuf + sizeof(int), addr->data, addr->len);
+  key_len = sizeof(int) + addr->len;
+
+  lookup_key = g_bytes_new_static(keybuf, key_len);
+  cached = (const char *)g_hash_table_lookup(addr_str_cache, lookup_key);
+  g_bytes_unref(lookup_key);
+
+  if (cached == NULL) {
+    char str[COL_MAX_LEN];
+
+    address_to_str_buf(addr, str, COL_MAX_LEN);
+    if (g_hash_table_size(addr_str_cache) >= ADDR_STR_CACHE_MAX)
+      g_hash_table_remove_all(addr_str_cache);
+    g_hash_table_insert(addr_str_cache, g_bytes_new(keybuf, key_len),
+        g_strdup(str));
+    (void) g_strlcpy(buf, str, buf_len);
+    return;
+  }
+
+  (void) g_strlcpy(buf, cached, buf_len);
+}
+
 static void
 col_set_addr(packet_info *pinfo, const int col, const address *addr, const gboolean is_src,
              const gboolean fill_col_exprs, const gboolean res)
@@ -1944,7 +2027,7 @@ col_set_addr(packet_info *pinfo, const int col, const address *addr, const gbool
     col_item->col_data = name;
   else {
     col_item->col_data = col_item->col_buf;
-    address_to_str_buf(addr, col_item->col_buf, COL_MAX_LEN);
+    col_addr_to_str_buf(addr, col_item->col_buf, COL_MAX_LEN);
   }
 
   if (!fill_col_exprs)
@@ -1953,7 +2036,7 @@ col_set_addr(packet_info *pinfo, const int col, const address *addr, const gbool
   pinfo->cinfo->col_expr.col_expr[col] = address_type_column_filter_string(addr, is_src);
   /* For address types that have a filter, create a string */
   if (strlen(pinfo->cinfo->col_expr.col_expr[col]) > 0)
-    address_to_str_buf(addr, pinfo->cinfo->col_expr.col_expr_val[col], COL_MAX_LEN);
+    col_addr_to_str_buf(addr, pinfo->cinfo->col_expr.col_expr_val[col], COL_MAX_LEN);
 }
 
 /* ------------------------ */
@@ -2067,6 +2150,7 @@ col_based_on_frame_data(column_info *cinfo, const gint col)
   case COL_DELTA_TIME_DIS:
   case COL_PACKET_LENGTH:
   case COL_CUMULATIVE_BYTES:
+  case COL_COARSE_CLASS:
     return TRUE;
 
   default:
@@ -2109,6 +2193,13 @@ col_fill_in_frame_data(const frame_data *fd, column_info *cinfo, const gint col,
     col_item->col_data = col_item->col_buf;
     break;
 
+  case COL_COARSE_CLASS:
+    (void) g_strlcpy(col_item->col_buf,
+                     val_to_str_const(fd->coarse_class, frame_class_vals, "Unclassified"),
+                     COL_MAX_LEN);
+    col_item->col_data = col_item->col_buf;
+    break;
+
   default:
     break;
   }
@@ -2140,6 +2231,11 @@ col_fill_in_frame_data(const frame_data *fd, column_info *cinfo, const gint col,
     (void) g_strlcpy(cinfo->col_expr.col_expr_val[col], col_item->col_buf, COL_MAX_LEN);
     break;
 
+  case COL_COARSE_CLASS:
+    cinfo->col_expr.col_expr[col] = "frame.coarse_class";
+    guint32_to_str_buf(fd->coarse_class, cinfo->col_expr.col_expr_val[col], COL_MAX_LEN);
+    break;
+
   case COL_CUMULATIVE_BYTES:
     break;
 
@@ -89,7 +89,8 @@ enum {
   COL_UTC_YDOY_TIME,  /**< 47) UTC date, as YYYY/DOY, and time */
   COL_UTC_TIME,       /**< 48) UTC time */
   COL_CLS_TIME,       /**< 49) Command line-specified time (default relative) */
-  NUM_COL_FMTS        /**< 50) Should always be last */
+  COL_COARSE_CLASS,   /**< 50) Pre-dissection coarse class (see frame_class.h) */
+  NUM_COL_FMTS        /**< 51) Should always be last */
 };
 
 /** Allocate all the data structures for constructing column data, given
@@ -79,7 +79,8 @@ col_format_to_string(const gint fmt) {
     "%Yut",                                     /* 46) COL_UTC_YMD_TIME */
     "%YDOYut",                                  /* 47) COL_UTC_YDOY_TIME */
     "%Aut",                                     /* 48) COL_UTC_TIME */
-    "%t"                                        /* 49) COL_CLS_TIME */
+    "%t",                                       /* 49) COL_CLS_TIME */
+    "%k"                                        /* 50) COL_COARSE_CLASS */
   };
 
  /* The following formats have been used in deprecated columns.  Noted here
@@ -122,6 +123,7 @@ col_format_desc(const gint fmt_num) {
     { COL_ABS_YDOY_TIME, "Absolute date, as YYYY/DOY, and time" },
     { COL_ABS_TIME, "Absolute time" },
     { COL_VSAN, "Cisco VSAN" },
+    { COL_COARSE_CLASS, "Coarse class (pre-dissection)" },
     { COL_CUMULATIVE_BYTES, "Cumulative Bytes" },
     { COL_CUSTOM, "Custom" },
     { COL_DCE_CALL, "DCE/RPC call (cn_call_id / dg_seqnum)" },
@@ -500,6 +502,9 @@ get_column_longest_string(const gint format)
     case COL_CUMULATIVE_BYTES:
       return "00000000";
       break;
+    case COL_COARSE_CLASS:
+      return "Unclassified";
+      break;
     case COL_IF_DIR:
       return "i 00000000 I";
       break;
@@ -862,6 +867,37 @@ col_finalize(column_info *cinfo)
   cinfo->col_expr.col_expr[i] = NULL;
   cinfo->col_expr.col_expr_val[i] = NULL;
 
+  /* Merge the fields that all the custom columns read into a single
+     deduplicated hf id list.  col_custom_prime_edt() primes each
+     dissection from that list, so several custom columns reading the
+     same fields cost no more per packet than one. */
+  if (cinfo->custom_prime_hfids != NULL) {
+    g_array_free(cinfo->custom_prime_hfids, TRUE);
+    cinfo->custom_prime_hfids = NULL;
+  }
+  for (i = 0; i < cinfo->num_cols; i++) {
+    const int *fields;
+    int        num_fields, i_field;
+
+    col_item = &cinfo->columns[i];
+    if (col_item->col_fmt != COL_CUSTOM || !col_item->col_custom_dfilter)
+      continue;
+
+    num_fields = dfilter_interesting_fields(col_item->col_custom_dfilter, &fields);
+    for (i_field = 0; i_field < num_fields; i_field++) {
+      guint j;
+
+      if (cinfo->custom_prime_hfids == NULL)
+        cinfo->custom_prime_hfids = g_array_new(FALSE, FALSE, sizeof(int));
+      for (j = 0; j < cinfo->custom_prime_hfids->len; j++) {
+        if (g_array_index(cinfo->custom_prime_hfids, int, j) == fields[i_field])
+          break;
+      }
+      if (j == cinfo->custom_prime_hfids->len)
+        g_array_append_val(cinfo->custom_prime_hfids, fields[i_field]);
+    }
+  }
+
   for (i = 0; i < cinfo->num_cols; i++) {
     int j;
 
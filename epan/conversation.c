@@ -14,6 +14,7 @@
 #include <glib.h>
 #include "packet.h"
 #include "to_str.h"
+#include "address_intern.h"
 #include "conversation.h"
 
 /* define DEBUG_CONVERSATION for pretty debug printing */
@@ -70,6 +71,73 @@ static guint32 new_index;
  */
 static address null_address_ = ADDRESS_INIT_NONE;
 
+/*
+ * One-entry memo of the last find_conversation() result.  Dissectors up
+ * the protocol stack re-look-up the same 5-tuple several times while
+ * dissecting one packet, so a single entry hits a lot.  The memo is
+ * dropped whenever a conversation hash table changes, as that can
+ * change what the same key would find; the insert/remove chokepoints
+ * below take care of that.
+ */
+static struct {
+	gboolean	valid;
+	guint32		frame_num;
+	address		addr_a;
+	address		addr_b;
+	endpoint_type	etype;
+	guint32		port_a;
+	guint32		port_b;
+	guint		options;
+	conversation_t *result;
+} find_memo;
+
+static void
+find_memo_invalidate(void)
+{
+	find_memo.valid = FALSE;
+}
+
+static gboolean
+find_memo_matches(const guint32 frame_num, const address *addr_a,
+    const address *addr_b, const endpoint_type etype, const guint32 port_a,
+    const guint32 port_b, const guint options)
+{
+	/*
+	 * Only a hit at the same frame is sound.  At a later frame the
+	 * right answer can differ without any table change in between:
+	 * when frames are re-dissected out of capture order, the tables
+	 * already hold conversations whose setup frame lies between the
+	 * memoized frame and the searched one.
+	 */
+	return find_memo.valid &&
+	    frame_num == find_memo.frame_num &&
+	    etype == find_memo.etype &&
+	    options == find_memo.options &&
+	    port_a == find_memo.port_a &&
+	    port_b == find_memo.port_b &&
+	    addresses_equal(&find_memo.addr_a, addr_a) &&
+	    addresses_equal(&find_memo.addr_b, addr_b);
+}
+
+static void
+find_memo_store(const guint32 frame_num, const address *addr_a,
+    const address *addr_b, const endpoint_type etype, const guint32 port_a,
+    const guint32 port_b, const guint options, conversation_t *result)
+{
+	/* The searched addresses live in packet scope; keep copies. */
+	free_address(&find_memo.addr_a);
+	free_address(&find_memo.addr_b);
+	copy_address(&find_memo.addr_a, addr_a);
+	copy_address(&find_memo.addr_b, addr_b);
+	find_memo.frame_num = frame_num;
+	find_memo.etype = etype;
+	find_memo.port_a = port_a;
+	find_memo.port_b = port_b;
+	find_memo.options = options;
+	find_memo.result = result;
+	find_memo.valid = TRUE;
+}
+
 
 /*
  * Creates a new conversation with known endpoints based on a conversation
@@ -167,6 +235,23 @@ conversation_create_from_template(conversation_t *conversation, const address *a
 	}
 }
 
+/*
+ * Mix a port value into a hash value, with the same mixing step the
+ * One-at-a-Time hash uses.  This used to be done by synthesizing a
+ * 4-byte address around the port and hashing that a byte at a time;
+ * mixing the value directly does the same job without the memory
+ * traffic, which matters on captures with millions of flows where
+ * these hash functions run several times per packet.
+ */
+static inline guint
+add_port_to_hash(guint hash_val, guint32 port)
+{
+	hash_val += port;
+	hash_val += ( hash_val << 10 );
+	hash_val ^= ( hash_val >> 6 );
+	return hash_val;
+}
+
 /*
  * Compute the hash value for two given address/port pairs if the match
  * is to be exact.
@@ -180,20 +265,13 @@ conversation_hash_exact(gconstpointer v)
 {
 	const conversation_key_t key = (const conversation_key_t)v;
 	guint hash_val;
-	address tmp_addr;
 
 	hash_val = 0;
-	tmp_addr.len  = 4;
 
 	hash_val = add_address_to_hash(hash_val, &key->addr1);
-
-	tmp_addr.data = &key->port1;
-	hash_val = add_address_to_hash(hash_val, &tmp_addr);
-
+	hash_val = add_port_to_hash(hash_val, key->port1);
 	hash_val = add_address_to_hash(hash_val, &key->addr2);
-
-	tmp_addr.data = &key->port2;
-	hash_val = add_address_to_hash(hash_val, &tmp_addr);
+	hash_val = add_port_to_hash(hash_val, key->port2);
 
 	hash_val += ( hash_val << 3 );
 	hash_val ^= ( hash_val >> 11 );
@@ -263,18 +341,12 @@ conversation_hash_no_addr2(gconstpointer v)
 {
 	const conversation_key_t key = (const conversation_key_t)v;
 	guint hash_val;
-	address tmp_addr;
 
 	hash_val = 0;
-	tmp_addr.len  = 4;
 
 	hash_val = add_address_to_hash(hash_val, &key->addr1);
-
-	tmp_addr.data = &key->port1;
-	hash_val = add_address_to_hash(hash_val, &tmp_addr);
-
-	tmp_addr.data = &key->port2;
-	hash_val = add_address_to_hash(hash_val, &tmp_addr);
+	hash_val = add_port_to_hash(hash_val, key->port1);
+	hash_val = add_port_to_hash(hash_val, key->port2);
 
 	hash_val += ( hash_val << 3 );
 	hash_val ^= ( hash_val >> 11 );
@@ -328,16 +400,11 @@ conversation_hash_no_port2(gconstpointer v)
 {
 	const conversation_key_t key = (const conversation_key_t)v;
 	guint hash_val;
-	address tmp_addr;
 
 	hash_val = 0;
-	tmp_addr.len  = 4;
 
 	hash_val = add_address_to_hash(hash_val, &key->addr1);
-
-	tmp_addr.data = &key->port1;
-	hash_val = add_address_to_hash(hash_val, &tmp_addr);
-
+	hash_val = add_port_to_hash(hash_val, key->port1);
 	hash_val = add_address_to_hash(hash_val, &key->addr2);
 
 	hash_val += ( hash_val << 3 );
@@ -392,15 +459,11 @@ conversation_hash_no_addr2_or_port2(gconstpointer v)
 {
 	const conversation_key_t key = (const conversation_key_t)v;
 	guint hash_val;
-	address tmp_addr;
 
 	hash_val = 0;
-	tmp_addr.len  = 4;
 
 	hash_val = add_address_to_hash(hash_val, &key->addr1);
-
-	tmp_addr.data = &key->port1;
-	hash_val = add_address_to_hash(hash_val, &tmp_addr);
+	hash_val = add_port_to_hash(hash_val, key->port1);
 
 	hash_val += ( hash_val << 3 );
 	hash_val ^= ( hash_val >> 11 );
@@ -481,6 +544,11 @@ void conversation_epan_reset(void)
 	 * Start the conversation indices over at 0.
 	 */
 	new_index = 0;
+
+	/*
+	 * The conversations the memo points into are gone.
+	 */
+	find_memo_invalidate();
 }
 
 /*
@@ -494,6 +562,8 @@ conversation_insert_into_hashtable(wmem_map_t *hashtable, conversation_t *conv)
 {
 	conversation_t *chain_head, *chain_tail, *cur, *prev;
 
+	find_memo_invalidate();
+
 	chain_head = (conversation_t *)wmem_map_lookup(hashtable, conv->key_ptr);
 
 	if (NULL==chain_head) {
@@ -550,6 +620,8 @@ conversation_remove_from_hashtable(wmem_map_t *hashtable, conversation_t *conv)
 {
 	conversation_t *chain_head, *cur, *prev;
 
+	find_memo_invalidate();
+
 	chain_head = (conversation_t *)wmem_map_lookup(hashtable, conv->key_ptr);
 
 	if (conv == chain_head) {
@@ -620,6 +692,7 @@ conversation_new(const guint32 setup_frame, const address *addr1, const address
 	wmem_map_t* hashtable;
 	conversation_t *conversation=NULL;
 	conversation_key_t new_key;
+	guint8 *addr_data;
 
 #ifdef DEBUG_CONVERSATION
 	gchar *addr1_str, *addr2_str;
@@ -724,14 +797,36 @@ conversation_new(const guint32 setup_frame, const address *addr1, const address
 		}
 	}
 
-	new_key = wmem_new(wmem_file_scope(), struct conversation_key);
+	/*
+	 * Allocate the key and both address payloads in a single
+	 * file-scope allocation, with the address data placed inline
+	 * after the key, rather than doing a separate allocation per
+	 * address; with millions of conversations the extra allocations
+	 * (and the pointer chasing they cost on lookup) add up.
+	 */
+	new_key = (conversation_key_t)wmem_alloc(wmem_file_scope(),
+	    sizeof(struct conversation_key) +
+	    (addr1 != NULL ? addr1->len : 0) +
+	    (addr2 != NULL ? addr2->len : 0));
+	addr_data = (guint8 *)new_key + sizeof(struct conversation_key);
 	if (addr1 != NULL) {
-		copy_address_wmem(wmem_file_scope(), &new_key->addr1, addr1);
+		if (addr1->len > 0) {
+			memcpy(addr_data, addr1->data, addr1->len);
+			set_address(&new_key->addr1, addr1->type, addr1->len, addr_data);
+			addr_data += addr1->len;
+		} else {
+			set_address(&new_key->addr1, addr1->type, 0, NULL);
+		}
 	} else {
 		clear_address(&new_key->addr1);
 	}
 	if (addr2 != NULL) {
-		copy_address_wmem(wmem_file_scope(), &new_key->addr2, addr2);
+		if (addr2->len > 0) {
+			memcpy(addr_data, addr2->data, addr2->len);
+			set_address(&new_key->addr2, addr2->type, addr2->len, addr_data);
+		} else {
+			set_address(&new_key->addr2, addr2->type, 0, NULL);
+		}
 	} else {
 		clear_address(&new_key->addr2);
 	}
@@ -828,7 +923,7 @@ conversation_set_addr2(conversation_t *conv, const address *addr)
 		conversation_remove_from_hashtable(conversation_hashtable_no_port2, conv);
 	}
 	conv->options &= ~NO_ADDR2;
-	copy_address_wmem(wmem_file_scope(), &conv->key_ptr->addr2, addr);
+	intern_address(&conv->key_ptr->addr2, addr);
 	if (conv->options & NO_PORT2) {
 		conversation_insert_into_hashtable(conversation_hashtable_no_port2, conv);
 	} else {
@@ -935,6 +1030,10 @@ find_conversation(const guint32 frame_num, const address *addr_a, const address
 {
 	conversation_t *conversation;
 
+	if (addr_a != NULL && addr_b != NULL &&
+	    find_memo_matches(frame_num, addr_a, addr_b, etype, port_a, port_b, options))
+		return find_memo.result;
+
 	DINSTR(gchar *addr_a_str = address_to_str(NULL, addr_a));
 	DINSTR(gchar *addr_b_str = address_to_str(NULL, addr_b));
 	/*
@@ -1283,6 +1382,14 @@ find_conversation(const guint32 frame_num, const address *addr_a, const address
 	conversation = NULL;
 
 end:
+	/*
+	 * Memoize after the wildcard promotions above, so an invalidation
+	 * they trigger doesn't outlive the result we hand back.
+	 */
+	if (addr_a != NULL && addr_b != NULL) {
+		find_memo_store(frame_num, addr_a, addr_b, etype, port_a,
+		    port_b, options, conversation);
+	}
 	DINSTR(wmem_free(NULL, addr_a_str));
 	DINSTR(wmem_free(NULL, addr_b_str));
 	return conversation;
@@ -1533,11 +1640,14 @@ void conversation_create_endpoint(struct _packet_info *pinfo, address* addr1, ad
 	pinfo->conv_endpoint = wmem_new0(pinfo->pool, struct endpoint);
 	pinfo->use_endpoint = TRUE;
 
+	/* The endpoint only lives for this packet, so interned (file
+	 * scoped) address data comfortably outlives it and no per-packet
+	 * copy is needed. */
 	if (addr1 != NULL)
-		copy_address_wmem(pinfo->pool, &pinfo->conv_endpoint->addr1, addr1);
+		intern_address(&pinfo->conv_endpoint->addr1, addr1);
 
 	if (addr2 != NULL)
-		copy_address_wmem(pinfo->pool, &pinfo->conv_endpoint->addr2, addr2);
+		intern_address(&pinfo->conv_endpoint->addr2, addr2);
 
 	pinfo->conv_endpoint->etype = etype;
 	pinfo->conv_endpoint->port1 = port1;
@@ -268,6 +268,9 @@ reset_conversation_table_data(conv_hash_t *ch)
 
     ch->conv_array=NULL;
     ch->hashtable=NULL;
+    ch->has_last=FALSE;
+    nstime_set_unset(&ch->min_start_time);
+    nstime_set_unset(&ch->max_stop_time);
 }
 
 void reset_hostlist_table_data(conv_hash_t *ch)
@@ -292,6 +295,38 @@ void reset_hostlist_table_data(conv_hash_t *ch)
 
     ch->conv_array=NULL;
     ch->hashtable=NULL;
+    ch->has_last=FALSE;
+}
+
+void resolve_conversation_table_names(conv_hash_t *ch, guint timeout_ms)
+{
+    guint i;
+
+    if (ch->conv_array == NULL)
+        return;
+
+    for (i = 0; i < ch->conv_array->len; i++) {
+        conv_item_t *conv = &g_array_index(ch->conv_array, conv_item_t, i);
+        queue_async_host_name_lookup(&conv->src_address);
+        queue_async_host_name_lookup(&conv->dst_address);
+    }
+
+    host_name_lookup_drain(timeout_ms);
+}
+
+void resolve_hostlist_table_names(conv_hash_t *ch, guint timeout_ms)
+{
+    guint i;
+
+    if (ch->conv_array == NULL)
+        return;
+
+    for (i = 0; i < ch->conv_array->len; i++) {
+        hostlist_talker_t *host = &g_array_index(ch->conv_array, hostlist_talker_t, i);
+        queue_async_host_name_lookup(&host->myaddress);
+    }
+
+    host_name_lookup_drain(timeout_ms);
 }
 
 char *get_conversation_address(wmem_allocator_t *allocator, address *addr, gboolean resolve_names)
@@ -592,31 +627,60 @@ add_conversation_table_data_with_conv_id(
                                               g_free,             /* key_destroy_func */
                                               NULL);              /* value_destroy_func */
 
+        ch->has_last = FALSE;
+        nstime_set_unset(&ch->min_start_time);
+        nstime_set_unset(&ch->max_stop_time);
     } else { /* try to find it among the existing known conversations */
-        /* first, check in the fwd conversations */
-        conv_key_t existing_key;
-        gpointer conversation_idx_hash_val;
-
-        existing_key.addr1 = *src;
-        existing_key.addr2 = *dst;
-        existing_key.port1 = src_port;
-        existing_key.port2 = dst_port;
-        existing_key.conv_id = conv_id;
-        if (g_hash_table_lookup_extended(ch->hashtable, &existing_key, NULL, &conversation_idx_hash_val)) {
-            conv_item = &g_array_index(ch->conv_array, conv_item_t, GPOINTER_TO_UINT(conversation_idx_hash_val));
+        /* Packets tend to arrive in bursts belonging to one conversation;
+           check the conversation the previous packet was added to before
+           paying for hash lookups in both directions. */
+        if (ch->has_last) {
+            conv_item_t *last_item = &g_array_index(ch->conv_array, conv_item_t, ch->last_idx);
+
+            if (last_item->etype == etype && last_item->conv_id == conv_id) {
+                if (last_item->src_port == src_port && last_item->dst_port == dst_port &&
+                    addresses_equal(&last_item->src_address, src) &&
+                    addresses_equal(&last_item->dst_address, dst)) {
+                    conv_item = last_item;
+                    is_fwd_direction = TRUE;
+                } else if (last_item->src_port == dst_port && last_item->dst_port == src_port &&
+                    addresses_equal(&last_item->src_address, dst) &&
+                    addresses_equal(&last_item->dst_address, src)) {
+                    conv_item = last_item;
+                }
+            }
         }
+
         if (conv_item == NULL) {
-            /* then, check in the rev conversations if not found in 'fwd' */
-            existing_key.addr1 = *dst;
-            existing_key.addr2 = *src;
-            existing_key.port1 = dst_port;
-            existing_key.port2 = src_port;
+            /* first, check in the fwd conversations */
+            conv_key_t existing_key;
+            gpointer conversation_idx_hash_val;
+
+            existing_key.addr1 = *src;
+            existing_key.addr2 = *dst;
+            existing_key.port1 = src_port;
+            existing_key.port2 = dst_port;
+            existing_key.conv_id = conv_id;
             if (g_hash_table_lookup_extended(ch->hashtable, &existing_key, NULL, &conversation_idx_hash_val)) {
                 conv_item = &g_array_index(ch->conv_array, conv_item_t, GPOINTER_TO_UINT(conversation_idx_hash_val));
             }
-        } else {
-            /* a conversation was found in this same fwd direction */
-            is_fwd_direction = TRUE;
+            if (conv_item == NULL) {
+                /* then, check in the rev conversations if not found in 'fwd' */
+                existing_key.addr1 = *dst;
+                existing_key.addr2 = *src;
+                existing_key.port1 = dst_port;
+                existing_key.port2 = src_port;
+                if (g_hash_table_lookup_extended(ch->hashtable, &existing_key, NULL, &conversation_idx_hash_val)) {
+                    conv_item = &g_array_index(ch->conv_array, conv_item_t, GPOINTER_TO_UINT(conversation_idx_hash_val));
+                }
+            } else {
+                /* a conversation was found in this same fwd direction */
+                is_fwd_direction = TRUE;
+            }
+            if (conv_item != NULL) {
+                ch->last_idx = GPOINTER_TO_UINT(conversation_idx_hash_val);
+                ch->has_last = TRUE;
+            }
         }
     }
 
@@ -661,6 +725,9 @@ add_conversation_table_data_with_conv_id(
         new_key->conv_id = conv_id;
         g_hash_table_insert(ch->hashtable, new_key, GUINT_TO_POINTER(conversation_idx));
 
+        ch->last_idx = conversation_idx;
+        ch->has_last = TRUE;
+
         /* update the conversation struct */
         conv_item->tx_frames += num_frames;
         conv_item->tx_bytes += num_bytes;
@@ -685,6 +752,20 @@ add_conversation_table_data_with_conv_id(
             memcpy(&conv_item->start_time, ts, sizeof(conv_item->start_time));
             memcpy(&conv_item->start_abs_time, abs_ts, sizeof(conv_item->start_abs_time));
         }
+
+        /* Maintain the overall time extents here, so a GUI drawing a
+           timeline doesn't have to rescan every conversation per draw. */
+        if (nstime_is_unset(&ch->max_stop_time)) {
+            ch->min_start_time = conv_item->start_time;
+            ch->max_stop_time = conv_item->stop_time;
+        } else {
+            if (nstime_cmp(&conv_item->start_time, &ch->min_start_time) < 0) {
+                ch->min_start_time = conv_item->start_time;
+            }
+            if (nstime_cmp(&conv_item->stop_time, &ch->max_stop_time) > 0) {
+                ch->max_stop_time = conv_item->stop_time;
+            }
+        }
     }
 }
 
@@ -792,6 +873,118 @@ add_hostlist_table_data(conv_hash_t *ch, const address *addr, guint32 port, gboo
     }
 }
 
+/*
+ * Binary aggregate export. The format is described in
+ * conversation_table.h; all multi-byte integers are little-endian.
+ */
+
+static gboolean
+export_write(FILE *fp, const void *data, size_t length)
+{
+    return fwrite(data, length, 1, fp) == 1;
+}
+
+static gboolean
+export_write_u32(FILE *fp, guint32 val)
+{
+    val = GUINT32_TO_LE(val);
+    return export_write(fp, &val, sizeof val);
+}
+
+static gboolean
+export_write_u64(FILE *fp, guint64 val)
+{
+    val = GUINT64_TO_LE(val);
+    return export_write(fp, &val, sizeof val);
+}
+
+static gboolean
+export_write_time(FILE *fp, const nstime_t *ts)
+{
+    return export_write_u64(fp, (guint64)ts->secs) &&
+           export_write_u32(fp, (guint32)ts->nsecs);
+}
+
+static gboolean
+export_write_address(FILE *fp, const address *addr)
+{
+    if (!export_write_u32(fp, (guint32)addr->type) ||
+        !export_write_u32(fp, (guint32)addr->len))
+        return FALSE;
+    if (addr->len == 0)
+        return TRUE;
+    return export_write(fp, addr->data, addr->len);
+}
+
+static gboolean
+export_write_header(FILE *fp, guint8 table_type, int proto_id, guint32 records)
+{
+    const char *proto_name = proto_get_protocol_filter_name(proto_id);
+    guint8 version = 1;
+    guint8 name_len = (guint8)MIN(strlen(proto_name), G_MAXUINT8);
+
+    return export_write(fp, "WSCT", 4) &&
+           export_write(fp, &version, 1) &&
+           export_write(fp, &table_type, 1) &&
+           export_write(fp, &name_len, 1) &&
+           export_write(fp, proto_name, name_len) &&
+           export_write_u32(fp, records);
+}
+
+gboolean
+conversation_table_export_binary(conv_hash_t *hash, int proto_id, FILE *fp)
+{
+    guint32 records = hash->conv_array ? hash->conv_array->len : 0;
+    guint i;
+
+    if (!export_write_header(fp, 0, proto_id, records))
+        return FALSE;
+
+    for (i = 0; i < records; i++) {
+        conv_item_t *item = &g_array_index(hash->conv_array, conv_item_t, i);
+
+        if (!export_write_address(fp, &item->src_address) ||
+            !export_write_address(fp, &item->dst_address) ||
+            !export_write_u32(fp, item->src_port) ||
+            !export_write_u32(fp, item->dst_port) ||
+            !export_write_u32(fp, (guint32)item->etype) ||
+            !export_write_u32(fp, item->conv_id) ||
+            !export_write_u64(fp, item->rx_frames) ||
+            !export_write_u64(fp, item->tx_frames) ||
+            !export_write_u64(fp, item->rx_bytes) ||
+            !export_write_u64(fp, item->tx_bytes) ||
+            !export_write_time(fp, &item->start_time) ||
+            !export_write_time(fp, &item->stop_time) ||
+            !export_write_time(fp, &item->start_abs_time))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+gboolean
+hostlist_table_export_binary(conv_hash_t *hash, int proto_id, FILE *fp)
+{
+    guint32 records = hash->conv_array ? hash->conv_array->len : 0;
+    guint i;
+
+    if (!export_write_header(fp, 1, proto_id, records))
+        return FALSE;
+
+    for (i = 0; i < records; i++) {
+        hostlist_talker_t *host = &g_array_index(hash->conv_array, hostlist_talker_t, i);
+
+        if (!export_write_address(fp, &host->myaddress) ||
+            !export_write_u32(fp, host->port) ||
+            !export_write_u32(fp, (guint32)host->etype) ||
+            !export_write_u64(fp, host->rx_frames) ||
+            !export_write_u64(fp, host->tx_frames) ||
+            !export_write_u64(fp, host->rx_bytes) ||
+            !export_write_u64(fp, host->tx_bytes))
+            return FALSE;
+    }
+    return TRUE;
+}
+
 /*
  * Editor modelines
  *
@@ -12,6 +12,8 @@
 #ifndef __CONVERSATION_TABLE_H__
 #define __CONVERSATION_TABLE_H__
 
+#include <stdio.h>
+
 #include "conv_id.h"
 #include "tap.h"
 #include "conversation.h"
@@ -54,6 +56,10 @@ typedef struct _conversation_hash_t {
     GHashTable  *hashtable;       /**< conversations hash table */
     GArray      *conv_array;      /**< array of conversation values */
     void        *user_data;       /**< "GUI" specifics (if necessary) */
+    guint       last_idx;         /**< conversation the previous packet was added to */
+    gboolean    has_last;         /**< TRUE if last_idx is valid */
+    nstime_t    min_start_time;   /**< earliest start_time of any conversation, or unset */
+    nstime_t    max_stop_time;    /**< latest stop_time of any conversation, or unset */
 } conv_hash_t;
 
 /** Key for hash lookups */
@@ -216,6 +222,23 @@ WS_DLL_PUBLIC void reset_conversation_table_data(conv_hash_t *ch);
  */
 WS_DLL_PUBLIC void reset_hostlist_table_data(conv_hash_t *ch);
 
+/** Queue asynchronous name lookups for every address in a conversation
+ * table and wait up to timeout_ms milliseconds for the answers, so that
+ * rendering the table afterwards finds the names already in the cache
+ * instead of resolving them one at a time.
+ *
+ * @param ch the table whose conversations to resolve
+ * @param timeout_ms how long to wait for outstanding lookups
+ */
+WS_DLL_PUBLIC void resolve_conversation_table_names(conv_hash_t *ch, guint timeout_ms);
+
+/** Same as resolve_conversation_table_names(), for a hostlist table.
+ *
+ * @param ch the table whose endpoints to resolve
+ * @param timeout_ms how long to wait for outstanding lookups
+ */
+WS_DLL_PUBLIC void resolve_hostlist_table_names(conv_hash_t *ch, guint timeout_ms);
+
 /** Initialize dissector conversation for stats and (possibly) GUI.
  *
  * @param opt_arg filter string to compare with dissector
@@ -265,6 +288,41 @@ WS_DLL_PUBLIC char *get_conversation_filter(conv_item_t *conv_item, conv_directi
  */
 WS_DLL_PUBLIC char *get_hostlist_filter(hostlist_talker_t *host);
 
+/** Write the aggregated conversations as a flat binary table, with no
+ * name resolution and no formatting.
+ *
+ * Format (all integers little-endian):
+ *   header:  "WSCT" magic, u8 version (1), u8 table type (0 =
+ *            conversations, 1 = endpoints), u8 protocol filter name
+ *            length, the name bytes, u32 record count
+ *   address: u32 address type (address_type), u32 data length, the
+ *            data bytes
+ *   time:    u64 seconds, u32 nanoseconds
+ *   conversation record: src address, dst address, u32 src port,
+ *            u32 dst port, u32 endpoint type, u32 conversation id
+ *            (0xffffffff when unset), u64 rx frames, u64 tx frames,
+ *            u64 rx bytes, u64 tx bytes, relative start time,
+ *            relative stop time, absolute start time
+ *
+ * @param hash the table with the aggregates
+ * @param proto_id protocol the aggregates belong to
+ * @param fp the open file to write to
+ * @return TRUE on success, FALSE on write error.
+ */
+WS_DLL_PUBLIC gboolean conversation_table_export_binary(conv_hash_t *hash, int proto_id, FILE *fp);
+
+/** Write the aggregated endpoints as a flat binary table. Same framing
+ * as conversation_table_export_binary() with table type 1; an endpoint
+ * record is: address, u32 port, u32 endpoint type, u64 rx frames,
+ * u64 tx frames, u64 rx bytes, u64 tx bytes.
+ *
+ * @param hash the table with the aggregates
+ * @param proto_id protocol the aggregates belong to
+ * @param fp the open file to write to
+ * @return TRUE on success, FALSE on write error.
+ */
+WS_DLL_PUBLIC gboolean hostlist_table_export_binary(conv_hash_t *hash, int proto_id, FILE *fp);
+
 /** Add some data to the conversation table.
  *
  * @param ch the table to add the data to
@@ -27,6 +27,10 @@ struct epan_dfilter {
 	int		*interesting_fields;
 	int		num_interesting_fields;
 	GPtrArray	*deprecated;
+	guint		ref_count;	/* handed out by dfilter_compile() */
+	gchar		*expanded_text;	/* compile cache key; macro-expanded filter text */
+	GArray		*frame_preds;	/* df_frame_pred_t; metadata-only prefix, or NULL */
+	gchar		*pcap_text;	/* capture filter for the kernel-evaluable part, or NULL */
 };
 
 typedef struct {
@@ -66,6 +70,12 @@ extern stnode_t *df_lval;
 /* Return value for error in scanner. */
 #define SCAN_FAILED	-1	/* not 0, as that means end-of-input */
 
+/* In dfilter-translate.c: translate a checked syntax tree into pcap
+ * filter text matching a superset of the packets the filter matches,
+ * or NULL if no part of the tree translates.  g_free() the result. */
+gchar *
+dfilter_translate_to_pcap(stnode_t *st_root);
+
 /* Set dfw->error_message */
 void
 dfilter_fail(dfwork_t *dfw, const char *format, ...) G_GNUC_PRINTF(2, 3);
@@ -0,0 +1,335 @@
+/* dfilter-translate.c
+ * Translate display filter syntax trees into capture (pcap) filter text
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 2001 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <glib.h>
+
+#include "dfilter-int.h"
+#include "syntax-tree.h"
+#include "sttype-test.h"
+
+#include <epan/proto.h>
+
+/*
+ * A display filter built from address, port, protocol and frame-length
+ * predicates can be evaluated by the kernel's BPF engine instead of
+ * dissecting every packet.  This module walks the checked syntax tree
+ * and emits pcap filter text matching a SUPERSET of the packets the
+ * display filter matches, so the result can be installed as a capture
+ * filter without losing any packet the display filter would accept;
+ * the display filter itself is still evaluated on whatever gets
+ * through.
+ *
+ * The superset property is kept by construction:
+ *
+ *  - translatable comparisons map to the corresponding pcap primitive;
+ *  - a conjunct of an AND with no translation is simply dropped,
+ *    which only widens the match;
+ *  - both branches of an OR must translate (an OR of supersets is a
+ *    superset);
+ *  - NOT and "!=" don't translate at all, since negating a superset
+ *    can exclude packets the display filter matches.
+ *
+ * Most pcap primitives are sensitive to the link-layer encapsulation:
+ * "host" and "port" test fixed offsets from the Ethernet header, so
+ * they don't match frames carrying an 802.1Q VLAN tag even though the
+ * display filter, which dissects the tag, would.  When the translation
+ * uses any such primitive, the result is emitted twice, once plainly
+ * and once behind pcap's "vlan" keyword (which shifts the offsets of
+ * the primitives that follow it), as
+ *
+ *	( <expr> ) or ( vlan and ( <expr> ) )
+ *
+ * so singly-tagged frames still match.  ("ether host" and "len" look
+ * at the frame itself and need no such treatment.)
+ *
+ * The usual capture filter caveats still apply: pcap primitives look
+ * at the outermost headers (past at most one VLAN tag, per the above),
+ * so a translated "tcp.port == 80" won't see QinQ or otherwise
+ * tunnelled traffic, or non-first IP fragments that the display filter
+ * would match after reassembly.  That's why tshark only installs the
+ * translation when explicitly asked to.
+ */
+
+typedef enum {
+	PCAP_FIELD_HOST,	/* IPv4/IPv6 host or net argument */
+	PCAP_FIELD_ETHER,	/* Ethernet host argument */
+	PCAP_FIELD_PORT		/* port number argument */
+} pcap_field_kind_t;
+
+typedef struct {
+	const char	 *abbrev;
+	pcap_field_kind_t kind;
+	const char	 *prefix;	/* pcap text before the argument */
+} pcap_field_map_t;
+
+static const pcap_field_map_t pcap_fields[] = {
+	{ "ip.addr",		PCAP_FIELD_HOST,	"" },
+	{ "ip.src",		PCAP_FIELD_HOST,	"src " },
+	{ "ip.dst",		PCAP_FIELD_HOST,	"dst " },
+	{ "ipv6.addr",		PCAP_FIELD_HOST,	"" },
+	{ "ipv6.src",		PCAP_FIELD_HOST,	"src " },
+	{ "ipv6.dst",		PCAP_FIELD_HOST,	"dst " },
+	{ "eth.addr",		PCAP_FIELD_ETHER,	"ether host " },
+	{ "eth.src",		PCAP_FIELD_ETHER,	"ether src " },
+	{ "eth.dst",		PCAP_FIELD_ETHER,	"ether dst " },
+	{ "tcp.port",		PCAP_FIELD_PORT,	"tcp port " },
+	{ "tcp.srcport",	PCAP_FIELD_PORT,	"tcp src port " },
+	{ "tcp.dstport",	PCAP_FIELD_PORT,	"tcp dst port " },
+	{ "udp.port",		PCAP_FIELD_PORT,	"udp port " },
+	{ "udp.srcport",	PCAP_FIELD_PORT,	"udp src port " },
+	{ "udp.dstport",	PCAP_FIELD_PORT,	"udp dst port " },
+	{ "sctp.port",		PCAP_FIELD_PORT,	"sctp port " },
+	{ "sctp.srcport",	PCAP_FIELD_PORT,	"sctp src port " },
+	{ "sctp.dstport",	PCAP_FIELD_PORT,	"sctp dst port " },
+};
+
+static const pcap_field_map_t *
+pcap_field_lookup(const header_field_info *hfinfo)
+{
+	size_t i;
+
+	for (i = 0; i < G_N_ELEMENTS(pcap_fields); i++) {
+		if (strcmp(pcap_fields[i].abbrev, hfinfo->abbrev) == 0)
+			return &pcap_fields[i];
+	}
+	return NULL;
+}
+
+/* The pcap name of a protocol the kernel can test for, or NULL. */
+static const char *
+proto_pcap_name(const header_field_info *hfinfo)
+{
+	if (hfinfo->type != FT_PROTOCOL)
+		return NULL;
+	if (strcmp(hfinfo->abbrev, "ip") == 0)
+		return "ip";
+	if (strcmp(hfinfo->abbrev, "ipv6") == 0)
+		return "ip6";
+	if (strcmp(hfinfo->abbrev, "tcp") == 0)
+		return "tcp";
+	if (strcmp(hfinfo->abbrev, "udp") == 0)
+		return "udp";
+	if (strcmp(hfinfo->abbrev, "sctp") == 0)
+		return "sctp";
+	if (strcmp(hfinfo->abbrev, "icmp") == 0)
+		return "icmp";
+	if (strcmp(hfinfo->abbrev, "icmpv6") == 0)
+		return "icmp6";
+	if (strcmp(hfinfo->abbrev, "arp") == 0)
+		return "arp";
+	if (strcmp(hfinfo->abbrev, "rarp") == 0)
+		return "rarp";
+	return NULL;
+}
+
+/* Translate a FIELD-relop-FVALUE comparison, appending to buf.
+ * Returns FALSE, leaving buf alone, if there's no translation.
+ * Sets *vlan_sensitive if the translation tests offsets that an
+ * 802.1Q tag would shift. */
+static gboolean
+translate_cmp(test_op_t op, stnode_t *arg1, stnode_t *arg2, GString *buf,
+    gboolean *vlan_sensitive)
+{
+	header_field_info	*hfinfo;
+	const pcap_field_map_t	*map;
+	fvalue_t		*fv;
+	char			*repr;
+
+	if (stnode_type_id(arg1) != STTYPE_FIELD ||
+	    stnode_type_id(arg2) != STTYPE_FVALUE)
+		return FALSE;
+
+	hfinfo = (header_field_info *)stnode_data(arg1);
+	fv = (fvalue_t *)stnode_data(arg2);
+
+	if (strcmp(hfinfo->abbrev, "frame.len") == 0) {
+		const char *relop;
+
+		switch (op) {
+			case TEST_OP_EQ:	relop = "==";	break;
+			case TEST_OP_NE:	relop = "!=";	break;
+			case TEST_OP_GT:	relop = ">";	break;
+			case TEST_OP_GE:	relop = ">=";	break;
+			case TEST_OP_LT:	relop = "<";	break;
+			case TEST_OP_LE:	relop = "<=";	break;
+			default:
+				return FALSE;
+		}
+		g_string_append_printf(buf, "len %s %u",
+		    relop, fvalue_get_uinteger(fv));
+		return TRUE;
+	}
+
+	/* Everything else only translates for equality; "!=" would need
+	 * a negation, and negated supersets aren't supersets. */
+	if (op != TEST_OP_EQ)
+		return FALSE;
+
+	map = pcap_field_lookup(hfinfo);
+	if (map == NULL)
+		return FALSE;
+
+	switch (map->kind) {
+
+	case PCAP_FIELD_HOST:
+		repr = fvalue_to_string_repr(NULL, fv, FTREPR_DISPLAY, BASE_NONE);
+		if (repr == NULL)
+			return FALSE;
+		/* An address with a prefix length is a net, not a host. */
+		g_string_append_printf(buf, "%s%s %s",
+		    map->prefix, strchr(repr, '/') ? "net" : "host", repr);
+		wmem_free(NULL, repr);
+		*vlan_sensitive = TRUE;
+		return TRUE;
+
+	case PCAP_FIELD_ETHER:
+		/* MAC addresses precede any VLAN tag, so no
+		 * vlan-qualified alternative is needed. */
+		repr = fvalue_to_string_repr(NULL, fv, FTREPR_DISPLAY, BASE_NONE);
+		if (repr == NULL)
+			return FALSE;
+		g_string_append_printf(buf, "%s%s", map->prefix, repr);
+		wmem_free(NULL, repr);
+		return TRUE;
+
+	case PCAP_FIELD_PORT:
+		g_string_append_printf(buf, "%s%u",
+		    map->prefix, fvalue_get_uinteger(fv));
+		*vlan_sensitive = TRUE;
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+static gboolean
+translate_test(stnode_t *node, GString *buf, gboolean *vlan_sensitive)
+{
+	test_op_t	 op;
+	stnode_t	*arg1;
+	stnode_t	*arg2;
+	GString		*left, *right;
+	gboolean	 lok, rok, ok;
+
+	if (stnode_type_id(node) != STTYPE_TEST)
+		return FALSE;
+
+	sttype_test_get(node, &op, &arg1, &arg2);
+
+	switch (op) {
+
+	case TEST_OP_EXISTS:
+	{
+		const char *name;
+
+		if (stnode_type_id(arg1) != STTYPE_FIELD)
+			return FALSE;
+		name = proto_pcap_name((header_field_info *)stnode_data(arg1));
+		if (name == NULL)
+			return FALSE;
+		g_string_append(buf, name);
+		/* These all test the EtherType or the IP protocol
+		 * field, both of which a VLAN tag shifts. */
+		*vlan_sensitive = TRUE;
+		return TRUE;
+	}
+
+	case TEST_OP_AND:
+		left = g_string_new(NULL);
+		right = g_string_new(NULL);
+		lok = translate_test(arg1, left, vlan_sensitive);
+		rok = translate_test(arg2, right, vlan_sensitive);
+		if (lok && rok)
+			g_string_append_printf(buf, "(%s) and (%s)",
+			    left->str, right->str);
+		else if (lok) {
+			/* The untranslatable conjunct is dropped; the
+			 * display filter still enforces it. */
+			g_string_append(buf, left->str);
+		}
+		else if (rok)
+			g_string_append(buf, right->str);
+		ok = lok || rok;
+		g_string_free(left, TRUE);
+		g_string_free(right, TRUE);
+		return ok;
+
+	case TEST_OP_OR:
+		left = g_string_new(NULL);
+		right = g_string_new(NULL);
+		lok = translate_test(arg1, left, vlan_sensitive);
+		rok = translate_test(arg2, right, vlan_sensitive);
+		if (lok && rok)
+			g_string_append_printf(buf, "(%s) or (%s)",
+			    left->str, right->str);
+		ok = lok && rok;
+		g_string_free(left, TRUE);
+		g_string_free(right, TRUE);
+		return ok;
+
+	case TEST_OP_EQ:
+	case TEST_OP_NE:
+	case TEST_OP_GT:
+	case TEST_OP_GE:
+	case TEST_OP_LT:
+	case TEST_OP_LE:
+		return translate_cmp(op, arg1, arg2, buf, vlan_sensitive);
+
+	default:
+		/* TEST_OP_NOT in particular: negating a superset can
+		 * exclude packets the display filter matches. */
+		return FALSE;
+	}
+}
+
+gchar *
+dfilter_translate_to_pcap(stnode_t *st_root)
+{
+	GString *buf;
+	gboolean vlan_sensitive = FALSE;
+
+	if (st_root == NULL)
+		return NULL;
+
+	buf = g_string_new(NULL);
+	if (!translate_test(st_root, buf, &vlan_sensitive)) {
+		g_string_free(buf, TRUE);
+		return NULL;
+	}
+	if (vlan_sensitive) {
+		/* Repeat the expression behind pcap's "vlan" keyword,
+		 * which shifts the offsets of the primitives following
+		 * it, so frames with one 802.1Q tag still match. */
+		gchar *plain = g_string_free(buf, FALSE);
+		gchar *qualified = g_strdup_printf("(%s) or (vlan and (%s))",
+		    plain, plain);
+
+		g_free(plain);
+		return qualified;
+	}
+	return g_string_free(buf, FALSE);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -16,8 +16,10 @@
 #include "syntax-tree.h"
 #include "gencode.h"
 #include "semcheck.h"
+#include "sttype-test.h"
 #include "dfvm.h"
 #include <epan/epan_dissect.h>
+#include <epan/frame_data.h>
 #include "dfilter.h"
 #include "dfilter-macro.h"
 #include "scanner_lex.h"
@@ -30,6 +32,26 @@
 /* Holds the singular instance of our Lemon parser object */
 static void*	ParserObj = NULL;
 
+/*
+ * Compile cache, mapping macro-expanded filter text to the live dfilter_t
+ * compiled from it.  The same expression is routinely compiled many times
+ * over - coloring rules, tap filters and the filter bar all compile
+ * independently - so dfilter_compile() hands out another reference to the
+ * cached program instead of running the scanner, parser, semantic check
+ * and code generator again.
+ *
+ * The cache doesn't hold references of its own: an entry lives exactly as
+ * long as its dfilter_t, and dfilter_free() drops the entry when the last
+ * reference goes away.  The whole cache is torn down in dfilter_cleanup(),
+ * alongside the field registry the cached programs' bytecode points into.
+ *
+ * Sharing a program is safe because a compiled filter is immutable apart
+ * from the register scratch space, which is only used for the duration of
+ * a dfvm_apply() call, and filters are compiled and applied from a single
+ * thread.
+ */
+static GHashTable *dfilter_cache = NULL;
+
 /*
  * XXX - if we're using a version of Flex that supports reentrant lexical
  * analyzers, we should put this into the lexical analyzer's state.
@@ -74,6 +96,9 @@ dfilter_init(void)
 	sttype_init();
 
 	dfilter_macro_init();
+
+	/* Keys and values are owned by the dfilter_t's themselves. */
+	dfilter_cache = g_hash_table_new(g_str_hash, g_str_equal);
 }
 
 /* Clean-up the dfilter module */
@@ -89,6 +114,193 @@ dfilter_cleanup(void)
 
 	/* Clean up the syntax-tree sub-sub-system */
 	sttype_cleanup();
+
+	/* Outstanding dfilter_t's remain valid until their last
+	 * dfilter_free(); they just can't be shared any more. */
+	if (dfilter_cache) {
+		g_hash_table_destroy(dfilter_cache);
+		dfilter_cache = NULL;
+	}
+}
+
+/*
+ * Metadata-only prefix of a filter.
+ *
+ * Conjuncts at the top of the filter's AND chain that compare a frame
+ * metadata field against a constant can be decided from frame_data
+ * alone, before any dissection.  We pull them out at compile time into
+ * an array of simple predicates; dfilter_check_frame_prefix() then
+ * lets callers rule a frame out without reading or dissecting it.
+ * Only top-level conjuncts are safe to extract: underneath an OR or a
+ * NOT, a false conjunct no longer implies the whole filter is false.
+ */
+
+enum {
+	DF_FRAME_META_NUMBER,	/* frame_data.num */
+	DF_FRAME_META_LEN,	/* frame_data.pkt_len */
+	DF_FRAME_META_CAP_LEN,	/* frame_data.cap_len */
+	DF_FRAME_META_TIME	/* frame_data.abs_ts */
+};
+
+typedef struct {
+	int		field;	/* DF_FRAME_META_* */
+	test_op_t	op;	/* EQ/NE/GT/GE/LT/LE */
+	guint32		num;	/* operand for the numeric fields */
+	nstime_t	time;	/* operand for DF_FRAME_META_TIME */
+} df_frame_pred_t;
+
+/* Map a field to the frame metadata it reads, or -1 if it isn't
+ * available without dissection. */
+static int
+frame_meta_field(const header_field_info *hfinfo)
+{
+	if (strcmp(hfinfo->abbrev, "frame.number") == 0)
+		return DF_FRAME_META_NUMBER;
+	if (strcmp(hfinfo->abbrev, "frame.len") == 0)
+		return DF_FRAME_META_LEN;
+	if (strcmp(hfinfo->abbrev, "frame.cap_len") == 0)
+		return DF_FRAME_META_CAP_LEN;
+	if (strcmp(hfinfo->abbrev, "frame.time") == 0 ||
+	    strcmp(hfinfo->abbrev, "frame.time_epoch") == 0)
+		return DF_FRAME_META_TIME;
+	return -1;
+}
+
+/* If st_node is "metadata field <relation> constant", append the
+ * equivalent frame_data predicate and return TRUE.  The constant is
+ * copied out of the tree; gencode steals the fvalue later. */
+static gboolean
+frame_pred_from_test(stnode_t *st_node, GArray *preds)
+{
+	test_op_t		op;
+	stnode_t		*st_arg1, *st_arg2;
+	header_field_info	*hfinfo;
+	fvalue_t		*fv;
+	df_frame_pred_t		pred;
+
+	sttype_test_get(st_node, &op, &st_arg1, &st_arg2);
+
+	switch (op) {
+		case TEST_OP_EQ:
+		case TEST_OP_NE:
+		case TEST_OP_GT:
+		case TEST_OP_GE:
+		case TEST_OP_LT:
+		case TEST_OP_LE:
+			break;
+		default:
+			return FALSE;
+	}
+
+	if (st_arg1 == NULL || st_arg2 == NULL)
+		return FALSE;
+	if (stnode_type_id(st_arg1) != STTYPE_FIELD ||
+	    stnode_type_id(st_arg2) != STTYPE_FVALUE)
+		return FALSE;
+
+	hfinfo = (header_field_info *)stnode_data(st_arg1);
+	pred.field = frame_meta_field(hfinfo);
+	if (pred.field < 0)
+		return FALSE;
+
+	pred.op = op;
+	fv = (fvalue_t *)stnode_data(st_arg2);
+	if (pred.field == DF_FRAME_META_TIME)
+		pred.time = *(const nstime_t *)fvalue_get(fv);
+	else
+		pred.num = fvalue_get_uinteger(fv);
+
+	g_array_append_val(preds, pred);
+	return TRUE;
+}
+
+/* Collect metadata-only conjuncts from the top of the AND chain. */
+static void
+frame_preds_collect(stnode_t *st_node, GArray *preds)
+{
+	test_op_t	op;
+	stnode_t	*st_arg1, *st_arg2;
+
+	if (stnode_type_id(st_node) != STTYPE_TEST)
+		return;
+	sttype_test_get(st_node, &op, &st_arg1, &st_arg2);
+	if (op == TEST_OP_AND) {
+		frame_preds_collect(st_arg1, preds);
+		frame_preds_collect(st_arg2, preds);
+		return;
+	}
+	frame_pred_from_test(st_node, preds);
+}
+
+static gboolean
+frame_pred_check(const df_frame_pred_t *pred, const frame_data *fd)
+{
+	int	cmp;
+	guint32	val;
+
+	switch (pred->field) {
+		case DF_FRAME_META_NUMBER:
+			val = fd->num;
+			cmp = (val > pred->num) - (val < pred->num);
+			break;
+		case DF_FRAME_META_LEN:
+			val = fd->pkt_len;
+			cmp = (val > pred->num) - (val < pred->num);
+			break;
+		case DF_FRAME_META_CAP_LEN:
+			val = fd->cap_len;
+			cmp = (val > pred->num) - (val < pred->num);
+			break;
+		case DF_FRAME_META_TIME:
+			cmp = nstime_cmp(&fd->abs_ts, &pred->time);
+			break;
+		default:
+			return TRUE;
+	}
+
+	switch (pred->op) {
+		case TEST_OP_EQ:
+			return cmp == 0;
+		case TEST_OP_NE:
+			return cmp != 0;
+		case TEST_OP_GT:
+			return cmp > 0;
+		case TEST_OP_GE:
+			return cmp >= 0;
+		case TEST_OP_LT:
+			return cmp < 0;
+		case TEST_OP_LE:
+			return cmp <= 0;
+		default:
+			return TRUE;
+	}
+}
+
+gboolean
+dfilter_has_frame_prefix(const dfilter_t *df)
+{
+	return df->frame_preds != NULL;
+}
+
+gboolean
+dfilter_check_frame_prefix(const dfilter_t *df, const frame_data *fd)
+{
+	guint i;
+
+	if (df->frame_preds == NULL)
+		return TRUE;
+	for (i = 0; i < df->frame_preds->len; i++) {
+		if (!frame_pred_check(&g_array_index(df->frame_preds,
+		    df_frame_pred_t, i), fd))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+const gchar *
+dfilter_pcap_text(const dfilter_t *df)
+{
+	return df->pcap_text;
 }
 
 static dfilter_t*
@@ -126,12 +338,24 @@ dfilter_free(dfilter_t *df)
 	if (!df)
 		return;
 
+	ws_assert(df->ref_count > 0);
+	if (--df->ref_count > 0)
+		return;
+
+	if (dfilter_cache && df->expanded_text)
+		g_hash_table_remove(dfilter_cache, df->expanded_text);
+
 	if (df->insns) {
 		free_insns(df->insns);
 	}
 	if (df->consts) {
 		free_insns(df->consts);
 	}
+	if (df->frame_preds) {
+		g_array_free(df->frame_preds, TRUE);
+	}
+
+	g_free(df->pcap_text);
 
 	g_free(df->interesting_fields);
 
@@ -152,6 +376,7 @@ dfilter_free(dfilter_t *df)
 	g_free(df->registers);
 	g_free(df->attempted_load);
 	g_free(df->owns_memory);
+	g_free(df->expanded_text);
 	g_free(df);
 }
 
@@ -212,6 +437,8 @@ dfilter_compile(const gchar *text, dfilter_t **dfp, gchar **err_msg)
 	guint		i;
 	/* XXX, GHashTable */
 	GPtrArray	*deprecated;
+	GArray		*frame_preds;
+	gchar		*pcap_text;
 
 	ws_assert(dfp);
 
@@ -227,6 +454,20 @@ dfilter_compile(const gchar *text, dfilter_t **dfp, gchar **err_msg)
 		return FALSE;
 	}
 
+	/* Hand out another reference if we've already compiled this
+	 * expression.  Keying on the expanded text keeps the cache
+	 * correct across display filter macro redefinitions. */
+	if (dfilter_cache) {
+		dfilter = (dfilter_t *)g_hash_table_lookup(dfilter_cache,
+		    expanded_text);
+		if (dfilter) {
+			dfilter->ref_count++;
+			*dfp = dfilter;
+			wmem_free(NULL, expanded_text);
+			return TRUE;
+		}
+	}
+
 	if (df_lex_init(&scanner) != 0) {
 		wmem_free(NULL, expanded_text);
 		*dfp = NULL;
@@ -337,6 +578,15 @@ dfilter_compile(const gchar *text, dfilter_t **dfp, gchar **err_msg)
 			goto FAILURE;
 		}
 
+		/* Pull the metadata-only prefix out of the checked tree
+		 * before generating code; gencode steals the constants. */
+		frame_preds = g_array_new(FALSE, FALSE, sizeof(df_frame_pred_t));
+		frame_preds_collect(dfw->st_root, frame_preds);
+
+		/* Likewise derive capture filter text for the kernel-
+		 * evaluable part of the filter, if there is one. */
+		pcap_text = dfilter_translate_to_pcap(dfw->st_root);
+
 		/* Create bytecode */
 		dfw_gencode(dfw);
 
@@ -362,6 +612,24 @@ dfilter_compile(const gchar *text, dfilter_t **dfp, gchar **err_msg)
 		/* Add any deprecated items */
 		dfilter->deprecated = deprecated;
 
+		/* Keep the metadata-only prefix, if we found one */
+		if (frame_preds->len > 0) {
+			dfilter->frame_preds = frame_preds;
+		} else {
+			g_array_free(frame_preds, TRUE);
+		}
+
+		dfilter->pcap_text = pcap_text;
+
+		/* Cache the program for the next compile of the same
+		 * expression; dfilter_free() drops the entry when the
+		 * last reference is released. */
+		dfilter->ref_count = 1;
+		dfilter->expanded_text = g_strdup(expanded_text);
+		if (dfilter_cache)
+			g_hash_table_insert(dfilter_cache,
+			    dfilter->expanded_text, dfilter);
+
 		/* And give it to the user. */
 		*dfp = dfilter;
 	}
@@ -430,6 +698,13 @@ dfilter_has_interesting_fields(const dfilter_t *df)
 	return (df->num_interesting_fields > 0);
 }
 
+int
+dfilter_interesting_fields(const dfilter_t *df, const int **fields)
+{
+	*fields = df->interesting_fields;
+	return df->num_interesting_fields;
+}
+
 GPtrArray *
 dfilter_deprecated_tokens(dfilter_t *df) {
 	if (df->deprecated && df->deprecated->len > 0) {
@@ -22,6 +22,7 @@ extern "C" {
 #endif /* __cplusplus */
 
 struct epan_dissect;
+struct _frame_data;
 
 /* Module-level initialization */
 void
@@ -64,7 +65,30 @@ dfilter_apply_edt(dfilter_t *df, struct epan_dissect *edt);
 gboolean
 dfilter_apply(dfilter_t *df, proto_tree *tree);
 
-/* Prime a proto_tree using the fields/protocols used in a dfilter. */
+/* TRUE if the filter has a metadata-only prefix that can be checked
+ * against frame_data before dissection. */
+WS_DLL_PUBLIC
+gboolean
+dfilter_has_frame_prefix(const dfilter_t *df);
+
+/* Evaluate the filter's metadata-only prefix against a frame's
+ * metadata.  FALSE means the frame cannot possibly pass the filter;
+ * TRUE means the full filter still has to be run after dissection. */
+WS_DLL_PUBLIC
+gboolean
+dfilter_check_frame_prefix(const dfilter_t *df, const struct _frame_data *fd);
+
+/* Capture (pcap) filter text matching a superset of the packets the
+ * display filter matches, for installation as a kernel filter during
+ * live capture, or NULL if no part of the filter translates.  The
+ * string is owned by the filter.  Offset-sensitive primitives are
+ * repeated behind pcap's "vlan" keyword so singly-802.1Q-tagged frames
+ * still match, but pcap primitives only look at the outermost headers,
+ * so the translation won't match QinQ or otherwise tunnelled traffic,
+ * or non-first IP fragments, that the display filter would. */
+WS_DLL_PUBLIC
+const gchar *
+dfilter_pcap_text(const dfilter_t *df);
 void
 dfilter_prime_proto_tree(const dfilter_t *df, proto_tree *tree);
 
@@ -72,6 +96,12 @@ dfilter_prime_proto_tree(const dfilter_t *df, proto_tree *tree);
 gboolean
 dfilter_has_interesting_fields(const dfilter_t *df);
 
+/* Return the number of fields/protocols the compiled filter reads and
+ * point *fields at the array of their hfids. The array is owned by the
+ * filter and stays valid until it is freed. */
+int
+dfilter_interesting_fields(const dfilter_t *df, const int **fields);
+
 WS_DLL_PUBLIC
 GPtrArray *
 dfilter_deprecated_tokens(dfilter_t *df);
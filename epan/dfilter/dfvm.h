@@ -10,6 +10,7 @@
 #define DFVM_H
 
 #include <epan/proto.h>
+#include <wsutil/ws_mempbrk.h>
 #include "dfilter-int.h"
 #include "syntax-tree.h"
 #include "drange.h"
@@ -24,9 +25,30 @@ typedef enum {
 	INTEGER,
 	DRANGE,
 	FUNCTION_DEF,
-	PCRE
+	PCRE,
+	HASH_SET
 } dfvm_value_type_t;
 
+/* A compiled "matches" pattern: the regex itself plus, when one could
+ * be extracted from the pattern, a literal substring that must occur in
+ * any matching value.  The literal is scanned for before the regex
+ * engine is invoked, which rejects most non-matching values at memory
+ * bandwidth instead of regex speed.  The literal is stored lowercased
+ * (patterns are compiled with G_REGEX_CASELESS) and first_chars holds
+ * both cases of its first byte for the vectorized scan. */
+typedef struct {
+	GRegex			*re;
+	gchar			*literal;	/* NULL if none extracted */
+	gsize			literal_len;
+	ws_mempbrk_pattern	first_chars;
+} dfvm_pcre_t;
+
+dfvm_pcre_t*
+dfvm_pcre_new(GRegex *re);
+
+void
+dfvm_pcre_free(dfvm_pcre_t *pcre);
+
 typedef struct {
 	dfvm_value_type_t	type;
 
@@ -36,7 +58,8 @@ typedef struct {
 		drange_t		*drange;
 		header_field_info	*hfinfo;
 		df_func_def_t		*funcdef;
-		GRegex			*pcre;
+		dfvm_pcre_t		*pcre;
+		GHashTable		*hash_set;
 	} value;
 
 } dfvm_value_t;
@@ -63,7 +86,8 @@ typedef enum {
 	ANY_MATCHES,
 	MK_RANGE,
 	CALL_FUNCTION,
-	ANY_IN_RANGE
+	ANY_IN_RANGE,
+	ANY_IN_HASH_SET
 
 } dfvm_opcode_t;
 
@@ -85,6 +109,16 @@ dfvm_insn_free(dfvm_insn_t *insn);
 dfvm_value_t*
 dfvm_value_new(dfvm_value_type_t type);
 
+/* Can this value be used as a member of a hashed membership set, i.e.
+ * is its equality fully captured by the 64-bit key below? */
+gboolean
+dfvm_fvalue_hashable(fvalue_t *fv);
+
+/* The value widened to 64 bits, for use as a hashed-set key.
+ * Only valid if dfvm_fvalue_hashable() returned TRUE. */
+guint64
+dfvm_fvalue_hash_key(fvalue_t *fv);
+
 void
 dfvm_dump(FILE *f, dfilter_t *df);
 
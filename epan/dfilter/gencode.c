@@ -17,6 +17,7 @@
 #include "sttype-set.h"
 #include "sttype-function.h"
 #include "ftypes/ftypes.h"
+#include <wsutil/glib-compat.h>
 #include <wsutil/ws_assert.h>
 
 static void
@@ -242,7 +243,7 @@ dfw_append_put_pcre(dfwork_t *dfw, GRegex *pcre)
 
 	insn = dfvm_insn_new(PUT_PCRE);
 	val1 = dfvm_value_new(PCRE);
-	val1->value.pcre = pcre;
+	val1->value.pcre = dfvm_pcre_new(pcre);
 	val2 = dfvm_value_new(REGISTER);
 	reg = dfw->first_constant--;
 	val2->value.numeric = reg;
@@ -309,8 +310,26 @@ fixup_jumps(gpointer data, gpointer user_data)
 	}
 }
 
+/* A set with at least this many hashable constant members is compiled
+ * into a hashed set probed by a single ANY_IN_HASH_SET instruction;
+ * below it, a short chain of equality tests is cheaper than a table. */
+#define HASH_SET_THRESHOLD	16
+
+/* Is this set element a constant that can be a hashed-set member?
+ * Range elements and non-integer types keep their per-member tests. */
+static gboolean
+set_element_hashable(stnode_t *node1, stnode_t *node2)
+{
+	return node2 == NULL &&
+		stnode_type_id(node1) == STTYPE_FVALUE &&
+		dfvm_fvalue_hashable((fvalue_t *)stnode_data(node1));
+}
+
 /* Generate the code for the in operator.  It behaves much like an OR-ed
- * series of == tests, but without the redundant existence checks. */
+ * series of == tests, but without the redundant existence checks.  Large
+ * sets of integer-like constants are collapsed into a hash table tested
+ * with a single probe per field value; range elements and members of
+ * other types are still tested one at a time. */
 static void
 gen_relation_in(dfwork_t *dfw, stnode_t *st_arg1, stnode_t *st_arg2)
 {
@@ -319,14 +338,77 @@ gen_relation_in(dfwork_t *dfw, stnode_t *st_arg1, stnode_t *st_arg2)
 	dfvm_value_t	*jmp1 = NULL, *jmp2 = NULL, *jmp3 = NULL;
 	int		reg1;
 	stnode_t	*node1, *node2;
-	GSList		*nodelist_head, *nodelist;
+	GSList		*nodelist_head, *nodelist, *chainlist = NULL;
 	GSList		*jumplist = NULL;
+	GHashTable	*hash_set = NULL;
+	guint		n_hashable = 0;
 
 	/* Create code for the LHS of the relation */
 	reg1 = gen_entity(dfw, st_arg1, &jmp1);
 
-	/* Create code for the set on the RHS of the relation */
 	nodelist_head = nodelist = (GSList*)stnode_steal_data(st_arg2);
+
+	/* Count the elements eligible for the hashed set. */
+	while (nodelist) {
+		node1 = (stnode_t*)nodelist->data;
+		nodelist = g_slist_next(nodelist);
+		node2 = (stnode_t*)nodelist->data;
+		nodelist = g_slist_next(nodelist);
+
+		if (set_element_hashable(node1, node2)) {
+			n_hashable++;
+		}
+	}
+
+	if (n_hashable >= HASH_SET_THRESHOLD) {
+		hash_set = g_hash_table_new_full(g_int64_hash, g_int64_equal,
+				g_free, NULL);
+	}
+
+	/* Partition the set: hashable constants go into the table, the
+	 * rest is kept (in element pairs) for the test chain below. */
+	nodelist = nodelist_head;
+	while (nodelist) {
+		node1 = (stnode_t*)nodelist->data;
+		nodelist = g_slist_next(nodelist);
+		node2 = (stnode_t*)nodelist->data;
+		nodelist = g_slist_next(nodelist);
+
+		if (hash_set && set_element_hashable(node1, node2)) {
+			guint64 key;
+
+			key = dfvm_fvalue_hash_key((fvalue_t *)stnode_data(node1));
+			g_hash_table_add(hash_set, g_memdup2(&key, sizeof key));
+		}
+		else {
+			chainlist = g_slist_prepend(chainlist, node2);
+			chainlist = g_slist_prepend(chainlist, node1);
+		}
+	}
+
+	if (hash_set) {
+		/* One probe covers all the hashed members. */
+		insn = dfvm_insn_new(ANY_IN_HASH_SET);
+		val1 = dfvm_value_new(REGISTER);
+		val1->value.numeric = reg1;
+		val2 = dfvm_value_new(HASH_SET);
+		val2->value.hash_set = hash_set;
+		insn->arg1 = val1;
+		insn->arg2 = val2;
+		dfw_append_insn(dfw, insn);
+
+		/* Exit as soon as we find a match */
+		if (chainlist) {
+			insn = dfvm_insn_new(IF_TRUE_GOTO);
+			val1 = dfvm_value_new(INSN_NUMBER);
+			insn->arg1 = val1;
+			dfw_append_insn(dfw, insn);
+			jumplist = g_slist_prepend(jumplist, val1);
+		}
+	}
+
+	/* Create code for the remaining elements of the set */
+	nodelist = chainlist;
 	while (nodelist) {
 		node1 = (stnode_t*)nodelist->data;
 		nodelist = g_slist_next(nodelist);
@@ -391,6 +473,7 @@ gen_relation_in(dfwork_t *dfw, stnode_t *st_arg1, stnode_t *st_arg2)
 
 	/* Clean up */
 	g_slist_free(jumplist);
+	g_slist_free(chainlist);
 	set_nodelist_free(nodelist_head);
 }
 
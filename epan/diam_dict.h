@@ -71,4 +71,9 @@ extern void ddict_print(FILE* fh, ddict_t* d);
 extern ddict_t* ddict_scan(const char* directory, const char* filename, int dbg);
 extern void ddict_free(ddict_t* d);
 
+/* Binary dictionary cache (see epan/dict_cache.h); returns NULL if no
+   valid cache exists for the directory. */
+extern ddict_t* ddict_cache_load(const char* system_directory);
+extern void ddict_cache_save(const char* system_directory, ddict_t* d);
+
 #endif
@@ -0,0 +1,205 @@
+/* dict_cache.c
+ * Binary cache files for dissector dictionaries parsed at startup
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+#define WS_LOG_DOMAIN LOG_DOMAIN_EPAN
+
+#include <string.h>
+#include <stdio.h>
+
+#include <glib.h>
+
+#include <wsutil/file_util.h>
+#include <wsutil/filesystem.h>
+#include <wsutil/wslog.h>
+
+#include "dict_cache.h"
+
+#define DICT_CACHE_MAGIC	0x57534443	/* "WSDC" */
+
+/*
+ * The cache file is a fixed header followed by the caller's payload:
+ *
+ *	guint32 magic
+ *	guint16 format version (caller-defined)
+ *	guint64 dictionary directory fingerprint
+ *	guint32 payload length
+ *	payload
+ *
+ * All header fields are host-endian; a cache file is private to the
+ * machine that wrote it.
+ */
+typedef struct {
+	guint32 magic;
+	guint16 fmt_version;
+	guint64 fingerprint;
+	guint32 payload_len;
+} dict_cache_header_t;
+
+/*
+ * The cache file's name encodes the dictionary directory, so several
+ * directories (e.g. the system and personal RADIUS dictionaries) get
+ * independent caches.
+ */
+static char *
+dict_cache_path(const char *tag, const char *dict_dir)
+{
+	char *fname, *path;
+
+	fname = g_strdup_printf("%s-%08x.cache", tag, g_str_hash(dict_dir));
+	path = get_persconffile_path(fname, FALSE);
+	g_free(fname);
+	return path;
+}
+
+/*
+ * Fingerprint a dictionary directory: fold the name, size and mtime of
+ * every regular file in it into one value.  Summing the per-file values
+ * makes the result independent of readdir order.
+ */
+static guint64
+dict_cache_fingerprint(const char *dict_dir)
+{
+	GDir	    *dir;
+	const gchar *name;
+	guint64	     fp = 1;
+
+	dir = ws_dir_open(dict_dir, 0, NULL);
+	if (dir == NULL)
+		return 0;
+
+	while ((name = ws_dir_read_name(dir)) != NULL) {
+		gchar	   *fname;
+		ws_statb64  statb;
+
+		fname = g_strdup_printf("%s" G_DIR_SEPARATOR_S "%s",
+		    dict_dir, name);
+		if (ws_stat64(fname, &statb) == 0 &&
+		    S_ISREG(statb.st_mode)) {
+			guint64 entry;
+
+			entry = (guint64)g_str_hash(name);
+			entry = entry * 31 + (guint64)statb.st_size;
+			entry = entry * 31 + (guint64)statb.st_mtime;
+			fp += entry;
+		}
+		g_free(fname);
+	}
+	ws_dir_close(dir);
+
+	return fp;
+}
+
+guint8 *
+dict_cache_load(const char *tag, guint16 fmt_version, const char *dict_dir,
+    gsize *len_p)
+{
+	char		   *path;
+	FILE		   *fh;
+	dict_cache_header_t hdr;
+	guint64		    fp;
+	guint8		   *payload = NULL;
+
+	*len_p = 0;
+
+	fp = dict_cache_fingerprint(dict_dir);
+	if (fp == 0)
+		return NULL;
+
+	path = dict_cache_path(tag, dict_dir);
+	fh = ws_fopen(path, "rb");
+	if (fh == NULL) {
+		g_free(path);
+		return NULL;
+	}
+
+	if (fread(&hdr, sizeof hdr, 1, fh) == 1 &&
+	    hdr.magic == DICT_CACHE_MAGIC &&
+	    hdr.fmt_version == fmt_version &&
+	    hdr.fingerprint == fp &&
+	    hdr.payload_len > 0) {
+		payload = (guint8 *)g_malloc(hdr.payload_len);
+		if (fread(payload, hdr.payload_len, 1, fh) == 1) {
+			*len_p = hdr.payload_len;
+		} else {
+			g_free(payload);
+			payload = NULL;
+		}
+	}
+	fclose(fh);
+
+	if (payload == NULL) {
+		/* Stale, truncated or from another format version; the
+		   caller will re-parse and rewrite it. */
+		ws_debug("Dictionary cache \"%s\" is stale or invalid; removing it",
+		    path);
+		ws_unlink(path);
+	}
+	g_free(path);
+	return payload;
+}
+
+void
+dict_cache_save(const char *tag, guint16 fmt_version, const char *dict_dir,
+    const guint8 *data, gsize len)
+{
+	char		   *path, *pf_dir_path = NULL;
+	FILE		   *fh;
+	dict_cache_header_t hdr;
+
+	if (len == 0 || len > G_MAXUINT32)
+		return;
+
+	hdr.magic = DICT_CACHE_MAGIC;
+	hdr.fmt_version = fmt_version;
+	hdr.fingerprint = dict_cache_fingerprint(dict_dir);
+	hdr.payload_len = (guint32)len;
+	if (hdr.fingerprint == 0)
+		return;
+
+	if (create_persconffile_dir(&pf_dir_path) == -1) {
+		ws_debug("Can't create directory \"%s\" for dictionary caches",
+		    pf_dir_path);
+		g_free(pf_dir_path);
+		return;
+	}
+
+	path = dict_cache_path(tag, dict_dir);
+	fh = ws_fopen(path, "wb");
+	if (fh == NULL) {
+		ws_debug("Can't write dictionary cache \"%s\"", path);
+		g_free(path);
+		return;
+	}
+
+	if (fwrite(&hdr, sizeof hdr, 1, fh) != 1 ||
+	    fwrite(data, len, 1, fh) != 1) {
+		/* A truncated cache would be rejected on load anyway, but
+		   don't leave it around. */
+		fclose(fh);
+		ws_unlink(path);
+	} else {
+		fclose(fh);
+	}
+	g_free(path);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -0,0 +1,58 @@
+/* dict_cache.h
+ * Binary cache files for dissector dictionaries parsed at startup
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __DICT_CACHE_H__
+#define __DICT_CACHE_H__
+
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Some dissectors (RADIUS, Diameter) parse large text or XML dictionary
+ * directories at startup, costing hundreds of milliseconds in every
+ * process - including every tshark invocation of a batch job.  These
+ * routines maintain per-user binary cache files for such dictionaries:
+ * the dissector serializes its parsed form once, and later processes
+ * load the flat records instead of re-running the parser.
+ *
+ * A cache file is keyed by the dictionary directory's path and
+ * fingerprinted with the names, sizes and modification times of the
+ * files in it, so editing (or adding/removing) any dictionary file
+ * invalidates the cache and the next startup re-parses and rewrites it.
+ * Cache files live in the personal configuration directory; failure to
+ * write one is never an error, just a missed speedup.
+ */
+
+/**
+ * Load the cache payload for a dictionary directory, if a valid one
+ * exists.  "tag" names the dictionary (it becomes part of the cache
+ * file's name) and "fmt_version" is the caller's record-format version;
+ * a cache with a different version or a stale fingerprint is ignored
+ * and deleted.  Returns the payload (g_free() it) or NULL.
+ */
+extern guint8 *dict_cache_load(const char *tag, guint16 fmt_version,
+                               const char *dict_dir, gsize *len_p);
+
+/**
+ * Write the cache payload for a dictionary directory.  Failures are
+ * not fatal and are reported only in the debug log.
+ */
+extern void dict_cache_save(const char *tag, guint16 fmt_version,
+                            const char *dict_dir, const guint8 *data,
+                            gsize len);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __DICT_CACHE_H__ */
@@ -0,0 +1,160 @@
+/* dissector_stats.c
+ * Per-dissector call, time and allocation counters
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#ifdef HAVE_CLOCK_GETTIME
+#include <time.h>
+#endif
+
+#include <glib.h>
+
+#include <wsutil/wmem/wmem_core.h>
+
+#include "dissector_stats.h"
+
+/*
+ * Larger than PINFO_LAYER_MAX_RECURSION_DEPTH in packet.c, so in practice
+ * the bracketing stack never overflows; if it somehow does, the extra
+ * levels are still counted for balance but not attributed.
+ */
+#define STATS_MAX_DEPTH 600
+
+typedef struct {
+	guint64 start_nsecs;
+	guint64 start_bytes;
+	guint64 child_nsecs;
+	guint64 child_bytes;
+} stats_frame_t;
+
+static gboolean       collecting;
+static GHashTable    *stats_table;	/* GINT_TO_POINTER(proto_id) -> dissector_stat_t */
+static stats_frame_t  stats_stack[STATS_MAX_DEPTH];
+static guint          stats_depth;
+
+static guint64
+now_nsecs(void)
+{
+#ifdef HAVE_CLOCK_GETTIME
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+		return (guint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+	/* Microsecond granularity: coarse for a single dissector call but
+	   good enough in aggregate over a whole load. */
+	return (guint64)g_get_monotonic_time() * 1000;
+}
+
+void
+dissector_stats_set_enabled(gboolean enable)
+{
+	if (enable && stats_table == NULL) {
+		stats_table = g_hash_table_new_full(g_direct_hash,
+		    g_direct_equal, NULL, g_free);
+	}
+	collecting = enable;
+	wmem_track_allocations(enable);
+}
+
+gboolean
+dissector_stats_enabled(void)
+{
+	return collecting;
+}
+
+void
+dissector_stats_reset(void)
+{
+	if (stats_table)
+		g_hash_table_remove_all(stats_table);
+	stats_depth = 0;
+}
+
+GArray *
+dissector_stats_snapshot(void)
+{
+	GArray *stats = g_array_new(FALSE, FALSE, sizeof(dissector_stat_t));
+	GHashTableIter iter;
+	gpointer value;
+
+	if (stats_table) {
+		g_hash_table_iter_init(&iter, stats_table);
+		while (g_hash_table_iter_next(&iter, NULL, &value))
+			g_array_append_vals(stats, value, 1);
+	}
+	return stats;
+}
+
+void
+dissector_stats_enter(void)
+{
+	stats_frame_t *fr;
+
+	if (stats_depth < STATS_MAX_DEPTH) {
+		fr = &stats_stack[stats_depth];
+		fr->start_nsecs = now_nsecs();
+		fr->start_bytes = wmem_bytes_allocated();
+		fr->child_nsecs = 0;
+		fr->child_bytes = 0;
+	}
+	stats_depth++;
+}
+
+void
+dissector_stats_leave(int proto_id)
+{
+	stats_frame_t *fr;
+	dissector_stat_t *st;
+	guint64 total_nsecs, total_bytes;
+
+	if (stats_depth == 0)
+		return;		/* unbalanced; collection toggled mid-packet */
+	stats_depth--;
+	if (stats_depth >= STATS_MAX_DEPTH || stats_table == NULL)
+		return;
+
+	fr = &stats_stack[stats_depth];
+	total_nsecs = now_nsecs() - fr->start_nsecs;
+	total_bytes = wmem_bytes_allocated() - fr->start_bytes;
+
+	/* Whatever this call spent, the caller didn't spend itself. */
+	if (stats_depth > 0) {
+		stats_stack[stats_depth - 1].child_nsecs += total_nsecs;
+		stats_stack[stats_depth - 1].child_bytes += total_bytes;
+	}
+
+	st = (dissector_stat_t *)g_hash_table_lookup(stats_table,
+	    GINT_TO_POINTER(proto_id));
+	if (st == NULL) {
+		st = g_new0(dissector_stat_t, 1);
+		st->proto_id = proto_id;
+		g_hash_table_insert(stats_table, GINT_TO_POINTER(proto_id), st);
+	}
+
+	st->calls++;
+	st->total_nsecs += total_nsecs;
+	st->total_bytes += total_bytes;
+	st->self_nsecs += total_nsecs - fr->child_nsecs;
+	st->self_bytes += total_bytes - fr->child_bytes;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
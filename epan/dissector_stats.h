@@ -0,0 +1,85 @@
+/* dissector_stats.h
+ * Per-dissector call, time and allocation counters
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __DISSECTOR_STATS_H__
+#define __DISSECTOR_STATS_H__
+
+#include <glib.h>
+#include "ws_symbol_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * A lightweight profiler for the dissection engine. While collection is
+ * enabled, call_dissector_work() brackets every dissector call and
+ * accumulates, per protocol, the number of calls, the wall-clock time
+ * spent and the wmem bytes requested. "Self" figures exclude time and
+ * allocations attributed to subdissectors; "total" figures include them,
+ * so a protocol that appears inside itself (e.g. tunnels) is counted
+ * once per nesting level, as in a flame graph.
+ *
+ * Collection is off by default and costs nothing while off beyond one
+ * predictable branch per dissector call.
+ */
+
+typedef struct _dissector_stat_t {
+	int	proto_id;	/**< protocol the counters belong to (see proto_get_id()) */
+	guint64	calls;		/**< number of times the dissector was entered */
+	guint64	self_nsecs;	/**< nanoseconds spent in the dissector itself */
+	guint64	total_nsecs;	/**< nanoseconds including subdissectors */
+	guint64	self_bytes;	/**< wmem bytes requested by the dissector itself */
+	guint64	total_bytes;	/**< wmem bytes including subdissectors */
+} dissector_stat_t;
+
+/** Turn collection on or off. Enabling also enables wmem allocation
+ * tracking (see wmem_track_allocations()). Counters accumulated so far
+ * are kept; use dissector_stats_reset() to discard them.
+ */
+WS_DLL_PUBLIC void dissector_stats_set_enabled(gboolean enable);
+
+/** Is collection currently enabled? */
+WS_DLL_PUBLIC gboolean dissector_stats_enabled(void);
+
+/** Discard all accumulated counters. */
+WS_DLL_PUBLIC void dissector_stats_reset(void);
+
+/** Take a snapshot of the accumulated counters.
+ *
+ * @return An unsorted GArray of dissector_stat_t, one element per
+ * protocol seen so far. Free with g_array_free(stats, TRUE).
+ */
+WS_DLL_PUBLIC GArray *dissector_stats_snapshot(void);
+
+/* Bracketing entry points for call_dissector_work(). Every
+ * dissector_stats_enter() must be matched by a dissector_stats_leave(),
+ * including on the exception-unwind path. Not for use by dissectors. */
+extern void dissector_stats_enter(void);
+extern void dissector_stats_leave(int proto_id);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __DISSECTOR_STATS_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -714,6 +714,8 @@ proto_reg_handoff_bittorrent(void)
    dissector_add_uint_range_with_preference("tcp.port", DEFAULT_TCP_PORT_RANGE, dissector_handle);
 
    heur_dissector_add("tcp", test_bittorrent_packet, "BitTorrent over TCP", "bittorrent_tcp", proto_bittorrent, HEURISTIC_ENABLE);
+   /* test_bittorrent_packet() only accepts the protocol handshake. */
+   heur_dissector_add_signature("bittorrent_tcp", 0, (const guint8 *)"\x13" "BitTorrent protocol", 20);
 }
 
 /*
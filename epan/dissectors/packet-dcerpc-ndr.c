@@ -21,6 +21,16 @@
  * to the rules of NDR.
  */
 
+/* Format a value via the field's value_string table, which may have been
+ * wrapped into a value_string_ext at registration time. */
+static const char *
+ndr_val_to_str(guint32 val, header_field_info *hf_info)
+{
+    if (hf_info->display & BASE_EXT_STRING)
+        return val_to_str_ext(val, (value_string_ext *)hf_info->strings, "Unknown:%u");
+    return val_to_str(val, (const value_string *)hf_info->strings, "Unknown:%u");
+}
+
 int
 dissect_ndr_uint8(tvbuff_t *tvb, gint offset, packet_info *pinfo,
                   proto_tree *tree, dcerpc_info *di, guint8 *drep,
@@ -66,17 +76,17 @@ PIDL_dissect_uint8_val(tvbuff_t *tvb, gint offset, packet_info *pinfo,
         valstr = (char *)wmem_alloc(pinfo->pool, 64);
         valstr[0]=0;
 
-        switch (hf_info->display) {
+        switch (FIELD_DISPLAY(hf_info->display)) {
         case BASE_DEC:
             if (hf_info->strings) {
-                g_snprintf(valstr, 64, "%s(%d)",val_to_str(val, (const value_string *)hf_info->strings, "Unknown:%u"), val);
+                g_snprintf(valstr, 64, "%s(%d)",ndr_val_to_str(val, hf_info), val);
             } else {
                 g_snprintf(valstr, 64, "%d", val);
             }
             break;
         case BASE_HEX:
             if (hf_info->strings) {
-                g_snprintf(valstr, 64, "%s(0x%02x)",val_to_str(val, (const value_string *)hf_info->strings, "Unknown:%u"), val);
+                g_snprintf(valstr, 64, "%s(0x%02x)",ndr_val_to_str(val, hf_info), val);
             } else {
                 g_snprintf(valstr, 64, "0x%02x", val);
             }
@@ -154,17 +164,17 @@ PIDL_dissect_uint16_val(tvbuff_t *tvb, gint offset, packet_info *pinfo,
         valstr = (char *)wmem_alloc(pinfo->pool, 64);
         valstr[0]=0;
 
-        switch (hf_info->display) {
+        switch (FIELD_DISPLAY(hf_info->display)) {
         case BASE_DEC:
             if (hf_info->strings) {
-                g_snprintf(valstr, 64, "%s(%d)",val_to_str(val, (const value_string *)hf_info->strings, "Unknown:%u"), val);
+                g_snprintf(valstr, 64, "%s(%d)",ndr_val_to_str(val, hf_info), val);
             } else {
                 g_snprintf(valstr, 64, "%d", val);
             }
             break;
         case BASE_HEX:
             if (hf_info->strings) {
-                g_snprintf(valstr, 64, "%s(0x%04x)",val_to_str(val, (const value_string *)hf_info->strings, "Unknown:%u"), val);
+                g_snprintf(valstr, 64, "%s(0x%04x)",ndr_val_to_str(val, hf_info), val);
             } else {
                 g_snprintf(valstr, 64, "0x%04x", val);
             }
@@ -281,17 +291,17 @@ PIDL_dissect_uint32_val(tvbuff_t *tvb, gint offset, packet_info *pinfo,
         valstr = (char *)wmem_alloc(pinfo->pool, 64);
         valstr[0]=0;
 
-        switch (hf_info->display) {
+        switch (FIELD_DISPLAY(hf_info->display)) {
         case BASE_DEC:
             if (hf_info->strings) {
-                g_snprintf(valstr, 64, "%s(%d)",val_to_str(val, (const value_string *)hf_info->strings, "Unknown:%u"), val);
+                g_snprintf(valstr, 64, "%s(%d)",ndr_val_to_str(val, hf_info), val);
             } else {
                 g_snprintf(valstr, 64, "%d", val);
             }
             break;
         case BASE_HEX:
             if (hf_info->strings) {
-                g_snprintf(valstr, 64, "%s(0x%08x)",val_to_str(val, (const value_string *)hf_info->strings, "Unknown:%u"), val);
+                g_snprintf(valstr, 64, "%s(0x%08x)",ndr_val_to_str(val, hf_info), val);
             } else {
                 g_snprintf(valstr, 64, "0x%08x", val);
             }
@@ -397,17 +407,17 @@ PIDL_dissect_uint64_val(tvbuff_t *tvb, gint offset, packet_info *pinfo,
         valstr = (char *)wmem_alloc(pinfo->pool, 64);
         valstr[0]=0;
 
-        switch (hf_info->display) {
+        switch (FIELD_DISPLAY(hf_info->display)) {
         case BASE_DEC:
             if (hf_info->strings) {
-                g_snprintf(valstr, 64, "%s(%" G_GINT64_MODIFIER "u)",val_to_str( (guint32) val, (const value_string *)hf_info->strings, "Unknown:%u"), val);
+                g_snprintf(valstr, 64, "%s(%" G_GINT64_MODIFIER "u)",ndr_val_to_str((guint32) val, hf_info), val);
             } else {
                 g_snprintf(valstr, 64, "%" G_GINT64_MODIFIER "u", val);
             }
             break;
         case BASE_HEX:
             if (hf_info->strings) {
-                g_snprintf(valstr, 64, "%s(0x%" G_GINT64_MODIFIER "x)",val_to_str( (guint32) val, (const value_string *)hf_info->strings, "Unknown:%u"), val);
+                g_snprintf(valstr, 64, "%s(0x%" G_GINT64_MODIFIER "x)",ndr_val_to_str((guint32) val, hf_info), val);
             } else {
                 g_snprintf(valstr, 64, "0x%" G_GINT64_MODIFIER "x", val);
             }
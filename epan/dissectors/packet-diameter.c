@@ -2116,9 +2116,15 @@ dictionary_load(void)
 		g_hash_table_insert(build_dict.types,(gchar *)type->name,(void *)type);
 	}
 
-	/* load the dictionary */
+	/* load the dictionary, from the binary cache if the directory
+	   hasn't changed since the cache was written */
 	dir = wmem_strdup_printf(NULL, "%s" G_DIR_SEPARATOR_S "diameter" G_DIR_SEPARATOR_S, get_datafile_dir());
-	d = ddict_scan(dir,"dictionary.xml",do_debug_parser);
+	d = ddict_cache_load(dir);
+	if (d == NULL) {
+		d = ddict_scan(dir,"dictionary.xml",do_debug_parser);
+		if (d != NULL)
+			ddict_cache_save(dir, d);
+	}
 	wmem_free(NULL, dir);
 	if (d == NULL) {
 		g_hash_table_destroy(vendors);
@@ -70,6 +70,7 @@
 #include <epan/afn.h>
 #include <epan/tap.h>
 #include <epan/stats_tree.h>
+#include <epan/proto_data.h>
 #include <wsutil/utf8_entities.h>
 #include "packet-tls.h"
 #include "packet-dtls.h"
@@ -4216,12 +4217,16 @@ dissect_dns_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
           }
         }
       }
+      if (dns_trans) {
+        /* Remember the match so that later passes don't have to search
+           the conversation tree again. Keyed by the transaction ID so
+           that multiple DNS messages in one frame stay distinct. */
+        p_add_proto_data(wmem_file_scope(), pinfo, proto_dns, reqresp_id, dns_trans);
+      }
     } else {
-      dns_trans=(dns_transaction_t *)wmem_tree_lookup32_array_le(dns_info->pdus, key);
+      dns_trans=(dns_transaction_t *)p_get_proto_data(wmem_file_scope(), pinfo, proto_dns, reqresp_id);
       if (dns_trans) {
-        if (dns_trans->id != reqresp_id) {
-          dns_trans = NULL;
-        } else if ((!(flags & F_RESPONSE)) && (dns_trans->req_frame != pinfo->num)) {
+        if ((!(flags & F_RESPONSE)) && (dns_trans->req_frame != pinfo->num)) {
           /* This is a request retransmission, create a "fake" dns_trans structure*/
           dns_transaction_t *retrans_dns = wmem_new(wmem_packet_scope(), dns_transaction_t);
           retrans_dns->req_frame=dns_trans->req_frame;
@@ -33,6 +33,7 @@
 #include <wsutil/ws_assert.h>
 #include <epan/proto_data.h>
 #include <epan/addr_resolv.h>
+#include <epan/frame_class.h>
 #include <epan/wmem_scopes.h>
 
 #include "packet-frame.h"
@@ -63,6 +64,7 @@ static int hf_frame_file_off = -1;
 static int hf_frame_md5_hash = -1;
 static int hf_frame_marked = -1;
 static int hf_frame_ignored = -1;
+static int hf_frame_coarse_class = -1;
 static int hf_link_number = -1;
 static int hf_frame_packet_id = -1;
 static int hf_frame_verdict = -1;
@@ -677,8 +679,13 @@ dissect_frame(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, void*
 								  " the valid range is 0-1000000000",
 								  (long) pinfo->abs_ts.nsecs);
 			}
+			static const nstime_t zero_shift = NSTIME_INIT_ZERO;
+			const nstime_t *shift_offset = epan_get_frame_shift_offset(pinfo->epan, pinfo->fd);
+
+			if (shift_offset == NULL)
+				shift_offset = &zero_shift;
 			item = proto_tree_add_time(fh_tree, hf_frame_shift_offset, tvb,
-					    0, 0, &(pinfo->fd->shift_offset));
+					    0, 0, shift_offset);
 			proto_item_set_generated(item);
 
 			if (generate_epoch_time) {
@@ -750,6 +757,12 @@ dissect_frame(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, void*
 		ti = proto_tree_add_boolean(fh_tree, hf_frame_ignored, tvb, 0, 0,pinfo->fd->ignored);
 		proto_item_set_generated(ti);
 
+		if (pinfo->fd->coarse_class != 0) {
+			ti = proto_tree_add_uint(fh_tree, hf_frame_coarse_class, tvb,
+						 0, 0, pinfo->fd->coarse_class);
+			proto_item_set_generated(ti);
+		}
+
 		if (pinfo->rec->rec_type == REC_TYPE_PACKET) {
 			/* Check for existences of P2P pseudo header */
 			if (pinfo->p2p_dir != P2P_DIR_UNKNOWN) {
@@ -1132,6 +1145,11 @@ proto_register_frame(void)
 		    FT_BOOLEAN, BASE_NONE, NULL, 0x0,
 		    "Frame is ignored by the dissectors", HFILL }},
 
+		{ &hf_frame_coarse_class,
+		  { "Coarse class", "frame.coarse_class",
+		    FT_UINT8, BASE_DEC, VALS(frame_class_vals), 0x0,
+		    "Pre-dissection coarse classification of the frame", HFILL }},
+
 		{ &hf_frame_protocols,
 		  { "Protocols in frame", "frame.protocols",
 		    FT_STRING, BASE_NONE, NULL, 0x0,
@@ -764,6 +764,16 @@ h265_payload_extension_present(tvbuff_t* tvb, gint bit_start, gint bit_offset, g
 */
 #define cVALS(x) (const value_string*)(x)
 
+/* Like val_to_str_const(), but for a field's registered table, which may have
+ * been wrapped into a value_string_ext at registration time. */
+static const gchar *
+h265_val_to_str_const(guint32 val, const header_field_info *hf_field, const gchar *unknown_str)
+{
+	if (hf_field->display & BASE_EXT_STRING)
+		return val_to_str_ext_const(val, (value_string_ext *)hf_field->strings, unknown_str);
+	return val_to_str_const(val, cVALS(hf_field->strings), unknown_str);
+}
+
 static guint32
 dissect_h265_exp_golomb_code(proto_tree *tree, int hf_index, tvbuff_t *tvb, gint *start_bit_offset, h265_golomb_descriptors descriptor)
 /*(tvbuff_t *tvb, gint *start_bit_offset) */
@@ -838,7 +848,7 @@ dissect_h265_exp_golomb_code(proto_tree *tree, int hf_index, tvbuff_t *tvb, gint
 						proto_tree_add_int_format(tree, hf_index, tvb, start_offset, 1, codenum,
 							"%s: %s (%d)",
 							str,
-							val_to_str_const(codenum, cVALS(hf_field->strings), "Unknown "),
+							h265_val_to_str_const(codenum, hf_field, "Unknown "),
 							codenum);
 					}
 					else {
@@ -864,7 +874,7 @@ dissect_h265_exp_golomb_code(proto_tree *tree, int hf_index, tvbuff_t *tvb, gint
 					proto_tree_add_uint_format(tree, hf_index, tvb, start_offset, 1, codenum,
 						"%s: %s (%u)",
 						str,
-						val_to_str_const(codenum, cVALS(hf_field->strings), "Unknown "),
+						h265_val_to_str_const(codenum, hf_field, "Unknown "),
 						codenum);
 				}
 				else {
@@ -985,7 +995,7 @@ dissect_h265_exp_golomb_code(proto_tree *tree, int hf_index, tvbuff_t *tvb, gint
 				proto_tree_add_uint_format(tree, hf_index, tvb, start_offset, 1, codenum,
 					"%s: %s (%u)",
 					str,
-					val_to_str_const(codenum, cVALS(hf_field->strings), "Unknown "),
+					h265_val_to_str_const(codenum, hf_field, "Unknown "),
 					codenum);
 			}
 			else {
@@ -1013,7 +1023,7 @@ dissect_h265_exp_golomb_code(proto_tree *tree, int hf_index, tvbuff_t *tvb, gint
 				proto_tree_add_int_format(tree, hf_index, tvb, start_offset, 1, codenum,
 					"%s: %s (%d)",
 					str,
-					val_to_str_const(codenum, cVALS(hf_field->strings), "Unknown "),
+					h265_val_to_str_const(codenum, hf_field, "Unknown "),
 					se_value);
 			}
 			else {
@@ -1846,6 +1846,7 @@ dissect_ip_v4(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, void*
   proto_tree *tree;
   proto_item *item = NULL, *ttl_item;
   guint16 ttl_valid;
+  tvb_span_t ip_span;
 
   tree = parent_tree;
   iph = wmem_new0(pinfo->pool, ws_ip4);
@@ -1899,7 +1900,11 @@ dissect_ip_v4(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, void*
   proto_tree_add_uint_bits_format_value(ip_tree, hf_ip_hdr_len, tvb, (offset<<3)+4, 4, hlen,
                                "%u bytes (%u)", hlen, hlen>>2);
 
-  iph->ip_tos = tvb_get_guint8(tvb, offset + 1);
+  /* Validate the fixed 20-byte header once; the field reads below are
+     unchecked span accesses. */
+  tvb_get_span(tvb, offset, IPH_MIN_LEN, &ip_span);
+
+  iph->ip_tos = tvb_span_get_guint8(&ip_span, 1);
   if (g_ip_dscp_actif) {
     col_add_str(pinfo->cinfo, COL_DSCP_VALUE,
                 val_to_str_ext(IPDSFIELD_DSCP(iph->ip_tos), &dscp_short_vals_ext, "%u"));
@@ -1938,7 +1943,7 @@ dissect_ip_v4(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, void*
      inside an ICMP datagram; we need to somehow let the
      dissector we call know that, as it might want to avoid
      doing its checksumming. */
-  iph->ip_len = tvb_get_ntohs(tvb, offset + 2);
+  iph->ip_len = tvb_span_get_ntohs(&ip_span, 2);
 
   if (iph->ip_len < hlen) {
     if (ip_tso_supported && !iph->ip_len) {
@@ -1989,11 +1994,11 @@ dissect_ip_v4(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, void*
     }
   }
 
-  iph->ip_id  = tvb_get_ntohs(tvb, offset + 4);
+  iph->ip_id  = tvb_span_get_ntohs(&ip_span, 4);
   if (tree)
     proto_tree_add_uint(ip_tree, hf_ip_id, tvb, offset + 4, 2, iph->ip_id);
 
-  iph->ip_off = tvb_get_ntohs(tvb, offset + 6);
+  iph->ip_off = tvb_span_get_ntohs(&ip_span, 6);
 
   if (ip_security_flag) {
     /* RFC 3514 - The Security Flag in the IPv4 Header (April Fool's joke) */
@@ -2022,15 +2027,15 @@ dissect_ip_v4(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, void*
 
   tf = proto_tree_add_uint(ip_tree, hf_ip_frag_offset, tvb, offset + 6, 2, (iph->ip_off & IP_OFFSET)*8);
 
-  iph->ip_ttl = tvb_get_guint8(tvb, offset + 8);
+  iph->ip_ttl = tvb_span_get_guint8(&ip_span, 8);
   ttl_item = proto_tree_add_item(ip_tree, hf_ip_ttl, tvb, offset + 8, 1, ENC_BIG_ENDIAN);
 
-  iph->ip_proto = tvb_get_guint8(tvb, offset + 9);
+  iph->ip_proto = tvb_span_get_guint8(&ip_span, 9);
   if (tree) {
     proto_tree_add_item(ip_tree, hf_ip_proto, tvb, offset + 9, 1, ENC_BIG_ENDIAN);
   }
 
-  iph->ip_sum = tvb_get_ntohs(tvb, offset + 10);
+  iph->ip_sum = tvb_span_get_ntohs(&ip_span, 10);
 
   /*
    * If checksum checking is enabled, and we have the entire IP header
@@ -2092,7 +2097,7 @@ dissect_ip_v4(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, void*
                                     offset + 10, 0, PROTO_CHECKSUM_E_UNVERIFIED);
     proto_item_set_generated(item);
   }
-  src32 = tvb_get_ntohl(tvb, offset + IPH_SRC);
+  src32 = tvb_span_get_ntohl(&ip_span, IPH_SRC);
   set_address_tvb(&pinfo->net_src, AT_IPv4, 4, tvb, offset + IPH_SRC);
   copy_address_shallow(&pinfo->src, &pinfo->net_src);
   copy_address_shallow(&iph->ip_src, &pinfo->src);
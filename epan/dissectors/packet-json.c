@@ -634,6 +634,19 @@ dissect_json(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data)
 		}
 	}
 
+	/* If we're not building a tree, none of the items below would be
+	 * visible; tokenizing large bodies through tvbparse just to throw
+	 * the results away can take longer than transferring them did.  A
+	 * single validating scan tells us whether the whole buffer is
+	 * JSON, which is all the column text needs. */
+	if (tree == NULL && buffer_length > offset &&
+	    json_validate(tvb_get_ptr(tvb, offset, buffer_length - offset),
+	                  buffer_length - offset)) {
+		if (data_name)
+			col_append_sep_fstr(pinfo->cinfo, COL_INFO, " ", "(%s)", data_name);
+		return buffer_length;
+	}
+
 	if (json_compact) {
 		proto_tree* json_tree_compact = NULL;
 		json_tree_compact = proto_tree_add_subtree(json_tree, tvb, 0, -1, ett_json_compact, NULL, "JSON compact form:");
@@ -1867,28 +1867,112 @@ decompress_zstd(tvbuff_t *tvb _U_, packet_info *pinfo, int offset _U_, guint32 l
 // Max is currently 2^22 in
 // https://github.com/apache/kafka/blob/trunk/clients/src/main/java/org/apache/kafka/common/record/KafkaLZ4BlockOutputStream.java
 #define MAX_DECOMPRESSION_SIZE (1 << 22)
+
+/*
+ * Decompressing a batch is by far the most expensive part of dissecting a
+ * Kafka frame, so do it only once. On the first pass every decompressed
+ * payload is copied to file scope and recorded, in call order, in a
+ * per-frame cache. Later passes (filtering, selecting the packet, export)
+ * replay the cache instead of running the codec again. The call order is
+ * deterministic, so a packet-scoped cursor is enough to pair each call
+ * with its cached result; a NULL payload marks a batch that failed to
+ * decompress, in which case the codec is re-run to reproduce the failure
+ * indication.
+ */
+typedef struct kafka_decompressed_batch {
+    guint8 *data;    /* decompressed payload (file scope), NULL on failure */
+    guint   length;
+} kafka_decompressed_batch_t;
+
+static kafka_decompressed_batch_t *
+decompress_replay_cached(packet_info *pinfo)
+{
+    wmem_array_t *cache;
+    guint *cursor;
+
+    cache = (wmem_array_t *) p_get_proto_data(wmem_file_scope(), pinfo, proto_kafka, 0);
+    if (cache == NULL) {
+        return NULL;
+    }
+    cursor = (guint *) p_get_proto_data(pinfo->pool, pinfo, proto_kafka, 0);
+    if (cursor == NULL) {
+        cursor = wmem_new0(pinfo->pool, guint);
+        p_add_proto_data(pinfo->pool, pinfo, proto_kafka, 0, cursor);
+    }
+    if (*cursor >= wmem_array_get_count(cache)) {
+        return NULL;
+    }
+    return (kafka_decompressed_batch_t *) wmem_array_index(cache, (*cursor)++);
+}
+
+static void
+decompress_record_cached(packet_info *pinfo, tvbuff_t *decompressed_tvb, int decompressed_offset, gboolean ok)
+{
+    wmem_array_t *cache;
+    kafka_decompressed_batch_t entry;
+
+    cache = (wmem_array_t *) p_get_proto_data(wmem_file_scope(), pinfo, proto_kafka, 0);
+    if (cache == NULL) {
+        cache = wmem_array_new(wmem_file_scope(), sizeof(kafka_decompressed_batch_t));
+        p_add_proto_data(wmem_file_scope(), pinfo, proto_kafka, 0, cache);
+    }
+    if (ok) {
+        entry.length = tvb_captured_length_remaining(decompressed_tvb, decompressed_offset);
+        entry.data   = (guint8 *) tvb_memdup(wmem_file_scope(), decompressed_tvb, decompressed_offset, entry.length);
+    } else {
+        entry.length = 0;
+        entry.data   = NULL;
+    }
+    wmem_array_append_one(cache, entry);
+}
+
 static gboolean
 decompress(tvbuff_t *tvb, packet_info *pinfo, int offset, guint32 length, int codec, tvbuff_t **decompressed_tvb, int *decompressed_offset)
 {
+    gboolean rc;
+
     if (length > MAX_DECOMPRESSION_SIZE) {
         expert_add_info(pinfo, NULL, &ei_kafka_bad_decompression_length);
         return FALSE;
     }
+    if (codec == KAFKA_MESSAGE_CODEC_NONE) {
+        return decompress_none(tvb, pinfo, offset, length, decompressed_tvb, decompressed_offset);
+    }
+    if (PINFO_FD_VISITED(pinfo)) {
+        kafka_decompressed_batch_t *entry = decompress_replay_cached(pinfo);
+        if (entry && entry->data) {
+            *decompressed_tvb = tvb_new_child_real_data(tvb, entry->data, entry->length, entry->length);
+            *decompressed_offset = 0;
+            return TRUE;
+        }
+        /* failed on the first pass (or no cache); fall through and run the codec */
+    }
     switch (codec) {
         case KAFKA_MESSAGE_CODEC_SNAPPY:
-            return decompress_snappy(tvb, pinfo, offset, length, decompressed_tvb, decompressed_offset);
+            rc = decompress_snappy(tvb, pinfo, offset, length, decompressed_tvb, decompressed_offset);
+            break;
         case KAFKA_MESSAGE_CODEC_LZ4:
-            return decompress_lz4(tvb, pinfo, offset, length, decompressed_tvb, decompressed_offset);
+            rc = decompress_lz4(tvb, pinfo, offset, length, decompressed_tvb, decompressed_offset);
+            break;
         case KAFKA_MESSAGE_CODEC_ZSTD:
-            return decompress_zstd(tvb, pinfo, offset, length, decompressed_tvb, decompressed_offset);
+            rc = decompress_zstd(tvb, pinfo, offset, length, decompressed_tvb, decompressed_offset);
+            break;
         case KAFKA_MESSAGE_CODEC_GZIP:
-            return decompress_gzip(tvb, pinfo, offset, length, decompressed_tvb, decompressed_offset);
-        case KAFKA_MESSAGE_CODEC_NONE:
-            return decompress_none(tvb, pinfo, offset, length, decompressed_tvb, decompressed_offset);
+            rc = decompress_gzip(tvb, pinfo, offset, length, decompressed_tvb, decompressed_offset);
+            break;
         default:
             col_append_str(pinfo->cinfo, COL_INFO, " [unsupported compression type]");
-            return FALSE;
+            rc = FALSE;
+            break;
+    }
+    if (!PINFO_FD_VISITED(pinfo)) {
+        if (rc) {
+            decompress_record_cached(pinfo, *decompressed_tvb, *decompressed_offset, TRUE);
+        } else {
+            decompress_record_cached(pinfo, NULL, 0, FALSE);
+        }
     }
+    return rc;
 }
 
 /*
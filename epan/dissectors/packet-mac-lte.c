@@ -1464,6 +1464,11 @@ static gboolean global_mac_lte_show_drx = FALSE;
 /* Whether to record config and try to show DRX state for each configured UE */
 static gboolean global_mac_lte_show_BSR_median = FALSE;
 
+/* Counters-only decoding: parse MAC headers and feed the statistics tap, but
+   skip per-PDU Msg3/CR, SR, HARQ and DRX analysis and don't call subdissectors
+   for SDUs.  Intended for bulk statistics runs over very large captures. */
+static gboolean global_mac_lte_counters_only = FALSE;
+
 
 /* When showing RLC info, count PDUs so can append info column properly */
 static guint8   s_number_of_rlc_pdus_shown = 0;
@@ -1562,7 +1567,14 @@ typedef struct ue_dynamic_drb_mappings_t {
     guint8 drb_to_lcid_mappings[32];         /* Also map drbid -> lcid */
 } ue_dynamic_drb_mappings_t;
 
-static GHashTable *mac_lte_ue_channels_hash = NULL;
+/* Per-UE tracking state below is pooled in flat arrays indexed by UEId or
+   C-RNTI.  Both identifiers are 16 bits, so the index space is bounded and
+   dense; with the tens of thousands of UEs seen in drive-test captures this
+   avoids hashing on every PDU.  The arrays hold pointers to file-scoped
+   entries and are allocated/freed with the file. */
+#define MAC_LTE_UE_POOL_SIZE 0x10000
+
+static ue_dynamic_drb_mappings_t **mac_lte_ue_channels = NULL;  /* Index is UEId */
 
 
 extern int proto_rlc_lte;
@@ -1582,9 +1594,9 @@ typedef struct Msg3Data {
 } Msg3Data;
 
 
-/* This table stores (RNTI -> Msg3Data*).  Will be populated when
+/* This array stores (RNTI -> Msg3Data*).  Will be populated when
    Msg3 frames are first read.  */
-static GHashTable *mac_lte_msg3_hash = NULL;
+static Msg3Data **mac_lte_msg3_data = NULL;
 
 typedef enum ContentionResolutionStatus {
     NoMsg3,
@@ -1634,9 +1646,9 @@ typedef struct DLHarqBuffers {
 } DLHarqBuffers;
 
 
-/* This table stores (RNTI -> DLHARQBuffers*).  Will be populated when
+/* This array stores (RNTI -> DLHARQBuffers*).  Will be populated when
    DL frames are first read.  */
-static GHashTable *mac_lte_dl_harq_hash = NULL;
+static DLHarqBuffers **mac_lte_dl_harq_buffers = NULL;
 
 typedef struct DLHARQResult {
     gboolean    previousSet, nextSet;
@@ -1663,9 +1675,9 @@ typedef struct ULHarqBuffers {
 } ULHarqBuffers;
 
 
-/* This table stores (RNTI -> ULHarqBuffers*).  Will be populated when
+/* This array stores (RNTI -> ULHarqBuffers*).  Will be populated when
    UL frames are first read.  */
-static GHashTable *mac_lte_ul_harq_hash = NULL;
+static ULHarqBuffers **mac_lte_ul_harq_buffers = NULL;
 
 typedef struct ULHARQResult {
     gboolean    previousSet, nextSet;
@@ -1728,9 +1740,9 @@ typedef struct SRState {
 } SRState;
 
 
-/* This table keeps track of the SR state for each UE.
-   (RNTI -> SRState) */
-static GHashTable *mac_lte_ue_sr_state = NULL;
+/* This array keeps track of the SR state for each UE.
+   (RNTI -> SRState*) */
+static SRState **mac_lte_ue_sr_state = NULL;
 
 
 typedef enum SRResultType {
@@ -1800,9 +1812,9 @@ typedef struct ue_parameters_t
     drx_state_t drx_state;
 } ue_parameters_t;
 
-/* Entries in this table are maintained during the first pass
-   It maps (UEId -> ue_parameters_t). */
-static GHashTable *mac_lte_ue_parameters = NULL;
+/* Entries in this array are maintained during the first pass
+   It maps (UEId -> ue_parameters_t*). */
+static ue_parameters_t **mac_lte_ue_parameters = NULL;
 
 
 /**************************************************************************/
@@ -1981,8 +1993,7 @@ static gboolean mac_lte_drx_has_timer_expired(drx_state_t *p_state, drx_timer_ty
 static void mac_lte_drx_new_ulsch_data(guint16 ueid)
 {
     /* Look up state of this UE */
-    ue_parameters_t *ue_params = (ue_parameters_t *)g_hash_table_lookup(mac_lte_ue_parameters,
-                                                                        GUINT_TO_POINTER((guint)ueid));
+    ue_parameters_t *ue_params = mac_lte_ue_parameters[ueid];
 
     /* Start inactivity timer */
     if ((ue_params != NULL) && ue_params->drx_state_valid) {
@@ -1993,8 +2004,7 @@ static void mac_lte_drx_new_ulsch_data(guint16 ueid)
 static void mac_lte_drx_new_dlsch_data(guint16 ueid)
 {
     /* Look up state of this UE */
-    ue_parameters_t *ue_params = (ue_parameters_t *)g_hash_table_lookup(mac_lte_ue_parameters,
-                                                                        GUINT_TO_POINTER((guint)ueid));
+    ue_parameters_t *ue_params = mac_lte_ue_parameters[ueid];
 
     /* Start retransmission timer */
     if ((ue_params != NULL) && ue_params->drx_state_valid) {
@@ -2005,8 +2015,7 @@ static void mac_lte_drx_new_dlsch_data(guint16 ueid)
 static void mac_lte_drx_dl_crc_error(guint16 ueid)
 {
     /* Look up state of this UE */
-    ue_parameters_t *ue_params = (ue_parameters_t *)g_hash_table_lookup(mac_lte_ue_parameters,
-                                                                        GUINT_TO_POINTER((guint)ueid));
+    ue_parameters_t *ue_params = mac_lte_ue_parameters[ueid];
 
     /* Start timer */
     if ((ue_params != NULL) && ue_params->drx_state_valid) {
@@ -2018,8 +2027,7 @@ static void mac_lte_drx_dl_crc_error(guint16 ueid)
 static void mac_lte_drx_control_element_received(guint16 ueid)
 {
     /* Look up state of this UE */
-    ue_parameters_t *ue_params = (ue_parameters_t *)g_hash_table_lookup(mac_lte_ue_parameters,
-                                                                        GUINT_TO_POINTER((guint)ueid));
+    ue_parameters_t *ue_params = mac_lte_ue_parameters[ueid];
 
     /* Start timers */
     if ((ue_params != NULL) && ue_params->drx_state_valid) {
@@ -2035,10 +2043,14 @@ static void update_drx_info(packet_info *pinfo, mac_lte_info *p_mac_lte_info)
 {
     int harq_id;
     guint64 time_until_expires;
+    ue_parameters_t *ue_params;
+
+    if (global_mac_lte_counters_only) {
+        return;
+    }
 
     /* Look up state of this UE */
-    ue_parameters_t *ue_params = (ue_parameters_t *)g_hash_table_lookup(mac_lte_ue_parameters,
-                                                                        GUINT_TO_POINTER((guint)p_mac_lte_info->ueid));
+    ue_params = mac_lte_ue_parameters[p_mac_lte_info->ueid];
 
     if ((ue_params != NULL) && ue_params->drx_state_valid) {
         /* We loop until we find this subframe */
@@ -2163,11 +2175,16 @@ static gpointer get_drx_result_hash_key(guint32 frameNumber,
    Only called on first pass through frames. */
 static void set_drx_info(packet_info *pinfo, mac_lte_info *p_mac_lte_info, gboolean before_event, guint pdu_instance)
 {
-    /* Look up state of this UE */
-    ue_parameters_t *ue_params = (ue_parameters_t *)g_hash_table_lookup(mac_lte_ue_parameters,
-                                                                        GUINT_TO_POINTER((guint)p_mac_lte_info->ueid));
+    ue_parameters_t *ue_params;
     drx_state_t *frame_result;
 
+    if (global_mac_lte_counters_only) {
+        return;
+    }
+
+    /* Look up state of this UE */
+    ue_params = mac_lte_ue_parameters[p_mac_lte_info->ueid];
+
     if ((ue_params != NULL) && ue_params->drx_state_valid) {
         /* Should only need to allocate frame_result and add to the result table when
            before PDU is processed */
@@ -2398,14 +2415,12 @@ static const gchar *get_mac_lte_rapid_description(guint8 rapid)
 static void
 get_mac_lte_ue_ext_bsr_sizes(mac_lte_info *p_mac_lte_info)
 {
-    gpointer p_orig_key, p_ue_params;
+    const ue_parameters_t *ue_params = mac_lte_ue_parameters[p_mac_lte_info->ueid];
 
-    /* Use the _extended function to check the key presence and avoid overriding a
-       value already set by the framing protocol while no RRC value is configured */
-    if (g_hash_table_lookup_extended(mac_lte_ue_parameters,
-                                     GUINT_TO_POINTER((guint)p_mac_lte_info->ueid),
-                                     &p_orig_key, &p_ue_params)) {
-        p_mac_lte_info->isExtendedBSRSizes = ((ue_parameters_t *)p_ue_params)->use_ext_bsr_sizes;
+    /* Check the entry presence to avoid overriding a value already set
+       by the framing protocol while no RRC value is configured */
+    if (ue_params != NULL) {
+        p_mac_lte_info->isExtendedBSRSizes = ue_params->use_ext_bsr_sizes;
     }
 }
 
@@ -2415,15 +2430,13 @@ get_mac_lte_ue_ext_bsr_sizes(mac_lte_info *p_mac_lte_info)
 static void
 get_mac_lte_ue_simult_pucch_pusch(mac_lte_info *p_mac_lte_info)
 {
-    gpointer p_orig_key, p_ue_params;
+    const ue_parameters_t *ue_params = mac_lte_ue_parameters[p_mac_lte_info->ueid];
 
-    /* Use the _extended function to check the key presence and avoid overriding a
-       value already set by the framing protocol while no RRC value is configured */
-    if (g_hash_table_lookup_extended(mac_lte_ue_parameters,
-                                     GUINT_TO_POINTER((guint)p_mac_lte_info->ueid),
-                                     &p_orig_key, &p_ue_params)) {
-        p_mac_lte_info->isSimultPUCCHPUSCHPCell = ((ue_parameters_t *)p_ue_params)->use_simult_pucch_pusch_pcell;
-        p_mac_lte_info->isSimultPUCCHPUSCHPSCell = ((ue_parameters_t *)p_ue_params)->use_simult_pucch_pusch_pscell;
+    /* Check the entry presence to avoid overriding a value already set
+       by the framing protocol while no RRC value is configured */
+    if (ue_params != NULL) {
+        p_mac_lte_info->isSimultPUCCHPUSCHPCell = ue_params->use_simult_pucch_pusch_pcell;
+        p_mac_lte_info->isSimultPUCCHPUSCHPSCell = ue_params->use_simult_pucch_pusch_pscell;
     }
 }
 
@@ -2437,6 +2450,11 @@ static guint8 get_mac_lte_channel_priority(guint16 ueid _U_, guint8 lcid,
 static void
 call_with_catch_all(dissector_handle_t handle, tvbuff_t* tvb, packet_info *pinfo, proto_tree *tree)
 {
+    /* Counters-only runs don't dissect SDU contents at all */
+    if (global_mac_lte_counters_only) {
+        return;
+    }
+
     /* Call it (catch exceptions so that stats will be updated) */
     if (handle) {
         TRY {
@@ -3590,6 +3608,10 @@ static void TrackReportedDLHARQResend(packet_info *pinfo, tvbuff_t *tvb, int len
     DLHARQResult *result = NULL;
     DLHARQResult *original_result = NULL;
 
+    if (global_mac_lte_counters_only) {
+        return;
+    }
+
     /* If don't have detailed DL PHY info, just give up */
     if (!p_mac_lte_info->detailed_phy_info.dl_info.present) {
         return;
@@ -3614,7 +3636,7 @@ static void TrackReportedDLHARQResend(packet_info *pinfo, tvbuff_t *tvb, int len
         }
 
         /* Look up entry for this UE/RNTI */
-        ueData = (DLHarqBuffers *)g_hash_table_lookup(mac_lte_dl_harq_hash, GUINT_TO_POINTER((guint)p_mac_lte_info->rnti));
+        ueData = mac_lte_dl_harq_buffers[p_mac_lte_info->rnti];
 
         if (ueData != NULL) {
             /* Get previous info for this harq-id */
@@ -3661,7 +3683,7 @@ static void TrackReportedDLHARQResend(packet_info *pinfo, tvbuff_t *tvb, int len
         else {
             /* Allocate entry in table for this UE/RNTI */
             ueData = wmem_new0(wmem_file_scope(), DLHarqBuffers);
-            g_hash_table_insert(mac_lte_dl_harq_hash, GUINT_TO_POINTER((guint)p_mac_lte_info->rnti), ueData);
+            mac_lte_dl_harq_buffers[p_mac_lte_info->rnti] = ueData;
         }
 
         /* Store this frame's details in table */
@@ -3744,6 +3766,10 @@ static void TrackReportedULHARQResend(packet_info *pinfo, tvbuff_t *tvb, int off
 {
     ULHARQResult *result = NULL;
 
+    if (global_mac_lte_counters_only) {
+        return;
+    }
+
     /* If don't have detailed DL PHY info, just give up */
     if (!p_mac_lte_info->detailed_phy_info.ul_info.present) {
         return;
@@ -3760,8 +3786,7 @@ static void TrackReportedULHARQResend(packet_info *pinfo, tvbuff_t *tvb, int off
         LastFrameData *thisData = NULL;
 
         /* Look up entry for this UE/RNTI */
-        ULHarqBuffers *ueData = (ULHarqBuffers *)g_hash_table_lookup(
-            mac_lte_ul_harq_hash, GUINT_TO_POINTER((guint)p_mac_lte_info->rnti));
+        ULHarqBuffers *ueData = mac_lte_ul_harq_buffers[p_mac_lte_info->rnti];
         if (ueData != NULL) {
             if (p_mac_lte_info->reTxCount >= 1) {
                 /* Looking for frame previously on this harq-id */
@@ -3812,7 +3837,7 @@ static void TrackReportedULHARQResend(packet_info *pinfo, tvbuff_t *tvb, int off
         else {
             /* Allocate entry in table for this UE/RNTI */
             ueData = wmem_new0(wmem_file_scope(), ULHarqBuffers);
-            g_hash_table_insert(mac_lte_ul_harq_hash, GUINT_TO_POINTER((guint)p_mac_lte_info->rnti), ueData);
+            mac_lte_ul_harq_buffers[p_mac_lte_info->rnti] = ueData;
         }
 
         /* Store this frame's details in table */
@@ -3896,6 +3921,10 @@ static void TrackSRInfo(SREvent event, packet_info *pinfo, proto_tree *tree,
     guint16     ueid;
     proto_item *ti;
 
+    if (global_mac_lte_counters_only) {
+        return;
+    }
+
     /* Get appropriate identifiers */
     if (event == SR_Request) {
         rnti = p_mac_lte_info->oob_rnti[idx];
@@ -3907,12 +3936,12 @@ static void TrackSRInfo(SREvent event, packet_info *pinfo, proto_tree *tree,
     }
 
     /* Create state for this RNTI if necessary */
-    state = (SRState *)g_hash_table_lookup(mac_lte_ue_sr_state, GUINT_TO_POINTER((guint)rnti));
+    state = mac_lte_ue_sr_state[rnti];
     if (state == NULL) {
         /* Allocate status for this RNTI */
         state = wmem_new(wmem_file_scope(), SRState);
         state->status = None;
-        g_hash_table_insert(mac_lte_ue_sr_state, GUINT_TO_POINTER((guint)rnti), state);
+        mac_lte_ue_sr_state[rnti] = state;
     }
 
     /* First time through - update state with new info */
@@ -4346,7 +4375,7 @@ static void lookup_rlc_channel_from_lcid(guint16 ueid,
     }
     else {
         /* Look up the dynamic mappings for this UE */
-        ue_dynamic_drb_mappings_t *ue_mappings = (ue_dynamic_drb_mappings_t *)g_hash_table_lookup(mac_lte_ue_channels_hash, GUINT_TO_POINTER((guint)ueid));
+        ue_dynamic_drb_mappings_t *ue_mappings = mac_lte_ue_channels[ueid];
         if (!ue_mappings) {
             return;
         }
@@ -5063,7 +5092,7 @@ static void dissect_ulsch_or_dlsch(tvbuff_t *tvb, packet_info *pinfo, proto_tree
                             g_hash_table_insert(mac_lte_cr_result_hash, GUINT_TO_POINTER(pinfo->num), crResult);
 
                             /* Look for Msg3 */
-                            msg3Data = (Msg3Data *)g_hash_table_lookup(mac_lte_msg3_hash, GUINT_TO_POINTER(msg3Key));
+                            msg3Data = mac_lte_msg3_data[msg3Key];
 
                             /* Compare CCCH bytes */
                             if (msg3Data != NULL) {
@@ -6078,15 +6107,15 @@ static void dissect_ulsch_or_dlsch(tvbuff_t *tvb, packet_info *pinfo, proto_tree
            Contention Resolution body */
         /* Starting from R13, CCCH can be more than 48 bits but only the first 48 bits are used for contention resolution */
         if ((lcids[n] == 0) && (p_mac_lte_info->direction == DIRECTION_UPLINK) && (data_length >= 6)) {
-            if (!PINFO_FD_VISITED(pinfo)) {
+            if (!PINFO_FD_VISITED(pinfo) && !global_mac_lte_counters_only) {
                 guint key = p_mac_lte_info->rnti;
-                Msg3Data *data = (Msg3Data *)g_hash_table_lookup(mac_lte_msg3_hash, GUINT_TO_POINTER(key));
+                Msg3Data *data = mac_lte_msg3_data[key];
 
                 /* Look for previous entry for this UE */
                 if (data == NULL) {
                     /* Allocate space for data and add to table */
                     data = wmem_new(wmem_file_scope(), Msg3Data);
-                    g_hash_table_insert(mac_lte_msg3_hash, GUINT_TO_POINTER(key), data);
+                    mac_lte_msg3_data[key] = data;
                 }
 
                 /* Fill in data details */
@@ -7632,18 +7661,21 @@ static void mac_lte_init_protocol(void)
     memset(&DL_tti_info, 0, sizeof(DL_tti_info));
     DL_tti_info.subframe = 0xff;  /* Invalid value */
 
-    mac_lte_msg3_hash = g_hash_table_new(g_direct_hash, g_direct_equal);
+    /* Pooled per-UE state, directly indexed by UEId or RNTI.  The entries
+       themselves are file-scoped, so only the pointer arrays need freeing. */
+    mac_lte_msg3_data = g_new0(Msg3Data *, MAC_LTE_UE_POOL_SIZE);
+    mac_lte_dl_harq_buffers = g_new0(DLHarqBuffers *, MAC_LTE_UE_POOL_SIZE);
+    mac_lte_ul_harq_buffers = g_new0(ULHarqBuffers *, MAC_LTE_UE_POOL_SIZE);
+    mac_lte_ue_sr_state = g_new0(SRState *, MAC_LTE_UE_POOL_SIZE);
+    mac_lte_ue_channels = g_new0(ue_dynamic_drb_mappings_t *, MAC_LTE_UE_POOL_SIZE);
+    mac_lte_ue_parameters = g_new0(ue_parameters_t *, MAC_LTE_UE_POOL_SIZE);
+
     mac_lte_cr_result_hash = g_hash_table_new(g_direct_hash, g_direct_equal);
     mac_lte_msg3_cr_hash = g_hash_table_new(g_direct_hash, g_direct_equal);
-    mac_lte_dl_harq_hash = g_hash_table_new(g_direct_hash, g_direct_equal);
     mac_lte_dl_harq_result_hash = g_hash_table_new(g_direct_hash, g_direct_equal);
-    mac_lte_ul_harq_hash = g_hash_table_new(g_direct_hash, g_direct_equal);
     mac_lte_ul_harq_result_hash = g_hash_table_new(g_direct_hash, g_direct_equal);
-    mac_lte_ue_sr_state = g_hash_table_new(g_direct_hash, g_direct_equal);
     mac_lte_sr_request_hash = g_hash_table_new(g_direct_hash, g_direct_equal);
     mac_lte_tti_info_result_hash = g_hash_table_new(g_direct_hash, g_direct_equal);
-    mac_lte_ue_channels_hash = g_hash_table_new(g_direct_hash, g_direct_equal);
-    mac_lte_ue_parameters = g_hash_table_new(g_direct_hash, g_direct_equal);
     mac_lte_drx_frame_result = g_hash_table_new(mac_lte_framenum_instance_hash_func, mac_lte_framenum_instance_hash_equal);
 
     /* Forget this setting */
@@ -7652,18 +7684,19 @@ static void mac_lte_init_protocol(void)
 
 static void mac_lte_cleanup_protocol(void)
 {
-    g_hash_table_destroy(mac_lte_msg3_hash);
+    g_free(mac_lte_msg3_data);
+    g_free(mac_lte_dl_harq_buffers);
+    g_free(mac_lte_ul_harq_buffers);
+    g_free(mac_lte_ue_sr_state);
+    g_free(mac_lte_ue_channels);
+    g_free(mac_lte_ue_parameters);
+
     g_hash_table_destroy(mac_lte_cr_result_hash);
     g_hash_table_destroy(mac_lte_msg3_cr_hash);
-    g_hash_table_destroy(mac_lte_dl_harq_hash);
     g_hash_table_destroy(mac_lte_dl_harq_result_hash);
-    g_hash_table_destroy(mac_lte_ul_harq_hash);
     g_hash_table_destroy(mac_lte_ul_harq_result_hash);
-    g_hash_table_destroy(mac_lte_ue_sr_state);
     g_hash_table_destroy(mac_lte_sr_request_hash);
     g_hash_table_destroy(mac_lte_tti_info_result_hash);
-    g_hash_table_destroy(mac_lte_ue_channels_hash);
-    g_hash_table_destroy(mac_lte_ue_parameters);
     g_hash_table_destroy(mac_lte_drx_frame_result);
 }
 
@@ -7702,14 +7735,11 @@ void set_mac_lte_channel_mapping(drb_mapping_t *drb_mapping)
     }
 
     /* Look for existing UE entry */
-    ue_mappings = (ue_dynamic_drb_mappings_t *)g_hash_table_lookup(mac_lte_ue_channels_hash,
-                                                                   GUINT_TO_POINTER((guint)drb_mapping->ueid));
+    ue_mappings = mac_lte_ue_channels[drb_mapping->ueid];
     if (!ue_mappings) {
         /* If not found, create & add to table */
         ue_mappings = wmem_new0(wmem_file_scope(), ue_dynamic_drb_mappings_t);
-        g_hash_table_insert(mac_lte_ue_channels_hash,
-                            GUINT_TO_POINTER((guint)drb_mapping->ueid),
-                            ue_mappings);
+        mac_lte_ue_channels[drb_mapping->ueid] = ue_mappings;
     }
 
     /* If lcid wasn't supplied, need to try to look up from drbid */
@@ -7820,7 +7850,7 @@ static guint8 get_mac_lte_channel_priority(guint16 ueid, guint8 lcid,
     }
 
     /* Look up the mappings for this UE */
-    ue_mappings = (ue_dynamic_drb_mappings_t *)g_hash_table_lookup(mac_lte_ue_channels_hash, GUINT_TO_POINTER((guint)ueid));
+    ue_mappings = mac_lte_ue_channels[ueid];
     if (!ue_mappings) {
         return 0;
     }
@@ -7842,10 +7872,10 @@ void set_mac_lte_drx_config(guint16 ueid, drx_config_t *drx_config, packet_info
         guint32 previousFrameNum = 0;
 
         /* Find or create config struct for this UE */
-        ue_params = (ue_parameters_t *)g_hash_table_lookup(mac_lte_ue_parameters, GUINT_TO_POINTER((guint)ueid));
+        ue_params = mac_lte_ue_parameters[ueid];
         if (ue_params == NULL) {
             ue_params = (ue_parameters_t *)wmem_new0(wmem_file_scope(), ue_parameters_t);
-            g_hash_table_insert(mac_lte_ue_parameters, GUINT_TO_POINTER((guint)ueid), ue_params);
+            mac_lte_ue_parameters[ueid] = ue_params;
         }
         else {
             previousFrameNum = ue_params->drx_state.config.frameNum;
@@ -7872,7 +7902,7 @@ void set_mac_lte_drx_config_release(guint16 ueid, packet_info *pinfo)
         ue_parameters_t *ue_params;
 
         /* Find or create config struct for this UE */
-        ue_params = (ue_parameters_t *)g_hash_table_lookup(mac_lte_ue_parameters, GUINT_TO_POINTER((guint)ueid));
+        ue_params = mac_lte_ue_parameters[ueid];
         if (ue_params != NULL) {
             ue_params->drx_state_valid = FALSE;
         }
@@ -7896,10 +7926,10 @@ void set_mac_lte_extended_bsr_sizes(guint16 ueid, gboolean use_ext_bsr_sizes, pa
         ue_parameters_t *ue_params;
 
         /* Find or create config struct for this UE */
-        ue_params = (ue_parameters_t *)g_hash_table_lookup(mac_lte_ue_parameters, GUINT_TO_POINTER((guint)ueid));
+        ue_params = mac_lte_ue_parameters[ueid];
         if (ue_params == NULL) {
             ue_params = (ue_parameters_t *)wmem_new0(wmem_file_scope(), ue_parameters_t);
-            g_hash_table_insert(mac_lte_ue_parameters, GUINT_TO_POINTER((guint)ueid), ue_params);
+            mac_lte_ue_parameters[ueid] = ue_params;
         }
 
         ue_params->use_ext_bsr_sizes = use_ext_bsr_sizes;
@@ -7913,10 +7943,10 @@ void set_mac_lte_simult_pucch_pusch(guint16 ueid, simult_pucch_pusch_cell_type c
         ue_parameters_t *ue_params;
 
         /* Find or create config struct for this UE */
-        ue_params = (ue_parameters_t *)g_hash_table_lookup(mac_lte_ue_parameters, GUINT_TO_POINTER((guint)ueid));
+        ue_params = mac_lte_ue_parameters[ueid];
         if (ue_params == NULL) {
             ue_params = (ue_parameters_t *)wmem_new0(wmem_file_scope(), ue_parameters_t);
-            g_hash_table_insert(mac_lte_ue_parameters, GUINT_TO_POINTER((guint)ueid), ue_params);
+            mac_lte_ue_parameters[ueid] = ue_params;
         }
 
         if (cell_type == SIMULT_PUCCH_PUSCH_PCELL) {
@@ -10052,6 +10082,13 @@ void proto_register_mac_lte(void)
         "Add as a generated field the middle of the range indicated by the BSR index",
         &global_mac_lte_show_BSR_median);
 
+    prefs_register_bool_preference(mac_lte_module, "counters_only",
+        "Counters-only decoding (bulk statistics)",
+        "Parse MAC headers and feed the statistics tap, but skip the per-PDU "
+        "Msg3/CR, SR, HARQ and DRX analysis and don't call subdissectors for "
+        "SDUs.  Speeds up statistics runs over very large captures",
+        &global_mac_lte_counters_only);
+
     register_init_routine(&mac_lte_init_protocol);
     register_cleanup_routine(&mac_lte_cleanup_protocol);
 }
@@ -186,6 +186,7 @@ static gboolean mbrtu_crc = FALSE;
 
 /* Globals for Modbus Preferences */
 static gint global_mbus_register_format = MODBUS_PREF_REGISTER_FORMAT_UINT16;
+static guint global_mbus_max_requests = 64; /* Outstanding requests tracked per conversation */
 
 typedef struct {
     guint8  function_code;
@@ -1552,6 +1553,17 @@ dissect_modbus_response(tvbuff_t *tvb, packet_info *pinfo, proto_tree *modbus_tr
 }
 
 
+/* Extra match for request tracking.  The transaction and unit id form the
+   tracker key; the request's function code has to agree with the response's
+   as well. */
+static gboolean
+modbus_request_matches(const void *entry_data, const void *user_data)
+{
+    const modbus_request_info_t *request_data = (const modbus_request_info_t *)entry_data;
+
+    return request_data->function_code == *(const guint8 *)user_data;
+}
+
 /* Dissect the Modbus Payload.  Called from either Modbus/TCP or Modbus RTU Dissector */
 static int
 dissect_modbus(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
@@ -1596,7 +1608,8 @@ dissect_modbus(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
 
         if (modbus_conv_data == NULL){
            modbus_conv_data = wmem_new(wmem_file_scope(), modbus_conversation);
-           modbus_conv_data->modbus_request_frame_data = wmem_list_new(wmem_file_scope());
+           modbus_conv_data->requests = request_track_new(wmem_file_scope(),
+                sizeof(modbus_request_info_t), global_mbus_max_requests);
            modbus_conv_data->register_format = global_mbus_register_format;
            conversation_add_proto_data(conversation, proto_modbus, (void *)modbus_conv_data);
         }
@@ -1604,53 +1617,38 @@ dissect_modbus(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
         pkt_info->register_format = modbus_conv_data->register_format;
 
         if (modbus_data->packet_type == QUERY_PACKET) {
-            /*create the modbus_request frame. It holds the request information.*/
-            modbus_request_info_t    *frame_ptr = wmem_new0(wmem_file_scope(), modbus_request_info_t);
+            /* Record the request; if too many are outstanding the tracker
+               recycles its oldest entry, so unanswered requests can't grow
+               the conversation's state without bound. */
+            modbus_request_info_t    *frame_ptr = (modbus_request_info_t *)
+                request_track_add(modbus_conv_data->requests, conv_key, pinfo->num);
             gint captured_length = tvb_captured_length(tvb);
 
             /* load information into the modbus request frame */
             frame_ptr->fnum = pinfo->num;
             frame_ptr->function_code = function_code;
-            frame_ptr->mbtcp_transid = modbus_data->mbtcp_transid;
-            frame_ptr->unit_id = modbus_data->unit_id;
             if (captured_length >= 3) {
                 pkt_info->reg_base = frame_ptr->base_address = tvb_get_ntohs(tvb, 1);
                 if (captured_length >= 5)
                     pkt_info->num_reg = frame_ptr->num_reg = tvb_get_ntohs(tvb, 3);
             }
             frame_ptr->req_time = pinfo->abs_ts;
-
-            wmem_list_prepend(modbus_conv_data->modbus_request_frame_data, frame_ptr);
         }
         else if (modbus_data->packet_type == RESPONSE_PACKET) {
-            guint8                req_function_code;
-            guint16               req_transaction_id;
-            guint8                req_unit_id;
-            guint32               req_frame_num;
-            modbus_request_info_t *request_data;
-
-            wmem_list_frame_t *frame = wmem_list_head(modbus_conv_data->modbus_request_frame_data);
-            /* Step backward through all logged instances of request frames, looking for a request frame number that
-            occurred immediately prior to current frame number that has a matching function code,
-            unit-id and transaction identifier */
-            while (frame && !pkt_info->request_found) {
-                request_data = (modbus_request_info_t *)wmem_list_frame_data(frame);
-                req_frame_num = request_data->fnum;
-                req_function_code = request_data->function_code;
-                req_transaction_id = request_data->mbtcp_transid;
-                req_unit_id = request_data->unit_id;
-                if ((pinfo->num > req_frame_num) && (req_function_code == function_code) &&
-                    (req_transaction_id == modbus_data->mbtcp_transid) && (req_unit_id == modbus_data->unit_id)) {
-                    pkt_info->reg_base = request_data->base_address;
-                    pkt_info->num_reg = request_data->num_reg;
-                    pkt_info->request_found = TRUE;
-                    pkt_info->req_frame_num = req_frame_num;
-                    pkt_info->req_time = request_data->req_time;
-                }
-                frame = wmem_list_frame_next(frame);
+            /* Find the most recent request from a prior frame with matching
+               transaction identifier and unit-id (the tracker key) and
+               matching function code */
+            modbus_request_info_t *request_data = (modbus_request_info_t *)
+                request_track_find(modbus_conv_data->requests, conv_key,
+                    pinfo->num, modbus_request_matches, &function_code);
+
+            if (request_data != NULL) {
+                pkt_info->reg_base = request_data->base_address;
+                pkt_info->num_reg = request_data->num_reg;
+                pkt_info->request_found = TRUE;
+                pkt_info->req_frame_num = request_data->fnum;
+                pkt_info->req_time = request_data->req_time;
             }
-
-
         }
         p_add_proto_data(wmem_file_scope(), pinfo, proto_modbus, conv_key, pkt_info);
 
@@ -2208,6 +2206,16 @@ proto_register_modbus(void)
                                     mbus_register_format,
                                     FALSE);
 
+    /* Modbus Preference - cap on tracked outstanding requests, bounding
+       per-conversation memory on captures where responses never arrive */
+    prefs_register_uint_preference(modbus_module, "max_tracked_requests",
+                                    "Maximum tracked requests per conversation",
+                                    "Maximum number of outstanding requests remembered for"
+                                    " request/response matching; the oldest request is forgotten"
+                                    " when more than this many are unanswered",
+                                    10,
+                                    &global_mbus_max_requests);
+
     /* Obsolete Preferences */
     prefs_register_obsolete_preference(mbtcp_module, "mbus_register_addr_type");
     prefs_register_obsolete_preference(mbtcp_module, "mbus_register_format");
@@ -13,6 +13,8 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later
  */
+#include <epan/request_track.h>
+
 #define PORT_MBTCP        502    /* Modbus/TCP located on port 502, with IANA registration */
 #define PORT_MBTLS        802    /* Modbus/TCP Security protocol (Modbus/TCP over TLS) is registered on port 802 */
 #define PORT_MBRTU        0    /* Modbus RTU over TCP does not have a standard port, default to zero */
@@ -96,8 +98,6 @@
 typedef struct {
     guint32 fnum;
     guint8  function_code;
-    guint16 mbtcp_transid;
-    guint8  unit_id;
     guint16 base_address;
     guint16 num_reg;
     nstime_t req_time;
@@ -109,10 +109,10 @@ typedef struct {
     guint8  unit_id;            /* Set to zero if not available */
 } modbus_data_t;
 
-/* List contains request data  */
+/* Bounded tracker of outstanding requests, keyed by transaction/unit id */
 typedef struct {
-    wmem_list_t *modbus_request_frame_data;
-    gint        register_format;
+    request_track_t *requests;
+    gint            register_format;
 } modbus_conversation;
 
 /*
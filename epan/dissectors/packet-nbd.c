@@ -458,7 +458,13 @@ void proto_register_nbd(void)
 void
 proto_reg_handoff_nbd(void)
 {
+	static const guint8 nbd_request_magic[]  = { 0x25, 0x60, 0x95, 0x13 };
+	static const guint8 nbd_response_magic[] = { 0x67, 0x44, 0x66, 0x98 };
+
 	heur_dissector_add("tcp", dissect_nbd_tcp_heur, "NBD over TCP", "nbd_tcp", proto_nbd, HEURISTIC_ENABLE);
+	/* dissect_nbd_tcp_heur() requires one of the NBD magic numbers. */
+	heur_dissector_add_signature("nbd_tcp", 0, nbd_request_magic, sizeof nbd_request_magic);
+	heur_dissector_add_signature("nbd_tcp", 0, nbd_response_magic, sizeof nbd_response_magic);
 }
 
 /*
@@ -681,9 +681,14 @@ void
 proto_reg_handoff_pathport(void)
 {
     static dissector_handle_t pathport_handle;
+    static const guint8 pathport_proto_magic[] = {
+        (PATHPORT_PROTO_MAGIC >> 8) & 0xff, PATHPORT_PROTO_MAGIC & 0xff
+    };
 
     pathport_handle = create_dissector_handle(dissect_pathport, proto_pathport);
     heur_dissector_add("udp", dissect_pathport_heur, "Pathport over UDP", "pathport_udp", proto_pathport, HEURISTIC_ENABLE);
+    /* packet_is_pathport() requires the protocol magic up front. */
+    heur_dissector_add_signature("pathport_udp", 0, pathport_proto_magic, sizeof pathport_proto_magic);
     dissector_add_uint_with_preference("udp.port", PATHPORT_UDP_PORT, pathport_handle);
 }
 
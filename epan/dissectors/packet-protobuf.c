@@ -172,6 +172,20 @@ static GHashTable *pbf_hf_hash = NULL;
  */
 static dissector_table_t protobuf_field_subdissector_table;
 
+/* Dispatch info of a field resolved once and reused for every value of
+ * that field, so dissecting a value does not repeat the string-keyed
+ * subdissector and header field lookups. The key is the field
+ * descriptor pointer; the cache is dropped whenever the descriptor pool
+ * or the dynamic header fields are rebuilt, and at the start of each
+ * dissection pass (subdissector registrations may have changed).
+ */
+typedef struct {
+    dissector_handle_t field_dissector;
+    int               *hf_id_ptr;
+} pbf_field_dispatch_t;
+
+static GHashTable *pbf_dispatch_hash = NULL;
+
 static dissector_handle_t protobuf_handle;
 
 /* store varint tvb info */
@@ -499,16 +513,36 @@ protobuf_dissect_field_value(proto_tree *value_tree, tvbuff_t *tvb, guint offset
     const PbwDescriptor* sub_message_desc = NULL;
     const PbwEnumDescriptor* enum_desc = NULL;
     int* hf_id_ptr = NULL;
-    const gchar* field_full_name = field_desc ? pbw_FieldDescriptor_full_name(field_desc) : NULL;
     proto_tree* field_tree = proto_item_get_subtree(ti_field);
     proto_tree* field_parent_tree = proto_tree_get_parent_tree(field_tree);
     proto_tree* pbf_tree = field_tree;
     nstime_t timestamp = { 0 };
-    dissector_handle_t field_dissector = field_full_name ? dissector_get_string_handle(protobuf_field_subdissector_table, field_full_name) : NULL;
+    dissector_handle_t field_dissector = NULL;
+
+    if (field_desc) {
+        pbf_field_dispatch_t* dispatch;
+
+        if (pbf_dispatch_hash == NULL) {
+            pbf_dispatch_hash = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+        }
+
+        dispatch = (pbf_field_dispatch_t*)g_hash_table_lookup(pbf_dispatch_hash, field_desc);
+        if (dispatch == NULL) {
+            const gchar* field_full_name = pbw_FieldDescriptor_full_name(field_desc);
+
+            dispatch = g_new0(pbf_field_dispatch_t, 1);
+            dispatch->field_dissector = dissector_get_string_handle(protobuf_field_subdissector_table, field_full_name);
+            if (pbf_as_hf) {
+                dispatch->hf_id_ptr = (int*)g_hash_table_lookup(pbf_hf_hash, field_full_name);
+                DISSECTOR_ASSERT_HINT(dispatch->hf_id_ptr && (*dispatch->hf_id_ptr) > 0, "hf must have been initialized properly");
+            }
+            g_hash_table_insert(pbf_dispatch_hash, (gpointer)field_desc, dispatch);
+        }
 
-    if (pbf_as_hf && field_full_name) {
-        hf_id_ptr = (int*)g_hash_table_lookup(pbf_hf_hash, field_full_name);
-        DISSECTOR_ASSERT_HINT(hf_id_ptr && (*hf_id_ptr) > 0, "hf must have been initialized properly");
+        field_dissector = dispatch->field_dissector;
+        if (pbf_as_hf) {
+            hf_id_ptr = dispatch->hf_id_ptr;
+        }
     }
 
     if (pbf_as_hf && hf_id_ptr && !show_details) {
@@ -1512,9 +1546,20 @@ update_protobuf_udp_message_types(void)
     protobuf_reinit(PREFS_UPDATE_PROTOBUF_UDP_MESSAGE_TYPES);
 }
 
+static void
+clear_field_dispatch_cache(void)
+{
+    if (pbf_dispatch_hash) {
+        g_hash_table_destroy(pbf_dispatch_hash);
+        pbf_dispatch_hash = NULL;
+    }
+}
+
 static void
 deregister_header_fields(void)
 {
+    clear_field_dispatch_cache();
+
     if (dynamic_hf) {
         /* Deregister all fields */
         for (guint i = 0; i < dynamic_hf_size; i++) {
@@ -2069,6 +2114,10 @@ proto_register_protobuf(void)
     expert_register_field_array(expert_protobuf, ei, array_length(ei));
 
     protobuf_handle = register_dissector("protobuf", dissect_protobuf, proto_protobuf);
+
+    /* clear the dispatch cache at the start of each dissection pass;
+       subdissector registrations may have changed in between */
+    register_init_routine(clear_field_dispatch_cache);
 }
 
 void
@@ -372,6 +372,7 @@ typedef struct quic_info_data {
     quic_cid_item_t client_cids;    /**< SCID of client from first Initial Packet. */
     quic_cid_item_t server_cids;    /**< SCID of server from first Retry/Handshake. */
     quic_cid_t      client_dcid_initial;    /**< DCID from Initial Packet. */
+    quic_cid_t      initial_decoders_cid;   /**< DCID the Initial ciphers were derived from (all zeroes if not yet derived). */
     dissector_handle_t app_handle;  /**< Application protocol handle (NULL if unknown). */
     wmem_map_t     *client_streams; /**< Map from Stream ID -> STREAM info (guint64 -> quic_stream_state), sent by the client. */
     wmem_map_t     *server_streams; /**< Map from Stream ID -> STREAM info (guint64 -> quic_stream_state), sent by the server. */
@@ -2525,9 +2526,15 @@ quic_create_initial_decoders(const quic_cid_t *cid, const gchar **error, quic_in
                               GCRY_CIPHER_AES128, GCRY_CIPHER_MODE_GCM, client_secret, error) ||
         !quic_ciphers_prepare(&quic_info->server_initial_ciphers, GCRY_MD_SHA256,
                               GCRY_CIPHER_AES128, GCRY_CIPHER_MODE_GCM, server_secret, error)) {
+        memset(&quic_info->initial_decoders_cid, 0, sizeof(quic_cid_t));
         return FALSE;
     }
 
+    /* Remember the source CID so that retransmitted or coalesced Initial
+     * packets do not re-run the key derivation. A Retry changes the DCID
+     * and with it the derived secrets, so keying on the CID handles that. */
+    memcpy(&quic_info->initial_decoders_cid, cid, sizeof(quic_cid_t));
+
     return TRUE;
 }
 
@@ -3139,8 +3146,11 @@ dissect_quic_long_header(tvbuff_t *tvb, packet_info *pinfo, proto_tree *quic_tre
         if (long_packet_type == QUIC_LPT_INITIAL && !from_server &&
             !memcmp(&dcid, &conn->client_dcid_initial, sizeof(quic_cid_t))) {
             /* Create new decryption context based on the Client Connection
-             * ID from the *very first* Client Initial packet. */
-            quic_create_initial_decoders(&dcid, &error, conn);
+             * ID from the *very first* Client Initial packet, unless the
+             * ciphers were already derived from this very CID. */
+            if (memcmp(&dcid, &conn->initial_decoders_cid, sizeof(quic_cid_t)) != 0) {
+                quic_create_initial_decoders(&dcid, &error, conn);
+            }
         } else if (long_packet_type == QUIC_LPT_0RTT) {
             early_data_secret_len = tls13_get_quic_secret(pinfo, FALSE, TLS_SECRET_0RTT_APP, DIGEST_MIN_SIZE, DIGEST_MAX_SIZE, early_data_secret);
             if (early_data_secret_len == 0) {
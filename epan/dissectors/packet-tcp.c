@@ -644,6 +644,15 @@ static dissector_handle_t tcp_opt_unknown_handle;
 static guint32 tcp_stream_count;
 static guint32 mptcp_stream_count;
 
+/* Follow Stream index, built during the first pass when the
+ * "tcp.follow_index" preference is enabled: maps a stream id to the
+ * ordered frame numbers of the stream's data segments, so Follow TCP
+ * Stream can dissect exactly those frames instead of retapping the
+ * whole file. Lives in file scope; the pointer is cleared in
+ * tcp_init(). */
+static gboolean tcp_follow_index_enabled = FALSE;
+static wmem_map_t *tcp_follow_index_map;
+
 
 
 /*
@@ -1461,6 +1470,8 @@ static void conversation_completeness_fill(gchar *buf, guint32 value)
  * RTT, relative sequence numbers, window scaling & etc.
  * **************************************************************************/
 static gboolean tcp_analyze_seq           = TRUE;
+static guint    tcp_analyze_seq_sample_period = 1;
+static gboolean tcp_deterministic_stream_ids = FALSE;
 static gboolean tcp_relative_seq          = TRUE;
 static gboolean tcp_track_bytes_in_flight = TRUE;
 static gboolean tcp_bif_seq_based         = FALSE;
@@ -1550,6 +1561,29 @@ process_tcp_payload(tvbuff_t *tvb, volatile int offset, packet_info *pinfo,
     struct tcp_analysis *tcpd, struct tcpinfo *tcpinfo);
 
 
+/* Deterministic stream id: a direction-independent hash of the 5-tuple
+ * plus the flow's first-seen timestamp.  Unlike the arrival-order
+ * counter, this doesn't depend on which other streams happen to be in
+ * the capture, so ids survive filtering a capture down to a subset of
+ * its streams and can be used to partition streams across independent
+ * workers.  Colliding flows would share an id, but the id is only a
+ * label; the conversation machinery still keeps their analysis state
+ * separate.
+ */
+static guint32
+tcp_deterministic_stream_id(packet_info *pinfo)
+{
+    guint hash;
+
+    hash = add_address_to_hash(0, &pinfo->src) +
+           add_address_to_hash(0, &pinfo->dst) +
+           pinfo->srcport + pinfo->destport;
+    hash ^= (guint)pinfo->abs_ts.secs;
+    hash ^= (guint)pinfo->abs_ts.nsecs << 1;
+
+    return hash;
+}
+
 static struct tcp_analysis *
 init_tcp_conversation_data(packet_info *pinfo)
 {
@@ -1565,8 +1599,12 @@ init_tcp_conversation_data(packet_info *pinfo)
     tcpd->flow2.win_scale=-1;
     tcpd->flow2.multisegment_pdus=wmem_tree_new(wmem_file_scope());
 
-    /* Only allocate the data if its actually going to be analyzed */
-    if (tcp_analyze_seq)
+    /* Only allocate the data if its actually going to be analyzed;
+     * when the user asked for only every Nth stream to be analyzed
+     * (tcp.analyze_sequence_sample_period), unsampled streams get no
+     * analysis state at all. */
+    if (tcp_analyze_seq && (tcp_analyze_seq_sample_period <= 1 ||
+        tcp_stream_count % tcp_analyze_seq_sample_period == 0))
     {
         tcpd->flow1.tcp_analyze_seq_info = wmem_new0(wmem_file_scope(), struct tcp_analyze_seq_flow_info_t);
         tcpd->flow2.tcp_analyze_seq_info = wmem_new0(wmem_file_scope(), struct tcp_analyze_seq_flow_info_t);
@@ -1593,7 +1631,11 @@ init_tcp_conversation_data(packet_info *pinfo)
     tcpd->flow2.push_set_last = FALSE;
     tcpd->flow1.closing_initiator = FALSE;
     tcpd->flow2.closing_initiator = FALSE;
-    tcpd->stream = tcp_stream_count++;
+    if (tcp_deterministic_stream_ids)
+        tcpd->stream = tcp_deterministic_stream_id(pinfo);
+    else
+        tcpd->stream = tcp_stream_count;
+    tcp_stream_count++;
     tcpd->server_port = 0;
 
     return tcpd;
@@ -1722,6 +1764,38 @@ guint32 get_tcp_stream_count(void)
     return tcp_stream_count;
 }
 
+static void
+tcp_follow_index_add(guint32 stream, guint32 frame)
+{
+    wmem_array_t *frames;
+
+    if (tcp_follow_index_map == NULL) {
+        tcp_follow_index_map = wmem_map_new(wmem_file_scope(),
+            g_direct_hash, g_direct_equal);
+    }
+    frames = (wmem_array_t *)wmem_map_lookup(tcp_follow_index_map,
+        GUINT_TO_POINTER(stream));
+    if (frames == NULL) {
+        frames = wmem_array_new(wmem_file_scope(), sizeof(guint32));
+        wmem_map_insert(tcp_follow_index_map, GUINT_TO_POINTER(stream), frames);
+    }
+    wmem_array_append_one(frames, frame);
+}
+
+const guint32 *get_tcp_follow_index_frames(guint32 stream, guint *count)
+{
+    wmem_array_t *frames;
+
+    if (!tcp_follow_index_enabled || tcp_follow_index_map == NULL)
+        return NULL;
+    frames = (wmem_array_t *)wmem_map_lookup(tcp_follow_index_map,
+        GUINT_TO_POINTER(stream));
+    if (frames == NULL || wmem_array_get_count(frames) == 0)
+        return NULL;
+    *count = wmem_array_get_count(frames);
+    return (const guint32 *)wmem_array_get_raw(frames);
+}
+
 /* Return the mptcp current stream count */
 guint32 get_mptcp_stream_count(void)
 {
@@ -1891,6 +1965,23 @@ pdu_store_sequencenumber_of_next_pdu(packet_info *pinfo, guint32 seq, guint32 nx
     return msp;
 }
 
+/* Same as above for MSPs stored on a TCP flow; additionally maintains the
+ * flow's cache of the MSP with the highest starting sequence number, which
+ * lets desegment_tcp() skip the tree lookups for in-order segments.
+ */
+static struct tcp_multisegment_pdu *
+pdu_store_sequencenumber_of_next_pdu_for_flow(packet_info *pinfo, guint32 seq, guint32 nxtpdu, tcp_flow_t *flow)
+{
+    struct tcp_multisegment_pdu *msp;
+
+    msp = pdu_store_sequencenumber_of_next_pdu(pinfo, seq, nxtpdu, flow->multisegment_pdus);
+    /* Plain unsigned comparison, mirroring the tree's key order. */
+    if (!flow->last_msp || msp->seq >= flow->last_msp->seq) {
+        flow->last_msp = msp;
+    }
+    return msp;
+}
+
 /* This is called for SYN and SYN+ACK packets and the purpose is to verify
  * that we have seen window scaling in both directions.
  * If we can't find window scaling being set in both directions
@@ -1979,6 +2070,37 @@ tcp_analyze_get_acked_struct(guint32 frame, guint32 seq, guint32 ack, gboolean c
 }
 
 
+/* Get a node for the unacked-segment list.  Recycled and inline nodes
+ * (see TCP_INLINE_UNACKED_SEGMENTS) cover the common case; only flows
+ * with many segments in flight hit the allocator.
+ */
+static tcp_unacked_t *
+tcp_unacked_new(tcp_analyze_seq_flow_info_t *seq_info)
+{
+    tcp_unacked_t *ual;
+
+    if (seq_info->free_segments) {
+        ual = seq_info->free_segments;
+        seq_info->free_segments = ual->next;
+    } else if (seq_info->inline_used < TCP_INLINE_UNACKED_SEGMENTS) {
+        ual = &seq_info->inline_segments[seq_info->inline_used++];
+    } else {
+        ual = wmem_new(wmem_file_scope(), tcp_unacked_t);
+    }
+    return ual;
+}
+
+/* Return an acked node to the flow's free list.  Nodes are never handed
+ * back to the allocator individually - inline nodes can't be, and the
+ * others are file scoped - they're kept for the next segment instead.
+ */
+static void
+tcp_unacked_recycle(tcp_analyze_seq_flow_info_t *seq_info, tcp_unacked_t *ual)
+{
+    ual->next = seq_info->free_segments;
+    seq_info->free_segments = ual;
+}
+
 /* fwd contains a list of all segments processed but not yet ACKed in the
  *     same direction as the current segment.
  * rev contains a list of all segments received but not yet ACKed in the
@@ -2052,6 +2174,14 @@ tcp_analyze_sequence_number(packet_info *pinfo, guint32 seq, guint32 ack, guint3
         tcpd->rev->valid_bif = 1;
     }
 
+    /* An unsampled stream (tcp.analyze_sequence_sample_period) has no
+     * analysis state; the base seq tracking above is all we do for it,
+     * so that relative sequence numbers keep working.
+     */
+    if(!tcpd->fwd->tcp_analyze_seq_info) {
+        return;
+    }
+
     /* ZERO WINDOW PROBE
      * it is a zero window probe if
      *  the sequence number is the next expected one
@@ -2380,7 +2510,7 @@ finished_checking_retransmission_type:
         /* Add this new sequence number to the fwd list.  But only if there
          * aren't "too many" unacked segments (e.g., we're not seeing the ACKs).
          */
-        ual = wmem_new(wmem_file_scope(), tcp_unacked_t);
+        ual = tcp_unacked_new(tcpd->fwd->tcp_analyze_seq_info);
         ual->next=tcpd->fwd->tcp_analyze_seq_info->segments;
         tcpd->fwd->tcp_analyze_seq_info->segments=ual;
         tcpd->fwd->tcp_analyze_seq_info->segment_count++;
@@ -2483,7 +2613,7 @@ finished_checking_retransmission_type:
         else{
             prevual->next = tmpual;
         }
-        wmem_free(wmem_file_scope(), ual);
+        tcp_unacked_recycle(tcpd->rev->tcp_analyze_seq_info, ual);
         ual = tmpual;
         tcpd->rev->tcp_analyze_seq_info->segment_count--;
     }
@@ -3377,7 +3507,14 @@ again:
          * Only shortcircuit here when the first segment of the MSP is known,
          * and when this this first segment is not one to complete the MSP.
          */
-        if ((msp = (struct tcp_multisegment_pdu *)wmem_tree_lookup32(tcpd->fwd->multisegment_pdus, seq)) &&
+        /* In the in-order common case the segment belongs to the most
+         * recently stored MSP, so try the flow's cache before the tree.
+         */
+        msp = tcpd->fwd->last_msp;
+        if (!(msp && msp->seq == seq)) {
+            msp = (struct tcp_multisegment_pdu *)wmem_tree_lookup32(tcpd->fwd->multisegment_pdus, seq);
+        }
+        if (msp &&
                 nxtseq <= msp->nxtpdu &&
                 !(msp->flags & MSP_FLAGS_MISSING_FIRST_SEGMENT) && msp->last_frame != pinfo->num) {
             const char* str;
@@ -3463,7 +3600,14 @@ again:
         }
         /* Else, find the most previous PDU starting before this sequence number */
         if (!msp) {
-            msp = (struct tcp_multisegment_pdu *)wmem_tree_lookup32_le(tcpd->fwd->multisegment_pdus, seq-1);
+            /* The cache holds the MSP with the highest starting sequence
+             * number; if that starts before this segment it's the answer,
+             * saving the tree lookup.
+             */
+            msp = tcpd->fwd->last_msp;
+            if (!(msp && msp->seq <= seq-1)) {
+                msp = (struct tcp_multisegment_pdu *)wmem_tree_lookup32_le(tcpd->fwd->multisegment_pdus, seq-1);
+            }
         }
     }
 
@@ -3507,9 +3651,9 @@ again:
                  * Create a new one starting at the expected next position and
                  * extend it to the end of the new segment.
                  */
-                msp = pdu_store_sequencenumber_of_next_pdu(pinfo,
+                msp = pdu_store_sequencenumber_of_next_pdu_for_flow(pinfo,
                     tcpd->fwd->maxnextseq, nxtseq,
-                    tcpd->fwd->multisegment_pdus);
+                    tcpd->fwd);
 
                 msp->flags |= MSP_FLAGS_MISSING_FIRST_SEGMENT;
             }
@@ -3870,8 +4014,8 @@ again:
                  * but set this msp flag so we can pick it up
                  * above.
                  */
-                msp = pdu_store_sequencenumber_of_next_pdu(pinfo, deseg_seq,
-                    nxtseq+1, tcpd->fwd->multisegment_pdus);
+                msp = pdu_store_sequencenumber_of_next_pdu_for_flow(pinfo, deseg_seq,
+                    nxtseq+1, tcpd->fwd);
                 msp->flags |= MSP_FLAGS_REASSEMBLE_ENTIRE_SEGMENT;
             } else if (pinfo->desegment_len == DESEGMENT_UNTIL_FIN) {
                 /*
@@ -3886,11 +4030,11 @@ again:
                  * than the largest possible stream size. Hopefully 1GiB
                  * (0x40000000 bytes) should be enough.
                  */
-                msp = pdu_store_sequencenumber_of_next_pdu(pinfo, deseg_seq,
-                    nxtseq+0x40000000, tcpd->fwd->multisegment_pdus);
+                msp = pdu_store_sequencenumber_of_next_pdu_for_flow(pinfo, deseg_seq,
+                    nxtseq+0x40000000, tcpd->fwd);
             } else {
-                msp = pdu_store_sequencenumber_of_next_pdu(pinfo,
-                    deseg_seq, nxtseq+pinfo->desegment_len, tcpd->fwd->multisegment_pdus);
+                msp = pdu_store_sequencenumber_of_next_pdu_for_flow(pinfo,
+                    deseg_seq, nxtseq+pinfo->desegment_len, tcpd->fwd);
             }
 
             /* add this segment as the first one for this new pdu */
@@ -6342,11 +6486,11 @@ process_tcp_payload(tvbuff_t *tvb, volatile int offset, packet_info *pinfo,
                 if(tcpd && (!pinfo->fd->visited) &&
                     tcp_analyze_seq && pinfo->want_pdu_tracking) {
                     if(seq || nxtseq) {
-                        pdu_store_sequencenumber_of_next_pdu(
+                        pdu_store_sequencenumber_of_next_pdu_for_flow(
                             pinfo,
                             seq,
                             nxtseq+pinfo->bytes_until_next_pdu,
-                            tcpd->fwd->multisegment_pdus);
+                            tcpd->fwd);
                     }
                 }
             }
@@ -6372,10 +6516,10 @@ process_tcp_payload(tvbuff_t *tvb, volatile int offset, packet_info *pinfo,
              */
             if(tcpd && (!pinfo->fd->visited) && tcp_analyze_seq && pinfo->want_pdu_tracking) {
                 if(seq || nxtseq) {
-                    pdu_store_sequencenumber_of_next_pdu(pinfo,
+                    pdu_store_sequencenumber_of_next_pdu_for_flow(pinfo,
                         seq,
                         nxtseq+pinfo->bytes_until_next_pdu,
-                        tcpd->fwd->multisegment_pdus);
+                        tcpd->fwd);
                 }
             }
         }
@@ -6482,6 +6626,7 @@ dissect_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
     gboolean    icmp_ip = FALSE;
     guint8     conversation_completeness = 0;
     gboolean   conversation_is_new = FALSE;
+    tvb_span_t tcp_span;
 
     tcph = wmem_new0(pinfo->pool, struct tcpheader);
     tcph->th_sport = tvb_get_ntohs(tvb, offset);
@@ -6541,13 +6686,20 @@ dissect_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
     p_add_proto_data(pinfo->pool, pinfo, hf_tcp_srcport, pinfo->curr_layer_num, GUINT_TO_POINTER(tcph->th_sport));
     p_add_proto_data(pinfo->pool, pinfo, hf_tcp_dstport, pinfo->curr_layer_num, GUINT_TO_POINTER(tcph->th_dport));
 
-    tcph->th_rawseq = tvb_get_ntohl(tvb, offset + 4);
+    /* Validate the rest of the fixed 20-byte header in one go; the field
+     * reads below are unchecked span accesses. A TCP header embedded in an
+     * ICMP error only carries the first 8 bytes, which is why the ports
+     * above are fetched individually: they're already set (and in the tree)
+     * when this throws for such packets. */
+    tvb_get_span(tvb, offset, 20, &tcp_span);
+
+    tcph->th_rawseq = tvb_span_get_ntohl(&tcp_span, 4);
     tcph->th_seq = tcph->th_rawseq;
-    tcph->th_rawack = tvb_get_ntohl(tvb, offset + 8);
+    tcph->th_rawack = tvb_span_get_ntohl(&tcp_span, 8);
     tcph->th_ack = tcph->th_rawack;
-    th_off_x2 = tvb_get_guint8(tvb, offset + 12);
-    tcpinfo.flags = tcph->th_flags = tvb_get_ntohs(tvb, offset + 12) & TH_MASK;
-    tcph->th_win = tvb_get_ntohs(tvb, offset + 14);
+    th_off_x2 = tvb_span_get_guint8(&tcp_span, 12);
+    tcpinfo.flags = tcph->th_flags = tvb_span_get_ntohs(&tcp_span, 12) & TH_MASK;
+    tcph->th_win = tvb_span_get_ntohs(&tcp_span, 14);
     real_window = tcph->th_win;
     tcph->th_hlen = hi_nibble(th_off_x2) * 4;  /* TCP header length, in bytes */
 
@@ -6854,7 +7006,7 @@ dissect_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
         }
     } else {
         /* Note if the ACK field is non-zero */
-        if (tvb_get_ntohl(tvb, offset+8) != 0) {
+        if (tvb_span_get_ntohl(&tcp_span, 8) != 0) {
             expert_add_info(pinfo, tf, &ei_tcp_ack_nonzero);
         }
     }
@@ -7002,7 +7154,7 @@ dissect_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
      * Assume, initially, that we can't desegment.
      */
     pinfo->can_desegment = 0;
-    th_sum = tvb_get_ntohs(tvb, offset + 16);
+    th_sum = tvb_span_get_ntohs(&tcp_span, 16);
     if (!pinfo->fragmented && tvb_bytes_exist(tvb, 0, reported_len)) {
         /* The packet isn't part of an un-reassembled fragmented datagram
            and isn't truncated.  This means we have all the data, and thus
@@ -7224,6 +7376,9 @@ dissect_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
     captured_length_remaining = tvb_captured_length_remaining(tvb, offset);
 
     if (tcph->th_have_seglen) {
+        if (tcp_follow_index_enabled && !pinfo->fd->visited && tcpd) {
+            tcp_follow_index_add(tcpd->stream, pinfo->num);
+        }
         if(have_tap_listener(tcp_follow_tap)) {
             tcp_follow_tap_data_t* follow_data = wmem_new0(pinfo->pool, tcp_follow_tap_data_t);
 
@@ -7367,6 +7522,7 @@ static void
 tcp_init(void)
 {
     tcp_stream_count = 0;
+    tcp_follow_index_map = NULL;
 
     /* MPTCP init */
     mptcp_stream_count = 0;
@@ -8407,6 +8563,21 @@ proto_register_tcp(void)
         "Analyze TCP sequence numbers",
         "Make the TCP dissector analyze TCP sequence numbers to find and flag segment retransmissions, missing segments and RTT",
         &tcp_analyze_seq);
+    prefs_register_uint_preference(tcp_module, "analyze_sequence_sample_period",
+        "Analyze every Nth stream only",
+        "Restrict TCP sequence number analysis to every Nth TCP stream. "
+        "The default of 1 analyzes every stream; larger values trade complete "
+        "analysis for faster loads of captures with very many streams. "
+        "This option has no effect if not used with \"Analyze TCP sequence numbers\". ",
+        10, &tcp_analyze_seq_sample_period);
+    prefs_register_bool_preference(tcp_module, "deterministic_stream_ids",
+        "Deterministic stream identifiers",
+        "Derive the TCP stream index from a hash of the connection's "
+        "addresses, ports and first-seen time instead of its arrival order. "
+        "Hashed indexes are stable when a capture is filtered down to a "
+        "subset of its streams and can be used to partition work by stream, "
+        "at the cost of no longer being small sequential numbers.",
+        &tcp_deterministic_stream_ids);
     prefs_register_bool_preference(tcp_module, "relative_sequence_numbers",
         "Relative sequence numbers (Requires \"Analyze TCP sequence numbers\")",
         "Make the TCP dissector use relative sequence numbers instead of absolute ones. "
@@ -8432,6 +8603,13 @@ proto_register_tcp(void)
         "Evaluate BiF on actual sequence numbers or use the historical method based on payloads (default). "
         "This option has no effect if not used with \"Track number of bytes in flight\". ",
         &tcp_bif_seq_based);
+    prefs_register_bool_preference(tcp_module, "follow_index",
+        "Build a Follow Stream index while the capture file loads",
+        "Record, per TCP stream, the frame numbers of its data segments during "
+        "the first pass. \"Follow TCP Stream\" then dissects exactly those "
+        "frames instead of rescanning the whole file, and leaves the main "
+        "display filter untouched. Costs a few bytes per data segment.",
+        &tcp_follow_index_enabled);
     prefs_register_bool_preference(tcp_module, "calculate_timestamps",
         "Calculate conversation timestamps",
         "Calculate timestamps relative to the first frame and the previous frame in the tcp conversation",
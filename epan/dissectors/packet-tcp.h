@@ -290,12 +290,23 @@ typedef enum {
 
 #define MPTCP_CHECKSUM_MASK                 0x80
 
+/* How many unacked-segment nodes are embedded in each flow's analysis
+ * state.  The typical flow keeps only a handful of segments in flight,
+ * so these cover the common case without per-segment allocations;
+ * pathological flows fall back to file-scope allocations, and acked
+ * nodes of either kind are recycled through a per-flow free list.
+ */
+#define TCP_INLINE_UNACKED_SEGMENTS 8
+
 /* Information in a flow that is only used when tcp_analyze_seq preference
  * is enabled, so save the memory when it isn't
  */
 typedef struct tcp_analyze_seq_flow_info_t {
 	tcp_unacked_t *segments;/* List of segments for which we haven't seen an ACK */
 	guint16 segment_count;	/* How many unacked segments we're currently storing */
+	tcp_unacked_t *free_segments;	/* Acked nodes kept for reuse */
+	guint8 inline_used;	/* How many inline_segments are handed out */
+	tcp_unacked_t inline_segments[TCP_INLINE_UNACKED_SEGMENTS];
     guint32 lastack;	/* Last seen ack for the reverse flow */
 	nstime_t lastacktime;	/* Time of the last ack packet */
 	guint32 lastnondupack;	/* frame number of last seen non dupack */
@@ -368,6 +379,14 @@ typedef struct _tcp_flow_t {
 	 */
 	wmem_tree_t *multisegment_pdus;
 
+	/* The entry in multisegment_pdus with the highest starting sequence
+	 * number (plain unsigned comparison, matching the tree's key order).
+	 * Entries are never removed from the tree, so for the in-order
+	 * common case desegment_tcp() can use this cache instead of the
+	 * tree lookups.
+	 */
+	struct tcp_multisegment_pdu *last_msp;
+
 	/* Process info, currently discovered via IPFIX */
 	tcp_process_info_t* process_info;
 
@@ -538,6 +557,18 @@ WS_DLL_PUBLIC guint32 get_tcp_stream_count(void);
  */
 WS_DLL_PUBLIC guint32 get_mptcp_stream_count(void);
 
+/** Get the Follow Stream index entries for a TCP stream: the frame
+ * numbers of the stream's data segments, in capture order, recorded
+ * during the first pass when the "tcp.follow_index" preference is
+ * enabled.
+ *
+ * @param stream The stream id (tcp.stream)
+ * @param[out] count Set to the number of frames on success
+ * @return The frame numbers, valid until the file is closed or
+ * redissected, or NULL if no index is available for the stream.
+ */
+WS_DLL_PUBLIC const guint32 *get_tcp_follow_index_frames(guint32 stream, guint *count);
+
 /* Follow Stream functionality shared with HTTP (and SSL?) */
 extern gchar *tcp_follow_conv_filter(epan_dissect_t *edt, packet_info *pinfo, guint *stream, guint *sub_stream);
 extern gchar *tcp_follow_index_filter(guint stream, guint sub_stream);
@@ -2511,8 +2511,7 @@ static gboolean from_hex(StringInfo* out, const char* in, gsize hex_len) {
 
 
 /* libgcrypt wrappers for HMAC/message digest operations {{{ */
-/* hmac abstraction layer */
-#define SSL_HMAC gcry_md_hd_t
+/* hmac abstraction layer (SSL_HMAC is defined in packet-tls-utils.h) */
 
 static inline gint
 ssl_hmac_init(SSL_HMAC* md, gint algo)
@@ -3734,6 +3733,9 @@ ssl_decoder_destroy_cb(wmem_allocator_t *allocator _U_, wmem_cb_event_t event _U
     if (dec->evp)
         ssl_cipher_cleanup(&dec->evp);
 
+    if (dec->mac_hd)
+        ssl_hmac_cleanup(&dec->mac_hd);
+
 #ifdef HAVE_ZLIB
     if (dec->decomp != NULL && dec->decomp->compression == 1 /* DEFLATE */)
         inflateEnd(&dec->decomp->istream);
@@ -4440,23 +4442,41 @@ ssl_decrypt_pre_master_secret(SslDecryptSession *ssl_session,
 
 /* Decryption integrity check {{{ */
 
+/* Opens the decoder's cached MAC context on first use. The MAC key is fixed
+ * for the lifetime of the decoder and gcry_md_reset() retains the key, so the
+ * following records only pay for a reset instead of open/setkey/close. */
+static gint
+ssl_decoder_hmac_reset(SslDecoder *decoder)
+{
+    gint md;
+
+    if (decoder->mac_hd) {
+        ssl_hmac_reset(&decoder->mac_hd);
+        return 0;
+    }
+    md=ssl_get_digest_by_name(ssl_cipher_suite_dig(decoder->cipher_suite)->name);
+    if (ssl_hmac_init(&decoder->mac_hd,md) != 0)
+        return -1;
+    if (ssl_hmac_setkey(&decoder->mac_hd,decoder->mac_key.data,decoder->mac_key.data_len) != 0) {
+        ssl_hmac_cleanup(&decoder->mac_hd);
+        decoder->mac_hd = NULL;
+        return -1;
+    }
+    return 0;
+}
+
 static gint
 tls_check_mac(SslDecoder*decoder, gint ct, gint ver, guint8* data,
         guint32 datalen, guint8* mac)
 {
-    SSL_HMAC hm;
-    gint     md;
     guint32  len;
     guint8   buf[DIGEST_MAX_SIZE];
     gint16   temp;
 
-    md=ssl_get_digest_by_name(ssl_cipher_suite_dig(decoder->cipher_suite)->name);
-    ssl_debug_printf("tls_check_mac mac type:%s md %d\n",
-        ssl_cipher_suite_dig(decoder->cipher_suite)->name, md);
+    ssl_debug_printf("tls_check_mac mac type:%s\n",
+        ssl_cipher_suite_dig(decoder->cipher_suite)->name);
 
-    if (ssl_hmac_init(&hm,md) != 0)
-        return -1;
-    if (ssl_hmac_setkey(&hm,decoder->mac_key.data,decoder->mac_key.data_len) != 0)
+    if (ssl_decoder_hmac_reset(decoder) != 0)
         return -1;
 
     /* hash sequence number */
@@ -4464,28 +4484,27 @@ tls_check_mac(SslDecoder*decoder, gint ct, gint ver, guint8* data,
 
     decoder->seq++;
 
-    ssl_hmac_update(&hm,buf,8);
+    ssl_hmac_update(&decoder->mac_hd,buf,8);
 
     /* hash content type */
     buf[0]=ct;
-    ssl_hmac_update(&hm,buf,1);
+    ssl_hmac_update(&decoder->mac_hd,buf,1);
 
     /* hash version,data length and data*/
     /* *((gint16*)buf) = g_htons(ver); */
     temp = g_htons(ver);
     memcpy(buf, &temp, 2);
-    ssl_hmac_update(&hm,buf,2);
+    ssl_hmac_update(&decoder->mac_hd,buf,2);
 
     /* *((gint16*)buf) = g_htons(datalen); */
     temp = g_htons(datalen);
     memcpy(buf, &temp, 2);
-    ssl_hmac_update(&hm,buf,2);
-    ssl_hmac_update(&hm,data,datalen);
+    ssl_hmac_update(&decoder->mac_hd,buf,2);
+    ssl_hmac_update(&decoder->mac_hd,data,datalen);
 
     /* get digest and digest len*/
     len = sizeof(buf);
-    ssl_hmac_final(&hm,buf,&len);
-    ssl_hmac_cleanup(&hm);
+    ssl_hmac_final(&decoder->mac_hd,buf,&len);
     ssl_print_data("Mac", buf, len);
     if(memcmp(mac,buf,len))
         return -1;
@@ -4559,19 +4578,14 @@ static gint
 dtls_check_mac(SslDecoder*decoder, gint ct,int ver, guint8* data,
         guint32 datalen, guint8* mac)
 {
-    SSL_HMAC hm;
-    gint     md;
     guint32  len;
     guint8   buf[DIGEST_MAX_SIZE];
     gint16   temp;
 
-    md=ssl_get_digest_by_name(ssl_cipher_suite_dig(decoder->cipher_suite)->name);
-    ssl_debug_printf("dtls_check_mac mac type:%s md %d\n",
-        ssl_cipher_suite_dig(decoder->cipher_suite)->name, md);
+    ssl_debug_printf("dtls_check_mac mac type:%s\n",
+        ssl_cipher_suite_dig(decoder->cipher_suite)->name);
 
-    if (ssl_hmac_init(&hm,md) != 0)
-        return -1;
-    if (ssl_hmac_setkey(&hm,decoder->mac_key.data,decoder->mac_key.data_len) != 0)
+    if (ssl_decoder_hmac_reset(decoder) != 0)
         return -1;
 
     ssl_debug_printf("dtls_check_mac seq: %" G_GUINT64_FORMAT " epoch: %d\n",decoder->seq,decoder->epoch);
@@ -4580,25 +4594,24 @@ dtls_check_mac(SslDecoder*decoder, gint ct,int ver, guint8* data,
     buf[0]=decoder->epoch>>8;
     buf[1]=(guint8)decoder->epoch;
 
-    ssl_hmac_update(&hm,buf,8);
+    ssl_hmac_update(&decoder->mac_hd,buf,8);
 
     /* hash content type */
     buf[0]=ct;
-    ssl_hmac_update(&hm,buf,1);
+    ssl_hmac_update(&decoder->mac_hd,buf,1);
 
     /* hash version,data length and data */
     temp = g_htons(ver);
     memcpy(buf, &temp, 2);
-    ssl_hmac_update(&hm,buf,2);
+    ssl_hmac_update(&decoder->mac_hd,buf,2);
 
     temp = g_htons(datalen);
     memcpy(buf, &temp, 2);
-    ssl_hmac_update(&hm,buf,2);
-    ssl_hmac_update(&hm,data,datalen);
+    ssl_hmac_update(&decoder->mac_hd,buf,2);
+    ssl_hmac_update(&decoder->mac_hd,data,datalen);
     /* get digest and digest len */
     len = sizeof(buf);
-    ssl_hmac_final(&hm,buf,&len);
-    ssl_hmac_cleanup(&hm);
+    ssl_hmac_final(&decoder->mac_hd,buf,&len);
     ssl_print_data("Mac", buf, len);
     if(memcmp(mac,buf,len))
         return -1;
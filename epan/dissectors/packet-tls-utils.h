@@ -30,6 +30,7 @@
 
 /* TODO inline this now that Libgcrypt is mandatory? */
 #define SSL_CIPHER_CTX gcry_cipher_hd_t
+#define SSL_HMAC gcry_md_hd_t
 #define SSL_DECRYPT_DEBUG
 
 
@@ -328,6 +329,7 @@ typedef struct _SslDecoder {
     StringInfo mac_key; /* for block and stream ciphers */
     StringInfo write_iv; /* for AEAD ciphers (at least GCM, CCM) */
     SSL_CIPHER_CTX evp;
+    SSL_HMAC mac_hd; /**< Cached MAC context for block and stream ciphers, opened on first use. */
     SslDecompress *decomp;
     guint64 seq;    /**< Implicit (TLS) or explicit (DTLS) record sequence number. */
     guint16 epoch;
@@ -990,10 +990,15 @@ dissect(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, guint32 ip_proto)
   struct udp_analysis *udpd = NULL;
   proto_tree *process_tree;
   gboolean    udp_jumbogram = FALSE;
+  tvb_span_t  udp_span;
+
+  /* Validate the fixed 8-byte header once; the field reads below are
+     unchecked span accesses. */
+  tvb_get_span(tvb, offset, 8, &udp_span);
 
   udph = wmem_new0(pinfo->pool, e_udphdr);
-  udph->uh_sport = tvb_get_ntohs(tvb, offset);
-  udph->uh_dport = tvb_get_ntohs(tvb, offset + 2);
+  udph->uh_sport = tvb_span_get_ntohs(&udp_span, 0);
+  udph->uh_dport = tvb_span_get_ntohs(&udp_span, 2);
   copy_address_shallow(&udph->ip_src, &pinfo->src);
   copy_address_shallow(&udph->ip_dst, &pinfo->dst);
 
@@ -1037,7 +1042,7 @@ dissect(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, guint32 ip_proto)
                                  ((udph->uh_dport - 32768 - 666 - 1) % 3) + 1);
   }
 
-  udph->uh_ulen = udph->uh_sum_cov = tvb_get_ntohs(tvb, offset + 4);
+  udph->uh_ulen = udph->uh_sum_cov = tvb_span_get_ntohs(&udp_span, 4);
   if (ip_proto == IP_PROTO_UDP) {
     len_cov_item = proto_tree_add_item(udp_tree, &hfi_udp_length, tvb, offset + 4, 2, ENC_BIG_ENDIAN);
     if (udph->uh_ulen == 0 && pinfo->src.type == AT_IPv6) {
@@ -1087,7 +1092,7 @@ dissect(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, guint32 ip_proto)
   if (udp_jumbogram)
     col_append_str(pinfo->cinfo, COL_INFO, " [Jumbogram]");
 
-  udph->uh_sum = tvb_get_ntohs(tvb, offset + 6);
+  udph->uh_sum = tvb_span_get_ntohs(&udp_span, 6);
   if (udph->uh_sum == 0) {
     /* No checksum supplied in the packet. */
 
@@ -272,6 +272,10 @@ typedef struct {
 typedef struct {
     wg_session_t   *session;
     gboolean        receiver_is_initiator;  /* Whether this transport data packet is sent to an Initiator. */
+#ifdef WG_DECRYPTION_SUPPORTED
+    guchar         *decrypted;              /* Decrypted transport payload (file scope), NULL if empty or failed. */
+    gboolean        decryption_ok;          /* Whether transport data decryption succeeded on the first pass. */
+#endif /* WG_DECRYPTION_SUPPORTED */
 } wg_packet_info_t;
 
 /* Map from Sender/Receiver IDs to a list of session information. */
@@ -1315,17 +1319,30 @@ wg_dissect_decrypted_packet(tvbuff_t *tvb, packet_info *pinfo, proto_tree *wg_tr
 {
     wg_handshake_state_t *hs = wg_pinfo->session->hs;
     gcry_cipher_hd_t cipher = wg_pinfo->receiver_is_initiator ? hs->initiator_recv_cipher : hs->responder_recv_cipher;
+    guchar *plain;
     if (!cipher) {
         return;
     }
 
     DISSECTOR_ASSERT(plain_length >= 0);
     const gint ctext_len = plain_length + AUTH_TAG_LENGTH;
-    const guchar *ctext = tvb_get_ptr(tvb, 16, ctext_len);
-    guchar *plain = (guchar *)wmem_alloc0(pinfo->pool, (guint)plain_length);
-    if (!wg_aead_decrypt(cipher, counter, ctext, (guint)ctext_len, NULL, 0, plain, (guint)plain_length)) {
-        proto_tree_add_expert(wg_tree, pinfo, &ei_wg_decryption_error, tvb, 16, ctext_len);
-        return;
+    if (!PINFO_FD_VISITED(pinfo)) {
+        /* Decrypt the transport data once and remember the result, later
+         * passes reuse it instead of running the AEAD again. */
+        const guchar *ctext = tvb_get_ptr(tvb, 16, ctext_len);
+        plain = (guchar *)wmem_alloc0(wmem_file_scope(), (guint)plain_length);
+        if (!wg_aead_decrypt(cipher, counter, ctext, (guint)ctext_len, NULL, 0, plain, (guint)plain_length)) {
+            proto_tree_add_expert(wg_tree, pinfo, &ei_wg_decryption_error, tvb, 16, ctext_len);
+            return;
+        }
+        wg_pinfo->decrypted = plain;
+        wg_pinfo->decryption_ok = TRUE;
+    } else {
+        if (!wg_pinfo->decryption_ok) {
+            proto_tree_add_expert(wg_tree, pinfo, &ei_wg_decryption_error, tvb, 16, ctext_len);
+            return;
+        }
+        plain = wg_pinfo->decrypted;
     }
     if (plain_length == 0) {
         return;
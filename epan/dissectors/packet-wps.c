@@ -1653,10 +1653,16 @@ dissect_wps_tlvs(proto_tree *eap_tree, tvbuff_t *tvb, int offset,
       }
 
       if ((hf_info != NULL) && hf_info->strings) {
-        /* item has value_string */
-        proto_item_append_text(tlv_item, fmt, val_to_str(value,
-                                                         (const value_string *)hf_info->strings,
-                                                         "Unknown: %d"), value);
+        /* item has value_string (possibly wrapped into a value_string_ext
+         * at registration time) */
+        if (hf_info->display & BASE_EXT_STRING)
+          proto_item_append_text(tlv_item, fmt, val_to_str_ext(value,
+                                                               (value_string_ext *)hf_info->strings,
+                                                               "Unknown: %d"), value);
+        else
+          proto_item_append_text(tlv_item, fmt, val_to_str(value,
+                                                           (const value_string *)hf_info->strings,
+                                                           "Unknown: %d"), value);
       } else if (valuep != NULL) {
         /* the string-case */
         proto_item_append_text(tlv_item, fmt, valuep);
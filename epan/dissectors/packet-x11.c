@@ -1280,6 +1280,16 @@ keysymString(guint32 v);
  ***                                                                  ***
  ************************************************************************/
 
+/* Look up a value in a field's registered value_string table. Large tables
+ * get wrapped into a value_string_ext at registration time, so check for
+ * that before falling back to a plain table lookup. */
+static const gchar *try_hfi_val_to_str(guint32 v, const header_field_info *hfi)
+{
+      if (hfi -> display & BASE_EXT_STRING)
+            return try_val_to_str_ext(v, (value_string_ext *)hfi -> strings);
+      return try_val_to_str(v, cVALS(hfi -> strings));
+}
+
 static void atom(tvbuff_t *tvb, int *offsetp, proto_tree *t, int hf,
                  guint byte_order)
 {
@@ -1293,7 +1303,7 @@ static void atom(tvbuff_t *tvb, int *offsetp, proto_tree *t, int hf,
       else {
             header_field_info *hfi = proto_registrar_get_nth(hf);
             if (hfi -> strings)
-                  interpretation = try_val_to_str(v, cVALS(hfi -> strings));
+                  interpretation = try_hfi_val_to_str(v, hfi);
       }
       if (!interpretation) interpretation = "error in Xlib client program ?";
       proto_tree_add_uint_format(t, hf, tvb, *offsetp, 4, v, "%s: %u (%s)",
@@ -2323,10 +2333,10 @@ static guint32 field8(tvbuff_t *tvb, int *offsetp, proto_tree *t, int hf,
       const gchar *enumValue = NULL;
 
       if (hfi -> strings)
-            enumValue = try_val_to_str(v, cVALS(hfi -> strings));
+            enumValue = try_hfi_val_to_str(v, hfi);
       if (enumValue)
             proto_tree_add_uint_format(t, hf, tvb, *offsetp, 1, v,
-            hfi -> display == BASE_DEC ? "%s: %u (%s)" : "%s: 0x%02x (%s)",
+            FIELD_DISPLAY(hfi -> display) == BASE_DEC ? "%s: %u (%s)" : "%s: 0x%02x (%s)",
             hfi -> name, v, enumValue);
       else
             proto_tree_add_item(t, hf, tvb, *offsetp, 1, byte_order);
@@ -2342,10 +2352,10 @@ static guint32 field16(tvbuff_t *tvb, int *offsetp, proto_tree *t, int hf,
       const gchar *enumValue = NULL;
 
       if (hfi -> strings)
-            enumValue = try_val_to_str(v, cVALS(hfi -> strings));
+            enumValue = try_hfi_val_to_str(v, hfi);
       if (enumValue)
             proto_tree_add_uint_format(t, hf, tvb, *offsetp, 2, v,
-            hfi -> display == BASE_DEC ? "%s: %u (%s)" : "%s: 0x%02x (%s)",
+            FIELD_DISPLAY(hfi -> display) == BASE_DEC ? "%s: %u (%s)" : "%s: 0x%02x (%s)",
             hfi -> name, v, enumValue);
       else
             proto_tree_add_item(t, hf, tvb, *offsetp, 2, byte_order);
@@ -2362,14 +2372,14 @@ static guint32 field32(tvbuff_t *tvb, int *offsetp, proto_tree *t, int hf,
       const gchar *nameAsChar = hfi -> name;
 
       if (hfi -> strings)
-            enumValue = try_val_to_str(v, cVALS(hfi -> strings));
+            enumValue = try_hfi_val_to_str(v, hfi);
       if (enumValue)
             proto_tree_add_uint_format(t, hf, tvb, *offsetp, 4, v,
-                                       hfi -> display == BASE_DEC ? "%s: %u (%s)" : "%s: 0x%08x (%s)",
+                                       FIELD_DISPLAY(hfi -> display) == BASE_DEC ? "%s: %u (%s)" : "%s: 0x%08x (%s)",
                                        nameAsChar, v, enumValue);
       else
             proto_tree_add_uint_format(t, hf, tvb, *offsetp, 4, v,
-                                       hfi -> display == BASE_DEC ? "%s: %u" : "%s: 0x%08x",
+                                       FIELD_DISPLAY(hfi -> display) == BASE_DEC ? "%s: %u" : "%s: 0x%08x",
                                        nameAsChar, v);
       *offsetp += 4;
       return v;
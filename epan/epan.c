@@ -30,8 +30,10 @@
 #include "epan_dissect.h"
 
 #include <wsutil/nstime.h>
+#include <wsutil/pipeline_stats.h>
 #include <wsutil/wslog.h>
 #include <wsutil/ws_assert.h>
+#include <wsutil/ws_tracepoints.h>
 
 #include "conversation.h"
 #include "except.h"
@@ -103,7 +105,12 @@
 static GSList *epan_plugin_register_all_procotols = NULL;
 static GSList *epan_plugin_register_all_handoffs = NULL;
 
-static wmem_allocator_t *pinfo_pool_cache = NULL;
+/* Several code paths keep two dissection contexts alive at once (a
+ * display-filter context plus a read-filter context), so cache a few
+ * spare pinfo pools rather than just one. */
+#define PINFO_POOL_CACHE_SIZE 4
+static wmem_allocator_t *pinfo_pool_cache[PINFO_POOL_CACHE_SIZE];
+static guint pinfo_pool_cached;
 
 /* Global variables holding the content of the corresponding environment variable
  * to save fetching it repeatedly.
@@ -420,10 +427,8 @@ epan_cleanup(void)
 	libwireshark_plugins = NULL;
 #endif
 
-	if (pinfo_pool_cache != NULL) {
-		wmem_destroy_allocator(pinfo_pool_cache);
-		pinfo_pool_cache = NULL;
-	}
+	while (pinfo_pool_cached > 0)
+		wmem_destroy_allocator(pinfo_pool_cache[--pinfo_pool_cached]);
 
 	wmem_cleanup_scopes();
 }
@@ -457,6 +462,15 @@ epan_get_modified_block(const epan_t *session, const frame_data *fd)
 	return NULL;
 }
 
+const nstime_t *
+epan_get_frame_shift_offset(const epan_t *session, const frame_data *fd)
+{
+	if (session->funcs.get_frame_shift_offset)
+		return session->funcs.get_frame_shift_offset(session->prov, fd);
+
+	return NULL;
+}
+
 const char *
 epan_get_interface_name(const epan_t *session, guint32 interface_id)
 {
@@ -529,9 +543,8 @@ epan_dissect_init(epan_dissect_t *edt, epan_t *session, const gboolean create_pr
 	edt->session = session;
 
 	memset(&edt->pi, 0, sizeof(edt->pi));
-	if (pinfo_pool_cache != NULL) {
-		edt->pi.pool = pinfo_pool_cache;
-		pinfo_pool_cache = NULL;
+	if (pinfo_pool_cached > 0) {
+		edt->pi.pool = pinfo_pool_cache[--pinfo_pool_cached];
 	}
 	else {
 		edt->pi.pool = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK_FAST);
@@ -608,6 +621,8 @@ epan_dissect_run(epan_dissect_t *edt, int file_type_subtype,
 #ifdef HAVE_LUA
 	wslua_prime_dfilter(edt); /* done before entering wmem scope */
 #endif
+	WS_TRACEPOINT1(dissect_entry, fd->num);
+	pipeline_stats_record(PIPELINE_STAGE_DISSECT, 1);
 	wmem_enter_packet_scope();
 	dissect_record(edt, file_type_subtype, rec, tvb, fd, cinfo);
 
@@ -622,6 +637,8 @@ epan_dissect_run_with_taps(epan_dissect_t *edt, int file_type_subtype,
 	wtap_rec *rec, tvbuff_t *tvb, frame_data *fd,
 	column_info *cinfo)
 {
+	WS_TRACEPOINT1(dissect_entry, fd->num);
+	pipeline_stats_record(PIPELINE_STAGE_DISSECT, 1);
 	wmem_enter_packet_scope();
 	tap_queue_init(edt);
 	dissect_record(edt, file_type_subtype, rec, tvb, fd, cinfo);
@@ -686,9 +703,9 @@ epan_dissect_cleanup(epan_dissect_t* edt)
 		proto_tree_free(edt->tree);
 	}
 
-	if (pinfo_pool_cache == NULL) {
+	if (pinfo_pool_cached < PINFO_POOL_CACHE_SIZE) {
 		wmem_free_all(edt->pi.pool);
-		pinfo_pool_cache = edt->pi.pool;
+		pinfo_pool_cache[pinfo_pool_cached++] = edt->pi.pool;
 	}
 	else {
 		wmem_destroy_allocator(edt->pi.pool);
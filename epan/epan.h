@@ -51,6 +51,7 @@ struct packet_provider_funcs {
 	const char *(*get_interface_name)(struct packet_provider_data *prov, guint32 interface_id);
 	const char *(*get_interface_description)(struct packet_provider_data *prov, guint32 interface_id);
 	wtap_block_t (*get_modified_block)(struct packet_provider_data *prov, const frame_data *fd);
+	const nstime_t *(*get_frame_shift_offset)(struct packet_provider_data *prov, const frame_data *fd);
 };
 
 /**
@@ -156,6 +157,11 @@ WS_DLL_PUBLIC epan_t *epan_new(struct packet_provider_data *prov,
 
 WS_DLL_PUBLIC wtap_block_t epan_get_modified_block(const epan_t *session, const frame_data *fd);
 
+/** Get the time shift applied to a frame, or NULL if its time was never
+ * shifted.  The offsets live in a side table kept by the packet provider,
+ * not in the frame_data, as almost no frames ever have one. */
+WS_DLL_PUBLIC const nstime_t *epan_get_frame_shift_offset(const epan_t *session, const frame_data *fd);
+
 WS_DLL_PUBLIC const char *epan_get_interface_name(const epan_t *session, guint32 interface_id);
 
 WS_DLL_PUBLIC const char *epan_get_interface_description(const epan_t *session, guint32 interface_id);
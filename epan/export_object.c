@@ -12,6 +12,8 @@
 
 #include <string.h>
 
+#include <wsutil/filesystem.h>
+
 #include "proto.h"
 #include "packet_info.h"
 #include "export_object.h"
@@ -156,6 +158,72 @@ void eo_free_entry(export_object_entry_t *entry)
     g_free(entry);
 }
 
+typedef struct {
+    gchar *path;
+    const guint8 *data;
+    size_t len;
+} eo_writer_task_t;
+
+struct _eo_writer {
+    GThreadPool *pool;
+    gint failed;        /* updated atomically by the workers */
+};
+
+static void
+eo_writer_worker(gpointer task_data, gpointer user_data)
+{
+    eo_writer_t *writer = (eo_writer_t *)user_data;
+    eo_writer_task_t *task = (eo_writer_task_t *)task_data;
+
+    if (!write_file_binary_mode(task->path, task->data, task->len))
+        g_atomic_int_inc(&writer->failed);
+
+    g_free(task->path);
+    g_free(task);
+}
+
+eo_writer_t *
+eo_writer_new(void)
+{
+    eo_writer_t *writer = g_new0(eo_writer_t, 1);
+
+    /* The writes are I/O bound; a handful of threads is enough to keep
+       the storage busy without degenerating into a seek storm. */
+    writer->pool = g_thread_pool_new(eo_writer_worker, writer,
+        MIN((gint)g_get_num_processors(), 8), FALSE, NULL);
+    return writer;
+}
+
+void
+eo_writer_queue(eo_writer_t *writer, gchar *save_as_fullpath,
+    const guint8 *payload_data, size_t payload_len)
+{
+    eo_writer_task_t *task = g_new(eo_writer_task_t, 1);
+
+    task->path = save_as_fullpath;
+    task->data = payload_data;
+    task->len = payload_len;
+
+    if (writer->pool == NULL || !g_thread_pool_push(writer->pool, task, NULL)) {
+        /* No pool, or the push failed: write synchronously instead. */
+        eo_writer_worker(task, writer);
+    }
+}
+
+guint
+eo_writer_finish(eo_writer_t *writer)
+{
+    guint failed;
+
+    if (writer->pool != NULL) {
+        /* Wait for the pending writes to drain. */
+        g_thread_pool_free(writer->pool, FALSE, TRUE);
+    }
+    failed = (guint)g_atomic_int_get(&writer->failed);
+    g_free(writer);
+    return failed;
+}
+
 /*
  * Editor modelines
  *
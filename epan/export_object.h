@@ -126,6 +126,38 @@ WS_DLL_PUBLIC const char *eo_ct2ext(const char *content_type);
  */
 WS_DLL_PUBLIC void eo_free_entry(export_object_entry_t *entry);
 
+/** Opaque handle for a pool of worker threads writing object payloads to
+    disk.  The "save all" code paths use it so that many small files are
+    written in parallel instead of paying the per-file latency serially. */
+typedef struct _eo_writer eo_writer_t;
+
+/** Create a writer pool.
+ *
+ * @return a new writer; release it with eo_writer_finish()
+ */
+WS_DLL_PUBLIC eo_writer_t *eo_writer_new(void);
+
+/** Queue one object payload for writing.
+ *
+ * Takes ownership of save_as_fullpath (a g_malloc()ed string).  The
+ * payload bytes are borrowed and must stay valid until
+ * eo_writer_finish() returns.
+ *
+ * @param writer writer created by eo_writer_new()
+ * @param save_as_fullpath full path of the file to write
+ * @param payload_data object contents
+ * @param payload_len length of the object contents in bytes
+ */
+WS_DLL_PUBLIC void eo_writer_queue(eo_writer_t *writer, gchar *save_as_fullpath,
+    const guint8 *payload_data, size_t payload_len);
+
+/** Wait for all queued writes to complete and free the writer.
+ *
+ * @param writer writer created by eo_writer_new()
+ * @return the number of writes that failed
+ */
+WS_DLL_PUBLIC guint eo_writer_finish(eo_writer_t *writer);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,204 @@
+/* frame_class.c
+ * Cheap pre-dissection coarse classification of frames.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <epan/frame_class.h>
+#include <epan/etypes.h>
+#include <epan/ipproto.h>
+#include <wsutil/pint.h>
+
+const value_string frame_class_vals[] = {
+  { FRAME_CLASS_UNCLASSIFIED, "Unclassified" },
+  { FRAME_CLASS_BROADCAST,    "Broadcast" },
+  { FRAME_CLASS_MULTICAST,    "Multicast" },
+  { FRAME_CLASS_ARP,          "ARP" },
+  { FRAME_CLASS_ICMP,         "ICMP" },
+  { FRAME_CLASS_TCP_CTL,      "TCP control" },
+  { FRAME_CLASS_TCP_DATA,     "TCP data" },
+  { FRAME_CLASS_TLS,          "TLS" },
+  { FRAME_CLASS_UDP,          "UDP" },
+  { FRAME_CLASS_OTHER,        "Other" },
+  { 0, NULL }
+};
+
+/*
+ * Classify the TCP segment starting at offset; ip_payload is the number
+ * of bytes the network layer says the segment occupies.
+ */
+static guint8
+classify_tcp(const guint8 *pd, guint32 offset, guint32 caplen,
+             guint32 ip_payload)
+{
+  guint32 hdr_len;
+
+  if (offset + 13 > caplen)
+    return FRAME_CLASS_OTHER;
+  hdr_len = ((pd[offset + 12] >> 4) & 0x0F) * 4;
+  if (hdr_len < 20 || ip_payload < hdr_len)
+    return FRAME_CLASS_OTHER;
+  if (ip_payload == hdr_len)
+    return FRAME_CLASS_TCP_CTL;
+
+  /* There's payload; a TLS record starts with a content type of
+     20..23 and a major version of 3. */
+  if (offset + hdr_len + 2 <= caplen &&
+      pd[offset + hdr_len] >= 20 && pd[offset + hdr_len] <= 23 &&
+      pd[offset + hdr_len + 1] == 3)
+    return FRAME_CLASS_TLS;
+  return FRAME_CLASS_TCP_DATA;
+}
+
+static guint8
+classify_ipv4(const guint8 *pd, guint32 offset, guint32 caplen)
+{
+  guint32 hdr_len, total_len;
+
+  if (offset + 20 > caplen || (pd[offset] >> 4) != 4)
+    return FRAME_CLASS_OTHER;
+  hdr_len = (pd[offset] & 0x0F) * 4;
+  if (hdr_len < 20)
+    return FRAME_CLASS_OTHER;
+  total_len = pntoh16(&pd[offset + 2]);
+  if (total_len < hdr_len)
+    return FRAME_CLASS_OTHER;
+
+  switch (pd[offset + 9]) {
+  case IP_PROTO_ICMP:
+    return FRAME_CLASS_ICMP;
+  case IP_PROTO_TCP:
+    return classify_tcp(pd, offset + hdr_len, caplen, total_len - hdr_len);
+  case IP_PROTO_UDP:
+    return FRAME_CLASS_UDP;
+  default:
+    return FRAME_CLASS_OTHER;
+  }
+}
+
+static guint8
+classify_ipv6(const guint8 *pd, guint32 offset, guint32 caplen)
+{
+  guint32 payload_len;
+
+  if (offset + 40 > caplen || (pd[offset] >> 4) != 6)
+    return FRAME_CLASS_OTHER;
+  payload_len = pntoh16(&pd[offset + 4]);
+
+  /* Look only at the first next-header value; walking extension header
+     chains is dissection's job, not a triage pass's. */
+  switch (pd[offset + 6]) {
+  case IP_PROTO_ICMPV6:
+    return FRAME_CLASS_ICMP;
+  case IP_PROTO_TCP:
+    return classify_tcp(pd, offset + 40, caplen, payload_len);
+  case IP_PROTO_UDP:
+    return FRAME_CLASS_UDP;
+  default:
+    return FRAME_CLASS_OTHER;
+  }
+}
+
+guint8
+frame_class_classify(int encap, const guint8 *pd, guint32 caplen)
+{
+  guint32  offset;
+  guint16  etype;
+  guint8   fclass = FRAME_CLASS_OTHER;
+  gboolean is_broadcast = FALSE, is_multicast = FALSE;
+
+  switch (encap) {
+
+  case WTAP_ENCAP_ETHERNET:
+    if (caplen < 14)
+      return FRAME_CLASS_UNCLASSIFIED;
+    if (pd[0] == 0xFF && pd[1] == 0xFF && pd[2] == 0xFF &&
+        pd[3] == 0xFF && pd[4] == 0xFF && pd[5] == 0xFF)
+      is_broadcast = TRUE;
+    else if (pd[0] & 0x01)
+      is_multicast = TRUE;
+
+    offset = 12;
+    etype = pntoh16(&pd[offset]);
+    while (etype == ETHERTYPE_VLAN || etype == ETHERTYPE_IEEE_802_1AD) {
+      offset += 4;
+      if (offset + 2 > caplen)
+        return is_broadcast ? FRAME_CLASS_BROADCAST :
+               is_multicast ? FRAME_CLASS_MULTICAST : FRAME_CLASS_UNCLASSIFIED;
+      etype = pntoh16(&pd[offset]);
+    }
+    offset += 2;
+
+    switch (etype) {
+    case ETHERTYPE_ARP:
+      return FRAME_CLASS_ARP;
+    case ETHERTYPE_IP:
+      fclass = classify_ipv4(pd, offset, caplen);
+      break;
+    case ETHERTYPE_IPv6:
+      fclass = classify_ipv6(pd, offset, caplen);
+      break;
+    default:
+      fclass = FRAME_CLASS_OTHER;
+      break;
+    }
+    break;
+
+  case WTAP_ENCAP_RAW_IP:
+    if (caplen < 1)
+      return FRAME_CLASS_UNCLASSIFIED;
+    fclass = ((pd[0] >> 4) == 6) ? classify_ipv6(pd, 0, caplen)
+                                 : classify_ipv4(pd, 0, caplen);
+    break;
+
+  case WTAP_ENCAP_RAW_IP4:
+    fclass = classify_ipv4(pd, 0, caplen);
+    break;
+
+  case WTAP_ENCAP_RAW_IP6:
+    fclass = classify_ipv6(pd, 0, caplen);
+    break;
+
+  default:
+    /* A link type we don't walk. */
+    return FRAME_CLASS_UNCLASSIFIED;
+  }
+
+  /* Broadcast/multicast only matter when nothing more specific fit. */
+  if (fclass == FRAME_CLASS_OTHER) {
+    if (is_broadcast)
+      return FRAME_CLASS_BROADCAST;
+    if (is_multicast)
+      return FRAME_CLASS_MULTICAST;
+  }
+  return fclass;
+}
+
+void
+frame_data_classify(frame_data *fdata, const wtap_rec *rec, const guint8 *pd)
+{
+  if (rec->rec_type != REC_TYPE_PACKET)
+    return;
+  fdata->coarse_class = frame_class_classify(
+      rec->rec_header.packet_header.pkt_encap, pd,
+      rec->rec_header.packet_header.caplen);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 2
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=2 tabstop=8 expandtab:
+ * :indentSize=2:tabSize=8:noTabs=true:
+ */
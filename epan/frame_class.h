@@ -0,0 +1,85 @@
+/* frame_class.h
+ * Cheap pre-dissection coarse classification of frames.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __FRAME_CLASS_H__
+#define __FRAME_CLASS_H__
+
+#include <glib.h>
+#include <wiretap/wtap.h>
+#include <epan/frame_data.h>
+#include <epan/value_string.h>
+#include "ws_symbol_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Triage of a large capture starts with separating background noise -
+ * broadcasts, ARP, ICMP chatter - from the traffic of interest.  These
+ * coarse classes are assigned by a fixed-function header walk, in the
+ * spirit of the capture dissectors, when the frame table is built: no
+ * epan dissection is needed, so the class is available for columns and
+ * filtering as soon as the frame is read.
+ *
+ * The class is stored as one byte in each frame_data.  A more specific
+ * class wins over a less specific one: an ARP request is ARP, not
+ * broadcast; broadcast and multicast are only assigned when no
+ * recognized protocol class applies.
+ */
+typedef enum {
+  FRAME_CLASS_UNCLASSIFIED = 0, /* link type we don't walk, or truncated */
+  FRAME_CLASS_BROADCAST,        /* link-layer broadcast, not otherwise classed */
+  FRAME_CLASS_MULTICAST,        /* link-layer multicast, not otherwise classed */
+  FRAME_CLASS_ARP,              /* ARP request/reply */
+  FRAME_CLASS_ICMP,             /* ICMP or ICMPv6 */
+  FRAME_CLASS_TCP_CTL,          /* TCP segment without payload (SYN/ACK/FIN/...) */
+  FRAME_CLASS_TCP_DATA,         /* TCP segment with payload */
+  FRAME_CLASS_TLS,              /* TLS record over TCP */
+  FRAME_CLASS_UDP,              /* UDP datagram */
+  FRAME_CLASS_OTHER             /* walked the headers, none of the above */
+} frame_class_t;
+
+/** Strings for the classes above, for columns and the frame.coarse_class
+    field. */
+WS_DLL_PUBLIC const value_string frame_class_vals[];
+
+/**
+ * Classify a packet's data by walking its link, network and transport
+ * headers.  encap is the frame's WTAP_ENCAP_ type.
+ */
+WS_DLL_PUBLIC guint8 frame_class_classify(int encap, const guint8 *pd,
+                                          guint32 caplen);
+
+/**
+ * Set fdata->coarse_class from a freshly read record; does nothing for
+ * non-packet records.
+ */
+WS_DLL_PUBLIC void frame_data_classify(frame_data *fdata,
+                                       const wtap_rec *rec, const guint8 *pd);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __FRAME_CLASS_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 2
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=2 tabstop=8 expandtab:
+ * :indentSize=2:tabSize=8:noTabs=true:
+ */
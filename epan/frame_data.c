@@ -147,6 +147,9 @@ frame_data_compare(const struct epan_session *epan, const frame_data *fdata1, co
   case COL_CUMULATIVE_BYTES:
     return COMPARE_NUM(cum_bytes);
 
+  case COL_COARSE_CLASS:
+    return COMPARE_NUM(coarse_class);
+
   }
   g_return_val_if_reached(0);
 }
@@ -167,6 +170,7 @@ frame_data_init(frame_data *fdata, guint32 num, const wtap_rec *rec,
   fdata->ref_time = 0;
   fdata->ignored = 0;
   fdata->has_ts = (rec->presence_flags & WTAP_HAS_TS) ? 1 : 0;
+  fdata->coarse_class = 0;  /* FRAME_CLASS_UNCLASSIFIED; see frame_data_classify() */
   switch (rec->rec_type) {
 
   case REC_TYPE_PACKET:
@@ -222,8 +226,6 @@ frame_data_init(frame_data *fdata, guint32 num, const wtap_rec *rec,
   fdata->has_modified_block = 0;
   fdata->need_colorize = 0;
   fdata->color_filter = NULL;
-  fdata->shift_offset.secs = 0;
-  fdata->shift_offset.nsecs = 0;
   fdata->frame_ref_num = 0;
   fdata->prev_dis_num = 0;
 }
@@ -88,8 +88,9 @@ typedef struct _frame_data {
   unsigned int has_modified_block : 1; /** 1 = block for this packet has been modified */
   unsigned int need_colorize    : 1; /**< 1 = need to (re-)calculate packet color */
   unsigned int tsprec           : 4; /**< Time stamp precision -2^tsprec gives up to femtoseconds */
-  nstime_t     abs_ts;       /**< Absolute timestamp */
-  nstime_t     shift_offset; /**< How much the abs_tm of the frame is shifted */
+  /* This fits in padding that would otherwise precede abs_ts. */
+  guint8       coarse_class; /**< Pre-dissection coarse class (see frame_class.h) */
+  nstime_t     abs_ts;       /**< Absolute timestamp, including any time shift */
   guint32      frame_ref_num; /**< Previous reference frame (0 if this is one) */
   guint32      prev_dis_num; /**< Previous displayed frame (0 if first one) */
 } frame_data;
@@ -17,16 +17,46 @@
 #include <strutil.h>
 #include <wsutil/ws_assert.h>
 
+/* Strings shorter than the fvalue union are stored inline in it instead
+ * of in a separate allocation; text protocols repeat short values ("GET",
+ * "200", host names) millions of times per capture, and the inline copy
+ * avoids a heap allocation and free per occurrence. The fvalue's private
+ * boolean records which representation is in use. */
+#define string_is_inline	fvalue_gboolean1
+
+static gchar *
+string_data(const fvalue_t *fv)
+{
+	if (fv->string_is_inline)
+		return (gchar *)fv->value.inline_string;
+	return fv->value.string;
+}
+
 static void
 string_fvalue_new(fvalue_t *fv)
 {
 	fv->value.string = NULL;
+	fv->string_is_inline = FALSE;
 }
 
 static void
 string_fvalue_free(fvalue_t *fv)
 {
-	g_free(fv->value.string);
+	if (!fv->string_is_inline)
+		g_free(fv->value.string);
+}
+
+static void
+string_store(fvalue_t *fv, const gchar *value, gsize length)
+{
+	if (length < sizeof(fv->value.inline_string)) {
+		memcpy(fv->value.inline_string, value, length);
+		fv->value.inline_string[length] = '\0';
+		fv->string_is_inline = TRUE;
+	} else {
+		fv->value.string = (gchar *)g_strndup(value, length);
+		fv->string_is_inline = FALSE;
+	}
 }
 
 static void
@@ -37,7 +67,7 @@ string_fvalue_set_string(fvalue_t *fv, const gchar *value)
 	/* Free up the old value, if we have one */
 	string_fvalue_free(fv);
 
-	fv->value.string = (gchar *)g_strdup(value);
+	string_store(fv, value, strlen(value));
 }
 
 static int
@@ -45,10 +75,10 @@ string_repr_len(fvalue_t *fv, ftrepr_t rtype, int field_display _U_)
 {
 	switch (rtype) {
 		case FTREPR_DISPLAY:
-			return (int)strlen(fv->value.string);
+			return (int)strlen(string_data(fv));
 
 		case FTREPR_DFILTER:
-			return escape_string_len(fv->value.string);
+			return escape_string_len(string_data(fv));
 	}
 	ws_assert_not_reached();
 	return -1;
@@ -59,11 +89,11 @@ string_to_repr(fvalue_t *fv, ftrepr_t rtype, int field_display _U_, char *buf, u
 {
 	switch (rtype) {
 		case FTREPR_DISPLAY:
-			(void) g_strlcpy(buf, fv->value.string, size);
+			(void) g_strlcpy(buf, string_data(fv), size);
 			return;
 
 		case FTREPR_DFILTER:
-			escape_string(buf, fv->value.string);
+			escape_string(buf, string_data(fv));
 			return;
 	}
 	ws_assert_not_reached();
@@ -73,7 +103,7 @@ string_to_repr(fvalue_t *fv, ftrepr_t rtype, int field_display _U_, char *buf, u
 static gpointer
 value_get(fvalue_t *fv)
 {
-	return fv->value.string;
+	return string_data(fv);
 }
 
 static gboolean
@@ -82,7 +112,7 @@ val_from_string(fvalue_t *fv, const char *s, gchar **err_msg _U_)
 	/* Free up the old value, if we have one */
 	string_fvalue_free(fv);
 
-	fv->value.string = g_strdup(s);
+	string_store(fv, s, strlen(s));
 	return TRUE;
 }
 
@@ -102,9 +132,8 @@ val_from_unparsed(fvalue_t *fv, const char *s, gboolean allow_partial_value _U_,
 		 * in the middle of the byte string? */
 		int num_bytes = fv_bytes->value.bytes->len;
 
-		fv->value.string = (gchar *)g_malloc(num_bytes + 1);
-		memcpy(fv->value.string, fv_bytes->value.bytes->data, num_bytes);
-		fv->value.string[num_bytes] = '\0';
+		string_store(fv, (const gchar *)fv_bytes->value.bytes->data,
+		    num_bytes);
 
 		FVALUE_FREE(fv_bytes);
 		return TRUE;
@@ -117,7 +146,7 @@ val_from_unparsed(fvalue_t *fv, const char *s, gboolean allow_partial_value _U_,
 static guint
 len(fvalue_t *fv)
 {
-	return (guint)strlen(fv->value.string);
+	return (guint)strlen(string_data(fv));
 }
 
 static void
@@ -125,7 +154,7 @@ slice(fvalue_t *fv, GByteArray *bytes, guint offset, guint length)
 {
 	guint8* data;
 
-	data = fv->value.ustring + offset;
+	data = (guint8 *)string_data(fv) + offset;
 
 	g_byte_array_append(bytes, data, length);
 }
@@ -134,37 +163,37 @@ slice(fvalue_t *fv, GByteArray *bytes, guint offset, guint length)
 static gboolean
 cmp_eq(const fvalue_t *a, const fvalue_t *b)
 {
-	return (strcmp(a->value.string, b->value.string) == 0);
+	return (strcmp(string_data(a), string_data(b)) == 0);
 }
 
 static gboolean
 cmp_ne(const fvalue_t *a, const fvalue_t *b)
 {
-	return (strcmp(a->value.string, b->value.string) != 0);
+	return (strcmp(string_data(a), string_data(b)) != 0);
 }
 
 static gboolean
 cmp_gt(const fvalue_t *a, const fvalue_t *b)
 {
-	return (strcmp(a->value.string, b->value.string) > 0);
+	return (strcmp(string_data(a), string_data(b)) > 0);
 }
 
 static gboolean
 cmp_ge(const fvalue_t *a, const fvalue_t *b)
 {
-	return (strcmp(a->value.string, b->value.string) >= 0);
+	return (strcmp(string_data(a), string_data(b)) >= 0);
 }
 
 static gboolean
 cmp_lt(const fvalue_t *a, const fvalue_t *b)
 {
-	return (strcmp(a->value.string, b->value.string) < 0);
+	return (strcmp(string_data(a), string_data(b)) < 0);
 }
 
 static gboolean
 cmp_le(const fvalue_t *a, const fvalue_t *b)
 {
-	return (strcmp(a->value.string, b->value.string) <= 0);
+	return (strcmp(string_data(a), string_data(b)) <= 0);
 }
 
 static gboolean
@@ -174,11 +203,11 @@ cmp_contains(const fvalue_t *fv_a, const fvalue_t *fv_b)
 	* http://www.introl.com/introl-demo/Libraries/C/ANSI_C/string/strstr.html
 	* strstr() returns a non-NULL value if needle is an empty
 	* string. We don't that behavior for cmp_contains. */
-	if (strlen(fv_b->value.string) == 0) {
+	if (strlen(string_data(fv_b)) == 0) {
 		return FALSE;
 	}
 
-	if (strstr(fv_a->value.string, fv_b->value.string)) {
+	if (strstr(string_data(fv_a), string_data(fv_b))) {
 		return TRUE;
 	}
 	else {
@@ -189,7 +218,7 @@ cmp_contains(const fvalue_t *fv_a, const fvalue_t *fv_b)
 static gboolean
 cmp_matches(const fvalue_t *fv, const GRegex *regex)
 {
-	char *str = fv->value.string;
+	char *str = string_data(fv);
 
 	if (! regex) {
 		return FALSE;
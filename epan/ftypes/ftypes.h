@@ -233,6 +233,11 @@ typedef struct _fvalue_t {
 		gdouble			floating;
 		gchar			*string;
 		guchar			*ustring;
+		/* Inline storage for short strings, used by ftype-string.c
+		 * to avoid a separate allocation; always NUL-terminated.
+		 * Longer strings use "string". This fits in the space the
+		 * union already occupies for the larger value types. */
+		gchar			inline_string[16];
 		GByteArray		*bytes;
 		ipv4_addr_and_mask	ipv4;
 		ipv6_addr_and_prefix	ipv6;
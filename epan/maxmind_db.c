@@ -163,9 +163,11 @@ static gboolean mmdbr_pipe_valid(void) {
 }
 
 // Writing to mmdbr_pipe.stdin_fd can block. Do so in a separate thread.
+#define MAX_MMDB_REQUEST_BATCH 8192
 static gpointer
 write_mmdbr_stdin_worker(gpointer sifd_data) {
     int stdin_fd = GPOINTER_TO_INT(sifd_data);
+    GString *request_buf = g_string_new("");
 
     MMDB_DEBUG("starting write worker");
 
@@ -173,6 +175,7 @@ write_mmdbr_stdin_worker(gpointer sifd_data) {
         if (!mmdbr_pipe_valid()) {
             // Should be due to mmdb_resolve_stop.
             MMDB_DEBUG("invalid mmdbr stdin pipe. exiting thread.");
+            g_string_free(request_buf, TRUE);
             return NULL;
         }
 
@@ -188,22 +191,37 @@ write_mmdbr_stdin_worker(gpointer sifd_data) {
             continue;
         }
 
-        MMDB_DEBUG("write %s ql %d", request, g_async_queue_length(mmdbr_request_q));
-        ssize_t req_status = ws_write(stdin_fd, request, (unsigned int)strlen(request));
+        g_string_assign(request_buf, request);
+        g_free(request);
+
+        // Coalesce whatever else is already queued into a single write
+        // so that a burst of lookups (e.g. from the endpoints dialog)
+        // doesn't cost one system call per address.
+        while (request_buf->len < MAX_MMDB_REQUEST_BATCH
+               && (request = (char *) g_async_queue_try_pop(mmdbr_request_q)) != NULL) {
+            if (strcmp(request, mmdbr_stop_sentinel) != 0) {
+                g_string_append(request_buf, request);
+            }
+            g_free(request);
+        }
+
+        MMDB_DEBUG("write %s ql %d", request_buf->str, g_async_queue_length(mmdbr_request_q));
+        ssize_t req_status = ws_write(stdin_fd, request_buf->str, (unsigned int)request_buf->len);
         if (req_status < 0) {
             MMDB_DEBUG("write error %s. exiting thread.", g_strerror(errno));
+            g_string_free(request_buf, TRUE);
             return NULL;
         }
-        g_free(request);
     }
+    g_string_free(request_buf, TRUE);
     return NULL;
 }
 
-static ssize_t mmdbr_pipe_read_one(char *ch_p) {
+static ssize_t mmdbr_pipe_read_block(char *buf, size_t buf_size) {
     ssize_t status = -1;
     g_rw_lock_reader_lock(&mmdbr_pipe_mtx);
     if (ws_pipe_valid(&mmdbr_pipe) && ws_pipe_data_available(mmdbr_pipe.stdout_fd)) {
-        status = ws_read(mmdbr_pipe.stdout_fd, ch_p, 1);
+        status = ws_read(mmdbr_pipe.stdout_fd, buf, (unsigned int)buf_size);
     }
     g_rw_lock_reader_unlock(&mmdbr_pipe_mtx);
     return status;
@@ -215,14 +233,15 @@ static ssize_t mmdbr_pipe_read_one(char *ch_p) {
 // thread calls fclose while fgets is blocking, it will block as well. The
 // same happens for plain close+read.
 //
-// Read our input one character at a time and only after we've ensured
-// that data is available. If this is too inefficient we could try one
-// of the following:
+// Read our input a block at a time and only after we've ensured that data
+// is available; reading a pipe never blocks for less than what's buffered.
+// If this is still too inefficient we could try one of the following:
 // - Use overlapped I/O, which implies adding ws_pipe_set_nonblock and
 //   ws_pipe_read_nonblock routines.
 // - Stash our worker thread handles on Windows and call CancelSynchronousIo
 //   before shutting down our threads.
 #define MAX_MMDB_LINE_LEN 2000
+#define MMDB_PIPE_BUF_SIZE 2048
 #define MMDB_WAIT_TIME (150 * 1000) // microseconds
 static gpointer
 read_mmdbr_stdout_worker(gpointer data _U_) {
@@ -233,44 +252,49 @@ read_mmdbr_stdout_worker(gpointer data _U_) {
     GString *city = g_string_new("");
     GString *as_org = g_string_new("");
     char cur_addr[WS_INET6_ADDRSTRLEN] = { 0 };
+    char read_buf[MMDB_PIPE_BUF_SIZE];
+    ssize_t read_buf_len = 0;
+    ssize_t read_buf_pos = 0;
 
     MMDB_DEBUG("starting read worker");
 
-    while (1) { // Start of line
-        char ch;
-        ssize_t status;
+    while (1) { // One iteration per buffered character
+        if (read_buf_pos >= read_buf_len) {
+            read_buf_len = mmdbr_pipe_read_block(read_buf, sizeof(read_buf));
+            read_buf_pos = 0;
 
-        g_string_truncate(line_buf, 0);
+            if (read_buf_len < 1) {
+                if (!mmdbr_pipe_valid()) {
+                    // Should be due to mmdb_resolve_stop.
+                    MMDB_DEBUG("invalid mmdbr stdout pipe. exiting thread.");
+                    break;
+                }
 
-        while((status = mmdbr_pipe_read_one(&ch)) == 1) {
-            if (ch == '\n') {
-                break;
+                MMDB_DEBUG("no pipe data");
+                g_usleep(MMDB_WAIT_TIME);
+                continue;
             }
+        }
 
+        char ch = read_buf[read_buf_pos++];
+
+        if (ch != '\n') {
             g_string_append_c(line_buf, ch);
 
             if (line_buf->len > MAX_MMDB_LINE_LEN) {
                 MMDB_DEBUG("long line");
                 g_string_assign(line_buf, RES_INVALID_LINE);
             }
-        }
-
-        if (status != 1) {
-            if (!mmdbr_pipe_valid()) {
-                // Should be due to mmdb_resolve_stop.
-                MMDB_DEBUG("invalid mmdbr stdout pipe. exiting thread.");
-                break;
-            }
-
-            MMDB_DEBUG("no pipe data");
-            g_usleep(MMDB_WAIT_TIME);
             continue;
         }
 
         char *line = g_strstrip(line_buf->str);
         size_t line_len = strlen(line);
-        MMDB_DEBUG("read %zd bytes, status %zd: %s", line_len, status, line);
-        if (line_len < 1) continue;
+        MMDB_DEBUG("read %zd bytes: %s", line_len, line);
+        if (line_len < 1) {
+            g_string_truncate(line_buf, 0);
+            continue;
+        }
 
         char *val_start = strchr(line, ':');
         if (val_start) {
@@ -361,6 +385,8 @@ read_mmdbr_stdout_worker(gpointer data _U_) {
             cur_addr[0] = '\0';
             init_lookup(&response->mmdb_val);
         }
+
+        g_string_truncate(line_buf, 0);
     }
 
     g_string_free(line_buf, TRUE);
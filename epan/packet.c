@@ -27,7 +27,10 @@
 #include "to_str.h"
 
 #include "addr_resolv.h"
+#include "address_intern.h"
 #include "tvbuff.h"
+#include "tvbuff_decompr_cache.h"
+#include "dissector_stats.h"
 #include "epan_dissect.h"
 
 #include <epan/wmem_scopes.h>
@@ -39,6 +42,7 @@
 #include <epan/prefs.h>
 #include <epan/range.h>
 
+#include <wsutil/glib-compat.h>
 #include <wsutil/str_util.h>
 #include <wsutil/wslog.h>
 #include <wsutil/ws_assert.h>
@@ -81,6 +85,11 @@ struct data_source {
  *
  * "protocol" is the protocol associated with the dissector table. Used
  * for determining dependencies.
+ *
+ * "uint_index" is a direct-index cache over "hash_table" for uint tables
+ * with a small key space (FT_UINT8/FT_UINT16); it's built lazily on the
+ * first lookup and thrown away whenever the table changes, so only tables
+ * actually consulted in the dissection hot path pay for it.
  */
 struct dissector_table {
 	GHashTable	*hash_table;
@@ -91,6 +100,8 @@ struct dissector_table {
 	protocol_t	*protocol;
 	GHashFunc	hash_func;
 	gboolean	supports_decode_as;
+	gboolean	consulted;	/* looked up since the last init_dissection() */
+	dtbl_entry_t	**uint_index;	/* see above */
 };
 
 /*
@@ -159,6 +170,7 @@ destroy_depend_dissector_list(void *data)
 struct heur_dissector_list {
 	protocol_t	*protocol;
 	GSList		*dissectors;
+	GSList		*sealed_out;	/* entries pruned while the profile is sealed */
 };
 
 static GHashTable *heur_dissector_lists = NULL;
@@ -166,6 +178,15 @@ static GHashTable *heur_dissector_lists = NULL;
 /* Name hashtables for fast detection of duplicate names */
 static GHashTable* heuristic_short_names  = NULL;
 
+/*
+ * Journal of successful heuristic outcomes, keyed by heuristic table and
+ * flow, so that a later pass over the same flows tries the entry that
+ * accepted them first instead of probing the whole list. See
+ * dissector_try_heuristic().
+ */
+static GHashTable* heur_journal = NULL;
+static gboolean heur_journal_preserved = FALSE;
+
 static void
 destroy_heuristic_dissector_entry(gpointer data)
 {
@@ -182,6 +203,7 @@ destroy_heuristic_dissector_list(void *data)
 	GSList **list = &(dissector_list->dissectors);
 
 	g_slist_free_full(*list, destroy_heuristic_dissector_entry);
+	g_slist_free_full(dissector_list->sealed_out, destroy_heuristic_dissector_entry);
 	g_slice_free(struct heur_dissector_list, dissector_list);
 }
 
@@ -190,6 +212,7 @@ destroy_dissector_table(void *data)
 {
 	struct dissector_table *table = (struct dissector_table *)data;
 
+	g_free(table->uint_index);
 	g_hash_table_destroy(table->hash_table);
 	g_slist_free(table->dissector_handles);
 	g_slice_free(struct dissector_table, data);
@@ -214,6 +237,9 @@ packet_init(void)
 			NULL, destroy_heuristic_dissector_list);
 
 	heuristic_short_names  = g_hash_table_new(g_str_hash, g_str_equal);
+
+	heur_journal = g_hash_table_new_full(g_str_hash, g_str_equal,
+			g_free, NULL);
 }
 
 void
@@ -261,6 +287,7 @@ packet_cleanup(void)
 	g_hash_table_destroy(depend_dissector_lists);
 	g_hash_table_destroy(heur_dissector_lists);
 	g_hash_table_destroy(heuristic_short_names);
+	g_hash_table_destroy(heur_journal);
 	g_slist_foreach(shutdown_routines, &call_routine, NULL);
 	g_slist_free(shutdown_routines);
 	if (postdissectors) {
@@ -310,6 +337,15 @@ register_shutdown_routine(void (*func)(void))
 	shutdown_routines = g_slist_prepend(shutdown_routines, (gpointer)func);
 }
 
+static void
+mark_dissector_table_unconsulted(gpointer key _U_, gpointer value,
+				 gpointer user_data _U_)
+{
+	struct dissector_table *table = (struct dissector_table *)value;
+
+	table->consulted = FALSE;
+}
+
 /* Initialize all data structures used for dissection. */
 void
 init_dissection(void)
@@ -321,6 +357,16 @@ init_dissection(void)
 	 */
 	host_name_lookup_reset();
 
+	/* A fresh dissection session hasn't consulted any dissector
+	   tables yet. */
+	if (dissector_tables)
+		g_hash_table_foreach(dissector_tables,
+		    mark_dissector_table_unconsulted, NULL);
+
+	/* Apply (or undo) the sealed-profile pruning for this session, so it
+	   reflects the protocol enablement as now configured. */
+	packet_apply_sealed_profile(prefs.sealed_profile);
+
 	wmem_enter_file_scope();
 
 	/* Initialize the table of conversations. */
@@ -332,6 +378,12 @@ init_dissection(void)
 	/* Initialize the stream-handling tables */
 	stream_init();
 
+	/* Start with an empty decompression result cache */
+	decompr_cache_init();
+
+	/* Start with an empty interned-address pool */
+	address_intern_init();
+
 	/* Initialize the expert infos */
 	expert_packet_init();
 }
@@ -345,6 +397,12 @@ cleanup_dissection(void)
 	/* Cleanup the stream-handling tables */
 	stream_cleanup();
 
+	/* Drop the decompression result cache */
+	decompr_cache_cleanup();
+
+	/* Drop the interned-address pool */
+	address_intern_cleanup();
+
 	/* Cleanup the expert infos */
 	expert_packet_cleanup();
 
@@ -715,6 +773,7 @@ struct dissector_handle {
 	enum dissector_e dissector_type;
 	void		*dissector_func;
 	void		*dissector_data;
+	batch_dissector_t batch_func;	/* optional batch entry point */
 	protocol_t	*protocol;
 };
 
@@ -783,7 +842,7 @@ call_dissector_work(dissector_handle_t handle, tvbuff_t *tvb, packet_info *pinfo
 	packet_info *pinfo = pinfo_arg;
 	const char  *saved_proto;
 	guint16      saved_can_desegment;
-	int          len;
+	volatile int len;
 	guint        saved_layers_len = 0;
 	guint        saved_tree_count = tree ? tree->tree_data->count : 0;
 
@@ -830,7 +889,29 @@ call_dissector_work(dissector_handle_t handle, tvbuff_t *tvb, packet_info *pinfo
 		}
 	}
 
-	if (pinfo->flags.in_error_pkt) {
+	if (dissector_stats_enabled() && handle->protocol != NULL) {
+		/*
+		 * Bracket the call so time and allocations get attributed
+		 * to this protocol. Dissectors bail out with exceptions,
+		 * so the bracket has to survive an unwind.
+		 */
+		int stats_proto_id = proto_get_id(handle->protocol);
+
+		dissector_stats_enter();
+		TRY {
+			if (pinfo->flags.in_error_pkt) {
+				len = call_dissector_work_error(handle, tvb, pinfo, tree, data);
+			} else {
+				len = call_dissector_through_handle(handle, tvb, pinfo, tree, data);
+			}
+		}
+		CATCH_ALL {
+			dissector_stats_leave(stats_proto_id);
+			RETHROW;
+		}
+		ENDTRY;
+		dissector_stats_leave(stats_proto_id);
+	} else if (pinfo->flags.in_error_pkt) {
 		len = call_dissector_work_error(handle, tvb, pinfo, tree, data);
 	} else {
 		/*
@@ -995,10 +1076,55 @@ find_dissector_table(const char *name)
 	return dissector_table;
 }
 
+gboolean
+dissector_table_consulted(const char *name)
+{
+	dissector_table_t dissector_table = find_dissector_table(name);
+
+	return dissector_table != NULL && dissector_table->consulted;
+}
+
+/* Size of the direct-index cache for a uint dissector table, or 0 if the
+   key space is too large to index directly. */
+static guint32
+uint_index_size(dissector_table_t sub_dissectors)
+{
+	switch (sub_dissectors->type) {
+
+	case FT_UINT8:
+		return 1 << 8;
+	case FT_UINT16:
+		return 1 << 16;
+	default:
+		return 0;
+	}
+}
+
+/* Throw away the direct-index cache; called whenever the table changes.
+   It will be rebuilt on the next lookup. */
+static void
+uint_index_invalidate(dissector_table_t sub_dissectors)
+{
+	g_free(sub_dissectors->uint_index);
+	sub_dissectors->uint_index = NULL;
+}
+
+static void
+uint_index_fill(gpointer key, gpointer value, gpointer user_data)
+{
+	dissector_table_t sub_dissectors = (dissector_table_t)user_data;
+	guint32 pattern = GPOINTER_TO_UINT(key);
+
+	if (pattern < uint_index_size(sub_dissectors))
+		sub_dissectors->uint_index[pattern] = (dtbl_entry_t *)value;
+}
+
 /* Find an entry in a uint dissector table. */
 static dtbl_entry_t *
 find_uint_dtbl_entry(dissector_table_t sub_dissectors, const guint32 pattern)
 {
+	guint32 index_size;
+
 	switch (sub_dissectors->type) {
 
 	case FT_UINT8:
@@ -1021,6 +1147,21 @@ find_uint_dtbl_entry(dissector_table_t sub_dissectors, const guint32 pattern)
 		ws_assert_not_reached();
 	}
 
+	/*
+	 * For small key spaces, consult the direct-index cache instead of
+	 * hashing; dispatch on ethertype, IP protocol and port tables goes
+	 * through here for every layer of every packet.
+	 */
+	index_size = uint_index_size(sub_dissectors);
+	if (index_size != 0 && pattern < index_size) {
+		if (G_UNLIKELY(sub_dissectors->uint_index == NULL)) {
+			sub_dissectors->uint_index = g_new0(dtbl_entry_t *, index_size);
+			g_hash_table_foreach(sub_dissectors->hash_table,
+			    uint_index_fill, sub_dissectors);
+		}
+		return sub_dissectors->uint_index[pattern];
+	}
+
 	/*
 	 * Find the entry.
 	 */
@@ -1107,6 +1248,7 @@ dissector_add_uint(const char *name, const guint32 pattern, dissector_handle_t h
 	/* do the table insertion */
 	g_hash_table_insert(sub_dissectors->hash_table,
 			     GUINT_TO_POINTER(pattern), (gpointer)dtbl_entry);
+	uint_index_invalidate(sub_dissectors);
 
 	/*
 	 * Now, if this table supports "Decode As", add this handle
@@ -1268,6 +1410,7 @@ dissector_delete_uint(const char *name, const guint32 pattern,
 		 */
 		g_hash_table_remove(sub_dissectors->hash_table,
 				    GUINT_TO_POINTER(pattern));
+		uint_index_invalidate(sub_dissectors);
 	}
 }
 
@@ -1309,6 +1452,7 @@ void dissector_delete_all(const char *name, dissector_handle_t handle)
 	ws_assert (sub_dissectors);
 
 	g_hash_table_foreach_remove (sub_dissectors->hash_table, dissector_delete_all_check, handle);
+	uint_index_invalidate(sub_dissectors);
 }
 
 static void
@@ -1318,6 +1462,7 @@ dissector_delete_from_table(gpointer key _U_, gpointer value, gpointer user_data
 	ws_assert (sub_dissectors);
 
 	g_hash_table_foreach_remove(sub_dissectors->hash_table, dissector_delete_all_check, user_data);
+	uint_index_invalidate(sub_dissectors);
 	sub_dissectors->dissector_handles = g_slist_remove(sub_dissectors->dissector_handles, user_data);
 }
 
@@ -1363,6 +1508,7 @@ dissector_change_uint(const char *name, const guint32 pattern, dissector_handle_
 	/* do the table insertion */
 	g_hash_table_insert(sub_dissectors->hash_table,
 			     GUINT_TO_POINTER(pattern), (gpointer)dtbl_entry);
+	uint_index_invalidate(sub_dissectors);
 }
 
 /* Reset an entry in a uint dissector table to its initial value. */
@@ -1391,6 +1537,7 @@ dissector_reset_uint(const char *name, const guint32 pattern)
 	} else {
 		g_hash_table_remove(sub_dissectors->hash_table,
 				    GUINT_TO_POINTER(pattern));
+		uint_index_invalidate(sub_dissectors);
 	}
 }
 
@@ -1408,6 +1555,7 @@ dissector_try_uint_new(dissector_table_t sub_dissectors, const guint32 uint_val,
 	guint32                  saved_match_uint;
 	int len;
 
+	sub_dissectors->consulted = TRUE;
 	dtbl_entry = find_uint_dtbl_entry(sub_dissectors, uint_val);
 	if (dtbl_entry == NULL) {
 		/*
@@ -1519,7 +1667,12 @@ find_string_dtbl_entry(dissector_table_t const sub_dissectors, const gchar *patt
 	if (sub_dissectors->param == TRUE) {
 		key = g_ascii_strdown(pattern, -1);
 	} else {
-		key = g_strdup(pattern);
+		/*
+		 * Case-sensitive tables can look the pattern up directly;
+		 * this runs for every payload of e.g. the media type table,
+		 * so don't copy the string just to hash it.
+		 */
+		return (dtbl_entry_t *)g_hash_table_lookup(sub_dissectors->hash_table, pattern);
 	}
 
 	/*
@@ -1715,6 +1868,7 @@ dissector_try_string_new(dissector_table_t sub_dissectors, const gchar *string,
 
 	/* XXX ASSERT instead ? */
 	if (!string) return 0;
+	sub_dissectors->consulted = TRUE;
 	dtbl_entry = find_string_dtbl_entry(sub_dissectors, string);
 	if (dtbl_entry != NULL) {
 		/*
@@ -1911,6 +2065,7 @@ int dissector_try_guid_new(dissector_table_t sub_dissectors,
 	struct dissector_handle *handle;
 	int len;
 
+	sub_dissectors->consulted = TRUE;
 	dtbl_entry = (dtbl_entry_t *)g_hash_table_lookup(sub_dissectors->hash_table, guid_val);
 	if (dtbl_entry != NULL) {
 		/*
@@ -2531,6 +2686,8 @@ register_dissector_table(const char *name, const char *ui_name, const int proto,
 	sub_dissectors->param   = param;
 	sub_dissectors->protocol  = find_protocol_by_id(proto);
 	sub_dissectors->supports_decode_as = FALSE;
+	sub_dissectors->consulted = FALSE;
+	sub_dissectors->uint_index = NULL;
 	g_hash_table_insert(dissector_tables, (gpointer)name, (gpointer) sub_dissectors);
 	return sub_dissectors;
 }
@@ -2560,6 +2717,8 @@ dissector_table_t register_custom_dissector_table(const char *name,
 	sub_dissectors->param   = BASE_NONE;
 	sub_dissectors->protocol  = find_protocol_by_id(proto);
 	sub_dissectors->supports_decode_as = FALSE;
+	sub_dissectors->consulted = FALSE;
+	sub_dissectors->uint_index = NULL;
 	g_hash_table_insert(dissector_tables, (gpointer)name, (gpointer) sub_dissectors);
 	return sub_dissectors;
 }
@@ -2666,6 +2825,30 @@ heur_dtbl_entry_t* find_heur_dissector_by_unique_short_name(const char *short_na
 	return (heur_dtbl_entry_t*)g_hash_table_lookup(heuristic_short_names, short_name);
 }
 
+static void
+heur_enabled_state_hash_cb(gpointer key _U_, gpointer value, gpointer user_data)
+{
+	heur_dtbl_entry_t *hdtbl_entry = (heur_dtbl_entry_t *)value;
+	guint *hash = (guint *)user_data;
+
+	if (!hdtbl_entry->enabled)
+		*hash ^= g_str_hash(hdtbl_entry->short_name);
+}
+
+guint
+heur_dissectors_enabled_state_hash(void)
+{
+	guint hash = 0;
+
+	/* XOR the hashes of the disabled entries' short names, so the
+	   result doesn't depend on the table's iteration order and two
+	   snapshots compare equal exactly when the same set is disabled. */
+	if (heuristic_short_names != NULL)
+		g_hash_table_foreach(heuristic_short_names,
+		    heur_enabled_state_hash_cb, &hash);
+	return hash;
+}
+
 void
 heur_dissector_add(const char *name, heur_dissector_t dissector, const char *display_name, const char *internal_name, const int proto, heuristic_enable_e enable)
 {
@@ -2727,6 +2910,7 @@ heur_dissector_add(const char *name, heur_dissector_t dissector, const char *dis
 	hdtbl_entry->short_name = g_strdup(internal_name);
 	hdtbl_entry->list_name = g_strdup(name);
 	hdtbl_entry->enabled   = (enable == HEURISTIC_ENABLE);
+	hdtbl_entry->signatures = NULL;
 
 	/* do the table insertion */
 	g_hash_table_insert(heuristic_short_names, (gpointer)hdtbl_entry->short_name, hdtbl_entry);
@@ -2744,7 +2928,138 @@ heur_dissector_add(const char *name, heur_dissector_t dissector, const char *dis
 		register_depend_dissector(proto_get_protocol_short_name(sub_dissectors->protocol), proto_get_protocol_short_name(hdtbl_entry->protocol));
 }
 
+/*
+ * A byte-signature pre-check for a heuristic dissector: "magic_len" fixed
+ * bytes at a fixed offset in the payload. Payloads that don't carry any of
+ * an entry's signatures can't be accepted by its dissector, so
+ * dissector_try_heuristic() skips the callback for them.
+ */
+typedef struct heur_signature {
+	guint   offset;
+	guint   len;
+	guint8 *magic;
+} heur_signature_t;
+
+static void
+heur_signature_free(gpointer data)
+{
+	heur_signature_t *sig = (heur_signature_t *)data;
+
+	g_free(sig->magic);
+	g_free(sig);
+}
+
+void
+heur_dissector_add_signature(const char *internal_name, const guint offset,
+    const guint8 *magic, const guint magic_len)
+{
+	heur_dtbl_entry_t *hdtbl_entry;
+	heur_signature_t  *sig;
+
+	hdtbl_entry = find_heur_dissector_by_unique_short_name(internal_name);
+	if (hdtbl_entry == NULL) {
+		fprintf(stderr, "OOPS: heuristic dissector \"%s\" doesn't exist\n",
+		    internal_name);
+		if (wireshark_abort_on_dissector_bug)
+			abort();
+		return;
+	}
+	if (magic == NULL || magic_len == 0) {
+		ws_error("Heuristic dissector \"%s\" is registering an empty byte signature."
+			" This might be caused by an inappropriate plugin or a development error.", internal_name);
+	}
+
+	sig = g_new(heur_signature_t, 1);
+	sig->offset = offset;
+	sig->len    = magic_len;
+	sig->magic  = (guint8 *)g_memdup2(magic, magic_len);
+
+	hdtbl_entry->signatures = g_slist_append(hdtbl_entry->signatures, sig);
+}
+
+static gboolean
+heur_signature_plausible(const heur_dtbl_entry_t *hdtbl_entry, tvbuff_t *tvb)
+{
+	const GSList           *sig_entry;
+	const heur_signature_t *sig;
+
+	if (hdtbl_entry->signatures == NULL) {
+		/* No pre-check registered; the payload is always plausible. */
+		return TRUE;
+	}
+
+	for (sig_entry = hdtbl_entry->signatures; sig_entry != NULL;
+	    sig_entry = g_slist_next(sig_entry)) {
+		sig = (const heur_signature_t *)sig_entry->data;
+		if (tvb_bytes_exist(tvb, sig->offset, sig->len) &&
+		    tvb_memeql(tvb, sig->offset, sig->magic, sig->len) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/*
+ * Build the journal key for a heuristic table and the current flow. The
+ * table has no name of its own, so its address (stable for the lifetime
+ * of the program) stands in for it. The flow direction is normalized so
+ * both directions of a conversation share an entry.
+ */
+static gchar *
+heur_journal_key(heur_dissector_list_t sub_dissectors, packet_info *pinfo)
+{
+	const address *addr_a = &pinfo->src;
+	const address *addr_b = &pinfo->dst;
+	guint32        port_a = pinfo->srcport;
+	guint32        port_b = pinfo->destport;
+	const guint8  *addr_data;
+	GString       *key;
+	int            cmp, i;
+
+	cmp = cmp_address(addr_a, addr_b);
+	if (cmp > 0 || (cmp == 0 && port_a > port_b)) {
+		addr_a = &pinfo->dst;
+		addr_b = &pinfo->src;
+		port_a = pinfo->destport;
+		port_b = pinfo->srcport;
+	}
 
+	key = g_string_new(NULL);
+	g_string_append_printf(key, "%p|%d|", (void *)sub_dissectors, pinfo->ptype);
+	addr_data = (const guint8 *)addr_a->data;
+	for (i = 0; i < addr_a->len; i++)
+		g_string_append_printf(key, "%02x", addr_data[i]);
+	g_string_append_printf(key, "|%u|", port_a);
+	addr_data = (const guint8 *)addr_b->data;
+	for (i = 0; i < addr_b->len; i++)
+		g_string_append_printf(key, "%02x", addr_data[i]);
+	g_string_append_printf(key, "|%u", port_b);
+
+	return g_string_free(key, FALSE);
+}
+
+void
+heur_dissector_journal_preserve(void)
+{
+	heur_journal_preserved = TRUE;
+}
+
+void
+heur_dissector_journal_clear(void)
+{
+	if (heur_journal_preserved) {
+		/* A reload of the same capture wants the learned bindings. */
+		heur_journal_preserved = FALSE;
+		return;
+	}
+	if (heur_journal != NULL)
+		g_hash_table_remove_all(heur_journal);
+}
+
+static gboolean
+heur_journal_entry_matches(gpointer key _U_, gpointer value, gpointer user_data)
+{
+	return value == user_data;
+}
 
 static int
 find_matching_heur_dissector(gconstpointer a, gconstpointer b) {
@@ -2769,18 +3084,85 @@ heur_dissector_delete(const char *name, heur_dissector_t dissector, const int pr
 
 	found_entry = g_slist_find_custom(sub_dissectors->dissectors,
 	    (gpointer) &hdtbl_entry, find_matching_heur_dissector);
+	if (found_entry == NULL) {
+		/* The entry may have been pruned by a sealed profile. */
+		found_entry = g_slist_find_custom(sub_dissectors->sealed_out,
+		    (gpointer) &hdtbl_entry, find_matching_heur_dissector);
+	}
 
 	if (found_entry) {
 		heur_dtbl_entry_t *found_hdtbl_entry = (heur_dtbl_entry_t *)(found_entry->data);
+		if (heur_journal != NULL) {
+			/* Drop journal entries that point at the dying entry. */
+			g_hash_table_foreach_remove(heur_journal,
+			    heur_journal_entry_matches, found_hdtbl_entry);
+		}
 		g_free(found_hdtbl_entry->list_name);
 		g_hash_table_remove(heuristic_short_names, found_hdtbl_entry->short_name);
 		g_free(found_hdtbl_entry->short_name);
+		g_slist_free_full(found_hdtbl_entry->signatures, heur_signature_free);
 		g_slice_free(heur_dtbl_entry_t, found_entry->data);
-		sub_dissectors->dissectors = g_slist_delete_link(sub_dissectors->dissectors,
+		sub_dissectors->dissectors = g_slist_remove_link(sub_dissectors->dissectors,
+		    found_entry);
+		sub_dissectors->sealed_out = g_slist_remove_link(sub_dissectors->sealed_out,
 		    found_entry);
+		g_slist_free_1(found_entry);
+	}
+}
+
+/*
+ * "Sealed profile" support.  When the protocols.sealed_profile preference
+ * is set, the configured protocol enablement is treated as fixed for the
+ * dissection session: heuristic entries whose protocol is disabled are
+ * pruned from the dispatch lists up front, so dissector_try_heuristic()
+ * doesn't walk over and re-check them for every packet.  Pruned entries
+ * are parked on the list's sealed_out slist; every seal starts by
+ * restoring them, so a re-seal after enablement changes (and the
+ * redissection those trigger) always works from the full lists.
+ */
+static gboolean dissectors_sealed = FALSE;
+
+static void
+unseal_heur_dissector_list(gpointer key _U_, gpointer value, gpointer user_data _U_)
+{
+	heur_dissector_list_t list = (heur_dissector_list_t)value;
+
+	list->dissectors = g_slist_concat(list->dissectors, list->sealed_out);
+	list->sealed_out = NULL;
+}
+
+static void
+seal_heur_dissector_list(gpointer key _U_, gpointer value, gpointer user_data _U_)
+{
+	heur_dissector_list_t list = (heur_dissector_list_t)value;
+	GSList *entry, *next;
+
+	for (entry = list->dissectors; entry != NULL; entry = next) {
+		heur_dtbl_entry_t *hdtbl_entry = (heur_dtbl_entry_t *)entry->data;
+
+		next = g_slist_next(entry);
+		if (hdtbl_entry->protocol != NULL &&
+		    (!proto_is_protocol_enabled(hdtbl_entry->protocol) ||
+		     !hdtbl_entry->enabled)) {
+			list->dissectors = g_slist_remove_link(list->dissectors, entry);
+			list->sealed_out = g_slist_concat(list->sealed_out, entry);
+		}
 	}
 }
 
+void
+packet_apply_sealed_profile(gboolean sealed)
+{
+	if (heur_dissector_lists == NULL)
+		return;
+
+	if (dissectors_sealed)
+		g_hash_table_foreach(heur_dissector_lists, unseal_heur_dissector_list, NULL);
+	if (sealed)
+		g_hash_table_foreach(heur_dissector_lists, seal_heur_dissector_list, NULL);
+	dissectors_sealed = sealed;
+}
+
 gboolean
 dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 			packet_info *pinfo, proto_tree *tree, heur_dtbl_entry_t **heur_dtbl_entry, void *data)
@@ -2819,6 +3201,27 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 
 	DISSECTOR_ASSERT(saved_layers_len < PINFO_LAYER_MAX_RECURSION_DEPTH);
 
+	/*
+	 * If an entry in this table already accepted this flow on an earlier
+	 * pass (or an earlier load of the same file), move it to the front of
+	 * the list so it's tried before any probing. The entry still goes
+	 * through the normal checks below, so a stale journal entry costs at
+	 * most one extra try.
+	 */
+	if (heur_journal != NULL && g_hash_table_size(heur_journal) > 0) {
+		gchar *key = heur_journal_key(sub_dissectors, pinfo);
+		hdtbl_entry = (heur_dtbl_entry_t *)g_hash_table_lookup(heur_journal, key);
+		g_free(key);
+		if (hdtbl_entry != NULL && sub_dissectors->dissectors != NULL &&
+		    sub_dissectors->dissectors->data != hdtbl_entry) {
+			entry = g_slist_find(sub_dissectors->dissectors, hdtbl_entry);
+			if (entry != NULL) {
+				sub_dissectors->dissectors = g_slist_remove_link(sub_dissectors->dissectors, entry);
+				sub_dissectors->dissectors = g_slist_concat(entry, sub_dissectors->dissectors);
+			}
+		}
+	}
+
 	for (entry = sub_dissectors->dissectors; entry != NULL;
 	    entry = g_slist_next(entry)) {
 		/* XXX - why set this now and above? */
@@ -2833,6 +3236,15 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 			continue;
 		}
 
+		if (!heur_signature_plausible(hdtbl_entry, tvb)) {
+			/*
+			 * The payload doesn't carry any of this entry's
+			 * byte signatures, so its dissector would reject
+			 * it; don't pay for the full check.
+			 */
+			continue;
+		}
+
 		if (hdtbl_entry->protocol != NULL) {
 			proto_id = proto_get_id(hdtbl_entry->protocol);
 			/* do NOT change this behavior - wslua uses the protocol short name set here in order
@@ -2879,6 +3291,15 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 				sub_dissectors->dissectors = g_slist_remove_link(sub_dissectors->dissectors, entry);
 				sub_dissectors->dissectors = g_slist_concat(entry, sub_dissectors->dissectors);
 			}
+			/* Journal the outcome so later passes over this flow
+			   try this entry first. */
+			if (heur_journal != NULL) {
+				gchar *key = heur_journal_key(sub_dissectors, pinfo);
+				if (g_hash_table_lookup(heur_journal, key) != (gpointer)hdtbl_entry)
+					g_hash_table_insert(heur_journal, key, hdtbl_entry);
+				else
+					g_free(key);
+			}
 			status = TRUE;
 			break;
 		}
@@ -3039,6 +3460,7 @@ register_heur_dissector_list(const char *name, const int proto)
 	sub_dissectors = g_slice_new(struct heur_dissector_list);
 	sub_dissectors->protocol  = find_protocol_by_id(proto);
 	sub_dissectors->dissectors = NULL;	/* initially empty */
+	sub_dissectors->sealed_out = NULL;
 	g_hash_table_insert(heur_dissector_lists, (gpointer)name,
 			    (gpointer) sub_dissectors);
 	return sub_dissectors;
@@ -3144,6 +3566,7 @@ new_dissector_handle(enum dissector_e type, void *dissector, const int proto, co
 	handle->dissector_type	= type;
 	handle->dissector_func	= dissector;
 	handle->dissector_data	= cb_data;
+	handle->batch_func	= NULL;
 	handle->protocol	= find_protocol_by_id(proto);
 	return handle;
 }
@@ -3162,6 +3585,16 @@ create_dissector_handle_with_name(dissector_t dissector,
 	return new_dissector_handle(DISSECTOR_TYPE_SIMPLE, dissector, proto, name, NULL);
 }
 
+/* Attach an optional batch entry point to a handle; see
+   call_dissector_batch(). */
+void
+dissector_handle_set_batch(dissector_handle_t handle, batch_dissector_t batch_dissector)
+{
+	ws_assert(handle != NULL);
+
+	handle->batch_func = batch_dissector;
+}
+
 /* Destroy an anonymous handle for a dissector. */
 static void
 destroy_dissector_handle(dissector_handle_t handle)
@@ -3260,6 +3693,87 @@ call_dissector_only(dissector_handle_t handle, tvbuff_t *tvb,
 	return ret;
 }
 
+/* Call a dissector once for a run of consecutive messages that all
+ * resolved to the same handle. Falls back to one call per message for
+ * handles without a batch entry point, so callers don't have to care
+ * whether the child registered one.
+ */
+int
+call_dissector_batch(dissector_handle_t handle, tvbuff_t **tvbs, guint num_tvbs,
+		     packet_info *pinfo, proto_tree *tree, void *data)
+{
+	const char   *saved_proto;
+	guint16       saved_can_desegment;
+	guint         saved_layers_len;
+	volatile int  len;
+	guint         i;
+
+	DISSECTOR_ASSERT(handle != NULL);
+
+	if (num_tvbs == 0)
+		return 0;
+
+	if (handle->batch_func == NULL) {
+		/*
+		 * No batch entry point; dissect the run one message at
+		 * a time, exactly as if the caller had looped itself.
+		 */
+		len = 0;
+		for (i = 0; i < num_tvbs; i++)
+			len += call_dissector_work(handle, tvbs[i], pinfo, tree, TRUE, data);
+		return len;
+	}
+
+	if (handle->protocol != NULL &&
+	    !proto_is_protocol_enabled(handle->protocol)) {
+		/*
+		 * The protocol isn't enabled.
+		 */
+		return 0;
+	}
+
+	/*
+	 * Bracket the batch call the way call_dissector_work() brackets
+	 * a single call: the whole run shows up as one layer of the
+	 * handle's protocol, and desegmentation is handed down one
+	 * level once.
+	 */
+	saved_proto = pinfo->current_proto;
+	saved_can_desegment = pinfo->can_desegment;
+	saved_layers_len = wmem_list_count(pinfo->layers);
+	DISSECTOR_ASSERT(saved_layers_len < PINFO_LAYER_MAX_RECURSION_DEPTH);
+
+	pinfo->saved_can_desegment = saved_can_desegment;
+	pinfo->can_desegment = saved_can_desegment-(saved_can_desegment>0);
+	if ((handle->protocol != NULL) && (!proto_is_pino(handle->protocol))) {
+		pinfo->current_proto =
+			proto_get_protocol_short_name(handle->protocol);
+		pinfo->curr_layer_num++;
+		wmem_list_append(pinfo->layers, GINT_TO_POINTER(proto_get_id(handle->protocol)));
+	}
+
+	if (dissector_stats_enabled() && handle->protocol != NULL) {
+		int stats_proto_id = proto_get_id(handle->protocol);
+
+		dissector_stats_enter();
+		TRY {
+			len = handle->batch_func(tvbs, num_tvbs, pinfo, tree, data);
+		}
+		CATCH_ALL {
+			dissector_stats_leave(stats_proto_id);
+			RETHROW;
+		}
+		ENDTRY;
+		dissector_stats_leave(stats_proto_id);
+	} else {
+		len = handle->batch_func(tvbs, num_tvbs, pinfo, tree, data);
+	}
+
+	pinfo->current_proto = saved_proto;
+	pinfo->can_desegment = saved_can_desegment;
+	return len;
+}
+
 /* Call a dissector through a handle and if this fails call the "data"
  * dissector.
  */
@@ -79,6 +79,18 @@ typedef int (*dissector_t)(tvbuff_t *, packet_info *, proto_tree *, void *);
 /* Same as dissector_t with an extra parameter for callback pointer */
 typedef int (*dissector_cb_t)(tvbuff_t *, packet_info *, proto_tree *, void *, void *);
 
+/*
+ * Optional batch dissector entry point; see call_dissector_batch().
+ * Receives an array of tvbuffs holding consecutive messages, in frame
+ * order, that all resolved to the same handle, so the implementation
+ * can amortize per-call setup across the run instead of paying it per
+ * message. All of the messages belong to the frame described by pinfo.
+ *
+ * Returns the total number of bytes consumed across the run.
+ */
+typedef int (*batch_dissector_t)(tvbuff_t **tvbs, guint num_tvbs,
+	packet_info *, proto_tree *, void *);
+
 /** Type of a heuristic dissector, used in heur_dissector_add().
  *
  * @param tvb the tvbuff with the (remaining) packet data
@@ -195,6 +207,13 @@ void deregister_dissector_table(const char *name);
 /* Find a dissector table by table name. */
 WS_DLL_PUBLIC dissector_table_t find_dissector_table(const char *name);
 
+/* Has this table been looked up by any dissector since the last
+ * init_dissection()?  If not, changing its entries cannot affect the
+ * dissection of any frame in the current session, so e.g. a "Decode As"
+ * change to it doesn't require a redissection.  Returns FALSE for
+ * unknown table names. */
+WS_DLL_PUBLIC gboolean dissector_table_consulted(const char *name);
+
 /* Get the UI name for a sub-dissector table, given its internal name */
 WS_DLL_PUBLIC const char *get_dissector_table_ui_name(const char *name);
 
@@ -441,6 +460,7 @@ typedef struct heur_dtbl_entry {
 	const gchar *display_name;     /* the string used to present heuristic to user */
 	gchar *short_name;     /* string used for "internal" use to uniquely identify heuristic */
 	gboolean enabled;
+	GSList *signatures;   /* byte-signature pre-checks; see heur_dissector_add_signature() */
 } heur_dtbl_entry_t;
 
 /** A protocol uses this function to register a heuristic sub-dissector list.
@@ -511,6 +531,15 @@ WS_DLL_PUBLIC heur_dissector_list_t find_heur_dissector_list(const char *name);
  */
 WS_DLL_PUBLIC heur_dtbl_entry_t* find_heur_dissector_by_unique_short_name(const char *short_name);
 
+/** Get a hash over which heuristic dissectors are currently disabled.
+ * Comparing snapshots taken before and after reloading the heuristic
+ * dissector lists tells whether the set actually changed, e.g. to
+ * decide if redissection is needed.
+ *
+ * @return a hash of the set of disabled heuristic dissectors
+ */
+WS_DLL_PUBLIC guint heur_dissectors_enabled_state_hash(void);
+
 /** Add a sub-dissector to a heuristic dissector list.
  *  Call this in the proto_handoff function of the sub-dissector.
  *
@@ -524,6 +553,26 @@ WS_DLL_PUBLIC heur_dtbl_entry_t* find_heur_dissector_by_unique_short_name(const
 WS_DLL_PUBLIC void heur_dissector_add(const char *name, heur_dissector_t dissector,
     const char *display_name, const char *internal_name, const int proto, heuristic_enable_e enable);
 
+/** Attach a byte-signature pre-check to a registered heuristic sub-dissector.
+ *  Call this in the proto_handoff function of the sub-dissector, after
+ *  heur_dissector_add().
+ *
+ *  A heuristic dissector whose check begins by matching fixed bytes at a
+ *  fixed offset can declare those bytes here; dissector_try_heuristic()
+ *  will then skip the dissector callback entirely for payloads that can't
+ *  match. A dissector may register several signatures; the callback runs
+ *  if any of them matches. Dissectors without signatures are always called,
+ *  so this is purely an opt-in fast path. Only register a signature if the
+ *  dissector rejects every payload that doesn't carry it.
+ *
+ * @param internal_name the heuristic's unique internal name, e.g. "http_tcp"
+ * @param offset offset within the payload where the magic bytes live
+ * @param magic the magic bytes the dissector requires
+ * @param magic_len the number of magic bytes; must be > 0
+ */
+WS_DLL_PUBLIC void heur_dissector_add_signature(const char *internal_name,
+    const guint offset, const guint8 *magic, const guint magic_len);
+
 /** Remove a sub-dissector from a heuristic dissector list.
  *  Call this in the prefs_reinit function of the sub-dissector.
  *
@@ -533,6 +582,23 @@ WS_DLL_PUBLIC void heur_dissector_add(const char *name, heur_dissector_t dissect
  */
 WS_DLL_PUBLIC void heur_dissector_delete(const char *name, heur_dissector_t dissector, const int proto);
 
+/** Keep the journal of successful heuristic outcomes across the next
+ *  capture file close.
+ *
+ *  Successful heuristic negotiations are journaled per flow while a file
+ *  is dissected, and dissector_try_heuristic() tries a journaled entry
+ *  first before probing the rest of its table. Calling this right before
+ *  reloading a capture file keeps the journal alive through the close, so
+ *  the reload skips probing for every flow it has already seen.
+ */
+WS_DLL_PUBLIC void heur_dissector_journal_preserve(void);
+
+/** Forget journaled heuristic outcomes, unless a preceding call to
+ *  heur_dissector_journal_preserve() asked to keep them. Called when a
+ *  capture file is closed.
+ */
+WS_DLL_PUBLIC void heur_dissector_journal_clear(void);
+
 /** Register a new dissector. */
 WS_DLL_PUBLIC dissector_handle_t register_dissector(const char *name, dissector_t dissector, const int proto);
 
@@ -569,6 +635,14 @@ WS_DLL_PUBLIC dissector_handle_t create_dissector_handle(dissector_t dissector,
 WS_DLL_PUBLIC dissector_handle_t create_dissector_handle_with_name(dissector_t dissector,
     const int proto, const char* name);
 
+/** Attach an optional batch entry point to a dissector handle.
+ * call_dissector_batch() hands a run of same-protocol messages to the
+ * batch entry point in a single call; handles without one are called
+ * once per message. Pass NULL to remove a previously set entry point.
+ */
+WS_DLL_PUBLIC void dissector_handle_set_batch(dissector_handle_t handle,
+    batch_dissector_t batch_dissector);
+
 /** Call a dissector through a handle and if no dissector was found
  * pass it over to the "data" dissector instead.
  *
@@ -605,6 +679,25 @@ WS_DLL_PUBLIC int call_data_dissector(tvbuff_t *tvb, packet_info *pinfo, proto_t
 WS_DLL_PUBLIC int call_dissector_only(dissector_handle_t handle, tvbuff_t *tvb,
     packet_info *pinfo, proto_tree *tree, void *data);
 
+/** Call a dissector once for a run of consecutive messages that all
+ * resolved to the same handle, e.g. fixed-size PDUs a parent dissector
+ * collected from a single TCP or UDP payload.
+ *
+ *   @param handle The dissector to call.
+ *   @param  tvbs Array of buffers, one per message, in frame order.
+ *   @param  num_tvbs Number of entries in tvbs.
+ *   @param  pinfo Packet Info.
+ *   @param  tree The protocol tree.
+ *   @param  data parameter to pass to dissector
+ *   @return The total number of bytes consumed. If the handle has a
+ *   batch entry point the whole run is dissected in one call, showing
+ *   up as a single layer of the handle's protocol; otherwise the
+ *   handle's dissector is called once per buffer, exactly as if the
+ *   caller had looped call_dissector_only() itself.
+ */
+WS_DLL_PUBLIC int call_dissector_batch(dissector_handle_t handle, tvbuff_t **tvbs,
+    guint num_tvbs, packet_info *pinfo, proto_tree *tree, void *data);
+
 /**
  *   @param heur_dtbl_entry The heur_dtbl_entry of the dissector to call.
  *   @param  tvb The buffer to dissect.
@@ -688,6 +781,12 @@ WS_DLL_PUBLIC void register_shutdown_routine(void (*func)(void));
 /* Initialize all data structures used for dissection. */
 void init_dissection(void);
 
+/* Apply or undo the sealed-profile pruning of heuristic dispatch lists
+ * (see the protocols.sealed_profile preference).  Called from
+ * init_dissection(), so it tracks the enablement configured when a
+ * dissection session starts. */
+WS_DLL_PUBLIC void packet_apply_sealed_profile(gboolean sealed);
+
 /* Free data structures allocated for dissection. */
 void cleanup_dissection(void);
 
@@ -915,19 +915,22 @@ prefs_modules_foreach_submodules(module_t *module, module_cb callback,
 }
 
 static gboolean
-call_apply_cb(const void *key _U_, void *value, void *data _U_)
+call_apply_cb(const void *key _U_, void *value, void *data)
 {
     module_t *module = (module_t *)value;
+    unsigned int *changed_flags = (unsigned int *)data;
 
     if (module->obsolete)
         return FALSE;
     if (module->prefs_changed_flags) {
+        if (changed_flags != NULL)
+            *changed_flags |= module->prefs_changed_flags;
         if (module->apply_cb != NULL)
             (*module->apply_cb)();
         module->prefs_changed_flags = 0;
     }
     if (module->submodules)
-        wmem_tree_foreach(module->submodules, call_apply_cb, NULL);
+        wmem_tree_foreach(module->submodules, call_apply_cb, data);
     return FALSE;
 }
 
@@ -935,12 +938,16 @@ call_apply_cb(const void *key _U_, void *value, void *data _U_)
  * Call the "apply" callback function for each module if any of its
  * preferences have changed, and then clear the flag saying its
  * preferences have changed, as the module has been notified of that
- * fact.
+ * fact.  Returns the effect flags of everything that changed, so the
+ * caller can tell whether e.g. redissection is warranted.
  */
-void
+unsigned int
 prefs_apply_all(void)
 {
-    wmem_tree_foreach(prefs_modules, call_apply_cb, NULL);
+    unsigned int changed_flags = 0;
+
+    wmem_tree_foreach(prefs_modules, call_apply_cb, &changed_flags);
+    return changed_flags;
 }
 
 /*
@@ -3038,6 +3045,15 @@ prefs_register_modules(void)
      */
     gui_module = prefs_register_module(NULL, "gui", "User Interface",
         "User Interface", &gui_callback, FALSE);
+    /* The GUI preferences are cosmetic: they change how dissection
+     * results are presented, not the results themselves, so changing
+     * them must not trigger redissection.  Do this before registering
+     * the preferences below, as each preference copies the module's
+     * effect flags when it is created.  Anything that does affect the
+     * dissection (e.g. custom column fields) sets its own flags.
+     */
+    prefs_set_module_effect_flags(gui_module,
+        prefs_get_module_effect_flags(gui_module) & (~PREF_EFFECT_DISSECTION));
 
     /* gui.console_open is placed first in the list so that any problems encountered
      *  in the following prefs can be displayed in the console window.
@@ -3700,6 +3716,15 @@ prefs_register_modules(void)
                                    "Currently ICMP and ICMPv6 use this preference to add VLAN ID to conversation tracking, and IPv4 uses this preference to take VLAN ID into account during reassembly",
                                    &prefs.strict_conversation_tracking_heuristics);
 
+    prefs_register_bool_preference(protocols_module, "sealed_profile",
+                                   "Seal the configured protocol set",
+                                   "Treat the current protocol enablement as fixed: heuristic dissectors "
+                                   "of disabled protocols are pruned from the dispatch lists up front "
+                                   "instead of being skipped on every packet. "
+                                   "Intended for monitors that only ever decode a known protocol stack; "
+                                   "applied when the next dissection session starts.",
+                                   &prefs.sealed_profile);
+
     /* Obsolete preferences
      * These "modules" were reorganized/renamed to correspond to their GUI
      * configuration screen within the preferences dialog
@@ -4288,21 +4313,69 @@ reset_pref_cb(gpointer data, gpointer user_data)
 {
     pref_t *pref = (pref_t *) data;
     module_t *module = (module_t *)user_data;
+    gboolean changed;
 
-    if (pref && (pref->type == PREF_RANGE || pref->type == PREF_DECODE_AS_RANGE)) {
-        /*
-         * Some dissectors expect the range (returned via prefs_get_range_value)
-         * to remain valid if it has not changed. If it did change, then we
-         * should set "prefs_changed_flags" to ensure that the preference apply
-         * callback is invoked. That callback will notify dissectors that it
-         * should no longer assume the range to be valid.
-         */
-        if (ranges_are_equal(*pref->varp.range, pref->default_val.range)) {
-            /* Optimization: do not invoke apply callback if nothing changed. */
-            return;
-        }
-        module->prefs_changed_flags |= prefs_get_effect_flags(pref);
+    if (!pref)
+        return;
+
+    /*
+     * Only mark the module as changed if resetting this preference
+     * really changes its value, so that the apply callback is invoked
+     * when it has to be (a value silently snapping back to its default
+     * is as much of a change as one set from a file) and stays quiet
+     * when nothing moved.  For ranges that's also a correctness matter:
+     * some dissectors expect the range (returned via
+     * prefs_get_range_value) to remain valid if it has not changed.
+     */
+    switch (pref->type) {
+
+    case PREF_UINT:
+    case PREF_DECODE_AS_UINT:
+        changed = (*pref->varp.uint != pref->default_val.uint);
+        break;
+
+    case PREF_BOOL:
+        changed = (*pref->varp.boolp != pref->default_val.boolval);
+        break;
+
+    case PREF_ENUM:
+        changed = (*pref->varp.enump != pref->default_val.enumval);
+        break;
+
+    case PREF_STRING:
+    case PREF_SAVE_FILENAME:
+    case PREF_OPEN_FILENAME:
+    case PREF_DIRNAME:
+        changed = (g_strcmp0(*pref->varp.string, pref->default_val.string) != 0);
+        break;
+
+    case PREF_RANGE:
+    case PREF_DECODE_AS_RANGE:
+        changed = !ranges_are_equal(*pref->varp.range, pref->default_val.range);
+        break;
+
+    case PREF_COLOR:
+        changed = (pref->varp.colorp->red != pref->default_val.color.red ||
+                   pref->varp.colorp->green != pref->default_val.color.green ||
+                   pref->varp.colorp->blue != pref->default_val.color.blue);
+        break;
+
+    case PREF_CUSTOM:
+        /* We have no way to compare; assume the reset changes it. */
+        changed = TRUE;
+        break;
+
+    default:
+        /* PREF_STATIC_TEXT, PREF_UAT, obsolete: nothing to reset. */
+        changed = FALSE;
+        break;
+    }
+
+    if (!changed) {
+        /* Optimization: do not invoke apply callback if nothing changed. */
+        return;
     }
+    module->prefs_changed_flags |= prefs_get_effect_flags(pref);
     reset_pref(pref);
 }
 
@@ -208,6 +208,7 @@ typedef struct _e_prefs {
   gboolean     enable_incomplete_dissectors_check;
   gboolean     incomplete_dissectors_check_debug;
   gboolean     strict_conversation_tracking_heuristics;
+  gboolean     sealed_profile; /* Treat protocol enablement as fixed and prune dispatch accordingly */
   gboolean     filter_expressions_old;  /* TRUE if old filter expressions preferences were loaded. */
   gboolean     gui_update_enabled;
   software_update_channel_e gui_update_channel;
@@ -356,9 +357,11 @@ WS_DLL_PUBLIC guint prefs_modules_foreach_submodules(module_t *module, module_cb
  * Call the "apply" callback function for each module if any of its
  * preferences have changed, and then clear the flag saying its
  * preferences have changed, as the module has been notified of that
- * fact.
+ * fact.  Returns the union of the effect flags (PREF_EFFECT_DISSECTION
+ * etc.) of all the preferences that had changed, so the caller can tell
+ * whether, for example, redissection is warranted.
  */
-WS_DLL_PUBLIC void prefs_apply_all(void);
+WS_DLL_PUBLIC unsigned int prefs_apply_all(void);
 
 /*
  * Call the "apply" callback function for a specific module if any of
@@ -1802,52 +1802,44 @@ get_field_data(GSList *src_list, field_info *fi)
 static void
 print_escaped_xml(FILE *fh, const char *unescaped_string)
 {
-    const char *p;
-
-#define ESCAPED_BUFFER_MAX 256
-    static char temp_buffer[ESCAPED_BUFFER_MAX];
-    gint        offset = 0;
+    const char *p = unescaped_string;
+    size_t      span;
 
     if (fh == NULL || unescaped_string == NULL) {
         return;
     }
 
-    for (p = unescaped_string; *p != '\0' && (offset<(ESCAPED_BUFFER_MAX-1)); p++) {
+    /* Write the string as spans of characters that need no escaping,
+       handed to fwrite() whole and separated by the entities for the
+       characters that do.  strcspn() scans several bytes at a time,
+       and most strings - field abbreviations in particular - are a
+       single clean span. */
+    for (;;) {
+        span = strcspn(p, "&<>\"'");
+        if (span > 0) {
+            fwrite(p, 1, span, fh);
+            p += span;
+        }
         switch (*p) {
+        case '\0':
+            return;
         case '&':
-            (void) g_strlcpy(&temp_buffer[offset], "&amp;", ESCAPED_BUFFER_MAX-offset);
-            offset += 5;
+            fputs("&amp;", fh);
             break;
         case '<':
-            (void) g_strlcpy(&temp_buffer[offset], "&lt;", ESCAPED_BUFFER_MAX-offset);
-            offset += 4;
+            fputs("&lt;", fh);
             break;
         case '>':
-            (void) g_strlcpy(&temp_buffer[offset], "&gt;", ESCAPED_BUFFER_MAX-offset);
-            offset += 4;
+            fputs("&gt;", fh);
             break;
         case '"':
-            (void) g_strlcpy(&temp_buffer[offset], "&quot;", ESCAPED_BUFFER_MAX-offset);
-            offset += 6;
+            fputs("&quot;", fh);
             break;
         case '\'':
-            (void) g_strlcpy(&temp_buffer[offset], "&#x27;", ESCAPED_BUFFER_MAX-offset);
-            offset += 6;
+            fputs("&#x27;", fh);
             break;
-        default:
-            temp_buffer[offset++] = *p;
-        }
-        if (offset > ESCAPED_BUFFER_MAX-8) {
-            /* Getting close to end of buffer so flush to fh */
-            temp_buffer[offset] = '\0';
-            fputs(temp_buffer, fh);
-            offset = 0;
         }
-    }
-    if (offset) {
-        /* Flush any outstanding data */
-        temp_buffer[offset] = '\0';
-        fputs(temp_buffer, fh);
+        p++;
     }
 }
 
@@ -2325,6 +2317,70 @@ gboolean output_fields_has_cols(output_fields_t* fields)
     return fields->includes_col_fields;
 }
 
+gboolean output_fields_can_prime(output_fields_t* fields)
+{
+    gsize i;
+
+    ws_assert(fields);
+
+    if (NULL == fields->fields) {
+        return FALSE;
+    }
+
+    for (i = 0; i < fields->fields->len; ++i) {
+        const gchar *field = (const gchar *)g_ptr_array_index(fields->fields, i);
+        header_field_info *hfinfo;
+
+        /* Column fields are taken from the column info, not the tree. */
+        if (!strncmp(field, COLUMN_FIELD_FILTER, strlen(COLUMN_FIELD_FILTER)))
+            continue;
+
+        hfinfo = proto_registrar_get_byname(field);
+        if (NULL == hfinfo)
+            return FALSE;
+
+        /* Protocol and text items are printed using the representation
+         * generated for a visible tree; they can't be extracted from a
+         * primed invisible tree without changing their output. */
+        if (hfinfo->type == FT_PROTOCOL || hfinfo->id == hf_text_only)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+void output_fields_prime_edt(epan_dissect_t *edt, output_fields_t* fields)
+{
+    gsize i;
+
+    ws_assert(fields);
+
+    if (NULL == fields->fields) {
+        return;
+    }
+
+    for (i = 0; i < fields->fields->len; ++i) {
+        const gchar *field = (const gchar *)g_ptr_array_index(fields->fields, i);
+        header_field_info *hfinfo;
+
+        if (!strncmp(field, COLUMN_FIELD_FILTER, strlen(COLUMN_FIELD_FILTER)))
+            continue;
+
+        hfinfo = proto_registrar_get_byname(field);
+        if (NULL == hfinfo)
+            continue;
+
+        /* Multiple fields can share the same abbreviation; mark every
+         * one of them as wanted, the way display filters do. */
+        while (hfinfo->same_name_prev_id != -1)
+            hfinfo = proto_registrar_get_nth(hfinfo->same_name_prev_id);
+        while (hfinfo) {
+            epan_dissect_prime_with_hfid(edt, hfinfo->id);
+            hfinfo = hfinfo->same_name_next;
+        }
+    }
+}
+
 void write_fields_preamble(output_fields_t* fields, FILE *fh)
 {
     gsize i;
@@ -108,6 +108,15 @@ struct ptvcursor {
 	   not to do so.						\
 	*/								\
 	PTREE_DATA(tree)->count++;					\
+	if (G_UNLIKELY(tree_progress_interval != 0 &&			\
+	    (PTREE_DATA(tree)->count % tree_progress_interval) == 0) &&	\
+	    tree_progress_func(PTREE_DATA(tree)->count, tree_progress_data)) { \
+		free_block;						\
+		/* Let the exception handler add items to the tree */	\
+		PTREE_DATA(tree)->count = 0;				\
+		THROW_MESSAGE(DissectorError,				\
+		    "Tree building was cancelled by the progress callback"); \
+	}								\
 	PROTO_REGISTRAR_GET_NTH(hfindex, hfinfo);			\
 	if (PTREE_DATA(tree)->count > prefs.gui_max_tree_items) {			\
 		free_block;						\
@@ -336,6 +345,7 @@ static expert_field ei_string_trailing_characters = EI_INIT;
 static void register_string_errors(void);
 
 static int proto_register_field_init(header_field_info *hfinfo, const int parent);
+static void gpa_name_map_ensure(void);
 
 /* special-case header field used within proto.c */
 static header_field_info hfi_text_only =
@@ -419,6 +429,17 @@ static GHashTable *gpa_protocol_aliases = NULL;
 static char *last_field_name = NULL;
 static header_field_info *last_hfinfo;
 
+/*
+ * Sorted index over field abbreviations for prefix queries from
+ * autocompletion. Built lazily on first use, rebuilt when fields have
+ * been registered since the last build and dropped when fields are
+ * deregistered.
+ */
+static GPtrArray *abbrev_index;
+static guint32    abbrev_index_hf_len;	/* gpa_hfinfo.len at build time */
+
+static void abbrev_index_invalidate(void);
+
 static void save_same_name_hfinfo(gpointer data)
 {
 	same_name_hfinfo = (header_field_info*)data;
@@ -432,6 +453,15 @@ static guint32 *tree_is_expanded;
 /* Number of elements in that array. */
 int		num_tree_types;
 
+/* Cooperative progress reporting for long tree builds.  When a callback
+   is registered, TRY_TO_FAKE_THIS_ITEM_OR_FREE invokes it every
+   tree_progress_interval items added to a single tree; if it returns
+   TRUE the rest of the build is abandoned via a DissectorError, leaving
+   the partial tree for display. */
+static proto_tree_progress_cb tree_progress_func;
+static guint                  tree_progress_interval;
+static void                  *tree_progress_data;
+
 /* Name hashtables for fast detection of duplicate names */
 static GHashTable* proto_names        = NULL;
 static GHashTable* proto_short_names  = NULL;
@@ -498,7 +528,8 @@ proto_init(GSList *register_all_plugin_protocols_list,
 	gpa_hfinfo.len           = 0;
 	gpa_hfinfo.allocated_len = 0;
 	gpa_hfinfo.hfi           = NULL;
-	gpa_name_map             = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, save_same_name_hfinfo);
+	/* gpa_name_map is built on first lookup; see gpa_name_map_ensure(). */
+	gpa_name_map             = NULL;
 	gpa_protocol_aliases     = g_hash_table_new(g_str_hash, g_str_equal);
 	deregistered_fields      = g_ptr_array_new();
 	deregistered_data        = g_ptr_array_new();
@@ -555,6 +586,12 @@ proto_init(GSList *register_all_plugin_protocols_list,
 	/* sort the protocols by protocol name */
 	protocols = g_list_sort(protocols, proto_compare_name);
 
+#ifdef ENABLE_CHECK_FILTER
+	/* Build the abbrev map right away so that the duplicate-abbrev
+	   type checks run even if nothing ever looks a field up by name. */
+	gpa_name_map_ensure();
+#endif
+
 	/* We've assigned all the subtree type values; allocate the array
 	   for them, and zero it out. */
 	tree_is_expanded = g_new0(guint32, (num_tree_types/32)+1);
@@ -620,6 +657,8 @@ proto_cleanup_base(void)
 		gpa_hfinfo.hfi           = NULL;
 	}
 
+	abbrev_index_invalidate();
+
 	if (deregistered_fields) {
 		g_ptr_array_free(deregistered_fields, TRUE);
 		deregistered_fields = NULL;
@@ -742,6 +781,12 @@ free_GPtrArray_value(gpointer key, gpointer value, gpointer user_data _U_)
 	g_ptr_array_free(ptrs, TRUE);
 }
 
+static void
+empty_GPtrArray_value(gpointer key _U_, gpointer value, gpointer user_data _U_)
+{
+	g_ptr_array_set_size((GPtrArray *)value, 0);
+}
+
 static void
 proto_tree_free_node(proto_node *node, gpointer data _U_)
 {
@@ -759,14 +804,17 @@ proto_tree_reset(proto_tree *tree)
 
 	proto_tree_children_foreach(tree, proto_tree_free_node, NULL);
 
-	/* free tree data */
 	if (tree_data->interesting_hfids) {
-		/* Free all the GPtrArray's in the interesting_hfids hash. */
+		/* Which fields are referenced is a property of the pass -
+		   the display filter, the tap listeners, the custom columns
+		   and the coloring rules primed into this tree - not of the
+		   packet, so the registry (and the reference marks it put on
+		   the fields) is kept for the next packet dissected with
+		   this tree; only the per-packet lists of matching
+		   field_infos are emptied.  The marks come off in
+		   proto_tree_free(), at the end of the pass. */
 		g_hash_table_foreach(tree_data->interesting_hfids,
-			free_GPtrArray_value, NULL);
-
-		/* And then remove all values. */
-		g_hash_table_remove_all(tree_data->interesting_hfids);
+			empty_GPtrArray_value, NULL);
 	}
 
 	/* Reset track of the number of children */
@@ -818,6 +866,15 @@ proto_tree_set_fake_protocols(proto_tree *tree, gboolean fake_protocols)
 	PTREE_DATA(tree)->fake_protocols = fake_protocols;
 }
 
+void
+proto_tree_set_progress_callback(proto_tree_progress_cb cb, guint interval,
+    void *user_data)
+{
+	tree_progress_func = cb;
+	tree_progress_interval = (cb != NULL) ? interval : 0;
+	tree_progress_data = user_data;
+}
+
 /* Assume dissector set only its protocol fields.
    This function is called by dissectors and allows the speeding up of filtering
    in wireshark; if this function returns FALSE it is safe to reset tree to NULL
@@ -929,6 +986,96 @@ proto_initialize_all_prefixes(void) {
 	g_hash_table_foreach_remove(prefixes, initialize_prefix, NULL);
 }
 
+/* Enter a field in the abbrev map, linking fields that share an
+ * abbreviation into a chain headed by the map entry.
+ *
+ * We allow multiple hfinfo's to be registered under the same
+ * abbreviation. This was done for X.25, as, depending
+ * on whether it's modulo-8 or modulo-128 operation,
+ * some bitfield fields may be in different bits of
+ * a byte, and we want to be able to refer to that field
+ * with one name regardless of whether the packets
+ * are modulo-8 or modulo-128 packets. */
+static void
+gpa_name_map_insert_field(header_field_info *hfinfo)
+{
+	header_field_info *same_name_next_hfinfo;
+
+	same_name_hfinfo = NULL;
+
+	g_hash_table_insert(gpa_name_map, (gpointer) (hfinfo->abbrev), hfinfo);
+	/* GLIB 2.x - if it is already present
+	 * the previous hfinfo with the same name is saved
+	 * to same_name_hfinfo by value destroy callback */
+	if (same_name_hfinfo) {
+		/* There's already a field with this name.
+		 * Put the current field *before* that field
+		 * in the list of fields with this name, Thus,
+		 * we end up with an effectively
+		 * doubly-linked-list of same-named hfinfo's,
+		 * with the head of the list (stored in the
+		 * hash) being the last seen hfinfo.
+		 */
+		same_name_next_hfinfo =
+			same_name_hfinfo->same_name_next;
+
+		hfinfo->same_name_next = same_name_next_hfinfo;
+		if (same_name_next_hfinfo)
+			same_name_next_hfinfo->same_name_prev_id = hfinfo->id;
+
+		same_name_hfinfo->same_name_next = hfinfo;
+		hfinfo->same_name_prev_id = same_name_hfinfo->id;
+#ifdef ENABLE_CHECK_FILTER
+		while (same_name_hfinfo) {
+			if (_ftype_common(hfinfo->type) != _ftype_common(same_name_hfinfo->type))
+				ws_warning("'%s' exists multiple times with incompatible types: %s and %s", hfinfo->abbrev, ftype_name(hfinfo->type), ftype_name(same_name_hfinfo->type));
+			same_name_hfinfo = same_name_hfinfo->same_name_next;
+		}
+#endif
+	}
+}
+
+/* Build the abbrev->hfinfo map on first lookup rather than during
+ * registration: a run that never resolves a field by name (no display
+ * filter, no field extraction, ...) skips a quarter million hash
+ * insertions at startup, which is a sizable slice of epan_init().
+ * Fields registered after the map exists are inserted directly by
+ * proto_register_field_init(); walking the registration-order array
+ * here yields the same same-name chains an eager build would have. */
+static void
+gpa_name_map_ensure(void)
+{
+	GHashTable *dereg = NULL;
+	guint32	    i;
+
+	if (gpa_name_map)
+		return;
+
+	if (deregistered_fields && deregistered_fields->len > 0) {
+		/* Deregistered-but-not-yet-freed fields are still in the
+		   registration array; they must not re-enter the map. */
+		dereg = g_hash_table_new(g_direct_hash, g_direct_equal);
+		for (i = 0; i < deregistered_fields->len; i++)
+			g_hash_table_add(dereg, g_ptr_array_index(deregistered_fields, i));
+	}
+
+	gpa_name_map = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, save_same_name_hfinfo);
+
+	for (i = 0; i < gpa_hfinfo.len; i++) {
+		header_field_info *hfinfo = gpa_hfinfo.hfi[i];
+
+		if (hfinfo == NULL)	/* deregistered and freed */
+			continue;
+		if (dereg && g_hash_table_contains(dereg, hfinfo))
+			continue;
+		if ((hfinfo->name[0] != 0) && (hfinfo->abbrev[0] != 0))
+			gpa_name_map_insert_field(hfinfo);
+	}
+
+	if (dereg)
+		g_hash_table_destroy(dereg);
+}
+
 /* Finds a record in the hfinfo array by name.
  * If it fails to find it in the already registered fields,
  * it tries to find and call an initializer in the prefixes
@@ -948,6 +1095,8 @@ proto_registrar_get_byname(const char *field_name)
 		return last_hfinfo;
 	}
 
+	gpa_name_map_ensure();
+
 	hfinfo = (header_field_info *)g_hash_table_lookup(gpa_name_map, field_name);
 
 	if (hfinfo) {
@@ -1021,6 +1170,88 @@ proto_registrar_get_id_byname(const char *field_name)
 	return hfinfo->id;
 }
 
+static void
+abbrev_index_invalidate(void)
+{
+	if (abbrev_index) {
+		g_ptr_array_free(abbrev_index, TRUE);
+		abbrev_index = NULL;
+	}
+}
+
+static int
+compare_hfinfo_abbrev(gconstpointer a, gconstpointer b)
+{
+	const header_field_info *ha = *(const header_field_info *const *)a;
+	const header_field_info *hb = *(const header_field_info *const *)b;
+
+	return g_ascii_strcasecmp(ha->abbrev, hb->abbrev);
+}
+
+static void
+abbrev_index_build(void)
+{
+	guint32 i;
+
+	abbrev_index_invalidate();
+
+	abbrev_index = g_ptr_array_sized_new(gpa_hfinfo.len);
+	for (i = 0; i < gpa_hfinfo.len; i++) {
+		header_field_info *hfinfo = gpa_hfinfo.hfi[i];
+
+		if (hfinfo == NULL || hfinfo->abbrev == NULL)
+			continue;
+		if (hfinfo->same_name_prev_id != -1)
+			continue;	/* only the first field of each name */
+		g_ptr_array_add(abbrev_index, hfinfo);
+	}
+	g_ptr_array_sort(abbrev_index, compare_hfinfo_abbrev);
+	abbrev_index_hf_len = gpa_hfinfo.len;
+}
+
+GPtrArray *
+proto_registrar_get_abbrev_matches(const char *prefix)
+{
+	GPtrArray *matches = g_ptr_array_new();
+	gsize      prefix_len;
+	guint      lo, hi, i;
+
+	if (!prefix || prefix[0] == '\0')
+		return matches;
+
+	if (abbrev_index == NULL || abbrev_index_hf_len != gpa_hfinfo.len)
+		abbrev_index_build();
+
+	prefix_len = strlen(prefix);
+
+	/* Binary-search the first abbreviation >= the prefix. Truncated
+	   comparison preserves the index order, so this is a plain lower
+	   bound. */
+	lo = 0;
+	hi = abbrev_index->len;
+	while (lo < hi) {
+		guint mid = lo + (hi - lo) / 2;
+		const header_field_info *hfinfo =
+			(const header_field_info *)abbrev_index->pdata[mid];
+
+		if (g_ascii_strncasecmp(hfinfo->abbrev, prefix, prefix_len) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	/* Take entries for as long as the prefix holds. */
+	for (i = lo; i < abbrev_index->len; i++) {
+		header_field_info *hfinfo =
+			(header_field_info *)abbrev_index->pdata[i];
+
+		if (g_ascii_strncasecmp(hfinfo->abbrev, prefix, prefix_len) != 0)
+			break;
+		g_ptr_array_add(matches, hfinfo);
+	}
+
+	return matches;
+}
 
 static char *
 hfinfo_format_text(wmem_allocator_t *scope, const header_field_info *hfinfo,
@@ -2451,7 +2682,9 @@ tree_data_add_maybe_interesting_field(tree_data_t *tree_data, field_info *fi)
 		}
 
 		if (!ptrs) {
-			/* First element triggers the creation of pointer array */
+			/* First element triggers the creation of pointer
+			   array; proto_tree_reset() keeps it in the hash,
+			   emptied, so this is once per field and pass. */
 			ptrs = g_ptr_array_new();
 			g_hash_table_insert(tree_data->interesting_hfids,
 					    GINT_TO_POINTER(hfinfo->id), ptrs);
@@ -6342,6 +6575,13 @@ hfinfo_remove_from_gpa_name_map(const header_field_info *hfinfo)
 	g_free(last_field_name);
 	last_field_name = NULL;
 
+	if (!gpa_name_map) {
+		/* The map was never built, so there are no same-name
+		 * chains to fix up either; gpa_name_map_ensure() skips
+		 * deregistered fields when it eventually runs. */
+		return;
+	}
+
 	if (!hfinfo->same_name_next && hfinfo->same_name_prev_id == -1) {
 		/* No hfinfo with the same name */
 		g_hash_table_steal(gpa_name_map, hfinfo->abbrev);
@@ -6396,16 +6636,20 @@ proto_item_fill_display_label(field_info *finfo, gchar *display_label_str, const
 			break;
 
 		case FT_ABSOLUTE_TIME:
-			tmp_str = abs_time_to_str(NULL, (const nstime_t *)fvalue_get(&finfo->value), (absolute_time_display_e)hfinfo->display, TRUE);
-			label_len = protoo_strlcpy(display_label_str, tmp_str, label_str_size);
-			wmem_free(NULL, tmp_str);
+		{
+			gchar time_buf[ABS_TIME_TO_STR_SIZE];
+			abs_time_to_str_buf((const nstime_t *)fvalue_get(&finfo->value), (absolute_time_display_e)hfinfo->display, TRUE, time_buf, sizeof(time_buf));
+			label_len = protoo_strlcpy(display_label_str, time_buf, label_str_size);
 			break;
+		}
 
 		case FT_RELATIVE_TIME:
-			tmp_str = rel_time_to_secs_str(NULL, (const nstime_t *)fvalue_get(&finfo->value));
-			label_len = protoo_strlcpy(display_label_str, tmp_str, label_str_size);
-			wmem_free(NULL, tmp_str);
+		{
+			gchar time_buf[REL_TIME_SECS_STR_SIZE];
+			rel_time_to_secs_str_buf((const nstime_t *)fvalue_get(&finfo->value), time_buf, sizeof(time_buf));
+			label_len = protoo_strlcpy(display_label_str, time_buf, label_str_size);
 			break;
+		}
 
 		case FT_BOOLEAN:
 			number64 = fvalue_get_uinteger64(&finfo->value);
@@ -7499,7 +7743,8 @@ proto_deregister_protocol(const char *short_name)
 	protocols = g_list_remove(protocols, protocol);
 
 	g_ptr_array_add(deregistered_fields, gpa_hfinfo.hfi[proto_id]);
-	g_hash_table_steal(gpa_name_map, protocol->filter_name);
+	if (gpa_name_map)
+		g_hash_table_steal(gpa_name_map, protocol->filter_name);
 
 	g_free(last_field_name);
 	last_field_name = NULL;
@@ -7861,6 +8106,25 @@ proto_reenable_all(void)
 	}
 }
 
+guint
+proto_enabled_state_hash(void)
+{
+	protocol_t *protocol;
+	GList      *list_item = protocols;
+	guint       hash = 0;
+
+	/* XOR the hashes of the disabled protocols' filter names, so the
+	   result is independent of registration order and two snapshots
+	   compare equal exactly when the same set is disabled. */
+	while (list_item) {
+		protocol = (protocol_t *)list_item->data;
+		if (protocol->can_toggle && !protocol->is_enabled)
+			hash ^= g_str_hash(protocol->filter_name);
+		list_item = g_list_next(list_item);
+	}
+	return hash;
+}
+
 void
 proto_set_cant_toggle(const int proto_id)
 {
@@ -7993,7 +8257,8 @@ proto_deregister_field (const int parent, gint hf_id)
 		hfi = (header_field_info *)g_ptr_array_index(proto->fields, i);
 		if (hfi->id == hf_id) {
 			/* Found the hf_id in this protocol */
-			g_hash_table_steal(gpa_name_map, hfi->abbrev);
+			if (gpa_name_map)
+				g_hash_table_steal(gpa_name_map, hfi->abbrev);
 			g_ptr_array_remove_index_fast(proto->fields, i);
 			g_ptr_array_add(deregistered_fields, gpa_hfinfo.hfi[hf_id]);
 			return;
@@ -8079,7 +8344,17 @@ void proto_free_field_strings (ftenum_t field_type, unsigned int field_display,
 					rs++;
 				}
 			} else {
-				value_string *vs = (value_string *)field_strings;
+				value_string *vs;
+				if (field_display & BASE_EXT_STRING) {
+					/* The table was wrapped into a
+					 * value_string_ext at registration
+					 * time; unwrap it and free the
+					 * wrapped table below. */
+					value_string_ext *vse = (value_string_ext *)field_strings;
+					field_strings = VALUE_STRING_EXT_VS_P(vse);
+					value_string_ext_free(vse);
+				}
+				vs = (value_string *)field_strings;
 				while (vs->strptr) {
 					g_free((gchar *)vs->strptr);
 					vs++;
@@ -8130,6 +8405,9 @@ proto_free_deregistered_fields (void)
 	g_ptr_array_free(deregistered_fields, TRUE);
 	deregistered_fields = g_ptr_array_new();
 
+	/* The abbreviation index may point at fields we just freed. */
+	abbrev_index_invalidate();
+
 	g_ptr_array_foreach(deregistered_data, free_deregistered_data, NULL);
 	g_ptr_array_free(deregistered_data, TRUE);
 	deregistered_data = g_ptr_array_new();
@@ -8790,6 +9068,56 @@ register_string_errors(void)
 	proto_set_cant_toggle(proto_string_errors);
 }
 
+/* A plain value_string attached to a field with at least this many entries
+ * (not counting the {0, NULL} terminator) is wrapped into a value_string_ext
+ * at registration time, so that lookups use the extended matching (direct
+ * table index or binary search, depending on how the values are laid out)
+ * instead of a linear scan. For smaller tables the scan is cheaper than the
+ * extra indirection. */
+#define AUTO_EXT_STRING_MIN_ENTRIES 32
+
+static void
+hfinfo_upgrade_value_string(header_field_info *hfinfo)
+{
+	const value_string *vals;
+	guint		    n;
+
+	switch (hfinfo->type) {
+		case FT_CHAR:
+		case FT_UINT8:
+		case FT_UINT16:
+		case FT_UINT24:
+		case FT_UINT32:
+		case FT_INT8:
+		case FT_INT16:
+		case FT_INT24:
+		case FT_INT32:
+			break;
+		default:
+			return;
+	}
+
+	if (hfinfo->strings == NULL)
+		return;
+
+	/* Only plain value_string tables qualify; everything else either has
+	 * its own lookup semantics or already is an extended table. */
+	if (hfinfo->display & (BASE_EXT_STRING | BASE_RANGE_STRING |
+	    BASE_VAL64_STRING | BASE_UNIT_STRING | BASE_SPECIAL_VALS))
+		return;
+	if (FIELD_DISPLAY(hfinfo->display) == BASE_CUSTOM)
+		return;
+
+	vals = (const value_string *)hfinfo->strings;
+	for (n = 0; vals[n].strptr != NULL; n++)
+		;
+	if (n < AUTO_EXT_STRING_MIN_ENTRIES)
+		return;
+
+	hfinfo->strings = value_string_ext_new(vals, n + 1, hfinfo->abbrev);
+	hfinfo->display |= BASE_EXT_STRING;
+}
+
 #define PROTO_PRE_ALLOC_HF_FIELDS_MEM (235000+PRE_ALLOC_EXPERT_FIELDS_MEM)
 static int
 proto_register_field_init(header_field_info *hfinfo, const int parent)
@@ -8797,9 +9125,15 @@ proto_register_field_init(header_field_info *hfinfo, const int parent)
 
 	tmp_fld_check_assert(hfinfo);
 
+	hfinfo_upgrade_value_string(hfinfo);
+
 	hfinfo->parent         = parent;
 	hfinfo->same_name_next = NULL;
 	hfinfo->same_name_prev_id = -1;
+	/* Cache the name length; label generation prepends the name to the
+	 * label of every field instance of every packet, and this saves it
+	 * re-walking the string each time. */
+	hfinfo->name_len       = strlen(hfinfo->name);
 
 	/* if we always add and never delete, then id == len - 1 is correct */
 	if (gpa_hfinfo.len >= gpa_hfinfo.allocated_len) {
@@ -8820,7 +9154,6 @@ proto_register_field_init(header_field_info *hfinfo, const int parent)
 	/* if we have real names, enter this field in the name tree */
 	if ((hfinfo->name[0] != 0) && (hfinfo->abbrev[0] != 0 )) {
 
-		header_field_info *same_name_next_hfinfo;
 		guchar c;
 
 		/* Check that the filter name (abbreviation) is legal;
@@ -8837,46 +9170,11 @@ proto_register_field_init(header_field_info *hfinfo, const int parent)
 			DISSECTOR_ASSERT_NOT_REACHED();
 		}
 
-		/* We allow multiple hfinfo's to be registered under the same
-		 * abbreviation. This was done for X.25, as, depending
-		 * on whether it's modulo-8 or modulo-128 operation,
-		 * some bitfield fields may be in different bits of
-		 * a byte, and we want to be able to refer to that field
-		 * with one name regardless of whether the packets
-		 * are modulo-8 or modulo-128 packets. */
-
-		same_name_hfinfo = NULL;
-
-		g_hash_table_insert(gpa_name_map, (gpointer) (hfinfo->abbrev), hfinfo);
-		/* GLIB 2.x - if it is already present
-		 * the previous hfinfo with the same name is saved
-		 * to same_name_hfinfo by value destroy callback */
-		if (same_name_hfinfo) {
-			/* There's already a field with this name.
-			 * Put the current field *before* that field
-			 * in the list of fields with this name, Thus,
-			 * we end up with an effectively
-			 * doubly-linked-list of same-named hfinfo's,
-			 * with the head of the list (stored in the
-			 * hash) being the last seen hfinfo.
-			 */
-			same_name_next_hfinfo =
-				same_name_hfinfo->same_name_next;
-
-			hfinfo->same_name_next = same_name_next_hfinfo;
-			if (same_name_next_hfinfo)
-				same_name_next_hfinfo->same_name_prev_id = hfinfo->id;
-
-			same_name_hfinfo->same_name_next = hfinfo;
-			hfinfo->same_name_prev_id = same_name_hfinfo->id;
-#ifdef ENABLE_CHECK_FILTER
-			while (same_name_hfinfo) {
-				if (_ftype_common(hfinfo->type) != _ftype_common(same_name_hfinfo->type))
-					ws_warning("'%s' exists multiple times with incompatible types: %s and %s", hfinfo->abbrev, ftype_name(hfinfo->type), ftype_name(same_name_hfinfo->type));
-				same_name_hfinfo = same_name_hfinfo->same_name_next;
-			}
-#endif
-		}
+		/* The abbrev map itself is built on demand (see
+		 * gpa_name_map_ensure()); once it exists, keep it
+		 * current. */
+		if (gpa_name_map)
+			gpa_name_map_insert_field(hfinfo);
 	}
 
 	return hfinfo->id;
@@ -8935,6 +9233,23 @@ label_concat(char *label_str, gsize pos, const char *str)
 	return pos;
 }
 
+/* As label_concat(), but for a string whose length is already known, so
+ * the source isn't walked again.  Returns the position the full string
+ * would have ended at, like g_strlcpy, so truncation is detected the
+ * same way. */
+static inline gsize
+label_concat_len(char *label_str, gsize pos, const char *str, gsize len)
+{
+	gsize write_len;
+
+	if (pos < ITEM_LABEL_LENGTH) {
+		write_len = MIN(len, ITEM_LABEL_LENGTH - pos - 1);
+		memcpy(label_str + pos, str, write_len);
+		label_str[pos + write_len] = '\0';
+	}
+	return pos + len;
+}
+
 static void
 label_mark_truncated(char *label_str, gsize name_pos)
 {
@@ -8976,7 +9291,10 @@ label_fill(char *label_str, gsize pos, const header_field_info *hfinfo, const ch
 	gsize name_pos;
 
 	/* "%s: %s", hfinfo->name, text */
-	name_pos = pos = label_concat(label_str, pos, hfinfo->name);
+	if (G_LIKELY(hfinfo->name_len != 0))
+		name_pos = pos = label_concat_len(label_str, pos, hfinfo->name, hfinfo->name_len);
+	else
+		name_pos = pos = label_concat(label_str, pos, hfinfo->name);
 	if (!(hfinfo->display & BASE_NO_DISPLAY_VALUE)) {
 		pos = label_concat(label_str, pos, ": ");
 		pos = label_concat(label_str, pos, text ? text : "(null)");
@@ -8996,7 +9314,10 @@ label_fill_descr(char *label_str, gsize pos, const header_field_info *hfinfo, co
 	gsize name_pos;
 
 	/* "%s: %s (%s)", hfinfo->name, text, descr */
-	name_pos = pos = label_concat(label_str, pos, hfinfo->name);
+	if (G_LIKELY(hfinfo->name_len != 0))
+		name_pos = pos = label_concat_len(label_str, pos, hfinfo->name, hfinfo->name_len);
+	else
+		name_pos = pos = label_concat(label_str, pos, hfinfo->name);
 	if (!(hfinfo->display & BASE_NO_DISPLAY_VALUE)) {
 		pos = label_concat(label_str, pos, ": ");
 		if (hfinfo->display & BASE_UNIT_STRING) {
@@ -9030,6 +9351,7 @@ proto_item_fill_label(field_info *fi, gchar *label_str)
 	gchar		   *name;
 	address		    addr;
 	char		   *addr_str;
+	char		    addr_buf[MAX_ADDR_STR_LEN];
 	char		   *tmp;
 
 	if (!fi) {
@@ -9171,17 +9493,21 @@ proto_item_fill_label(field_info *fi, gchar *label_str)
 		}
 
 		case FT_ABSOLUTE_TIME:
-			tmp = abs_time_to_str(NULL, (const nstime_t *)fvalue_get(&fi->value), (absolute_time_display_e)hfinfo->display, TRUE);
-			label_fill(label_str, 0, hfinfo, tmp);
-			wmem_free(NULL, tmp);
+		{
+			gchar time_buf[ABS_TIME_TO_STR_SIZE];
+			abs_time_to_str_buf((const nstime_t *)fvalue_get(&fi->value), (absolute_time_display_e)hfinfo->display, TRUE, time_buf, sizeof(time_buf));
+			label_fill(label_str, 0, hfinfo, time_buf);
 			break;
+		}
 
 		case FT_RELATIVE_TIME:
-			tmp = rel_time_to_secs_str(NULL, (const nstime_t *)fvalue_get(&fi->value));
+		{
+			gchar time_buf[REL_TIME_SECS_STR_SIZE];
+			rel_time_to_secs_str_buf((const nstime_t *)fvalue_get(&fi->value), time_buf, sizeof(time_buf));
 			g_snprintf(label_str, ITEM_LABEL_LENGTH,
-				   "%s: %s seconds", hfinfo->name, tmp);
-			wmem_free(NULL, tmp);
+				   "%s: %s seconds", hfinfo->name, time_buf);
 			break;
+		}
 
 		case FT_IPXNET:
 			integer = fvalue_get_uinteger(&fi->value);
@@ -9197,10 +9523,9 @@ proto_item_fill_label(field_info *fi, gchar *label_str)
 			addr.len  = AX25_ADDR_LEN;
 			addr.data = (guint8 *)fvalue_get(&fi->value);
 
-			addr_str = (char*)address_to_str(NULL, &addr);
+			address_to_str_buf(&addr, addr_buf, sizeof(addr_buf));
 			g_snprintf(label_str, ITEM_LABEL_LENGTH,
-				   "%s: %s", hfinfo->name, addr_str);
-			wmem_free(NULL, addr_str);
+				   "%s: %s", hfinfo->name, addr_buf);
 			break;
 
 		case FT_VINES:
@@ -9208,10 +9533,9 @@ proto_item_fill_label(field_info *fi, gchar *label_str)
 			addr.len  = VINES_ADDR_LEN;
 			addr.data = (guint8 *)fvalue_get(&fi->value);
 
-			addr_str = (char*)address_to_str(NULL, &addr);
+			address_to_str_buf(&addr, addr_buf, sizeof(addr_buf));
 			g_snprintf(label_str, ITEM_LABEL_LENGTH,
-				   "%s: %s", hfinfo->name, addr_str);
-			wmem_free(NULL, addr_str);
+				   "%s: %s", hfinfo->name, addr_buf);
 			break;
 
 		case FT_ETHER:
@@ -9221,10 +9545,9 @@ proto_item_fill_label(field_info *fi, gchar *label_str)
 			addr.len  = 6;
 			addr.data = bytes;
 
-			addr_str = (char*)address_with_resolution_to_str(NULL, &addr);
+			address_with_resolution_to_str_buf(&addr, addr_buf, sizeof(addr_buf));
 			g_snprintf(label_str, ITEM_LABEL_LENGTH,
-				   "%s: %s", hfinfo->name, addr_str);
-			wmem_free(NULL, addr_str);
+				   "%s: %s", hfinfo->name, addr_buf);
 			break;
 
 		case FT_IPv4:
@@ -9235,13 +9558,12 @@ proto_item_fill_label(field_info *fi, gchar *label_str)
 			addr.data = &ipv4;
 
 			if (hfinfo->display == BASE_NETMASK) {
-				addr_str = (char*)address_to_str(NULL, &addr);
+				address_to_str_buf(&addr, addr_buf, sizeof(addr_buf));
 			} else {
-				addr_str = (char*)address_with_resolution_to_str(NULL, &addr);
+				address_with_resolution_to_str_buf(&addr, addr_buf, sizeof(addr_buf));
 			}
 			g_snprintf(label_str, ITEM_LABEL_LENGTH,
-				   "%s: %s", hfinfo->name, addr_str);
-			wmem_free(NULL, addr_str);
+				   "%s: %s", hfinfo->name, addr_buf);
 			break;
 
 		case FT_IPv6:
@@ -9251,10 +9573,9 @@ proto_item_fill_label(field_info *fi, gchar *label_str)
 			addr.len  = 16;
 			addr.data = bytes;
 
-			addr_str = (char*)address_with_resolution_to_str(NULL, &addr);
+			address_with_resolution_to_str_buf(&addr, addr_buf, sizeof(addr_buf));
 			g_snprintf(label_str, ITEM_LABEL_LENGTH,
-				   "%s: %s", hfinfo->name, addr_str);
-			wmem_free(NULL, addr_str);
+				   "%s: %s", hfinfo->name, addr_buf);
 			break;
 
 		case FT_FCWWN:
@@ -9262,10 +9583,9 @@ proto_item_fill_label(field_info *fi, gchar *label_str)
 			addr.len  = FCWWN_ADDR_LEN;
 			addr.data = (guint8 *)fvalue_get(&fi->value);
 
-			addr_str = (char*)address_with_resolution_to_str(NULL, &addr);
+			address_with_resolution_to_str_buf(&addr, addr_buf, sizeof(addr_buf));
 			g_snprintf(label_str, ITEM_LABEL_LENGTH,
-				   "%s: %s", hfinfo->name, addr_str);
-			wmem_free(NULL, addr_str);
+				   "%s: %s", hfinfo->name, addr_buf);
 			break;
 
 		case FT_GUID:
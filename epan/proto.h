@@ -751,6 +751,7 @@ struct _header_field_info {
     hf_ref_type        ref_type;          /**< is this field referenced by a filter */
     int                same_name_prev_id; /**< ID of previous hfinfo with same abbrev */
     header_field_info *same_name_next;    /**< Link to next hfinfo with same abbrev */
+    gsize              name_len;          /**< Cached strlen(name), filled in at registration */
 };
 
 /**
@@ -758,14 +759,15 @@ struct _header_field_info {
  * _header_field_info. If new fields are added or removed, it should
  * be changed as necessary.
  */
-#define HFILL -1, 0, HF_REF_TYPE_NONE, -1, NULL
+#define HFILL -1, 0, HF_REF_TYPE_NONE, -1, NULL, 0
 
 #define HFILL_INIT(hf)   \
     (hf).hfinfo.id                = -1;   \
     (hf).hfinfo.parent            = 0;   \
     (hf).hfinfo.ref_type          = HF_REF_TYPE_NONE;   \
     (hf).hfinfo.same_name_prev_id = -1;   \
-    (hf).hfinfo.same_name_next    = NULL;
+    (hf).hfinfo.same_name_next    = NULL;   \
+    (hf).hfinfo.name_len          = 0;
 
 /** Used when registering many fields at once, using proto_register_field_array() */
 typedef struct hf_register_info {
@@ -1155,6 +1157,27 @@ WS_DLL_PUBLIC char *proto_item_get_display_repr(wmem_allocator_t *scope, proto_i
  @return the new tree root */
 extern proto_tree* proto_tree_create_root(struct _packet_info *pinfo);
 
+/** Progress callback invoked periodically while a large proto_tree is
+ being filled in, so a UI can keep repainting (and, if it wants, give
+ up) during a multi-second build of a single huge PDU's tree.
+ The callback runs in the middle of a dissection, with a packet scope
+ live; it must not do anything that could start another dissection,
+ such as pumping an event loop whose paint or timer handlers dissect
+ packets.
+ @param items the number of items added to the tree so far
+ @param user_data user data supplied to proto_tree_set_progress_callback()
+ @return TRUE to cancel the rest of the build; the dissection is aborted
+ with a DissectorError and the partial tree is kept for display */
+typedef gboolean (*proto_tree_progress_cb)(guint items, void *user_data);
+
+/** Registers a progress callback for proto_tree building.
+ @param cb the callback, or NULL to unregister
+ @param interval invoke the callback every 'interval' items added to a
+ single tree; 0 disables progress reporting
+ @param user_data user data to pass to the callback */
+WS_DLL_PUBLIC void proto_tree_set_progress_callback(proto_tree_progress_cb cb,
+    guint interval, void *user_data);
+
 void proto_tree_reset(proto_tree *tree);
 
 /** Clear memory for entry proto_tree. Clears proto_tree struct also.
@@ -2527,6 +2550,16 @@ WS_DLL_PUBLIC header_field_info* proto_registrar_get_byalias(const char *alias_n
  @return the field id for the registered item */
 WS_DLL_PUBLIC int proto_registrar_get_id_byname(const char *field_name);
 
+/** Get all registered fields whose abbreviation starts with a prefix.
+ Backed by a sorted index over the registry, so a query costs a binary
+ search plus the matches instead of a walk over every registered field;
+ intended for autocompletion. The comparison is ASCII case-insensitive.
+ @param prefix the abbreviation prefix to search for
+ @return a GPtrArray of header_field_info pointers, sorted by
+ abbreviation; free it (but not the entries) with
+ g_ptr_array_free(matches, TRUE) */
+WS_DLL_PUBLIC GPtrArray* proto_registrar_get_abbrev_matches(const char *prefix);
+
 /** Get enum ftenum FT_ of registered header_field number n.
  @param n item # n (0-indexed)
  @return the registered item */
@@ -2670,6 +2703,13 @@ WS_DLL_PUBLIC void proto_set_decoding(const int proto_id, const gboolean enabled
 /** Re-enable all protocols that are not marked as disabled by default. */
 WS_DLL_PUBLIC void proto_reenable_all(void);
 
+/** Get a hash over which protocols are currently disabled.  Comparing
+ snapshots taken before and after reloading the enabled/disabled lists
+ tells whether the set actually changed, e.g. to decide if redissection
+ is needed.
+ @return a hash of the set of disabled protocols */
+WS_DLL_PUBLIC guint proto_enabled_state_hash(void);
+
 /** Disable disabling/enabling of protocol of the given item number.
  @param proto_id protocol id (0-indexed) */
 WS_DLL_PUBLIC void proto_set_cant_toggle(const int proto_id);
@@ -500,6 +500,12 @@ pbl_field_descriptor_type(const pbl_field_descriptor_t* field)
                 ((pbl_field_descriptor_t*)field)->type = PROTOBUF_TYPE_MESSAGE;
             }
         }
+        if (node) {
+            /* remember the node so message_type()/enum_type() don't
+               have to resolve the name again */
+            ((pbl_field_descriptor_t*)field)->type_node = node;
+            ((pbl_field_descriptor_t*)field)->type_node_resolved = TRUE;
+        }
     }
     return field->type;
 }
@@ -517,36 +523,47 @@ pbl_field_descriptor_is_packed(const pbl_field_descriptor_t* field)
 {
     gboolean has_packed_option;
     gboolean packed_option_value;
+    gboolean is_packed;
     int syntax_version = ((pbl_node_t*)field)->file->syntax_version;
 
+    if (field->is_packed_resolved) {
+        return field->is_packed_value ? 1 : 0;
+    }
+
     /* determine packed flag */
     if (field->is_repeated == FALSE) {
-        return FALSE;
-    }
-    /* note: field->type may be undetermined until calling pbl_field_descriptor_type() */
-    switch (pbl_field_descriptor_type(field)) {
-    case PROTOBUF_TYPE_STRING:
-    case PROTOBUF_TYPE_GROUP:
-    case PROTOBUF_TYPE_MESSAGE:
-    case PROTOBUF_TYPE_BYTES:
-        return FALSE;
-    default: /* only repeated fields of primitive numeric types can be declared "packed". */
-        has_packed_option = field->options_node
-            && field->options_node->children_by_name
-            && g_hash_table_lookup(field->options_node->children_by_name, "packed");
-
-        packed_option_value = (has_packed_option ?
-            g_strcmp0(
-              ((pbl_option_descriptor_t*)g_hash_table_lookup(
-                field->options_node->children_by_name, "packed"))->value, "true") == 0
-            : FALSE);
-
-        if (syntax_version == 2) {
-            return packed_option_value;
-        } else { /* packed default in syntax_version = 3 */
-            return has_packed_option ? packed_option_value : TRUE;
+        is_packed = FALSE;
+    } else {
+        /* note: field->type may be undetermined until calling pbl_field_descriptor_type() */
+        switch (pbl_field_descriptor_type(field)) {
+        case PROTOBUF_TYPE_STRING:
+        case PROTOBUF_TYPE_GROUP:
+        case PROTOBUF_TYPE_MESSAGE:
+        case PROTOBUF_TYPE_BYTES:
+            is_packed = FALSE;
+            break;
+        default: /* only repeated fields of primitive numeric types can be declared "packed". */
+            has_packed_option = field->options_node
+                && field->options_node->children_by_name
+                && g_hash_table_lookup(field->options_node->children_by_name, "packed");
+
+            packed_option_value = (has_packed_option ?
+                g_strcmp0(
+                  ((pbl_option_descriptor_t*)g_hash_table_lookup(
+                    field->options_node->children_by_name, "packed"))->value, "true") == 0
+                : FALSE);
+
+            if (syntax_version == 2) {
+                is_packed = packed_option_value;
+            } else { /* packed default in syntax_version = 3 */
+                is_packed = has_packed_option ? packed_option_value : TRUE;
+            }
         }
     }
+
+    ((pbl_field_descriptor_t*)field)->is_packed_value = is_packed;
+    ((pbl_field_descriptor_t*)field)->is_packed_resolved = TRUE;
+    return is_packed ? 1 : 0;
 }
 
 /* like FieldDescriptor::TypeName() */
@@ -556,13 +573,26 @@ pbl_field_descriptor_TypeName(int field_type)
     return val_to_str(field_type, protobuf_field_type, "UNKNOWN_FIELD_TYPE(%d)");
 }
 
+/* resolve and cache the node the type_name of a field refers to. A field
+   refers to at most one message or enum, so the cache can be shared. */
+static const pbl_node_t*
+pbl_field_descriptor_resolve_type_node(const pbl_field_descriptor_t* field, pbl_node_type_t nodetype)
+{
+    if (!field->type_node_resolved) {
+        ((pbl_field_descriptor_t*)field)->type_node =
+            pbl_find_node_in_context(((pbl_node_t*)field)->parent, field->type_name, nodetype);
+        ((pbl_field_descriptor_t*)field)->type_node_resolved = TRUE;
+    }
+    return field->type_node;
+}
+
 /* like FieldDescriptor::message_type()  type = TYPE_MESSAGE or TYPE_GROUP */
 const pbl_message_descriptor_t*
 pbl_field_descriptor_message_type(const pbl_field_descriptor_t* field)
 {
     const pbl_node_t* n;
     if (field->type == PROTOBUF_TYPE_MESSAGE || field->type == PROTOBUF_TYPE_GROUP) {
-        n = pbl_find_node_in_context(((pbl_node_t*)field)->parent, field->type_name, PBL_MESSAGE);
+        n = pbl_field_descriptor_resolve_type_node(field, PBL_MESSAGE);
         return n ? (const pbl_message_descriptor_t*)n : NULL;
     }
     return NULL;
@@ -574,7 +604,7 @@ pbl_field_descriptor_enum_type(const pbl_field_descriptor_t* field)
 {
     const pbl_node_t* n;
     if (field->type == PROTOBUF_TYPE_ENUM) {
-        n = pbl_find_node_in_context(((pbl_node_t*)field)->parent, field->type_name, PBL_ENUM);
+        n = pbl_field_descriptor_resolve_type_node(field, PBL_ENUM);
         return n ? (const pbl_enum_descriptor_t*)n : NULL;
     }
     return NULL;
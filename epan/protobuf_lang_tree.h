@@ -119,6 +119,12 @@ typedef struct {
         gchar* s;
         const pbl_enum_value_descriptor_t* e;
     } default_value;
+    /* caches resolved lazily on first use, so that per-packet lookups
+       don't repeat the type name resolution */
+    const pbl_node_t* type_node;
+    gboolean type_node_resolved;
+    gboolean is_packed_value;
+    gboolean is_packed_resolved;
 } pbl_field_descriptor_t;
 
 /* like google::protobuf::EnumDescriptor of protobuf cpp library */
@@ -943,6 +943,15 @@ LINK_FRAG(fragment_head *fd_head,fragment_item *fd)
 {
 	fragment_item *fd_i;
 
+	/* Fragments usually arrive in order, appending at the tail; without
+	 * this fast path long fragment runs go quadratic. */
+	if (fd_head->last && fd->offset >= fd_head->last->offset) {
+		fd->next = NULL;
+		fd_head->last->next = fd;
+		fd_head->last = fd;
+		return;
+	}
+
 	/* add fragment to list, keep list sorted */
 	for(fd_i= fd_head; fd_i->next;fd_i=fd_i->next) {
 		if (fd->offset < fd_i->next->offset )
@@ -950,6 +959,8 @@ LINK_FRAG(fragment_head *fd_head,fragment_item *fd)
 	}
 	fd->next=fd_i->next;
 	fd_i->next=fd;
+	if (fd->next == NULL)
+		fd_head->last = fd;
 }
 
 static void
@@ -959,6 +970,9 @@ MERGE_FRAG(fragment_head *fd_head, fragment_item *fd)
 
 	if (fd == NULL) return;
 
+	/* The tail is about to change in a way LINK_FRAG() can't track. */
+	fd_head->last = NULL;
+
 	for(fd_i = fd_head; fd_i->next; fd_i=fd_i->next) {
 		if (fd->offset < fd_i->next->offset) {
 			tmp = fd_i->next;
@@ -1011,6 +1025,8 @@ fragment_add_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 	fd->len  = frag_data_len;
 	fd->tvb_data = NULL;
 	fd->error = NULL;
+	fd->last = NULL;
+	fd->contiguous = 0;
 
 	/*
 	 * Are we adding to an already-completed reassembly?
@@ -1707,6 +1723,7 @@ fragment_add_seq_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 	fragment_item *last_fd;
 	guint32 max, dfpos;
 	guint32 frag_number_work;
+	gboolean contiguous_stale;
 
 	/* Enables the use of fragment sequence numbers, which do not start with 0 */
 	frag_number_work = frag_number;
@@ -1741,6 +1758,10 @@ fragment_add_seq_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 		fd_head->datalen=0;
 		fd_head->reassembled_in=0;
 		fd_head->reas_in_layer_num = 0;
+		/* Trailing fragments may have been linked while we were
+		 * defragmented without the contiguous count keeping up;
+		 * force it to be re-derived below. */
+		fd_head->last = NULL;
 	}
 
 
@@ -1753,6 +1774,8 @@ fragment_add_seq_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 	fd->len  = frag_data_len;
 	fd->tvb_data = NULL;
 	fd->error = NULL;
+	fd->last = NULL;
+	fd->contiguous = 0;
 
 	/* fd_head->frame is the maximum of the frame numbers of all the
 	 * fragments added to the reassembly. */
@@ -1888,8 +1911,41 @@ fragment_add_seq_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 
 		fd->tvb_data = tvb_clone_offset_len(tvb, offset, fd->len);
 	}
+	contiguous_stale = (fd_head->last == NULL && fd_head->next != NULL);
 	LINK_FRAG(fd_head,fd);
 
+	/* Keep the count of contiguous blocks seen from block 0 up to date,
+	 * so the completeness check below doesn't have to rescan the whole
+	 * list for every fragment added.
+	 */
+	if (contiguous_stale || fd_head->last == NULL) {
+		/* Someone did list surgery behind our back; re-derive the
+		 * count (and the list tail) from scratch.
+		 */
+		max = 0;
+		for(fd_i=fd_head->next;fd_i;fd_i=fd_i->next) {
+			if ( fd_i->offset==max ){
+				max++;
+			}
+			if (fd_i->next == NULL) {
+				fd_head->last = fd_i;
+			}
+		}
+		fd_head->contiguous = max;
+	} else if (fd->offset == fd_head->contiguous) {
+		/* This fragment extends the contiguous run, and may have
+		 * plugged the gap in front of blocks we already have.
+		 */
+		max = fd_head->contiguous + 1;
+		for(fd_i=fd->next;fd_i;fd_i=fd_i->next) {
+			if ( fd_i->offset==max ){
+				max++;
+			} else if ( fd_i->offset>max ){
+				break;
+			}
+		}
+		fd_head->contiguous = max;
+	}
 
 	if( !(fd_head->flags & FD_DATALEN_SET) ){
 		/* if we don't know the sequence number of the last fragment,
@@ -1901,15 +1957,9 @@ fragment_add_seq_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 
 
 	/* check if we have received the entire fragment
-	 * this is easy since the list is sorted and the head is faked.
-	 * common case the whole list is scanned.
+	 * this is easy since the head keeps track of the contiguous run.
 	 */
-	max = 0;
-	for(fd_i=fd_head->next;fd_i;fd_i=fd_i->next) {
-	  if ( fd_i->offset==max ){
-		max++;
-	  }
-	}
+	max = fd_head->contiguous;
 	/* max will now be datalen+1 if all fragments have been seen */
 
 	if (max <= fd_head->datalen) {
@@ -2207,6 +2257,7 @@ fragment_add_seq_single_move(reassembly_table *table, const packet_info *pinfo,
 		fd = new_fh->next;
 		if (fd && fd->offset != 0) {
 			prev_fd->next = fd;
+			fh->last = NULL;
 			for (; fd; fd=fd->next) {
 				fd->offset += offset;
 				if (fh->frame < fd->frame) {
@@ -2221,6 +2272,7 @@ fragment_add_seq_single_move(reassembly_table *table, const packet_info *pinfo,
 			}
 			/* Now remove and delete */
 			new_fh->next = NULL;
+			new_fh->last = NULL;
 			old_tvb_data = fragment_delete(table, pinfo, id+offset, data);
 			if (old_tvb_data)
 				tvb_free(old_tvb_data);
@@ -2285,6 +2337,7 @@ fragment_add_seq_single_work(reassembly_table *table, tvbuff_t *tvb,
 					}
 				}
 				prev_fd->next = NULL;
+				new_fh->last = NULL;
 				break;
 			}
 		}
@@ -2367,6 +2420,7 @@ fragment_add_seq_single_work(reassembly_table *table, tvbuff_t *tvb,
 		 * if bit errors mess up Last or First. */
 		if (fd != NULL) {
 			prev_fd->next = NULL;
+			fh->last = NULL;
 			fh->frame = 0;
 			for (prev_fd=fh->next; prev_fd; prev_fd=prev_fd->next) {
 				if (fh->frame < prev_fd->frame) {
@@ -2510,6 +2564,8 @@ fragment_start_seq_check(reassembly_table *table, const packet_info *pinfo,
 		fd_head->flags = FD_BLOCKSEQUENCE|FD_DATALEN_SET;
 		fd_head->tvb_data = NULL;
 		fd_head->error = NULL;
+		fd_head->last = NULL;
+		fd_head->contiguous = 0;
 
 		insert_fd_head(table, fd_head, pinfo, id, data);
 	}
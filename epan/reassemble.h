@@ -83,6 +83,18 @@ typedef struct _fragment_item {
 	 * reassembly and for the fragments in a reassembly.
 	 */
 	const char *error;
+	/*
+	 * Bookkeeping for the reassembly head; meaningless (and wasted,
+	 * as with "error" above) in the fragments within a reassembly.
+	 */
+	struct _fragment_item *last;	/**< Last fragment in the sorted list, or
+					 * NULL if not currently known.  Code
+					 * doing list surgery behind the back of
+					 * LINK_FRAG() sets this to NULL; the
+					 * next insertion re-derives it. */
+	guint32 contiguous;		/**< For FD_BLOCKSEQUENCE reassemblies:
+					 * the number of contiguous blocks seen,
+					 * starting from block 0. */
 } fragment_item, fragment_head;
 
 
@@ -0,0 +1,117 @@
+/* request_track.c
+ * Bounded per-conversation request tracking.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <epan/request_track.h>
+
+/*
+ * Entries form a doubly-linked list from newest to oldest; the data
+ * block follows the header in the same allocation.  Once max_entries
+ * have been allocated, adding a request reuses the oldest entry
+ * instead of allocating a new one, so a tracker never holds more than
+ * max_entries * (sizeof entry header + data_size) bytes no matter how
+ * many requests go unanswered.
+ */
+typedef struct _request_track_entry {
+	struct _request_track_entry *newer;
+	struct _request_track_entry *older;
+	guint32	key;
+	guint32	frame_num;
+	/* data_size bytes of caller data follow */
+} request_track_entry_t;
+
+struct _request_track {
+	wmem_allocator_t	*scope;
+	gsize			 data_size;
+	guint			 max_entries;
+	guint			 num_entries;
+	request_track_entry_t	*newest;
+	request_track_entry_t	*oldest;
+};
+
+#define ENTRY_DATA(entry) ((void *)((guint8 *)(entry) + sizeof(request_track_entry_t)))
+
+request_track_t *
+request_track_new(wmem_allocator_t *scope, gsize data_size, guint max_entries)
+{
+	request_track_t *rt;
+
+	rt = wmem_new0(scope, request_track_t);
+	rt->scope = scope;
+	rt->data_size = data_size;
+	rt->max_entries = max_entries > 0 ? max_entries : 1;
+	return rt;
+}
+
+void *
+request_track_add(request_track_t *rt, guint32 key, guint32 frame_num)
+{
+	request_track_entry_t *entry;
+
+	if (rt->num_entries == rt->max_entries) {
+		/* Full: recycle the oldest entry. */
+		entry = rt->oldest;
+		rt->oldest = entry->newer;
+		if (rt->oldest)
+			rt->oldest->older = NULL;
+		else
+			rt->newest = NULL;	/* cap of one */
+	} else {
+		entry = (request_track_entry_t *)wmem_alloc(rt->scope,
+		    sizeof(request_track_entry_t) + rt->data_size);
+		rt->num_entries++;
+	}
+
+	entry->newer = NULL;
+	entry->older = rt->newest;
+	entry->key = key;
+	entry->frame_num = frame_num;
+	memset(ENTRY_DATA(entry), 0, rt->data_size);
+
+	if (rt->newest)
+		rt->newest->newer = entry;
+	else
+		rt->oldest = entry;
+	rt->newest = entry;
+
+	return ENTRY_DATA(entry);
+}
+
+void *
+request_track_find(request_track_t *rt, guint32 key, guint32 frame_num,
+    request_track_match_t match, const void *user_data)
+{
+	request_track_entry_t *entry;
+
+	for (entry = rt->newest; entry != NULL; entry = entry->older) {
+		if (entry->key != key || entry->frame_num >= frame_num)
+			continue;
+		if (match != NULL && !match(ENTRY_DATA(entry), user_data))
+			continue;
+		return ENTRY_DATA(entry);
+	}
+	return NULL;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
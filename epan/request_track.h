@@ -0,0 +1,97 @@
+/* request_track.h
+ * Bounded per-conversation request tracking.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __REQUEST_TRACK_H__
+#define __REQUEST_TRACK_H__
+
+#include <glib.h>
+#include <wsutil/wmem/wmem.h>
+#include "ws_symbol_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * A request tracker remembers the most recent outstanding requests of a
+ * conversation so that responses can be matched to them, with a hard cap
+ * on how many entries it will hold.  Request/response dissectors
+ * traditionally keep an unbounded wmem list or map for this; on captures
+ * where responses never arrive (one-directional taps, replay gaps) such
+ * a list grows for the lifetime of the file and every response has to
+ * scan all of it.  A tracker instead evicts the oldest entry once the
+ * cap is reached and recycles its storage for the next request, so both
+ * the memory it holds and the cost of a lookup are bounded by the cap.
+ *
+ * Entries are fixed-size blocks of caller-defined data, keyed by a
+ * 32-bit value of the caller's choosing (a transaction identifier,
+ * sequence number, ...) plus the request's frame number.  Lookups walk
+ * from the newest entry to the oldest, so a retransmitted request
+ * shadows the original, matching the behavior of the lists this
+ * replaces.
+ *
+ * A pointer returned by request_track_add() or request_track_find() is
+ * valid until the next request_track_add() on the same tracker, which
+ * may recycle the entry; copy out what you need before then.  Data that
+ * must outlive the entry (e.g. results attached to a response frame)
+ * belongs in per-packet proto data, not in the tracker.
+ */
+
+struct _request_track;
+typedef struct _request_track request_track_t;
+
+/**
+ * Extra per-entry match check for request_track_find(); return TRUE if
+ * the entry's data matches.  Only called for entries whose key already
+ * matches.
+ */
+typedef gboolean (*request_track_match_t)(const void *entry_data,
+    const void *user_data);
+
+/**
+ * Create a tracker in the given scope (normally wmem_file_scope()),
+ * holding at most max_entries entries of data_size bytes each.
+ */
+WS_DLL_PUBLIC request_track_t *request_track_new(wmem_allocator_t *scope,
+    gsize data_size, guint max_entries);
+
+/**
+ * Record a request, evicting the oldest entry if the tracker is full.
+ * Returns the entry's zero-filled data block for the caller to fill in.
+ */
+WS_DLL_PUBLIC void *request_track_add(request_track_t *rt, guint32 key,
+    guint32 frame_num);
+
+/**
+ * Find the newest tracked request with the given key that was recorded
+ * for a frame earlier than frame_num, or NULL if there is none.  If
+ * match is non-NULL it must also accept the entry's data.
+ */
+WS_DLL_PUBLIC void *request_track_find(request_track_t *rt, guint32 key,
+    guint32 frame_num, request_track_match_t match, const void *user_data);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __REQUEST_TRACK_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -23,6 +23,8 @@
 
 #define NODE_OVERFLOW MAX_NUM_NODES+1
 
+static guint add_or_get_node(seq_analysis_info_t *sainfo, address *node);
+
 struct register_analysis {
     const char* name;          /* Name (used for lookup) */
     const char* ui_name;       /* Name used for UI */
@@ -99,28 +101,40 @@ seq_analysis_item_t* sequence_analysis_create_sai_with_addresses(packet_info *pi
 {
     seq_analysis_item_t *sai = NULL;
     char time_str[COL_MAX_LEN];
+    address *src_addr, *dst_addr;
 
     if (sainfo->any_addr) {
-        if (pinfo->net_src.type!=AT_NONE && pinfo->net_dst.type!=AT_NONE) {
-            sai = g_new0(seq_analysis_item_t, 1);
-            copy_address(&(sai->src_addr),&(pinfo->net_src));
-            copy_address(&(sai->dst_addr),&(pinfo->net_dst));
-        }
-
+        src_addr = &pinfo->net_src;
+        dst_addr = &pinfo->net_dst;
     } else {
-        if (pinfo->src.type!=AT_NONE && pinfo->dst.type!=AT_NONE) {
-            sai = g_new0(seq_analysis_item_t, 1);
-            copy_address(&(sai->src_addr),&(pinfo->src));
-            copy_address(&(sai->dst_addr),&(pinfo->dst));
-        }
+        src_addr = &pinfo->src;
+        dst_addr = &pinfo->dst;
     }
 
-    if (sai) {
-        /* Fill in the timestamps */
-        set_fd_time(pinfo->epan, pinfo->fd, time_str);
-        sai->time_str = g_strdup(time_str);
+    if (src_addr->type == AT_NONE || dst_addr->type == AT_NONE)
+        return NULL;
+
+    if (sainfo->window_count > 0) {
+        guint32 ordinal = sainfo->items_seen++;
+
+        /* Collect the nodes for every matching packet, so the node list is
+         * complete and stable no matter which window gets materialized. */
+        add_or_get_node(sainfo, src_addr);
+        add_or_get_node(sainfo, dst_addr);
+
+        if (ordinal < sainfo->window_start ||
+            ordinal - sainfo->window_start >= sainfo->window_count)
+            return NULL;
     }
 
+    sai = g_new0(seq_analysis_item_t, 1);
+    copy_address(&(sai->src_addr), src_addr);
+    copy_address(&(sai->dst_addr), dst_addr);
+
+    /* Fill in the timestamps */
+    set_fd_time(pinfo->epan, pinfo->fd, time_str);
+    sai->time_str = g_strdup(time_str);
+
     return sai;
 }
 
@@ -239,6 +253,7 @@ sequence_analysis_list_free(seq_analysis_info_t *sainfo)
         g_hash_table_remove_all(sainfo->ht);
     }
     sainfo->nconv = 0;
+    sainfo->items_seen = 0;
 
     sequence_analysis_free_nodes(sainfo);
 }
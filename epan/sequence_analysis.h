@@ -65,6 +65,9 @@ typedef struct _seq_analysis_info {
     GHashTable *ht;          /**< hash table of seq_analysis_info_t */
     address nodes[MAX_NUM_NODES]; /**< horizontal node list */
     guint32 num_nodes;       /**< actual number of nodes */
+    guint32 window_start;    /**< first item ordinal to materialize (windowed analysis) */
+    guint32 window_count;    /**< number of items to materialize, 0 to keep every item */
+    guint32 items_seen;      /**< matching items seen during the last windowed tap pass */
 } seq_analysis_info_t;
 
 /** Structure for information about a registered sequence analysis function */
@@ -121,9 +124,16 @@ WS_DLL_PUBLIC guint sequence_analysis_get_tap_flags(register_analysis_t* analysi
  * Allocate a seq_analysis_item_t to return and populate the time_str and src_addr and dst_addr
  * members based on seq_analysis_info_t any_addr member
  *
+ * When the sainfo window_count member is non-zero, an item is only allocated
+ * for item ordinals in [window_start, window_start + window_count); every
+ * matching packet still has its addresses added to the node list and is
+ * counted in items_seen, so a windowed tap pass discovers the complete node
+ * list and item total while materializing no more than window_count items.
+ *
  * @param pinfo packet info
  * @param sainfo info determining address type
- * @return sequence analysis tap flags
+ * @return newly allocated item, or NULL if the packet has no usable
+ * addresses or falls outside the materialization window
  */
 WS_DLL_PUBLIC seq_analysis_item_t* sequence_analysis_create_sai_with_addresses(packet_info *pinfo, seq_analysis_info_t *sainfo);
 
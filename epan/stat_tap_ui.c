@@ -40,6 +40,11 @@ typedef struct {
 } stat_requested;
 static GSList *stats_requested = NULL;
 
+/* the arguments of every stat requested on the command line, in order,
+   kept for the lifetime of the process so UIs can report what was run
+   (see stat_cmd_args_get_requested()) */
+static GSList *stats_requested_log = NULL;
+
 /* **********************************************************************
  * Function called from stat to register the stat's command-line argument
  * and initialization routine
@@ -102,6 +107,8 @@ process_stat_cmd_arg(const char *optstr)
             tr->sca = sca;
             tr->arg = stat_command;
             stats_requested = g_slist_append(stats_requested, tr);
+            stats_requested_log = g_slist_append(stats_requested_log,
+                wmem_strdup(wmem_epan_scope(), stat_command));
             return TRUE;
         }
     }
@@ -141,6 +148,12 @@ start_requested_stats(void)
     }
 }
 
+GSList *
+stat_cmd_args_get_requested(void)
+{
+    return stats_requested_log;
+}
+
 static wmem_tree_t *registered_stat_tables = NULL;
 
 void register_stat_tap_table_ui(stat_tap_table_ui *ui)
@@ -184,6 +184,14 @@ WS_DLL_PUBLIC void list_stat_cmd_args(void);
 
 WS_DLL_PUBLIC void start_requested_stats(void);
 
+/** Get the arguments of every stat requested on the command line, in
+ * the order they were given.
+ *
+ * @return A list of const char * argument strings, owned by the epan
+ * scope; the caller must not modify or free it.
+ */
+WS_DLL_PUBLIC GSList *stat_cmd_args_get_requested(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -641,6 +641,8 @@ update_burst_calc(stat_node *node, gint value)
     }
 }
 
+static int manip_int_node(manip_node_mode mode, stat_node *node, gint value);
+
 /*
  * Increases by delta the counter of the node whose name is given
  * if the node does not exist yet it's created (with counter=1)
@@ -667,6 +669,14 @@ stats_tree_manip_node_int(manip_node_mode mode, stats_tree *st, const char *name
     if ( node == NULL )
         node = new_stat_node(st,name,parent_id,STAT_DT_INT,with_hash,with_hash);
 
+    return manip_int_node(mode, node, value);
+}
+
+/* Applies mode to an already-resolved node; shared by the by-name and
+ * by-id entry points. */
+static int
+manip_int_node(manip_node_mode mode, stat_node *node, gint value)
+{
     switch (mode) {
         case MN_INCREASE:
             node->counter += value;
@@ -703,6 +713,24 @@ stats_tree_manip_node_int(manip_node_mode mode, stats_tree *st, const char *name
         return -1;
 }
 
+/*
+ * Same as stats_tree_manip_node_int() but takes the id of an existing
+ * node, as returned by stats_tree_create_node() or an earlier by-name
+ * manipulation, so ticking a node whose handle the caller already holds
+ * doesn't redo the per-packet name hash lookup.
+ */
+int
+stats_tree_manip_node_id_int(manip_node_mode mode, stats_tree *st, int node_id, gint value)
+{
+    stat_node *node = NULL;
+
+    ws_assert( node_id >= 0 && node_id < (int) st->parents->len );
+
+    node = (stat_node *)g_ptr_array_index(st->parents,node_id);
+
+    return manip_int_node(mode, node, value);
+}
+
 /*
 * Increases by delta the counter of the node whose name is given
 * if the node does not exist yet it's created (with counter=1)
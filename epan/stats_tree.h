@@ -208,12 +208,30 @@ WS_DLL_PUBLIC int stats_tree_manip_node_float(manip_node_mode mode,
                                         gboolean with_children,
                                         gfloat value);
 
+/*
+ * Same as stats_tree_manip_node_int() but takes the id of an existing
+ * node - as returned by stats_tree_create_node() or an earlier by-name
+ * manipulation - instead of resolving the node by name.  Use this for
+ * nodes whose handle the per-packet callback already holds, so ticking
+ * them doesn't format and hash a name on every packet.
+ */
+WS_DLL_PUBLIC int stats_tree_manip_node_id_int(manip_node_mode mode,
+                                        stats_tree *st,
+                                        int node_id,
+                                        gint value);
+
 #define increase_stat_node(st,name,parent_id,with_children,value)       \
     (stats_tree_manip_node_int(MN_INCREASE,(st),(name),(parent_id),(with_children),(value)))
 
 #define tick_stat_node(st,name,parent_id,with_children)                 \
     (stats_tree_manip_node_int(MN_INCREASE,(st),(name),(parent_id),(with_children),1))
 
+#define increase_stat_node_id(st,node_id,value)                         \
+    (stats_tree_manip_node_id_int(MN_INCREASE,(st),(node_id),(value)))
+
+#define tick_stat_node_id(st,node_id)                                   \
+    (stats_tree_manip_node_id_int(MN_INCREASE,(st),(node_id),1))
+
 #define set_stat_node(st,name,parent_id,with_children,value)            \
     (stats_tree_manip_node_int(MN_SET,(st),(name),(parent_id),(with_children),value))
 
@@ -91,6 +91,8 @@ typedef struct _tap_listener_t {
 	tap_packet_cb packet;
 	tap_draw_cb draw;
 	tap_finish_cb finish;
+	int *needed_hfids;
+	guint num_needed_hfids;
 } tap_listener_t;
 
 static tap_listener_t *tap_listener_queue=NULL;
@@ -272,9 +274,14 @@ void tap_build_interesting (epan_dissect_t *edt)
 	/* loop over all tap listeners and build the list of all
 	   interesting hf_fields */
 	for(tl=tap_listener_queue;tl;tl=tl->next){
+		guint i;
+
 		if(tl->code){
 			epan_dissect_prime_with_dfilter(edt, tl->code);
 		}
+		for(i=0;i<tl->num_needed_hfids;i++){
+			epan_dissect_prime_with_hfid(edt, tl->needed_hfids[i]);
+		}
 	}
 }
 
@@ -319,62 +326,65 @@ tap_push_tapped_queue(epan_dissect_t *edt)
 		return;
 	}
 
-	/* loop over all tap listeners and call the listener callback
-	   for all packets that match the filter. */
-	for(i=0;i<tap_packet_index;i++){
-		for(tl=tap_listener_queue;tl;tl=tl->next){
+	/* Loop over the listeners in the outer loop, so that the
+	   per-listener work - the "is there a per-packet routine", "did a
+	   previous call fail" checks and, above all, the filter - is done
+	   once per packet rather than once per queued entry.  Every entry
+	   in the queue was tapped during the dissection in "edt", so a
+	   listener's filter gives the same answer for all of them.  Each
+	   listener still sees its entries in the order they were queued. */
+	for(tl=tap_listener_queue;tl;tl=tl->next){
+		if(!tl->packet){
+			/* There isn't a per-packet routine for this tap. */
+			continue;
+		}
+		if(tl->failed){
+			/* A previous call failed, meaning "stop running
+			 * this tap", so don't call the packet routine.
+			 */
+			continue;
+		}
+
+		/* If we have a filter, see if the packet passes. */
+		if(tl->code){
+			if (!dfilter_apply_edt(tl->code, edt)){
+				/* The packet didn't pass the filter. */
+				continue;
+			}
+		}
+
+		for(i=0;i<tap_packet_index;i++){
 			tp=&tap_packet_array[i];
+			if(tp->tap_id!=tl->tap_id){
+				continue;
+			}
 			/* Don't tap the packet if it's an "error packet"
 			 * unless the listener has requested that we do so.
 			 */
-			if (!(tp->flags & TAP_PACKET_IS_ERROR_PACKET) || (tl->flags & TL_REQUIRES_ERROR_PACKETS))
-			{
-				if(tp->tap_id==tl->tap_id){
-					if(!tl->packet){
-						/* There isn't a per-packet
-						 * routine for this tap.
-						 */
-						continue;
-					}
-					if(tl->failed){
-						/* A previous call failed,
-						 * meaning "stop running this
-						 * tap", so don't call the
-						 * packet routine.
-						 */
-						continue;
-					}
-
-					/* If we have a filter, see if the
-					 * packet passes.
-					 */
-					if(tl->code){
-						if (!dfilter_apply_edt(tl->code, edt)){
-							/* The packet didn't
-							 * pass the filter. */
-							continue;
-						}
-					}
-
-					/* So call the per-packet routine. */
-					tap_packet_status status;
-
-					status = tl->packet(tl->tapdata, tp->pinfo, edt, tp->tap_specific_data);
-
-					switch (status) {
-
-					case TAP_PACKET_DONT_REDRAW:
-						break;
-
-					case TAP_PACKET_REDRAW:
-						tl->needs_redraw=TRUE;
-						break;
-
-					case TAP_PACKET_FAILED:
-						tl->failed=TRUE;
-						break;
-					}
-				}
+			if((tp->flags & TAP_PACKET_IS_ERROR_PACKET) && !(tl->flags & TL_REQUIRES_ERROR_PACKETS)){
+				continue;
+			}
+
+			/* So call the per-packet routine. */
+			tap_packet_status status;
+
+			status = tl->packet(tl->tapdata, tp->pinfo, edt, tp->tap_specific_data);
+
+			switch (status) {
+
+			case TAP_PACKET_DONT_REDRAW:
+				break;
+
+			case TAP_PACKET_REDRAW:
+				tl->needs_redraw=TRUE;
+				break;
+
+			case TAP_PACKET_FAILED:
+				tl->failed=TRUE;
+				break;
+			}
+			if(tl->failed){
+				break;
 			}
 		}
 	}
@@ -519,6 +529,7 @@ free_tap_listener(tap_listener_t *tl)
 	}
 	dfilter_free(tl->code);
 	g_free(tl->fstring);
+	g_free(tl->needed_hfids);
 	g_free(tl);
 }
 
@@ -532,6 +543,25 @@ GString *
 register_tap_listener(const char *tapname, void *tapdata, const char *fstring,
 		      guint flags, tap_reset_cb reset, tap_packet_cb packet,
 		      tap_draw_cb draw, tap_finish_cb finish)
+{
+	return register_tap_listener_with_fields(tapname, tapdata, fstring,
+	    flags, reset, packet, draw, finish, NULL, 0);
+}
+
+/* this function attaches the tap_listener to the named tap, additionally
+ * declaring the header field ids the listener reads from edt->tree so that
+ * they can be primed into an otherwise faked protocol tree.
+ * function returns :
+ *     NULL: ok.
+ * non-NULL: error, return value points to GString containing error
+ *           message.
+ */
+GString *
+register_tap_listener_with_fields(const char *tapname, void *tapdata,
+		      const char *fstring, guint flags, tap_reset_cb reset,
+		      tap_packet_cb packet, tap_draw_cb draw,
+		      tap_finish_cb finish, const int *needed_hfids,
+		      guint num_needed_hfids)
 {
 	tap_listener_t *tl;
 	int tap_id;
@@ -563,6 +593,11 @@ register_tap_listener(const char *tapname, void *tapdata, const char *fstring,
 	}
 	tl->fstring=g_strdup(fstring);
 	tl->code=code;
+	if(needed_hfids && num_needed_hfids){
+		tl->needed_hfids=(int *)g_memdup2(needed_hfids,
+		    num_needed_hfids*sizeof(int));
+		tl->num_needed_hfids=num_needed_hfids;
+	}
 
 	tl->tap_id=tap_id;
 	tl->tapdata=tapdata;
@@ -739,6 +774,23 @@ have_filtering_tap_listeners(void)
 	return FALSE;
 }
 
+/*
+ * Return TRUE if we have any tap listeners that declared needed fields,
+ * FALSE otherwise.  Like filtering listeners, they need a protocol tree
+ * to be built, but it can be a faked tree with just those fields primed.
+ */
+gboolean
+have_field_tap_listeners(void)
+{
+	tap_listener_t *tl;
+
+	for(tl=tap_listener_queue;tl;tl=tl->next){
+		if(tl->num_needed_hfids)
+			return TRUE;
+	}
+	return FALSE;
+}
+
 /*
  * Get the union of all the flags for all the tap listeners; that gives
  * an indication of whether the protocol tree, or the columns, are
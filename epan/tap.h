@@ -226,6 +226,20 @@ WS_DLL_PUBLIC GString *register_tap_listener(const char *tapname, void *tapdata,
     tap_packet_cb tap_packet, tap_draw_cb tap_draw,
     tap_finish_cb tap_finish) G_GNUC_WARN_UNUSED_RESULT;
 
+/** Register a tap listener, additionally declaring the header field ids
+ * the listener's "packet" routine reads from edt->tree.  This is a
+ * lighter-weight alternative to TL_REQUIRES_PROTO_TREE for listeners that
+ * only need the values of a few known fields: the declared fields are
+ * primed into the protocol tree before each packet is dissected, exactly
+ * as a listener filter's fields are, so the dissection engine can fake
+ * the rest of the tree instead of building all of it.  The needed_hfids
+ * array is copied.
+ */
+WS_DLL_PUBLIC GString *register_tap_listener_with_fields(const char *tapname,
+    void *tapdata, const char *fstring, guint flags, tap_reset_cb tap_reset,
+    tap_packet_cb tap_packet, tap_draw_cb tap_draw, tap_finish_cb tap_finish,
+    const int *needed_hfids, guint num_needed_hfids) G_GNUC_WARN_UNUSED_RESULT;
+
 /** This function sets a new dfilter to a tap listener */
 WS_DLL_PUBLIC GString *set_tap_dfilter(void *tapdata, const char *fstring);
 
@@ -247,6 +261,12 @@ WS_DLL_PUBLIC gboolean have_tap_listener(int tap_id);
 /** Return TRUE if we have any tap listeners with filters, FALSE otherwise. */
 WS_DLL_PUBLIC gboolean have_filtering_tap_listeners(void);
 
+/** Return TRUE if we have any tap listeners that declared needed fields,
+ * FALSE otherwise.  Like filtering listeners, they need a protocol tree to
+ * be built, but it can be a faked tree with just those fields primed.
+ */
+WS_DLL_PUBLIC gboolean have_field_tap_listeners(void);
+
 /**
  * Get the union of all the flags for all the tap listeners; that gives
  * an indication of whether the protocol tree, or the columns, are
@@ -418,13 +418,12 @@ get_zonename(struct tm *tmp)
 #endif /* _WIN32 */
 }
 
-gchar *
-abs_time_to_str(wmem_allocator_t *scope, const nstime_t *abs_time, const absolute_time_display_e fmt,
-		gboolean show_zone)
+void
+abs_time_to_str_buf(const nstime_t *abs_time, const absolute_time_display_e fmt,
+		gboolean show_zone, gchar *buf, int buf_len)
 {
 	struct tm *tmp = NULL;
 	const char *zonename = "???";
-	gchar *buf = NULL;
 
 
 	switch (fmt) {
@@ -448,7 +447,7 @@ abs_time_to_str(wmem_allocator_t *scope, const nstime_t *abs_time, const absolut
 
 			case ABSOLUTE_TIME_DOY_UTC:
 				if (show_zone) {
-					buf = wmem_strdup_printf(scope,
+					g_snprintf(buf, buf_len,
 							"%04d/%03d:%02d:%02d:%02d.%09ld %s",
 							tmp->tm_year + 1900,
 							tmp->tm_yday + 1,
@@ -458,7 +457,7 @@ abs_time_to_str(wmem_allocator_t *scope, const nstime_t *abs_time, const absolut
 							(long)abs_time->nsecs,
 							zonename);
 				} else {
-					buf = wmem_strdup_printf(scope,
+					g_snprintf(buf, buf_len,
 							"%04d/%03d:%02d:%02d:%02d.%09ld",
 							tmp->tm_year + 1900,
 							tmp->tm_yday + 1,
@@ -474,7 +473,7 @@ abs_time_to_str(wmem_allocator_t *scope, const nstime_t *abs_time, const absolut
 			case ABSOLUTE_TIME_LOCAL:
 				if ((abs_time->secs == 0) && (abs_time->nsecs == 0)) {
 					if (show_zone) {
-						buf = wmem_strdup_printf(scope,
+						g_snprintf(buf, buf_len,
 							"(0)%s %2d, %d %02d:%02d:%02d.%09ld %s",
 							mon_names[tmp->tm_mon],
 							tmp->tm_mday,
@@ -485,7 +484,7 @@ abs_time_to_str(wmem_allocator_t *scope, const nstime_t *abs_time, const absolut
 							(long)abs_time->nsecs,
 							zonename);
 					} else {
-						buf = wmem_strdup_printf(scope,
+						g_snprintf(buf, buf_len,
 							"(0)%s %2d, %d %02d:%02d:%02d.%09ld",
 							mon_names[tmp->tm_mon],
 							tmp->tm_mday,
@@ -498,7 +497,7 @@ abs_time_to_str(wmem_allocator_t *scope, const nstime_t *abs_time, const absolut
 					break;
 				}
 				if (show_zone) {
-					buf = wmem_strdup_printf(scope,
+					g_snprintf(buf, buf_len,
 							"%s %2d, %d %02d:%02d:%02d.%09ld %s",
 							mon_names[tmp->tm_mon],
 							tmp->tm_mday,
@@ -509,7 +508,7 @@ abs_time_to_str(wmem_allocator_t *scope, const nstime_t *abs_time, const absolut
 							(long)abs_time->nsecs,
 							zonename);
 				} else {
-					buf = wmem_strdup_printf(scope,
+					g_snprintf(buf, buf_len,
 							"%s %2d, %d %02d:%02d:%02d.%09ld",
 							mon_names[tmp->tm_mon],
 							tmp->tm_mday,
@@ -522,8 +521,17 @@ abs_time_to_str(wmem_allocator_t *scope, const nstime_t *abs_time, const absolut
 				break;
 		}
 	} else
-		buf = wmem_strdup(scope, "Not representable");
-	return buf;
+		g_strlcpy(buf, "Not representable", buf_len);
+}
+
+gchar *
+abs_time_to_str(wmem_allocator_t *scope, const nstime_t *abs_time, const absolute_time_display_e fmt,
+		gboolean show_zone)
+{
+	gchar buf[ABS_TIME_TO_STR_SIZE];
+
+	abs_time_to_str_buf(abs_time, fmt, show_zone, buf, sizeof(buf));
+	return wmem_strdup(scope, buf);
 }
 
 gchar *
@@ -951,6 +959,13 @@ rel_time_to_str(wmem_allocator_t *scope, const nstime_t *rel_time)
 /*
  * Display a relative time as seconds.
  */
+void
+rel_time_to_secs_str_buf(const nstime_t *rel_time, gchar *buf, int buf_len)
+{
+	display_signed_time(buf, buf_len, (gint64) rel_time->secs,
+			rel_time->nsecs, TO_STR_TIME_RES_T_NSECS);
+}
+
 gchar *
 rel_time_to_secs_str(wmem_allocator_t *scope, const nstime_t *rel_time)
 {
@@ -958,8 +973,7 @@ rel_time_to_secs_str(wmem_allocator_t *scope, const nstime_t *rel_time)
 
 	buf=(gchar *)wmem_alloc(scope, REL_TIME_SECS_LEN);
 
-	display_signed_time(buf, REL_TIME_SECS_LEN, (gint64) rel_time->secs,
-			rel_time->nsecs, TO_STR_TIME_RES_T_NSECS);
+	rel_time_to_secs_str_buf(rel_time, buf, REL_TIME_SECS_LEN);
 	return buf;
 }
 
@@ -70,6 +70,11 @@ gchar *address_to_display(wmem_allocator_t *allocator, const address *addr);
 
 WS_DLL_PUBLIC void     address_to_str_buf(const address *addr, gchar *buf, int buf_len);
 
+/* The same as address_with_resolution_to_str, but into a caller-provided
+ * buffer so no allocation is needed. A buffer of MAX_ADDR_STR_LEN always
+ * suffices. */
+WS_DLL_PUBLIC void     address_with_resolution_to_str_buf(const address *addr, gchar *buf, int buf_len);
+
 #define tvb_ether_to_str(tvb, offset) tvb_address_to_str(wmem_packet_scope(), tvb, AT_ETHER, offset)
 #define tvb_ip_to_str(tvb, offset) tvb_address_to_str(wmem_packet_scope(), tvb, AT_IPv4, offset)
 #define tvb_ip6_to_str(tvb, offset) tvb_address_to_str(wmem_packet_scope(), tvb, AT_IPv6, offset)
@@ -88,8 +93,14 @@ int ip6_to_str_buf_with_pfx(const ws_in6_addr *ad, gchar *buf, int buf_size, con
 extern gchar*	ipxnet_to_str_punct(wmem_allocator_t *scope, const guint32 ad, const char punct);
 WS_DLL_PUBLIC gchar*	eui64_to_str(wmem_allocator_t *scope, const guint64 ad);
 
+/* Enough room for the longest abs_time_to_str_buf result, including the
+ * terminating '\0'; time zone names make the exact bound system-dependent. */
+#define ABS_TIME_TO_STR_SIZE 128
+
 WS_DLL_PUBLIC gchar*	abs_time_to_str(wmem_allocator_t *scope, const nstime_t*, const absolute_time_display_e fmt,
     gboolean show_zone);
+WS_DLL_PUBLIC void	abs_time_to_str_buf(const nstime_t*, const absolute_time_display_e fmt,
+    gboolean show_zone, gchar *buf, int buf_len);
 WS_DLL_PUBLIC gchar*	abs_time_secs_to_str(wmem_allocator_t *scope, const time_t, const absolute_time_display_e fmt,
     gboolean show_zone);
 WS_DLL_PUBLIC void	display_epoch_time(gchar *, int, const time_t,  gint32, const to_str_time_res_t);
@@ -103,8 +114,13 @@ WS_DLL_PUBLIC gchar*	signed_time_msecs_to_str(wmem_allocator_t *scope, gint32 ti
 WS_DLL_PUBLIC void guint32_to_str_buf(guint32 u, gchar *buf, int buf_len);
 WS_DLL_PUBLIC void guint64_to_str_buf(guint64 u, gchar *buf, int buf_len);
 
+/* Enough room for the longest rel_time_to_secs_str_buf result, including
+ * the terminating '\0' (sign, 19 digits, '.', 9 digits). */
+#define REL_TIME_SECS_STR_SIZE 31
+
 WS_DLL_PUBLIC gchar*	rel_time_to_str(wmem_allocator_t *scope, const nstime_t*);
 WS_DLL_PUBLIC gchar*	rel_time_to_secs_str(wmem_allocator_t *scope, const nstime_t*);
+WS_DLL_PUBLIC void	rel_time_to_secs_str_buf(const nstime_t*, gchar *buf, int buf_len);
 WS_DLL_PUBLIC gchar*	guid_to_str(wmem_allocator_t *scope, const e_guid_t*);
 gchar*	guid_to_str_buf(const e_guid_t*, gchar*, int);
 
@@ -124,27 +124,36 @@ static int ignore_fcn(tvbparse_t* tt, int offset) {
 }
 
 
-static int cond_char (tvbparse_t* tt, const int offset, const tvbparse_wanted_t * wanted, tvbparse_elem_t** tok) {
-    gchar c,t;
-    guint i;
+/* Build a 256-entry membership table from a character list, accepting
+   (accept == TRUE) or rejecting (accept == FALSE) the listed characters.
+   Lowering the lists into tables at registration time turns every
+   per-byte class test in the matching loops into a single index. */
+static char* make_accept_str(const gchar* chr, gboolean accept) {
+    char *accept_str;
+    gsize i;
 
-#ifdef TVBPARSE_DEBUG
-    if (TVBPARSE_DEBUG & TVBPARSE_DEBUG_CHAR) ws_warning("cond_char: control='%s'",wanted->control.str);
-#endif
+    accept_str = (char *)wmem_alloc(wmem_epan_scope(), 256);
+    memset(accept_str, accept ? 0x00 : 0xFF, 256);
+    for (i = 0; chr[i]; i++)
+        accept_str[(unsigned) chr[i]] = accept ? (char)0xFF : '\0';
+
+    return accept_str;
+}
+
+static int cond_char (tvbparse_t* tt, const int offset, const tvbparse_wanted_t * wanted, tvbparse_elem_t** tok) {
+    guint8 t;
 
     if ( offset + 1 > tt->end_offset )
         return -1;
 
-    t = (gchar) tvb_get_guint8(tt->tvb,offset);
+    t = tvb_get_guint8(tt->tvb,offset);
 
-    for(i = 0; (c = wanted->control.str[i]) && offset <= tt->end_offset; i++) {
-        if ( c == t ) {
-            *tok =  new_tok(tt,wanted->id,offset,1,wanted);
+    if ( wanted->control.str[t] ) {
+        *tok =  new_tok(tt,wanted->id,offset,1,wanted);
 #ifdef TVBPARSE_DEBUG
-            if (TVBPARSE_DEBUG & TVBPARSE_DEBUG_CHAR) ws_warning("cond_char: GOT: '%c'",c);
+        if (TVBPARSE_DEBUG & TVBPARSE_DEBUG_CHAR) ws_warning("cond_char: GOT: '%c'",t);
 #endif
-            return 1;
-        }
+        return 1;
     }
 
     return -1;
@@ -159,7 +168,7 @@ tvbparse_wanted_t* tvbparse_char(const int id,
 
     w->condition = cond_char;
     w->id = id;
-    w->control.str = chr;
+    w->control.str = make_accept_str(chr, TRUE);
     w->len = 1;
     w->data = data;
     w->before = before_cb;
@@ -182,15 +191,14 @@ static int cond_chars_common(tvbparse_t* tt, int offset, const tvbparse_wanted_t
 
     left = left < (int) wanted->max ? left :  (int) wanted->max;
 
-    while( left > 0 ) {
-        guint8 t = tvb_get_guint8(tt->tvb,offset++);
+    if ( left > 0 ) {
+        /* One bounds check for the whole window, then a tight loop over
+           the membership table. */
+        const guint8 *p = tvb_get_ptr(tt->tvb, offset, left);
 
-        if (!wanted->control.str[t])
-            break;
-
-        length++;
-        left--;
-    };
+        while ( length < (guint) left && wanted->control.str[p[length]] )
+            length++;
+    }
 
     if (length < wanted->min) {
         return  -1;
@@ -212,17 +220,10 @@ tvbparse_wanted_t* tvbparse_chars(const int id,
                                   tvbparse_action_t after_cb)
 {
     tvbparse_wanted_t* w = wmem_new0(wmem_epan_scope(), tvbparse_wanted_t);
-    char *accept_str;
-    gsize i;
-
-    accept_str = (char *)wmem_alloc(wmem_epan_scope(), 256);
-    memset(accept_str, 0x00, 256);
-    for (i = 0; chr[i]; i++)
-        accept_str[(unsigned)chr[i]] = (char)0xFF;
 
     w->condition = cond_chars_common;
     w->id = id;
-    w->control.str = accept_str;
+    w->control.str = make_accept_str(chr, TRUE);
     w->min = min_len ? min_len : 1;
     w->max = max_len ? max_len : G_MAXINT/2;
     w->data = data;
@@ -234,27 +235,15 @@ tvbparse_wanted_t* tvbparse_chars(const int id,
 
 
 static int cond_not_char(tvbparse_t* tt, const int offset, const tvbparse_wanted_t * wanted, tvbparse_elem_t** tok) {
-    gchar c, t;
-    guint i;
-    gboolean not_matched = FALSE;
-
-#ifdef TVBPARSE_DEBUG
-    if (TVBPARSE_DEBUG & TVBPARSE_DEBUG_NOT_CHAR) ws_warning("cond_not_char: control='%s'",wanted->control.str);
-#endif
+    guint8 t;
 
     if ( offset >= tt->end_offset ) {
         return -1;
     }
 
-    t = (gchar) tvb_get_guint8(tt->tvb,offset);
-
-    for(i = 0; (c = wanted->control.str[i]); i++) {
-        if ( c == t ) {
-            not_matched = TRUE;
-        }
-    }
+    t = tvb_get_guint8(tt->tvb,offset);
 
-    if (not_matched) {
+    if ( !wanted->control.str[t] ) {
         return -1;
     } else {
         *tok =  new_tok(tt,wanted->id,offset,1,wanted);
@@ -274,7 +263,7 @@ tvbparse_wanted_t* tvbparse_not_char(const int id,
 
     w->condition = cond_not_char;
     w->id = id;
-    w->control.str = chr;
+    w->control.str = make_accept_str(chr, FALSE);
     w->data = data;
     w->before = before_cb;
     w->after = after_cb;
@@ -291,18 +280,12 @@ tvbparse_wanted_t* tvbparse_not_chars(const int id,
                                       tvbparse_action_t after_cb)
 {
     tvbparse_wanted_t* w = wmem_new0(wmem_epan_scope(), tvbparse_wanted_t);
-    char *accept_str;
-    gsize i;
-
-    /* cond_chars_common() use accept string, so mark all elements with, and later unset from reject */
-    accept_str = (char *)wmem_alloc(wmem_epan_scope(), 256);
-    memset(accept_str, 0xFF, 256);
-    for (i = 0; chr[i]; i++)
-        accept_str[(unsigned) chr[i]] = '\0';
 
+    /* cond_chars_common() uses an accept table, so accept everything
+       except the rejected characters */
     w->condition = cond_chars_common;
     w->id = id;
-    w->control.str = accept_str;
+    w->control.str = make_accept_str(chr, FALSE);
     w->len = 0;
     w->min = min_len ? min_len : 1;
     w->max = max_len ? max_len : G_MAXINT/2;
@@ -767,9 +750,30 @@ static int cond_until(tvbparse_t* tt, const int offset, const tvbparse_wanted_t
     if (++tt->recursion_depth > TVBPARSE_MAX_RECURSION_DEPTH)
         return -1;
 
-    do {
-        len = wanted->control.until.subelem->condition(tt, target_offset++, wanted->control.until.subelem,  &new_elem);
-    } while(len < 0  && target_offset+1 < tt->end_offset);
+    if (wanted->control.until.subelem->condition == cond_char) {
+        /* The terminator is a single character class; scan the window
+           over its membership table directly instead of re-invoking the
+           condition at every offset. */
+        const tvbparse_wanted_t* subelem = wanted->control.until.subelem;
+        const guint8 *p = tvb_get_ptr(tt->tvb, offset, tt->end_offset - offset);
+        int i = 0;
+
+        len = -1;
+        do {
+            if (subelem->control.str[p[i]]) {
+                len = 1;
+                target_offset = offset + i + 1;
+                new_elem = new_tok(tt, subelem->id, offset + i, 1, subelem);
+                break;
+            }
+            i++;
+            target_offset = offset + i;
+        } while(target_offset+1 < tt->end_offset);
+    } else {
+        do {
+            len = wanted->control.until.subelem->condition(tt, target_offset++, wanted->control.until.subelem,  &new_elem);
+        } while(len < 0  && target_offset+1 < tt->end_offset);
+    }
 
     tt->recursion_depth--;
 
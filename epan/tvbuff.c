@@ -930,6 +930,13 @@ tvb_get_ptr(tvbuff_t *tvb, const gint offset, const gint length)
 	return ensure_contiguous(tvb, offset, length);
 }
 
+void
+tvb_get_span(tvbuff_t *tvb, const gint offset, const gint length, tvb_span_t *span)
+{
+	span->data   = ensure_contiguous(tvb, offset, length);
+	span->length = length;
+}
+
 /* ---------------- */
 guint8
 tvb_get_guint8(tvbuff_t *tvb, const gint offset)
@@ -27,6 +27,7 @@
 #include <epan/ipv6.h>
 
 #include <wsutil/nstime.h>
+#include <wsutil/pint.h>
 #include "wsutil/ws_mempbrk.h"
 
 #ifdef __cplusplus
@@ -495,6 +496,65 @@ WS_DLL_PUBLIC void *tvb_memdup(wmem_allocator_t *scope, tvbuff_t *tvb,
 WS_DLL_PUBLIC const guint8 *tvb_get_ptr(tvbuff_t *tvb, const gint offset,
     const gint length);
 
+/** A contiguous, bounds-checked span of tvbuff data.
+ *
+ * tvb_get_span() validates the whole region up front, throwing the usual
+ * bounds exceptions if any of it is missing; after that the fields inside
+ * the span can be read through the branchless tvb_span_get_*() accessors
+ * below with no further per-access checking, which also lets the compiler
+ * combine and vectorize multi-field extraction. Intended for fixed-size
+ * protocol headers whose fields are extracted one after another.
+ *
+ * The data pointer is internal to the tvbuff, so all of the caveats for
+ * tvb_get_ptr() above apply: keep reads strictly inside the validated
+ * length and don't hold on to the span after the dissector returns. */
+typedef struct {
+    const guint8 *data;     /**< first byte of the validated region */
+    guint         length;   /**< number of validated bytes */
+} tvb_span_t;
+
+/** Validate 'length' bytes at 'offset' and fill in a span covering them.
+ * Throws an exception, just as the tvb_get_*() accessors would, if the
+ * region isn't entirely present. */
+WS_DLL_PUBLIC void tvb_get_span(tvbuff_t *tvb, const gint offset,
+    const gint length, tvb_span_t *span);
+
+static inline guint8
+tvb_span_get_guint8(const tvb_span_t *span, const guint offset)
+{
+    return span->data[offset];
+}
+
+static inline guint16
+tvb_span_get_ntohs(const tvb_span_t *span, const guint offset)
+{
+    return pntoh16(span->data + offset);
+}
+
+static inline guint32
+tvb_span_get_ntohl(const tvb_span_t *span, const guint offset)
+{
+    return pntoh32(span->data + offset);
+}
+
+static inline guint64
+tvb_span_get_ntoh64(const tvb_span_t *span, const guint offset)
+{
+    return pntoh64(span->data + offset);
+}
+
+static inline guint16
+tvb_span_get_letohs(const tvb_span_t *span, const guint offset)
+{
+    return pletoh16(span->data + offset);
+}
+
+static inline guint32
+tvb_span_get_letohl(const tvb_span_t *span, const guint offset)
+{
+    return pletoh32(span->data + offset);
+}
+
 /** Find first occurrence of needle in tvbuff, starting at offset. Searches
  * at most maxlength number of bytes; if maxlength is -1, searches to
  * end of tvbuff.
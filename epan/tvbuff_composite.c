@@ -24,6 +24,14 @@ typedef struct {
 	guint		*start_offsets;
 	guint		*end_offsets;
 
+	/* Member index built by tvb_composite_finalize() so that accessors
+	 * don't have to walk the GSList for every byte. Dissection reads
+	 * composites mostly sequentially, so the member that satisfied the
+	 * previous access is remembered and checked first. */
+	tvbuff_t	**member_tvbs;
+	guint		num_members;
+	guint		last_member;
+
 } tvb_comp_t;
 
 struct tvb_composite {
@@ -40,6 +48,7 @@ composite_free(tvbuff_t *tvb)
 
 	g_slist_free(composite->tvbs);
 
+	g_free(composite->member_tvbs);
 	g_free(composite->start_offsets);
 	g_free(composite->end_offsets);
 	g_free((gpointer)tvb->real_data);
@@ -51,36 +60,64 @@ composite_offset(const tvbuff_t *tvb _U_, const guint counter)
 	return counter;
 }
 
+/* Find the member containing abs_offset: the first member whose end
+ * offset is >= abs_offset. Returns num_members if abs_offset is past
+ * the last member (the zero-length access at tvb->length). The hit is
+ * cached, so sequential accesses cost one comparison; random accesses
+ * binary-search the end offsets. */
+static guint
+composite_find_member(tvb_comp_t *composite, guint abs_offset)
+{
+	guint lo, hi, mid;
+
+	mid = composite->last_member;
+	if (abs_offset >= composite->start_offsets[mid] &&
+	    abs_offset <= composite->end_offsets[mid]) {
+		return mid;
+	}
+
+	if (abs_offset > composite->end_offsets[composite->num_members - 1]) {
+		return composite->num_members;
+	}
+
+	lo = 0;
+	hi = composite->num_members - 1;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (abs_offset > composite->end_offsets[mid]) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	composite->last_member = lo;
+	return lo;
+}
+
 static const guint8*
 composite_get_ptr(tvbuff_t *tvb, guint abs_offset, guint abs_length)
 {
 	struct tvb_composite *composite_tvb = (struct tvb_composite *) tvb;
-	guint	    i, num_members;
+	guint	    i;
 	tvb_comp_t *composite;
-	tvbuff_t   *member_tvb = NULL;
+	tvbuff_t   *member_tvb;
 	guint	    member_offset;
-	GSList	   *slist;
 
 	/* DISSECTOR_ASSERT(tvb->ops == &tvb_composite_ops); */
 
 	/* Maybe the range specified by offset/length
 	 * is contiguous inside one of the member tvbuffs */
 	composite = &composite_tvb->composite;
-	num_members = g_slist_length(composite->tvbs);
 
-	for (i = 0; i < num_members; i++) {
-		if (abs_offset <= composite->end_offsets[i]) {
-			slist = g_slist_nth(composite->tvbs, i);
-			member_tvb = (tvbuff_t *)slist->data;
-			break;
-		}
-	}
+	i = composite_find_member(composite, abs_offset);
 
 	/* special case */
-	if (!member_tvb) {
+	if (i == composite->num_members) {
 		DISSECTOR_ASSERT(abs_offset == tvb->length && abs_length == 0);
 		return "";
 	}
+	member_tvb = composite->member_tvbs[i];
 
 	member_offset = abs_offset - composite->start_offsets[i];
 
@@ -92,6 +129,12 @@ composite_get_ptr(tvbuff_t *tvb, guint abs_offset, guint abs_length)
 		return tvb_get_ptr(member_tvb, member_offset, abs_length);
 	}
 	else {
+		/* The range crosses members, so contiguity has to be
+		 * materialized. Do it once for the whole composite; the
+		 * returned pointer has to stay valid for the lifetime of
+		 * the tvb anyway, and later crossing requests are then
+		 * free. Spans within a single member keep being served
+		 * from the member's data without copying. */
 		/* Use a temporary variable as tvb_memcpy is also checking tvb->real_data pointer */
 		void *real_data = g_malloc(tvb->length);
 		tvb_memcpy(tvb, real_data, 0, tvb->length);
@@ -108,32 +151,25 @@ composite_memcpy(tvbuff_t *tvb, void* _target, guint abs_offset, guint abs_lengt
 	struct tvb_composite *composite_tvb = (struct tvb_composite *) tvb;
 	guint8 *target = (guint8 *) _target;
 
-	guint	    i, num_members;
+	guint	    i;
 	tvb_comp_t *composite;
-	tvbuff_t   *member_tvb = NULL;
+	tvbuff_t   *member_tvb;
 	guint	    member_offset, member_length;
-	GSList	   *slist;
 
 	/* DISSECTOR_ASSERT(tvb->ops == &tvb_composite_ops); */
 
 	/* Maybe the range specified by offset/length
 	 * is contiguous inside one of the member tvbuffs */
 	composite   = &composite_tvb->composite;
-	num_members = g_slist_length(composite->tvbs);
 
-	for (i = 0; i < num_members; i++) {
-		if (abs_offset <= composite->end_offsets[i]) {
-			slist = g_slist_nth(composite->tvbs, i);
-			member_tvb = (tvbuff_t *)slist->data;
-			break;
-		}
-	}
+	i = composite_find_member(composite, abs_offset);
 
 	/* special case */
-	if (!member_tvb) {
+	if (i == composite->num_members) {
 		DISSECTOR_ASSERT(abs_offset == tvb->length && abs_length == 0);
 		return target;
 	}
+	member_tvb = composite->member_tvbs[i];
 
 	member_offset = abs_offset - composite->start_offsets[i];
 
@@ -201,6 +237,9 @@ tvb_new_composite(void)
 	composite->tvbs		 = NULL;
 	composite->start_offsets = NULL;
 	composite->end_offsets	 = NULL;
+	composite->member_tvbs	 = NULL;
+	composite->num_members	 = 0;
+	composite->last_member	 = 0;
 
 	return tvb;
 }
@@ -278,10 +317,13 @@ tvb_composite_finalize(tvbuff_t *tvb)
 
 	composite->start_offsets = g_new(guint, num_members);
 	composite->end_offsets = g_new(guint, num_members);
+	composite->member_tvbs = g_new(tvbuff_t *, num_members);
+	composite->num_members = num_members;
 
 	for (slist = composite->tvbs; slist != NULL; slist = slist->next) {
 		DISSECTOR_ASSERT((guint) i < num_members);
 		member_tvb = (tvbuff_t *)slist->data;
+		composite->member_tvbs[i] = member_tvb;
 		composite->start_offsets[i] = tvb->length;
 		tvb->length += member_tvb->length;
 		tvb->reported_length += member_tvb->reported_length;
@@ -0,0 +1,166 @@
+/* tvbuff_decompr_cache.c
+ * Cache of decompression results, shared by the tvb_uncompress*()
+ * implementations.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include <wsutil/glib-compat.h>
+
+#include "tvbuff_decompr_cache.h"
+
+/* Combined size of the compressed keys and decompressed data the cache
+ * may hold before the least recently used entries are evicted. */
+#define DECOMPR_CACHE_MAX_BYTES (32 * 1024 * 1024)
+
+typedef struct {
+	GBytes	*key;		/* borrowed from the table's key */
+	guint8	*data;		/* the decompressed bytes */
+	guint	 len;
+	gsize	 size;		/* what this entry counts against the budget */
+	GList	*lru_link;	/* our link in decompr_cache_lru */
+} decompr_cache_entry_t;
+
+/* GBytes(alg byte + compressed data) -> decompr_cache_entry_t.
+ * NULL when no dissection session is active. */
+static GHashTable *decompr_cache_table;
+
+/* Entries in use order; the head is the eviction candidate. */
+static GQueue decompr_cache_lru = G_QUEUE_INIT;
+
+static gsize decompr_cache_bytes;
+
+/* Keying by content rather than by position means retransmitted or
+ * duplicated payloads share one entry, and no frame/offset plumbing is
+ * needed at the tvb_uncompress*() call sites. */
+static GBytes *
+decompr_cache_key(decompr_cache_alg_t alg, const guint8 *compr, guint comprlen)
+{
+	guint8 *bytes;
+
+	bytes = (guint8 *)g_malloc((gsize)comprlen + 1);
+	bytes[0] = (guint8)alg;
+	memcpy(bytes + 1, compr, comprlen);
+	return g_bytes_new_take(bytes, (gsize)comprlen + 1);
+}
+
+static void
+decompr_cache_entry_free(gpointer data)
+{
+	decompr_cache_entry_t *entry = (decompr_cache_entry_t *)data;
+
+	decompr_cache_bytes -= entry->size;
+	g_queue_delete_link(&decompr_cache_lru, entry->lru_link);
+	g_free(entry->data);
+	g_free(entry);
+}
+
+tvbuff_t *
+decompr_cache_lookup(decompr_cache_alg_t alg, const guint8 *compr, guint comprlen)
+{
+	GBytes			*key;
+	decompr_cache_entry_t	*entry;
+	tvbuff_t		*tvb;
+
+	if (decompr_cache_table == NULL || compr == NULL || comprlen == 0)
+		return NULL;
+
+	key = decompr_cache_key(alg, compr, comprlen);
+	entry = (decompr_cache_entry_t *)g_hash_table_lookup(decompr_cache_table, key);
+	g_bytes_unref(key);
+	if (entry == NULL)
+		return NULL;
+
+	/* Used; move to the young end of the LRU order. */
+	g_queue_unlink(&decompr_cache_lru, entry->lru_link);
+	g_queue_push_tail_link(&decompr_cache_lru, entry->lru_link);
+
+	/* Hand out a copy, so the returned tvbuff can be freed on the
+	 * caller's schedule while the entry stays evictable. */
+	tvb = tvb_new_real_data((guint8 *)g_memdup2(entry->data, entry->len),
+	    entry->len, entry->len);
+	tvb_set_free_cb(tvb, g_free);
+	return tvb;
+}
+
+void
+decompr_cache_store(decompr_cache_alg_t alg, const guint8 *compr, guint comprlen,
+    const guint8 *uncompr, guint uncomprlen)
+{
+	GBytes			*key;
+	decompr_cache_entry_t	*entry;
+	gsize			 size;
+
+	if (decompr_cache_table == NULL || compr == NULL || comprlen == 0 ||
+	    uncompr == NULL || uncomprlen == 0)
+		return;
+
+	size = (gsize)comprlen + 1 + uncomprlen;
+	if (size > DECOMPR_CACHE_MAX_BYTES)
+		return;		/* would just flush everything else */
+
+	key = decompr_cache_key(alg, compr, comprlen);
+	if (g_hash_table_contains(decompr_cache_table, key)) {
+		g_bytes_unref(key);
+		return;
+	}
+
+	/* Make room, oldest first. */
+	while (decompr_cache_bytes + size > DECOMPR_CACHE_MAX_BYTES &&
+	    !g_queue_is_empty(&decompr_cache_lru)) {
+		entry = (decompr_cache_entry_t *)g_queue_peek_head(&decompr_cache_lru);
+		g_hash_table_remove(decompr_cache_table, entry->key);
+	}
+
+	entry = g_new(decompr_cache_entry_t, 1);
+	entry->key = key;
+	entry->data = (guint8 *)g_memdup2(uncompr, uncomprlen);
+	entry->len = uncomprlen;
+	entry->size = size;
+	g_queue_push_tail(&decompr_cache_lru, entry);
+	entry->lru_link = g_queue_peek_tail_link(&decompr_cache_lru);
+
+	g_hash_table_insert(decompr_cache_table, key, entry);
+	decompr_cache_bytes += size;
+}
+
+void
+decompr_cache_init(void)
+{
+	decompr_cache_cleanup();
+	decompr_cache_table = g_hash_table_new_full(g_bytes_hash, g_bytes_equal,
+	    (GDestroyNotify)g_bytes_unref, decompr_cache_entry_free);
+}
+
+void
+decompr_cache_cleanup(void)
+{
+	if (decompr_cache_table == NULL)
+		return;
+
+	/* Destroying the table frees every entry, which also empties the
+	 * LRU queue and returns the byte count to zero. */
+	g_hash_table_destroy(decompr_cache_table);
+	decompr_cache_table = NULL;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
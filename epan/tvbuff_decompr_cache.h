@@ -0,0 +1,68 @@
+/* tvbuff_decompr_cache.h
+ * Cache of decompression results, shared by the tvb_uncompress*()
+ * implementations.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __TVBUFF_DECOMPR_CACHE_H__
+#define __TVBUFF_DECOMPR_CACHE_H__
+
+#include <glib.h>
+#include <epan/tvbuff.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** @file
+ * The same payload is decompressed again on every redissection, click,
+ * and filter pass; for captures full of compressed HTTP bodies or SMB3
+ * messages that dominates the cost of selecting a packet.  This cache
+ * remembers decompression results for the duration of a dissection
+ * session, keyed by the algorithm and the compressed bytes themselves,
+ * with least-recently-used eviction beyond a fixed byte budget.  It is
+ * filled and consulted inside the tvb_uncompress*() routines, so
+ * dissectors get hits transparently.
+ */
+
+typedef enum {
+	DECOMPR_CACHE_ZLIB,
+	DECOMPR_CACHE_BROTLI,
+	DECOMPR_CACHE_LZ77,
+	DECOMPR_CACHE_LZ77HUFF,
+	DECOMPR_CACHE_LZNT1
+} decompr_cache_alg_t;
+
+/**
+ * If the result of decompressing comprlen bytes at compr with alg is
+ * cached, return a fresh tvbuff over a copy of it (with a free callback
+ * already set), else return NULL.
+ */
+WS_DLL_PUBLIC tvbuff_t *decompr_cache_lookup(decompr_cache_alg_t alg,
+    const guint8 *compr, guint comprlen);
+
+/**
+ * Remember that decompressing comprlen bytes at compr with alg yielded
+ * the uncomprlen bytes at uncompr.  The cache keeps its own copies.
+ */
+WS_DLL_PUBLIC void decompr_cache_store(decompr_cache_alg_t alg,
+    const guint8 *compr, guint comprlen,
+    const guint8 *uncompr, guint uncomprlen);
+
+/* Start a new dissection session with an empty cache; called by
+ * init_dissection(). */
+extern void decompr_cache_init(void);
+
+/* Discard the cache; called by cleanup_dissection(). */
+extern void decompr_cache_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TVBUFF_DECOMPR_CACHE_H__ */
@@ -12,6 +12,7 @@
 #include <glib.h>
 #include <epan/exceptions.h>
 #include <epan/tvbuff.h>
+#include <epan/tvbuff_decompr_cache.h>
 #include <epan/wmem_scopes.h>
 
 #define MAX_INPUT_SIZE (16*1024*1024) /* 16MB */
@@ -101,6 +102,19 @@ tvb_uncompress_lz77(tvbuff_t *tvb, const int offset, int in_size)
 	wmem_allocator_t *pool;
 	wmem_array_t *obuf;
 	tvbuff_t *out;
+	guint8 *compr = NULL;
+
+	/* Were these bytes decompressed before, e.g. on an earlier pass?
+	   Truncated input falls through to do_uncompress(), which copes
+	   with it. */
+	if (tvb && in_size > 0 && tvb_bytes_exist(tvb, offset, in_size)) {
+		compr = (guint8 *)tvb_memdup(NULL, tvb, offset, in_size);
+		out = decompr_cache_lookup(DECOMPR_CACHE_LZ77, compr, in_size);
+		if (out) {
+			wmem_free(NULL, compr);
+			return out;
+		}
+	}
 
 	pool = wmem_allocator_new(WMEM_ALLOCATOR_SIMPLE);
 	obuf = wmem_array_sized_new(pool, 1, in_size*2);
@@ -124,10 +138,12 @@ tvb_uncompress_lz77(tvbuff_t *tvb, const int offset, int in_size)
 		memcpy(p, wmem_array_get_raw(obuf), size);
 		out = tvb_new_real_data(p, size, size);
 		tvb_set_free_cb(out, g_free);
+		decompr_cache_store(DECOMPR_CACHE_LZ77, compr, in_size, p, size);
 	} else {
 		out = NULL;
 	}
 
+	wmem_free(NULL, compr);
 	wmem_destroy_allocator(pool);
 
 	return out;
@@ -21,6 +21,7 @@
 #include <stdlib.h> /* qsort */
 #include <epan/exceptions.h>
 #include <epan/tvbuff.h>
+#include <epan/tvbuff_decompr_cache.h>
 #include <epan/wmem_scopes.h>
 
 #define MAX_INPUT_SIZE (16*1024*1024) /* 16MB */
@@ -364,6 +365,19 @@ tvb_uncompress_lz77huff(tvbuff_t *tvb,
 			      .offset = offset,
 			      .size = input_size
 	};
+	guint8 *compr = NULL;
+
+	/* Were these bytes decompressed before, e.g. on an earlier pass?
+	   Truncated input falls through to do_uncompress(), which copes
+	   with it. */
+	if (tvb && input_size > 0 && tvb_bytes_exist(tvb, offset, input_size)) {
+		compr = (guint8 *)tvb_memdup(NULL, tvb, offset, input_size);
+		out = decompr_cache_lookup(DECOMPR_CACHE_LZ77HUFF, compr, input_size);
+		if (out) {
+			wmem_free(NULL, compr);
+			return out;
+		}
+	}
 
 	pool = wmem_allocator_new(WMEM_ALLOCATOR_SIMPLE);
 	obuf = wmem_array_sized_new(pool, 1, input_size*2);
@@ -387,10 +401,12 @@ tvb_uncompress_lz77huff(tvbuff_t *tvb,
 		memcpy(p, wmem_array_get_raw(obuf), size);
 		out = tvb_new_real_data(p, size, size);
 		tvb_set_free_cb(out, g_free);
+		decompr_cache_store(DECOMPR_CACHE_LZ77HUFF, compr, input_size, p, size);
 	} else {
 		out = NULL;
 	}
 
+	wmem_free(NULL, compr);
 	wmem_destroy_allocator(pool);
 
 	return out;
@@ -23,6 +23,7 @@
 #endif
 
 #include "tvbuff.h"
+#include "tvbuff_decompr_cache.h"
 #include <wsutil/wslog.h>
 
 #ifdef HAVE_ZLIB
@@ -60,6 +61,13 @@ tvb_uncompress(tvbuff_t *tvb, const int offset, int comprlen)
 		return NULL;
 	}
 
+	/* Were these bytes inflated before, e.g. on an earlier pass? */
+	uncompr_tvb = decompr_cache_lookup(DECOMPR_CACHE_ZLIB, compr, comprlen);
+	if (uncompr_tvb != NULL) {
+		wmem_free(NULL, compr);
+		return uncompr_tvb;
+	}
+
 	/*
 	 * Assume that the uncompressed data is at least twice as big as
 	 * the compressed size.
@@ -302,6 +310,8 @@ tvb_uncompress(tvbuff_t *tvb, const int offset, int comprlen)
 	if (uncompr != NULL) {
 		uncompr_tvb =  tvb_new_real_data(uncompr, bytes_out, bytes_out);
 		tvb_set_free_cb(uncompr_tvb, g_free);
+		decompr_cache_store(DECOMPR_CACHE_ZLIB, compr, comprlen,
+		    uncompr, bytes_out);
 	}
 	wmem_free(NULL, compr);
 	return uncompr_tvb;
@@ -56,6 +56,8 @@ struct epan_uat {
     GArray* user_data;  /**< An array of valid records that will be exposed to the dissector. */
     GArray* raw_data;   /**< An array of records containing possibly invalid data. For internal use only. */
     GArray* valid_data; /**< An array of booleans describing whether the records in 'raw_data' are valid or not. */
+    uat_field_t* key_field; /**< Optional lookup key field; see uat_set_key_field(). */
+    GHashTable* key_index;  /**< Key string -> GPtrArray of indices into 'user_data'. */
     gboolean changed;
     uat_rep_t* rep;
     uat_rep_free_cb_t free_rep;
@@ -93,6 +93,8 @@ uat_t* uat_new(const char* name,
     uat->from_global = FALSE;
     uat->rep = NULL;
     uat->free_rep = NULL;
+    uat->key_field = NULL;
+    uat->key_index = NULL;
     uat->help = g_strdup(help);
     uat->flags = flags;
 
@@ -114,6 +116,86 @@ uat_t* uat_new(const char* name,
     return uat;
 }
 
+/* Add the record at the given index in 'user_data' to the key index. */
+static void uat_index_add_record(uat_t* uat, guint idx) {
+    char* key;
+    GPtrArray* entries;
+
+    key = uat_fld_tostr(UAT_USER_INDEX_PTR(uat, idx), uat->key_field);
+    entries = (GPtrArray*)g_hash_table_lookup(uat->key_index, key);
+    if (entries) {
+        g_free(key);
+    } else {
+        entries = g_ptr_array_new();
+        g_hash_table_insert(uat->key_index, key, entries);
+    }
+    /* Indices rather than pointers: 'user_data' may be reallocated as
+       it grows, but an index stays good until the table is rebuilt,
+       and rebuilds re-run this. */
+    g_ptr_array_add(entries, GUINT_TO_POINTER(idx));
+}
+
+/* Rebuild the key index from scratch to match 'user_data'. */
+static void uat_index_rebuild(uat_t* uat) {
+    guint i;
+
+    if (!uat->key_field)
+        return;
+
+    g_hash_table_remove_all(uat->key_index);
+
+    for (i = 0; i < uat->user_data->len; i++) {
+        uat_index_add_record(uat, i);
+    }
+}
+
+void uat_set_key_field(uat_t* uat, const char* field_name) {
+    guint i;
+
+    for (i = 0; i < uat->ncols; i++) {
+        if (strcmp(uat->fields[i].name, field_name) == 0) {
+            uat->key_field = &uat->fields[i];
+            if (!uat->key_index) {
+                uat->key_index = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                       g_free, (GDestroyNotify)g_ptr_array_unref);
+            }
+            uat_index_rebuild(uat);
+            return;
+        }
+    }
+
+    /* The field name doesn't belong to this table. */
+    ws_assert_not_reached();
+}
+
+guint uat_lookup_count(uat_t* uat, const char* key) {
+    GPtrArray* entries;
+
+    if (!uat->key_field || !key)
+        return 0;
+
+    entries = (GPtrArray*)g_hash_table_lookup(uat->key_index, key);
+
+    return entries ? entries->len : 0;
+}
+
+void* uat_lookup_nth(uat_t* uat, const char* key, guint n) {
+    GPtrArray* entries;
+
+    if (!uat->key_field || !key)
+        return NULL;
+
+    entries = (GPtrArray*)g_hash_table_lookup(uat->key_index, key);
+    if (!entries || n >= entries->len)
+        return NULL;
+
+    return UAT_USER_INDEX_PTR(uat, GPOINTER_TO_UINT(g_ptr_array_index(entries, n)));
+}
+
+void* uat_lookup(uat_t* uat, const char* key) {
+    return uat_lookup_nth(uat, key, 0);
+}
+
 void* uat_add_record(uat_t* uat, const void* data, gboolean valid_rec) {
     void* rec;
     gboolean* valid;
@@ -134,6 +216,10 @@ void* uat_add_record(uat_t* uat, const void* data, gboolean valid_rec) {
 
         valid = &g_array_index(uat->valid_data, gboolean, uat->valid_data->len-1);
         *valid = valid_rec;
+
+        if (uat->key_field) {
+            uat_index_add_record(uat, uat->user_data->len - 1);
+        }
     } else {
         rec = NULL;
     }
@@ -413,6 +499,7 @@ gboolean uat_save(uat_t* uat, char** error) {
         }
     }
 
+    uat_index_rebuild(uat);
 
     fprintf(fp,"# This file is automatically generated, DO NOT MODIFY.\n");
 
@@ -470,6 +557,10 @@ void uat_clear(uat_t* uat) {
     g_array_set_size(uat->user_data,0);
     g_array_set_size(uat->valid_data,0);
 
+    if (uat->key_index) {
+        g_hash_table_remove_all(uat->key_index);
+    }
+
     *((uat)->user_ptr) = NULL;
     *((uat)->nrows_p) = 0;
 
@@ -505,6 +596,8 @@ void uat_cleanup(void) {
         g_array_free(uat->user_data, TRUE);
         g_array_free(uat->raw_data, TRUE);
         g_array_free(uat->valid_data, TRUE);
+        if (uat->key_index)
+            g_hash_table_destroy(uat->key_index);
         for (j = 0; uat->fields[j].title; j++)
             g_free(uat->fields[j].priv);
         g_free(uat);
@@ -331,6 +331,56 @@ uat_t *uat_find(gchar *name);
 WS_DLL_PUBLIC
 uat_t* uat_get_table_by_name(const char* name);
 
+/** Declare one of the uat's fields as a lookup key.
+ *
+ * The uat core then maintains a hash index from that field's string
+ * representation to the valid records carrying it, kept up to date as
+ * records are added, edited, removed or reloaded.  Dissectors that
+ * consult the table at dissection time can then use uat_lookup() or
+ * uat_lookup_nth() instead of scanning the exposed record array
+ * linearly on every lookup.
+ *
+ * @param uat_in Pointer to a uat. Must not be NULL.
+ * @param field_name The name of one of the uat's fields. Must exist.
+ */
+WS_DLL_PUBLIC
+void uat_set_key_field(uat_t *uat_in, const char *field_name);
+
+/** Count the valid records whose key field matches a string.
+ *
+ * @param uat_in Pointer to a uat. Must not be NULL.
+ * @param key The key value to look up, in the same form the key field
+ * is written to the uat's file.
+ *
+ * @return The number of matching records; 0 if there is no match or no
+ * key field was declared.
+ */
+WS_DLL_PUBLIC
+guint uat_lookup_count(uat_t *uat_in, const char *key);
+
+/** Fetch the nth valid record whose key field matches a string.
+ *
+ * @param uat_in Pointer to a uat. Must not be NULL.
+ * @param key The key value to look up.
+ * @param n The 0-based position among the matching records, in record
+ * order.
+ *
+ * @return A pointer to the record, owned by the uat and valid until the
+ * table next changes, or NULL if there are fewer than n+1 matches.
+ */
+WS_DLL_PUBLIC
+void* uat_lookup_nth(uat_t *uat_in, const char *key, guint n);
+
+/** Fetch the first valid record whose key field matches a string.
+ *
+ * @param uat_in Pointer to a uat. Must not be NULL.
+ * @param key The key value to look up.
+ *
+ * @return A pointer to the record, or NULL if there is no match.
+ */
+WS_DLL_PUBLIC
+void* uat_lookup(uat_t *uat_in, const char *key);
+
 /*
  * Some common uat_fld_chk_cbs
  */
@@ -26,6 +26,7 @@
 #include <wsutil/ws_assert.h>
 #include <ui/version_info.h>
 
+#include <wiretap/chain.h>
 #include <wiretap/merge.h>
 
 #include <epan/exceptions.h>
@@ -46,14 +47,20 @@
 #include <epan/secrets.h>
 
 #include "cfile.h"
+#include "comment_journal.h"
 #include "file.h"
 #include "fileset.h"
+#include "frame_index.h"
 #include "frame_tvbuff.h"
+#include <epan/frame_class.h>
+#include "session_journal.h"
 
 #include "ui/alert_box.h"
 #include "ui/simple_dialog.h"
 #include "ui/main_statusbar.h"
 #include "ui/progress_dlg.h"
+#include "ui/proto_hier_stats.h"
+#include "ui/summary.h"
 #include "ui/urls.h"
 #include "ui/ws_ui_util.h"
 
@@ -74,7 +81,8 @@
 #endif
 
 static gboolean read_record(capture_file *cf, wtap_rec *rec, Buffer *buf,
-    dfilter_t *dfcode, epan_dissect_t *edt, column_info *cinfo, gint64 offset);
+    dfilter_t *dfcode, epan_dissect_t *edt, column_info *cinfo, gint64 offset,
+    epan_dissect_t *rf_edt);
 
 static void rescan_packets(capture_file *cf, const char *action, const char *action_item, gboolean redissect);
 
@@ -252,22 +260,19 @@ ws_epan_new(capture_file *cf)
     ws_get_frame_ts,
     cap_file_provider_get_interface_name,
     cap_file_provider_get_interface_description,
-    cap_file_provider_get_modified_block
+    cap_file_provider_get_modified_block,
+    cap_file_provider_get_shift_offset
   };
 
   return epan_new(&cf->provider, &funcs);
 }
 
-cf_status_t
-cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_tempfile, int *err)
+/* Common to cf_open() and cf_open_file_set(): fill in the capture_file
+   for a freshly opened wtap handle and get ready for the sequential read. */
+static void
+cf_open_common(capture_file *cf, wtap *wth, const char *fname,
+               unsigned int type, gboolean is_tempfile)
 {
-  wtap  *wth;
-  gchar *err_info;
-
-  wth = wtap_open_offline(fname, type, err, &err_info, TRUE);
-  if (wth == NULL)
-    goto fail;
-
   /* The open succeeded.  Close whatever capture file we had open,
      and fill in the information for this file. */
   cf_close(cf);
@@ -320,6 +325,12 @@ cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_temp
   cf->provider.prev_cap = NULL;
   cf->cum_bytes = 0;
 
+  /* The sequential read that follows (cf_read, or the tail reads of a
+     live capture) maintains the protocol hierarchy counters and the
+     capture file summary aggregates. */
+  ph_stats_live_reset(cf);
+  summary_stats_live_reset(cf);
+
   /* Create new epan session for dissection.
    * (The old one was freed in cf_close().)
    */
@@ -331,12 +342,43 @@ cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_temp
   wtap_set_cb_new_ipv4(cf->provider.wth, add_ipv4_name);
   wtap_set_cb_new_ipv6(cf->provider.wth, (wtap_new_ipv6_callback_t) add_ipv6_name);
   wtap_set_cb_new_secrets(cf->provider.wth, secrets_wtap_callback);
+}
 
+cf_status_t
+cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_tempfile, int *err)
+{
+  wtap  *wth;
+  gchar *err_info;
+
+  wth = wtap_open_offline(fname, type, err, &err_info, TRUE);
+  if (wth == NULL) {
+    cfile_open_failure_alert_box(fname, *err, err_info);
+    return CF_ERROR;
+  }
+
+  cf_open_common(cf, wth, fname, type, is_tempfile);
   return CF_OK;
+}
 
-fail:
-  cfile_open_failure_alert_box(fname, *err, err_info);
-  return CF_ERROR;
+cf_status_t
+cf_open_file_set(capture_file *cf, const char *const *fnames, guint n_fnames,
+                 int *err)
+{
+  wtap  *wth;
+  gchar *err_info;
+  guint  err_fileno;
+
+  wth = wtap_chain_open_offline(fnames, n_fnames, err, &err_info,
+                                &err_fileno);
+  if (wth == NULL) {
+    cfile_open_failure_alert_box(fnames[err_fileno], *err, err_info);
+    return CF_ERROR;
+  }
+
+  /* The virtual capture takes the name of its first member; that's the
+     file the title bar and the file set dialog show as loaded. */
+  cf_open_common(cf, wth, fnames[0], WTAP_TYPE_AUTO, FALSE);
+  return CF_OK;
 }
 
 /*
@@ -372,6 +414,10 @@ cf_close(capture_file *cf)
   /* close things, if not already closed before */
   color_filters_cleanup();
 
+  /* Unless this close is part of a reload of the same file, the learned
+     heuristic bindings are of no use to whatever is opened next. */
+  heur_dissector_journal_clear();
+
   if (cf->provider.wth) {
     wtap_close(cf->provider.wth);
     cf->provider.wth = NULL;
@@ -407,10 +453,22 @@ cf_close(capture_file *cf)
     free_frame_data_sequence(cf->provider.frames);
     cf->provider.frames = NULL;
   }
+  cf->frames_preloaded = FALSE;
+  if (cf->dfilter_result_cache != NULL) {
+    g_hash_table_destroy(cf->dfilter_result_cache);
+    cf->dfilter_result_cache = NULL;
+  }
+  frame_index_postings_free(cf);
+  ph_stats_live_invalidate(cf);
+  summary_stats_live_invalidate(cf);
   if (cf->provider.frames_modified_blocks) {
     g_tree_destroy(cf->provider.frames_modified_blocks);
     cf->provider.frames_modified_blocks = NULL;
   }
+  if (cf->provider.frames_shift_offsets) {
+    g_tree_destroy(cf->provider.frames_shift_offsets);
+    cf->provider.frames_shift_offsets = NULL;
+  }
   cf_unselect_packet(cf);   /* nothing to select */
   cf->first_displayed = 0;
   cf->last_displayed = 0;
@@ -491,6 +549,112 @@ calc_progbar_val(capture_file *cf, gint64 size, gint64 file_pos, gchar *status_s
   return progbar_val;
 }
 
+/*
+ * Read-ahead support for the first sequential pass.
+ *
+ * A dedicated reader thread pulls records out of wiretap (which includes
+ * any decompression done by the file wrappers) into a small pool of
+ * record slots, while the dissection of earlier records proceeds on the
+ * calling thread.  Dissection itself stays strictly in file order on one
+ * thread, so dissectors with cross-packet state (conversations,
+ * reassembly, ...) see exactly the same sequence as before; we only
+ * overlap the I/O and decompression with it.
+ *
+ * The slots cycle between two queues: "free" slots waiting to be filled
+ * by the reader and "full" slots waiting to be dissected.  The pool is
+ * bounded, so the reader can never run arbitrarily far ahead of the
+ * dissector.  End of file, a read error, or a stop request is signalled
+ * by a slot with ok set to FALSE; the reader exits after pushing it.
+ *
+ * The loop below pumps the event loop, so the user can select an
+ * already-visited frame while we're still loading, which seek-reads on
+ * the random handle from the main thread.  The sequential and random
+ * handles share mutable state; wiretap serializes access to it
+ * internally (see wtap_read()), so that's safe.
+ */
+#define CF_READ_AHEAD_SLOTS 16
+
+typedef struct {
+  wtap_rec  rec;
+  Buffer    buf;
+  gint64    data_offset;
+  gint64    file_pos;      /* wtap_read_so_far() after this record */
+  gboolean  ok;            /* FALSE on EOF, read error or stop request */
+  int       err;
+  gchar    *err_info;
+} cf_read_ahead_slot_t;
+
+typedef struct {
+  wtap                 *wth;
+  GAsyncQueue          *free_q;
+  GAsyncQueue          *full_q;
+  gint                  stop;  /* accessed with g_atomic_int_*() */
+  cf_read_ahead_slot_t  slots[CF_READ_AHEAD_SLOTS];
+} cf_read_ahead_t;
+
+static gpointer
+cf_read_ahead_thread(gpointer arg)
+{
+  cf_read_ahead_t      *ra = (cf_read_ahead_t *)arg;
+  cf_read_ahead_slot_t *slot;
+
+  for (;;) {
+    /* Time out now and then so that a stop request can't leave us
+       parked on an empty free queue forever. */
+    slot = (cf_read_ahead_slot_t *)g_async_queue_timeout_pop(ra->free_q,
+                                                             100000);
+    if (slot == NULL) {
+      if (g_atomic_int_get(&ra->stop))
+        return NULL;
+      continue;
+    }
+    if (g_atomic_int_get(&ra->stop))
+      return NULL;
+
+    slot->err = 0;
+    slot->err_info = NULL;
+    slot->ok = wtap_read(ra->wth, &slot->rec, &slot->buf, &slot->err,
+                         &slot->err_info, &slot->data_offset);
+    slot->file_pos = wtap_read_so_far(ra->wth);
+    g_async_queue_push(ra->full_q, slot);
+    if (!slot->ok) {
+      /* EOF or a hard read error; we're done. */
+      return NULL;
+    }
+  }
+}
+
+static void
+cf_read_ahead_start(cf_read_ahead_t *ra, wtap *wth)
+{
+  guint i;
+
+  ra->wth = wth;
+  ra->free_q = g_async_queue_new();
+  ra->full_q = g_async_queue_new();
+  ra->stop = 0;
+  for (i = 0; i < CF_READ_AHEAD_SLOTS; i++) {
+    wtap_rec_init(&ra->slots[i].rec);
+    ws_buffer_init(&ra->slots[i].buf, 1514);
+    g_async_queue_push(ra->free_q, &ra->slots[i]);
+  }
+}
+
+static void
+cf_read_ahead_finish(cf_read_ahead_t *ra, GThread *thread)
+{
+  guint i;
+
+  g_atomic_int_set(&ra->stop, 1);
+  g_thread_join(thread);
+  for (i = 0; i < CF_READ_AHEAD_SLOTS; i++) {
+    wtap_rec_cleanup(&ra->slots[i].rec);
+    ws_buffer_free(&ra->slots[i].buf);
+  }
+  g_async_queue_unref(ra->free_q);
+  g_async_queue_unref(ra->full_q);
+}
+
 cf_read_status_t
 cf_read(capture_file *cf, gboolean reloading)
 {
@@ -503,8 +667,9 @@ cf_read(capture_file *cf, gboolean reloading)
   gint64               size;
   gint64               start_time;
   epan_dissect_t       edt;
-  wtap_rec             rec;
-  Buffer               buf;
+  epan_dissect_t       rf_edt;
+  cf_read_ahead_t      ra;
+  GThread             *ra_thread;
   dfilter_t           *dfcode;
   column_info         *cinfo;
   volatile gboolean    create_proto_tree;
@@ -524,6 +689,12 @@ cf_read(capture_file *cf, gboolean reloading)
   }
   cf->read_lock = TRUE;
 
+  /* If this is the initial read of the file and a valid sidecar index
+     exists, preload the frame table from it; read_record will then reuse
+     the stored frame metadata instead of rebuilding it per record. */
+  if (cf->count == 0 && !cf->frames_preloaded)
+    frame_index_load(cf);
+
   /* Compile the current display filter.
    * We assume this will not fail since cf->dfilter is only set in
    * cf_filter IFF the filter was valid.
@@ -542,6 +713,8 @@ cf_read(capture_file *cf, gboolean reloading)
    *
    *    one of the tap listeners is going to apply a filter;
    *
+   *    one of the tap listeners declared fields it needs primed;
+   *
    *    one of the tap listeners requires a protocol tree;
    *
    *    a postdissector wants field values or protocols on
@@ -549,8 +722,22 @@ cf_read(capture_file *cf, gboolean reloading)
    */
   create_proto_tree =
     (dfcode != NULL || have_filtering_tap_listeners() ||
+     have_field_tap_listeners() ||
      (tap_flags & TL_REQUIRES_PROTO_TREE) || postdissectors_want_hfids());
 
+  /* If the user asked for a field postings index and this first pass will
+     visit every record, collect the postings as we dissect; that requires
+     a protocol tree even if nothing else does. */
+  if (frame_index_postings_wanted() && cf->count == 0 &&
+      !cf->frames_preloaded && !cf->is_tempfile && cf->rfcode == NULL) {
+    create_proto_tree = TRUE;
+    frame_index_postings_begin(cf);
+  }
+
+  /* Re-apply any "Decode As" bindings journaled for this capture in an
+     earlier session, before the first pass dissects anything. */
+  session_journal_replay_decode_as(cf);
+
   reset_tap_listeners();
 
   name_ptr = g_filename_display_basename(cf->filename);
@@ -564,7 +751,10 @@ cf_read(capture_file *cf, gboolean reloading)
      XXX - do we know this at open time? */
   cf->compression_type = wtap_get_compression_type(cf->provider.wth);
 
-  /* The packet list window will be empty until the file is completly loaded */
+  /* Detach the packet list's model while the first batch of frames is
+     read; the read loop below re-attaches it at the first progress
+     update, so a long load becomes visible and clickable almost
+     immediately. */
   packet_list_freeze();
 
   cf->stop_flag = FALSE;
@@ -572,6 +762,11 @@ cf_read(capture_file *cf, gboolean reloading)
 
   epan_dissect_init(&edt, cf->epan, create_proto_tree, FALSE);
 
+  /* If there's a read filter, create its dissection context once for
+     the whole pass; read_record resets it between records. */
+  if (cf->rfcode)
+    epan_dissect_init(&rf_edt, cf->epan, TRUE, FALSE);
+
   /* If any tap listeners require the columns, construct them. */
   cinfo = (tap_flags & TL_REQUIRES_COLUMNS) ? &cf->cinfo : NULL;
 
@@ -580,20 +775,30 @@ cf_read(capture_file *cf, gboolean reloading)
 
   g_timer_start(prog_timer);
 
-  wtap_rec_init(&rec);
-  ws_buffer_init(&buf, 1514);
+  /* Overlap record reading and decompression with the dissection of
+     earlier records; see the comment above cf_read_ahead_thread(). */
+  cf_read_ahead_start(&ra, cf->provider.wth);
+  ra_thread = g_thread_new("cf_read ahead", cf_read_ahead_thread, &ra);
 
   TRY {
     guint32 count             = 0;
+    gboolean list_thawed      = FALSE;
 
     gint64  file_pos;
-    gint64  data_offset;
 
     float   progbar_val;
     gchar   status_str[100];
 
-    while ((wtap_read(cf->provider.wth, &rec, &buf, &err, &err_info,
-            &data_offset))) {
+    cf_read_ahead_slot_t *slot;
+
+    for (;;) {
+      slot = (cf_read_ahead_slot_t *)g_async_queue_pop(ra.full_q);
+      if (!slot->ok) {
+        /* EOF or a read error; pick up the error for the code below. */
+        err = slot->err;
+        err_info = slot->err_info;
+        break;
+      }
       if (size >= 0) {
         if (cf->count == max_records) {
             /*
@@ -604,7 +809,7 @@ cf_read(capture_file *cf, gboolean reloading)
             break;
         }
         count++;
-        file_pos = wtap_read_so_far(cf->provider.wth);
+        file_pos = slot->file_pos;
 
         /* Create the progress bar if necessary. */
         if (progress_is_slow(progbar, prog_timer, size, file_pos)) {
@@ -620,12 +825,31 @@ cf_read(capture_file *cf, gboolean reloading)
          * might take a while depending on the platform and display. Reset
          * our timer *after* painting.
          */
-        if (progbar && g_timer_elapsed(prog_timer, NULL) > PROGBAR_UPDATE_INTERVAL) {
-          progbar_val = calc_progbar_val(cf, size, file_pos, status_str, sizeof(status_str));
-          /* update the packet bar content on the first run or frequently on very large files */
-          update_progress_dlg(progbar, progbar_val, status_str);
-          compute_elapsed(cf, start_time);
-          packets_bar_update();
+        if (g_timer_elapsed(prog_timer, NULL) > PROGBAR_UPDATE_INTERVAL) {
+          if (!list_thawed) {
+            /* Re-attach the packet list's model: the frames loaded so
+               far become visible and selectable right away, the same
+               way a live capture fills in, while the rest of the file
+               keeps loading underneath.  Later frames are appended
+               through the same batched path the live capture uses. */
+            packet_list_thaw();
+            list_thawed = TRUE;
+          }
+          if (progbar) {
+            progbar_val = calc_progbar_val(cf, size, file_pos, status_str, sizeof(status_str));
+            /* update the packet bar content on the first run or frequently on very large files */
+            update_progress_dlg(progbar, progbar_val, status_str);
+            compute_elapsed(cf, start_time);
+            packets_bar_update();
+          } else {
+            /* No progress dialog (yet), so nothing above pumps the event
+             * loop for us.  Service pending UI events here anyway, so the
+             * application stays responsive instead of freezing between
+             * progress updates.  Like update_progress_dlg, this can let
+             * the user queue a redissection; cf->read_lock and
+             * cf->redissection_queued cover that. */
+            main_window_update();
+          }
           g_timer_start(prog_timer);
         }
         /*
@@ -652,7 +876,9 @@ cf_read(capture_file *cf, gboolean reloading)
            hours even on fast machines) just to see that it was the wrong file. */
         break;
       }
-      read_record(cf, &rec, &buf, dfcode, &edt, cinfo, data_offset);
+      read_record(cf, &slot->rec, &slot->buf, dfcode, &edt, cinfo,
+                  slot->data_offset, &rf_edt);
+      g_async_queue_push(ra.free_q, slot);
     }
   }
   CATCH(OutOfMemoryError) {
@@ -684,8 +910,9 @@ cf_read(capture_file *cf, gboolean reloading)
   dfilter_free(dfcode);
 
   epan_dissect_cleanup(&edt);
-  wtap_rec_cleanup(&rec);
-  ws_buffer_free(&buf);
+  if (cf->rfcode)
+    epan_dissect_cleanup(&rf_edt);
+  cf_read_ahead_finish(&ra, ra_thread);
 
   /* Close the sequential I/O side, to free up memory it requires. */
   wtap_sequential_close(cf->provider.wth);
@@ -722,6 +949,14 @@ cf_read(capture_file *cf, gboolean reloading)
   ws_assert(cf->read_lock);
   cf->read_lock = FALSE;
 
+  /* Only a completed pass yields exhaustive postings; partial ones must
+     be neither saved nor queried. */
+  if (cf->postings_collecting) {
+    cf->postings_collecting = FALSE;
+    if (cf->stop_flag || too_many_records || err != 0 || is_read_aborted)
+      frame_index_postings_free(cf);
+  }
+
   if (is_read_aborted) {
     /*
      * Well, the user decided to exit Wireshark while reading this *offline*
@@ -739,6 +974,25 @@ cf_read(capture_file *cf, gboolean reloading)
     rescan_packets(cf, NULL, NULL, redissect);
   }
 
+  /* If the user opted into the sidecar index and the read completed
+     cleanly and didn't come from an index, write one so the next open
+     of this file can skip rebuilding the frame table. */
+  if (!cf->stop_flag && !too_many_records && err == 0 &&
+      !cf->frames_preloaded)
+    frame_index_save(cf);
+
+  /* Replay any packet-comment journal left over from an earlier session.
+     The comments come back as modified blocks, leaving the capture marked
+     as having unsaved changes until a full save merges them into the
+     file itself. */
+  if (!cf->stop_flag && !too_many_records && err == 0)
+    comment_journal_replay(cf);
+
+  /* Restore journaled time references now that the frame table is fully
+     populated. */
+  if (!cf->stop_flag && !too_many_records && err == 0)
+    session_journal_replay_timerefs(cf);
+
   if (cf->stop_flag) {
     simple_message_box(ESD_TYPE_WARN, NULL,
                   "The remaining packets in the file were discarded.\n"
@@ -780,6 +1034,7 @@ cf_continue_tail(capture_file *cf, volatile int to_read, wtap_rec *rec,
   volatile int      newly_displayed_packets = 0;
   dfilter_t        *dfcode;
   epan_dissect_t    edt;
+  epan_dissect_t    rf_edt;
   gboolean          create_proto_tree;
   guint             tap_flags;
   gboolean          compiled _U_;
@@ -802,6 +1057,8 @@ cf_continue_tail(capture_file *cf, volatile int to_read, wtap_rec *rec,
    *
    *    one of the tap listeners is going to apply a filter;
    *
+   *    one of the tap listeners declared fields it needs primed;
+   *
    *    one of the tap listeners requires a protocol tree;
    *
    *    a postdissector wants field values or protocols on
@@ -809,6 +1066,7 @@ cf_continue_tail(capture_file *cf, volatile int to_read, wtap_rec *rec,
    */
   create_proto_tree =
     (dfcode != NULL || have_filtering_tap_listeners() ||
+     have_field_tap_listeners() ||
      (tap_flags & TL_REQUIRES_PROTO_TREE) || postdissectors_want_hfids());
 
   *err = 0;
@@ -818,6 +1076,11 @@ cf_continue_tail(capture_file *cf, volatile int to_read, wtap_rec *rec,
 
   epan_dissect_init(&edt, cf->epan, create_proto_tree, FALSE);
 
+  /* If there's a read filter, create its dissection context once for
+     this batch; read_record resets it between records. */
+  if (cf->rfcode)
+    epan_dissect_init(&rf_edt, cf->epan, TRUE, FALSE);
+
   TRY {
     gint64 data_offset = 0;
     column_info *cinfo;
@@ -837,7 +1100,8 @@ cf_continue_tail(capture_file *cf, volatile int to_read, wtap_rec *rec,
            aren't any packets left to read) exit. */
         break;
       }
-      if (read_record(cf, rec, buf, dfcode, &edt, cinfo, data_offset)) {
+      if (read_record(cf, rec, buf, dfcode, &edt, cinfo, data_offset,
+                      &rf_edt)) {
         newly_displayed_packets++;
       }
       to_read--;
@@ -866,6 +1130,8 @@ cf_continue_tail(capture_file *cf, volatile int to_read, wtap_rec *rec,
   dfilter_free(dfcode);
 
   epan_dissect_cleanup(&edt);
+  if (cf->rfcode)
+    epan_dissect_cleanup(&rf_edt);
 
   /* Don't freeze/thaw the list when doing live capture */
   /*packet_list_thaw();*/
@@ -916,6 +1182,7 @@ cf_finish_tail(capture_file *cf, wtap_rec *rec, Buffer *buf, int *err)
   dfilter_t *dfcode;
   column_info *cinfo;
   epan_dissect_t edt;
+  epan_dissect_t rf_edt;
   gboolean   create_proto_tree;
   guint      tap_flags;
   gboolean   compiled _U_;
@@ -941,6 +1208,8 @@ cf_finish_tail(capture_file *cf, wtap_rec *rec, Buffer *buf, int *err)
    *
    *    one of the tap listeners is going to apply a filter;
    *
+   *    one of the tap listeners declared fields it needs primed;
+   *
    *    one of the tap listeners requires a protocol tree;
    *
    *    a postdissector wants field values or protocols on
@@ -948,6 +1217,7 @@ cf_finish_tail(capture_file *cf, wtap_rec *rec, Buffer *buf, int *err)
    */
   create_proto_tree =
     (dfcode != NULL || have_filtering_tap_listeners() ||
+     have_field_tap_listeners() ||
      (tap_flags & TL_REQUIRES_PROTO_TREE) || postdissectors_want_hfids());
 
   if (cf->provider.wth == NULL) {
@@ -960,6 +1230,11 @@ cf_finish_tail(capture_file *cf, wtap_rec *rec, Buffer *buf, int *err)
 
   epan_dissect_init(&edt, cf->epan, create_proto_tree, FALSE);
 
+  /* If there's a read filter, create its dissection context once for
+     the rest of the pass; read_record resets it between records. */
+  if (cf->rfcode)
+    epan_dissect_init(&rf_edt, cf->epan, TRUE, FALSE);
+
   while ((wtap_read(cf->provider.wth, rec, buf, err, &err_info, &data_offset))) {
     if (cf->state == FILE_READ_ABORTED) {
       /* Well, the user decided to abort the read.  Break out of the
@@ -967,13 +1242,15 @@ cf_finish_tail(capture_file *cf, wtap_rec *rec, Buffer *buf, int *err)
          aren't any packets left to read) exit. */
       break;
     }
-    read_record(cf, rec, buf, dfcode, &edt, cinfo, data_offset);
+    read_record(cf, rec, buf, dfcode, &edt, cinfo, data_offset, &rf_edt);
   }
 
   /* Cleanup and release all dfilter resources */
   dfilter_free(dfcode);
 
   epan_dissect_cleanup(&edt);
+  if (cf->rfcode)
+    epan_dissect_cleanup(&rf_edt);
 
   /* Don't freeze/thaw the list when doing live capture */
   /*packet_list_thaw();*/
@@ -1217,6 +1494,16 @@ add_packet_to_packet_list(frame_data *fdata, capture_file *cf,
   if (fdata->passed_dfilter || fdata->ref_time)
     cf->displayed_count++;
 
+  /* Keep the incrementally maintained protocol hierarchy counters in
+     step with the displayed frames. */
+  if (fdata->passed_dfilter)
+    ph_stats_live_add(cf, &edt->pi);
+
+  /* If pass one is building the sidecar field postings, record which
+     fields this frame contains and which frames it depends on. */
+  if (cf->postings_collecting && edt->tree != NULL)
+    frame_index_postings_add(cf, edt);
+
   if (add_to_packet_list) {
     /* We fill the needed columns from new_packet_list */
     packet_list_append(cinfo, fdata);
@@ -1245,13 +1532,46 @@ add_packet_to_packet_list(frame_data *fdata, capture_file *cf,
  */
 static gboolean
 read_record(capture_file *cf, wtap_rec *rec, Buffer *buf, dfilter_t *dfcode,
-            epan_dissect_t *edt, column_info *cinfo, gint64 offset)
+            epan_dissect_t *edt, column_info *cinfo, gint64 offset,
+            epan_dissect_t *rf_edt)
 {
   frame_data    fdlocal;
   frame_data   *fdata;
   gboolean      passed = TRUE;
   gboolean      added = FALSE;
 
+  if (cf->frames_preloaded) {
+    /* The frame table was preloaded from a sidecar index; reuse the
+       stored frame metadata rather than recomputing it.  The index is
+       never used when a read filter is set, so there's no filter pass
+       to run here. */
+    fdata = frame_data_sequence_find(cf->provider.frames, cf->count + 1);
+    if (fdata != NULL) {
+      if (fdata->file_off != offset) {
+        /* The file changed under a matching fingerprint; trust what we
+           just read from the file over the index. */
+        ws_warning("Frame index for \"%s\" is stale at frame %u",
+                   cf->filename, cf->count + 1);
+        frame_data_init(fdata, cf->count + 1, rec, offset, cf->cum_bytes);
+      }
+      /* The sidecar index doesn't carry the coarse class; recompute it. */
+      frame_data_classify(fdata, rec, ws_buffer_start_ptr(buf));
+      if (rec->rec_type == REC_TYPE_PACKET)
+        cf_add_encapsulation_type(cf, rec->rec_header.packet_header.pkt_encap);
+      cf->count++;
+      if (rec->block != NULL)
+        cf->packet_comment_count += wtap_block_count_option(rec->block, OPT_COMMENT);
+      cf->f_datalen = offset + fdata->cap_len;
+      if (!cf->redissecting && cf->redissection_queued == RESCAN_NONE) {
+        add_packet_to_packet_list(fdata, cf, edt, dfcode, cinfo, rec, buf, TRUE);
+      }
+      summary_stats_live_add(cf, fdata);
+      return TRUE;
+    }
+    /* More records in the file than in the index; fall through and add
+       this one normally. */
+  }
+
   /* Add this packet's link-layer encapsulation type to cf->linktypes, if
      it's not already there.
      XXX - yes, this is O(N), so if every packet had a different
@@ -1265,17 +1585,18 @@ read_record(capture_file *cf, wtap_rec *rec, Buffer *buf, dfilter_t *dfcode,
   /* The frame number of this packet, if we add it to the set of frames,
      would be one more than the count of frames in the file so far. */
   frame_data_init(&fdlocal, cf->count + 1, rec, offset, cf->cum_bytes);
+  frame_data_classify(&fdlocal, rec, ws_buffer_start_ptr(buf));
 
   if (cf->rfcode) {
-    epan_dissect_t rf_edt;
-
-    epan_dissect_init(&rf_edt, cf->epan, TRUE, FALSE);
-    epan_dissect_prime_with_dfilter(&rf_edt, cf->rfcode);
-    epan_dissect_run(&rf_edt, cf->cd_t, rec,
+    /* The read-filter dissection context is created once per sequential
+       pass by our callers and reset between records, rather than being
+       built and torn down (pool, tree root and all) for every record. */
+    epan_dissect_prime_with_dfilter(rf_edt, cf->rfcode);
+    epan_dissect_run(rf_edt, cf->cd_t, rec,
                      frame_tvbuff_new_buffer(&cf->provider, &fdlocal, buf),
                      &fdlocal, NULL);
-    passed = dfilter_apply_edt(cf->rfcode, &rf_edt);
-    epan_dissect_cleanup(&rf_edt);
+    passed = dfilter_apply_edt(cf->rfcode, rf_edt);
+    epan_dissect_reset(rf_edt);
   }
 
   if (passed) {
@@ -1294,6 +1615,10 @@ read_record(capture_file *cf, wtap_rec *rec, Buffer *buf, dfilter_t *dfcode,
     if (!cf->redissecting && cf->redissection_queued == RESCAN_NONE) {
       add_packet_to_packet_list(fdata, cf, edt, dfcode, cinfo, rec, buf, TRUE);
     }
+
+    /* The frame's filter result (if any pass ran) is settled; account
+       for the frame in the running summary aggregates. */
+    summary_stats_live_add(cf, fdata);
   }
 
   return added;
@@ -1554,6 +1879,9 @@ void
 cf_reftime_packets(capture_file *cf)
 {
   ref_time_packets(cf);
+  /* The relative and delta times just changed underneath any cached
+     filter results; a filter testing them must be re-evaluated. */
+  cf_filter_result_cache_invalidate(cf);
 }
 
 void
@@ -1578,6 +1906,32 @@ cf_redissect_packets(capture_file *cf)
   }
 }
 
+/*
+ * When nonzero, rescan_packets() stops dissecting after this frame,
+ * leaving the rest of the file undissected; see cf_redissect_to_frame().
+ */
+static guint32 rescan_stop_frame;
+
+void
+cf_redissect_to_frame(capture_file *cf, guint32 frame_num)
+{
+  if (frame_num == 0 || frame_num >= cf->count) {
+    /* The horizon covers the whole file; just redissect normally. */
+    cf_redissect_packets(cf);
+    return;
+  }
+
+  if (cf->read_lock || cf->redissection_queued != RESCAN_NONE) {
+    /* A full pass is already in progress or queued; it wins. */
+    cf->redissection_queued = RESCAN_REDISSECT;
+    return;
+  }
+
+  rescan_stop_frame = frame_num;
+  rescan_packets(cf, "Reprocessing", "packets up to the selected frame", TRUE);
+  rescan_stop_frame = 0;
+}
+
 gboolean
 cf_read_record(capture_file *cf, const frame_data *fdata,
                  wtap_rec *rec, Buffer *buf)
@@ -1624,6 +1978,180 @@ cf_read_current_record(capture_file *cf)
    any state information they have (because a preference that affects
    some dissector has changed, meaning some dissector might construct
    its state differently from the way it was constructed the last time). */
+/*
+ * Cache of display filter results, so switching back to a recently used
+ * filter doesn't have to re-read and re-dissect every frame.  For each
+ * filter expression we keep one bit of "passed" and one bit of
+ * "depended upon" per frame, recorded after a completed filter pass and
+ * replayed by rescan_packets() when the same expression is applied
+ * again.  Entries are keyed by the filter text; they are dropped
+ * whenever a full redissection happens, as changed dissection state can
+ * change what a filter matches, and an entry recorded at a different
+ * frame count (e.g. during a live capture) is simply ignored.
+ */
+typedef struct {
+  guint32  count;      /* cf->count when this entry was recorded */
+  guint8  *passed;     /* one bit per frame: passed the filter */
+  guint8  *depended;   /* one bit per frame: depended upon by a displayed frame */
+} dfilter_result_cache_entry_t;
+
+#define DF_CACHE_BIT_SET(arr, n)  ((arr)[(n) >> 3] |= (guint8)(1U << ((n) & 7)))
+#define DF_CACHE_BIT_GET(arr, n)  (((arr)[(n) >> 3] >> ((n) & 7)) & 1)
+
+static void
+dfilter_result_cache_entry_free(gpointer data)
+{
+  dfilter_result_cache_entry_t *entry = (dfilter_result_cache_entry_t *)data;
+
+  g_free(entry->passed);
+  g_free(entry->depended);
+  g_free(entry);
+}
+
+static dfilter_result_cache_entry_t *
+dfilter_result_cache_lookup_text(capture_file *cf, const char *filter)
+{
+  dfilter_result_cache_entry_t *entry;
+
+  if (cf->dfilter_result_cache == NULL)
+    return NULL;
+  entry = (dfilter_result_cache_entry_t *)g_hash_table_lookup(
+      cf->dfilter_result_cache, filter ? filter : "");
+  if (entry == NULL || entry->count != cf->count)
+    return NULL;
+  return entry;
+}
+
+static dfilter_result_cache_entry_t *
+dfilter_result_cache_lookup(capture_file *cf)
+{
+  return dfilter_result_cache_lookup_text(cf, cf->dfilter);
+}
+
+static void
+dfilter_result_cache_store(capture_file *cf)
+{
+  dfilter_result_cache_entry_t *entry;
+  frame_data *fdata;
+  guint32     framenum;
+  gsize       nbytes;
+
+  if (cf->dfilter_result_cache == NULL) {
+    cf->dfilter_result_cache = g_hash_table_new_full(g_str_hash, g_str_equal,
+        g_free, dfilter_result_cache_entry_free);
+  }
+
+  nbytes = (cf->count + 7) / 8;
+  entry = g_new(dfilter_result_cache_entry_t, 1);
+  entry->count = cf->count;
+  entry->passed = (guint8 *)g_malloc0(nbytes);
+  entry->depended = (guint8 *)g_malloc0(nbytes);
+  for (framenum = 1; framenum <= cf->count; framenum++) {
+    fdata = frame_data_sequence_find(cf->provider.frames, framenum);
+    if (fdata->passed_dfilter)
+      DF_CACHE_BIT_SET(entry->passed, framenum - 1);
+    if (fdata->dependent_of_displayed)
+      DF_CACHE_BIT_SET(entry->depended, framenum - 1);
+  }
+  g_hash_table_insert(cf->dfilter_result_cache,
+      g_strdup(cf->dfilter ? cf->dfilter : ""), entry);
+}
+
+void
+cf_filter_result_cache_invalidate(capture_file *cf)
+{
+  if (cf->dfilter_result_cache != NULL)
+    g_hash_table_remove_all(cf->dfilter_result_cache);
+}
+
+/*
+ * Try to answer a display filter from the sidecar field postings.
+ * Only a bare field name is a pure existence test; anything
+ * with operators needs real evaluation.  On success a normal filter
+ * result cache entry is synthesized for the filter text, so the
+ * replay path below applies unchanged.  Returns TRUE if one was added.
+ */
+static gboolean
+dfilter_result_cache_from_postings(capture_file *cf, const char *filter)
+{
+  dfilter_result_cache_entry_t *entry;
+  const GArray *frames, *deps;
+  guint32     num, dep;
+  guint       i, j;
+  gsize       nbytes;
+
+  if (cf->field_postings == NULL || cf->postings_collecting ||
+      filter == NULL)
+    return FALSE;
+  if (proto_registrar_get_byname(filter) == NULL)
+    return FALSE;
+
+  nbytes = (cf->count + 7) / 8;
+  entry = g_new(dfilter_result_cache_entry_t, 1);
+  entry->count = cf->count;
+  entry->passed = (guint8 *)g_malloc0(nbytes);
+  entry->depended = (guint8 *)g_malloc0(nbytes);
+
+  /* An absent postings list is itself an answer - the field appeared in
+     no frame - since the postings cover every field of every dissected
+     frame. */
+  frames = (const GArray *)g_hash_table_lookup(cf->field_postings,
+                                               filter);
+  for (i = 0; frames != NULL && i < frames->len; i++) {
+    num = g_array_index(frames, guint32, i);
+    if (num == 0 || num > cf->count)
+      goto bad;
+    DF_CACHE_BIT_SET(entry->passed, num - 1);
+    deps = (const GArray *)g_hash_table_lookup(cf->frame_dependencies,
+                                               GUINT_TO_POINTER(num));
+    for (j = 0; deps != NULL && j < deps->len; j++) {
+      dep = g_array_index(deps, guint32, j);
+      if (dep == 0 || dep > cf->count)
+        goto bad;
+      DF_CACHE_BIT_SET(entry->depended, dep - 1);
+    }
+  }
+
+  if (cf->dfilter_result_cache == NULL) {
+    cf->dfilter_result_cache = g_hash_table_new_full(g_str_hash, g_str_equal,
+        g_free, dfilter_result_cache_entry_free);
+  }
+  g_hash_table_insert(cf->dfilter_result_cache, g_strdup(filter), entry);
+  return TRUE;
+
+bad:
+  /* The postings disagree with the frame table; don't trust them. */
+  ws_warning("Field postings for \"%s\" are inconsistent; discarding them",
+             cf->filename);
+  frame_index_postings_free(cf);
+  dfilter_result_cache_entry_free(entry);
+  return FALSE;
+}
+
+gboolean
+cf_filter_preview_count(capture_file *cf, const gchar *filter,
+                        guint32 *matches)
+{
+  dfilter_result_cache_entry_t *entry;
+  guint32 framenum, passed = 0;
+
+  if (cf->state == FILE_CLOSED || cf->count == 0 || filter == NULL)
+    return FALSE;
+
+  entry = dfilter_result_cache_lookup_text(cf, filter);
+  if (entry == NULL && dfilter_result_cache_from_postings(cf, filter))
+    entry = dfilter_result_cache_lookup_text(cf, filter);
+  if (entry == NULL)
+    return FALSE;
+
+  for (framenum = 1; framenum <= cf->count; framenum++) {
+    if (DF_CACHE_BIT_GET(entry->passed, framenum - 1))
+      passed++;
+  }
+  *matches = passed;
+  return TRUE;
+}
+
 static void
 rescan_packets(capture_file *cf, const char *action, const char *action_item, gboolean redissect)
 {
@@ -1650,6 +2178,9 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
   gboolean    compiled _U_;
   guint32     frames_count;
   gboolean    queued_rescan_type = RESCAN_NONE;
+  dfilter_result_cache_entry_t *df_cached = NULL;
+  gboolean    use_frame_prefix = FALSE;
+  gboolean    frame_ruled_out;
 
   /* Rescan in progress, clear pending actions. */
   cf->redissection_queued = RESCAN_NONE;
@@ -1680,6 +2211,8 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
    *
    *    one of the tap listeners is going to apply a filter;
    *
+   *    one of the tap listeners declared fields it needs primed;
+   *
    *    one of the tap listeners requires a protocol tree;
    *
    *    we're redissecting and a postdissector wants field
@@ -1687,6 +2220,7 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
    */
   create_proto_tree =
     (dfcode != NULL || have_filtering_tap_listeners() ||
+     have_field_tap_listeners() ||
      (tap_flags & TL_REQUIRES_PROTO_TREE) ||
      (redissect && postdissectors_want_hfids()));
 
@@ -1735,7 +2269,44 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
      * packet list store. */
     packet_list_clear();
     add_to_packet_list = TRUE;
-  }
+
+    /* Dissection state is being rebuilt, so previously recorded filter
+     * results may no longer be valid.  Same for the field postings,
+     * which reflect the previous dissection configuration. */
+    cf_filter_result_cache_invalidate(cf);
+    frame_index_postings_free(cf);
+  } else if (cinfo == NULL && !tap_listeners_require_dissection()) {
+    /* Nothing but the filter itself needs the dissection, so if we have
+     * cached results for this filter - or can synthesize them from the
+     * sidecar field postings - we can replay them and skip the read and
+     * dissection of every frame. */
+    df_cached = dfilter_result_cache_lookup(cf);
+    if (df_cached == NULL && dfilter_result_cache_from_postings(cf, cf->dfilter))
+      df_cached = dfilter_result_cache_lookup(cf);
+
+    /* Failing that, if the filter starts with metadata-only conjuncts
+     * (frame number, length, time), those rule frames out from
+     * frame_data alone; such frames can skip the read and dissection
+     * entirely.  Frames were all dissected on the first pass, so
+     * skipping some here doesn't perturb dissector state. */
+    if (df_cached == NULL && dfcode != NULL && !cf->postings_collecting)
+      use_frame_prefix = dfilter_has_frame_prefix(dfcode);
+  }
+
+  /* The pass below revisits every frame, so restart the incremental
+     protocol hierarchy counters along with the other per-pass state.
+     When we're replaying cached filter results nothing is dissected
+     and the counters can't be maintained; drop them and let
+     ph_stats_new() do its own pass if the dialog is opened. */
+  if (df_cached == NULL)
+    ph_stats_live_reset(cf);
+  else
+    ph_stats_live_invalidate(cf);
+
+  /* The summary aggregates only need frame metadata, which every path
+     below has even when nothing is dissected, so restart them
+     unconditionally. */
+  summary_stats_live_reset(cf);
 
   /* We don't yet know which will be the first and last frames displayed. */
   cf->first_displayed = 0;
@@ -1820,6 +2391,10 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
         g_snprintf(status_str, sizeof(status_str),
                   "%4u of %u frames", count, frames_count);
         update_progress_dlg(progbar, progbar_val, status_str);
+      } else {
+        /* Keep the UI serviced even before the (delayed) progress dialog
+         * exists; see the matching pump in cf_read(). */
+        main_window_update();
       }
 
       g_timer_start(prog_timer);
@@ -1848,6 +2423,13 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
       break;
     }
 
+    if (rescan_stop_frame != 0 && framenum > rescan_stop_frame) {
+      /* We were asked to stop dissecting at a particular frame; the
+         frames past it are left undissected (and reset below), so the
+         dissectors' state is exactly as of that frame. */
+      break;
+    }
+
     count++;
 
     if (redissect) {
@@ -1862,8 +2444,13 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
     /* Frame dependencies from the previous dissection/filtering are no longer valid. */
     fdata->dependent_of_displayed = 0;
 
-    if (!cf_read_record(cf, fdata, &rec, &buf))
-      break; /* error reading the frame */
+    frame_ruled_out = use_frame_prefix &&
+        !dfilter_check_frame_prefix(dfcode, fdata);
+
+    if (df_cached == NULL && !frame_ruled_out) {
+      if (!cf_read_record(cf, fdata, &rec, &buf))
+        break; /* error reading the frame */
+    }
 
     /* If the previous frame is displayed, and we haven't yet seen the
        selected frame, remember that frame - it's the closest one we've
@@ -1873,9 +2460,54 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
       preceding_frame = prev_frame;
     }
 
-    add_packet_to_packet_list(fdata, cf, &edt, dfcode,
-                                    cinfo, &rec, &buf,
-                                    add_to_packet_list);
+    if (df_cached != NULL) {
+      /* Replay the cached filter result for this frame, doing the same
+         bookkeeping add_packet_to_packet_list() would, minus the
+         dissection. */
+      frame_data_set_before_dissect(fdata, &cf->elapsed_time,
+                                    &cf->provider.ref, cf->provider.prev_dis);
+      cf->provider.prev_cap = fdata;
+      fdata->passed_dfilter =
+          DF_CACHE_BIT_GET(df_cached->passed, framenum - 1);
+      fdata->dependent_of_displayed =
+          DF_CACHE_BIT_GET(df_cached->depended, framenum - 1);
+      if (fdata->passed_dfilter || fdata->ref_time) {
+        cf->displayed_count++;
+
+        frame_data_set_after_dissect(fdata, &cf->cum_bytes);
+        cf->provider.prev_dis = fdata;
+
+        if (cf->first_displayed == 0)
+          cf->first_displayed = fdata->num;
+        cf->last_displayed = fdata->num;
+      }
+    } else if (frame_ruled_out) {
+      /* The metadata prefix already rules this frame out; do the same
+         bookkeeping add_packet_to_packet_list() would, minus the read
+         and dissection. */
+      frame_data_set_before_dissect(fdata, &cf->elapsed_time,
+                                    &cf->provider.ref, cf->provider.prev_dis);
+      cf->provider.prev_cap = fdata;
+      fdata->passed_dfilter = 0;
+      if (fdata->ref_time) {
+        cf->displayed_count++;
+
+        frame_data_set_after_dissect(fdata, &cf->cum_bytes);
+        cf->provider.prev_dis = fdata;
+
+        if (cf->first_displayed == 0)
+          cf->first_displayed = fdata->num;
+        cf->last_displayed = fdata->num;
+      }
+    } else {
+      add_packet_to_packet_list(fdata, cf, &edt, dfcode,
+                                      cinfo, &rec, &buf,
+                                      add_to_packet_list);
+    }
+
+    /* Whichever path above settled this frame's filter result, account
+       for the frame in the running summary aggregates. */
+    summary_stats_live_add(cf, fdata);
 
     /* If this frame is displayed, and this is the first frame we've
        seen displayed after the selected frame, remember this frame -
@@ -1901,6 +2533,21 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
   wtap_rec_cleanup(&rec);
   ws_buffer_free(&buf);
 
+  /* If we dissected our way through a complete pass, record the filter
+     results so applying the same filter again can skip the dissection. */
+  if (df_cached == NULL && framenum > frames_count &&
+      queued_rescan_type == RESCAN_NONE && !cf->stop_flag)
+    dfilter_result_cache_store(cf);
+
+  /* An aborted or truncated pass leaves frames the incremental protocol
+     hierarchy counters and summary aggregates never saw; don't hand out
+     short counts. */
+  if (cf->stop_flag || queued_rescan_type != RESCAN_NONE ||
+      rescan_stop_frame != 0) {
+    ph_stats_live_invalidate(cf);
+    summary_stats_live_invalidate(cf);
+  }
+
   /* We are done redissecting the packet list. */
   cf->redissecting = FALSE;
 
@@ -2008,6 +2655,8 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
    * change) was requested, the rescan above is aborted and restarted here. */
   if (queued_rescan_type != RESCAN_NONE) {
     redissect = redissect || queued_rescan_type == RESCAN_REDISSECT;
+    /* The queued pass supersedes any dissection horizon. */
+    rescan_stop_frame = 0;
     rescan_packets(cf, "Reprocessing", "all packets", redissect);
   }
 }
@@ -2276,10 +2925,17 @@ cf_retap_packets(capture_file *cf)
    *
    *    one of the tap listeners is going to apply a filter;
    *
+   *    one of the tap listeners declared fields it needs primed;
+   *
    *    one of the tap listeners requires a protocol tree.
+   *
+   * Unless a listener requires a full tree, the tree stays invisible
+   * and the dissection engine fakes everything except the fields that
+   * the listener filters and declarations primed into it.
    */
   create_proto_tree =
-    (have_filtering_tap_listeners() || (tap_flags & TL_REQUIRES_PROTO_TREE));
+    (have_filtering_tap_listeners() || have_field_tap_listeners() ||
+     (tap_flags & TL_REQUIRES_PROTO_TREE));
 
   /* Reset the tap listeners. */
   reset_tap_listeners();
@@ -2319,6 +2975,69 @@ cf_retap_packets(capture_file *cf)
   return CF_READ_OK;
 }
 
+cf_read_status_t
+cf_retap_frames(capture_file *cf, const guint32 *frames, guint n_frames)
+{
+  retap_callback_args_t callback_args;
+  gboolean              create_proto_tree;
+  guint                 tap_flags;
+  wtap_rec              rec;
+  Buffer                buf;
+  frame_data           *fdata;
+  guint                 i;
+  cf_read_status_t      status = CF_READ_OK;
+
+  /* Presumably the user closed the capture file. */
+  if (cf == NULL) {
+    return CF_READ_ABORTED;
+  }
+
+  if (cf->read_lock) {
+    ws_warning("Failing due to nested cf_retap_frames(\"%s\") call!", cf->filename);
+    return CF_READ_ERROR;
+  }
+  cf->read_lock = TRUE;
+
+  cf_callback_invoke(cf_cb_file_retap_started, cf);
+
+  /* Same tap setup as cf_retap_packets(), without the progress
+     machinery: the point of retapping a frame list is that it's short. */
+  tap_flags = union_of_tap_listener_flags();
+  callback_args.cinfo = (tap_flags & TL_REQUIRES_COLUMNS) ? &cf->cinfo : NULL;
+  create_proto_tree =
+    (have_filtering_tap_listeners() || have_field_tap_listeners() ||
+     (tap_flags & TL_REQUIRES_PROTO_TREE));
+
+  reset_tap_listeners();
+
+  epan_dissect_init(&callback_args.edt, cf->epan, create_proto_tree, FALSE);
+
+  wtap_rec_init(&rec);
+  ws_buffer_init(&buf, 1514);
+
+  for (i = 0; i < n_frames; i++) {
+    fdata = frame_data_sequence_find(cf->provider.frames, frames[i]);
+    if (fdata == NULL)
+      continue;
+    if (!cf_read_record(cf, fdata, &rec, &buf)) {
+      status = CF_READ_ERROR;
+      break;
+    }
+    retap_packet(cf, fdata, &rec, &buf, &callback_args);
+  }
+
+  wtap_rec_cleanup(&rec);
+  ws_buffer_free(&buf);
+  epan_dissect_cleanup(&callback_args.edt);
+
+  cf_callback_invoke(cf_cb_file_retap_finished, cf);
+
+  ws_assert(cf->read_lock);
+  cf->read_lock = FALSE;
+
+  return status;
+}
+
 typedef struct {
   print_args_t *print_args;
   gboolean      print_header_line;
@@ -3324,6 +4043,14 @@ match_narrow_and_wide(capture_file *cf, frame_data *fdata,
   pd = ws_buffer_start_ptr(buf);
   i = 0;
   while (i < buf_len) {
+    if (c_match == 0 && !cf->case_type) {
+      /* Between candidate matches, skip ahead to the next occurrence of
+         the first character instead of testing every byte. */
+      const guint8 *next = (const guint8 *)memchr(pd + i, ascii_text[0], buf_len - i);
+      if (next == NULL)
+        break;
+      i = (guint32)(next - pd);
+    }
     c_char = pd[i];
     if (cf->case_type)
       c_char = g_ascii_toupper(c_char);
@@ -3374,6 +4101,14 @@ match_narrow(capture_file *cf, frame_data *fdata,
   pd = ws_buffer_start_ptr(buf);
   i = 0;
   while (i < buf_len) {
+    if (c_match == 0 && !cf->case_type) {
+      /* Between candidate matches, skip ahead to the next occurrence of
+         the first character instead of testing every byte. */
+      const guint8 *next = (const guint8 *)memchr(pd + i, ascii_text[0], buf_len - i);
+      if (next == NULL)
+        break;
+      i = (guint32)(next - pd);
+    }
     c_char = pd[i];
     if (cf->case_type)
       c_char = g_ascii_toupper(c_char);
@@ -3423,6 +4158,14 @@ match_wide(capture_file *cf, frame_data *fdata,
   pd = ws_buffer_start_ptr(buf);
   i = 0;
   while (i < buf_len) {
+    if (c_match == 0 && !cf->case_type) {
+      /* Between candidate matches, skip ahead to the next occurrence of
+         the first character instead of testing every byte. */
+      const guint8 *next = (const guint8 *)memchr(pd + i, ascii_text[0], buf_len - i);
+      if (next == NULL)
+        break;
+      i = (guint32)(next - pd);
+    }
     c_char = pd[i];
     if (cf->case_type)
       c_char = g_ascii_toupper(c_char);
@@ -3456,9 +4199,8 @@ match_binary(capture_file *cf, frame_data *fdata,
   size_t        datalen     = info->data_len;
   match_result  result;
   guint32       buf_len;
-  guint8       *pd;
-  guint32       i;
-  size_t        c_match     = 0;
+  const guint8 *pd;
+  const guint8 *p;
 
   /* Load the frame's data. */
   if (!cf_read_record(cf, fdata, rec, buf)) {
@@ -3469,24 +4211,21 @@ match_binary(capture_file *cf, frame_data *fdata,
   result = MR_NOTMATCHED;
   buf_len = fdata->cap_len;
   pd = ws_buffer_start_ptr(buf);
-  i = 0;
-  while (i < buf_len) {
-    if (pd[i] == binary_data[c_match]) {
-      c_match += 1;
-      if (c_match == datalen) {
+  /* Exact bytes: let memchr() find candidate start positions and verify
+     each one with memcmp() instead of walking the data byte by byte. */
+  if (datalen > 0 && buf_len >= datalen) {
+    p = pd;
+    while ((p = (const guint8 *)memchr(p, binary_data[0], buf_len - datalen - (p - pd) + 1)) != NULL) {
+      if (memcmp(p, binary_data, datalen) == 0) {
         result = MR_MATCHED;
-        cf->search_pos = i; /* Save the position of the last character
+        cf->search_pos = (guint32)(p - pd) + (guint32)datalen - 1;
+                            /* Save the position of the last character
                                for highlighting the field. */
         cf->search_len = (guint32)datalen;
         break;
       }
+      p++;
     }
-    else {
-      ws_assert(i>=c_match);
-      i -= (guint32)c_match;
-      c_match = 0;
-    }
-    i += 1;
   }
   return result;
 }
@@ -3516,11 +4255,27 @@ match_regex(capture_file *cf, frame_data *fdata,
     return result;
 }
 
+/* What to match against in match_dfilter().  If the filter's text has a
+ * result cache entry from an earlier full filter pass, cached_passed
+ * points at its per-frame bitmap and each candidate frame is answered
+ * with a bit test instead of being re-read and re-dissected. */
+typedef struct {
+  dfilter_t    *sfcode;
+  const guint8 *cached_passed;
+} match_dfilter_criterion_t;
+
 gboolean
 cf_find_packet_dfilter(capture_file *cf, dfilter_t *sfcode,
-                       search_direction dir)
+                       const gchar *filter, search_direction dir)
 {
-  return find_packet(cf, match_dfilter, sfcode, dir);
+  match_dfilter_criterion_t      criterion;
+  dfilter_result_cache_entry_t  *cached;
+
+  criterion.sfcode = sfcode;
+  cached = dfilter_result_cache_lookup_text(cf, filter);
+  criterion.cached_passed = cached ? cached->passed : NULL;
+
+  return find_packet(cf, match_dfilter, &criterion, dir);
 }
 
 gboolean
@@ -3544,7 +4299,7 @@ cf_find_packet_dfilter_string(capture_file *cf, const char *filter,
      */
     return FALSE;
   }
-  result = find_packet(cf, match_dfilter, sfcode, dir);
+  result = cf_find_packet_dfilter(cf, sfcode, filter, dir);
   dfilter_free(sfcode);
   return result;
 }
@@ -3553,10 +4308,18 @@ static match_result
 match_dfilter(capture_file *cf, frame_data *fdata,
               wtap_rec *rec, Buffer *buf, void *criterion)
 {
-  dfilter_t      *sfcode = (dfilter_t *)criterion;
+  match_dfilter_criterion_t *mdc = (match_dfilter_criterion_t *)criterion;
+  dfilter_t      *sfcode = mdc->sfcode;
   epan_dissect_t  edt;
   match_result    result;
 
+  /* A cached full-pass result for this filter answers without any
+   * reading or dissection. */
+  if (mdc->cached_passed != NULL) {
+    return DF_CACHE_BIT_GET(mdc->cached_passed, fdata->num - 1) ?
+        MR_MATCHED : MR_NOTMATCHED;
+  }
+
   /* Load the frame's data. */
   if (!cf_read_record(cf, fdata, rec, buf)) {
     /* Attempt to get the packet failed. */
@@ -3920,6 +4683,7 @@ cf_mark_frame(capture_file *cf, frame_data *frame)
     frame->marked = TRUE;
     if (cf->count > cf->marked_count)
       cf->marked_count++;
+    summary_stats_live_mark(cf, frame, TRUE);
   }
 }
 
@@ -3933,6 +4697,7 @@ cf_unmark_frame(capture_file *cf, frame_data *frame)
     frame->marked = FALSE;
     if (cf->marked_count > 0)
       cf->marked_count--;
+    summary_stats_live_mark(cf, frame, FALSE);
   }
 }
 
@@ -4061,6 +4826,10 @@ cf_set_modified_block(capture_file *cf, frame_data *fd, const wtap_block_t new_b
     expert_update_comment_count(cf->packet_comment_count);
   }
 
+  /* Persist the edit to the sidecar journal, so it survives this session
+     without requiring a full-file rewrite. */
+  comment_journal_record(cf, fd->num, new_block);
+
   /* Either way, we have unsaved changes. */
   wtap_block_unref(pkt_block);
   cf->unsaved_changes = TRUE;
@@ -4165,6 +4934,160 @@ save_record(capture_file *cf, frame_data *fdata, wtap_rec *rec,
   return TRUE;
 }
 
+/*
+ * Export the records selected by a packet range by re-reading the
+ * source file sequentially rather than seek-reading each selected
+ * record.  The frame table is in file order, so one buffered sweep
+ * of the file visits every record the range can select; that turns
+ * what used to be per-record random I/O into sequential I/O at
+ * roughly disk bandwidth.
+ */
+static psp_return_t
+export_specified_records_sequential(capture_file *cf, packet_range_t *range,
+                                    save_callback_args_t *callback_args)
+{
+  wtap            *wth;
+  guint32          framenum;
+  frame_data      *fdata;
+  wtap_rec         rec;
+  Buffer           buf;
+  int              err;
+  gchar           *err_info;
+  gint64           data_offset;
+  psp_return_t     ret     = PSP_FINISHED;
+
+  progdlg_t       *progbar = NULL;
+  GTimer          *prog_timer = g_timer_new();
+  int              progbar_count;
+  float            progbar_val;
+  gchar            progbar_status_str[100];
+  range_process_e  process_this;
+
+  /* Open a second, sequential-only handle on the source file; the
+     handle in cf->provider stays available for random access. */
+  wth = wtap_open_offline(cf->filename, cf->open_type, &err, &err_info, FALSE);
+  if (wth == NULL) {
+    cfile_open_failure_alert_box(cf->filename, err, err_info);
+    g_timer_destroy(prog_timer);
+    return PSP_FAILED;
+  }
+
+  wtap_rec_init(&rec);
+  ws_buffer_init(&buf, 1514);
+
+  g_timer_start(prog_timer);
+  /* Count of packets at which we've looked. */
+  progbar_count = 0;
+  /* Progress so far. */
+  progbar_val = 0.0f;
+
+  if (cf->read_lock) {
+    ws_warning("Failing due to nested export_specified_records_sequential(\"%s\") call!", cf->filename);
+    wtap_rec_cleanup(&rec);
+    ws_buffer_free(&buf);
+    wtap_close(wth);
+    g_timer_destroy(prog_timer);
+    return PSP_FAILED;
+  }
+  cf->read_lock = TRUE;
+
+  cf->stop_flag = FALSE;
+
+  packet_range_process_init(range);
+
+  for (framenum = 1; framenum <= cf->count; framenum++) {
+    fdata = frame_data_sequence_find(cf->provider.frames, framenum);
+
+    /* Create the progress bar if necessary.
+       We check on every iteration of the loop, so that it takes no
+       longer than the standard time to create it (otherwise, for a
+       large file, we might take considerably longer than that standard
+       time in order to get to the next progress bar step). */
+    if (progbar == NULL)
+      progbar = delayed_create_progress_dlg(cf->window, "Writing",
+                                            "specified records", TRUE,
+                                            &cf->stop_flag, progbar_val);
+
+    /*
+     * Update the progress bar, but do it only after PROGBAR_UPDATE_INTERVAL
+     * has elapsed. Calling update_progress_dlg and packets_bar_update will
+     * likely trigger UI paint events, which might take a while depending on
+     * the platform and display. Reset our timer *after* painting.
+     */
+    if (progbar && g_timer_elapsed(prog_timer, NULL) > PROGBAR_UPDATE_INTERVAL) {
+      /* let's not divide by zero. I should never be started
+       * with count == 0, so let's assert that
+       */
+      ws_assert(cf->count > 0);
+      progbar_val = (gfloat) progbar_count / cf->count;
+
+      g_snprintf(progbar_status_str, sizeof(progbar_status_str),
+                  "%4u of %u packets", progbar_count, cf->count);
+      update_progress_dlg(progbar, progbar_val, progbar_status_str);
+
+      g_timer_start(prog_timer);
+    }
+
+    if (cf->stop_flag) {
+      /* Well, the user decided to abort the operation.  Just stop,
+         and arrange to return PSP_STOPPED to our caller, so they know
+         it was stopped explicitly. */
+      ret = PSP_STOPPED;
+      break;
+    }
+
+    progbar_count++;
+
+    /* Advance the sequential stream to this record even if we end up
+       skipping it; the next selected record is then a short read away. */
+    if (!wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset)) {
+      if (err != 0) {
+        /* The read failed; report the error. */
+        cfile_read_failure_alert_box(cf->filename, err, err_info);
+      } else {
+        /* The file has fewer records than the frame table; it must
+           have changed underneath us. */
+        simple_error_message_box("The file \"%s\" has fewer records than expected.",
+                                 cf->filename);
+      }
+      ret = PSP_FAILED;
+      break;
+    }
+
+    /* do we have to process this packet? */
+    process_this = packet_range_process_packet(range, fdata);
+    if (process_this == range_process_next) {
+      /* this packet uninteresting, continue with next one */
+      continue;
+    } else if (process_this == range_processing_finished) {
+      /* all interesting packets processed, stop the loop */
+      break;
+    }
+
+    /* Process the packet */
+    if (!save_record(cf, fdata, &rec, &buf, callback_args)) {
+      /* save_record reported the error appropriately. */
+      ret = PSP_FAILED;
+      break;
+    }
+  }
+
+  /* We're done writing the packets; destroy the progress bar if
+     it was created. */
+  if (progbar != NULL)
+    destroy_progress_dlg(progbar);
+  g_timer_destroy(prog_timer);
+
+  ws_assert(cf->read_lock);
+  cf->read_lock = FALSE;
+
+  wtap_rec_cleanup(&rec);
+  ws_buffer_free(&buf);
+  wtap_close(wth);
+
+  return ret;
+}
+
 /*
  * Can this capture file be written out in any format using Wiretap
  * rather than by copying the raw data?
@@ -4675,6 +5598,10 @@ cf_save_records(capture_file *cf, const char *fname, guint save_format,
   cf_callback_invoke(cf_cb_file_save_finished, NULL);
   cf->unsaved_changes = FALSE;
 
+  /* Whatever comments we had are now in the capture file itself; the
+     sidecar journal is no longer needed. */
+  comment_journal_delete(cf);
+
   if (!dont_reopen) {
     switch (how_to_save) {
 
@@ -4855,18 +5782,19 @@ cf_export_specified_packets(capture_file *cf, const char *fname,
   /* Add address resolution */
   wtap_dump_set_addrinfo_list(pdh, get_addrinfo_list());
 
-  /* Iterate through the list of packets, processing the packets we were
-     told to process.
+  /* Sweep the source file once, sequentially, writing out the records
+     the range selects as we reach them.  The range decides, frame by
+     frame, whether a record is wanted, so there's no need to seek-read
+     each selected record individually.
 
      XXX - we've already called "packet_range_process_init(range)", but
-     "process_specified_records()" will do it again.  Fortunately,
+     "export_specified_records_sequential()" will do it again.  Fortunately,
      that's harmless in this case, as we haven't done anything to
      "range" since we initialized it. */
   callback_args.pdh = pdh;
   callback_args.fname = fname;
   callback_args.file_type = save_format;
-  switch (process_specified_records(cf, range, "Writing", "specified records",
-                                    TRUE, save_record, &callback_args, TRUE)) {
+  switch (export_specified_records_sequential(cf, range, &callback_args)) {
 
   case PSP_FINISHED:
     /* Completed successfully. */
@@ -4991,6 +5919,11 @@ cf_reload(capture_file *cf) {
   filename = g_strdup(cf->filename);
   is_tempfile = cf->is_tempfile;
   cf->is_tempfile = FALSE;
+
+  /* We're re-reading the same packets, so keep the journaled heuristic
+     outcomes across the close; known flows then skip heuristic probing. */
+  heur_dissector_journal_preserve();
+
   if (cf_open(cf, filename, cf->open_type, is_tempfile, &err) == CF_OK) {
     switch (cf_read(cf, TRUE)) {
 
@@ -124,6 +124,20 @@ cf_callback_remove(cf_callback_t func, gpointer user_data);
  */
 cf_status_t cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_tempfile, int *err);
 
+/**
+ * Open a set of capture files as one virtual, concatenated capture.
+ * The set is read-only; member files are opened lazily as reading and
+ * random access reach them, so a large file set can be browsed without
+ * merging it first. See wtap_chain_open_offline().
+ *
+ * @param cf the capture file to be opened
+ * @param fnames the filenames of the members, in presentation order
+ * @param n_fnames the number of entries in fnames; must be at least 1
+ * @param err error code
+ * @return one of cf_status_t
+ */
+cf_status_t cf_open_file_set(capture_file *cf, const char *const *fnames, guint n_fnames, int *err);
+
 /**
  * Close a capture file.
  *
@@ -394,6 +408,22 @@ void cf_set_rfcode(capture_file *cf, dfilter_t *rfcode);
  */
 cf_status_t cf_filter_packets(capture_file *cf, gchar *dfilter, gboolean force);
 
+/**
+ * Try to answer, without reading or dissecting any frame, how many
+ * frames would pass the given display filter.  Only filters with a
+ * cached full-pass result, or bare field names covered by the sidecar
+ * field postings, can be answered; for the latter a result cache entry
+ * is synthesized, so a subsequent cf_filter_packets() of the same text
+ * replays from the cached bitmap instead of rescanning.
+ *
+ * @param cf the capture file
+ * @param filter the display filter text
+ * @param matches set to the number of passing frames on success
+ * @return TRUE if an instant answer was available, FALSE otherwise
+ */
+gboolean cf_filter_preview_count(capture_file *cf, const gchar *filter,
+                                 guint32 *matches);
+
 /**
  * At least one "Refence Time" flag has changed, rescan all packets.
  *
@@ -401,6 +431,15 @@ cf_status_t cf_filter_packets(capture_file *cf, gchar *dfilter, gboolean force);
  */
 void cf_reftime_packets(capture_file *cf);
 
+/**
+ * Discard all cached display filter results.  Call whenever frame
+ * metadata a filter may test - timestamps after a time shift, relative
+ * times after a reference time toggle - changes without a redissection.
+ *
+ * @param cf the capture file
+ */
+void cf_filter_result_cache_invalidate(capture_file *cf);
+
 /**
  * Return the time it took to load the file (in msec).
  */
@@ -413,6 +452,20 @@ gulong cf_get_computed_elapsed(capture_file *cf);
  */
 void cf_redissect_packets(capture_file *cf);
 
+/**
+ * Redissect the capture file from the beginning, but stop after the
+ * given frame, leaving the remaining frames undissected.  The
+ * dissectors' conversation and per-protocol state is then exactly as
+ * it was when that frame was dissected, which is useful when chasing
+ * protocol state machine problems.  A later redissection (preference
+ * change, "Reload", ...) restores the full view.
+ *
+ * @param cf the capture file
+ * @param frame_num the last frame to dissect; 0 or a frame number at
+ * or past the end of the file means a normal full redissection
+ */
+void cf_redissect_to_frame(capture_file *cf, guint32 frame_num);
+
 /**
  * Rescan all packets and just run taps - don't reconstruct the display.
  *
@@ -421,6 +474,19 @@ void cf_redissect_packets(capture_file *cf);
  */
 cf_read_status_t cf_retap_packets(capture_file *cf);
 
+/**
+ * Dissect only the listed frames and run the taps on them, for
+ * consumers that already know which frames they need (e.g. a Follow
+ * Stream index). Unknown frame numbers are skipped.
+ *
+ * @param cf the capture file
+ * @param frames the frame numbers to retap
+ * @param n_frames number of entries in frames
+ * @return one of cf_read_status_t
+ */
+cf_read_status_t cf_retap_frames(capture_file *cf, const guint32 *frames,
+                                 guint n_frames);
+
 /**
  * Adjust timestamp precision if auto is selected.
  *
@@ -559,11 +625,14 @@ gboolean cf_find_packet_data(capture_file *cf, const guint8 *string,
  *
  * @param cf the capture file
  * @param sfcode the display filter to match
+ * @param filter the text sfcode was compiled from, or NULL if not known;
+ * used to look up cached per-frame results for the same filter, which
+ * answer the search without redissecting candidate frames
  * @param dir direction in which to search
  * @return TRUE if a packet was found, FALSE otherwise
  */
 gboolean cf_find_packet_dfilter(capture_file *cf, dfilter_t *sfcode,
-                                search_direction dir);
+                                const gchar *filter, search_direction dir);
 
 /**
  * Find packet that matches a display filter given as a text string.
@@ -90,3 +90,33 @@ cap_file_provider_set_modified_block(struct packet_provider_data *prov, frame_da
 
   fd->has_modified_block = TRUE;
 }
+
+const nstime_t *
+cap_file_provider_get_shift_offset(struct packet_provider_data *prov, const frame_data *fd)
+{
+  if (prov->frames_shift_offsets)
+    return (const nstime_t *)g_tree_lookup(prov->frames_shift_offsets, fd);
+
+  return NULL;
+}
+
+void
+cap_file_provider_set_shift_offset(struct packet_provider_data *prov, frame_data *fd, const nstime_t *shift_offset)
+{
+  nstime_t *shift_copy;
+
+  if (shift_offset->secs == 0 && shift_offset->nsecs == 0) {
+    /* Unshifted frames don't get an entry, so the tree only ever costs
+       memory for frames whose time the user actually moved. */
+    if (prov->frames_shift_offsets)
+      g_tree_remove(prov->frames_shift_offsets, fd);
+    return;
+  }
+
+  if (!prov->frames_shift_offsets)
+    prov->frames_shift_offsets = g_tree_new_full(frame_cmp, NULL, NULL, g_free);
+
+  shift_copy = g_new(nstime_t, 1);
+  nstime_copy(shift_copy, shift_offset);
+  g_tree_replace(prov->frames_shift_offsets, fd, shift_copy);
+}
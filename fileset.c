@@ -319,6 +319,32 @@ fileset_add_dir(const char *fname, void *window)
 }
 
 
+/* get the full names of all files in the set, in sort order */
+char **
+fileset_get_fullname_list(void)
+{
+    char        **list;
+    guint         count;
+    guint         i;
+    GList        *le;
+
+
+    count = g_list_length(set.entries);
+    if(count == 0) {
+        return NULL;
+    }
+
+    list = g_new(char *, count + 1);
+    i = 0;
+    for(le = g_list_first(set.entries); le; le = g_list_next(le)) {
+        list[i++] = g_strdup(((fileset_entry *)le->data)->fullname);
+    }
+    list[i] = NULL;
+
+    return list;
+}
+
+
 /* get current directory name */
 const char *
 fileset_get_dirname(void)
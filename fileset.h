@@ -35,6 +35,15 @@ extern void fileset_delete(void);
 /* get the current directory name */
 extern const char *fileset_get_dirname(void);
 
+/**
+ * Get the full names of all files in the set, in sort order, e.g. to
+ * open the whole set as one virtual capture with wtap_chain_open_offline().
+ *
+ * @return a NULL-terminated vector of names, to be freed with g_strfreev(),
+ * or NULL if the set is empty.
+ */
+extern char **fileset_get_fullname_list(void);
+
 extern fileset_entry *fileset_get_next(void);
 extern fileset_entry *fileset_get_previous(void);
 
@@ -0,0 +1,537 @@
+/* frame_index.c
+ * Sidecar frame-table index for capture files
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+#define WS_LOG_DOMAIN LOG_DOMAIN_CAPTURE
+
+#include <string.h>
+#include <stdio.h>
+
+#include <glib.h>
+
+#include <wsutil/file_util.h>
+#include <wsutil/wslog.h>
+
+#include <epan/frame_data.h>
+#include <epan/frame_data_sequence.h>
+#include <epan/epan_dissect.h>
+#include <epan/proto.h>
+
+#include "frame_index.h"
+
+/*
+ * The index is written in host byte order; the magic number doubles as
+ * an endianness check, so an index copied between hosts of different
+ * byte order is simply rejected and rebuilt.
+ */
+#define FRAME_INDEX_MAGIC   0x57534958  /* "WSIX" */
+#define FRAME_INDEX_VERSION 1
+
+#define FRAME_INDEX_SUFFIX  ".wsidx"
+
+typedef struct {
+  guint32 magic;
+  guint32 version;
+  gint64  cap_size;     /* size of the capture file when indexed */
+  gint64  cap_mtime;    /* mtime of the capture file when indexed */
+  guint32 count;        /* number of frame entries that follow */
+  guint32 n_postings;   /* number of field postings lists after the entries
+                           (0 in indexes written without field postings) */
+} frame_index_header_t;
+
+typedef struct {
+  gint64  file_off;
+  gint64  ts_secs;
+  gint32  ts_nsecs;
+  guint32 pkt_len;
+  guint32 cap_len;
+  guint32 cum_bytes;
+  guint32 flags;        /* see FIF_* below */
+} frame_index_entry_t;
+
+#define FIF_HAS_TS      0x00000001
+#define FIF_ENCODING    0x00000002  /* PACKET_CHAR_ENC_CHAR_EBCDIC */
+#define FIF_TSPREC_SHIFT 8
+#define FIF_TSPREC_MASK  0x00000f00
+
+static gchar *
+frame_index_filename(const capture_file *cf)
+{
+  return g_strconcat(cf->filename, FRAME_INDEX_SUFFIX, NULL);
+}
+
+/*
+ * Get the fingerprint of the capture file itself, for validating an
+ * index against it.  Returns FALSE if the file can't be stat'ed.
+ */
+static gboolean
+frame_index_fingerprint(const capture_file *cf, gint64 *size, gint64 *mtime)
+{
+  ws_statb64 statb;
+
+  if (ws_stat64(cf->filename, &statb) < 0)
+    return FALSE;
+  *size = statb.st_size;
+  *mtime = (gint64)statb.st_mtime;
+  return TRUE;
+}
+
+/*
+ * Field postings: per field abbrev, the sorted list of frame numbers the
+ * field appeared in during pass one.  On disk each list is a
+ * length-prefixed abbrev followed by a count and the frame numbers
+ * delta-coded as 7-bit varints; existence filters hit short, dense
+ * lists, so the deltas are mostly single bytes.  A dependency section
+ * (frame number -> depended-upon frame numbers, same coding) follows so
+ * that replaying a postings answer can mark depended frames the way a
+ * real filter pass would.
+ */
+
+#define POSTINGS_MAX_ABBREV 512   /* sanity bound when reading */
+
+static void
+postings_garray_free(gpointer data)
+{
+  g_array_free((GArray *)data, TRUE);
+}
+
+static gboolean
+postings_write_varint(FILE *fh, guint32 v)
+{
+  guint8 buf[5];
+  guint  n = 0;
+
+  do {
+    buf[n] = v & 0x7f;
+    v >>= 7;
+    if (v != 0)
+      buf[n] |= 0x80;
+    n++;
+  } while (v != 0);
+  return fwrite(buf, n, 1, fh) == 1;
+}
+
+static gboolean
+postings_read_varint(FILE *fh, guint32 *v)
+{
+  guint  shift = 0;
+  int    c;
+
+  *v = 0;
+  do {
+    c = getc(fh);
+    if (c == EOF || shift > 28)
+      return FALSE;
+    *v |= (guint32)(c & 0x7f) << shift;
+    shift += 7;
+  } while (c & 0x80);
+  return TRUE;
+}
+
+/*
+ * Read a delta-coded frame-number list into a new GArray, or return
+ * NULL on a malformed or truncated list.
+ */
+static GArray *
+postings_read_list(FILE *fh, guint32 n_frames, guint32 max_frame)
+{
+  GArray  *frames;
+  guint32  i, delta, prev = 0;
+
+  frames = g_array_sized_new(FALSE, FALSE, sizeof(guint32), n_frames);
+  for (i = 0; i < n_frames; i++) {
+    if (!postings_read_varint(fh, &delta) ||
+        delta > max_frame - prev) {
+      g_array_free(frames, TRUE);
+      return NULL;
+    }
+    prev += delta;
+    g_array_append_val(frames, prev);
+  }
+  return frames;
+}
+
+static gboolean
+postings_write_list(FILE *fh, const GArray *frames)
+{
+  guint32 i, prev = 0, num;
+
+  for (i = 0; i < frames->len; i++) {
+    num = g_array_index(frames, guint32, i);
+    if (!postings_write_varint(fh, num - prev))
+      return FALSE;
+    prev = num;
+  }
+  return TRUE;
+}
+
+gboolean
+frame_index_postings_wanted(void)
+{
+  const gchar *val = g_getenv("WIRESHARK_FIELD_INDEX");
+
+  return val != NULL && *val != '\0';
+}
+
+gboolean
+frame_index_wanted(void)
+{
+  const gchar *val = g_getenv("WIRESHARK_FRAME_INDEX");
+
+  /* Postings only exist inside the sidecar, so asking for them asks
+     for the sidecar, too. */
+  if (frame_index_postings_wanted())
+    return TRUE;
+  return val != NULL && *val != '\0';
+}
+
+void
+frame_index_postings_begin(capture_file *cf)
+{
+  frame_index_postings_free(cf);
+  cf->field_postings = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                             g_free, postings_garray_free);
+  cf->frame_dependencies = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                                 NULL, postings_garray_free);
+  cf->postings_collecting = TRUE;
+}
+
+typedef struct {
+  capture_file *cf;
+  guint32       num;
+} postings_walk_t;
+
+static void
+postings_add_node(proto_node *node, gpointer data)
+{
+  postings_walk_t *walk = (postings_walk_t *)data;
+  field_info      *fi = PNODE_FINFO(node);
+  GArray          *frames;
+
+  if (fi != NULL && fi->hfinfo != NULL && fi->hfinfo->abbrev != NULL) {
+    frames = (GArray *)g_hash_table_lookup(walk->cf->field_postings,
+                                           fi->hfinfo->abbrev);
+    if (frames == NULL) {
+      frames = g_array_new(FALSE, FALSE, sizeof(guint32));
+      g_hash_table_insert(walk->cf->field_postings,
+                          g_strdup(fi->hfinfo->abbrev), frames);
+    }
+    /* The walk visits fields in frame order, so duplicates within a
+       frame are always adjacent. */
+    if (frames->len == 0 ||
+        g_array_index(frames, guint32, frames->len - 1) != walk->num)
+      g_array_append_val(frames, walk->num);
+  }
+  proto_tree_children_foreach(node, postings_add_node, data);
+}
+
+static gint
+postings_guint32_cmp(gconstpointer a, gconstpointer b)
+{
+  guint32 ua = *(const guint32 *)a;
+  guint32 ub = *(const guint32 *)b;
+
+  return ua < ub ? -1 : (ua > ub ? 1 : 0);
+}
+
+void
+frame_index_postings_add(capture_file *cf, struct epan_dissect *edt)
+{
+  postings_walk_t  walk;
+  GArray          *deps;
+  GSList          *entry;
+  guint32          dep;
+
+  walk.cf = cf;
+  walk.num = edt->pi.num;
+  proto_tree_children_foreach(edt->tree, postings_add_node, &walk);
+
+  if (edt->pi.dependent_frames != NULL) {
+    deps = g_array_new(FALSE, FALSE, sizeof(guint32));
+    for (entry = edt->pi.dependent_frames; entry != NULL;
+         entry = entry->next) {
+      dep = GPOINTER_TO_UINT(entry->data);
+      g_array_append_val(deps, dep);
+    }
+    g_array_sort(deps, postings_guint32_cmp);
+    g_hash_table_insert(cf->frame_dependencies,
+                        GUINT_TO_POINTER(walk.num), deps);
+  }
+}
+
+void
+frame_index_postings_free(capture_file *cf)
+{
+  if (cf->field_postings != NULL) {
+    g_hash_table_destroy(cf->field_postings);
+    cf->field_postings = NULL;
+  }
+  if (cf->frame_dependencies != NULL) {
+    g_hash_table_destroy(cf->frame_dependencies);
+    cf->frame_dependencies = NULL;
+  }
+  cf->postings_collecting = FALSE;
+}
+
+/*
+ * Read the postings and dependency sections that follow the frame
+ * entries.  Failure here is not fatal to the frame table, which has
+ * already been loaded; we just go on without postings.
+ */
+static void
+frame_index_load_postings(capture_file *cf, FILE *fh, guint32 n_postings,
+                          guint32 max_frame)
+{
+  GHashTable *postings, *deps;
+  GArray     *frames;
+  gchar      *abbrev;
+  guint32     i, len, n_frames, n_dep_records, frame_num;
+
+  postings = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                   g_free, postings_garray_free);
+  deps = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                               NULL, postings_garray_free);
+
+  for (i = 0; i < n_postings; i++) {
+    if (fread(&len, sizeof len, 1, fh) != 1 ||
+        len == 0 || len > POSTINGS_MAX_ABBREV)
+      goto fail;
+    abbrev = (gchar *)g_malloc(len + 1);
+    if (fread(abbrev, len, 1, fh) != 1) {
+      g_free(abbrev);
+      goto fail;
+    }
+    abbrev[len] = '\0';
+    if (fread(&n_frames, sizeof n_frames, 1, fh) != 1 ||
+        n_frames > max_frame ||
+        (frames = postings_read_list(fh, n_frames, max_frame)) == NULL) {
+      g_free(abbrev);
+      goto fail;
+    }
+    g_hash_table_insert(postings, abbrev, frames);
+  }
+
+  if (fread(&n_dep_records, sizeof n_dep_records, 1, fh) != 1 ||
+      n_dep_records > max_frame)
+    goto fail;
+  for (i = 0; i < n_dep_records; i++) {
+    if (fread(&frame_num, sizeof frame_num, 1, fh) != 1 ||
+        frame_num == 0 || frame_num > max_frame ||
+        fread(&n_frames, sizeof n_frames, 1, fh) != 1 ||
+        n_frames > max_frame ||
+        (frames = postings_read_list(fh, n_frames, max_frame)) == NULL)
+      goto fail;
+    g_hash_table_insert(deps, GUINT_TO_POINTER(frame_num), frames);
+  }
+
+  cf->field_postings = postings;
+  cf->frame_dependencies = deps;
+  ws_info("Loaded field postings for \"%s\" (%u fields)", cf->filename,
+          n_postings);
+  return;
+
+fail:
+  ws_warning("Field postings for \"%s\" are malformed; ignoring them",
+             cf->filename);
+  g_hash_table_destroy(postings);
+  g_hash_table_destroy(deps);
+}
+
+typedef struct {
+  FILE     *fh;
+  gboolean  ok;
+} postings_save_t;
+
+static void
+frame_index_save_posting(gpointer key, gpointer value, gpointer user_data)
+{
+  postings_save_t *save = (postings_save_t *)user_data;
+  const gchar     *abbrev = (const gchar *)key;
+  const GArray    *frames = (const GArray *)value;
+  guint32          len = (guint32)strlen(abbrev);
+  guint32          n_frames = frames->len;
+
+  if (!save->ok)
+    return;
+  save->ok = fwrite(&len, sizeof len, 1, save->fh) == 1 &&
+             fwrite(abbrev, len, 1, save->fh) == 1 &&
+             fwrite(&n_frames, sizeof n_frames, 1, save->fh) == 1 &&
+             postings_write_list(save->fh, frames);
+}
+
+static void
+frame_index_save_dependency(gpointer key, gpointer value, gpointer user_data)
+{
+  postings_save_t *save = (postings_save_t *)user_data;
+  guint32          frame_num = GPOINTER_TO_UINT(key);
+  const GArray    *frames = (const GArray *)value;
+  guint32          n_frames = frames->len;
+
+  if (!save->ok)
+    return;
+  save->ok = fwrite(&frame_num, sizeof frame_num, 1, save->fh) == 1 &&
+             fwrite(&n_frames, sizeof n_frames, 1, save->fh) == 1 &&
+             postings_write_list(save->fh, frames);
+}
+
+gboolean
+frame_index_load(capture_file *cf)
+{
+  gchar                *idx_name;
+  FILE                 *fh;
+  frame_index_header_t  hdr;
+  frame_index_entry_t   entry;
+  frame_data            fdata;
+  gint64                cap_size, cap_mtime;
+  guint32               i;
+
+  if (!frame_index_wanted())
+    return FALSE;
+  if (cf->is_tempfile || cf->rfcode != NULL)
+    return FALSE;
+  if (!frame_index_fingerprint(cf, &cap_size, &cap_mtime))
+    return FALSE;
+
+  idx_name = frame_index_filename(cf);
+  fh = ws_fopen(idx_name, "rb");
+  g_free(idx_name);
+  if (fh == NULL)
+    return FALSE;
+
+  if (fread(&hdr, sizeof hdr, 1, fh) != 1 ||
+      hdr.magic != FRAME_INDEX_MAGIC ||
+      hdr.version != FRAME_INDEX_VERSION ||
+      hdr.cap_size != cap_size ||
+      hdr.cap_mtime != cap_mtime) {
+    fclose(fh);
+    return FALSE;
+  }
+
+  for (i = 0; i < hdr.count; i++) {
+    if (fread(&entry, sizeof entry, 1, fh) != 1) {
+      /* Truncated index; throw away what we read and start over with
+         an empty frame table. */
+      ws_warning("Frame index for \"%s\" is truncated; ignoring it",
+                 cf->filename);
+      fclose(fh);
+      free_frame_data_sequence(cf->provider.frames);
+      cf->provider.frames = new_frame_data_sequence();
+      return FALSE;
+    }
+    memset(&fdata, 0, sizeof fdata);
+    fdata.num = i + 1;
+    fdata.file_off = entry.file_off;
+    fdata.pkt_len = entry.pkt_len;
+    fdata.cap_len = entry.cap_len;
+    fdata.cum_bytes = entry.cum_bytes;
+    fdata.abs_ts.secs = (time_t)entry.ts_secs;
+    fdata.abs_ts.nsecs = entry.ts_nsecs;
+    fdata.has_ts = (entry.flags & FIF_HAS_TS) ? 1 : 0;
+    fdata.encoding = (entry.flags & FIF_ENCODING) ? 1 : 0;
+    fdata.tsprec = (entry.flags & FIF_TSPREC_MASK) >> FIF_TSPREC_SHIFT;
+    frame_data_sequence_add(cf->provider.frames, &fdata);
+  }
+
+  if (hdr.n_postings > 0)
+    frame_index_load_postings(cf, fh, hdr.n_postings, hdr.count);
+  fclose(fh);
+
+  cf->frames_preloaded = TRUE;
+  ws_info("Loaded frame index for \"%s\" (%u frames)", cf->filename,
+          hdr.count);
+  return TRUE;
+}
+
+void
+frame_index_save(capture_file *cf)
+{
+  gchar                *idx_name;
+  FILE                 *fh;
+  frame_index_header_t  hdr;
+  frame_index_entry_t   entry;
+  frame_data           *fdata;
+  postings_save_t       save;
+  guint32               i, n_dep_records;
+
+  if (!frame_index_wanted())
+    return;
+  if (cf->is_tempfile || cf->rfcode != NULL)
+    return;
+
+  memset(&hdr, 0, sizeof hdr);
+  hdr.magic = FRAME_INDEX_MAGIC;
+  hdr.version = FRAME_INDEX_VERSION;
+  hdr.count = cf->count;
+  if (cf->field_postings != NULL)
+    hdr.n_postings = g_hash_table_size(cf->field_postings);
+  if (!frame_index_fingerprint(cf, &hdr.cap_size, &hdr.cap_mtime))
+    return;
+
+  idx_name = frame_index_filename(cf);
+  fh = ws_fopen(idx_name, "wb");
+  if (fh == NULL) {
+    /* The capture's directory may simply not be writable; the index is
+       only a cache, so don't complain. */
+    g_free(idx_name);
+    return;
+  }
+
+  if (fwrite(&hdr, sizeof hdr, 1, fh) != 1)
+    goto fail;
+  for (i = 1; i <= cf->count; i++) {
+    fdata = frame_data_sequence_find(cf->provider.frames, i);
+    memset(&entry, 0, sizeof entry);
+    entry.file_off = fdata->file_off;
+    entry.ts_secs = (gint64)fdata->abs_ts.secs;
+    entry.ts_nsecs = fdata->abs_ts.nsecs;
+    entry.pkt_len = fdata->pkt_len;
+    entry.cap_len = fdata->cap_len;
+    entry.cum_bytes = fdata->cum_bytes;
+    entry.flags = (fdata->has_ts ? FIF_HAS_TS : 0) |
+                  (fdata->encoding ? FIF_ENCODING : 0) |
+                  ((fdata->tsprec << FIF_TSPREC_SHIFT) & FIF_TSPREC_MASK);
+    if (fwrite(&entry, sizeof entry, 1, fh) != 1)
+      goto fail;
+  }
+
+  if (hdr.n_postings > 0) {
+    save.fh = fh;
+    save.ok = TRUE;
+    g_hash_table_foreach(cf->field_postings, frame_index_save_posting, &save);
+    n_dep_records = g_hash_table_size(cf->frame_dependencies);
+    if (save.ok)
+      save.ok = fwrite(&n_dep_records, sizeof n_dep_records, 1, fh) == 1;
+    g_hash_table_foreach(cf->frame_dependencies, frame_index_save_dependency,
+                         &save);
+    if (!save.ok)
+      goto fail;
+  }
+  fclose(fh);
+  g_free(idx_name);
+  return;
+
+fail:
+  fclose(fh);
+  ws_unlink(idx_name);
+  g_free(idx_name);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 2
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=2 tabstop=8 expandtab:
+ * :indentSize=2:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,114 @@
+/* frame_index.h
+ * Sidecar frame-table index for capture files
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __FRAME_INDEX_H__
+#define __FRAME_INDEX_H__
+
+#include "cfile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * A frame index is a sidecar file ("<capture>.wsidx") holding the frame
+ * table of a capture file: per-frame offsets, lengths, timestamps and
+ * related metadata that the first sequential pass otherwise recomputes
+ * from every record.  The index is strictly opt-in: nothing is written
+ * or read unless the WIRESHARK_FRAME_INDEX environment variable is set
+ * (WIRESHARK_FIELD_INDEX, below, implies it), since writing sidecar
+ * files next to every capture a user opens is wrong for read-only
+ * media, evidence folders and shared archives.  It is only written and
+ * used for a file opened without a read filter, and it is validated
+ * against the capture file's size and modification time before being
+ * trusted.
+ *
+ * Loading an index does not replace the first-pass dissection - protocol
+ * state (conversations, reassembly) and column text still require it -
+ * but it lets that pass reuse the stored frame metadata instead of
+ * rebuilding the frame table record by record.
+ *
+ * When the WIRESHARK_FIELD_INDEX environment variable is set, the index
+ * additionally carries per-field postings lists: for every field abbrev
+ * that appeared during pass one, the (delta-coded) list of frame numbers
+ * containing it, plus each frame's depended-upon frames.  A later
+ * existence filter ("http.response") can then be answered entirely from
+ * the postings without re-reading or re-dissecting any frame.  Postings
+ * are collected only on a full first pass, so opening a file whose index
+ * predates the setting requires deleting the sidecar to rebuild it.
+ */
+
+/**
+ * TRUE if the user asked for the sidecar index to be used and kept up
+ * to date (WIRESHARK_FRAME_INDEX or WIRESHARK_FIELD_INDEX is set in
+ * the environment).
+ */
+extern gboolean frame_index_wanted(void);
+
+/**
+ * Try to populate cf->provider.frames from a sidecar index for
+ * cf->filename.  Returns TRUE, and sets cf->frames_preloaded, if a
+ * valid index was found and loaded; returns FALSE (leaving the empty
+ * frame table untouched) otherwise.  Does nothing unless
+ * frame_index_wanted().
+ */
+extern gboolean frame_index_load(capture_file *cf);
+
+/**
+ * Write a sidecar index for cf->filename from the fully-populated
+ * frame table.  Failures are not fatal; the index is a pure cache.
+ * Does nothing unless frame_index_wanted().
+ */
+extern void frame_index_save(capture_file *cf);
+
+struct epan_dissect;
+
+/**
+ * TRUE if the user asked for field postings to be built and saved
+ * (WIRESHARK_FIELD_INDEX is set in the environment).
+ */
+extern gboolean frame_index_postings_wanted(void);
+
+/**
+ * Prepare cf->field_postings and cf->frame_dependencies for collection
+ * and set cf->postings_collecting.
+ */
+extern void frame_index_postings_begin(capture_file *cf);
+
+/**
+ * Record the fields present in a freshly dissected frame, and the
+ * frames it depends on, in the postings tables.
+ */
+extern void frame_index_postings_add(capture_file *cf,
+                                     struct epan_dissect *edt);
+
+/**
+ * Discard the postings tables (if any) and clear the collection flag.
+ */
+extern void frame_index_postings_free(capture_file *cf);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __FRAME_INDEX_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 2
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=2 tabstop=8 expandtab:
+ * :indentSize=2:tabSize=8:noTabs=true:
+ */
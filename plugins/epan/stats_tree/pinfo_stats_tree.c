@@ -108,19 +108,19 @@ static void ipv6_hosts_stats_tree_init(stats_tree *st) {
 	st_node_ipv6 = stats_tree_create_node(st, st_str_ipv6, 0, STAT_DT_INT, TRUE);
 }
 
-static tap_packet_status ip_hosts_stats_tree_packet(stats_tree *st, packet_info *pinfo, int st_node, const gchar *st_str) {
-	tick_stat_node(st, st_str, 0, FALSE);
+static tap_packet_status ip_hosts_stats_tree_packet(stats_tree *st, packet_info *pinfo, int st_node) {
+	tick_stat_node_id(st, st_node);
 	tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_src), st_node, FALSE);
 	tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_dst), st_node, FALSE);
 	return TAP_PACKET_REDRAW;
 }
 
 static tap_packet_status ipv4_hosts_stats_tree_packet(stats_tree *st, packet_info *pinfo, epan_dissect_t *edt _U_, const void *p _U_) {
-	return ip_hosts_stats_tree_packet(st, pinfo, st_node_ipv4, st_str_ipv4);
+	return ip_hosts_stats_tree_packet(st, pinfo, st_node_ipv4);
 }
 
 static tap_packet_status ipv6_hosts_stats_tree_packet(stats_tree *st, packet_info *pinfo, epan_dissect_t *edt _U_, const void *p _U_) {
-	return ip_hosts_stats_tree_packet(st, pinfo, st_node_ipv6, st_str_ipv6);
+	return ip_hosts_stats_tree_packet(st, pinfo, st_node_ipv6);
 }
 
 /* ip host stats_tree -- separate source and dest, test stats_tree flags */
@@ -159,24 +159,22 @@ static void ipv6_srcdst_stats_tree_init(stats_tree *st) {
 static tap_packet_status ip_srcdst_stats_tree_packet(stats_tree *st,
 						     packet_info *pinfo,
 				                     int st_node_src,
-				                     const gchar *st_str_src,
-						     int st_node_dst,
-						     const gchar *st_str_dst) {
+						     int st_node_dst) {
 	/* update source branch */
-	tick_stat_node(st, st_str_src, 0, FALSE);
+	tick_stat_node_id(st, st_node_src);
 	tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_src), st_node_src, FALSE);
 	/* update destination branch */
-	tick_stat_node(st, st_str_dst, 0, FALSE);
+	tick_stat_node_id(st, st_node_dst);
 	tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_dst), st_node_dst, FALSE);
 	return TAP_PACKET_REDRAW;
 }
 
 static tap_packet_status ipv4_srcdst_stats_tree_packet(stats_tree *st, packet_info *pinfo, epan_dissect_t *edt _U_, const void *p _U_) {
-	return ip_srcdst_stats_tree_packet(st, pinfo, st_node_ipv4_src, st_str_ipv4_src, st_node_ipv4_dst, st_str_ipv4_dst);
+	return ip_srcdst_stats_tree_packet(st, pinfo, st_node_ipv4_src, st_node_ipv4_dst);
 }
 
 static tap_packet_status ipv6_srcdst_stats_tree_packet(stats_tree *st, packet_info *pinfo, epan_dissect_t *edt _U_, const void *p _U_) {
-	return ip_srcdst_stats_tree_packet(st, pinfo, st_node_ipv6_src, st_str_ipv6_src, st_node_ipv6_dst, st_str_ipv6_dst);
+	return ip_srcdst_stats_tree_packet(st, pinfo, st_node_ipv6_src, st_node_ipv6_dst);
 }
 
 /* packet type stats_tree -- test pivot node */
@@ -222,12 +220,12 @@ static void ipv6_dsts_stats_tree_init(stats_tree *st) {
 	st_node_ipv6_dsts = stats_tree_create_node(st, st_str_ipv6_dsts, 0, STAT_DT_INT, TRUE);
 }
 
-static tap_packet_status dsts_stats_tree_packet(stats_tree *st, packet_info *pinfo, int st_node, const gchar *st_str) {
+static tap_packet_status dsts_stats_tree_packet(stats_tree *st, packet_info *pinfo, int st_node) {
 	static gchar str[128];
 	int ip_dst_node;
 	int protocol_node;
 
-	tick_stat_node(st, st_str, 0, FALSE);
+	tick_stat_node_id(st, st_node);
 	ip_dst_node = tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_dst), st_node, TRUE);
 	protocol_node = tick_stat_node(st, port_type_to_str(pinfo->ptype), ip_dst_node, TRUE);
 	g_snprintf(str, sizeof(str) - 1, "%u", pinfo->destport);
@@ -236,11 +234,11 @@ static tap_packet_status dsts_stats_tree_packet(stats_tree *st, packet_info *pin
 }
 
 static tap_packet_status ipv4_dsts_stats_tree_packet(stats_tree *st, packet_info *pinfo, epan_dissect_t *edt _U_, const void *p _U_) {
-	return dsts_stats_tree_packet(st, pinfo, st_node_ipv4_dsts, st_str_ipv4_dsts);
+	return dsts_stats_tree_packet(st, pinfo, st_node_ipv4_dsts);
 }
 
 static tap_packet_status ipv6_dsts_stats_tree_packet(stats_tree *st, packet_info *pinfo, epan_dissect_t *edt _U_, const void *p _U_) {
-	return dsts_stats_tree_packet(st, pinfo, st_node_ipv6_dsts, st_str_ipv6_dsts);
+	return dsts_stats_tree_packet(st, pinfo, st_node_ipv6_dsts);
 }
 
 /* packet length stats_tree -- test range node */
@@ -265,7 +263,7 @@ static void plen_stats_tree_init(stats_tree *st) {
 }
 
 static tap_packet_status plen_stats_tree_packet(stats_tree *st, packet_info *pinfo, epan_dissect_t *edt _U_, const void *p _U_) {
-	tick_stat_node(st, st_str_plen, 0, FALSE);
+	tick_stat_node_id(st, st_node_plen);
 
 	stats_tree_tick_range(st, st_str_plen, 0, pinfo->fd->pkt_len);
 
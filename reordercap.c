@@ -29,12 +29,15 @@
 #endif
 
 #include <wiretap/wtap.h>
+#include <wiretap/merge.h>
 
 #include <ui/cmdarg_err.h>
 #include <ui/exit_codes.h>
 #include <wsutil/filesystem.h>
 #include <wsutil/file_util.h>
 #include <wsutil/privileges.h>
+#include <wsutil/strtoi.h>
+#include <wsutil/tempfile.h>
 #include <cli_main.h>
 #include <ui/version_info.h>
 #include <wiretap/wtap_opttypes.h>
@@ -60,6 +63,10 @@ print_usage(FILE *output)
     fprintf(output, "\n");
     fprintf(output, "Options:\n");
     fprintf(output, "  -n        don't write to output file if the input file is ordered.\n");
+    fprintf(output, "  -M <limit> keep at most <limit> MB of frames in memory; the input is\n");
+    fprintf(output, "            sorted in runs of that size, which are written to temporary\n");
+    fprintf(output, "            files and merged into the output file. Use this for input\n");
+    fprintf(output, "            files that are too large to index in memory.\n");
     fprintf(output, "  -h        display this help and exit.\n");
     fprintf(output, "  -v        print version information and exit.\n");
 }
@@ -72,6 +79,12 @@ typedef struct FrameRecord_t {
     nstime_t     frame_time;
 } FrameRecord_t;
 
+/* A frame held fully in memory while its sorted run is collected (-M) */
+typedef struct BufferedFrame_t {
+    wtap_rec     rec;
+    Buffer       buf;
+} BufferedFrame_t;
+
 
 /**************************************************/
 /* Debugging only                                 */
@@ -141,6 +154,254 @@ frames_compare(gconstpointer a, gconstpointer b)
     return nstime_cmp(time1, time2);
 }
 
+/* Comparing timestamps between 2 frames held fully in memory.
+   Frames without a time stamp sort before all others, matching what
+   the merge step (wiretap/merge.c) does with such records. */
+static int
+buffered_frames_compare(gconstpointer a, gconstpointer b)
+{
+    const BufferedFrame_t *frame1 = *(const BufferedFrame_t *const *) a;
+    const BufferedFrame_t *frame2 = *(const BufferedFrame_t *const *) b;
+    gboolean has_ts1 = (frame1->rec.presence_flags & WTAP_HAS_TS) != 0;
+    gboolean has_ts2 = (frame2->rec.presence_flags & WTAP_HAS_TS) != 0;
+
+    if (has_ts1 != has_ts2)
+        return has_ts1 ? 1 : -1;
+    if (!has_ts1)
+        return 0;
+    return nstime_cmp(&frame1->rec.ts, &frame2->rec.ts);
+}
+
+/* Sort the collected run of frames and write it to a new temporary file,
+   whose name is appended to run_filenames.  The frames are freed and the
+   run array emptied for reuse. */
+static gboolean
+write_sorted_run(GPtrArray *run, GPtrArray *run_filenames,
+                 int file_type_subtype, const wtap_dump_params *params,
+                 const char *infile)
+{
+    gchar *run_filename = NULL;
+    GError *error = NULL;
+    int fd;
+    wtap_dumper *run_pdh;
+    int err;
+    gchar *err_info;
+    guint i;
+    gboolean ok = TRUE;
+
+    g_ptr_array_sort(run, buffered_frames_compare);
+
+    fd = create_tempfile(&run_filename, "reordercap", NULL, &error);
+    if (fd == -1) {
+        fprintf(stderr, "reordercap: Could not create temporary file: %s\n",
+                error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+    g_ptr_array_add(run_filenames, run_filename);
+
+    run_pdh = wtap_dump_fdopen(fd, file_type_subtype, WTAP_UNCOMPRESSED,
+                               params, &err, &err_info);
+    if (run_pdh == NULL) {
+        cfile_dump_open_failure_message(run_filename, err, err_info,
+                                        file_type_subtype);
+        ws_close(fd);
+        return FALSE;
+    }
+
+    for (i = 0; i < run->len; i++) {
+        BufferedFrame_t *frame = (BufferedFrame_t *)run->pdata[i];
+
+        if (ok && !wtap_dump(run_pdh, &frame->rec,
+                             ws_buffer_start_ptr(&frame->buf),
+                             &err, &err_info)) {
+            cfile_write_failure_message(infile, run_filename, err, err_info,
+                                        0, file_type_subtype);
+            ok = FALSE;
+        }
+        wtap_rec_cleanup(&frame->rec);
+        ws_buffer_free(&frame->buf);
+        g_slice_free(BufferedFrame_t, frame);
+    }
+    g_ptr_array_set_size(run, 0);
+
+    if (!wtap_dump_close(run_pdh, &err, &err_info)) {
+        cfile_close_failure_message(run_filename, err, err_info);
+        ok = FALSE;
+    }
+    return ok;
+}
+
+/* Reorder the input file using bounded memory: collect frames into runs
+   of at most run_size_limit bytes, write each run, sorted, to a
+   temporary file, and merge the runs into the output file in
+   chronological order.  All I/O is sequential. */
+static int
+reorder_with_bounded_memory(wtap *wth, const char *infile,
+                            const char *outfile,
+                            gboolean write_output_regardless,
+                            guint64 run_size_limit)
+{
+    wtap_dump_params params;
+    GPtrArray *run = g_ptr_array_new();
+    GPtrArray *run_filenames = g_ptr_array_new_with_free_func(g_free);
+    guint64 run_bytes = 0;
+    guint frame_count = 0;
+    guint wrong_order_count = 0;
+    nstime_t prev_time;
+    gboolean have_prev_time = FALSE;
+    int file_type_subtype = wtap_file_type_subtype(wth);
+    int err = 0;
+    gchar *err_info;
+    gint64 data_offset;
+    guint i;
+    int ret = EXIT_SUCCESS;
+
+    wtap_dump_params_init(&params, wth);
+
+    /* Read each frame from infile, flushing a sorted run to disk
+       whenever the memory limit is reached */
+    for (;;) {
+        BufferedFrame_t *frame = g_slice_new(BufferedFrame_t);
+
+        wtap_rec_init(&frame->rec);
+        ws_buffer_init(&frame->buf, 1514);
+        if (!wtap_read(wth, &frame->rec, &frame->buf, &err, &err_info,
+                       &data_offset)) {
+            wtap_rec_cleanup(&frame->rec);
+            ws_buffer_free(&frame->buf);
+            g_slice_free(BufferedFrame_t, frame);
+            break;
+        }
+        frame_count++;
+
+        if (frame->rec.presence_flags & WTAP_HAS_TS) {
+            if (have_prev_time &&
+                nstime_cmp(&frame->rec.ts, &prev_time) < 0) {
+                wrong_order_count++;
+            }
+            prev_time = frame->rec.ts;
+            have_prev_time = TRUE;
+        }
+
+        g_ptr_array_add(run, frame);
+        run_bytes += sizeof(BufferedFrame_t) + ws_buffer_length(&frame->buf);
+        if (run_bytes >= run_size_limit) {
+            if (!write_sorted_run(run, run_filenames, file_type_subtype,
+                                  &params, infile)) {
+                ret = OUTPUT_FILE_ERROR;
+                goto clean_up;
+            }
+            run_bytes = 0;
+        }
+    }
+    if (err != 0) {
+      /* Print a message noting that the read failed somewhere along the line. */
+      cfile_read_failure_message(infile, err, err_info);
+    }
+
+    printf("%u frames, %u out of order\n", frame_count, wrong_order_count);
+
+    /* Avoid writing if already sorted and configured to */
+    if (!write_output_regardless && (wrong_order_count == 0)) {
+        printf("Not writing output file because input file is already in order.\n");
+        goto clean_up;
+    }
+
+    /* Write the final run, even if it's empty; that way the merge below
+       always has at least one input and produces an output file with
+       the proper headers even for an empty input file. */
+    if (run->len > 0 || run_filenames->len == 0) {
+        if (!write_sorted_run(run, run_filenames, file_type_subtype,
+                              &params, infile)) {
+            ret = OUTPUT_FILE_ERROR;
+            goto clean_up;
+        }
+    }
+
+    /* Merge the sorted runs into the output file */
+    {
+        const char *const *in_filenames = (const char *const *)run_filenames->pdata;
+        merge_result m;
+        guint err_fileno = 0;
+        guint32 err_framenum = 0;
+
+        if (strcmp(outfile, "-") == 0) {
+          m = merge_files_to_stdout(file_type_subtype, in_filenames,
+                                    run_filenames->len, FALSE,
+                                    IDB_MERGE_MODE_ALL_SAME, 0,
+                                    get_appname_and_version(), NULL,
+                                    &err, &err_info, &err_fileno,
+                                    &err_framenum);
+        } else {
+          m = merge_files(outfile, file_type_subtype, in_filenames,
+                          run_filenames->len, FALSE,
+                          IDB_MERGE_MODE_ALL_SAME, 0,
+                          get_appname_and_version(), NULL,
+                          &err, &err_info, &err_fileno, &err_framenum);
+        }
+
+        switch (m) {
+            case MERGE_OK:
+            case MERGE_USER_ABORTED:
+                break;
+            case MERGE_ERR_CANT_OPEN_INFILE:
+                cfile_open_failure_message(in_filenames[err_fileno], err,
+                                           err_info);
+                ret = OUTPUT_FILE_ERROR;
+                break;
+            case MERGE_ERR_CANT_OPEN_OUTFILE:
+                cfile_dump_open_failure_message(outfile, err, err_info,
+                                                file_type_subtype);
+                ret = OUTPUT_FILE_ERROR;
+                break;
+            case MERGE_ERR_CANT_READ_INFILE:
+                cfile_read_failure_message(in_filenames[err_fileno], err,
+                                           err_info);
+                ret = OUTPUT_FILE_ERROR;
+                break;
+            case MERGE_ERR_BAD_PHDR_INTERFACE_ID:
+                fprintf(stderr,
+                        "reordercap: Record %u of \"%s\" has an interface ID that does not match any IDB\n",
+                        err_framenum, in_filenames[err_fileno]);
+                ret = OUTPUT_FILE_ERROR;
+                break;
+            case MERGE_ERR_CANT_WRITE_OUTFILE:
+                cfile_write_failure_message(in_filenames[err_fileno], outfile,
+                                            err, err_info, err_framenum,
+                                            file_type_subtype);
+                ret = OUTPUT_FILE_ERROR;
+                break;
+            case MERGE_ERR_CANT_CLOSE_OUTFILE:
+                cfile_close_failure_message(outfile, err, err_info);
+                ret = OUTPUT_FILE_ERROR;
+                break;
+            default:
+                ret = OUTPUT_FILE_ERROR;
+                break;
+        }
+    }
+
+clean_up:
+    for (i = 0; i < run->len; i++) {
+        BufferedFrame_t *frame = (BufferedFrame_t *)run->pdata[i];
+
+        wtap_rec_cleanup(&frame->rec);
+        ws_buffer_free(&frame->buf);
+        g_slice_free(BufferedFrame_t, frame);
+    }
+    g_ptr_array_free(run, TRUE);
+
+    /* The temporary run files are no longer needed */
+    for (i = 0; i < run_filenames->len; i++) {
+        ws_unlink((const char *)run_filenames->pdata[i]);
+    }
+    g_ptr_array_free(run_filenames, TRUE);
+
+    wtap_dump_params_cleanup(&params);
+    return ret;
+}
+
 /*
  * General errors and warnings are reported with an console message
  * in reordercap.
@@ -191,6 +452,7 @@ main(int argc, char *argv[])
     gint64 data_offset;
     guint wrong_order_count = 0;
     gboolean write_output_regardless = TRUE;
+    guint32 run_size_mb = 0;
     guint i;
     wtap_dump_params params;
     int                          ret = EXIT_SUCCESS;
@@ -241,11 +503,22 @@ main(int argc, char *argv[])
     wtap_init(TRUE);
 
     /* Process the options first */
-    while ((opt = getopt_long(argc, argv, "hnv", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "hnM:v", long_options, NULL)) != -1) {
         switch (opt) {
             case 'n':
                 write_output_regardless = FALSE;
                 break;
+            case 'M':
+                if (!ws_strtou32(optarg, NULL, &run_size_mb) ||
+                    run_size_mb == 0) {
+                    fprintf(stderr,
+                            "reordercap: \"%s\" isn't a valid memory limit in MB\n",
+                            optarg);
+                    print_usage(stderr);
+                    ret = INVALID_OPTION;
+                    goto clean_exit;
+                }
+                break;
             case 'h':
                 show_help_header("Reorder timestamps of input file frames into output file.");
                 print_usage(stdout);
@@ -283,6 +556,16 @@ main(int argc, char *argv[])
     }
     DEBUG_PRINT("file_type_subtype is %d\n", wtap_file_type_subtype(wth));
 
+    /* With a memory limit, sort via temporary sorted runs rather than
+       indexing the whole file and seek-reading it in sorted order. */
+    if (run_size_mb != 0) {
+        ret = reorder_with_bounded_memory(wth, infile, outfile,
+                                          write_output_regardless,
+                                          (guint64)run_size_mb * 1024 * 1024);
+        wtap_close(wth);
+        goto clean_exit;
+    }
+
     wtap_dump_params_init(&params, wth);
 
     /* Open outfile (same filetype/encap as input file) */
@@ -52,6 +52,7 @@
 #endif
 
 #include "ringbuffer.h"
+#include <ws_attributes.h>
 #include <wsutil/file_util.h>
 
 #ifdef HAVE_ZLIB
@@ -81,12 +82,31 @@ typedef struct _ringbuf_data {
   FILE         *name_h;              /**< write names of completed files to this handle */
   gchar        *compress_type;       /**< compress type */
 
-  GMutex        mutex;               /**< mutex for oldnames */
+  GMutex        mutex;               /**< mutex for oldnames and the pre-opened next file */
   gchar        *oldnames[MAX_FILENAME_QUEUE];       /**< filename list of pending to be deleted */
+
+  GThread      *finalizer_thread;    /**< finalizes switched-out files off the capture loop */
+  GAsyncQueue  *finalize_q;          /**< queue of rb_finalize_job, ended by a stop sentinel */
+  int           next_fd;             /**< pre-opened fd for the next ring file, or -1 */
+  gchar        *next_name;           /**< name of the pre-opened next file */
 } ringbuf_data;
 
 static ringbuf_data rb_data;
 
+/** A switched-out file handed to the finalizer thread. The flush, close,
+    name reporting and recycling of the ring slot's old file all happen
+    there, so that the capture loop only swaps descriptors at rotation. */
+typedef struct _rb_finalize_job {
+  FILE         *pdh;                 /**< file to flush and close, or NULL */
+  char         *io_buffer;           /**< its IO buffer, freed after the close */
+  gchar        *written_name;        /**< completed file to report to name_h, or NULL */
+  gchar        *delete_name;         /**< recycled file to delete, or NULL */
+  gchar        *compress_name;       /**< completed file to compress, or NULL */
+  gchar        *prepare_name;        /**< file to pre-open for the next switch, or NULL */
+} rb_finalize_job;
+
+static rb_finalize_job finalize_stop_job;
+
 /*
  * delete pending uncompressed pcap files.
  */
@@ -201,15 +221,36 @@ static int ringbuf_start_compress_file(rb_file* rfile)
 }
 
 /*
- * create the next filename and open a new binary file with that name
+ * create the filename for the ringbuffer file with the given (printed) number,
+ * carrying the current time
  */
-static int ringbuf_open_file(rb_file *rfile, int *err)
+static gchar *ringbuf_make_name(guint file_num)
 {
   char    filenum[5+1];
   char    timestr[14+1];
   time_t  current_time;
   struct tm *tm;
 
+#ifdef _WIN32
+  _tzset();
+#endif
+  current_time = time(NULL);
+
+  g_snprintf(filenum, sizeof(filenum), "%05u", file_num % RINGBUFFER_MAX_NUM_FILES);
+  tm = localtime(&current_time);
+  if (tm != NULL)
+    strftime(timestr, sizeof(timestr), "%Y%m%d%H%M%S", tm);
+  else
+    (void) g_strlcpy(timestr, "196912312359", sizeof(timestr)); /* second before the Epoch */
+  return g_strconcat(rb_data.fprefix, "_", filenum, "_", timestr,
+                     rb_data.fsuffix, NULL);
+}
+
+/*
+ * create the next filename and open a new binary file with that name
+ */
+static int ringbuf_open_file(rb_file *rfile, int *err)
+{
   if (rfile->name != NULL) {
     if (rb_data.unlimited == FALSE) {
       /* remove old file (if any, so ignore error) */
@@ -221,19 +262,7 @@ static int ringbuf_open_file(rb_file *rfile, int *err)
     g_free(rfile->name);
   }
 
-#ifdef _WIN32
-  _tzset();
-#endif
-  current_time = time(NULL);
-
-  g_snprintf(filenum, sizeof(filenum), "%05u", (rb_data.curr_file_num + 1) % RINGBUFFER_MAX_NUM_FILES);
-  tm = localtime(&current_time);
-  if (tm != NULL)
-    strftime(timestr, sizeof(timestr), "%Y%m%d%H%M%S", tm);
-  else
-    (void) g_strlcpy(timestr, "196912312359", sizeof(timestr)); /* second before the Epoch */
-  rfile->name = g_strconcat(rb_data.fprefix, "_", filenum, "_", timestr,
-                            rb_data.fsuffix, NULL);
+  rfile->name = ringbuf_make_name(rb_data.curr_file_num + 1);
 
   if (rfile->name == NULL) {
     if (err != NULL)
@@ -251,6 +280,95 @@ static int ringbuf_open_file(rb_file *rfile, int *err)
   return rb_data.fd;
 }
 
+/*
+ * thread that finalizes switched-out files: flushes and closes them,
+ * reports their names, recycles the old file of the reused ring slot and
+ * pre-opens the file for the next switch. Queue order matches switch
+ * order, so completed names are reported in sequence.
+ */
+static void* ringbuf_finalizer_thread(void* arg _U_)
+{
+  rb_finalize_job *job;
+
+  while ((job = (rb_finalize_job *)g_async_queue_pop(rb_data.finalize_q)) != &finalize_stop_job) {
+    if (job->pdh != NULL) {
+      /* Errors can no longer be reported back to the capture loop at
+         this point; as with the compression thread, the file is left
+         as complete as the flush got it. */
+      fclose(job->pdh);
+    }
+    g_free(job->io_buffer);
+    if (job->written_name != NULL) {
+      if (rb_data.name_h != NULL) {
+        fprintf(rb_data.name_h, "%s\n", job->written_name);
+        fflush(rb_data.name_h);
+      }
+      g_free(job->written_name);
+    }
+    if (job->delete_name != NULL) {
+      /* remove old file (if any, so ignore error) */
+      ws_unlink(job->delete_name);
+      g_free(job->delete_name);
+    }
+    if (job->compress_name != NULL) {
+      /* the file is closed by now, so it's safe to compress it */
+      g_thread_new("exec_compress", &exec_compress_thread, job->compress_name);
+    }
+    if (job->prepare_name != NULL) {
+      int fd = ws_open(job->prepare_name, O_RDWR|O_BINARY|O_TRUNC|O_CREAT,
+                       rb_data.group_read_access ? 0640 : 0600);
+      if (fd == -1) {
+        /* the next switch falls back to opening the file itself */
+        g_free(job->prepare_name);
+      } else {
+        g_mutex_lock(&rb_data.mutex);
+        if (rb_data.next_fd != -1) {
+          /* a previously prepared file was never taken (the capture
+             loop fell back to opening one itself); replace it */
+          ws_close(rb_data.next_fd);
+          ws_unlink(rb_data.next_name);
+          g_free(rb_data.next_name);
+        }
+        rb_data.next_fd = fd;
+        rb_data.next_name = job->prepare_name;
+        g_mutex_unlock(&rb_data.mutex);
+      }
+    }
+    g_free(job);
+  }
+  return NULL;
+}
+
+/*
+ * drain the finalizer queue and stop the thread
+ */
+static void ringbuf_finalizer_stop(void)
+{
+  if (rb_data.finalizer_thread != NULL) {
+    g_async_queue_push(rb_data.finalize_q, &finalize_stop_job);
+    g_thread_join(rb_data.finalizer_thread);
+    rb_data.finalizer_thread = NULL;
+    g_async_queue_unref(rb_data.finalize_q);
+    rb_data.finalize_q = NULL;
+  }
+}
+
+/*
+ * discard a pre-opened next file that was never switched to
+ */
+static void ringbuf_discard_prepared_file(void)
+{
+  if (rb_data.next_fd != -1) {
+    ws_close(rb_data.next_fd);
+    rb_data.next_fd = -1;
+  }
+  if (rb_data.next_name != NULL) {
+    ws_unlink(rb_data.next_name);
+    g_free(rb_data.next_name);
+    rb_data.next_name = NULL;
+  }
+}
+
 /*
  * Initialize the ringbuffer data structures
  */
@@ -272,6 +390,10 @@ ringbuf_init(const char *capfile_name, guint num_files, gboolean group_read_acce
   rb_data.group_read_access = group_read_access;
   rb_data.name_h = NULL;
   rb_data.compress_type = compress_type;
+  rb_data.finalizer_thread = NULL;
+  rb_data.finalize_q = NULL;
+  rb_data.next_fd = -1;
+  rb_data.next_name = NULL;
   g_mutex_init(&rb_data.mutex);
 
   /* just to be sure ... */
@@ -339,6 +461,15 @@ ringbuf_init(const char *capfile_name, guint num_files, gboolean group_read_acce
     return -1;
   }
 
+  /* start the finalizer and have it pre-open the file for the first switch */
+  rb_data.finalize_q = g_async_queue_new();
+  rb_data.finalizer_thread = g_thread_new("ringbuf_finalize", &ringbuf_finalizer_thread, NULL);
+  {
+    rb_finalize_job *job = g_new0(rb_finalize_job, 1);
+    job->prepare_name = ringbuf_make_name(rb_data.curr_file_num + 2);
+    g_async_queue_push(rb_data.finalize_q, job);
+  }
+
   return rb_data.fd;
 }
 
@@ -423,37 +554,85 @@ ringbuf_switch_file(FILE **pdh, gchar **save_file, int *save_file_fd, int *err)
 {
   int     next_file_index;
   rb_file *next_rfile = NULL;
+  rb_finalize_job *job;
+  int     new_fd;
+  gchar  *new_name;
 
-  /* close current file */
+  /* hand the current file to the finalizer; the flush and close happen
+     off the capture loop, so a close error can no longer stop the
+     capture - the finalizer leaves the file as complete as it got it */
 
-  if (fclose(rb_data.pdh) == EOF) {
-    if (err != NULL) {
-      *err = errno;
-    }
-    ws_close(rb_data.fd);  /* XXX - the above should have closed this already */
-    rb_data.pdh = NULL;    /* it's still closed, we just got an error while closing */
-    rb_data.fd = -1;
-    g_free(rb_data.io_buffer);
-    rb_data.io_buffer = NULL;
-    return FALSE;
+  job = g_new0(rb_finalize_job, 1);
+  job->pdh = rb_data.pdh;
+  job->io_buffer = rb_data.io_buffer;
+  if (rb_data.name_h != NULL) {
+    job->written_name = g_strdup(ringbuf_current_filename());
   }
 
   rb_data.pdh = NULL;
   rb_data.fd  = -1;
+  rb_data.io_buffer = NULL;
 
-  if (rb_data.name_h != NULL) {
-    fprintf(rb_data.name_h, "%s\n", ringbuf_current_filename());
-    fflush(rb_data.name_h);
-  }
-
-  /* get the next file number and open it */
+  /* get the next file number and recycle the old file of its ring slot */
 
   rb_data.curr_file_num++ /* = next_file_num*/;
   next_file_index = (rb_data.curr_file_num) % rb_data.num_files;
   next_rfile = &rb_data.files[next_file_index];
 
-  if (ringbuf_open_file(next_rfile, err) == -1) {
-    return FALSE;
+  if (next_rfile->name != NULL) {
+    if (rb_data.unlimited == FALSE) {
+      /* the finalizer deletes it after the close, so that a one-file
+         ring never loses its only complete file early */
+      job->delete_name = next_rfile->name;
+    }
+    else if (rb_data.compress_type != NULL && strcmp(rb_data.compress_type, "gzip") == 0) {
+      /* compression must not start before the close has finished */
+      job->compress_name = next_rfile->name;
+    }
+    else {
+      g_free(next_rfile->name);
+    }
+    next_rfile->name = NULL;
+  }
+
+  /* have the finalizer pre-open the file for the switch after this one */
+  job->prepare_name = ringbuf_make_name(rb_data.curr_file_num + 2);
+
+  /* take the pre-opened next file, if the finalizer got around to it */
+  g_mutex_lock(&rb_data.mutex);
+  new_fd = rb_data.next_fd;
+  new_name = rb_data.next_name;
+  rb_data.next_fd = -1;
+  rb_data.next_name = NULL;
+  g_mutex_unlock(&rb_data.mutex);
+
+  g_async_queue_push(rb_data.finalize_q, job);
+
+  if (new_fd == -1) {
+    /* no pre-opened file (pre-opening failed, or the finalizer is still
+       busy with the previous file); open the next file ourselves */
+    if (ringbuf_open_file(next_rfile, err) == -1) {
+      return FALSE;
+    }
+  } else {
+    next_rfile->name = new_name;
+    rb_data.fd = new_fd;
+#ifndef _WIN32
+    /* the file was created ahead of time; rename it so that its name
+       carries the time it actually becomes the current file. On Windows
+       an open file cannot be renamed, so there it keeps the time it was
+       pre-created. */
+    new_name = ringbuf_make_name(rb_data.curr_file_num + 1);
+    if (new_name != NULL) {
+      if (strcmp(new_name, next_rfile->name) != 0 &&
+          ws_rename(next_rfile->name, new_name) == 0) {
+        g_free(next_rfile->name);
+        next_rfile->name = new_name;
+      } else {
+        g_free(new_name);
+      }
+    }
+#endif
   }
 
   if (ringbuf_init_libpcap_fdopen(err) == NULL) {
@@ -476,6 +655,12 @@ ringbuf_libpcap_dump_close(gchar **save_file, int *err)
 {
   gboolean  ret_val = TRUE;
 
+  /* finish all pending finalizations first, so that completed file names
+     have been reported in order, then remove the never-used pre-opened
+     next file */
+  ringbuf_finalizer_stop();
+  ringbuf_discard_prepared_file();
+
   /* close current file, if it's open */
   if (rb_data.pdh != NULL) {
     if (fclose(rb_data.pdh) == EOF) {
@@ -514,6 +699,9 @@ ringbuf_free(void)
 {
   unsigned int i;
 
+  ringbuf_finalizer_stop();
+  ringbuf_discard_prepared_file();
+
   if (rb_data.files != NULL) {
     for (i=0; i < rb_data.num_files; i++) {
       if (rb_data.files[i].name != NULL) {
@@ -544,6 +732,9 @@ ringbuf_error_cleanup(void)
 {
   unsigned int i;
 
+  ringbuf_finalizer_stop();
+  ringbuf_discard_prepared_file();
+
   /* try to close via wtap */
   if (rb_data.pdh != NULL) {
     if (fclose(rb_data.pdh) == 0) {
@@ -0,0 +1,421 @@
+/* session_journal.c
+ * Sidecar append-only journal for per-capture analysis session state
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+#define WS_LOG_DOMAIN LOG_DOMAIN_CAPTURE
+
+#include <string.h>
+#include <stdio.h>
+
+#include <glib.h>
+
+#include <wsutil/file_util.h>
+#include <wsutil/wslog.h>
+
+#include <epan/packet.h>
+#include <epan/decode_as.h>
+#include <epan/frame_data.h>
+#include <epan/frame_data_sequence.h>
+
+#include "file.h"
+#include "session_journal.h"
+
+/*
+ * The journal is a text file: a header line tying it to the capture
+ * file, then one record per line.  Record types:
+ *
+ *   decodeas-reset
+ *   decodeas <table>,<selector>,<initial proto>,<current proto>
+ *       A "Decode As" snapshot: a reset line followed by one line per
+ *       changed binding, in the same CSV form as the decode_as_entries
+ *       configuration file.  Each apply appends a complete snapshot, so
+ *       replay just honors the last one.
+ *
+ *   timeref <frame> <0|1>
+ *   timeref-clear
+ *       A time-reference toggle, or "Unset All Time References".
+ *       Replayed in order; the last record for a frame wins.
+ *
+ * Records are only ever appended, and everything one user action
+ * produces goes out in a single buffered write, so persisting an edit
+ * is O(1) regardless of capture size.
+ */
+#define SESSION_JOURNAL_MAGIC   "WSSJ"
+#define SESSION_JOURNAL_VERSION 1
+
+#define SESSION_JOURNAL_SUFFIX  ".wsses"
+
+static gchar *
+session_journal_filename(const capture_file *cf)
+{
+  return g_strconcat(cf->filename, SESSION_JOURNAL_SUFFIX, NULL);
+}
+
+/*
+ * Get the fingerprint of the capture file itself, for validating a
+ * journal against it.  Returns FALSE if the file can't be stat'ed.
+ */
+static gboolean
+session_journal_fingerprint(const capture_file *cf, gint64 *size,
+                            gint64 *mtime)
+{
+  ws_statb64 statb;
+
+  if (ws_stat64(cf->filename, &statb) < 0)
+    return FALSE;
+  *size = statb.st_size;
+  *mtime = (gint64)statb.st_mtime;
+  return TRUE;
+}
+
+/*
+ * Append one or more complete records (with trailing newlines) to the
+ * journal in a single write, creating the journal with a header if it
+ * doesn't exist yet.  Failures are not fatal; the state being journaled
+ * is still in effect in memory.
+ */
+static void
+session_journal_append(capture_file *cf, const gchar *records)
+{
+  gchar  *jnl_name;
+  FILE   *fh;
+  gint64  cap_size, cap_mtime;
+
+  if (cf->is_tempfile)
+    return;
+  if (!session_journal_fingerprint(cf, &cap_size, &cap_mtime))
+    return;
+
+  jnl_name = session_journal_filename(cf);
+  fh = ws_fopen(jnl_name, "ab");
+  if (fh == NULL) {
+    g_free(jnl_name);
+    return;
+  }
+
+  if (fseek(fh, 0, SEEK_END) == 0 && ftell(fh) == 0) {
+    fprintf(fh, "%s %d %" G_GINT64_FORMAT " %" G_GINT64_FORMAT "\n",
+            SESSION_JOURNAL_MAGIC, SESSION_JOURNAL_VERSION,
+            cap_size, cap_mtime);
+  }
+
+  if (fputs(records, fh) == EOF || fflush(fh) == EOF) {
+    /* A partial record would make everything after it suspect; drop the
+       whole journal and fall back to the in-memory state. */
+    fclose(fh);
+    ws_unlink(jnl_name);
+  } else {
+    fclose(fh);
+  }
+  g_free(jnl_name);
+}
+
+/*
+ * Serialize one changed dissector-table entry, in the same CSV form as
+ * decode_as_write_entry() uses for the decode_as_entries file.
+ */
+static void
+session_journal_decode_as_entry(const gchar *table_name,
+                                ftenum_t selector_type,
+                                gpointer key, gpointer value,
+                                gpointer user_data)
+{
+  GString            *records = (GString *)user_data;
+  dissector_handle_t  current, initial;
+  const gchar        *current_proto_name, *initial_proto_name;
+
+  current = dtbl_entry_get_handle((dtbl_entry_t *)value);
+  current_proto_name =
+    current ? dissector_handle_get_short_name(current) : DECODE_AS_NONE;
+  initial = dtbl_entry_get_initial_handle((dtbl_entry_t *)value);
+  initial_proto_name =
+    initial ? dissector_handle_get_short_name(initial) : DECODE_AS_NONE;
+
+  switch (selector_type) {
+
+  case FT_UINT8:
+  case FT_UINT16:
+  case FT_UINT24:
+  case FT_UINT32:
+    g_string_append_printf(records, "decodeas %s,%u,%s,%s\n",
+                           table_name, GPOINTER_TO_UINT(key),
+                           initial_proto_name, current_proto_name);
+    break;
+
+  case FT_NONE:
+    g_string_append_printf(records, "decodeas %s,0,%s,%s\n",
+                           table_name, initial_proto_name,
+                           current_proto_name);
+    break;
+
+  case FT_STRING:
+  case FT_STRINGZ:
+  case FT_UINT_STRING:
+  case FT_STRINGZPAD:
+  case FT_STRINGZTRUNC:
+    g_string_append_printf(records, "decodeas %s,%s,%s,%s\n",
+                           table_name, (gchar *)key,
+                           initial_proto_name, current_proto_name);
+    break;
+
+  default:
+    /* GUID and other selector types have no file representation; they
+       aren't in the decode_as_entries file either. */
+    break;
+  }
+}
+
+void
+session_journal_record_decode_as(capture_file *cf)
+{
+  GString *records;
+
+  if (cf->is_tempfile)
+    return;
+
+  /* A snapshot replaces whatever was journaled before, so start it with
+     a reset record; the whole group goes out in one append. */
+  records = g_string_new("decodeas-reset\n");
+  dissector_all_tables_foreach_changed(session_journal_decode_as_entry,
+                                       records);
+  session_journal_append(cf, records->str);
+  g_string_free(records, TRUE);
+}
+
+void
+session_journal_record_timeref(capture_file *cf, guint32 frame_num,
+                               gboolean set)
+{
+  gchar *record;
+
+  record = g_strdup_printf("timeref %u %d\n", frame_num, set ? 1 : 0);
+  session_journal_append(cf, record);
+  g_free(record);
+}
+
+void
+session_journal_record_timeref_clear(capture_file *cf)
+{
+  session_journal_append(cf, "timeref-clear\n");
+}
+
+/*
+ * Read and validate the journal.  Returns the journal's lines (to be
+ * freed with g_strfreev()), or NULL if there is no usable journal; a
+ * stale journal is deleted.
+ */
+static gchar **
+session_journal_load(capture_file *cf)
+{
+  gchar  *jnl_name;
+  gchar  *contents;
+  gchar **jnl_lines;
+  gint64  cap_size, cap_mtime, jnl_size, jnl_mtime;
+  int     version;
+
+  if (cf->is_tempfile)
+    return NULL;
+
+  jnl_name = session_journal_filename(cf);
+  if (!g_file_get_contents(jnl_name, &contents, NULL, NULL)) {
+    g_free(jnl_name);
+    return NULL;
+  }
+  jnl_lines = g_strsplit(contents, "\n", -1);
+  g_free(contents);
+
+  /* A journal left over from a capture file that has since been
+     rewritten or replaced is stale. */
+  if (!session_journal_fingerprint(cf, &cap_size, &cap_mtime) ||
+      jnl_lines[0] == NULL ||
+      sscanf(jnl_lines[0],
+             SESSION_JOURNAL_MAGIC " %d %" G_GINT64_MODIFIER "d %" G_GINT64_MODIFIER "d",
+             &version, &jnl_size, &jnl_mtime) != 3 ||
+      version != SESSION_JOURNAL_VERSION ||
+      jnl_size != cap_size || jnl_mtime != cap_mtime) {
+    ws_message("Session journal for \"%s\" is stale or invalid; removing it",
+               cf->filename);
+    ws_unlink(jnl_name);
+    g_strfreev(jnl_lines);
+    g_free(jnl_name);
+    return NULL;
+  }
+
+  g_free(jnl_name);
+  return jnl_lines;
+}
+
+/*
+ * Apply one journaled "decodeas" record.  This mirrors what the -d
+ * option and read_set_decode_as_entries() do with the same CSV fields;
+ * like -d, it changes the running dissector tables without touching the
+ * profile's saved "Decode As" preferences.
+ */
+static gboolean
+session_journal_apply_decode_as(const gchar *csv)
+{
+  gchar             *values[4] = {NULL, NULL, NULL, NULL};
+  const gchar       *p = csv;
+  gchar             *pch;
+  guint              i, j;
+  dissector_table_t  sub_dissectors;
+  dissector_handle_t handle;
+  ftenum_t           selector_type;
+  gboolean           applied = FALSE;
+
+  for (i = 0; i < 3; i++) {
+    pch = strchr(p, ',');
+    if (pch == NULL) {
+      for (j = 0; j < i; j++)
+        g_free(values[j]);
+      return FALSE;
+    }
+    values[i] = g_strndup(p, pch - p);
+    p = pch + 1;
+  }
+  values[3] = g_strdup(p);
+
+  sub_dissectors = find_dissector_table(values[0]);
+  if (sub_dissectors != NULL) {
+    selector_type = dissector_table_get_type(sub_dissectors);
+    handle = dissector_table_get_dissector_handle(sub_dissectors, values[3]);
+
+    if (handle != NULL || g_ascii_strcasecmp(values[3], DECODE_AS_NONE) == 0) {
+      if (IS_FT_STRING(selector_type)) {
+        dissector_change_string(values[0], values[1], handle);
+        applied = TRUE;
+      } else if (selector_type == FT_NONE) {
+        dissector_change_payload(values[0], handle);
+        applied = TRUE;
+      } else {
+        gchar *end;
+        guint64 selector;
+
+        selector = g_ascii_strtoull(values[1], &end, 0);
+        if (end != values[1] && *end == '\0' && selector <= G_MAXUINT32) {
+          dissector_change_uint(values[0], (guint32)selector, handle);
+          applied = TRUE;
+        }
+      }
+      if (applied) {
+        /* Register the change for decode_clear_all(), as loading the
+           decode_as_entries file does. */
+        decode_build_reset_list(values[0], selector_type, values[1],
+                                NULL, NULL);
+      }
+    }
+  }
+
+  for (i = 0; i < 4; i++)
+    g_free(values[i]);
+  return applied;
+}
+
+guint
+session_journal_replay_decode_as(capture_file *cf)
+{
+  gchar     **jnl_lines;
+  GPtrArray  *snapshot;
+  guint       i, applied = 0;
+
+  jnl_lines = session_journal_load(cf);
+  if (jnl_lines == NULL)
+    return 0;
+
+  /* Each apply journals a complete snapshot starting with a reset
+     record, so only the bindings after the last reset matter. */
+  snapshot = g_ptr_array_new();
+  for (i = 1; jnl_lines[i] != NULL; i++) {
+    if (strcmp(jnl_lines[i], "decodeas-reset") == 0)
+      g_ptr_array_set_size(snapshot, 0);
+    else if (g_str_has_prefix(jnl_lines[i], "decodeas "))
+      g_ptr_array_add(snapshot, jnl_lines[i] + strlen("decodeas "));
+  }
+
+  for (i = 0; i < snapshot->len; i++) {
+    if (session_journal_apply_decode_as((const gchar *)g_ptr_array_index(snapshot, i)))
+      applied++;
+  }
+
+  g_ptr_array_free(snapshot, TRUE);
+  g_strfreev(jnl_lines);
+
+  if (applied > 0)
+    ws_info("Replayed %u \"Decode As\" bindings for \"%s\"", applied,
+            cf->filename);
+  return applied;
+}
+
+guint
+session_journal_replay_timerefs(capture_file *cf)
+{
+  gchar         **jnl_lines;
+  GHashTable     *latest;
+  GHashTableIter  iter;
+  gpointer        key, value;
+  guint           i, frame_num, set, restored = 0;
+  frame_data     *fd;
+
+  jnl_lines = session_journal_load(cf);
+  if (jnl_lines == NULL)
+    return 0;
+
+  /* Only the last record for a frame matters, and a clear record wipes
+     everything journaled before it. */
+  latest = g_hash_table_new(g_direct_hash, g_direct_equal);
+  for (i = 1; jnl_lines[i] != NULL; i++) {
+    if (strcmp(jnl_lines[i], "timeref-clear") == 0) {
+      g_hash_table_remove_all(latest);
+      continue;
+    }
+    if (sscanf(jnl_lines[i], "timeref %u %u", &frame_num, &set) != 2)
+      continue;
+    if (frame_num == 0 || frame_num > cf->count)
+      continue;
+    g_hash_table_insert(latest, GUINT_TO_POINTER(frame_num),
+                        GUINT_TO_POINTER(set));
+  }
+
+  g_hash_table_iter_init(&iter, latest);
+  while (g_hash_table_iter_next(&iter, &key, &value)) {
+    if (!GPOINTER_TO_UINT(value))
+      continue;
+    fd = frame_data_sequence_find(cf->provider.frames,
+                                  GPOINTER_TO_UINT(key));
+    if (fd == NULL || fd->ref_time)
+      continue;
+    fd->ref_time = 1;
+    cf->ref_time_count++;
+    restored++;
+  }
+
+  g_hash_table_destroy(latest);
+  g_strfreev(jnl_lines);
+
+  if (restored > 0) {
+    cf_reftime_packets(cf);
+    ws_info("Restored %u time references for \"%s\"", restored,
+            cf->filename);
+  }
+  return restored;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 2
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=2 tabstop=8 expandtab:
+ * :indentSize=2:tabSize=8:noTabs=true:
+ */
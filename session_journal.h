@@ -0,0 +1,87 @@
+/* session_journal.h
+ * Sidecar append-only journal for per-capture analysis session state
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __SESSION_JOURNAL_H__
+#define __SESSION_JOURNAL_H__
+
+#include "cfile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * A session journal is a sidecar file ("<capture>.wsses") holding
+ * analysis state that otherwise lives only in memory and dies with the
+ * process: "Decode As" bindings and time references.  It follows the
+ * comment journal's model - validated against the capture file's size
+ * and modification time, appended to as the user works, replayed when
+ * the same unmodified capture is opened again - so a crash costs the
+ * edit in flight, not the session.
+ *
+ * All the records produced by one user action are written with a single
+ * append and flush, so a "Decode As" apply that touches a dozen tables
+ * still costs one write.  Packet comments have their own journal
+ * (comment_journal.h) because they, unlike this state, are merged into
+ * the capture file by a full save.
+ */
+
+/**
+ * Append a snapshot of all changed "Decode As" bindings.  Call after
+ * applying changes; the snapshot replaces any previously journaled
+ * bindings.  Failures are not fatal - the bindings are still in effect
+ * in memory.
+ */
+extern void session_journal_record_decode_as(capture_file *cf);
+
+/**
+ * Append a record for a frame whose time-reference flag was toggled.
+ */
+extern void session_journal_record_timeref(capture_file *cf,
+                                           guint32 frame_num, gboolean set);
+
+/**
+ * Append a record clearing all journaled time references.
+ */
+extern void session_journal_record_timeref_clear(capture_file *cf);
+
+/**
+ * Re-apply journaled "Decode As" bindings for cf->filename, if a valid
+ * journal exists.  Call before the first pass dissects anything, so the
+ * restored bindings take effect without a redissection.  Returns the
+ * number of bindings applied; a stale journal is deleted.
+ */
+extern guint session_journal_replay_decode_as(capture_file *cf);
+
+/**
+ * Restore journaled time references into cf's frame table and recompute
+ * the relative times.  Call once the frame table is fully populated.
+ * Returns the number of frames whose reference flag was set.
+ */
+extern guint session_journal_replay_timerefs(capture_file *cf);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SESSION_JOURNAL_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 2
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=2 tabstop=8 expandtab:
+ * :indentSize=2:tabSize=8:noTabs=true:
+ */
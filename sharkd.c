@@ -37,6 +37,7 @@
 #include <epan/timestamp.h>
 #include <epan/packet.h>
 #include "frame_tvbuff.h"
+#include <epan/frame_class.h>
 #include <epan/disabled_protos.h>
 #include <epan/prefs.h>
 #include <epan/column.h>
@@ -241,12 +242,254 @@ sharkd_epan_new(capture_file *cf)
     sharkd_get_frame_ts,
     cap_file_provider_get_interface_name,
     cap_file_provider_get_interface_description,
-    cap_file_provider_get_modified_block
+    cap_file_provider_get_modified_block,
+    cap_file_provider_get_shift_offset
   };
 
   return epan_new(&cf->provider, &funcs);
 }
 
+/*
+ * Frame-table snapshots.
+ *
+ * The first pass over a capture builds the frame table - per-frame
+ * offsets, lengths, timestamps and cumulative byte counts - and, in
+ * sharkd, everything else (columns, conversations, tap output) is
+ * computed on demand from it by re-dissecting the frames in question.
+ * The frame table is therefore the only durable product of a plain
+ * load, and the only part of the post-load state that can usefully be
+ * written out and read back.
+ *
+ * If SHARKD_SNAPSHOT_DIR is set in the environment, a plain load (no
+ * read or display filter, no packet or byte limit) writes the frame
+ * table to a snapshot file in that directory, and subsequent loads of
+ * the same capture restore it from there instead of reading, and
+ * possibly dissecting, every record.  A snapshot records the capture
+ * file's size and modification time and is ignored if they no longer
+ * match; the fields are written in host format, so snapshots are only
+ * meant to be read on the machine that wrote them.
+ *
+ * Name resolution entries and decryption secrets embedded in a capture
+ * are handed to us by callbacks as the file is read sequentially.  A
+ * restored snapshot skips that read, so captures that deliver either
+ * are never snapshotted.
+ */
+
+#define SNAPSHOT_MAGIC   0x53444654  /* "SDFT" */
+#define SNAPSHOT_VERSION 1
+
+typedef struct {
+  guint32 magic;
+  guint32 version;
+  guint32 frame_size;     /* sizeof(snapshot_frame_t), as a layout check */
+  guint32 count;          /* number of frames that follow */
+  gint64  file_size;      /* size of the capture file ... */
+  gint64  file_mtime;     /* ... and its mtime, when the snapshot was made */
+  gint64  elapsed_secs;   /* cf->elapsed_time */
+  gint32  elapsed_nsecs;
+  guint32 cum_bytes;      /* running total after the last frame */
+} snapshot_header_t;
+
+typedef struct {
+  gint64  file_off;
+  gint64  ts_secs;
+  gint32  ts_nsecs;
+  guint32 pkt_len;
+  guint32 cap_len;
+  guint32 cum_bytes;
+  guint32 frame_ref_num;
+  guint32 prev_dis_num;
+  guint8  tsprec;
+  guint8  has_ts;
+  guint8  has_phdr_block;
+  guint8  unused;
+} snapshot_frame_t;
+
+/* Set if the file's sequential read delivered anything a restored
+   snapshot couldn't replay; see the callback wrappers below. */
+static gboolean snapshot_unsafe;
+
+static void
+snapshot_cb_new_ipv4(const guint addr, const gchar *name)
+{
+  snapshot_unsafe = TRUE;
+  add_ipv4_name(addr, name);
+}
+
+static void
+snapshot_cb_new_ipv6(const void *addrp, const gchar *name)
+{
+  snapshot_unsafe = TRUE;
+  add_ipv6_name((const ws_in6_addr *)addrp, name);
+}
+
+static void
+snapshot_cb_new_secrets(guint32 secrets_type, const void *secrets, guint size)
+{
+  snapshot_unsafe = TRUE;
+  secrets_wtap_callback(secrets_type, secrets, size);
+}
+
+static char *
+snapshot_file_path(const capture_file *cf)
+{
+  const char *dir = g_getenv("SHARKD_SNAPSHOT_DIR");
+  gchar *digest;
+  char  *path;
+
+  if (dir == NULL || *dir == '\0')
+    return NULL;
+
+  /* Key the snapshot on the capture's path; the header's size and
+     mtime checks reject a path that's been reused for a different
+     capture. */
+  digest = g_compute_checksum_for_string(G_CHECKSUM_SHA256, cf->filename, -1);
+  path = g_strdup_printf("%s%c%s.snapshot", dir, G_DIR_SEPARATOR, digest);
+  g_free(digest);
+  return path;
+}
+
+static gboolean
+snapshot_restore(capture_file *cf)
+{
+  char *path = snapshot_file_path(cf);
+  FILE *fp;
+  ws_statb64 st;
+  snapshot_header_t hdr;
+  snapshot_frame_t sf;
+  frame_data fdlocal;
+  guint32 i;
+
+  if (path == NULL)
+    return FALSE;
+
+  fp = ws_fopen(path, "rb");
+  g_free(path);
+  if (fp == NULL)
+    return FALSE;
+
+  if (fread(&hdr, sizeof hdr, 1, fp) != 1 ||
+      hdr.magic != SNAPSHOT_MAGIC ||
+      hdr.version != SNAPSHOT_VERSION ||
+      hdr.frame_size != (guint32)sizeof(snapshot_frame_t) ||
+      ws_stat64(cf->filename, &st) < 0 ||
+      hdr.file_size != (gint64)st.st_size ||
+      hdr.file_mtime != (gint64)st.st_mtime) {
+    fclose(fp);
+    return FALSE;
+  }
+
+  for (i = 0; i < hdr.count; i++) {
+    if (fread(&sf, sizeof sf, 1, fp) != 1) {
+      /* Truncated snapshot; throw away whatever we've rebuilt and
+         fall back to a normal load. */
+      free_frame_data_sequence(cf->provider.frames);
+      cf->provider.frames = new_frame_data_sequence();
+      cf->count = 0;
+      fclose(fp);
+      return FALSE;
+    }
+
+    /* Fill in the fields a plain first pass would have set; everything
+       frame_data_init() zeroes stays zero. */
+    memset(&fdlocal, 0, sizeof fdlocal);
+    fdlocal.num = i + 1;
+    fdlocal.file_off = sf.file_off;
+    fdlocal.pkt_len = sf.pkt_len;
+    fdlocal.cap_len = sf.cap_len;
+    fdlocal.cum_bytes = sf.cum_bytes;
+    fdlocal.abs_ts.secs = (time_t)sf.ts_secs;
+    fdlocal.abs_ts.nsecs = sf.ts_nsecs;
+    fdlocal.tsprec = sf.tsprec;
+    fdlocal.has_ts = sf.has_ts;
+    fdlocal.has_phdr_block = sf.has_phdr_block;
+    fdlocal.frame_ref_num = sf.frame_ref_num;
+    fdlocal.prev_dis_num = sf.prev_dis_num;
+
+    frame_data_sequence_add(cf->provider.frames, &fdlocal);
+    cf->count++;
+  }
+
+  cf->elapsed_time.secs = (time_t)hdr.elapsed_secs;
+  cf->elapsed_time.nsecs = hdr.elapsed_nsecs;
+  cum_bytes = hdr.cum_bytes;
+
+  fclose(fp);
+  return TRUE;
+}
+
+static void
+snapshot_save(capture_file *cf)
+{
+  char *path;
+  FILE *fp;
+  ws_statb64 st;
+  snapshot_header_t hdr;
+  snapshot_frame_t sf;
+  const frame_data *fdata;
+  guint32 framenum;
+
+  if (snapshot_unsafe)
+    return;
+
+  path = snapshot_file_path(cf);
+  if (path == NULL)
+    return;
+
+  if (ws_stat64(cf->filename, &st) < 0) {
+    g_free(path);
+    return;
+  }
+
+  fp = ws_fopen(path, "wb");
+  if (fp == NULL) {
+    g_free(path);
+    return;
+  }
+
+  memset(&hdr, 0, sizeof hdr);
+  hdr.magic = SNAPSHOT_MAGIC;
+  hdr.version = SNAPSHOT_VERSION;
+  hdr.frame_size = (guint32)sizeof(snapshot_frame_t);
+  hdr.count = cf->count;
+  hdr.file_size = (gint64)st.st_size;
+  hdr.file_mtime = (gint64)st.st_mtime;
+  hdr.elapsed_secs = (gint64)cf->elapsed_time.secs;
+  hdr.elapsed_nsecs = cf->elapsed_time.nsecs;
+  hdr.cum_bytes = cum_bytes;
+  if (fwrite(&hdr, sizeof hdr, 1, fp) != 1)
+    goto fail;
+
+  for (framenum = 1; framenum <= cf->count; framenum++) {
+    fdata = frame_data_sequence_find(cf->provider.frames, framenum);
+
+    memset(&sf, 0, sizeof sf);
+    sf.file_off = fdata->file_off;
+    sf.ts_secs = (gint64)fdata->abs_ts.secs;
+    sf.ts_nsecs = fdata->abs_ts.nsecs;
+    sf.pkt_len = fdata->pkt_len;
+    sf.cap_len = fdata->cap_len;
+    sf.cum_bytes = fdata->cum_bytes;
+    sf.frame_ref_num = fdata->frame_ref_num;
+    sf.prev_dis_num = fdata->prev_dis_num;
+    sf.tsprec = (guint8)fdata->tsprec;
+    sf.has_ts = (guint8)fdata->has_ts;
+    sf.has_phdr_block = (guint8)fdata->has_phdr_block;
+    if (fwrite(&sf, sizeof sf, 1, fp) != 1)
+      goto fail;
+  }
+
+  fclose(fp);
+  g_free(path);
+  return;
+
+fail:
+  /* Don't leave a half-written snapshot behind. */
+  fclose(fp);
+  ws_unlink(path);
+  g_free(path);
+}
+
 static gboolean
 process_packet(capture_file *cf, epan_dissect_t *edt,
                gint64 offset, wtap_rec *rec, Buffer *buf)
@@ -262,6 +505,7 @@ process_packet(capture_file *cf, epan_dissect_t *edt,
   /* The frame number of this packet, if we add it to the set of frames,
      would be one more than the count of frames in the file so far. */
   frame_data_init(&fdlocal, cf->count + 1, rec, offset, cum_bytes);
+  frame_data_classify(&fdlocal, rec, ws_buffer_start_ptr(buf));
 
   /* If we're going to print packet information, or we're going to
      run a read filter, or display filter, or we're going to process taps, set up to
@@ -333,63 +577,75 @@ process_packet(capture_file *cf, epan_dissect_t *edt,
 static int
 load_cap_file(capture_file *cf, int max_packet_count, gint64 max_byte_count)
 {
-  int          err;
+  int          err = 0;
   gchar       *err_info = NULL;
   gint64       data_offset;
   wtap_rec     rec;
   Buffer       buf;
   epan_dissect_t *edt = NULL;
+  gboolean     plain_load;
+  gboolean     restored = FALSE;
+
+  /* Filters and limits change what the first pass produces, so only a
+     plain load can use, or leave behind, a frame-table snapshot. */
+  plain_load = (max_packet_count == 0 && max_byte_count == 0 &&
+                cf->rfcode == NULL && cf->dfcode == NULL);
 
   {
     /* Allocate a frame_data_sequence for all the frames. */
     cf->provider.frames = new_frame_data_sequence();
 
-    {
-      gboolean create_proto_tree;
-
-      /*
-       * Determine whether we need to create a protocol tree.
-       * We do if:
-       *
-       *    we're going to apply a read filter;
-       *
-       *    we're going to apply a display filter;
-       *
-       *    a postdissector wants field values or protocols
-       *    on the first pass.
-       */
-      create_proto_tree =
-        (cf->rfcode != NULL || cf->dfcode != NULL || postdissectors_want_hfids());
-
-      /* We're not going to display the protocol tree on this pass,
-         so it's not going to be "visible". */
-      edt = epan_dissect_new(cf->epan, create_proto_tree, FALSE);
-    }
+    if (plain_load)
+      restored = snapshot_restore(cf);
+
+    if (!restored) {
+      {
+        gboolean create_proto_tree;
+
+        /*
+         * Determine whether we need to create a protocol tree.
+         * We do if:
+         *
+         *    we're going to apply a read filter;
+         *
+         *    we're going to apply a display filter;
+         *
+         *    a postdissector wants field values or protocols
+         *    on the first pass.
+         */
+        create_proto_tree =
+          (cf->rfcode != NULL || cf->dfcode != NULL || postdissectors_want_hfids());
 
-    wtap_rec_init(&rec);
-    ws_buffer_init(&buf, 1514);
+        /* We're not going to display the protocol tree on this pass,
+           so it's not going to be "visible". */
+        edt = epan_dissect_new(cf->epan, create_proto_tree, FALSE);
+      }
 
-    while (wtap_read(cf->provider.wth, &rec, &buf, &err, &err_info, &data_offset)) {
-      if (process_packet(cf, edt, data_offset, &rec, &buf)) {
-        /* Stop reading if we have the maximum number of packets;
-         * When the -c option has not been used, max_packet_count
-         * starts at 0, which practically means, never stop reading.
-         * (unless we roll over max_packet_count ?)
-         */
-        if ( (--max_packet_count == 0) || (max_byte_count != 0 && data_offset >= max_byte_count)) {
-          err = 0; /* This is not an error */
-          break;
+      wtap_rec_init(&rec);
+      ws_buffer_init(&buf, 1514);
+
+      while (wtap_read(cf->provider.wth, &rec, &buf, &err, &err_info, &data_offset)) {
+        if (process_packet(cf, edt, data_offset, &rec, &buf)) {
+          /* Stop reading if we have the maximum number of packets;
+           * When the -c option has not been used, max_packet_count
+           * starts at 0, which practically means, never stop reading.
+           * (unless we roll over max_packet_count ?)
+           */
+          if ( (--max_packet_count == 0) || (max_byte_count != 0 && data_offset >= max_byte_count)) {
+            err = 0; /* This is not an error */
+            break;
+          }
         }
       }
-    }
 
-    if (edt) {
-      epan_dissect_free(edt);
-      edt = NULL;
-    }
+      if (edt) {
+        epan_dissect_free(edt);
+        edt = NULL;
+      }
 
-    wtap_rec_cleanup(&rec);
-    ws_buffer_free(&buf);
+      wtap_rec_cleanup(&rec);
+      ws_buffer_free(&buf);
+    }
 
     /* Close the sequential I/O side, to free up memory it requires. */
     wtap_sequential_close(cf->provider.wth);
@@ -404,6 +660,10 @@ load_cap_file(capture_file *cf, int max_packet_count, gint64 max_byte_count)
 
   if (err != 0) {
     cfile_read_failure_message(cf->filename, err, err_info);
+  } else if (plain_load && !restored) {
+    /* We've just done the work a snapshot would save; leave one behind
+       for the next load of this capture. */
+    snapshot_save(cf);
   }
 
   return err;
@@ -452,9 +712,12 @@ cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_temp
 
   cf->state = FILE_READ_IN_PROGRESS;
 
-  wtap_set_cb_new_ipv4(cf->provider.wth, add_ipv4_name);
-  wtap_set_cb_new_ipv6(cf->provider.wth, (wtap_new_ipv6_callback_t) add_ipv6_name);
-  wtap_set_cb_new_secrets(cf->provider.wth, secrets_wtap_callback);
+  /* Nothing's been delivered by this file's sequential read yet. */
+  snapshot_unsafe = FALSE;
+
+  wtap_set_cb_new_ipv4(cf->provider.wth, snapshot_cb_new_ipv4);
+  wtap_set_cb_new_ipv6(cf->provider.wth, snapshot_cb_new_ipv6);
+  wtap_set_cb_new_secrets(cf->provider.wth, snapshot_cb_new_secrets);
 
   return CF_OK;
 
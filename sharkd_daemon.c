@@ -45,6 +45,7 @@
 
 #ifndef _WIN32
 #include <sys/un.h>
+#include <sys/wait.h>
 #include <netinet/tcp.h>
 #endif
 
@@ -402,13 +403,53 @@ sharkd_loop(int argc _U_, char* argv[])
 		pid = fork();
 		if (pid == 0)
 		{
+			pid_t worker;
+			int status;
+
 			closesocket(_server_fd);
 			/* redirect stdin, stdout to socket */
 			dup2(fd, 0);
 			dup2(fd, 1);
 			close(fd);
 
-			exit(sharkd_session_main(mode));
+			/* The daemon ignores SIGCHLD so connection children
+			   are auto-reaped; undo that here, or waitpid() on
+			   the grandchild below would fail with ECHILD. */
+			signal(SIGCHLD, SIG_DFL);
+
+			/* Run the session itself in a supervised grandchild.
+			   If a dissector crashes it, the supervisor still owns
+			   the socket and can tell the client what happened
+			   instead of just dropping the connection; the client
+			   then reconnects and resumes from the frame-table
+			   snapshot in seconds rather than re-reading the
+			   whole capture. */
+			worker = fork();
+			if (worker <= 0)
+			{
+				/* Grandchild -- or fork() failed, in which case
+				   run unsupervised as before. */
+				exit(sharkd_session_main(mode));
+			}
+
+			if (waitpid(worker, &status, 0) == -1)
+				exit(1);
+
+			if (WIFSIGNALED(status))
+			{
+				if (mode <= SHARKD_MODE_CLASSIC_DAEMON)
+					printf("{\"err\":1,\"errstr\":\"session terminated by signal %d\"}\n",
+					    WTERMSIG(status));
+				else
+					printf("{\"jsonrpc\":\"2.0\",\"id\":null,\"error\":{\"code\":-32603,\"message\":\"session terminated by signal %d; reconnect to resume\"}}\n",
+					    WTERMSIG(status));
+				fflush(stdout);
+				fprintf(stderr, "sharkd session process %d terminated by signal %d\n",
+				    (int) worker, WTERMSIG(status));
+				exit(1);
+			}
+
+			exit(WIFEXITED(status) ? WEXITSTATUS(status) : 1);
 		}
 
 		if (pid == -1)
@@ -18,11 +18,19 @@
 #include <string.h>
 #include <errno.h>
 
+#ifndef _WIN32
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#endif
+
 #include <glib.h>
 
 #include <wsutil/wsjson.h>
 #include <wsutil/json_dumper.h>
 #include <wsutil/ws_assert.h>
+#include <wsutil/file_util.h>
 
 #include <file.h>
 #include <epan/epan_dissect.h>
@@ -31,6 +39,7 @@
 #include <epan/prefs.h>
 #include <epan/prefs-int.h>
 #include <epan/uat-int.h>
+#include <epan/wmem_scopes.h>
 #include <wiretap/wtap.h>
 
 #include <epan/column.h>
@@ -87,6 +96,43 @@ static guint32 rpcid;
 
 static json_dumper dumper = {0};
 
+/*
+ * Request workers.
+ *
+ * Requests are normally processed one at a time, so a heavy request - a
+ * "frames" pass with a filter over a big capture, say - blocks cheap
+ * ones, such as the "frame" request behind a packet detail pane, until
+ * it completes.  libwireshark keeps its dissection state in
+ * process-wide structures and can't be run from multiple threads, but
+ * the dissection done for a request after a load only *reads* the
+ * loaded capture, so, on systems with fork(), such a request can run in
+ * a forked worker against a copy-on-write snapshot of the session while
+ * the parent goes back to reading requests.
+ *
+ * If SHARKD_WORKERS is set to a nonzero worker count in the
+ * environment, requests classified as read-only are executed that way,
+ * up to that many at a time.  Requests that can change session state -
+ * load, setconf, Decode As changes via setconf, and the rest - are
+ * still processed in the parent, after waiting for in-flight workers to
+ * finish, so their effects can't overtake the responses of requests
+ * that preceded them.
+ *
+ * Each response is built in a per-process buffer file and copied to
+ * stdout in one critical section when it's complete, so responses stay
+ * whole on the wire no matter which process wrote them.  Workers
+ * re-open the capture file for themselves, because the parent's handle
+ * shares its seek position across fork().
+ */
+#ifndef _WIN32
+static guint32 workers_max;		/* 0 = process every request in-line */
+static guint32 workers_running;
+static FILE *response_file;		/* response being built, when workers are enabled */
+static FILE *response_lock_file;	/* fcntl-locked around writes to the real stdout */
+#endif
+
+static guint64 memory_limit;		/* SHARKD_MEMORY_LIMIT, 0 = no budget */
+static gboolean memory_limit_warned;
+
 
 static const char *
 json_find_attr(const char *buf, const jsmntok_t *tokens, int count, const char *attr)
@@ -174,6 +220,56 @@ sharkd_json_array_close(void)
 	json_dumper_end_array(&dumper);
 }
 
+#ifndef _WIN32
+static void
+sharkd_response_lock(gboolean acquire)
+{
+	struct flock fl;
+
+	/*
+	 * fcntl() record locks, unlike flock() locks, are owned by the
+	 * process, so taking one on the descriptor a worker inherited
+	 * still excludes the parent and the other workers.
+	 */
+	memset(&fl, 0, sizeof fl);
+	fl.l_type = acquire ? F_WRLCK : F_UNLCK;
+	fl.l_whence = SEEK_SET;
+	while (fcntl(fileno(response_lock_file), F_SETLKW, &fl) == -1 && errno == EINTR)
+		;
+}
+
+static void
+sharkd_response_flush(void)
+{
+	char block[8 * 1024];
+	size_t nread;
+
+	fflush(response_file);
+	rewind(response_file);
+
+	/* Copy the completed response to stdout in one critical section,
+	   so responses from concurrent workers come out whole rather than
+	   interleaved. */
+	sharkd_response_lock(TRUE);
+	while ((nread = fread(block, 1, sizeof(block), response_file)) > 0)
+		fwrite(block, 1, nread, stdout);
+	fflush(stdout);
+	sharkd_response_lock(FALSE);
+
+	/* Empty the buffer for the next response. */
+	if (ftruncate(fileno(response_file), 0) == -1) {
+		/* Shouldn't happen for a temporary file; start a fresh
+		   buffer rather than re-sending these bytes next time. */
+		fclose(response_file);
+		response_file = tmpfile();
+		if (response_file == NULL)
+			exit(1);
+		dumper.output_file = response_file;
+	} else
+		rewind(response_file);
+}
+#endif /* _WIN32 */
+
 static void
 sharkd_json_response_open(guint32 id)
 {
@@ -187,6 +283,16 @@ sharkd_json_response_close(void)
 {
 	json_dumper_finish(&dumper);
 
+#ifndef _WIN32
+	if (workers_max != 0)
+	{
+		/* The response was built in response_file; put it on the
+		   wire in one piece. */
+		sharkd_response_flush();
+		return;
+	}
+#endif
+
 	/*
 	 * We do an explicit fflush after every line, because
 	 * we want output to be written to the socket as soon
@@ -371,6 +477,7 @@ json_prep(char* buf, const jsmntok_t* tokens, int count)
 		{"method",     "follow",     1, JSMN_STRING,       SHARKD_JSON_STRING,   OPTIONAL},
 		{"method",     "frame",      1, JSMN_STRING,       SHARKD_JSON_STRING,   OPTIONAL},
 		{"method",     "frames",     1, JSMN_STRING,       SHARKD_JSON_STRING,   OPTIONAL},
+		{"method",     "fsframes",   1, JSMN_STRING,       SHARKD_JSON_STRING,   OPTIONAL},
 		{"method",     "info",       1, JSMN_STRING,       SHARKD_JSON_STRING,   OPTIONAL},
 		{"method",     "intervals",  1, JSMN_STRING,       SHARKD_JSON_STRING,   OPTIONAL},
 		{"method",     "iograph",    1, JSMN_STRING,       SHARKD_JSON_STRING,   OPTIONAL},
@@ -402,6 +509,9 @@ json_prep(char* buf, const jsmntok_t* tokens, int count)
 		{"frames",     "skip",       2, JSMN_PRIMITIVE,    SHARKD_JSON_UINTEGER, OPTIONAL},
 		{"frames",     "limit",      2, JSMN_PRIMITIVE,    SHARKD_JSON_UINTEGER, OPTIONAL},
 		{"frames",     "refs",       2, JSMN_STRING,       SHARKD_JSON_STRING,   OPTIONAL},
+		{"fsframes",   "dir",        2, JSMN_STRING,       SHARKD_JSON_STRING,   MANDATORY},
+		{"fsframes",   "filter",     2, JSMN_STRING,       SHARKD_JSON_STRING,   OPTIONAL},
+		{"fsframes",   "limit",      2, JSMN_PRIMITIVE,    SHARKD_JSON_UINTEGER, OPTIONAL},
 		{"intervals",  "interval",   2, JSMN_PRIMITIVE,    SHARKD_JSON_UINTEGER, OPTIONAL},
 		{"intervals",  "filter",     2, JSMN_STRING,       SHARKD_JSON_STRING,   OPTIONAL},
 		{"iograph",    "interval",   2, JSMN_PRIMITIVE,    SHARKD_JSON_UINTEGER, OPTIONAL},
@@ -1103,6 +1213,10 @@ sharkd_session_process_load(const char *buf, const jsmntok_t *tokens, int count)
  *   (m) duration - time difference between time of first frame, and last loaded frame
  *   (o) filename - capture filename
  *   (o) filesize - capture filesize
+ *   (m) memfile  - bytes of file-scope analysis state (reassembly,
+ *                  conversations, decrypted payloads, ...) requested
+ *                  since the capture was opened
+ *   (m) memepan  - bytes of process-lifetime epan state requested
  */
 static void
 sharkd_session_process_status(void)
@@ -1111,6 +1225,10 @@ sharkd_session_process_status(void)
 
 	sharkd_json_value_anyf("frames", "%u", cfile.count);
 	sharkd_json_value_anyf("duration", "%.9f", nstime_to_sec(&cfile.elapsed_time));
+	sharkd_json_value_anyf("memfile", "%" G_GUINT64_FORMAT,
+		wmem_allocator_bytes_allocated(wmem_file_scope()));
+	sharkd_json_value_anyf("memepan", "%" G_GUINT64_FORMAT,
+		wmem_allocator_bytes_allocated(wmem_epan_scope()));
 
 	if (cfile.filename)
 	{
@@ -1319,15 +1437,120 @@ sharkd_session_create_columns(column_info *cinfo, const char *buf, const jsmntok
 	return cinfo;
 }
 
+/*
+ * Accumulator for the compact "frames" response format: columnar, with
+ * the column (and color) strings deduplicated through a per-response
+ * string table, instead of one JSON object per row.  Cuts the response
+ * size, and the time spent formatting it, by roughly an order of
+ * magnitude on captures where the column values repeat a lot - which is
+ * most of them.
+ */
+struct sharkd_frames_batch
+{
+	GHashTable *str_index;	/* string -> its index in strings */
+	GPtrArray *strings;	/* string table; [0] is "", meaning "no value" */
+	GArray **columns;	/* per column, per row: string-table index */
+	int num_cols;
+	GArray *nums;		/* per row: frame number */
+	GArray *bg, *fg;	/* per row: color string-table index */
+	GArray *ignored;	/* row indices, for the rows where it's set */
+	GArray *marked;
+	GArray *commented;
+	guint32 rows;
+	gboolean any_color;
+};
+
+static guint32
+sharkd_frames_batch_intern(struct sharkd_frames_batch *batch, const char *str)
+{
+	gpointer value;
+	gchar *copy;
+	guint32 idx;
+
+	if (str == NULL || str[0] == '\0')
+		return 0;
+
+	if (g_hash_table_lookup_extended(batch->str_index, str, NULL, &value))
+		return GPOINTER_TO_UINT(value);
+
+	idx = batch->strings->len;
+	copy = g_strdup(str);
+	g_ptr_array_add(batch->strings, copy);
+	g_hash_table_insert(batch->str_index, copy, GUINT_TO_POINTER(idx));
+	return idx;
+}
+
+static void
+sharkd_session_process_frames_compact_cb(epan_dissect_t *edt, struct epan_column_info *cinfo, struct sharkd_frames_batch *batch)
+{
+	packet_info *pi = &edt->pi;
+	frame_data *fdata = pi->fd;
+	wtap_block_t pkt_block = NULL;
+	char *comment;
+	guint32 idx;
+
+	for (int col = 0; col < cinfo->num_cols; ++col)
+	{
+		idx = sharkd_frames_batch_intern(batch, cinfo->columns[col].col_data);
+		g_array_append_val(batch->columns[col], idx);
+	}
+
+	g_array_append_val(batch->nums, pi->num);
+
+	if (fdata->has_modified_block)
+		pkt_block = sharkd_get_modified_block(fdata);
+	else if (fdata->has_phdr_block)
+		pkt_block = pi->rec->block;
+
+	if (pkt_block != NULL &&
+	    WTAP_OPTTYPE_SUCCESS == wtap_block_get_nth_string_option_value(pkt_block, OPT_COMMENT, 0, &comment))
+		g_array_append_val(batch->commented, batch->rows);
+
+	if (fdata->ignored)
+		g_array_append_val(batch->ignored, batch->rows);
+
+	if (fdata->marked)
+		g_array_append_val(batch->marked, batch->rows);
+
+	if (fdata->color_filter)
+	{
+		char color_str[16];
+
+		snprintf(color_str, sizeof(color_str), "%x", color_t_to_rgb(&fdata->color_filter->bg_color));
+		idx = sharkd_frames_batch_intern(batch, color_str);
+		g_array_append_val(batch->bg, idx);
+
+		snprintf(color_str, sizeof(color_str), "%x", color_t_to_rgb(&fdata->color_filter->fg_color));
+		idx = sharkd_frames_batch_intern(batch, color_str);
+		g_array_append_val(batch->fg, idx);
+
+		batch->any_color = TRUE;
+	}
+	else
+	{
+		idx = 0;
+		g_array_append_val(batch->bg, idx);
+		g_array_append_val(batch->fg, idx);
+	}
+
+	batch->rows++;
+}
+
 static void
 sharkd_session_process_frames_cb(epan_dissect_t *edt, proto_tree *tree _U_,
-    struct epan_column_info *cinfo, const GSList *data_src _U_, void *data _U_)
+    struct epan_column_info *cinfo, const GSList *data_src _U_, void *data)
 {
 	packet_info *pi = &edt->pi;
 	frame_data *fdata = pi->fd;
 	wtap_block_t pkt_block = NULL;
 	char *comment;
 
+	if (data != NULL)
+	{
+		sharkd_session_process_frames_compact_cb(edt, cinfo, (struct sharkd_frames_batch *) data);
+		return;
+	}
+
 	json_dumper_begin_object(&dumper);
 
 	sharkd_json_array_open("c");
@@ -1383,6 +1606,7 @@ sharkd_session_process_frames_cb(epan_dissect_t *edt, proto_tree *tree _U_,
  *   (o) skip=N   - skip N frames
  *   (o) limit=N  - show only N frames
  *   (o) refs  - list (comma separated) with sorted time reference frame numbers.
+ *   (o) compact - if present, return one columnar batch instead of one object per frame
  *
  * Output array of frames with attributes:
  *   (m) c   - array of column data
@@ -1392,6 +1616,19 @@ sharkd_session_process_frames_cb(epan_dissect_t *edt, proto_tree *tree _U_,
  *   (o) ct  - if frame is commented
  *   (o) bg  - color filter - background color in hex
  *   (o) fg  - color filter - foreground color in hex
+ *
+ * Compact output object with attributes:
+ *   (m) st  - string table; strings are deduplicated and referenced by
+ *             index, index 0 is always "" and doubles as "no value"
+ *   (m) c   - array with one array per column, holding a string-table
+ *             index per row
+ *   (m) num - frame numbers, delta-encoded: the first entry is absolute,
+ *             every later entry is the gap from the previous row
+ *   (o) bg  - background color string-table index per row
+ *   (o) fg  - foreground color string-table index per row
+ *   (o) i   - row indices (0-origin) of the ignored frames
+ *   (o) m   - row indices of the marked frames
+ *   (o) ct  - row indices of the commented frames
  */
 static void
 sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int count)
@@ -1401,6 +1638,10 @@ sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int coun
 	const char *tok_skip   = json_find_attr(buf, tokens, count, "skip");
 	const char *tok_limit  = json_find_attr(buf, tokens, count, "limit");
 	const char *tok_refs   = json_find_attr(buf, tokens, count, "refs");
+	const char *tok_compact = json_find_attr(buf, tokens, count, "compact");
+
+	struct sharkd_frames_batch batch_data;
+	struct sharkd_frames_batch *batch = NULL;
 
 	const guint8 *filter_data = NULL;
 
@@ -1464,7 +1705,26 @@ sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int coun
 			return;
 	}
 
-	sharkd_json_result_array_prologue(rpcid);
+	if (tok_compact)
+	{
+		memset(&batch_data, 0, sizeof(batch_data));
+		batch_data.str_index = g_hash_table_new(g_str_hash, g_str_equal);
+		batch_data.strings = g_ptr_array_new_with_free_func(g_free);
+		g_ptr_array_add(batch_data.strings, g_strdup(""));	/* index 0 = no value */
+		batch_data.num_cols = cinfo->num_cols;
+		batch_data.columns = g_new(GArray *, cinfo->num_cols);
+		for (int col = 0; col < cinfo->num_cols; col++)
+			batch_data.columns[col] = g_array_new(FALSE, FALSE, sizeof(guint32));
+		batch_data.nums = g_array_new(FALSE, FALSE, sizeof(guint32));
+		batch_data.bg = g_array_new(FALSE, FALSE, sizeof(guint32));
+		batch_data.fg = g_array_new(FALSE, FALSE, sizeof(guint32));
+		batch_data.ignored = g_array_new(FALSE, FALSE, sizeof(guint32));
+		batch_data.marked = g_array_new(FALSE, FALSE, sizeof(guint32));
+		batch_data.commented = g_array_new(FALSE, FALSE, sizeof(guint32));
+		batch = &batch_data;
+	}
+	else
+		sharkd_json_result_array_prologue(rpcid);
 
 	wtap_rec_init(&rec);
 	ws_buffer_init(&rec_buf, 1514);
@@ -1513,7 +1773,7 @@ sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int coun
 		    (framenum != 1) ? 1 : 0, framenum - 1,
 		    &rec, &rec_buf, cinfo,
 		    (fdata->color_filter == NULL) ? SHARKD_DISSECT_FLAG_COLOR : SHARKD_DISSECT_FLAG_NULL,
-		    &sharkd_session_process_frames_cb, NULL,
+		    &sharkd_session_process_frames_cb, batch,
 		    &err, &err_info);
 		switch (status) {
 
@@ -1536,7 +1796,91 @@ sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int coun
 		if (limit && --limit == 0)
 			break;
 	}
-	sharkd_json_result_array_epilogue();
+
+	if (batch)
+	{
+		guint32 prev_num = 0;
+
+		sharkd_json_result_prologue(rpcid);
+
+		sharkd_json_array_open("st");
+		for (guint i = 0; i < batch->strings->len; i++)
+			sharkd_json_value_string(NULL, (const char *) g_ptr_array_index(batch->strings, i));
+		sharkd_json_array_close();
+
+		sharkd_json_array_open("c");
+		for (int col = 0; col < batch->num_cols; col++)
+		{
+			sharkd_json_array_open(NULL);
+			for (guint32 row = 0; row < batch->rows; row++)
+				sharkd_json_value_anyf(NULL, "%u", g_array_index(batch->columns[col], guint32, row));
+			sharkd_json_array_close();
+		}
+		sharkd_json_array_close();
+
+		sharkd_json_array_open("num");
+		for (guint32 row = 0; row < batch->rows; row++)
+		{
+			guint32 num = g_array_index(batch->nums, guint32, row);
+
+			sharkd_json_value_anyf(NULL, "%u", num - prev_num);
+			prev_num = num;
+		}
+		sharkd_json_array_close();
+
+		if (batch->any_color)
+		{
+			sharkd_json_array_open("bg");
+			for (guint32 row = 0; row < batch->rows; row++)
+				sharkd_json_value_anyf(NULL, "%u", g_array_index(batch->bg, guint32, row));
+			sharkd_json_array_close();
+
+			sharkd_json_array_open("fg");
+			for (guint32 row = 0; row < batch->rows; row++)
+				sharkd_json_value_anyf(NULL, "%u", g_array_index(batch->fg, guint32, row));
+			sharkd_json_array_close();
+		}
+
+		if (batch->ignored->len)
+		{
+			sharkd_json_array_open("i");
+			for (guint i = 0; i < batch->ignored->len; i++)
+				sharkd_json_value_anyf(NULL, "%u", g_array_index(batch->ignored, guint32, i));
+			sharkd_json_array_close();
+		}
+
+		if (batch->marked->len)
+		{
+			sharkd_json_array_open("m");
+			for (guint i = 0; i < batch->marked->len; i++)
+				sharkd_json_value_anyf(NULL, "%u", g_array_index(batch->marked, guint32, i));
+			sharkd_json_array_close();
+		}
+
+		if (batch->commented->len)
+		{
+			sharkd_json_array_open("ct");
+			for (guint i = 0; i < batch->commented->len; i++)
+				sharkd_json_value_anyf(NULL, "%u", g_array_index(batch->commented, guint32, i));
+			sharkd_json_array_close();
+		}
+
+		sharkd_json_result_epilogue();
+
+		g_hash_table_destroy(batch->str_index);
+		g_ptr_array_free(batch->strings, TRUE);
+		for (int col = 0; col < batch->num_cols; col++)
+			g_array_free(batch->columns[col], TRUE);
+		g_free(batch->columns);
+		g_array_free(batch->nums, TRUE);
+		g_array_free(batch->bg, TRUE);
+		g_array_free(batch->fg, TRUE);
+		g_array_free(batch->ignored, TRUE);
+		g_array_free(batch->marked, TRUE);
+		g_array_free(batch->commented, TRUE);
+	}
+	else
+		sharkd_json_result_array_epilogue();
 
 	if (cinfo != &cfile.cinfo)
 		col_cleanup(cinfo);
@@ -1545,6 +1889,320 @@ sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int coun
 	ws_buffer_free(&rec_buf);
 }
 
+/**
+ * sharkd_session_process_fsframes()
+ *
+ * Process fsframes request - a filtered frame search over every capture
+ * file in a directory, with one forked worker per file.
+ *
+ * A day of ring buffer output is one capture split into files on time
+ * boundaries, so the result of a search over the set is the
+ * concatenation of the per-file results in file name order - ring
+ * buffer file names embed a sequence number and a timestamp, so name
+ * order is time order.  Each worker inherits a session of its own via
+ * fork(), loads one file (through the frame-table snapshot warm start,
+ * when SHARKD_SNAPSHOT_DIR is set), and streams its hits into a buffer
+ * file; the parent splices the streams into the response in file order
+ * as the workers complete, so up to a worker-pool's worth of files are
+ * searched at any one time and no file waits for output behind a
+ * slower one that comes after it.
+ *
+ * Input:
+ *   (m) dir     - directory with the capture files
+ *   (o) filter  - display filter; frames that pass it are reported
+ *   (o) limit=N - report at most N frames per file
+ *
+ * Output object with attributes:
+ *   (m) frames - array of matching frames, in search order, each with:
+ *                  (m) f   - index of the frame's file in "files"
+ *                  (m) num - frame number inside its file
+ *                  (m) c   - array of column data
+ *   (m) files  - array with one entry per file, in search order:
+ *                  (m) file   - file name, without the directory
+ *                  (m) status - "OK", or "Error" if the file could not
+ *                               be searched; its frames are absent
+ */
+#ifdef _WIN32
+static void
+sharkd_session_process_fsframes(const char *buf _U_, const jsmntok_t *tokens _U_, int count _U_)
+{
+	sharkd_json_error(
+		rpcid, -14001, NULL,
+		"fsframes requires a platform with fork()"
+	);
+}
+#else /* _WIN32 */
+struct sharkd_fsframes_worker
+{
+	FILE *out;		/* the worker's rows: a comma-separated JSON fragment */
+	pid_t pid;
+	gboolean failed;
+};
+
+struct sharkd_fsframes_pass
+{
+	guint32 file_idx;
+	guint32 limit;		/* 0 = unlimited */
+	guint32 rows;
+};
+
+static void
+sharkd_session_fsframes_cb(epan_dissect_t *edt, proto_tree *tree _U_,
+    struct epan_column_info *cinfo, const GSList *data_src _U_, void *data)
+{
+	struct sharkd_fsframes_pass *pass = (struct sharkd_fsframes_pass *) data;
+	packet_info *pi = &edt->pi;
+
+	json_dumper_begin_object(&dumper);
+
+	sharkd_json_value_anyf("f", "%u", pass->file_idx);
+	sharkd_json_value_anyf("num", "%u", pi->num);
+
+	sharkd_json_array_open("c");
+	for (int col = 0; col < cinfo->num_cols; ++col)
+		sharkd_json_value_string(NULL, cinfo->columns[col].col_data);
+	sharkd_json_array_close();
+
+	json_dumper_end_object(&dumper);
+
+	pass->rows++;
+}
+
+static void
+sharkd_session_fsframes_child(const char *fullname, guint32 file_idx, const char *filter, guint32 limit)
+{
+	guint8 *filter_data = NULL;
+	struct sharkd_fsframes_pass pass;
+	wtap_rec rec;
+	Buffer rec_buf;
+	int err = 0;
+
+	if (sharkd_cf_open(fullname, WTAP_TYPE_AUTO, FALSE, &err) != CF_OK)
+		_exit(1);
+
+	TRY
+	{
+		err = sharkd_load_cap_file();
+	}
+	CATCH(OutOfMemoryError)
+	{
+		_exit(1);
+	}
+	ENDTRY;
+	if (err != 0)
+		_exit(1);
+
+	if (filter != NULL && sharkd_filter(filter, &filter_data) == -1)
+		_exit(1);
+
+	pass.file_idx = file_idx;
+	pass.limit = limit;
+	pass.rows = 0;
+
+	wtap_rec_init(&rec);
+	ws_buffer_init(&rec_buf, 1514);
+
+	for (guint32 framenum = 1; framenum <= cfile.count; framenum++)
+	{
+		gchar *err_info = NULL;
+
+		if (filter_data && !(filter_data[framenum / 8] & (1 << (framenum % 8))))
+			continue;
+
+		if (sharkd_dissect_request(framenum,
+		    (framenum != 1) ? 1 : 0, framenum - 1,
+		    &rec, &rec_buf, &cfile.cinfo, SHARKD_DISSECT_FLAG_NULL,
+		    &sharkd_session_fsframes_cb, &pass,
+		    &err, &err_info) == DISSECT_REQUEST_READ_ERROR)
+			g_free(err_info);
+
+		if (pass.limit != 0 && pass.rows >= pass.limit)
+			break;
+	}
+
+	/* The rows went through the dumper into our buffer file; push out
+	   whatever stdio still holds before exiting. */
+	fflush(dumper.output_file);
+	_exit(0);
+}
+
+static void
+sharkd_session_fsframes_splice(FILE *out, gboolean *first)
+{
+	char block[8 * 1024];
+	size_t nread;
+
+	rewind(out);
+
+	/* Every worker starts from a dumper that was forked inside the
+	   still-empty "frames" array, so its fragment carries no leading
+	   comma; supply the one between fragments here. */
+	nread = fread(block, 1, sizeof(block), out);
+	if (nread == 0)
+		return;
+
+	if (!*first)
+		fputc(',', dumper.output_file);
+	*first = FALSE;
+
+	do
+		fwrite(block, 1, nread, dumper.output_file);
+	while ((nread = fread(block, 1, sizeof(block), out)) > 0);
+}
+
+static gint
+sharkd_session_fsframes_name_cmp(gconstpointer a, gconstpointer b)
+{
+	return strcmp(*(const char * const *) a, *(const char * const *) b);
+}
+
+static void
+sharkd_session_process_fsframes(const char *buf, const jsmntok_t *tokens, int count)
+{
+	const char *tok_dir    = json_find_attr(buf, tokens, count, "dir");
+	const char *tok_filter = json_find_attr(buf, tokens, count, "filter");
+	const char *tok_limit  = json_find_attr(buf, tokens, count, "limit");
+
+	struct sharkd_fsframes_worker *workers;
+	GPtrArray *files;
+	WS_DIR *dir;
+	WS_DIRENT *file;
+	guint n_parallel;
+	guint next_spawn = 0;
+	guint next_emit = 0;
+	gboolean first_row = TRUE;
+	guint32 limit = 0;
+	void (*prev_sigchld)(int);
+
+	if (!tok_dir)
+		return;
+
+	if (tok_limit && !ws_strtou32(tok_limit, NULL, &limit))
+		return;
+
+	if (tok_filter)
+	{
+		/* Fail fast on a bad filter here, rather than once per file
+		   in the workers. */
+		dfilter_t *dfcode;
+		gchar *err_msg = NULL;
+
+		if (!dfilter_compile(tok_filter, &dfcode, &err_msg))
+		{
+			g_free(err_msg);
+			sharkd_json_error(
+				rpcid, -14002, NULL,
+				"Filter expression invalid"
+			);
+			return;
+		}
+		dfilter_free(dfcode);
+	}
+
+	dir = ws_dir_open(tok_dir, 0, NULL);
+	if (dir == NULL)
+	{
+		sharkd_json_error(
+			rpcid, -14003, NULL,
+			"Unable to open the directory"
+		);
+		return;
+	}
+
+	files = g_ptr_array_new_with_free_func(g_free);
+	while ((file = ws_dir_read_name(dir)) != NULL)
+	{
+		const char *name = ws_dir_get_name(file);
+		gchar *fullname = g_build_filename(tok_dir, name, NULL);
+
+		if (name[0] != '.' && g_file_test(fullname, G_FILE_TEST_IS_REGULAR))
+			g_ptr_array_add(files, g_strdup(name));
+		g_free(fullname);
+	}
+	ws_dir_close(dir);
+	g_ptr_array_sort(files, sharkd_session_fsframes_name_cmp);
+
+	n_parallel = workers_max != 0 ? workers_max : MIN(g_get_num_processors(), 8);
+
+	workers = g_new0(struct sharkd_fsframes_worker, files->len);
+
+	/* Classic console mode ignores SIGCHLD; we need to wait for the
+	   per-file workers. */
+	prev_sigchld = signal(SIGCHLD, SIG_DFL);
+
+	sharkd_json_result_prologue(rpcid);
+
+	sharkd_json_array_open("frames");
+	while (next_emit < files->len)
+	{
+		while (next_spawn < files->len && next_spawn - next_emit < n_parallel)
+		{
+			struct sharkd_fsframes_worker *w = &workers[next_spawn];
+			gchar *fullname = g_build_filename(tok_dir,
+			    (const char *) g_ptr_array_index(files, next_spawn), NULL);
+
+			w->out = tmpfile();
+			w->pid = (w->out != NULL) ? fork() : -1;
+			if (w->pid == 0)
+			{
+				/* Worker child: rows go into our buffer file. */
+				dumper.output_file = w->out;
+				sharkd_session_fsframes_child(fullname, next_spawn, tok_filter, limit);
+				/* not reached */
+			}
+			if (w->pid == -1)
+				w->failed = TRUE;
+			g_free(fullname);
+			next_spawn++;
+		}
+
+		/* Stream the next file's rows as soon as its worker is done;
+		   the files after it keep searching meanwhile. */
+		{
+			struct sharkd_fsframes_worker *w = &workers[next_emit];
+
+			if (w->pid != -1)
+			{
+				int status = 0;
+
+				while (waitpid(w->pid, &status, 0) == -1 && errno == EINTR)
+					;
+				if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+				{
+					/* The fragment may end in a half-written
+					   row; drop it rather than corrupt the
+					   response. */
+					w->failed = TRUE;
+				}
+				else
+					sharkd_session_fsframes_splice(w->out, &first_row);
+			}
+			if (w->out != NULL)
+				fclose(w->out);
+		}
+		next_emit++;
+	}
+	sharkd_json_array_close();
+
+	signal(SIGCHLD, prev_sigchld);
+
+	sharkd_json_array_open("files");
+	for (guint i = 0; i < files->len; i++)
+	{
+		json_dumper_begin_object(&dumper);
+		sharkd_json_value_string("file", (const char *) g_ptr_array_index(files, i));
+		sharkd_json_value_string("status", workers[i].failed ? "Error" : "OK");
+		json_dumper_end_object(&dumper);
+	}
+	sharkd_json_array_close();
+
+	sharkd_json_result_epilogue();
+
+	g_free(workers);
+	g_ptr_array_free(files, TRUE);
+}
+#endif /* _WIN32 */
+
 static void
 sharkd_session_process_tap_stats_node_cb(const stat_node *n)
 {
@@ -4955,6 +5613,150 @@ sharkd_session_process_download(char *buf, const jsmntok_t *tokens, int count)
 	}
 }
 
+static void
+sharkd_session_process_request(const char *tok_method, char *buf, const jsmntok_t *tokens, int count)
+{
+	if (!strcmp(tok_method, "load"))
+		sharkd_session_process_load(buf, tokens, count);
+	else if (!strcmp(tok_method, "status"))
+		sharkd_session_process_status();
+	else if (!strcmp(tok_method, "analyse"))
+		sharkd_session_process_analyse();
+	else if (!strcmp(tok_method, "info"))
+		sharkd_session_process_info();
+	else if (!strcmp(tok_method, "check"))
+		sharkd_session_process_check(buf, tokens, count);
+	else if (!strcmp(tok_method, "complete"))
+		sharkd_session_process_complete(buf, tokens, count);
+	else if (!strcmp(tok_method, "frames"))
+		sharkd_session_process_frames(buf, tokens, count);
+	else if (!strcmp(tok_method, "fsframes"))
+		sharkd_session_process_fsframes(buf, tokens, count);
+	else if (!strcmp(tok_method, "tap"))
+		sharkd_session_process_tap(buf, tokens, count);
+	else if (!strcmp(tok_method, "follow"))
+		sharkd_session_process_follow(buf, tokens, count);
+	else if (!strcmp(tok_method, "iograph"))
+		sharkd_session_process_iograph(buf, tokens, count);
+	else if (!strcmp(tok_method, "intervals"))
+		sharkd_session_process_intervals(buf, tokens, count);
+	else if (!strcmp(tok_method, "frame"))
+		sharkd_session_process_frame(buf, tokens, count);
+	else if (!strcmp(tok_method, "setcomment"))
+		sharkd_session_process_setcomment(buf, tokens, count);
+	else if (!strcmp(tok_method, "setconf"))
+		sharkd_session_process_setconf(buf, tokens, count);
+	else if (!strcmp(tok_method, "dumpconf"))
+		sharkd_session_process_dumpconf(buf, tokens, count);
+	else if (!strcmp(tok_method, "download"))
+		sharkd_session_process_download(buf, tokens, count);
+	else if (!strcmp(tok_method, "bye"))
+	{
+		sharkd_json_simple_ok(rpcid);
+		exit(0);
+	}
+	else
+	{
+		sharkd_json_error(
+			rpcid, -32601, NULL,
+			"The method \"%s\" is unknown", tok_method
+		);
+	}
+}
+
+#ifndef _WIN32
+static gboolean
+sharkd_session_method_is_readonly(const char *tok_method)
+{
+	/* Requests that only read the loaded capture, and whose work is
+	   heavy enough to be worth a fork().  Cheap requests, requests
+	   that can change session state, and requests that maintain
+	   session caches (check, complete) stay in the parent. */
+	return !strcmp(tok_method, "frames") ||
+	       !strcmp(tok_method, "frame") ||
+	       !strcmp(tok_method, "tap") ||
+	       !strcmp(tok_method, "follow") ||
+	       !strcmp(tok_method, "iograph") ||
+	       !strcmp(tok_method, "intervals") ||
+	       !strcmp(tok_method, "analyse");
+}
+
+static void
+sharkd_workers_reap(gboolean drain)
+{
+	while (workers_running != 0)
+	{
+		if (waitpid(-1, NULL, drain ? 0 : WNOHANG) <= 0)
+			break;
+		workers_running--;
+	}
+}
+
+/* Returns TRUE, in the parent, if the request was handed to a worker. */
+static gboolean
+sharkd_session_process_in_worker(const char *tok_method, char *buf, const jsmntok_t *tokens, int count)
+{
+	pid_t pid;
+	wtap *wth;
+	int err = 0;
+	gchar *err_info = NULL;
+
+	if (workers_max == 0 || cfile.filename == NULL)
+		return FALSE;
+
+	if (!sharkd_session_method_is_readonly(tok_method))
+	{
+		/* A request that can change session state waits for the
+		   in-flight readers, so that its effects can't overtake
+		   responses to the requests that preceded it. */
+		sharkd_workers_reap(TRUE);
+		return FALSE;
+	}
+
+	sharkd_workers_reap(FALSE);
+	while (workers_running >= workers_max)
+	{
+		if (waitpid(-1, NULL, 0) <= 0)
+			break;
+		workers_running--;
+	}
+
+	pid = fork();
+	if (pid == -1)
+		return FALSE;	/* just process it in-line */
+
+	if (pid != 0)
+	{
+		workers_running++;
+		return TRUE;
+	}
+
+	/* Worker child.  Build the response in a buffer of our own; the
+	   inherited one is shared with the parent and the other workers. */
+	response_file = tmpfile();
+	if (response_file == NULL)
+		_exit(1);
+	dumper.output_file = response_file;
+
+	/* The capture file handle's seek position is shared across
+	   fork(), so re-dissect through a private handle on the file. */
+	wth = wtap_open_offline(cfile.filename, cfile.open_type, &err, &err_info, TRUE);
+	if (wth == NULL)
+	{
+		g_free(err_info);
+		sharkd_json_error(
+			rpcid, -32603, NULL,
+			"Unable to reopen the file"
+		);
+		_exit(1);
+	}
+	cfile.provider.wth = wth;
+
+	sharkd_session_process_request(tok_method, buf, tokens, count);
+	_exit(0);
+}
+#endif /* _WIN32 */
+
 static void
 sharkd_session_process(char *buf, const jsmntok_t *tokens, int count)
 {
@@ -4972,50 +5774,13 @@ sharkd_session_process(char *buf, const jsmntok_t *tokens, int count)
 				"No method found");
 			return;
 		}
-		if (!strcmp(tok_method, "load"))
-			sharkd_session_process_load(buf, tokens, count);
-		else if (!strcmp(tok_method, "status"))
-			sharkd_session_process_status();
-		else if (!strcmp(tok_method, "analyse"))
-			sharkd_session_process_analyse();
-		else if (!strcmp(tok_method, "info"))
-			sharkd_session_process_info();
-		else if (!strcmp(tok_method, "check"))
-			sharkd_session_process_check(buf, tokens, count);
-		else if (!strcmp(tok_method, "complete"))
-			sharkd_session_process_complete(buf, tokens, count);
-		else if (!strcmp(tok_method, "frames"))
-			sharkd_session_process_frames(buf, tokens, count);
-		else if (!strcmp(tok_method, "tap"))
-			sharkd_session_process_tap(buf, tokens, count);
-		else if (!strcmp(tok_method, "follow"))
-			sharkd_session_process_follow(buf, tokens, count);
-		else if (!strcmp(tok_method, "iograph"))
-			sharkd_session_process_iograph(buf, tokens, count);
-		else if (!strcmp(tok_method, "intervals"))
-			sharkd_session_process_intervals(buf, tokens, count);
-		else if (!strcmp(tok_method, "frame"))
-			sharkd_session_process_frame(buf, tokens, count);
-		else if (!strcmp(tok_method, "setcomment"))
-			sharkd_session_process_setcomment(buf, tokens, count);
-		else if (!strcmp(tok_method, "setconf"))
-			sharkd_session_process_setconf(buf, tokens, count);
-		else if (!strcmp(tok_method, "dumpconf"))
-			sharkd_session_process_dumpconf(buf, tokens, count);
-		else if (!strcmp(tok_method, "download"))
-			sharkd_session_process_download(buf, tokens, count);
-		else if (!strcmp(tok_method, "bye"))
-		{
-			sharkd_json_simple_ok(rpcid);
-			exit(0);
-		}
-		else
-		{
-			sharkd_json_error(
-				rpcid, -32601, NULL,
-				"The method \"%s\" is unknown", tok_method
-			);
-		}
+
+#ifndef _WIN32
+		if (sharkd_session_process_in_worker(tok_method, buf, tokens, count))
+			return;
+#endif
+
+		sharkd_session_process_request(tok_method, buf, tokens, count);
 	}
 }
 
@@ -5032,6 +5797,36 @@ sharkd_session_main(int mode_setting)
 
 	dumper.output_file = stdout;
 
+#ifndef _WIN32
+	{
+		const char *workers_env = g_getenv("SHARKD_WORKERS");
+
+		if (workers_env != NULL && ws_strtou32(workers_env, NULL, &workers_max) && workers_max != 0)
+		{
+			response_file = tmpfile();
+			response_lock_file = tmpfile();
+			if (response_file != NULL && response_lock_file != NULL)
+			{
+				dumper.output_file = response_file;
+				/* Classic console mode ignores SIGCHLD; we
+				   need to wait for our workers. */
+				signal(SIGCHLD, SIG_DFL);
+			}
+			else
+				workers_max = 0;
+		}
+		else
+			workers_max = 0;
+	}
+#endif
+
+	{
+		const char *limit_env = g_getenv("SHARKD_MEMORY_LIMIT");
+
+		if (limit_env != NULL && !ws_strtou64(limit_env, NULL, &memory_limit))
+			memory_limit = 0;
+	}
+
 	filter_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, sharkd_session_filter_free);
 
 #ifdef HAVE_MAXMINDDB
@@ -5078,6 +5873,25 @@ sharkd_session_main(int mode_setting)
 		host_name_lookup_process();
 
 		sharkd_session_process(buf, tokens, ret);
+
+		/* File-scope analysis state only grows while a capture stays
+		   open.  When a budget is set, return the pools' unused
+		   blocks to the OS once we cross it, and tell the operator;
+		   the state itself can only be released by loading another
+		   capture. */
+		if (memory_limit != 0 &&
+		    wmem_allocator_bytes_allocated(wmem_file_scope()) > memory_limit)
+		{
+			wmem_gc(wmem_file_scope());
+			if (!memory_limit_warned)
+			{
+				fprintf(stderr, "sharkd: analysis state (%" G_GUINT64_FORMAT " bytes) is over SHARKD_MEMORY_LIMIT (%" G_GUINT64_FORMAT " bytes)\n",
+					wmem_allocator_bytes_allocated(wmem_file_scope()), memory_limit);
+				memory_limit_warned = TRUE;
+			}
+		}
+		else
+			memory_limit_warned = FALSE;	/* counter resets with the next capture */
 	}
 
 	g_hash_table_destroy(filter_table);
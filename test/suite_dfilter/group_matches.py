@@ -0,0 +1,49 @@
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+import unittest
+import fixtures
+from suite_dfilter.dfiltertest import *
+
+
+@fixtures.uses_fixtures
+class case_matches(unittest.TestCase):
+    trace_file = "http.pcap"
+
+    def test_matches_1(self, checkDFilterCount):
+        dfilter = 'http.request.method matches "^HEAD$"'
+        checkDFilterCount(dfilter, 1)
+
+    def test_matches_2(self, checkDFilterCount):
+        dfilter = 'http.request.method matches "^POST$"'
+        checkDFilterCount(dfilter, 0)
+
+    def test_matches_caseless(self, checkDFilterCount):
+        dfilter = 'http.request.method matches "head"'
+        checkDFilterCount(dfilter, 1)
+
+    # "matches" with \xNN escapes in a raw string; the hex digits must
+    # not be mistaken for literal pattern text.
+
+    def test_matches_hex_1(self, checkDFilterCount):
+        dfilter = r'http.request.method matches r"\x48EAD"'
+        checkDFilterCount(dfilter, 1)
+
+    def test_matches_hex_2(self, checkDFilterCount):
+        dfilter = r'http.request.method matches r"\x48\x45\x41\x44"'
+        checkDFilterCount(dfilter, 1)
+
+    def test_matches_hex_3(self, checkDFilterCount):
+        dfilter = r'http.request.method matches r"\x50OST"'
+        checkDFilterCount(dfilter, 0)
+
+    def test_matches_hex_caseless(self, checkDFilterCount):
+        dfilter = r'http.request.method matches r"\x68ead"'
+        checkDFilterCount(dfilter, 1)
+
+    def test_matches_hex_brace(self, checkDFilterCount):
+        dfilter = r'http.request.method matches r"\x{48}EAD"'
+        checkDFilterCount(dfilter, 1)
+
+    def test_matches_hex_quantifier(self, checkDFilterCount):
+        dfilter = r'http.request.method matches r"HEA\x44+"'
+        checkDFilterCount(dfilter, 1)
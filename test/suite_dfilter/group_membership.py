@@ -58,3 +58,23 @@ class case_membership(unittest.TestCase):
         dfilter = 'frame.number in {1 "foo"}'
         error = '"foo" cannot be converted to Unsigned integer, 4 bytes.'
         checkDFilterFail(dfilter, error)
+
+    def test_membership_12_large_set_match(self, checkDFilterCount):
+        # A set this large is probed through a hash table rather than
+        # element-by-element; the result must not change.
+        dfilter = 'tcp.port in {70 71 72 73 74 75 76 77 78 79 80 81 82 83 84 85 86 87}'
+        checkDFilterCount(dfilter, 1)
+
+    def test_membership_13_large_set_no_match(self, checkDFilterCount):
+        dfilter = 'tcp.port in {1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18}'
+        checkDFilterCount(dfilter, 0)
+
+    def test_membership_14_large_set_with_range_match(self, checkDFilterCount):
+        # Ranges can't be hashed; they must still be tested alongside the
+        # hashed constants.
+        dfilter = 'tcp.port in {1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 3200..3300}'
+        checkDFilterCount(dfilter, 1)
+
+    def test_membership_15_large_set_with_range_no_match(self, checkDFilterCount):
+        dfilter = 'tcp.port in {1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 81..3266}'
+        checkDFilterCount(dfilter, 0)
@@ -0,0 +1,97 @@
+#
+# Wireshark tests
+# By Gerald Combs <gerald@wireshark.org>
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+'''Editcap tests'''
+
+import subprocesstest
+import fixtures
+
+testout_pcap = 'testout.pcap'
+
+
+@fixtures.mark_usefixtures('test_env')
+@fixtures.uses_fixtures
+class case_editcap_compare(subprocesstest.SubprocessTestCase):
+    def test_editcap_compare_identical(self, cmd_editcap, capture_file):
+        '''--compare with the same capture on both sides matches every packet.'''
+        self.assertRun((cmd_editcap, '--compare',
+            capture_file('dhcp.pcap'), capture_file('dhcp.pcap')))
+        self.assertTrue(self.grepOutput('Matched: 4'))
+        self.assertTrue(self.grepOutput('Only in A: 0'))
+        self.assertTrue(self.grepOutput('Only in B: 0'))
+        self.assertTrue(self.grepOutput('Delay B-A'))
+
+    def test_editcap_compare_missing_packet(self, cmd_editcap, capture_file):
+        '''--compare reports a packet present in only one of the captures.'''
+        subset_file = self.filename_from_id(testout_pcap)
+        self.assertRun((cmd_editcap, '-r',
+            capture_file('dhcp.pcap'), subset_file, '1-3'))
+        self.assertRun((cmd_editcap, '-v', '--compare',
+            capture_file('dhcp.pcap'), subset_file))
+        self.assertTrue(self.grepOutput('Matched: 3'))
+        self.assertTrue(self.grepOutput('Only in A: 1'))
+        self.assertTrue(self.grepOutput('Only in B: 0'))
+        self.assertTrue(self.grepOutput('only in file A'))
+
+    def test_editcap_compare_window(self, cmd_editcap, capture_file):
+        '''--compare accepts an explicit time window.'''
+        self.assertRun((cmd_editcap, '--compare=0.5',
+            capture_file('dhcp.pcap'), capture_file('dhcp.pcap')))
+        self.assertTrue(self.grepOutput('Matched: 4'))
+
+    def test_editcap_compare_requires_two_files(self, cmd_editcap, capture_file):
+        '''--compare rejects more than two capture files.'''
+        self.assertRun((cmd_editcap, '--compare',
+            capture_file('dhcp.pcap'), capture_file('dhcp.pcap'),
+            capture_file('dhcp.pcap')),
+            expected_return=1)
+        self.assertTrue(self.grepOutput('requires exactly two capture files'))
+
+
+@fixtures.mark_usefixtures('test_env')
+@fixtures.uses_fixtures
+class case_editcap_snap_headers(subprocesstest.SubprocessTestCase):
+    def test_editcap_snap_headers(self, cmd_editcap, cmd_tshark, capture_file):
+        '''--snap-headers truncates packets at the end of the transport header.'''
+        testout_file = self.filename_from_id(testout_pcap)
+        self.assertRun((cmd_editcap, '--snap-headers',
+            capture_file('dhcp.pcap'), testout_file))
+        proc = self.assertRun((cmd_tshark, '-r', testout_file,
+            '-T', 'fields', '-e', 'frame.cap_len', '-e', 'frame.len'))
+        lines = proc.stdout_str.splitlines()
+        self.assertEqual(len(lines), 4)
+        for line in lines:
+            cap_len, length = line.split('\t')
+            # Every packet in dhcp.pcap is Ethernet + IPv4 + UDP.
+            self.assertEqual(int(cap_len), 14 + 20 + 8)
+            # Without -L the reported length is left alone.
+            self.assertGreater(int(length), 14 + 20 + 8)
+
+    def test_editcap_snap_headers_adjlen(self, cmd_editcap, cmd_tshark, capture_file):
+        '''--snap-headers with -L also adjusts the reported length.'''
+        testout_file = self.filename_from_id(testout_pcap)
+        self.assertRun((cmd_editcap, '--snap-headers', '-L',
+            capture_file('dhcp.pcap'), testout_file))
+        proc = self.assertRun((cmd_tshark, '-r', testout_file,
+            '-T', 'fields', '-e', 'frame.cap_len', '-e', 'frame.len'))
+        lines = proc.stdout_str.splitlines()
+        self.assertEqual(len(lines), 4)
+        for line in lines:
+            cap_len, length = line.split('\t')
+            self.assertEqual(int(cap_len), 14 + 20 + 8)
+            self.assertEqual(int(length), 14 + 20 + 8)
+
+
+@fixtures.mark_usefixtures('test_env')
+@fixtures.uses_fixtures
+class case_editcap_stop_time(subprocesstest.SubprocessTestCase):
+    def test_editcap_stop_after_stop_time_requires_B(self, cmd_editcap, capture_file):
+        '''--stop-after-stop-time is rejected without a -B stop time.'''
+        testout_file = self.filename_from_id(testout_pcap)
+        self.assertRun((cmd_editcap, '--stop-after-stop-time',
+            capture_file('dhcp.pcap'), testout_file),
+            expected_return=1)
+        self.assertTrue(self.grepOutput('requires a -B stop time'))
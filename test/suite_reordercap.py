@@ -0,0 +1,54 @@
+#
+# Wireshark tests
+# By Gerald Combs <gerald@wireshark.org>
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+'''Reordercap tests'''
+
+import subprocesstest
+import fixtures
+
+testout_pcap = 'testout.pcap'
+testout2_pcap = 'testout2.pcap'
+
+
+@fixtures.mark_usefixtures('test_env')
+@fixtures.uses_fixtures
+class case_reordercap(subprocesstest.SubprocessTestCase):
+    def frame_summaries(self, cmd_tshark, cap_file):
+        '''Return (time, length) per frame, and check the times are sorted.'''
+        proc = self.assertRun((cmd_tshark, '-r', cap_file,
+            '-T', 'fields', '-e', 'frame.time_epoch', '-e', 'frame.len'))
+        frames = [line.split('\t') for line in proc.stdout_str.splitlines()]
+        times = [float(frame[0]) for frame in frames]
+        self.assertEqual(times, sorted(times))
+        return frames
+
+    def test_reordercap_basic(self, cmd_reordercap, cmd_tshark, capture_file):
+        '''reordercap writes the input's frames in timestamp order.'''
+        testout_file = self.filename_from_id(testout_pcap)
+        self.assertRun((cmd_reordercap,
+            capture_file('dhcp.pcap'), testout_file))
+        self.assertTrue(self.grepOutput('4 frames, 0 out of order'))
+        self.assertEqual(len(self.frame_summaries(cmd_tshark, testout_file)), 4)
+
+    def test_reordercap_bounded_memory(self, cmd_reordercap, cmd_tshark, capture_file):
+        '''reordercap -M produces the same order as the in-memory sort.'''
+        testout_file = self.filename_from_id(testout_pcap)
+        testout2_file = self.filename_from_id(testout2_pcap)
+        self.assertRun((cmd_reordercap,
+            capture_file('dhcp.pcap'), testout_file))
+        self.assertRun((cmd_reordercap, '-M', '1',
+            capture_file('dhcp.pcap'), testout2_file))
+        self.assertTrue(self.grepOutput('4 frames, 0 out of order'))
+        self.assertEqual(self.frame_summaries(cmd_tshark, testout_file),
+            self.frame_summaries(cmd_tshark, testout2_file))
+
+    def test_reordercap_bounded_memory_bad_limit(self, cmd_reordercap, capture_file):
+        '''reordercap -M rejects a zero memory limit.'''
+        testout_file = self.filename_from_id(testout_pcap)
+        self.assertRun((cmd_reordercap, '-M', '0',
+            capture_file('dhcp.pcap'), testout_file),
+            expected_return=1)
+        self.assertTrue(self.grepOutput("isn't a valid memory limit"))
@@ -242,8 +242,6 @@ static FILE       *output_file = NULL;
 /* Offset base to parse */
 static guint32 offset_base = 16;
 
-extern FILE *text2pcap_in;
-
 /* ----- State machine -----------------------------------------------------------*/
 
 /* Current state of parser */
@@ -1358,6 +1356,121 @@ fail_null_str:
     return EXIT_FAILURE;
 }
 
+/*----------------------------------------------------------------------
+ * Fast path for the overwhelmingly common case of a canonical hex dump
+ * line, "offset: byte byte byte ...".  Feeds parse_token() the same
+ * token sequence the scanner would produce for such a line, but decodes
+ * the line with straight-line code instead of the scanner machinery.
+ * Returns FALSE, without consuming anything, if the line is not of that
+ * form - ASCII dump columns, preamble text, directives, comments, ">"
+ * quoting and so on; those lines must go through the scanner, which is
+ * the only thing that reproduces the parser's handling of them exactly.
+ * On TRUE, *status is the result of the parse_token() calls.
+ */
+static gboolean
+parse_canonical_hexdump_line(const char *line, int *status)
+{
+    const char *p = line;
+    const char *bytes_start;
+    gsize       offset_len;
+    char        tok[12];
+
+    *status = EXIT_SUCCESS;
+
+    /* An offset token: a run of hex digits followed by ':', ' ' or '\t'.
+       (Octal and decimal offsets, with -o, are a subset of this; the
+       token text is what determines how it is parsed, and it is the
+       same one the scanner would hand to parse_token().) */
+    while (g_ascii_isxdigit(*p))
+        p++;
+    offset_len = p - line;
+    if (offset_len == 0 || offset_len > 8)
+        return FALSE;
+    if (*p != ':' && *p != ' ' && *p != '\t')
+        return FALSE;
+    p++;        /* the separator is part of the offset token */
+
+    /* Byte tokens: pairs of hex digits, each followed by a single
+       separator or the end of the line.  Anything else - in particular
+       an ASCII dump column - disqualifies the whole line. */
+    bytes_start = p;
+    for (;;) {
+        while (*p == ' ' || *p == '\t')
+            p++;
+        if (*p == '\0' || *p == '\n' || (*p == '\r' && p[1] == '\n'))
+            break;
+        if (!g_ascii_isxdigit(p[0]) || !g_ascii_isxdigit(p[1]))
+            return FALSE;
+        if (p[2] != ' ' && p[2] != '\t' && p[2] != '\0' && p[2] != '\n' &&
+            !(p[2] == '\r' && p[3] == '\n'))
+            return FALSE;
+        p += 2;
+    }
+
+    /* The line is canonical; emit the tokens. */
+    memcpy(tok, line, offset_len + 1);
+    tok[offset_len + 1] = '\0';
+    *status = parse_token(T_OFFSET, tok);
+    if (*status != EXIT_SUCCESS)
+        return TRUE;
+
+    p = bytes_start;
+    for (;;) {
+        while (*p == ' ' || *p == '\t')
+            p++;
+        if (*p == '\0' || *p == '\n' || *p == '\r')
+            break;
+        tok[0] = p[0];
+        tok[1] = p[1];
+        tok[2] = '\0';
+        *status = parse_token(T_BYTE, tok);
+        if (*status != EXIT_SUCCESS)
+            return TRUE;
+        p += 2;
+    }
+
+    if (*p != '\0') {
+        /* The line ends in a newline; the scanner reports that, too. */
+        *status = parse_token(T_EOL, NULL);
+    }
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------
+ * Read the input line by line, decoding canonical hex dump lines
+ * directly and handing everything else to the scanner.
+ */
+static int
+process_input(void)
+{
+    GString *line = g_string_sized_new(256);
+    char     buf[4096];
+    int      status = EXIT_SUCCESS;
+
+    while (fgets(buf, sizeof buf, input_file) != NULL) {
+        g_string_append(line, buf);
+        if (line->str[line->len - 1] != '\n')
+            continue;   /* Line longer than the buffer; keep reading */
+
+        if (!parse_canonical_hexdump_line(line->str, &status))
+            status = text2pcap_scan_line(line->str);
+        if (status != EXIT_SUCCESS)
+            break;
+        g_string_truncate(line, 0);
+    }
+
+    /* Process a final line with no terminating newline */
+    if (status == EXIT_SUCCESS && line->len > 0 &&
+        line->str[line->len - 1] != '\n') {
+        if (!parse_canonical_hexdump_line(line->str, &status))
+            status = text2pcap_scan_line(line->str);
+    }
+
+    g_string_free(line, TRUE);
+    text2pcap_scan_cleanup();
+    return status;
+}
+
 /*----------------------------------------------------------------------
  * Print usage string and exit
  */
@@ -1923,8 +2036,7 @@ main(int argc, char *argv[])
     }
     curr_offset = header_length;
 
-    text2pcap_in = input_file;
-    if (text2pcap_scan() == EXIT_SUCCESS) {
+    if (process_input() == EXIT_SUCCESS) {
         if (write_current_packet(FALSE) != EXIT_SUCCESS)
             ret = EXIT_FAILURE;
     } else {
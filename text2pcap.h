@@ -27,7 +27,9 @@ typedef enum {
 
 int parse_token(token_t token, char *str);
 
-int text2pcap_scan(void);
+int text2pcap_scan_line(const char *line);
+
+void text2pcap_scan_cleanup(void);
 
 #endif
 
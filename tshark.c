@@ -58,6 +58,7 @@
 #include <wsutil/privileges.h>
 #include <wsutil/report_message.h>
 #include <wsutil/please_report_bug.h>
+#include <wsutil/pipeline_stats.h>
 #include <wsutil/wslog.h>
 #include <wsutil/ws_assert.h>
 #include <cli_main.h>
@@ -71,6 +72,7 @@
 #include <epan/wslua/init_wslua.h>
 #endif
 #include "frame_tvbuff.h"
+#include <epan/frame_class.h>
 #include <epan/disabled_protos.h>
 #include <epan/prefs.h>
 #include <epan/column.h>
@@ -122,6 +124,8 @@
 
 #include <wsutil/str_util.h>
 #include <wsutil/utf8_entities.h>
+#include <wsutil/inet_addr.h>
+#include <wsutil/pint.h>
 #include <wsutil/json_dumper.h>
 #include <wsutil/wslog.h>
 #ifdef _WIN32
@@ -145,6 +149,8 @@
 #define LONGOPT_ELASTIC_MAPPING_FILTER  LONGOPT_BASE_APPLICATION+4
 #define LONGOPT_EXPORT_TLS_SESSION_KEYS LONGOPT_BASE_APPLICATION+5
 #define LONGOPT_CAPTURE_COMMENT         LONGOPT_BASE_APPLICATION+6
+#define LONGOPT_FLOW_SAMPLE             LONGOPT_BASE_APPLICATION+7
+#define LONGOPT_AUTO_CAPTURE_FILTER     LONGOPT_BASE_APPLICATION+8
 
 capture_file cfile;
 
@@ -155,6 +161,8 @@ static frame_data prev_cap_frame;
 
 static gboolean perform_two_pass_analysis;
 static guint32 epan_auto_reset_count = 0;
+static guint32 epan_auto_reset_interval = 0;  /* seconds; 0 if not time-based */
+static gint64 epan_auto_reset_deadline = 0;   /* monotonic time of the next reset */
 static gboolean epan_auto_reset = FALSE;
 
 /*
@@ -176,6 +184,7 @@ static gboolean do_dissection;     /* TRUE if we have to dissect each packet */
 static gboolean print_packet_info; /* TRUE if we're to print packet information */
 static gboolean print_summary;     /* TRUE if we're to print packet summary information */
 static gboolean print_details;     /* TRUE if we're to print packet details information */
+static gboolean extract_fields_only; /* TRUE if only the fields given with -e have to be dissected */
 static gboolean print_hex;         /* TRUE if we're to print hex/ascii information */
 static gboolean line_buffered;
 static gboolean quiet = FALSE;
@@ -215,6 +224,16 @@ static capture_options global_capture_opts;
 static capture_session global_capture_session;
 static info_data_t global_info_data;
 
+/*
+ * Flow sampling (--flow-sample): during a live capture, every packet we
+ * read from the capture child is accounted in a 5-tuple flow table built
+ * by a lightweight header parse of the raw bytes, but only one packet in
+ * every flow_sample_interval goes through full dissection.
+ */
+static guint32 flow_sample_interval; /* 0 or 1 - every packet is dissected */
+static GHashTable *flow_sample_table;
+static guint64 flow_sample_tally;    /* all packets fed to the flow table */
+
 #ifdef SIGINFO
 static gboolean infodelay;      /* if TRUE, don't print capture info in SIGINFO handler */
 static gboolean infoprint;      /* if TRUE, print capture info after clearing infodelay */
@@ -348,6 +367,10 @@ print_usage(FILE *output)
   fprintf(output, "  -i <interface>, --interface <interface>\n");
   fprintf(output, "                           name or idx of interface (def: first non-loopback)\n");
   fprintf(output, "  -f <capture filter>      packet filter in libpcap filter syntax\n");
+  fprintf(output, "  --auto-capture-filter    derive a capture filter from the -Y display filter\n");
+  fprintf(output, "                           for interfaces without an explicit -f filter; the\n");
+  fprintf(output, "                           derivation only looks at outermost headers and can\n");
+  fprintf(output, "                           drop tunnelled traffic the display filter would match\n");
   fprintf(output, "  -s <snaplen>, --snapshot-length <snaplen>\n");
 #ifdef HAVE_PCAP_CREATE
   fprintf(output, "                           packet snapshot length (def: appropriate maximum)\n");
@@ -400,7 +423,12 @@ print_usage(FILE *output)
   fprintf(output, "\n");
   fprintf(output, "Processing:\n");
   fprintf(output, "  -2                       perform a two-pass analysis\n");
-  fprintf(output, "  -M <packet count>        perform session auto reset\n");
+  fprintf(output, "  -M <packet count>|duration:NUM\n");
+  fprintf(output, "                           perform session auto reset after the given number of\n");
+  fprintf(output, "                           packets or, with duration:NUM, every NUM seconds\n");
+  fprintf(output, "  --flow-sample <interval> when capturing, fully dissect only 1 packet in every\n");
+  fprintf(output, "                           <interval>; account all packets in a 5-tuple flow\n");
+  fprintf(output, "                           table printed when the capture ends\n");
   fprintf(output, "  -R <read filter>, --read-filter <read filter>\n");
   fprintf(output, "                           packet Read filter in Wireshark display filter syntax\n");
   fprintf(output, "                           (requires -2)\n");
@@ -711,6 +739,8 @@ main(int argc, char *argv[])
     {"no-duplicate-keys", no_argument, NULL, LONGOPT_NO_DUPLICATE_KEYS},
     {"elastic-mapping-filter", required_argument, NULL, LONGOPT_ELASTIC_MAPPING_FILTER},
     {"capture-comment", required_argument, NULL, LONGOPT_CAPTURE_COMMENT},
+    {"flow-sample", required_argument, NULL, LONGOPT_FLOW_SAMPLE},
+    {"auto-capture-filter", no_argument, NULL, LONGOPT_AUTO_CAPTURE_FILTER},
     {0, 0, 0, 0 }
   };
   gboolean             arg_error = FALSE;
@@ -727,6 +757,7 @@ main(int argc, char *argv[])
   GList               *if_list;
   gchar               *err_str, *err_str_secondary;
   struct bpf_program   fcode;
+  gboolean             auto_cfilter_requested = FALSE;
 #else
   gboolean             capture_option_specified = FALSE;
   volatile int         max_packet_count = 0;
@@ -746,6 +777,7 @@ main(int argc, char *argv[])
   const gchar         *volatile tls_session_keys_file = NULL;
   exp_pdu_t            exp_pdu_tap_data;
   const gchar*         elastic_mapping_filter = NULL;
+  gboolean             taps_requested = FALSE;
 
 /*
  * The leading + ensures that getopt_long() does not permute the argv[]
@@ -1086,7 +1118,14 @@ main(int argc, char *argv[])
         cmdarg_err("-M does not support two pass analysis.");
         arg_error=TRUE;
       }
-      epan_auto_reset_count = get_positive_int(optarg, "epan reset count");
+      if (strncmp(optarg, "duration:", strlen("duration:")) == 0) {
+        epan_auto_reset_interval = get_positive_int(optarg + strlen("duration:"),
+                                                    "epan reset interval");
+        epan_auto_reset_deadline = g_get_monotonic_time() +
+                                   (gint64)epan_auto_reset_interval * G_USEC_PER_SEC;
+      } else {
+        epan_auto_reset_count = get_positive_int(optarg, "epan reset count");
+      }
       epan_auto_reset = TRUE;
       break;
     case 'a':        /* autostop criteria */
@@ -1441,6 +1480,7 @@ main(int argc, char *argv[])
         exit_status = INVALID_OPTION;
         goto clean_exit;
       }
+      taps_requested = TRUE;
       break;
     case 'd':        /* Decode as rule */
     case 'K':        /* Kerberos keytab file */
@@ -1468,6 +1508,7 @@ main(int argc, char *argv[])
         exit_status = INVALID_OPTION;
         goto clean_exit;
       }
+      taps_requested = TRUE;
       break;
     case LONGOPT_EXPORT_TLS_SESSION_KEYS:   /* --export-tls-session-keys */
       tls_session_keys_file = optarg;
@@ -1485,6 +1526,22 @@ main(int argc, char *argv[])
       }
       g_ptr_array_add(capture_comments, g_strdup(optarg));
       break;
+    case LONGOPT_FLOW_SAMPLE:  /* fully dissect only 1 in N captured packets */
+#ifdef HAVE_LIBPCAP
+      flow_sample_interval = get_positive_int(optarg, "flow sample interval");
+#else
+      capture_option_specified = TRUE;
+      arg_error = TRUE;
+#endif
+      break;
+    case LONGOPT_AUTO_CAPTURE_FILTER:  /* derive a capture filter from -Y */
+#ifdef HAVE_LIBPCAP
+      auto_cfilter_requested = TRUE;
+#else
+      capture_option_specified = TRUE;
+      arg_error = TRUE;
+#endif
+      break;
     default:
     case '?':        /* Bad flag - print usage message */
       switch(optopt) {
@@ -1689,6 +1746,18 @@ main(int argc, char *argv[])
         exit_status = INVALID_OPTION;
         goto clean_exit;
       }
+      if (flow_sample_interval > 1) {
+        cmdarg_err("Flow sampling was requested, but "
+                   "a capture isn't being done.");
+        exit_status = INVALID_OPTION;
+        goto clean_exit;
+      }
+      if (auto_cfilter_requested) {
+        cmdarg_err("A capture filter derived from the display filter was requested, but "
+                   "a capture isn't being done.");
+        exit_status = INVALID_OPTION;
+        goto clean_exit;
+      }
       if (global_capture_opts.has_file_duration) {
         cmdarg_err("Switching capture files after a time period was specified, but "
                    "a capture isn't being done.");
@@ -1996,6 +2065,62 @@ main(int argc, char *argv[])
   }
   cfile.dfcode = dfcode;
 
+#ifdef HAVE_LIBPCAP
+  if (auto_cfilter_requested) {
+    /* The user asked us to derive a capture filter from the display
+       filter, so packets the display filter can never accept are
+       dropped in the kernel instead of being dissected and discarded.
+       The display filter is still applied to whatever gets through.
+       This is opt-in because the translation is not exact: it only
+       looks at the outermost headers, so tunnelled traffic the display
+       filter would match after decapsulation or reassembly never makes
+       it into the capture, and filters that depend on cross-packet
+       state can lose the packets that set that state up. */
+    const gchar *auto_cfilter;
+    gboolean installed = FALSE;
+    guint i;
+
+    if (dfcode == NULL) {
+      cmdarg_err("--auto-capture-filter was specified, but there's no "
+                 "display filter to derive a capture filter from.");
+      exit_status = INVALID_OPTION;
+      goto clean_exit;
+    }
+    if (taps_requested) {
+      /* Taps see every captured packet, so narrowing the capture
+         would silently change -z and --export-objects results. */
+      cmdarg_err("--auto-capture-filter can't be used together with "
+                 "-z or --export-objects.");
+      exit_status = INVALID_OPTION;
+      goto clean_exit;
+    }
+    auto_cfilter = dfilter_pcap_text(dfcode);
+    if (auto_cfilter == NULL) {
+      cmdarg_err("No part of the display filter \"%s\" can be "
+                 "translated into a capture filter.", dfilter);
+      exit_status = INVALID_FILTER;
+      goto clean_exit;
+    }
+
+    for (i = 0; i < global_capture_opts.ifaces->len; i++) {
+      interface_options *interface_opts;
+
+      interface_opts = &g_array_index(global_capture_opts.ifaces, interface_options, i);
+      if (interface_opts->cfilter == NULL) {
+        interface_opts->cfilter = g_strdup(auto_cfilter);
+        installed = TRUE;
+      }
+    }
+    if (global_capture_opts.default_options.cfilter == NULL) {
+      global_capture_opts.default_options.cfilter = g_strdup(auto_cfilter);
+      installed = TRUE;
+    }
+    if (installed && really_quiet == FALSE)
+      fprintf(stderr, "Capture filter derived from display filter: %s\n",
+              auto_cfilter);
+  }
+#endif
+
   if (print_packet_info) {
     /* If we're printing as text or PostScript, we have
        to create a print stream. */
@@ -2322,8 +2447,15 @@ main(int argc, char *argv[])
     cfile.provider.frames = NULL;
   }
 
-  if (draw_taps)
+  if (draw_taps) {
+    draw_manifest_report(perform_two_pass_analysis ? 2 : 1);
     draw_tap_listeners(TRUE);
+  }
+
+#ifdef HAVE_LIBPCAP
+  if (flow_sample_interval > 1)
+    flow_sample_report();
+#endif
 
   if (tls_session_keys_file) {
     gsize keylist_length;
@@ -2747,6 +2879,278 @@ capture_input_new_file(capture_session *cap_session, gchar *new_file)
 }
 
 
+/*
+ * Flow sampling support.  This is deliberately not built on epan: the
+ * point is to keep per-packet accounting down to a header parse and a
+ * hash probe, so we pull the 5-tuple straight out of the raw bytes.
+ * Anything we can't classify (non-IP, truncated headers, link layers we
+ * don't handle here) is lumped into a single all-zero "unclassified"
+ * bucket; its frames and bytes are still counted.
+ */
+struct flow_sample_key {
+  guint8  af;        /* 0 = unclassified, 4 = IPv4, 6 = IPv6 */
+  guint8  proto;     /* IP protocol number */
+  guint16 src_port;  /* 0 if the transport has no ports or was cut off */
+  guint16 dst_port;
+  guint8  src[16];   /* IPv4 addresses use the first 4 bytes */
+  guint8  dst[16];
+};
+
+struct flow_sample_val {
+  guint64 frames;
+  guint64 bytes;
+};
+
+static guint
+flow_sample_key_hash(gconstpointer v)
+{
+  const guint8 *p = (const guint8 *)v;
+  guint hash = 5381;
+  size_t i;
+
+  for (i = 0; i < sizeof(struct flow_sample_key); i++)
+    hash = (hash << 5) + hash + p[i];
+  return hash;
+}
+
+static gboolean
+flow_sample_key_equal(gconstpointer a, gconstpointer b)
+{
+  /* Keys are zeroed before they're filled in, so padding compares equal. */
+  return memcmp(a, b, sizeof(struct flow_sample_key)) == 0;
+}
+
+static void
+flow_sample_parse_ports(const guint8 *pd, guint caplen,
+                        struct flow_sample_key *key)
+{
+  switch (key->proto) {
+  case 6:    /* TCP */
+  case 17:   /* UDP */
+  case 132:  /* SCTP */
+    if (caplen >= 4) {
+      key->src_port = pntoh16(pd);
+      key->dst_port = pntoh16(pd + 2);
+    }
+    break;
+  }
+}
+
+static void
+flow_sample_parse_ip(const guint8 *pd, guint caplen,
+                     struct flow_sample_key *key)
+{
+  if (caplen < 1)
+    return;
+  switch (pd[0] >> 4) {
+  case 4:
+  {
+    guint hlen;
+
+    if (caplen < 20)
+      return;
+    hlen = (pd[0] & 0x0f) * 4;
+    if (hlen < 20 || caplen < hlen)
+      return;
+    key->af = 4;
+    key->proto = pd[9];
+    memcpy(key->src, pd + 12, 4);
+    memcpy(key->dst, pd + 16, 4);
+    /* Only the first fragment has a transport header after the IP
+       header; for the others, leave the ports zero. */
+    if ((pntoh16(pd + 6) & 0x1fff) != 0)
+      return;
+    flow_sample_parse_ports(pd + hlen, caplen - hlen, key);
+    break;
+  }
+  case 6:
+  {
+    guint8 nxt;
+    guint off;
+
+    if (caplen < 40)
+      return;
+    key->af = 6;
+    memcpy(key->src, pd + 8, 16);
+    memcpy(key->dst, pd + 24, 16);
+    nxt = pd[6];
+    off = 40;
+    /* Walk the extension header chain to the transport header. */
+    for (;;) {
+      if (nxt == 0 || nxt == 43 || nxt == 60) {
+        /* hop-by-hop options, routing, destination options */
+        if (caplen < off + 8)
+          return;
+        nxt = pd[off];
+        off += (pd[off + 1] + 1) * 8;
+        if (caplen < off)
+          return;
+      } else if (nxt == 44) {
+        /* fragment header; ports only from the first fragment */
+        if (caplen < off + 8)
+          return;
+        nxt = pd[off];
+        if ((pntoh16(pd + off + 2) & 0xfff8) != 0) {
+          key->proto = nxt;
+          return;
+        }
+        off += 8;
+      } else {
+        break;
+      }
+    }
+    key->proto = nxt;
+    flow_sample_parse_ports(pd + off, caplen - off, key);
+    break;
+  }
+  }
+}
+
+static void
+flow_sample_parse(const guint8 *pd, guint caplen, int encap,
+                  struct flow_sample_key *key)
+{
+  switch (encap) {
+  case WTAP_ENCAP_ETHERNET:
+  {
+    guint16 etype;
+    guint off = 12;
+
+    if (caplen < 14)
+      return;
+    etype = pntoh16(pd + off);
+    /* Step over VLAN tags. */
+    while (etype == 0x8100 || etype == 0x88a8 || etype == 0x9100) {
+      off += 4;
+      if (caplen < off + 2)
+        return;
+      etype = pntoh16(pd + off);
+    }
+    if (etype == 0x0800 || etype == 0x86dd)
+      flow_sample_parse_ip(pd + off + 2, caplen - (off + 2), key);
+    break;
+  }
+  case WTAP_ENCAP_RAW_IP:
+    flow_sample_parse_ip(pd, caplen, key);
+    break;
+  }
+}
+
+static void
+flow_sample_add(const wtap_rec *rec, const guint8 *pd)
+{
+  struct flow_sample_key key;
+  struct flow_sample_val *val;
+
+  memset(&key, 0, sizeof(key));
+  flow_sample_parse(pd, rec->rec_header.packet_header.caplen,
+                    rec->rec_header.packet_header.pkt_encap, &key);
+
+  if (flow_sample_table == NULL)
+    flow_sample_table = g_hash_table_new_full(flow_sample_key_hash,
+                                              flow_sample_key_equal,
+                                              g_free, g_free);
+  val = (struct flow_sample_val *)g_hash_table_lookup(flow_sample_table, &key);
+  if (val == NULL) {
+    struct flow_sample_key *kcopy = g_new(struct flow_sample_key, 1);
+
+    *kcopy = key;
+    val = g_new0(struct flow_sample_val, 1);
+    g_hash_table_insert(flow_sample_table, kcopy, val);
+  }
+  val->frames++;
+  val->bytes += rec->rec_header.packet_header.len;
+  flow_sample_tally++;
+}
+
+static const char *
+flow_sample_proto_name(guint8 proto, char *buf, size_t buf_size)
+{
+  switch (proto) {
+  case 1:   return "ICMP";
+  case 6:   return "TCP";
+  case 17:  return "UDP";
+  case 58:  return "ICMPv6";
+  case 132: return "SCTP";
+  default:
+    g_snprintf(buf, (gulong)buf_size, "IP proto %u", proto);
+    return buf;
+  }
+}
+
+static gint
+flow_sample_sort_cb(gconstpointer a, gconstpointer b)
+{
+  const struct flow_sample_val *va, *vb;
+
+  va = (const struct flow_sample_val *)g_hash_table_lookup(flow_sample_table, a);
+  vb = (const struct flow_sample_val *)g_hash_table_lookup(flow_sample_table, b);
+  if (va->bytes != vb->bytes)
+    return (vb->bytes > va->bytes) ? 1 : -1;
+  return 0;
+}
+
+static void
+flow_sample_report(void)
+{
+  GList *keys, *entry;
+  guint64 total_bytes = 0;
+
+  printf("===================================================================\n");
+  printf("Sampled flow statistics - 1 packet in %u dissected\n",
+         flow_sample_interval);
+  if (flow_sample_table == NULL) {
+    printf("No packets captured\n");
+    printf("===================================================================\n");
+    return;
+  }
+
+  keys = g_list_sort(g_hash_table_get_keys(flow_sample_table),
+                     flow_sample_sort_cb);
+  for (entry = keys; entry != NULL; entry = entry->next) {
+    const struct flow_sample_val *val;
+
+    val = (const struct flow_sample_val *)g_hash_table_lookup(flow_sample_table,
+                                                              entry->data);
+    total_bytes += val->bytes;
+  }
+  printf("%u flows, %" G_GUINT64_FORMAT " frames, %" G_GUINT64_FORMAT " bytes\n",
+         g_hash_table_size(flow_sample_table), flow_sample_tally, total_bytes);
+
+  for (entry = keys; entry != NULL; entry = entry->next) {
+    const struct flow_sample_key *key;
+    const struct flow_sample_val *val;
+    char src[WS_INET6_ADDRSTRLEN], dst[WS_INET6_ADDRSTRLEN];
+    char proto_buf[16];
+
+    key = (const struct flow_sample_key *)entry->data;
+    val = (const struct flow_sample_val *)g_hash_table_lookup(flow_sample_table,
+                                                              key);
+    if (key->af == 0) {
+      printf("%-10s %-47s", "", "unclassified");
+    } else {
+      char src_port[WS_INET6_ADDRSTRLEN + 6], dst_port[WS_INET6_ADDRSTRLEN + 6];
+
+      if (key->af == 4) {
+        ws_inet_ntop4(key->src, src, sizeof(src));
+        ws_inet_ntop4(key->dst, dst, sizeof(dst));
+      } else {
+        ws_inet_ntop6(key->src, src, sizeof(src));
+        ws_inet_ntop6(key->dst, dst, sizeof(dst));
+      }
+      g_snprintf(src_port, sizeof(src_port), "%s:%u", src, key->src_port);
+      g_snprintf(dst_port, sizeof(dst_port), "%s:%u", dst, key->dst_port);
+      printf("%-10s %-22s -> %-22s",
+             flow_sample_proto_name(key->proto, proto_buf, sizeof(proto_buf)),
+             src_port, dst_port);
+    }
+    printf(" %10" G_GUINT64_FORMAT " frames %14" G_GUINT64_FORMAT " bytes\n",
+           val->frames, val->bytes);
+  }
+  printf("===================================================================\n");
+  g_list_free(keys);
+}
+
 /* capture child tells us we have new packets to read */
 static void
 capture_input_new_packets(capture_session *cap_session, int to_read)
@@ -2792,6 +3196,8 @@ capture_input_new_packets(capture_session *cap_session, int to_read)
      *
      *    one of the tap listeners is going to apply a filter;
      *
+     *    one of the tap listeners declared fields it needs primed;
+     *
      *    one of the tap listeners requires a protocol tree;
      *
      *    a postdissector wants field values or protocols
@@ -2802,14 +3208,27 @@ capture_input_new_packets(capture_session *cap_session, int to_read)
      */
     create_proto_tree =
       (cf->rfcode || cf->dfcode || print_details || filtering_tap_listeners ||
+        have_field_tap_listeners() ||
         (tap_flags & TL_REQUIRES_PROTO_TREE) || postdissectors_want_hfids() ||
         have_custom_cols(&cf->cinfo) || dissect_color);
 
+    /* If we're only writing the values of a known list of fields, the
+       requested fields can be primed below and the dissection engine will
+       fake the rest of the tree, skipping most proto_item allocation.
+       Faking requires an invisible tree, so this can't be done if any tap
+       listener walks the tree or if a field needs the visible
+       representation (see output_fields_can_prime()). */
+    extract_fields_only =
+      (output_action == WRITE_FIELDS && !filtering_tap_listeners &&
+       !(tap_flags & TL_REQUIRES_PROTO_TREE) &&
+       output_fields_can_prime(output_fields));
+
     /* The protocol tree will be "visible", i.e., printed, only if we're
        printing packet details, which is true if we're printing stuff
        ("print_packet_info" is true) and we're in verbose mode
        ("packet_details" is true). */
-    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details);
+    edt = epan_dissect_new(cf->epan, create_proto_tree,
+                           print_packet_info && print_details && !extract_fields_only);
 
     wtap_rec_init(&rec);
     ws_buffer_init(&buf, 1514);
@@ -2817,15 +3236,26 @@ capture_input_new_packets(capture_session *cap_session, int to_read)
     while (to_read-- && cf->provider.wth) {
       wtap_cleareof(cf->provider.wth);
       ret = wtap_read(cf->provider.wth, &rec, &buf, &err, &err_info, &data_offset);
-      reset_epan_mem(cf, edt, create_proto_tree, print_packet_info && print_details);
+      reset_epan_mem(cf, edt, create_proto_tree,
+                     print_packet_info && print_details && !extract_fields_only);
       if (ret == FALSE) {
         /* read from file failed, tell the capture child to stop */
         sync_pipe_stop(cap_session);
         wtap_close(cf->provider.wth);
         cf->provider.wth = NULL;
       } else {
-        ret = process_packet_single_pass(cf, edt, data_offset, &rec, &buf,
-                                         tap_flags);
+        gboolean dissect_this = TRUE;
+
+        if (flow_sample_interval > 1 && rec.rec_type == REC_TYPE_PACKET) {
+          /* Account every packet in the flow table; dissect only 1 in N. */
+          flow_sample_add(&rec, ws_buffer_start_ptr(&buf));
+          dissect_this = (flow_sample_tally % flow_sample_interval) == 1;
+        }
+        if (dissect_this)
+          ret = process_packet_single_pass(cf, edt, data_offset, &rec, &buf,
+                                           tap_flags);
+        else
+          ret = TRUE;  /* counted, not dissected */
       }
       if (ret != FALSE) {
         /* packet successfully read and gone through the "Read Filter" */
@@ -3008,6 +3438,7 @@ process_packet_first_pass(capture_file *cf, epan_dissect_t *edt,
   passed = TRUE;
 
   frame_data_init(&fdlocal, framenum, rec, offset, cum_bytes);
+  frame_data_classify(&fdlocal, rec, ws_buffer_start_ptr(buf));
 
   /* If we're going to run a read filter or a display filter, set up to
      do a dissection and do so.  (This is the first pass of two passes
@@ -3124,18 +3555,110 @@ typedef enum {
   PASS_INTERRUPTED
 } pass_status_t;
 
+/*
+ * Read-ahead support for the first pass of a two-pass run.
+ *
+ * Distributing pass one itself over several processes isn't workable -
+ * conversation and reassembly state depend on seeing the packets in
+ * order and can't be merged afterwards - but the wiretap side of the
+ * pass (file reads and decompression) doesn't need to be serialized
+ * with dissection.  A reader thread runs wtap_read() ahead of the main
+ * loop, handing filled record slots over a pair of async queues, so
+ * I/O and decompression overlap with dissection on a second core.
+ *
+ * End of file, a read error, or a stop request is signalled by a slot
+ * with ok set to FALSE; the reader exits after pushing it.
+ */
+#define FIRST_PASS_READ_AHEAD_SLOTS 16
+
+typedef struct {
+  wtap_rec  rec;
+  Buffer    buf;
+  gint64    data_offset;
+  gboolean  ok;            /* FALSE on EOF, read error or stop request */
+  int       err;
+  gchar    *err_info;
+} first_pass_read_ahead_slot_t;
+
+typedef struct {
+  wtap                         *wth;
+  GAsyncQueue                  *free_q;
+  GAsyncQueue                  *full_q;
+  gint                          stop;  /* accessed with g_atomic_int_*() */
+  first_pass_read_ahead_slot_t  slots[FIRST_PASS_READ_AHEAD_SLOTS];
+} first_pass_read_ahead_t;
+
+static gpointer
+first_pass_read_ahead_thread(gpointer arg)
+{
+  first_pass_read_ahead_t      *ra = (first_pass_read_ahead_t *)arg;
+  first_pass_read_ahead_slot_t *slot;
+
+  for (;;) {
+    /* Time out now and then so that a stop request can't leave us
+       parked on an empty free queue forever. */
+    slot = (first_pass_read_ahead_slot_t *)g_async_queue_timeout_pop(ra->free_q,
+                                                                     100000);
+    if (slot == NULL) {
+      if (g_atomic_int_get(&ra->stop))
+        return NULL;
+      continue;
+    }
+    if (g_atomic_int_get(&ra->stop))
+      return NULL;
+
+    slot->err = 0;
+    slot->err_info = NULL;
+    slot->ok = wtap_read(ra->wth, &slot->rec, &slot->buf, &slot->err,
+                         &slot->err_info, &slot->data_offset);
+    g_async_queue_push(ra->full_q, slot);
+    if (!slot->ok) {
+      /* EOF or a hard read error; we're done. */
+      return NULL;
+    }
+  }
+}
+
+static void
+first_pass_read_ahead_start(first_pass_read_ahead_t *ra, wtap *wth)
+{
+  guint i;
+
+  ra->wth = wth;
+  ra->free_q = g_async_queue_new();
+  ra->full_q = g_async_queue_new();
+  ra->stop = 0;
+  for (i = 0; i < FIRST_PASS_READ_AHEAD_SLOTS; i++) {
+    wtap_rec_init(&ra->slots[i].rec);
+    ws_buffer_init(&ra->slots[i].buf, 1514);
+    g_async_queue_push(ra->free_q, &ra->slots[i]);
+  }
+}
+
+static void
+first_pass_read_ahead_finish(first_pass_read_ahead_t *ra, GThread *thread)
+{
+  guint i;
+
+  g_atomic_int_set(&ra->stop, 1);
+  g_thread_join(thread);
+  for (i = 0; i < FIRST_PASS_READ_AHEAD_SLOTS; i++) {
+    wtap_rec_cleanup(&ra->slots[i].rec);
+    ws_buffer_free(&ra->slots[i].buf);
+  }
+  g_async_queue_unref(ra->free_q);
+  g_async_queue_unref(ra->full_q);
+}
+
 static pass_status_t
 process_cap_file_first_pass(capture_file *cf, int max_packet_count,
                             gint64 max_byte_count, int *err, gchar **err_info)
 {
-  wtap_rec        rec;
-  Buffer          buf;
   epan_dissect_t *edt = NULL;
-  gint64          data_offset;
   pass_status_t   status = PASS_SUCCEEDED;
-
-  wtap_rec_init(&rec);
-  ws_buffer_init(&buf, 1514);
+  first_pass_read_ahead_t       ra;
+  first_pass_read_ahead_slot_t *slot;
+  GThread        *ra_thread;
 
   /* Allocate a frame_data_sequence for all the frames. */
   cf->provider.frames = new_frame_data_sequence();
@@ -3166,28 +3689,46 @@ process_cap_file_first_pass(capture_file *cf, int max_packet_count,
 
   ws_debug("tshark: reading records for first pass");
   *err = 0;
-  while (wtap_read(cf->provider.wth, &rec, &buf, err, err_info, &data_offset)) {
+
+  /* Overlap record reading and decompression with the dissection of
+     earlier records; see the comment above first_pass_read_ahead_thread(). */
+  first_pass_read_ahead_start(&ra, cf->provider.wth);
+  ra_thread = g_thread_new("tshark pass1 read ahead",
+                           first_pass_read_ahead_thread, &ra);
+
+  for (;;) {
+    slot = (first_pass_read_ahead_slot_t *)g_async_queue_pop(ra.full_q);
+    if (!slot->ok) {
+      /* EOF or a read error; pick up the error for the code below. */
+      *err = slot->err;
+      *err_info = slot->err_info;
+      break;
+    }
     if (read_interrupted) {
       status = PASS_INTERRUPTED;
       break;
     }
-    if (process_packet_first_pass(cf, edt, data_offset, &rec, &buf)) {
+    if (process_packet_first_pass(cf, edt, slot->data_offset, &slot->rec,
+                                  &slot->buf)) {
       /* Stop reading if we have the maximum number of packets;
        * When the -c option has not been used, max_packet_count
        * starts at 0, which practically means, never stop reading.
        * (unless we roll over max_packet_count ?)
        */
-      if ( (--max_packet_count == 0) || (max_byte_count != 0 && data_offset >= max_byte_count)) {
+      if ( (--max_packet_count == 0) || (max_byte_count != 0 && slot->data_offset >= max_byte_count)) {
         ws_debug("tshark: max_packet_count (%d) or max_byte_count (%" G_GINT64_MODIFIER "d/%" G_GINT64_MODIFIER "d) reached",
-                      max_packet_count, data_offset, max_byte_count);
+                      max_packet_count, slot->data_offset, max_byte_count);
         *err = 0; /* This is not an error */
         break;
       }
     }
+    g_async_queue_push(ra.free_q, slot);
   }
   if (*err != 0)
     status = PASS_READ_ERROR;
 
+  first_pass_read_ahead_finish(&ra, ra_thread);
+
   if (edt)
     epan_dissect_free(edt);
 
@@ -3201,9 +3742,6 @@ process_cap_file_first_pass(capture_file *cf, int max_packet_count,
   cf->provider.prev_dis = NULL;
   cf->provider.prev_cap = NULL;
 
-  ws_buffer_free(&buf);
-  wtap_rec_cleanup(&rec);
-
   return status;
 }
 
@@ -3231,6 +3769,11 @@ process_packet_second_pass(capture_file *cf, epan_dissect_t *edt,
     if (cf->dfcode)
       epan_dissect_prime_with_dfilter(edt, cf->dfcode);
 
+    /* If we're only extracting fields, prime the epan_dissect_t with the
+       requested fields; everything else will be faked. */
+    if (extract_fields_only)
+      output_fields_prime_edt(edt, output_fields);
+
     col_custom_prime_edt(edt, &cf->cinfo);
 
     /* We only need the columns if either
@@ -3271,6 +3814,7 @@ process_packet_second_pass(capture_file *cf, epan_dissect_t *edt,
     if (print_packet_info) {
       /* We're printing packet information; print the information for
          this packet. */
+      pipeline_stats_record(PIPELINE_STAGE_DISPLAY, 1);
       print_packet(cf, edt);
 
       /* If we're doing "line-buffering", flush the standard output
@@ -3361,6 +3905,8 @@ process_cap_file_second_pass(capture_file *cf, wtap_dumper *pdh,
      *
      *    we're going to print the protocol tree;
      *
+     *    one of the tap listeners declared fields it needs primed;
+     *
      *    one of the tap listeners requires a protocol tree;
      *
      *    we have custom columns (which require field values, which
@@ -3368,15 +3914,25 @@ process_cap_file_second_pass(capture_file *cf, wtap_dumper *pdh,
      */
     create_proto_tree =
       (cf->dfcode || print_details || filtering_tap_listeners ||
+       have_field_tap_listeners() ||
        (tap_flags & TL_REQUIRES_PROTO_TREE) || have_custom_cols(&cf->cinfo) || dissect_color);
 
     ws_debug("tshark: create_proto_tree = %s", create_proto_tree ? "TRUE" : "FALSE");
 
+    /* If we're only writing the values of a known list of fields, the
+       requested fields can be primed below and the dissection engine will
+       fake the rest of the tree, skipping most proto_item allocation. */
+    extract_fields_only =
+      (output_action == WRITE_FIELDS && !filtering_tap_listeners &&
+       !(tap_flags & TL_REQUIRES_PROTO_TREE) &&
+       output_fields_can_prime(output_fields));
+
     /* The protocol tree will be "visible", i.e., printed, only if we're
        printing packet details, which is true if we're printing stuff
        ("print_packet_info" is true) and we're in verbose mode
        ("packet_details" is true). */
-    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details);
+    edt = epan_dissect_new(cf->epan, create_proto_tree,
+                           print_packet_info && print_details && !extract_fields_only);
   }
 
   /*
@@ -3464,6 +4020,8 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
      *
      *    one of the tap listeners is going to apply a filter;
      *
+     *    one of the tap listeners declared fields it needs primed;
+     *
      *    one of the tap listeners requires a protocol tree;
      *
      *    a postdissector wants field values or protocols
@@ -3474,16 +4032,26 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
      */
     create_proto_tree =
       (cf->rfcode || cf->dfcode || print_details || filtering_tap_listeners ||
+        have_field_tap_listeners() ||
         (tap_flags & TL_REQUIRES_PROTO_TREE) || postdissectors_want_hfids() ||
         have_custom_cols(&cf->cinfo) || dissect_color);
 
     ws_debug("tshark: create_proto_tree = %s", create_proto_tree ? "TRUE" : "FALSE");
 
+    /* If we're only writing the values of a known list of fields, the
+       requested fields can be primed below and the dissection engine will
+       fake the rest of the tree, skipping most proto_item allocation. */
+    extract_fields_only =
+      (output_action == WRITE_FIELDS && !filtering_tap_listeners &&
+       !(tap_flags & TL_REQUIRES_PROTO_TREE) &&
+       output_fields_can_prime(output_fields));
+
     /* The protocol tree will be "visible", i.e., printed, only if we're
        printing packet details, which is true if we're printing stuff
        ("print_packet_info" is true) and we're in verbose mode
        ("packet_details" is true). */
-    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details);
+    edt = epan_dissect_new(cf->epan, create_proto_tree,
+                           print_packet_info && print_details && !extract_fields_only);
   }
 
   /*
@@ -3512,7 +4080,8 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
 
     ws_debug("tshark: processing packet #%d", framenum);
 
-    reset_epan_mem(cf, edt, create_proto_tree, print_packet_info && print_details);
+    reset_epan_mem(cf, edt, create_proto_tree,
+                   print_packet_info && print_details && !extract_fields_only);
 
     if (process_packet_single_pass(cf, edt, data_offset, &rec, &buf, tap_flags)) {
       /* Either there's no read filtering or this packet passed the
@@ -3824,6 +4393,7 @@ process_packet_single_pass(capture_file *cf, epan_dissect_t *edt, gint64 offset,
   passed = TRUE;
 
   frame_data_init(&fdata, cf->count, rec, offset, cum_bytes);
+  frame_data_classify(&fdata, rec, ws_buffer_start_ptr(buf));
 
   /* If we're going to print packet information, or we're going to
      run a read filter, or we're going to process taps, set up to
@@ -3840,6 +4410,11 @@ process_packet_single_pass(capture_file *cf, epan_dissect_t *edt, gint64 offset,
        with the hfids postdissectors want on the first pass. */
     prime_epan_dissect_with_postdissector_wanted_hfids(edt);
 
+    /* If we're only extracting fields, prime the epan_dissect_t with the
+       requested fields; everything else will be faked. */
+    if (extract_fields_only)
+      output_fields_prime_edt(edt, output_fields);
+
     col_custom_prime_edt(edt, &cf->cinfo);
 
     /* We only need the columns if either
@@ -3883,6 +4458,7 @@ process_packet_single_pass(capture_file *cf, epan_dissect_t *edt, gint64 offset,
       /* We're printing packet information; print the information for
          this packet. */
       ws_assert(edt);
+      pipeline_stats_record(PIPELINE_STAGE_DISPLAY, 1);
       print_packet(cf, edt);
 
       /* If we're doing "line-buffering", flush the standard output
@@ -3921,6 +4497,9 @@ write_preamble(capture_file *cf)
     return print_preamble(print_stream, cf->filename, get_ws_vcs_version_info());
 
   case WRITE_XML:
+    /* XML export emits many small writes per field; give stdout a big
+       buffer so they coalesce into few system calls. */
+    setvbuf(stdout, NULL, _IOFBF, 1024 * 1024);
     if (print_details)
       write_pdml_preamble(stdout, cf->filename);
     else
@@ -4535,9 +5114,23 @@ tshark_cmdarg_err_cont(const char *msg_format, va_list ap)
 
 static void reset_epan_mem(capture_file *cf,epan_dissect_t *edt, gboolean tree, gboolean visual)
 {
-  if (!epan_auto_reset || (cf->count < epan_auto_reset_count))
+  gboolean due = FALSE;
+
+  if (!epan_auto_reset)
     return;
 
+  if (epan_auto_reset_count != 0 && cf->count >= epan_auto_reset_count)
+    due = TRUE;
+  if (epan_auto_reset_interval != 0 &&
+      g_get_monotonic_time() >= epan_auto_reset_deadline)
+    due = TRUE;
+  if (!due)
+    return;
+
+  if (epan_auto_reset_interval != 0)
+    epan_auto_reset_deadline = g_get_monotonic_time() +
+                               (gint64)epan_auto_reset_interval * G_USEC_PER_SEC;
+
   fprintf(stderr, "resetting session.\n");
 
   epan_dissect_cleanup(edt);
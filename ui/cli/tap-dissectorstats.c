@@ -0,0 +1,121 @@
+/* tap-dissectorstats.c
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/* This module provides per-dissector profiling counters for tshark:
+ * how often each dissector ran, how long it took and how much wmem
+ * memory it requested, with and without its subdissectors. Collection
+ * happens inside the dissection engine (see epan/dissector_stats.h);
+ * this tap only switches it on and prints the result. */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+#include <epan/proto.h>
+#include <epan/dissector_stats.h>
+
+#include <ui/cmdarg_err.h>
+
+void register_tap_listener_dissectorstats(void);
+
+static gint
+compare_self_nsecs(gconstpointer a, gconstpointer b)
+{
+	const dissector_stat_t *sa = (const dissector_stat_t *)a;
+	const dissector_stat_t *sb = (const dissector_stat_t *)b;
+
+	if (sa->self_nsecs != sb->self_nsecs)
+		return (sa->self_nsecs < sb->self_nsecs) ? 1 : -1;
+	return 0;
+}
+
+static void
+dissectorstats_draw(void *dummy _U_)
+{
+	GArray *stats = dissector_stats_snapshot();
+	guint i;
+
+	g_array_sort(stats, compare_self_nsecs);
+
+	printf("\n");
+	printf("==========================================================================================\n");
+	printf("Dissector Statistics\n");
+	printf("%-24s %10s %12s %12s %12s %12s\n",
+	    "Protocol", "Calls", "Self (ms)", "Total (ms)", "Self (kB)", "Total (kB)");
+	for (i = 0; i < stats->len; i++) {
+		dissector_stat_t *st = &g_array_index(stats, dissector_stat_t, i);
+
+		printf("%-24s %10" G_GINT64_MODIFIER "u %12.3f %12.3f %12" G_GINT64_MODIFIER "u %12" G_GINT64_MODIFIER "u\n",
+		    proto_get_protocol_filter_name(st->proto_id),
+		    st->calls,
+		    st->self_nsecs / 1000000.0,
+		    st->total_nsecs / 1000000.0,
+		    st->self_bytes / 1024,
+		    st->total_bytes / 1024);
+	}
+	printf("==========================================================================================\n");
+
+	g_array_free(stats, TRUE);
+}
+
+static void
+dissectorstats_init(const char *opt_arg, void *userdata _U_)
+{
+	GString *error_string;
+
+	if (strcmp("dissector_stats", opt_arg) != 0) {
+		cmdarg_err("invalid \"-z dissector_stats\" argument");
+		exit(1);
+	}
+
+	dissector_stats_reset();
+	dissector_stats_set_enabled(TRUE);
+
+	/* No per-packet routine; the engine accumulates the counters
+	   itself. We only need to be told when to draw. */
+	error_string = register_tap_listener("frame", NULL, NULL, 0,
+	    NULL, NULL, dissectorstats_draw, NULL);
+	if (error_string) {
+		cmdarg_err("Couldn't register dissector_stats tap: %s",
+			error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+}
+
+static stat_tap_ui dissectorstats_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	"dissector_stats",
+	dissectorstats_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_dissectorstats(void)
+{
+	register_stat_tap_ui(&dissectorstats_ui, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
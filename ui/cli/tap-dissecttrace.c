@@ -0,0 +1,303 @@
+/* tap-dissecttrace.c
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/* Record/replay harness for dissection regressions.
+ *
+ * "-z dissect_trace,record,<file>" writes one line per dissected frame
+ * with the frame number, the number of fields posted to the protocol
+ * tree, a hash over the postings (abbrev, type, start, length -- expert
+ * items post fields too, so they are covered) and the Info column text,
+ * plus a trailer with the frame count and the elapsed wall time.
+ *
+ * "-z dissect_trace,replay,<file>" dissects a capture again, rebuilds
+ * the same lines and compares them against the recorded reference,
+ * reporting the first divergence and the timing delta.  Running the
+ * golden corpus through record once and replay after every change
+ * catches correctness and performance regressions in one pass.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <epan/packet_info.h>
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+#include <epan/epan_dissect.h>
+#include <epan/column-utils.h>
+
+#include <wsutil/file_util.h>
+
+#include <ui/cmdarg_err.h>
+
+void register_tap_listener_dissecttrace(void);
+
+#define TRACE_FILE_MAGIC "#dissect_trace 1"
+
+static FILE      *trace_fp;           /* record mode */
+static GPtrArray *trace_ref_lines;    /* replay mode: reference lines */
+static guint64    trace_ref_elapsed;  /* replay mode: recorded elapsed us */
+static guint      trace_index;
+static guint      trace_mismatches;
+static gchar     *trace_first_expected;
+static gchar     *trace_first_got;
+static gint64     trace_start_us;
+
+typedef struct {
+	guint32 fields;
+	guint64 hash;
+} trace_frame_info_t;
+
+/* FNV-1a, 64 bit. */
+static guint64
+trace_hash_bytes(guint64 hash, const void *data, gsize len)
+{
+	const guint8 *p = (const guint8 *)data;
+	gsize i;
+
+	for (i = 0; i < len; i++) {
+		hash ^= p[i];
+		hash *= G_GUINT64_CONSTANT(0x100000001b3);
+	}
+	return hash;
+}
+
+static void
+trace_hash_node(proto_node *node, gpointer data)
+{
+	trace_frame_info_t *tf = (trace_frame_info_t *)data;
+	field_info *fi = PNODE_FINFO(node);
+
+	if (fi && fi->hfinfo) {
+		gint32 coords[3];
+
+		tf->fields++;
+		tf->hash = trace_hash_bytes(tf->hash, fi->hfinfo->abbrev,
+		    strlen(fi->hfinfo->abbrev));
+		coords[0] = fi->start;
+		coords[1] = fi->length;
+		coords[2] = (gint32)fi->hfinfo->type;
+		tf->hash = trace_hash_bytes(tf->hash, coords, sizeof(coords));
+	}
+	proto_tree_children_foreach((proto_tree *)node, trace_hash_node, data);
+}
+
+static gchar *
+trace_format_frame(packet_info *pinfo, epan_dissect_t *edt)
+{
+	trace_frame_info_t tf;
+	const gchar *info_text = NULL;
+
+	tf.fields = 0;
+	tf.hash = G_GUINT64_CONSTANT(0xcbf29ce484222325);
+	if (edt->tree)
+		proto_tree_children_foreach(edt->tree, trace_hash_node, &tf);
+	if (pinfo->cinfo)
+		info_text = col_get_text(pinfo->cinfo, COL_INFO);
+
+	return g_strdup_printf("%u\t%u\t%016" G_GINT64_MODIFIER "x\t%s",
+	    pinfo->num, tf.fields, tf.hash, info_text ? info_text : "-");
+}
+
+static tap_packet_status
+dissecttrace_record_packet(void *tapdata _U_, packet_info *pinfo,
+    epan_dissect_t *edt, const void *data _U_)
+{
+	gchar *line = trace_format_frame(pinfo, edt);
+
+	fprintf(trace_fp, "%s\n", line);
+	g_free(line);
+	trace_index++;
+	return TAP_PACKET_DONT_REDRAW;
+}
+
+static tap_packet_status
+dissecttrace_replay_packet(void *tapdata _U_, packet_info *pinfo,
+    epan_dissect_t *edt, const void *data _U_)
+{
+	gchar *line = trace_format_frame(pinfo, edt);
+	const gchar *expected = NULL;
+
+	if (trace_index < trace_ref_lines->len)
+		expected = (const gchar *)g_ptr_array_index(trace_ref_lines, trace_index);
+
+	if (expected == NULL || strcmp(expected, line) != 0) {
+		trace_mismatches++;
+		if (trace_first_expected == NULL) {
+			trace_first_expected = g_strdup(expected ? expected : "(no reference line)");
+			trace_first_got = g_strdup(line);
+		}
+	}
+	g_free(line);
+	trace_index++;
+	return TAP_PACKET_DONT_REDRAW;
+}
+
+static void
+dissecttrace_record_draw(void *tapdata _U_)
+{
+	gint64 elapsed = g_get_monotonic_time() - trace_start_us;
+
+	fprintf(trace_fp, "=\t%u\t%" G_GINT64_MODIFIER "d\n",
+	    trace_index, elapsed);
+	fclose(trace_fp);
+	trace_fp = NULL;
+
+	printf("\n");
+	printf("===================================================================\n");
+	printf("Dissection Trace: recorded\n");
+	printf("Frames: %u\n", trace_index);
+	printf("Elapsed: %.3f s\n", elapsed / 1e6);
+	printf("===================================================================\n");
+}
+
+static void
+dissecttrace_replay_draw(void *tapdata _U_)
+{
+	gint64 elapsed = g_get_monotonic_time() - trace_start_us;
+
+	printf("\n");
+	printf("===================================================================\n");
+	printf("Dissection Trace: replay\n");
+	printf("Frames compared: %u (reference has %u)\n",
+	    trace_index, trace_ref_lines->len);
+	if (trace_index != trace_ref_lines->len)
+		trace_mismatches += (trace_index < trace_ref_lines->len) ?
+		    trace_ref_lines->len - trace_index : 0;
+	printf("Mismatches: %u\n", trace_mismatches);
+	if (trace_first_expected) {
+		printf("First divergence:\n");
+		printf("\texpected: %s\n", trace_first_expected);
+		printf("\tgot:      %s\n", trace_first_got);
+	}
+	printf("Elapsed: %.3f s (reference %.3f s, %+.1f%%)\n",
+	    elapsed / 1e6, trace_ref_elapsed / 1e6,
+	    trace_ref_elapsed != 0 ?
+	        ((double)elapsed - (double)trace_ref_elapsed) * 100.0 / (double)trace_ref_elapsed :
+	        0.0);
+	printf("Result: %s\n", trace_mismatches == 0 ? "MATCH" : "DIVERGED");
+	printf("===================================================================\n");
+}
+
+static void
+dissecttrace_load_reference(const char *path)
+{
+	gchar *contents = NULL;
+	gchar **lines;
+	guint i;
+
+	if (!g_file_get_contents(path, &contents, NULL, NULL)) {
+		cmdarg_err("dissect_trace: can't read reference file \"%s\"", path);
+		exit(1);
+	}
+	lines = g_strsplit(contents, "\n", -1);
+	g_free(contents);
+
+	if (lines[0] == NULL || strcmp(lines[0], TRACE_FILE_MAGIC) != 0) {
+		cmdarg_err("dissect_trace: \"%s\" is not a dissection trace", path);
+		exit(1);
+	}
+
+	trace_ref_lines = g_ptr_array_new_with_free_func(g_free);
+	for (i = 1; lines[i] != NULL; i++) {
+		if (lines[i][0] == '=') {
+			/* Trailer: frame count (redundant) and elapsed us. */
+			sscanf(lines[i], "=\t%*u\t%" G_GINT64_MODIFIER "u",
+			    &trace_ref_elapsed);
+			break;
+		}
+		if (lines[i][0] == '\0')
+			continue;
+		g_ptr_array_add(trace_ref_lines, g_strdup(lines[i]));
+	}
+	g_strfreev(lines);
+}
+
+static void
+dissecttrace_init(const char *opt_arg, void *userdata _U_)
+{
+	GString *error_string;
+	const char *args = opt_arg + strlen("dissect_trace");
+	gboolean record;
+	const char *path;
+
+	if (g_str_has_prefix(args, ",record,")) {
+		record = TRUE;
+		path = args + strlen(",record,");
+	} else if (g_str_has_prefix(args, ",replay,")) {
+		record = FALSE;
+		path = args + strlen(",replay,");
+	} else {
+		cmdarg_err("invalid \"-z dissect_trace,record|replay,<file>\" argument");
+		exit(1);
+	}
+	if (*path == '\0') {
+		cmdarg_err("dissect_trace: no file given");
+		exit(1);
+	}
+
+	if (record) {
+		trace_fp = ws_fopen(path, "w");
+		if (trace_fp == NULL) {
+			cmdarg_err("dissect_trace: can't create \"%s\"", path);
+			exit(1);
+		}
+		fprintf(trace_fp, "%s\n", TRACE_FILE_MAGIC);
+	} else {
+		dissecttrace_load_reference(path);
+	}
+
+	trace_index = 0;
+	trace_mismatches = 0;
+	trace_start_us = g_get_monotonic_time();
+
+	error_string = register_tap_listener("frame", NULL, NULL,
+	    TL_REQUIRES_PROTO_TREE, NULL,
+	    record ? dissecttrace_record_packet : dissecttrace_replay_packet,
+	    record ? dissecttrace_record_draw : dissecttrace_replay_draw,
+	    NULL);
+	if (error_string) {
+		cmdarg_err("Couldn't register dissect_trace tap: %s",
+		    error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+}
+
+static stat_tap_ui dissecttrace_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	"dissect_trace",
+	dissecttrace_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_dissecttrace(void)
+{
+	register_stat_tap_ui(&dissecttrace_ui, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
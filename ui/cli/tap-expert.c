@@ -49,6 +49,7 @@ typedef struct expert_entry
 /* Overall struct for storing all data seen */
 typedef struct expert_tapdata_t {
     GArray       *ei_array[max_level]; /* expert info items */
+    GHashTable   *ei_hash[max_level];  /* "protocol|summary" -> index+1 into ei_array */
     GStringChunk *text;         /* for efficient storage of summary strings */
 } expert_tapdata_t;
 
@@ -64,9 +65,10 @@ expert_stat_reset(void *tapdata)
     g_string_chunk_free(etd->text);
     etd->text = g_string_chunk_new(100);
 
-    /* Empty each of the arrays */
+    /* Empty each of the arrays and their indexes */
     for (n=0; n < max_level; n++) {
         g_array_set_size(etd->ei_array[n], 0);
+        g_hash_table_remove_all(etd->ei_hash[n]);
     }
 }
 
@@ -80,7 +82,8 @@ expert_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U
     severity_level_t     severity_level;
     expert_entry         tmp_entry;
     expert_entry        *entry;
-    guint                n;
+    gchar               *key;
+    gpointer             value;
 
     switch (ei->severity) {
         case PI_COMMENT:
@@ -108,15 +111,17 @@ expert_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U
         return TAP_PACKET_REDRAW; /* XXX - TAP_PACKET_DONT_REDRAW? */
     }
 
-    /* If a duplicate just bump up frequency.
-       TODO: could make more efficient by avoiding linear search...*/
-    for (n=0; n < data->ei_array[severity_level]->len; n++) {
-        entry = &g_array_index(data->ei_array[severity_level], expert_entry, n);
-        if ((strcmp(ei->protocol, entry->protocol) == 0) &&
-            (strcmp(ei->summary, entry->summary) == 0)) {
-            entry->frequency++;
-            return TAP_PACKET_REDRAW;
-        }
+    /* If a duplicate just bump up frequency. The hash table maps each
+       (protocol, summary) pair seen so far to its index in the array.
+       Protocol names never contain '|', so the key is unambiguous. */
+    key = g_strdup_printf("%s|%s", ei->protocol, ei->summary);
+    value = g_hash_table_lookup(data->ei_hash[severity_level], key);
+    if (value != NULL) {
+        g_free(key);
+        entry = &g_array_index(data->ei_array[severity_level], expert_entry,
+                               GPOINTER_TO_UINT(value) - 1);
+        entry->frequency++;
+        return TAP_PACKET_REDRAW;
     }
 
     /* Else Add new item to end of list for severity level */
@@ -126,8 +131,11 @@ expert_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U
     entry->summary = g_string_chunk_insert_const(data->text, ei->summary);
     entry->group = ei->group;
     entry->frequency = 1;
-    /* Store a copy of the expert entry */
+    /* Store a copy of the expert entry and index it (offset by one so that
+       index 0 is distinguishable from "not found") */
     g_array_append_val(data->ei_array[severity_level], tmp_entry);
+    g_hash_table_insert(data->ei_hash[severity_level], key,
+                        GUINT_TO_POINTER(data->ei_array[severity_level]->len));
 
     return TAP_PACKET_REDRAW;
 }
@@ -189,6 +197,7 @@ expert_tapdata_free(expert_tapdata_t* hs)
 {
     for (int n = 0; n < max_level; n++) {
         g_array_free(hs->ei_array[n], TRUE);
+        g_hash_table_destroy(hs->ei_hash[n]);
     }
     g_string_chunk_free(hs->text);
     g_free(hs);
@@ -247,9 +256,10 @@ static void expert_stat_init(const char *opt_arg, void *userdata _U_)
     /* Allocate chunk of strings */
     hs->text = g_string_chunk_new(100);
 
-    /* Allocate GArray for each severity level */
+    /* Allocate GArray and duplicate-detection index for each severity level */
     for (n=0; n < max_level; n++) {
         hs->ei_array[n] = g_array_sized_new(FALSE, FALSE, sizeof(expert_entry), 1000);
+        hs->ei_hash[n] = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
     }
 
     /**********************************************/
@@ -109,6 +109,9 @@ eo_draw(void *tapdata)
     GString *safe_filename = NULL;
     gchar *save_as_fullpath = NULL;
     guint count = 0;
+    eo_writer_t *writer;
+    GHashTable *claimed_names;
+    guint failed;
 
     if (!g_file_test(save_in_path, G_FILE_TEST_IS_DIR)) {
         /* If the destination directory (or its parents) do not exist, create them. */
@@ -119,6 +122,11 @@ eo_draw(void *tapdata)
         }
     }
 
+    writer = eo_writer_new();
+    /* Queued files may not be on disk yet when we pick the next name,
+       so remember the names already handed to the writer. */
+    claimed_names = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
     while (slist) {
         entry = (export_object_entry_t *)slist->data;
         do {
@@ -137,13 +145,24 @@ eo_draw(void *tapdata)
             }
             save_as_fullpath = g_build_filename(save_in_path, safe_filename->str, NULL);
             g_string_free(safe_filename, TRUE);
-        } while (g_file_test(save_as_fullpath, G_FILE_TEST_EXISTS) && ++count < prefs.gui_max_export_objects);
+        } while ((g_hash_table_contains(claimed_names, save_as_fullpath) ||
+                  g_file_test(save_as_fullpath, G_FILE_TEST_EXISTS)) &&
+                 ++count < prefs.gui_max_export_objects);
         count = 0;
-        write_file_binary_mode(save_as_fullpath, entry->payload_data, entry->payload_len);
-        g_free(save_as_fullpath);
+        g_hash_table_add(claimed_names, g_strdup(save_as_fullpath));
+        /* The writer takes ownership of the path; the payload stays
+           owned by the entry, which outlives eo_writer_finish(). */
+        eo_writer_queue(writer, save_as_fullpath, entry->payload_data, entry->payload_len);
         save_as_fullpath = NULL;
         slist = slist->next;
     }
+
+    failed = eo_writer_finish(writer);
+    if (failed != 0) {
+        fprintf(stderr, "Failed to write %u export object(s) to \"%s\"\n",
+                failed, save_in_path);
+    }
+    g_hash_table_destroy(claimed_names);
 }
 
 static void
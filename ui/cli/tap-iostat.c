@@ -1372,8 +1372,21 @@ register_io_tap(io_stat_t *io, int i, const char *filter)
     }
     g_free(field);
 
-    error_string = register_tap_listener("frame", &io->items[i], flt, TL_REQUIRES_PROTO_TREE, NULL,
-                                       iostat_packet, i ? NULL : iostat_draw, NULL);
+    if (hfi) {
+        /* A calculation on a field: declare that field instead of asking
+           for a full protocol tree, so that retaps can run with a faked
+           tree in which only this field (and any filter fields) is
+           materialized. */
+        error_string = register_tap_listener_with_fields("frame", &io->items[i], flt,
+                                           TL_REQUIRES_NOTHING, NULL,
+                                           iostat_packet, i ? NULL : iostat_draw, NULL,
+                                           &io->items[i].hf_index, 1);
+    } else {
+        /* FRAMES/BYTES only use pinfo, not the protocol tree. */
+        error_string = register_tap_listener("frame", &io->items[i], flt,
+                                           TL_REQUIRES_NOTHING, NULL,
+                                           iostat_packet, i ? NULL : iostat_draw, NULL);
+    }
     if (error_string) {
         g_free(io->items);
         g_free(io);
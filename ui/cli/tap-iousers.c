@@ -13,9 +13,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <errno.h>
 #include <string.h>
 #include <epan/packet.h>
 #include <epan/timestamp.h>
+#include <wsutil/file_util.h>
 #include <wsutil/str_util.h>
 #include <ui/cmdarg_err.h>
 #include <ui/cli/tshark-tap.h>
@@ -23,6 +25,8 @@
 typedef struct _io_users_t {
 	const char *type;
 	const char *filter;
+	const char *bin_path;	/* write the table as binary here instead */
+	int proto_id;
 	conv_hash_t hash;
 } io_users_t;
 
@@ -37,6 +41,29 @@ iousers_draw(void *arg)
 	guint i;
 	gboolean display_ports = (!strncmp(iu->type, "TCP", 3) || !strncmp(iu->type, "UDP", 3) || !strncmp(iu->type, "SCTP", 4)) ? TRUE : FALSE;
 
+	if (iu->bin_path) {
+		/* Binary export: the aggregates are written as they sit
+		   in the array, with no name resolution and no
+		   formatting. */
+		FILE *fp = ws_fopen(iu->bin_path, "wb");
+
+		if (fp == NULL) {
+			fprintf(stderr, "tshark: \"%s\" could not be opened: %s\n",
+				iu->bin_path, g_strerror(errno));
+			return;
+		}
+		if (!conversation_table_export_binary(&iu->hash, iu->proto_id, fp) ||
+		    fclose(fp) == EOF) {
+			fprintf(stderr, "tshark: error writing \"%s\": %s\n",
+				iu->bin_path, g_strerror(errno));
+		}
+		return;
+	}
+
+	/* Resolve all the addresses in one asynchronous batch up front,
+	   rather than one synchronous lookup at a time while printing. */
+	resolve_conversation_table_names(&iu->hash, RESOLV_TABLE_TIMEOUT_MS);
+
 	printf("================================================================================\n");
 	printf("%s Conversations\n", iu->type);
 	printf("Filter:%s\n", iu->filter ? iu->filter : "<No Filter>");
@@ -236,10 +263,32 @@ void init_iousers(struct register_ct *ct, const char *filter)
 {
 	io_users_t *iu;
 	GString *error_string;
+	char *bin_path = NULL;
+
+	/* An optional "bin:<file>" before the filter selects the binary
+	   export: -z conv,tcp,bin:conv.wsct[,<filter>] */
+	if (filter && g_str_has_prefix(filter, "bin:")) {
+		const char *path = filter + strlen("bin:");
+		const char *comma = strchr(path, ',');
+
+		if (comma) {
+			bin_path = g_strndup(path, comma - path);
+			filter = comma + 1;
+		} else {
+			bin_path = g_strdup(path);
+			filter = NULL;
+		}
+		if (*bin_path == '\0') {
+			cmdarg_err("No file name given after \"bin:\"");
+			exit(1);
+		}
+	}
 
 	iu = g_new0(io_users_t, 1);
 	iu->type = proto_get_protocol_short_name(find_protocol_by_id(get_conversation_proto_id(ct)));
 	iu->filter = g_strdup(filter);
+	iu->bin_path = bin_path;
+	iu->proto_id = get_conversation_proto_id(ct);
 	iu->hash.user_data = iu;
 
 	error_string = register_tap_listener(proto_get_protocol_filter_name(get_conversation_proto_id(ct)), &iu->hash, filter, 0, NULL, get_conversation_packet_func(ct), iousers_draw, NULL);
@@ -0,0 +1,122 @@
+/* tap-manifest.c
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/* "-z manifest" prepends a report manifest to the statistics output:
+ * a block listing every "-z" report produced by this invocation, the
+ * number of dissection passes that were run and the number of frames
+ * that fed the taps.  All requested statistics are collected by
+ * coexisting taps during the same dissection, so scripts that used to
+ * invoke tshark once per report can ask for everything in one run and
+ * use the manifest to sanity-check the combined output. */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <epan/packet_info.h>
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+
+#include <ui/cmdarg_err.h>
+#include <ui/cli/tshark-tap.h>
+
+void register_tap_listener_manifest(void);
+
+static gboolean manifest_requested = FALSE;
+static guint64 manifest_frames = 0;
+
+static tap_packet_status
+manifest_packet(void *tapdata _U_, packet_info *pinfo _U_,
+    epan_dissect_t *edt _U_, const void *data _U_)
+{
+	manifest_frames++;
+	return TAP_PACKET_DONT_REDRAW;
+}
+
+/* Called from tshark before the tap listeners draw, so the manifest
+   comes out ahead of the reports it describes regardless of where
+   "-z manifest" appeared on the command line.  Does nothing unless the
+   manifest was requested. */
+void
+draw_manifest_report(guint passes)
+{
+	GSList *entry;
+
+	if (!manifest_requested)
+		return;
+
+	printf("\n");
+	printf("===================================================================\n");
+	printf("Report Manifest\n");
+	printf("Dissection passes: %u\n", passes);
+	printf("Frames tapped: %" G_GINT64_MODIFIER "u\n", manifest_frames);
+	printf("Reports in this run:\n");
+	for (entry = stat_cmd_args_get_requested(); entry; entry = entry->next) {
+		if (strcmp((const char *)entry->data, "manifest") == 0)
+			continue;
+		printf("\t%s\n", (const char *)entry->data);
+	}
+	printf("===================================================================\n");
+}
+
+static void
+manifest_init(const char *opt_arg, void *userdata _U_)
+{
+	GString *error_string;
+
+	if (strcmp("manifest", opt_arg) != 0) {
+		cmdarg_err("invalid \"-z manifest\" argument");
+		exit(1);
+	}
+
+	manifest_requested = TRUE;
+	manifest_frames = 0;
+
+	/* No draw routine; tshark draws the manifest itself, before the
+	   other listeners, via draw_manifest_report(). */
+	error_string = register_tap_listener("frame", NULL, NULL, 0,
+	    NULL, manifest_packet, NULL, NULL);
+	if (error_string) {
+		cmdarg_err("Couldn't register manifest tap: %s",
+			error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+}
+
+static stat_tap_ui manifest_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	"manifest",
+	manifest_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_manifest(void)
+{
+	register_stat_tap_ui(&manifest_ui, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
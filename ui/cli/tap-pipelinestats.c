@@ -0,0 +1,127 @@
+/* tap-pipelinestats.c
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/* This module reports per-stage statistics for the capture-to-display
+ * pipeline: how many packets crossed each instrumented stage boundary
+ * (sync pipe delivery, dissection entry, output) and how far each stage
+ * ran behind the one before it, so backpressure can be located without
+ * attaching a system tracer. Collection happens at the stage boundaries
+ * themselves (see wsutil/pipeline_stats.h); this tap only switches it
+ * on and prints the result. */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+
+#include <wsutil/pipeline_stats.h>
+
+#include <ui/cmdarg_err.h>
+
+void register_tap_listener_pipelinestats(void);
+
+static const char *stage_names[PIPELINE_NUM_STAGES] = {
+	"Sync pipe delivery",
+	"Dissection",
+	"Output",
+};
+
+static void
+pipelinestats_draw(void *dummy _U_)
+{
+	pipeline_stage_stat_t stats[PIPELINE_NUM_STAGES];
+	guint i;
+
+	pipeline_stats_snapshot(stats);
+
+	printf("\n");
+	printf("===================================================================================\n");
+	printf("Pipeline Statistics\n");
+	printf("%-20s %12s %12s %12s %12s\n",
+	    "Stage", "Packets", "Pkts/s", "Lag avg (ms)", "Lag max (ms)");
+	for (i = 0; i < PIPELINE_NUM_STAGES; i++) {
+		pipeline_stage_stat_t *st = &stats[i];
+		guint64 span_usecs = st->last_usecs - st->first_usecs;
+
+		if (st->packets == 0) {
+			/* The stage didn't run in this process (e.g. no
+			   live capture, so no sync pipe). */
+			printf("%-20s %12s\n", stage_names[i], "-");
+			continue;
+		}
+		printf("%-20s %12" G_GINT64_MODIFIER "u", stage_names[i], st->packets);
+		if (span_usecs != 0)
+			printf(" %12.1f", st->packets / (span_usecs / 1000000.0));
+		else
+			printf(" %12s", "-");
+		if (st->lag_samples != 0) {
+			printf(" %12.3f %12.3f",
+			    st->lag_usecs_sum / (double)st->lag_samples / 1000.0,
+			    st->lag_usecs_max / 1000.0);
+		}
+		printf("\n");
+	}
+	printf("===================================================================================\n");
+}
+
+static void
+pipelinestats_init(const char *opt_arg, void *userdata _U_)
+{
+	GString *error_string;
+
+	if (strcmp("pipeline,stats", opt_arg) != 0) {
+		cmdarg_err("invalid \"-z pipeline,stats\" argument");
+		exit(1);
+	}
+
+	pipeline_stats_reset();
+	pipeline_stats_set_enabled(TRUE);
+
+	/* No per-packet routine; the stage boundaries accumulate the
+	   counters themselves. We only need to be told when to draw. */
+	error_string = register_tap_listener("frame", NULL, NULL, 0,
+	    NULL, NULL, pipelinestats_draw, NULL);
+	if (error_string) {
+		cmdarg_err("Couldn't register pipeline,stats tap: %s",
+			error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+}
+
+static stat_tap_ui pipelinestats_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	"pipeline,stats",
+	pipelinestats_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_pipelinestats(void)
+{
+	register_stat_tap_ui(&pipelinestats_ui, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -12,10 +12,15 @@
 
 #include <epan/conversation_table.h>
 
+/* How long the conversation/endpoint taps wait for their bulk name
+   resolution batch before drawing. */
+#define RESOLV_TABLE_TIMEOUT_MS 5000
+
 extern void init_iousers(struct register_ct* ct, const char *filter);
 extern void init_hostlists(struct register_ct* ct, const char *filter);
 extern gboolean register_srt_tables(const void *key, void *value, void *userdata);
 extern gboolean register_rtd_tables(const void *key, void *value, void *userdata);
 extern gboolean register_simple_stat_tables(const void *key, void *value, void *userdata);
+extern void draw_manifest_report(guint passes);
 
 #endif /* __TSHARK_TAP_H__ */
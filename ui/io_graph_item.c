@@ -126,6 +126,106 @@ GString *check_field_unit(const char *field_name, int *hf_index, io_graph_item_u
     return err_str;
 }
 
+/* Combine src into dst. dst must cover an earlier or equal time range. */
+static void
+merge_io_graph_item(io_graph_item_t *dst, const io_graph_item_t *src, io_graph_item_unit_t item_unit)
+{
+    if (dst->first_frame_in_invl == 0) {
+        dst->first_frame_in_invl = src->first_frame_in_invl;
+    }
+    if (src->last_frame_in_invl != 0) {
+        dst->last_frame_in_invl = src->last_frame_in_invl;
+    }
+
+    if (src->fields) {
+        if (dst->fields == 0) {
+            dst->int_max    = src->int_max;
+            dst->int_min    = src->int_min;
+            dst->float_max  = src->float_max;
+            dst->float_min  = src->float_min;
+            dst->double_max = src->double_max;
+            dst->double_min = src->double_min;
+            dst->time_max   = src->time_max;
+            dst->time_min   = src->time_min;
+            dst->extreme_frame_in_invl = src->extreme_frame_in_invl;
+        } else {
+            /* Only one of the int/float/double/time channels is in use
+             * for a given graph; in the unused ones both sides are zero,
+             * so these comparisons never fire there. */
+            gboolean max_from_src = (src->int_max > dst->int_max)
+                || (src->float_max > dst->float_max)
+                || (src->double_max > dst->double_max)
+                || (nstime_cmp(&src->time_max, &dst->time_max) > 0);
+            gboolean min_from_src = (src->int_min < dst->int_min)
+                || (src->float_min < dst->float_min)
+                || (src->double_min < dst->double_min)
+                || (nstime_cmp(&src->time_min, &dst->time_min) < 0);
+
+            if (max_from_src) {
+                dst->int_max    = MAX(dst->int_max, src->int_max);
+                dst->float_max  = MAX(dst->float_max, src->float_max);
+                dst->double_max = MAX(dst->double_max, src->double_max);
+                if (nstime_cmp(&src->time_max, &dst->time_max) > 0) {
+                    dst->time_max = src->time_max;
+                }
+                if (item_unit == IOG_ITEM_UNIT_CALC_MAX) {
+                    dst->extreme_frame_in_invl = src->extreme_frame_in_invl;
+                }
+            }
+            if (min_from_src) {
+                dst->int_min    = MIN(dst->int_min, src->int_min);
+                dst->float_min  = MIN(dst->float_min, src->float_min);
+                dst->double_min = MIN(dst->double_min, src->double_min);
+                if (nstime_cmp(&src->time_min, &dst->time_min) < 0) {
+                    dst->time_min = src->time_min;
+                }
+                if (item_unit == IOG_ITEM_UNIT_CALC_MIN) {
+                    dst->extreme_frame_in_invl = src->extreme_frame_in_invl;
+                }
+            }
+        }
+        dst->int_tot    += src->int_tot;
+        dst->float_tot  += src->float_tot;
+        dst->double_tot += src->double_tot;
+        dst->fields     += src->fields;
+    }
+    /* LOAD spreads time_tot over bins without bumping the field count,
+     * so sum it unconditionally. */
+    nstime_add(&dst->time_tot, &src->time_tot);
+
+    dst->frames += src->frames;
+    dst->bytes  += src->bytes;
+}
+
+int
+rebin_io_graph_items(io_graph_item_t *items, int cur_idx, int old_interval, int new_interval, io_graph_item_unit_t item_unit)
+{
+    int factor = new_interval / old_interval;
+    int new_cur_idx = cur_idx / factor;
+    int i;
+
+    ws_assert(factor > 0 && new_interval % old_interval == 0);
+
+    /* The destination index never exceeds the source index, and each
+     * destination is fully assembled before the loop moves past its
+     * sources, so we can re-bin in place in one ascending pass. */
+    for (i = 1; i <= cur_idx; i++) {
+        int new_idx = i / factor;
+
+        if (new_idx == i) {
+            continue;
+        }
+        if (i % factor == 0) {
+            items[new_idx] = items[i];
+        } else {
+            merge_io_graph_item(&items[new_idx], &items[i], item_unit);
+        }
+    }
+    reset_io_graph_items(&items[new_cur_idx + 1], cur_idx - new_cur_idx);
+
+    return new_cur_idx;
+}
+
 // Adapted from get_it_value in gtk/io_stat.c.
 double get_io_graph_item(const io_graph_item_t *items_, io_graph_item_unit_t val_units_, int idx, int hf_index_, const capture_file *cap_file, int interval_, int cur_idx_)
 {
@@ -115,6 +115,24 @@ int get_io_graph_index(packet_info *pinfo, int interval);
  */
 GString *check_field_unit(const char *field_name, int *hf_index, io_graph_item_unit_t item_unit);
 
+/** Aggregate items binned at one interval into bins at a coarser interval.
+ *
+ * The items are merged in place: bin N of the new binning is the
+ * combination of bins N*factor .. N*factor+factor-1 of the old one, where
+ * factor is new_interval / old_interval.  All counters, totals and
+ * extremes combine losslessly, so the result is identical to retapping
+ * at the coarser interval, without touching any packets.
+ *
+ * @param items [in,out] Array containing the items to re-bin.
+ * @param cur_idx [in] Index of the last used item.
+ * @param old_interval [in] Interval the items are currently binned at, in ms.
+ * @param new_interval [in] The new interval, in ms. Must be a positive
+ *                          integer multiple of old_interval.
+ * @param item_unit [in] The type of unit to calculate. From IOG_ITEM_UNITS.
+ * @return The index of the last used item in the new binning.
+ */
+int rebin_io_graph_items(io_graph_item_t *items, int cur_idx, int old_interval, int new_interval, io_graph_item_unit_t item_unit);
+
 /** Get the value at the given interval (idx) for the current value unit.
  *
  * @param items [in] Array containing the item to get.
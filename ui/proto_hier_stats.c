@@ -18,6 +18,8 @@
 #include "ui/progress_dlg.h"
 #include "epan/epan_dissect.h"
 #include "epan/proto.h"
+#include "epan/wmem_scopes.h"
+#include <wsutil/glib-compat.h>
 #include <wsutil/ws_assert.h>
 
 /* Update the progress bar this many times when scanning the packet list. */
@@ -28,6 +30,12 @@
 
 static int pc_proto_id = -1;
 
+/* Counters maintained incrementally during the load pass; see the
+   comments in proto_hier_stats.h. */
+struct ph_stats_live {
+    ph_stats_t	*ps;
+};
+
     static GNode*
 find_stat_node(GNode *parent_stat_node, header_field_info *needle_hfinfo)
 {
@@ -184,6 +192,42 @@ process_record(capture_file *cf, frame_data *frame, column_info *cinfo,
     return TRUE;	/* success */
 }
 
+    static ph_stats_t*
+ph_stats_alloc(void)
+{
+    ph_stats_t	*ps;
+
+    ps = g_new(ph_stats_t, 1);
+    ps->tot_packets = 0;
+    ps->tot_bytes = 0;
+    ps->stats_tree = g_node_new(NULL);
+    ps->first_time = 0.0;
+    ps->last_time = 0.0;
+    return ps;
+}
+
+    static gpointer
+stat_node_dup(gconstpointer src, gpointer data _U_)
+{
+    if (src == NULL)
+        return NULL;
+
+    return g_memdup2(src, sizeof(ph_stats_node_t));
+}
+
+/* Deep-copy the statistics, so the caller can ph_stats_free() its copy
+   while the live counters keep accumulating. */
+    static ph_stats_t*
+ph_stats_dup(const ph_stats_t *orig)
+{
+    ph_stats_t	*ps;
+
+    ps = g_new(ph_stats_t, 1);
+    *ps = *orig;
+    ps->stats_tree = g_node_copy_deep(orig->stats_tree, stat_node_dup, NULL);
+    return ps;
+}
+
     ph_stats_t*
 ph_stats_new(capture_file *cf)
 {
@@ -203,15 +247,16 @@ ph_stats_new(capture_file *cf)
 
     if (!cf) return NULL;
 
+    /* If the counters were maintained while the frames were loaded,
+       hand out a copy of them instead of dissecting the whole file
+       over again. */
+    if (cf->pstats_live != NULL)
+        return ph_stats_dup(cf->pstats_live->ps);
+
     pc_proto_id = proto_registrar_get_id_byname("pkt_comment");
 
     /* Initialize the data */
-    ps = g_new(ph_stats_t, 1);
-    ps->tot_packets = 0;
-    ps->tot_bytes = 0;
-    ps->stats_tree = g_node_new(NULL);
-    ps->first_time = 0.0;
-    ps->last_time = 0.0;
+    ps = ph_stats_alloc();
 
     /* Update the progress bar when it gets to this value. */
     progbar_nextstep = 0;
@@ -352,3 +397,83 @@ ph_stats_free(ph_stats_t *ps)
 
     g_free(ps);
 }
+
+    void
+ph_stats_live_reset(capture_file *cf)
+{
+    ph_stats_live_invalidate(cf);
+
+    pc_proto_id = proto_registrar_get_id_byname("pkt_comment");
+
+    cf->pstats_live = g_new(struct ph_stats_live, 1);
+    cf->pstats_live->ps = ph_stats_alloc();
+}
+
+    void
+ph_stats_live_invalidate(capture_file *cf)
+{
+    if (cf->pstats_live == NULL)
+        return;
+
+    ph_stats_free(cf->pstats_live->ps);
+    g_free(cf->pstats_live);
+    cf->pstats_live = NULL;
+}
+
+    void
+ph_stats_live_add(capture_file *cf, packet_info *pinfo)
+{
+    ph_stats_t		*ps;
+    ph_stats_node_t	*stats = NULL;
+    GNode		*parent_stat_node, *stat_node;
+    wmem_list_frame_t	*proto;
+    guint32		pkt_len;
+
+    if (cf->pstats_live == NULL)
+        return;
+
+    ps = cf->pstats_live->ps;
+    pkt_len = pinfo->fd->pkt_len;
+
+    parent_stat_node = ps->stats_tree;
+    for (proto = wmem_list_head(pinfo->layers); proto != NULL;
+         proto = wmem_list_frame_next(proto)) {
+        int			proto_id = GPOINTER_TO_INT(wmem_list_frame_data(proto));
+        header_field_info	*hfinfo = proto_registrar_get_nth(proto_id);
+
+        /* Skip packet comments, as process_tree() does, and nameless
+           pseudo-protocols, as process_node() does. */
+        if (hfinfo == NULL || proto_id == pc_proto_id ||
+            strlen(hfinfo->name) == 0)
+            continue;
+
+        stat_node = find_stat_node(parent_stat_node, hfinfo);
+        stats = STAT_NODE_STATS(stat_node);
+        stats->num_pkts_total++;
+        stats->num_bytes_total += pkt_len;
+        parent_stat_node = stat_node;
+    }
+
+    /* The innermost layer is where the frame ended up. */
+    if (stats) {
+        stats->num_pkts_last++;
+        stats->num_bytes_last += pkt_len;
+    }
+
+    if (pinfo->fd->has_ts) {
+        double cur_time = nstime_to_sec(&pinfo->fd->abs_ts);
+
+        if (ps->tot_packets == 0) {
+            ps->first_time = cur_time;
+            ps->last_time = cur_time;
+        } else {
+            if (cur_time < ps->first_time)
+                ps->first_time = cur_time;
+            if (cur_time > ps->last_time)
+                ps->last_time = cur_time;
+        }
+    }
+
+    ps->tot_packets++;
+    ps->tot_bytes += pkt_len;
+}
@@ -42,6 +42,35 @@ ph_stats_t *ph_stats_new(capture_file *cf);
 
 void ph_stats_free(ph_stats_t *ps);
 
+/*
+ * Incrementally maintained statistics.
+ *
+ * file.c restarts this accumulator whenever a pass over every frame
+ * begins (initial load, redissection, refiltering) and feeds it the
+ * pinfo->layers list of each displayed frame as it is dissected.  While
+ * the accumulator is alive, ph_stats_new() hands out a snapshot of it
+ * instead of re-reading and re-dissecting the whole file, so the
+ * Protocol Hierarchy dialog opens instantly and stays current while a
+ * live capture appends packets.
+ *
+ * The byte counters from this path credit a frame's whole length to
+ * every layer it traverses; the per-protocol field lengths the full
+ * pass uses are only known from the protocol tree, which isn't built
+ * while loading.
+ */
+
+/** Restart the accumulator; a full dissection pass is beginning. */
+void ph_stats_live_reset(capture_file *cf);
+
+/** Account for one displayed frame that was just dissected. */
+void ph_stats_live_add(capture_file *cf, struct _packet_info *pinfo);
+
+/** Drop the accumulator; the counters can no longer be kept in step
+ * with the displayed frames (e.g. a pass was aborted, or replayed
+ * cached filter results without dissecting anything).  ph_stats_new()
+ * then falls back to its own pass over the file. */
+void ph_stats_live_invalidate(capture_file *cf);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
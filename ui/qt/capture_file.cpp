@@ -82,7 +82,8 @@ QString CaptureFile::no_capture_file_ = QObject::tr("[no capture file]");
 CaptureFile::CaptureFile(QObject *parent, capture_file *cap_file) :
     QObject(parent),
     cap_file_(cap_file),
-    file_state_(QString())
+    file_state_(QString()),
+    retap_scheduled_(false)
 {
 #ifdef HAVE_LIBPCAP
     capture_callback_add(captureCallback, (gpointer) this);
@@ -212,14 +213,41 @@ int CaptureFile::timestampPrecision()
 
 void CaptureFile::retapPackets()
 {
-    if (cap_file_) {
-        cf_retap_packets(cap_file_);
+    if (!cap_file_) {
+        return;
     }
+    /* The retap loop processes UI events, so a second dialog can be opened
+     * (and request its own retap) while a retap is in progress. The nested
+     * cf_retap_packets call would fail and leave the new listener without
+     * data; run another full pass once the current one has finished
+     * instead. One pass serves every registered listener, so any number of
+     * requests made in the meantime coalesce into that single pass. */
+    if (cap_file_->read_lock) {
+        delayedRetapPackets();
+        return;
+    }
+    retap_scheduled_ = false;
+    cf_retap_packets(cap_file_);
 }
 
 void CaptureFile::delayedRetapPackets()
 {
-    QTimer::singleShot(0, this, SLOT(retapPackets()));
+    if (retap_scheduled_) {
+        return;
+    }
+    retap_scheduled_ = true;
+    QTimer::singleShot(0, this, SLOT(doDelayedRetap()));
+}
+
+void CaptureFile::doDelayedRetap()
+{
+    /* A direct retapPackets() call in the meantime has already served
+     * every listener; don't run the file again. */
+    if (!retap_scheduled_) {
+        return;
+    }
+    retap_scheduled_ = false;
+    retapPackets();
 }
 
 void CaptureFile::reload()
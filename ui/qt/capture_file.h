@@ -134,7 +134,8 @@ public slots:
     /** Retap the capture file after the current batch of application events
      * is processed. If you call this instead of retapPackets or
      * cf_retap_packets in a dialog's constructor it will be displayed before
-     * tapping starts.
+     * tapping starts. Multiple pending requests are coalesced into a
+     * single pass over the file, which serves every registered listener.
      */
     void delayedRetapPackets();
 
@@ -148,6 +149,9 @@ public slots:
      */
     void setCaptureStopFlag(bool stop_flag = true);
 
+private slots:
+    void doDelayedRetap();
+
 private:
     static void captureFileCallback(gint event, gpointer data, gpointer user_data);
 #ifdef HAVE_LIBPCAP
@@ -162,6 +166,7 @@ private:
 
     capture_file *cap_file_;
     QString file_state_;
+    bool retap_scheduled_;
 };
 
 #endif // CAPTURE_FILE_H
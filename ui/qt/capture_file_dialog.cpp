@@ -47,6 +47,12 @@
 #include <ui/qt/utils/qt_ui_utils.h>
 #include <wireshark_application.h>
 
+#if !defined(Q_OS_WIN)
+// Upper bound on the records scanned for the preview; past this the
+// record count becomes an estimate scaled up from the scanned prefix.
+static const guint32 preview_max_records_ = 100000;
+#endif
+
 CaptureFileDialog::CaptureFileDialog(QWidget *parent, capture_file *cf, QString &display_filter) :
     WiresharkFileDialog(parent),
     cap_file_(cf),
@@ -900,11 +906,9 @@ int CaptureFileDialog::mergeType() {
 /* do a preview run on the currently selected capture file */
 void CaptureFileDialog::preview(const QString & path)
 {
-    wtap        *wth;
     int          err;
     gchar       *err_info;
-    ws_file_preview_stats stats;
-    ws_file_preview_stats_status status;
+    wtap_probe_info probe;
     time_t       ti_time;
     struct tm   *ti_tm;
     unsigned int elapsed_time;
@@ -926,8 +930,11 @@ void CaptureFileDialog::preview(const QString & path)
         return;
     }
 
-    wth = wtap_open_offline(path.toUtf8().data(), WTAP_TYPE_AUTO, &err, &err_info, TRUE);
-    if (wth == NULL) {
+    // A bounded probe: the scanned prefix is enough for the start time
+    // and a record count estimate, and keeps previews of large remote
+    // files near-instant.
+    if (!wtap_probe_file(path.toUtf8().data(), preview_max_records_,
+                         prefs.gui_fileopen_preview, &probe, &err, &err_info)) {
         if (err == WTAP_ERR_FILE_UNKNOWN_FORMAT) {
             preview_format_.setText(tr("unknown file format"));
         } else {
@@ -942,42 +949,39 @@ void CaptureFileDialog::preview(const QString & path)
     }
 
     // Format
-    preview_format_.setText(QString::fromUtf8(wtap_file_type_subtype_description(wtap_file_type_subtype(wth))));
+    preview_format_.setText(QString::fromUtf8(wtap_file_type_subtype_description(probe.file_type_subtype)));
 
     // Size
-    gint64 filesize = wtap_file_size(wth, &err);
     // Finder and Windows Explorer use IEC. What do the various Linux file managers use?
-    QString size_str(gchar_free_to_qstring(format_size(filesize, format_size_unit_bytes|format_size_prefix_iec)));
+    QString size_str(gchar_free_to_qstring(format_size(probe.file_size, format_size_unit_bytes|format_size_prefix_iec)));
 
-    status = get_stats_for_preview(wth, &stats, &err, &err_info);
-
-    if (status == PREVIEW_READ_ERROR) {
+    if (err != 0) {
         // XXX - give error details?
         g_free(err_info);
-        preview_size_.setText(tr("%1, error after %Ln data record(s)", "", stats.records)
+        preview_size_.setText(tr("%1, error after %Ln data record(s)", "", probe.data_records)
                               .arg(size_str));
         return;
     }
 
     // Packet count
-    if (status == PREVIEW_TIMED_OUT) {
-        preview_size_.setText(tr("%1, timed out at %Ln data record(s)", "", stats.data_records)
+    if (!probe.scan_complete) {
+        preview_size_.setText(tr("%1, around %Ln data record(s)", "", probe.est_data_records)
                               .arg(size_str));
     } else {
-        preview_size_.setText(tr("%1, %Ln data record(s)", "", stats.data_records)
+        preview_size_.setText(tr("%1, %Ln data record(s)", "", probe.data_records)
                               .arg(size_str));
     }
 
     // First packet + elapsed time
     QString first_elapsed;
-    if (stats.have_times) {
+    if (probe.have_times) {
         //
         // We saw at least one record with a time stamp, so we can give
         // a start time (if we have a mix of records with and without
         // time stamps, and there were records without time stamps
         // before the first one with a time stamp, this may be inaccurate).
         //
-        ti_time = (long)stats.start_time;
+        ti_time = (time_t)probe.start_time.secs;
         ti_tm = localtime(&ti_time);
         first_elapsed = "?";
         if (ti_tm) {
@@ -995,16 +999,16 @@ void CaptureFileDialog::preview(const QString & path)
 
     // Elapsed time
     first_elapsed += " / ";
-    if (status == PREVIEW_SUCCEEDED && stats.have_times) {
+    if (probe.scan_complete && probe.have_times) {
         //
-        // We didn't time out, so we looked at all packets, and we got
-        // at least one packet with a time stamp, so we can calculate
-        // an elapsed time from the time stamp of the last packet with
-        // with a time stamp (if we have a mix of records with and without
-        // time stamps, and there were records without time stamps after
-        // the last one with a time stamp, this may be inaccurate).
+        // We looked at all packets, and we got at least one packet
+        // with a time stamp, so we can calculate an elapsed time from
+        // the time stamp of the last packet with a time stamp (if we
+        // have a mix of records with and without time stamps, and
+        // there were records without time stamps after the last one
+        // with a time stamp, this may be inaccurate).
         //
-        elapsed_time = (unsigned int)(stats.stop_time-stats.start_time);
+        elapsed_time = (unsigned int)(probe.stop_time.secs-probe.start_time.secs);
         if (elapsed_time/86400) {
             first_elapsed += QString("%1 days ").arg(elapsed_time/86400, 2, 10, QChar('0'));
             elapsed_time = elapsed_time % 86400;
@@ -1017,8 +1021,6 @@ void CaptureFileDialog::preview(const QString & path)
         first_elapsed += tr("unknown");
     }
     preview_first_elapsed_.setText(first_elapsed);
-
-    wtap_close(wth);
 }
 
 void CaptureFileDialog::on_buttonBox_helpRequested()
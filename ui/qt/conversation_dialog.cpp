@@ -758,18 +758,13 @@ void ConversationTreeWidget::updateItems() {
         return;
     }
 
-    setSortingEnabled(false);
+    pauseSorting();
 
     QList<QTreeWidgetItem *>new_items;
     for (int i = topLevelItemCount(); i < (int) hash_.conv_array->len; i++) {
         ConversationTreeWidgetItem *ctwi = new ConversationTreeWidgetItem(hash_.conv_array, i, &resolve_names_);
         new_items << ctwi;
 
-        if (i == 0) {
-            min_rel_start_time_ = nstime_to_sec(&(ctwi->convItem()->start_time));
-            max_rel_stop_time_ = nstime_to_sec(&(ctwi->convItem()->stop_time));
-        }
-
         for (int col = 0; col < columnCount(); col++) {
             switch (col) {
             case CONV_COLUMN_SRC_ADDR:
@@ -783,23 +778,14 @@ void ConversationTreeWidget::updateItems() {
     }
     addTopLevelItems(new_items);
 
-    for (int i = 0; i < topLevelItemCount(); i++) {
-        ConversationTreeWidgetItem *ctwi = dynamic_cast<ConversationTreeWidgetItem *>(topLevelItem(i));
-
-        if (ctwi) {
-            double item_rel_start = nstime_to_sec(&(ctwi->convItem()->start_time));
-            if (item_rel_start < min_rel_start_time_) {
-                min_rel_start_time_ = item_rel_start;
-            }
-
-            double item_rel_stop = nstime_to_sec(&(ctwi->convItem()->stop_time));
-            if (item_rel_stop > max_rel_stop_time_) {
-                max_rel_stop_time_ = item_rel_stop;
-            }
-        }
+    // The tap maintains the overall extents as it aggregates, so the
+    // timeline doesn't cost us a pass over every conversation here.
+    if (!nstime_is_unset(&hash_.max_stop_time)) {
+        min_rel_start_time_ = nstime_to_sec(&hash_.min_start_time);
+        max_rel_stop_time_ = nstime_to_sec(&hash_.max_stop_time);
     }
 
-    setSortingEnabled(true);
+    resumeSorting();
 
     if (resize) {
         for (int col = 0; col < columnCount(); col++) {
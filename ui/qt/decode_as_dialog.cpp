@@ -199,8 +199,10 @@ void DecodeAsDialog::on_clearToolButton_clicked()
 
 void DecodeAsDialog::applyChanges()
 {
-    model_->applyChanges();
-    wsApp->queueAppSignal(WiresharkApplication::PacketDissectionChanged);
+    /* Only redissect if a table the current dissection actually consulted
+       was changed; otherwise the change can't affect any dissected frame. */
+    if (model_->applyChanges())
+        wsApp->queueAppSignal(WiresharkApplication::PacketDissectionChanged);
 }
 
 void DecodeAsDialog::on_buttonBox_clicked(QAbstractButton *button)
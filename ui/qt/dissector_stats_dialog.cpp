@@ -0,0 +1,129 @@
+/* dissector_stats_dialog.cpp
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dissector_stats_dialog.h"
+#include <ui_dissector_stats_dialog.h>
+
+#include "config.h"
+
+#include <glib.h>
+
+#include <epan/dissector_stats.h>
+#include <epan/proto.h>
+
+#include <QAbstractButton>
+#include <QDialogButtonBox>
+#include <QTreeWidgetItem>
+
+#include "wireshark_application.h"
+
+namespace {
+
+enum {
+    col_protocol_,
+    col_calls_,
+    col_self_time_,
+    col_total_time_,
+    col_self_bytes_,
+    col_total_bytes_
+};
+
+// QTreeWidgetItem sorts by display text; everything except the protocol
+// column is numeric, so compare the raw values stashed in Qt::UserRole.
+class DissectorStatsTreeWidgetItem : public QTreeWidgetItem
+{
+public:
+    DissectorStatsTreeWidgetItem(QTreeWidget *parent) : QTreeWidgetItem(parent) {}
+
+    bool operator< (const QTreeWidgetItem &other) const
+    {
+        int col = treeWidget()->sortColumn();
+        if (col == col_protocol_) {
+            return QTreeWidgetItem::operator< (other);
+        }
+        return data(col, Qt::UserRole).toDouble() < other.data(col, Qt::UserRole).toDouble();
+    }
+};
+
+} // namespace
+
+DissectorStatsDialog::DissectorStatsDialog(QWidget *parent) :
+    GeometryStateDialog(parent),
+    ui(new Ui::DissectorStatsDialog)
+{
+    ui->setupUi(this);
+    loadGeometry();
+    setAttribute(Qt::WA_DeleteOnClose, true);
+    setWindowTitle(wsApp->windowTitleString(tr("Dissector Statistics")));
+
+    ui->enableCheckBox->setChecked(dissector_stats_enabled());
+
+    fillStats();
+}
+
+DissectorStatsDialog::~DissectorStatsDialog()
+{
+    delete ui;
+}
+
+void DissectorStatsDialog::fillStats()
+{
+    GArray *stats = dissector_stats_snapshot();
+
+    ui->statsTreeWidget->setSortingEnabled(false);
+    ui->statsTreeWidget->clear();
+
+    for (guint i = 0; i < stats->len; i++) {
+        dissector_stat_t *st = &g_array_index(stats, dissector_stat_t, i);
+        DissectorStatsTreeWidgetItem *item = new DissectorStatsTreeWidgetItem(ui->statsTreeWidget);
+
+        item->setText(col_protocol_, proto_get_protocol_filter_name(st->proto_id));
+        item->setText(col_calls_, QString::number(st->calls));
+        item->setText(col_self_time_, QString::number(st->self_nsecs / 1000000.0, 'f', 3));
+        item->setText(col_total_time_, QString::number(st->total_nsecs / 1000000.0, 'f', 3));
+        item->setText(col_self_bytes_, QString::number(st->self_bytes / 1024));
+        item->setText(col_total_bytes_, QString::number(st->total_bytes / 1024));
+
+        item->setData(col_calls_, Qt::UserRole, QVariant(double(st->calls)));
+        item->setData(col_self_time_, Qt::UserRole, QVariant(double(st->self_nsecs)));
+        item->setData(col_total_time_, Qt::UserRole, QVariant(double(st->total_nsecs)));
+        item->setData(col_self_bytes_, Qt::UserRole, QVariant(double(st->self_bytes)));
+        item->setData(col_total_bytes_, Qt::UserRole, QVariant(double(st->total_bytes)));
+
+        for (int col = col_calls_; col <= col_total_bytes_; col++) {
+            item->setTextAlignment(col, Qt::AlignRight);
+        }
+    }
+
+    g_array_free(stats, TRUE);
+
+    ui->statsTreeWidget->setSortingEnabled(true);
+    ui->statsTreeWidget->sortByColumn(col_self_time_, Qt::DescendingOrder);
+    for (int col = 0; col < ui->statsTreeWidget->columnCount(); col++) {
+        ui->statsTreeWidget->resizeColumnToContents(col);
+    }
+}
+
+void DissectorStatsDialog::on_enableCheckBox_toggled(bool checked)
+{
+    dissector_stats_set_enabled(checked);
+    if (checked) {
+        // Fresh counters land on the next dissection pass; show what we
+        // have in the meantime.
+        fillStats();
+    }
+}
+
+void DissectorStatsDialog::on_buttonBox_clicked(QAbstractButton *button)
+{
+    if (ui->buttonBox->buttonRole(button) == QDialogButtonBox::ResetRole) {
+        dissector_stats_reset();
+        fillStats();
+    }
+}
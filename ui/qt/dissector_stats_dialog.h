@@ -0,0 +1,39 @@
+/* dissector_stats_dialog.h
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef DISSECTOR_STATS_DIALOG_H
+#define DISSECTOR_STATS_DIALOG_H
+
+#include "geometry_state_dialog.h"
+
+namespace Ui {
+class DissectorStatsDialog;
+}
+
+class QAbstractButton;
+
+class DissectorStatsDialog : public GeometryStateDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DissectorStatsDialog(QWidget *parent = 0);
+    ~DissectorStatsDialog();
+
+protected slots:
+    void on_enableCheckBox_toggled(bool checked);
+    void on_buttonBox_clicked(QAbstractButton *button);
+
+private:
+    Ui::DissectorStatsDialog *ui;
+
+    void fillStats();
+};
+
+#endif // DISSECTOR_STATS_DIALOG_H
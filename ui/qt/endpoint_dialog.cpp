@@ -617,7 +617,7 @@ void EndpointTreeWidget::updateItems()
         return;
     }
 
-    setSortingEnabled(false);
+    pauseSorting();
 
     QList<QTreeWidgetItem *>new_items;
     for (int i = topLevelItemCount(); i < (int) hash_.conv_array->len; i++) {
@@ -641,7 +641,7 @@ void EndpointTreeWidget::updateItems()
 #endif
     }
     addTopLevelItems(new_items);
-    setSortingEnabled(true);
+    resumeSorting();
 
     if (resize) {
         for (int col = 0; col < columnCount(); col++) {
@@ -59,7 +59,8 @@ FileSetDialog::FileSetDialog(QWidget *parent) :
     GeometryStateDialog(parent),
     fs_ui_(new Ui::FileSetDialog),
     fileset_entry_model_(new FilesetEntryModel(this)),
-    close_button_(NULL)
+    close_button_(NULL),
+    open_set_button_(NULL)
 {
     fs_ui_->setupUi(this);
     loadGeometry ();
@@ -70,6 +71,12 @@ FileSetDialog::FileSetDialog(QWidget *parent) :
 
     close_button_ = fs_ui_->buttonBox->button(QDialogButtonBox::Close);
 
+    open_set_button_ = fs_ui_->buttonBox->addButton(tr("Open as One Capture"),
+                                                    QDialogButtonBox::ActionRole);
+    open_set_button_->setToolTip(tr("Open every file of the set as one virtual, concatenated capture."));
+    open_set_button_->setEnabled(false);
+    connect(open_set_button_, SIGNAL(clicked()), this, SLOT(openSetButtonClicked()));
+
     connect(fs_ui_->fileSetTree->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
             this, SLOT(selectionChanged(QItemSelection,QItemSelection)));
 
@@ -111,6 +118,8 @@ void FileSetDialog::beginAddFile()
     setWindowTitle(wsApp->windowTitleString(tr("No files in Set")));
     fs_ui_->directoryLabel->setText(tr("No capture loaded"));
     fs_ui_->directoryLabel->setEnabled(false);
+    if (open_set_button_)
+        open_set_button_->setEnabled(false);
 }
 
 void FileSetDialog::endAddFile()
@@ -135,6 +144,10 @@ void FileSetDialog::endAddFile()
 
     if (close_button_)
         close_button_->setEnabled(true);
+
+    /* Opening the set as one capture only makes sense for a real set. */
+    if (open_set_button_)
+        open_set_button_->setEnabled(fileset_entry_model_->entryCount() > 1);
 }
 
 void FileSetDialog::selectionChanged(const QItemSelection &selected, const QItemSelection &)
@@ -151,6 +164,11 @@ void FileSetDialog::selectionChanged(const QItemSelection &selected, const QItem
     }
 }
 
+void FileSetDialog::openSetButtonClicked()
+{
+    emit fileSetOpenCaptureSet();
+}
+
 void FileSetDialog::on_buttonBox_helpRequested()
 {
     wsApp->helpTopicAction(HELP_FILESET_DIALOG);
@@ -43,15 +43,18 @@ public:
 
 signals:
     void fileSetOpenCaptureFile(QString);
+    void fileSetOpenCaptureSet();
 
 private slots:
     void selectionChanged(const QItemSelection &selected, const QItemSelection &);
+    void openSetButtonClicked();
     void on_buttonBox_helpRequested();
 
 private:
     Ui::FileSetDialog *fs_ui_;
     FilesetEntryModel *fileset_entry_model_;
     QPushButton *close_button_;
+    QPushButton *open_set_button_;
     int cur_idx_;
 };
 
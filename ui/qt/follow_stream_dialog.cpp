@@ -1107,12 +1107,27 @@ bool FollowStreamDialog::follow(QString previous_filter, bool use_stream_index,
     }
     }
 
+    const guint32 *index_frames = NULL;
+    guint index_frame_count = 0;
+
+    if (follow_type_ == FOLLOW_TCP) {
+        index_frames = get_tcp_follow_index_frames(stream_num, &index_frame_count);
+    }
+
     beginRetapPackets();
     updateWidgets(true);
 
-    /* Run the display filter so it goes in effect - even if it's the
-       same as the previous display filter. */
-    emit updateFilter(follow_filter, TRUE);
+    if (index_frames) {
+        /* The load pass built a payload index for this stream
+           (tcp.follow_index); feed the tap with exactly its data
+           segments instead of rescanning the whole file. The main
+           display filter is left untouched. */
+        cf_retap_frames(cap_file_.capFile(), index_frames, index_frame_count);
+    } else {
+        /* Run the display filter so it goes in effect - even if it's the
+           same as the previous display filter. */
+        emit updateFilter(follow_filter, TRUE);
+    }
 
     removeTapListeners();
 
@@ -1163,7 +1178,7 @@ bool FollowStreamDialog::follow(QString previous_filter, bool use_stream_index,
     updateWidgets(false);
     endRetapPackets();
 
-    if (prefs.restore_filter_after_following_stream) {
+    if (!index_frames && prefs.restore_filter_after_following_stream) {
         emit updateFilter(previous_filter_, TRUE);
     }
 
@@ -1195,6 +1210,45 @@ void FollowStreamDialog::captureFileClosed()
  * This might or might not be the reason why C arrays display
  * correctly but get extra blank lines very other line when printed.
  */
+// Render a run of merged same-direction records with a single showBuffer()
+// call, then record the packet boundaries of the individual records in
+// text_pos_to_packet_ as if they had been inserted one by one.
+frs_return_t
+FollowStreamDialog::flushMergedRecords(QByteArray &buffer, QList<QPair<int, guint32> > &record_ends,
+                                       gboolean is_from_server, nstime_t abs_ts, guint32 *global_pos)
+{
+    frs_return_t frs_return;
+
+    if (buffer.isEmpty())
+        return FRS_OK;
+
+    frs_return = showBuffer(
+                buffer.data(),
+                buffer.size(),
+                is_from_server,
+                record_ends.last().second,
+                abs_ts,
+                global_pos);
+
+    if (frs_return != FRS_PRINT_ERROR && !truncated_) {
+        // addText() mapped the end of the whole insertion to the last
+        // record; map the intermediate record boundaries as well. In the
+        // ASCII and EBCDIC views each stream byte becomes exactly one
+        // character, so the offsets within the buffer carry over.
+        int end_pos = ui->teStreamContent->textCursor().anchor();
+        int total = buffer.size();
+        for (int i = 0; i < record_ends.size() - 1; i++) {
+            text_pos_to_packet_[end_pos - (total - record_ends[i].first)] =
+                    record_ends[i].second;
+        }
+    }
+
+    buffer.clear();
+    record_ends.clear();
+
+    return frs_return;
+}
+
 frs_return_t
 FollowStreamDialog::readFollowStream()
 {
@@ -1206,6 +1260,19 @@ FollowStreamDialog::readFollowStream()
     follow_record_t *follow_record;
     QElapsedTimer elapsed_timer;
 
+    // In the ASCII and EBCDIC views, consecutive records from the same
+    // direction can be merged and handed to the text widget as a single
+    // insertion; inserting per record makes QTextEdit redo its layout
+    // work once per packet, which takes minutes on gigabyte streams.
+    // The other views emit per-record framing (offsets, timestamps), so
+    // they keep the one-call-per-record path.
+    const bool merge_records = (show_type_ == SHOW_ASCII || show_type_ == SHOW_EBCDIC);
+    const int merged_flush_bytes = 4 * 1024 * 1024;
+    QByteArray merged;
+    QList<QPair<int, guint32> > merged_ends;   // (end offset, packet number)
+    gboolean merged_is_server = FALSE;
+    nstime_t merged_abs_ts = { 0, 0 };
+
     elapsed_timer.start();
 
     for (cur = g_list_last(follow_info_.payload); cur; cur = g_list_previous(cur)) {
@@ -1225,10 +1292,28 @@ FollowStreamDialog::readFollowStream()
             }
         }
 
-        QByteArray buffer;
-        if (!skip) {
+        if (skip)
+            continue;
+
+        if (merge_records) {
+            if (!merged.isEmpty() &&
+                (merged_is_server != follow_record->is_server ||
+                 merged.size() >= merged_flush_bytes)) {
+                frs_return = flushMergedRecords(merged, merged_ends,
+                                                merged_is_server, merged_abs_ts,
+                                                merged_is_server ? &global_server_pos
+                                                                 : &global_client_pos);
+                if (frs_return == FRS_PRINT_ERROR)
+                    return frs_return;
+            }
+            merged.append((const char *) follow_record->data->data,
+                          follow_record->data->len);
+            merged_ends.append(qMakePair(merged.size(), follow_record->packet_num));
+            merged_is_server = follow_record->is_server;
+            merged_abs_ts = follow_record->abs_ts;
+        } else {
             // We want a deep copy.
-            buffer.clear();
+            QByteArray buffer;
             buffer.append((const char *) follow_record->data->data,
                                      follow_record->data->len);
             frs_return = showBuffer(
@@ -1240,13 +1325,31 @@ FollowStreamDialog::readFollowStream()
                         global_pos);
             if (frs_return == FRS_PRINT_ERROR)
                 return frs_return;
-            if (elapsed_timer.elapsed() > info_update_freq_) {
-                fillHintLabel(ui->teStreamContent->textCursor().position());
-                wsApp->processEvents();
-                elapsed_timer.start();
+        }
+
+        if (elapsed_timer.elapsed() > info_update_freq_) {
+            if (merge_records) {
+                frs_return = flushMergedRecords(merged, merged_ends,
+                                                merged_is_server, merged_abs_ts,
+                                                merged_is_server ? &global_server_pos
+                                                                 : &global_client_pos);
+                if (frs_return == FRS_PRINT_ERROR)
+                    return frs_return;
             }
+            fillHintLabel(ui->teStreamContent->textCursor().position());
+            wsApp->processEvents();
+            elapsed_timer.start();
         }
     }
 
+    if (merge_records) {
+        frs_return = flushMergedRecords(merged, merged_ends,
+                                        merged_is_server, merged_abs_ts,
+                                        merged_is_server ? &global_server_pos
+                                                         : &global_client_pos);
+        if (frs_return == FRS_PRINT_ERROR)
+            return frs_return;
+    }
+
     return FRS_OK;
 }
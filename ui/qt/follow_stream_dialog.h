@@ -28,6 +28,7 @@
 
 #include <QFile>
 #include <QMap>
+#include <QPair>
 #include <QPushButton>
 
 namespace Ui {
@@ -84,6 +85,9 @@ private:
     frs_return_t
     showBuffer(char *buffer, size_t nchars, gboolean is_from_server,
                 guint32 packet_num, nstime_t abs_ts, guint32 *global_pos);
+    frs_return_t
+    flushMergedRecords(QByteArray &buffer, QList<QPair<int, guint32> > &record_ends,
+                gboolean is_from_server, nstime_t abs_ts, guint32 *global_pos);
 
     frs_return_t readStream();
     frs_return_t readFollowStream();
@@ -1225,14 +1225,19 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
 {
     int interval = ui->intervalComboBox->itemData(ui->intervalComboBox->currentIndex()).toInt();
     bool need_retap = false;
+    bool need_recalc = false;
 
     if (uat_model_ != NULL) {
         for (int row = 0; row < uat_model_->rowCount(); row++) {
             IOGraph *iog = ioGraphs_.value(row, NULL);
             if (iog) {
-                iog->setInterval(interval);
+                bool rebinned = iog->setInterval(interval);
                 if (iog->visible()) {
-                    need_retap = true;
+                    if (rebinned) {
+                        need_recalc = true;
+                    } else {
+                        need_retap = true;
+                    }
                 }
             }
         }
@@ -1240,6 +1245,8 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
 
     if (need_retap) {
         scheduleRetap(true);
+    } else if (need_recalc) {
+        scheduleRecalc(true);
     }
 
     updateLegend();
@@ -2134,9 +2141,26 @@ bool IOGraph::hasItemToShow(int idx, double value) const
     return result;
 }
 
-void IOGraph::setInterval(int interval)
+bool IOGraph::setInterval(int interval)
 {
+    if (interval == interval_) {
+        return true;
+    }
+
+    // If the new interval is a multiple of the current one we can merge
+    // the existing bins in place instead of retapping every packet --
+    // unless we hit the item limit at the finer binning, in which case
+    // only a retap can recover the packets beyond the truncation point.
+    if (interval_ > 0 && cur_idx_ >= 0 && cur_idx_ < max_io_items_ - 1
+        && interval > interval_ && interval % interval_ == 0) {
+        cur_idx_ = rebin_io_graph_items(items_, cur_idx_, interval_, interval,
+                                        val_units_);
+        interval_ = interval;
+        return true;
+    }
+
     interval_ = interval;
+    return false;
 }
 
 // Get the value at the given interval (idx) for the current value unit.
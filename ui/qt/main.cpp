@@ -136,6 +136,22 @@ void main_window_update(void)
     WiresharkApplication::processEvents();
 }
 
+/* Keep the main window looking alive while a single huge packet's tree
+   is being built.  We must not pump the event loop here: excluding user
+   input and socket notifiers still delivers paint and timer events, and
+   both the packet list's paint path and its idle-dissection timer
+   lazily dissect rows, which would re-enter dissection while a packet
+   scope is live.  Synchronously repaint the status bar instead; we
+   never ask for cancellation. */
+static gboolean
+main_window_tree_progress(guint items _U_, void *user_data _U_)
+{
+    MainWindow *mw = qobject_cast<MainWindow *>(wsApp->mainWindow());
+    if (mw && mw->statusBar())
+        mw->statusBar()->repaint();
+    return FALSE;
+}
+
 #ifdef HAVE_LIBPCAP
 
 /* quit the main window */
@@ -789,6 +805,10 @@ int main(int argc, char *qt_argv[])
     ws_log(LOG_DOMAIN_MAIN, LOG_LEVEL_INFO, "epan done, elapsed time %" G_GUINT64_FORMAT " us \n", g_get_monotonic_time() - start_time);
 #endif
 
+    /* Pump the event loop every so many tree items so the main window
+       keeps repainting during multi-second builds of oversized PDUs. */
+    proto_tree_set_progress_callback(main_window_tree_progress, 100000, NULL);
+
     /* Register all audio codecs. */
     codecs_init();
 
@@ -1010,7 +1030,7 @@ int main(int argc, char *qt_argv[])
                     /* Filter ok, jump to the first packet matching the filter
                        conditions. Default search direction is forward, but if
                        option d was given, search backwards */
-                    cf_find_packet_dfilter(CaptureFile::globalCapFile(), jump_to_filter, global_commandline_info.jump_backwards);
+                    cf_find_packet_dfilter(CaptureFile::globalCapFile(), jump_to_filter, global_commandline_info.jfilter, global_commandline_info.jump_backwards);
                 }
             }
         }
@@ -433,6 +433,8 @@ MainWindow::MainWindow(QWidget *parent) :
     file_set_dialog_ = new FileSetDialog(this);
     connect(file_set_dialog_, SIGNAL(fileSetOpenCaptureFile(QString)),
             this, SLOT(openCaptureFile(QString)));
+    connect(file_set_dialog_, SIGNAL(fileSetOpenCaptureSet()),
+            this, SLOT(openCaptureSet()));
 
     initMainToolbarIcons();
 
@@ -570,6 +572,8 @@ MainWindow::MainWindow(QWidget *parent) :
             this, SLOT(updateRecentActions()));
     connect(wsApp, SIGNAL(packetDissectionChanged()),
             this, SLOT(redissectPackets()), Qt::QueuedConnection);
+    connect(wsApp, SIGNAL(colorsChanged()),
+            packet_list_, SLOT(recolorPackets()), Qt::QueuedConnection);
 
     connect(wsApp, SIGNAL(checkDisplayFilter()),
             this, SLOT(checkDisplayFilter()));
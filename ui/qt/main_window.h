@@ -324,6 +324,8 @@ public slots:
     // XXX We might want to return a cf_read_status_t or a CaptureFile.
     bool openCaptureFile(QString cf_path, QString display_filter, unsigned int type, gboolean is_tempfile = FALSE);
     bool openCaptureFile(QString cf_path = QString(), QString display_filter = QString()) { return openCaptureFile(cf_path, display_filter, WTAP_TYPE_AUTO); }
+    /** Open every file of the current file set as one virtual capture. */
+    void openCaptureSet();
     void filterPackets(QString new_filter = QString(), bool force = false);
     void setDisplayFilter(QString filter, FilterAction::Action action, FilterAction::ActionType filterType);
     void updateForUnsavedChanges();
@@ -628,6 +630,7 @@ private slots:
     void on_actionStatisticsCaptureFileProperties_triggered();
     void on_actionStatisticsResolvedAddresses_triggered();
     void on_actionStatisticsProtocolHierarchy_triggered();
+    void on_actionStatisticsDissectorStats_triggered();
     void on_actionStatisticsFlowGraph_triggered();
     void openTcpStreamDialog(int graph_type);
     void on_actionStatisticsTcpStreamStevens_triggered();
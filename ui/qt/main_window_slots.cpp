@@ -105,6 +105,7 @@ DIAG_ON(frame-larger-than=)
 #include "decode_as_dialog.h"
 #include <ui/qt/widgets/display_filter_edit.h>
 #include "display_filter_expression_dialog.h"
+#include "dissector_stats_dialog.h"
 #include "dissector_tables_dialog.h"
 #include "endpoint_dialog.h"
 #include "expert_info_dialog.h"
@@ -289,6 +290,50 @@ finish:
     return ret;
 }
 
+void MainWindow::openCaptureSet()
+{
+    char **fnames = fileset_get_fullname_list();
+    guint n_fnames;
+    int err;
+
+    if (!fnames) return;
+    n_fnames = g_strv_length(fnames);
+
+    /* Grabbing the name list above has to happen first: closing the
+       current file clears the file set. */
+    if (!testCaptureFileClose(tr(" before opening the file set"))) {
+        g_strfreev(fnames);
+        return;
+    }
+
+    setMwFileName(fnames[0]);
+
+    /* Try to open the whole set as one virtual capture. */
+    CaptureFile::globalCapFile()->window = this;
+    if (cf_open_file_set(CaptureFile::globalCapFile(), fnames, n_fnames, &err) != CF_OK) {
+        CaptureFile::globalCapFile()->window = NULL;
+        g_strfreev(fnames);
+        return;
+    }
+    g_strfreev(fnames);
+
+    switch (cf_read(CaptureFile::globalCapFile(), FALSE)) {
+    case CF_READ_OK:
+    case CF_READ_ERROR:
+        /* Just because we got an error, that doesn't mean we were unable
+           to read any of the set; we handle what we could get from it. */
+        break;
+
+    case CF_READ_ABORTED:
+        /* The user bailed out of re-reading the capture file; the
+           capture file has been closed. */
+        capture_file_.setCapFile(NULL);
+        return;
+    }
+
+    main_ui_->statusBar->showExpert();
+}
+
 void MainWindow::filterPackets(QString new_filter, bool force)
 {
     cf_status_t cf_status;
@@ -3762,7 +3807,7 @@ void MainWindow::goToConversationFrame(bool go_next) {
         return;
     }
 
-    found_packet = cf_find_packet_dfilter(capture_file_.capFile(), dfcode, go_next ? SD_FORWARD : SD_BACKWARD);
+    found_packet = cf_find_packet_dfilter(capture_file_.capFile(), dfcode, filter, go_next ? SD_FORWARD : SD_BACKWARD);
 
     if (!found_packet) {
         /* We didn't find a packet */
@@ -3910,6 +3955,12 @@ void MainWindow::on_actionStatisticsResolvedAddresses_triggered()
     resolved_addresses_dialog->show();
 }
 
+void MainWindow::on_actionStatisticsDissectorStats_triggered()
+{
+    DissectorStatsDialog *dissector_stats_dialog = new DissectorStatsDialog(this);
+    dissector_stats_dialog->show();
+}
+
 void MainWindow::on_actionStatisticsProtocolHierarchy_triggered()
 {
     ProtocolHierarchyDialog *phd = new ProtocolHierarchyDialog(*this, capture_file_);
@@ -0,0 +1,63 @@
+/* batched_table_model.cpp
+ * Base model for tables that grow one row at a time from a tap.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "batched_table_model.h"
+
+#include <QTimer>
+
+// Same cadence as PacketListModel::flushVisibleRows(): one coalesced
+// insertion per display frame is plenty.
+static const int publish_interval_ = 16; // Milliseconds, ~60fps.
+
+BatchedTableModel::BatchedTableModel(QObject *parent) :
+    QAbstractTableModel(parent),
+    published_rows_(0),
+    publish_scheduled_(false)
+{
+}
+
+int BatchedTableModel::rowCount(const QModelIndex &parent) const
+{
+    // there are no children
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    return published_rows_;
+}
+
+void BatchedTableModel::rowsAppended()
+{
+    if (publish_scheduled_)
+        return;
+
+    publish_scheduled_ = true;
+    QTimer::singleShot(publish_interval_, this, SLOT(publishRows()));
+}
+
+void BatchedTableModel::publishRows()
+{
+    int stored = storedRowCount();
+
+    publish_scheduled_ = false;
+    // The storage may have been reset since we were scheduled; in that
+    // case resetBatch() already brought the views up to date.
+    if (stored <= published_rows_)
+        return;
+
+    emit beginInsertRows(QModelIndex(), published_rows_, stored - 1);
+    published_rows_ = stored;
+    emit endInsertRows();
+}
+
+void BatchedTableModel::resetBatch()
+{
+    published_rows_ = 0;
+}
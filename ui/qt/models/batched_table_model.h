@@ -0,0 +1,65 @@
+/* batched_table_model.h
+ * Base model for tables that grow one row at a time from a tap.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BATCHED_TABLE_MODEL_H
+#define BATCHED_TABLE_MODEL_H
+
+#include <config.h>
+
+#include <QAbstractTableModel>
+
+/**
+ * Base class for flat table models whose rows arrive one at a time from a
+ * tap while a capture is running.  Emitting beginInsertRows/endInsertRows
+ * for each row makes every attached view, and any sort/filter proxy in
+ * between, re-evaluate its layout per row, which is O(n) per update tick.
+ *
+ * Subclasses append rows to their own storage without emitting anything
+ * and call rowsAppended(); the new rows stay invisible until the next
+ * flush, when everything that accumulated is published to the views in a
+ * single beginInsertRows span.  The flush cadence matches the one
+ * PacketListModel uses for live captures.
+ *
+ * Subclasses must implement storedRowCount(), must leave rowCount() to
+ * this class, and must call resetBatch() inside their own model reset
+ * when they empty their storage.
+ *
+ * Like CacheProxyModel, only flat data is supported; tree models (with
+ * parents) are unsupported.
+ */
+class BatchedTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit BatchedTableModel(QObject *parent = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+
+protected:
+    /** Rows in the subclass's storage, published or not. */
+    virtual int storedRowCount() const = 0;
+
+    /** Call after appending one or more rows to the storage. */
+    void rowsAppended();
+
+    /** Call when the storage has been emptied, between the subclass's
+     *  own beginResetModel/endResetModel pair. */
+    void resetBatch();
+
+private slots:
+    void publishRows();
+
+private:
+    int published_rows_;
+    bool publish_scheduled_;
+};
+
+#endif // BATCHED_TABLE_MODEL_H
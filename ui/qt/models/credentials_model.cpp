@@ -16,15 +16,10 @@
 #include <ui/qt/utils/qt_ui_utils.h>
 
 CredentialsModel::CredentialsModel(QObject *parent)
-    :QAbstractListModel(parent)
+    :BatchedTableModel(parent)
 {
 }
 
-int CredentialsModel::rowCount(const QModelIndex &) const
-{
-    return credentials_.count();
-}
-
 int CredentialsModel::columnCount(const QModelIndex &) const
 {
     return COL_INFO + 1;
@@ -100,8 +95,6 @@ QVariant CredentialsModel::data(const QModelIndex &index, int role) const
 
 void CredentialsModel::addRecord(const tap_credential_t* auth)
 {
-    emit beginInsertRows(QModelIndex(), rowCount(), rowCount() + 1);
-
     tap_credential_t* clone = new tap_credential_t;
     clone->num = auth->num;
     clone->username_num = auth->username_num;
@@ -111,20 +104,21 @@ void CredentialsModel::addRecord(const tap_credential_t* auth)
     clone->info = qstring_strdup(auth->info);
     credentials_.append(clone);
 
-    emit endInsertRows();
+    rowsAppended();
 }
 
 void CredentialsModel::clear()
 {
     if (!credentials_.isEmpty()) {
-        emit beginRemoveRows(QModelIndex(), 0, rowCount() - 1);
+        emit beginResetModel();
         for (QList<tap_credential_t*>::iterator itr = credentials_.begin(); itr != credentials_.end(); ++itr) {
             g_free((*itr)->username);
             g_free((*itr)->info);
             delete *itr;
         }
         credentials_.clear();
-        emit endRemoveRows();
+        resetBatch();
+        emit endResetModel();
     }
 }
 
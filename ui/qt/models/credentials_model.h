@@ -13,19 +13,18 @@
 #ifndef CREDENTIALS_MODELS_H
 #define CREDENTIALS_MODELS_H
 
-#include <QAbstractListModel>
 #include <QList>
 
 #include <epan/tap.h>
 #include <capture_file.h>
 #include <ui/tap-credentials.h>
+#include <ui/qt/models/batched_table_model.h>
 
-class CredentialsModel : public QAbstractListModel
+class CredentialsModel : public BatchedTableModel
 {
     Q_OBJECT
 public:
     CredentialsModel(QObject *parent);
-    virtual int rowCount(const QModelIndex &parent = QModelIndex()) const ;
     virtual int columnCount(const QModelIndex &parent = QModelIndex()) const;
     virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
     virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
@@ -44,6 +43,9 @@ public:
         ColumnHFID = Qt::UserRole + 1
     };
 
+protected:
+    int storedRowCount() const { return credentials_.count(); }
+
 private:
     QList<tap_credential_t*> credentials_;
 
@@ -21,6 +21,8 @@
 
 #include <ui/qt/utils/qt_ui_utils.h>
 #include <wsutil/file_util.h>
+
+#include "session_journal.h"
 #include <wsutil/ws_assert.h>
 
 #include <QVector>
@@ -705,12 +707,13 @@ void DecodeAsModel::gatherChangedEntries(const gchar *table_name,
     }
 }
 
-void DecodeAsModel::applyChanges()
+bool DecodeAsModel::applyChanges()
 {
     dissector_table_t sub_dissectors;
     module_t *module;
     pref_t* pref_value;
     dissector_handle_t handle;
+    bool redissect_needed = false;
     // Reset all dissector tables, then apply all rules from model.
 
     // We can't call g_hash_table_removed from g_hash_table_foreach, which
@@ -722,6 +725,11 @@ void DecodeAsModel::applyChanges()
     // instead.
     dissector_all_tables_foreach_changed(gatherChangedEntries, this);
     foreach (UintPair uint_entry, changed_uint_entries_) {
+        /* If the current dissection never looked this table up, resetting
+           it can't change any dissected frame. */
+        if (dissector_table_consulted(uint_entry.first))
+            redissect_needed = true;
+
         /* Set "Decode As preferences" to default values */
         sub_dissectors = find_dissector_table(uint_entry.first);
         handle = dissector_get_uint_handle(sub_dissectors, uint_entry.second);
@@ -738,6 +746,8 @@ void DecodeAsModel::applyChanges()
     }
     changed_uint_entries_.clear();
     foreach (CharPtrPair char_ptr_entry, changed_string_entries_) {
+        if (dissector_table_consulted(char_ptr_entry.first))
+            redissect_needed = true;
         dissector_reset_string(char_ptr_entry.first, char_ptr_entry.second);
     }
     changed_string_entries_.clear();
@@ -754,6 +764,9 @@ void DecodeAsModel::applyChanges()
 
             if (!g_strcmp0(decode_as_entry->table_name, item->tableName_)) {
 
+                if (dissector_table_consulted(item->tableName_))
+                    redissect_needed = true;
+
                 ftenum_t selector_type = get_dissector_table_selector_type(item->tableName_);
                 gconstpointer  selector_value;
                 QByteArray byteArray;
@@ -824,4 +837,11 @@ void DecodeAsModel::applyChanges()
         }
     }
     prefs_apply_all();
+
+    /* Journal the new binding set so a reopen of this capture (or a
+       crash) doesn't lose it. */
+    if (cap_file_)
+        session_journal_record_decode_as(cap_file_);
+
+    return redissect_needed;
 }
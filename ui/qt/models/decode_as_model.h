@@ -79,7 +79,10 @@ public:
 
     static QString entryString(const gchar *table_name, gconstpointer value);
 
-    void applyChanges();
+    // Apply the model's rules to the dissector tables.  Returns true if
+    // any affected table has been consulted by the current dissection
+    // session, i.e. if the changes call for a redissection.
+    bool applyChanges();
 
 protected:
     static void buildChangedList(const gchar *table_name, ftenum_t selector_type,
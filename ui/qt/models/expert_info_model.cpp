@@ -19,6 +19,7 @@ ExpertPacketItem::ExpertPacketItem(const expert_info_t& expert_info, column_info
     hf_id_(expert_info.hf_index),
     protocol_(expert_info.protocol),
     summary_(expert_info.summary),
+    row_(0),
     parentItem_(parent)
 {
     if (cinfo) {
@@ -54,6 +55,7 @@ QString ExpertPacketItem::groupKey(bool group_by_summary) {
 
 void ExpertPacketItem::appendChild(ExpertPacketItem* child, QString hash)
 {
+    child->row_ = childItems_.count();
     childItems_.append(child);
     hashChild_[hash] = child;
 }
@@ -75,8 +77,10 @@ int ExpertPacketItem::childCount() const
 
 int ExpertPacketItem::row() const
 {
+    // Children are only ever appended (the tree is rebuilt from scratch on
+    // reset), so the index cached at insertion time stays valid.
     if (parentItem_)
-        return parentItem_->childItems_.indexOf(const_cast<ExpertPacketItem*>(this));
+        return row_;
 
     return 0;
 }
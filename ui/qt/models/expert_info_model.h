@@ -59,6 +59,7 @@ private:
     QByteArray info_;
 
     QList<ExpertPacketItem*> childItems_;
+    int row_;                  //cached index in parent's childItems_
     ExpertPacketItem* parentItem_;
     QHash<QString, ExpertPacketItem*> hashChild_;    //optimization for insertion
 };
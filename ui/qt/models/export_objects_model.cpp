@@ -16,6 +16,7 @@
 #include <epan/prefs.h>
 
 #include <QDir>
+#include <QSet>
 
 extern "C" {
 
@@ -43,7 +44,7 @@ object_list_get_entry(void *gui_data, int row) {
 
 
 ExportObjectModel::ExportObjectModel(register_eo_t* eo, QObject *parent) :
-    QAbstractTableModel(parent),
+    BatchedTableModel(parent),
     eo_(eo)
 {
     eo_gui_data_.model = this;
@@ -108,16 +109,6 @@ QVariant ExportObjectModel::headerData(int section, Qt::Orientation orientation,
     return QVariant();
 }
 
-int ExportObjectModel::rowCount(const QModelIndex &parent) const
-{
-    // there are no children
-    if (parent.isValid()) {
-        return 0;
-    }
-
-    return objects_.count();
-}
-
 int ExportObjectModel::columnCount(const QModelIndex&) const
 {
     return colExportObjectMax;
@@ -128,10 +119,10 @@ void ExportObjectModel::addObjectEntry(export_object_entry_t *entry)
     if (entry == NULL)
         return;
 
-    int count = objects_.count();
-    beginInsertRows(QModelIndex(), count, count);
     objects_.append(VariantPointer<export_object_entry_t>::asQVariant(entry));
-    endInsertRows();
+    // The tap can deliver one object per packet during a live capture;
+    // let the base model publish them in batches.
+    rowsAppended();
 }
 
 export_object_entry_t* ExportObjectModel::objectEntry(int row)
@@ -162,6 +153,10 @@ void ExportObjectModel::saveAllEntries(QString path)
 
     QDir save_dir(path);
     export_object_entry_t *entry;
+    eo_writer_t *writer = eo_writer_new();
+    // Queued files may not be on disk yet when we pick the next name,
+    // so remember the names already handed to the writer.
+    QSet<QString> claimed_names;
 
     for (QList<QVariant>::iterator it = objects_.begin(); it != objects_.end(); ++it)
     {
@@ -190,10 +185,15 @@ void ExportObjectModel::saveAllEntries(QString path)
             }
             filename = QString::fromUtf8(safe_filename->str);
             g_string_free(safe_filename, TRUE);
-        } while (save_dir.exists(filename) && ++count < prefs.gui_max_export_objects);
-        write_file_binary_mode(qUtf8Printable(save_dir.filePath(filename)),
-                               entry->payload_data, entry->payload_len);
+        } while ((claimed_names.contains(filename) || save_dir.exists(filename)) &&
+                 ++count < prefs.gui_max_export_objects);
+        claimed_names.insert(filename);
+        // The writer takes ownership of the path; the payload stays
+        // owned by the entry, which outlives eo_writer_finish().
+        eo_writer_queue(writer, qstring_strdup(save_dir.filePath(filename)),
+                        entry->payload_data, entry->payload_len);
     }
+    eo_writer_finish(writer);
 }
 
 void ExportObjectModel::resetObjects()
@@ -202,6 +202,7 @@ void ExportObjectModel::resetObjects()
 
     emit beginResetModel();
     objects_.clear();
+    resetBatch();
     emit endResetModel();
 
     if (reset_cb)
@@ -16,7 +16,8 @@
 #include <epan/tap.h>
 #include <epan/export_object.h>
 
-#include <QAbstractTableModel>
+#include <ui/qt/models/batched_table_model.h>
+
 #include <QSortFilterProxyModel>
 #include <QList>
 
@@ -24,7 +25,7 @@ typedef struct export_object_list_gui_t {
     class ExportObjectModel *model;
 } export_object_list_gui_t;
 
-class ExportObjectModel : public QAbstractTableModel
+class ExportObjectModel : public BatchedTableModel
 {
     Q_OBJECT
 
@@ -56,9 +57,11 @@ public:
     QVariant data(const QModelIndex &index, int role) const;
     QVariant headerData(int section, Qt::Orientation orientation,
                         int role = Qt::DisplayRole) const;
-    int rowCount(const QModelIndex &parent = QModelIndex()) const;
     int columnCount(const QModelIndex &parent = QModelIndex()) const;
 
+protected:
+    int storedRowCount() const { return objects_.count(); }
+
 private:
     QList<QVariant> objects_;
 
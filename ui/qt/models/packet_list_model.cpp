@@ -13,10 +13,14 @@
 #include "packet_list_model.h"
 
 #include "file.h"
+#include "session_journal.h"
 
 #include <wsutil/nstime.h>
+#include <wsutil/pipeline_stats.h>
+#include <wsutil/ws_tracepoints.h>
 #include <epan/column.h>
 #include <epan/prefs.h>
+#include <epan/timestamp.h>
 
 #include "ui/packet_list_utils.h"
 #include "ui/recent.h"
@@ -36,6 +40,8 @@
 #include <QFontMetrics>
 #include <QModelIndex>
 #include <QElapsedTimer>
+#include <QPair>
+#include <QThread>
 
 // Print timing information
 //#define DEBUG_PACKET_LIST_MODEL 1
@@ -47,6 +53,19 @@
 static PacketListModel * glbl_plist_model = Q_NULLPTR;
 static const int reserved_packets_ = 100000;
 
+// Rows on either side of the most recently accessed row that keep their
+// materialized PacketListRecord. Records outside the window are frozen
+// into the cold row tier (or, if that fails, re-created from dissection
+// if they're ever shown again).
+static const int materialized_row_window_ = 10000;
+
+// Cold row tier sizing: serialized bytes per segment and how many
+// compressed segments to keep. Column text compresses well (typically
+// 4:1 or better), so at the defaults the tier holds a few hundred
+// thousand frozen rows in roughly 10 MB.
+static const int frozen_segment_bytes_ = 512 * 1024;
+static const int max_frozen_segments_ = 64;
+
 guint
 packet_list_append(column_info *, frame_data *fdata)
 {
@@ -69,9 +88,16 @@ packet_list_recreate_visible_rows(void)
 PacketListModel::PacketListModel(QObject *parent, capture_file *cf) :
     QAbstractItemModel(parent),
     number_to_row_(QVector<int>()),
+    time_sorted_valid_(true),
+    record_window_anchor_(0),
+    first_frozen_segment_(0),
+    frozen_data_ver_(0),
+    thawed_segment_(-1),
     max_row_height_(0),
     max_line_count_(1),
-    idle_dissection_row_(0)
+    idle_dissection_row_(0),
+    priority_first_(0),
+    priority_last_(-1)
 {
     Q_ASSERT(glbl_plist_model == Q_NULLPTR);
     glbl_plist_model = this;
@@ -81,6 +107,7 @@ PacketListModel::PacketListModel(QObject *parent, capture_file *cf) :
     visible_rows_.reserve(reserved_packets_);
     new_visible_rows_.reserve(1000);
     number_to_row_.reserve(reserved_packets_);
+    time_sorted_rows_.reserve(reserved_packets_);
 
     if (qobject_cast<MainWindow *>(wsApp->mainWindow()))
     {
@@ -103,6 +130,7 @@ PacketListModel::PacketListModel(QObject *parent, capture_file *cf) :
 
 PacketListModel::~PacketListModel()
 {
+    qDeleteAll(record_window_);
     delete idle_dissection_timer_;
 }
 
@@ -117,9 +145,7 @@ QModelIndex PacketListModel::index(int row, int column, const QModelIndex &) con
     if (row >= visible_rows_.count() || row < 0 || !cap_file_ || column >= prefs.num_cols)
         return QModelIndex();
 
-    PacketListRecord *record = visible_rows_[row];
-
-    return createIndex(row, column, record);
+    return createIndex(row, column, recordFor(row));
 }
 
 // Everything is under the root.
@@ -135,6 +161,180 @@ int PacketListModel::packetNumberToRow(int packet_num) const
     return number_to_row_.value(packet_num) - 1;
 }
 
+// Return the materialized record for a visible row, creating one if needed.
+PacketListRecord *PacketListModel::recordFor(int row) const
+{
+    if (row < 0 || row >= visible_rows_.count())
+        return Q_NULLPTR;
+
+    frame_data *fdata = visible_rows_[row];
+    PacketListRecord *record = record_window_.value(fdata);
+    if (!record) {
+        record = new PacketListRecord(fdata);
+        // If this row was evicted earlier, refill its column strings
+        // from the cold tier so it doesn't have to be redissected.
+        thawRecord(fdata, record);
+        record_window_.insert(fdata, record);
+    }
+
+    // Slide the window lazily: only re-anchor (and evict) once accesses
+    // have drifted well away from the old anchor and enough records have
+    // piled up to be worth dropping. Records near the old anchor stay
+    // alive through the move, so indexes the view handed out recently
+    // keep pointing at live records.
+    if (qAbs(row - record_window_anchor_) > materialized_row_window_ / 2 &&
+        record_window_.count() > materialized_row_window_ * 2) {
+        pruneRecordWindow(row);
+    }
+
+    return record;
+}
+
+// Re-anchor the window at center_row and evict the records more than
+// materialized_row_window_ rows away from it, freezing their column
+// strings into the cold tier.
+void PacketListModel::pruneRecordWindow(int center_row) const
+{
+    record_window_anchor_ = center_row;
+
+    // Collect the evictees first and freeze them in row order, so rows
+    // that are adjacent on screen end up adjacent in the same segment
+    // and scrolling back through them thaws one segment, not many.
+    QVector<QPair<int, frame_data *> > evicted;
+    QHashIterator<frame_data *, PacketListRecord *> iter(record_window_);
+    while (iter.hasNext()) {
+        iter.next();
+        int row = packetNumberToRow(iter.key()->num);
+        if (row < center_row - materialized_row_window_ ||
+            row > center_row + materialized_row_window_) {
+            evicted << qMakePair(row, iter.key());
+        }
+    }
+    std::sort(evicted.begin(), evicted.end());
+
+    for (int i = 0; i < evicted.count(); i++) {
+        frame_data *fdata = evicted.at(i).second;
+        PacketListRecord *record = record_window_.take(fdata);
+        freezeRecord(fdata, record);
+        delete record;
+    }
+}
+
+// Append a record's cached column strings to the cold tier's fill
+// buffer, compressing the buffer into a segment once it's full.
+void PacketListModel::freezeRecord(frame_data *fdata, PacketListRecord *record) const
+{
+    if (frozen_data_ver_ != PacketListRecord::columnDataVersion()) {
+        // The tier predates a column invalidation; everything in it
+        // is stale.
+        dropFrozenRows();
+    }
+
+    if (frozen_rows_.contains(fdata)) {
+        // Still frozen from an earlier eviction (it was thawed, not
+        // invalidated, in between); no need to store a second copy.
+        return;
+    }
+
+    FrozenRowRef ref;
+    ref.segment = -1;
+    ref.offset = frozen_fill_buf_.size();
+    {
+        QDataStream out(&frozen_fill_buf_, QIODevice::WriteOnly | QIODevice::Append);
+        if (!record->freeze(out)) {
+            return;
+        }
+    }
+    ref.length = frozen_fill_buf_.size() - ref.offset;
+    frozen_rows_.insert(fdata, ref);
+    frozen_fill_rows_ << fdata;
+
+    if (frozen_fill_buf_.size() >= frozen_segment_bytes_) {
+        sealFrozenFillBuf();
+    }
+}
+
+// Refill a fresh record from the cold tier. Returns false if the row
+// was never frozen (or its segment has been retired), in which case
+// the record dissects on first use as usual.
+bool PacketListModel::thawRecord(frame_data *fdata, PacketListRecord *record) const
+{
+    if (frozen_data_ver_ != PacketListRecord::columnDataVersion()) {
+        dropFrozenRows();
+        return false;
+    }
+
+    QHash<frame_data *, FrozenRowRef>::const_iterator it = frozen_rows_.constFind(fdata);
+    if (it == frozen_rows_.constEnd()) {
+        return false;
+    }
+
+    FrozenRowRef ref = it.value();
+    const QByteArray *buf = &frozen_fill_buf_;
+    if (ref.segment >= 0) {
+        if (ref.segment != thawed_segment_) {
+            thawed_buf_ = qUncompress(frozen_segments_.at(ref.segment - first_frozen_segment_));
+            thawed_segment_ = ref.segment;
+        }
+        buf = &thawed_buf_;
+    }
+
+    QDataStream in(QByteArray::fromRawData(buf->constData() + ref.offset, ref.length));
+    record->thaw(in);
+    return true;
+}
+
+void PacketListModel::sealFrozenFillBuf() const
+{
+    if (frozen_fill_buf_.isEmpty()) {
+        return;
+    }
+
+    if (frozen_segments_.count() >= max_frozen_segments_) {
+        // Retire the oldest segment rather than growing without bound.
+        // Only drop refs that still point into it; a row may have been
+        // re-frozen into a newer segment since.
+        foreach (frame_data *fdata, frozen_segment_rows_.first()) {
+            QHash<frame_data *, FrozenRowRef>::iterator it = frozen_rows_.find(fdata);
+            if (it != frozen_rows_.end() && it.value().segment == first_frozen_segment_) {
+                frozen_rows_.erase(it);
+            }
+        }
+        frozen_segments_.removeFirst();
+        frozen_segment_rows_.removeFirst();
+        if (thawed_segment_ == first_frozen_segment_) {
+            thawed_segment_ = -1;
+            thawed_buf_.clear();
+        }
+        first_frozen_segment_++;
+    }
+
+    int segment = first_frozen_segment_ + frozen_segments_.count();
+    frozen_segments_ << qCompress(frozen_fill_buf_);
+    frozen_segment_rows_ << frozen_fill_rows_;
+    foreach (frame_data *fdata, frozen_fill_rows_) {
+        QHash<frame_data *, FrozenRowRef>::iterator it = frozen_rows_.find(fdata);
+        if (it != frozen_rows_.end() && it.value().segment == -1) {
+            it.value().segment = segment;
+        }
+    }
+    frozen_fill_buf_.clear();
+    frozen_fill_rows_.clear();
+}
+
+void PacketListModel::dropFrozenRows() const
+{
+    frozen_rows_.clear();
+    frozen_segments_.clear();
+    frozen_segment_rows_.clear();
+    first_frozen_segment_ = 0;
+    frozen_fill_buf_.clear();
+    frozen_fill_rows_.clear();
+    thawed_segment_ = -1;
+    thawed_buf_.clear();
+    frozen_data_ver_ = PacketListRecord::columnDataVersion();
+}
+
 guint PacketListModel::recreateVisibleRows()
 {
     beginResetModel();
@@ -142,11 +342,9 @@ guint PacketListModel::recreateVisibleRows()
     number_to_row_.fill(0);
     endResetModel();
 
-    foreach (PacketListRecord *record, physical_rows_) {
-        frame_data *fdata = record->frameData();
-
+    foreach (frame_data *fdata, physical_rows_) {
         if (fdata->passed_dfilter || fdata->ref_time) {
-            visible_rows_ << record;
+            visible_rows_ << fdata;
             if (number_to_row_.size() <= (int)fdata->num) {
                 number_to_row_.resize(fdata->num + 10000);
             }
@@ -158,24 +356,36 @@ guint PacketListModel::recreateVisibleRows()
         endInsertRows();
     }
     idle_dissection_row_ = 0;
+    priority_first_ = 0;
+    priority_last_ = -1;
     return visible_rows_.count();
 }
 
 void PacketListModel::clear() {
     emit beginResetModel();
-    qDeleteAll(physical_rows_);
+    qDeleteAll(record_window_);
+    record_window_.clear();
+    record_window_anchor_ = 0;
+    dropFrozenRows();
+    // Also drops the interned column string pool.
+    PacketListRecord::invalidateAllRecords();
     physical_rows_.resize(0);
     visible_rows_.resize(0);
     new_visible_rows_.resize(0);
     number_to_row_.resize(0);
+    time_sorted_rows_.resize(0);
+    time_sorted_valid_ = true;
     emit endResetModel();
     max_row_height_ = 0;
     max_line_count_ = 1;
     idle_dissection_row_ = 0;
+    priority_first_ = 0;
+    priority_last_ = -1;
 }
 
 void PacketListModel::invalidateAllColumnStrings()
 {
+    dropFrozenRows();
     PacketListRecord::invalidateAllRecords();
     dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1),
             QVector<int>() << Qt::DisplayRole);
@@ -191,6 +401,45 @@ void PacketListModel::resetColumns()
     emit headerDataChanged(Qt::Horizontal, 0, columnCount() - 1);
 }
 
+// Timestamps (or the values derived from them, like cumulative bytes)
+// changed but the packet data didn't. Refresh the frame_data-based
+// columns in place instead of invalidating every record, which would
+// redissect each row from disk the next time it's painted.
+void PacketListModel::refreshFrameDataColumns()
+{
+    if (!cap_file_) return;
+
+    column_info *cinfo = &cap_file_->cinfo;
+
+    // Frozen rows can't be patched in place and their time columns are
+    // now stale, so drop them; this doesn't bump the data version, so
+    // the live records' dissected columns stay valid.
+    dropFrozenRows();
+
+    foreach (PacketListRecord *record, record_window_) {
+        record->refreshFrameDataColumns(cinfo);
+    }
+
+    for (int col = 0; col < cinfo->num_cols; col++) {
+        if (!col_based_on_frame_data(cinfo, col)) {
+            continue;
+        }
+        emit dataChanged(index(0, col), index(rowCount() - 1, col),
+                QVector<int>() << Qt::DisplayRole);
+    }
+}
+
+// The raw capture timestamps changed (a time shift), so the time-sorted
+// companion of physical_rows_ no longer is. Drop it; appendPacket stops
+// maintaining it and the next ascending sort on an absolute time column
+// rebuilds it from its result.
+void PacketListModel::invalidateTimeSortIndex()
+{
+    time_sorted_rows_.resize(0);
+    time_sorted_rows_.squeeze();
+    time_sorted_valid_ = false;
+}
+
 void PacketListModel::resetColorized()
 {
     PacketListRecord::resetColorization();
@@ -198,22 +447,54 @@ void PacketListModel::resetColorized()
             QVector<int>() << Qt::BackgroundRole << Qt::ForegroundRole);
 }
 
+// Invalidate the cached column text of a single row, including any
+// frozen copy of it, so the next paint recreates the text.  Cheaper
+// than bumping the global column data version when only some rows
+// changed.
+void PacketListModel::invalidateRowText(frame_data *fdata)
+{
+    PacketListRecord *record = record_window_.value(fdata);
+    if (record)
+        record->invalidateRecord();
+    frozen_rows_.remove(fdata);
+}
+
+// Emit dataChanged for a set of rows, coalescing contiguous rows into
+// one signal per run, so toggling a large selection doesn't queue one
+// viewport update per row.
+void PacketListModel::emitRowsChanged(QList<int> &rows, const QVector<int> &roles)
+{
+    if (rows.isEmpty())
+        return;
+
+    std::sort(rows.begin(), rows.end());
+    int section_max = columnCount() - 1;
+    int run_start = rows.first();
+    int prev = run_start;
+    for (int i = 1; i < rows.count(); i++) {
+        int row = rows.at(i);
+        if (row == prev || row == prev + 1) {
+            prev = row;
+            continue;
+        }
+        emit dataChanged(index(run_start, 0), index(prev, section_max), roles);
+        run_start = prev = row;
+    }
+    emit dataChanged(index(run_start, 0), index(prev, section_max), roles);
+}
+
 void PacketListModel::toggleFrameMark(const QModelIndexList &indeces)
 {
     if (!cap_file_ || indeces.count() <= 0)
         return;
 
-    int sectionMax = columnCount() - 1;
+    QList<int> rows;
 
     foreach (QModelIndex index, indeces) {
         if (! index.isValid())
             continue;
 
-        PacketListRecord *record = static_cast<PacketListRecord*>(index.internalPointer());
-        if (!record)
-            continue;
-
-        frame_data *fdata = record->frameData();
+        frame_data *fdata = getRowFdata(index);
         if (!fdata)
             continue;
 
@@ -222,22 +503,30 @@ void PacketListModel::toggleFrameMark(const QModelIndexList &indeces)
         else
             cf_mark_frame(cap_file_, fdata);
 
-        dataChanged(index.sibling(index.row(), 0), index.sibling(index.row(), sectionMax),
-                QVector<int>() << Qt::BackgroundRole << Qt::ForegroundRole);
+        // Custom columns can show frame.marked.
+        invalidateRowText(fdata);
+        rows << index.row();
     }
+
+    emitRowsChanged(rows, QVector<int>()
+            << Qt::BackgroundRole << Qt::ForegroundRole << Qt::DisplayRole);
 }
 
 void PacketListModel::setDisplayedFrameMark(gboolean set)
 {
-    foreach (PacketListRecord *record, visible_rows_) {
+    foreach (frame_data *fdata, visible_rows_) {
         if (set) {
-            cf_mark_frame(cap_file_, record->frameData());
+            cf_mark_frame(cap_file_, fdata);
         } else {
-            cf_unmark_frame(cap_file_, record->frameData());
+            cf_unmark_frame(cap_file_, fdata);
         }
     }
+    // Every displayed row changed; drop the cached text wholesale
+    // instead of row by row.
+    dropFrozenRows();
+    PacketListRecord::invalidateAllRecords();
     emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1),
-            QVector<int>() << Qt::BackgroundRole << Qt::ForegroundRole);
+            QVector<int>() << Qt::BackgroundRole << Qt::ForegroundRole << Qt::DisplayRole);
 }
 
 void PacketListModel::toggleFrameIgnore(const QModelIndexList &indeces)
@@ -245,17 +534,13 @@ void PacketListModel::toggleFrameIgnore(const QModelIndexList &indeces)
     if (!cap_file_ || indeces.count() <= 0)
         return;
 
-    int sectionMax = columnCount() - 1;
+    QList<int> rows;
 
     foreach (QModelIndex index, indeces) {
         if (! index.isValid())
             continue;
 
-        PacketListRecord *record = static_cast<PacketListRecord*>(index.internalPointer());
-        if (!record)
-            continue;
-
-        frame_data *fdata = record->frameData();
+        frame_data *fdata = getRowFdata(index);
         if (!fdata)
             continue;
 
@@ -264,20 +549,27 @@ void PacketListModel::toggleFrameIgnore(const QModelIndexList &indeces)
         else
             cf_ignore_frame(cap_file_, fdata);
 
-        dataChanged(index.sibling(index.row(), 0), index.sibling(index.row(), sectionMax),
-                QVector<int>() << Qt::BackgroundRole << Qt::ForegroundRole << Qt::DisplayRole);
+        invalidateRowText(fdata);
+        rows << index.row();
     }
+
+    emitRowsChanged(rows, QVector<int>()
+            << Qt::BackgroundRole << Qt::ForegroundRole << Qt::DisplayRole);
 }
 
 void PacketListModel::setDisplayedFrameIgnore(gboolean set)
 {
-    foreach (PacketListRecord *record, visible_rows_) {
+    foreach (frame_data *fdata, visible_rows_) {
         if (set) {
-            cf_ignore_frame(cap_file_, record->frameData());
+            cf_ignore_frame(cap_file_, fdata);
         } else {
-            cf_unignore_frame(cap_file_, record->frameData());
+            cf_unignore_frame(cap_file_, fdata);
         }
     }
+    // Every displayed row changed; drop the cached text wholesale
+    // instead of row by row.
+    dropFrozenRows();
+    PacketListRecord::invalidateAllRecords();
     emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1),
             QVector<int>() << Qt::BackgroundRole << Qt::ForegroundRole << Qt::DisplayRole);
 }
@@ -286,10 +578,7 @@ void PacketListModel::toggleFrameRefTime(const QModelIndex &rt_index)
 {
     if (!cap_file_ || !rt_index.isValid()) return;
 
-    PacketListRecord *record = static_cast<PacketListRecord*>(rt_index.internalPointer());
-    if (!record) return;
-
-    frame_data *fdata = record->frameData();
+    frame_data *fdata = getRowFdata(rt_index);
     if (!fdata) return;
 
     if (fdata->ref_time) {
@@ -299,12 +588,12 @@ void PacketListModel::toggleFrameRefTime(const QModelIndex &rt_index)
         fdata->ref_time=1;
         cap_file_->ref_time_count++;
     }
+    session_journal_record_timeref(cap_file_, fdata->num, fdata->ref_time);
     cf_reftime_packets(cap_file_);
     if (!fdata->ref_time && !fdata->passed_dfilter) {
         cap_file_->displayed_count--;
     }
-    record->resetColumns(&cap_file_->cinfo);
-    emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+    refreshFrameDataColumns();
 }
 
 void PacketListModel::unsetAllFrameRefTime()
@@ -313,16 +602,15 @@ void PacketListModel::unsetAllFrameRefTime()
 
     /* XXX: we might need a progressbar here */
 
-    foreach (PacketListRecord *record, physical_rows_) {
-        frame_data *fdata = record->frameData();
+    foreach (frame_data *fdata, physical_rows_) {
         if (fdata->ref_time) {
             fdata->ref_time = 0;
         }
     }
     cap_file_->ref_time_count = 0;
+    session_journal_record_timeref_clear(cap_file_);
     cf_reftime_packets(cap_file_);
-    PacketListRecord::resetColumns(&cap_file_->cinfo);
-    emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+    refreshFrameDataColumns();
 }
 
 void PacketListModel::setMaximumRowHeight(int height)
@@ -342,6 +630,28 @@ capture_file *PacketListModel::sort_cap_file_;
 
 QElapsedTimer busy_timer_;
 const int busy_timeout_ = 65; // ms, approximately 15 fps
+
+// Sort column strings, keyed by frame. Materialized for the duration of
+// a text-column sort and discarded as soon as the rows are in order, so
+// sorting doesn't pin a string per row for the life of the capture.
+static QHash<frame_data *, QString> sort_column_text_;
+
+// Sorts a snapshot of the physical rows off the main thread. The comparator
+// only reads sort_column_text_ and frame data, so the main thread can
+// keep painting the old order while we work.
+class PacketListSortThread : public QThread
+{
+public:
+    explicit PacketListSortThread(QVector<frame_data *> *rows) :
+        rows_(rows) {}
+protected:
+    void run() {
+        std::sort(rows_->begin(), rows_->end(), PacketListModel::recordLessThan);
+    }
+private:
+    QVector<frame_data *> *rows_;
+};
+
 void PacketListModel::sort(int column, Qt::SortOrder order)
 {
     if (!cap_file_ || visible_rows_.count() < 1) return;
@@ -361,18 +671,91 @@ void PacketListModel::sort(int column, Qt::SortOrder order)
         wsApp->pushStatus(WiresharkApplication::BusyStatus, busy_msg);
     }
 
-    busy_timer_.start();
-    sort_column_is_numeric_ = isNumericColumn(sort_column_);
-    std::sort(physical_rows_.begin(), physical_rows_.end(), recordLessThan);
+    // A column that orders purely by the raw capture timestamp can reuse
+    // the time-sorted companion of physical_rows_ maintained during
+    // append: the "sort" is then just a copy (or reversed copy) of that
+    // vector, with no string materialization and no comparison sort.
+    // Time references sort above everything else, so any of those forces
+    // the general path.
+    bool use_time_index = time_sorted_valid_ &&
+            time_sorted_rows_.count() == physical_rows_.count() &&
+            cap_file_->ref_time_count == 0 &&
+            isPureTimeColumn(column);
+
+    if (use_time_index) {
+        if (order == Qt::AscendingOrder) {
+            physical_rows_ = time_sorted_rows_;
+        } else {
+            physical_rows_.resize(0);
+            for (int i = time_sorted_rows_.count() - 1; i >= 0; i--) {
+                physical_rows_ << time_sorted_rows_.at(i);
+            }
+        }
+    } else {
+        busy_timer_.start();
+        sort_column_is_numeric_ = isNumericColumn(sort_column_);
+
+        // Sorting is done in two phases. First materialize every row's sort
+        // column string into sort_column_text_; this can dissect records,
+        // which must happen on the main thread. Rows outside the record
+        // window go through a throwaway record, so only the strings survive
+        // this loop - and those are interned, so repeated values share one
+        // copy. Pump events now and then so the busy indicator keeps
+        // painting.
+        if (text_sort_column_ >= 0) {
+            sort_column_text_.reserve(physical_rows_.count());
+            foreach (frame_data *fdata, physical_rows_) {
+                PacketListRecord *record = record_window_.value(fdata);
+                if (record) {
+                    sort_column_text_[fdata] = record->columnString(sort_cap_file_, sort_column_);
+                } else {
+                    // Thaw frozen rows into the scratch record; rows that
+                    // were never materialized dissect as before.
+                    PacketListRecord scratch(fdata);
+                    thawRecord(fdata, &scratch);
+                    sort_column_text_[fdata] = scratch.columnString(sort_cap_file_, sort_column_);
+                }
+                if (busy_timer_.elapsed() > busy_timeout_) {
+                    // What's the least amount of processing that we can do which will draw
+                    // the busy indicator?
+                    wsApp->processEvents(QEventLoop::ExcludeUserInputEvents | QEventLoop::ExcludeSocketNotifiers, 1);
+                    busy_timer_.restart();
+                }
+            }
+        }
+
+        // Now sort a snapshot on a worker thread. The view keeps displaying
+        // the old order (visible_rows_ is untouched) until the snapshot swaps
+        // in below. Wait without pumping events: even with user input
+        // excluded, paint and idle-dissection timer events lazily dissect
+        // rows and rewrite their cached column strings, which would race
+        // with the comparator reading them on the worker.
+        QVector<frame_data *> sorted_rows = physical_rows_;
+        sorted_rows.data();   // Detach from physical_rows_ on this thread.
+        PacketListSortThread sort_thread(&sorted_rows);
+        sort_thread.start();
+        sort_thread.wait();
+        physical_rows_ = sorted_rows;
+
+        sort_column_text_.clear();
+        sort_column_text_.squeeze();
+
+        if (!time_sorted_valid_ && order == Qt::AscendingOrder &&
+            cap_file_->ref_time_count == 0 && isPureTimeColumn(column)) {
+            // The rows just ended up in exactly the order the dropped
+            // companion index would hold (timestamp, then frame number),
+            // so rebuild it from the result and resume maintaining it.
+            time_sorted_rows_ = physical_rows_;
+            time_sorted_valid_ = true;
+        }
+    }
 
     emit beginResetModel();
     visible_rows_.resize(0);
     number_to_row_.fill(0);
-    foreach (PacketListRecord *record, physical_rows_) {
-        frame_data *fdata = record->frameData();
-
+    foreach (frame_data *fdata, physical_rows_) {
         if (fdata->passed_dfilter || fdata->ref_time) {
-            visible_rows_ << record;
+            visible_rows_ << fdata;
             if (number_to_row_.size() <= (int)fdata->num) {
                 number_to_row_.resize(fdata->num + 10000);
             }
@@ -457,7 +840,45 @@ bool PacketListModel::isNumericColumn(int column)
     return true;
 }
 
-bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
+// Columns whose sort order is exactly the raw capture timestamp, i.e.
+// the order time_sorted_rows_ maintains. The configurable time column
+// only qualifies in its absolute formats; the relative and delta formats
+// compare through reference and previous frames instead (see
+// frame_data_compare).
+bool PacketListModel::isPureTimeColumn(int column)
+{
+    if (column < 0) {
+        return false;
+    }
+    switch (cap_file_->cinfo.columns[column].col_fmt) {
+    case COL_ABS_YMD_TIME:   /**< 1) Absolute date, as YYYY-MM-DD, and time */
+    case COL_ABS_YDOY_TIME:  /**< 2) Absolute date, as YYYY/DOY, and time */
+    case COL_ABS_TIME:       /**< 3) Absolute time */
+    case COL_UTC_YMD_TIME:   /**< 46) UTC date, as YYYY-MM-DD, and time */
+    case COL_UTC_YDOY_TIME:  /**< 47) UTC date, as YYYY/DOY, and time */
+    case COL_UTC_TIME:       /**< 48) UTC time */
+        return true;
+
+    case COL_CLS_TIME:       /**< 6) Command line-specified time */
+        switch (timestamp_get_type()) {
+        case TS_ABSOLUTE:
+        case TS_ABSOLUTE_WITH_YMD:
+        case TS_ABSOLUTE_WITH_YDOY:
+        case TS_UTC:
+        case TS_UTC_WITH_YMD:
+        case TS_UTC_WITH_YDOY:
+        case TS_EPOCH:
+            return true;
+        default:
+            return false;
+        }
+
+    default:
+        return false;
+    }
+}
+
+bool PacketListModel::recordLessThan(frame_data *r1, frame_data *r2)
 {
     int cmp_val = 0;
 
@@ -465,28 +886,27 @@ bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
     // _packet_list_compare_records, and packet_list_compare_custom from
     // gtk/packet_list_store.c into one function
 
-    if (busy_timer_.elapsed() > busy_timeout_) {
-        // What's the least amount of processing that we can do which will draw
-        // the busy indicator?
-        wsApp->processEvents(QEventLoop::ExcludeUserInputEvents | QEventLoop::ExcludeSocketNotifiers, 1);
-        busy_timer_.restart();
-    }
+    // This can run on the sort worker thread, so it must only touch the
+    // column strings materialized by sort() and read-only frame data.
     if (sort_column_ < 0) {
         // No column.
-        cmp_val = frame_data_compare(sort_cap_file_->epan, r1->frameData(), r2->frameData(), COL_NUMBER);
+        cmp_val = frame_data_compare(sort_cap_file_->epan, r1, r2, COL_NUMBER);
     } else if (text_sort_column_ < 0) {
         // Column comes directly from frame data
-        cmp_val = frame_data_compare(sort_cap_file_->epan, r1->frameData(), r2->frameData(), sort_cap_file_->cinfo.columns[sort_column_].col_fmt);
+        cmp_val = frame_data_compare(sort_cap_file_->epan, r1, r2, sort_cap_file_->cinfo.columns[sort_column_].col_fmt);
     } else  {
-        if (r1->columnString(sort_cap_file_, sort_column_).constData() == r2->columnString(sort_cap_file_, sort_column_).constData()) {
+        const QString str_r1 = sort_column_text_.value(r1);
+        const QString str_r2 = sort_column_text_.value(r2);
+
+        if (str_r1.constData() == str_r2.constData()) {
             cmp_val = 0;
         } else if (sort_column_is_numeric_) {
             // Custom column with numeric data (or something like a port number).
             // Attempt to convert to numbers.
             // XXX This is slow. Can we avoid doing this?
             bool ok_r1, ok_r2;
-            double num_r1 = parseNumericColumn(r1->columnString(sort_cap_file_, sort_column_), &ok_r1);
-            double num_r2 = parseNumericColumn(r2->columnString(sort_cap_file_, sort_column_), &ok_r2);
+            double num_r1 = parseNumericColumn(str_r1, &ok_r1);
+            double num_r2 = parseNumericColumn(str_r2, &ok_r2);
 
             if (!ok_r1 && !ok_r2) {
                 cmp_val = 0;
@@ -498,12 +918,12 @@ bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
                 cmp_val = 1;
             }
         } else {
-            cmp_val = r1->columnString(sort_cap_file_, sort_column_).compare(r2->columnString(sort_cap_file_, sort_column_));
+            cmp_val = str_r1.compare(str_r2);
         }
 
         if (cmp_val == 0) {
             // All else being equal, compare column numbers.
-            cmp_val = frame_data_compare(sort_cap_file_->epan, r1->frameData(), r2->frameData(), COL_NUMBER);
+            cmp_val = frame_data_compare(sort_cap_file_->epan, r1, r2, COL_NUMBER);
         }
     }
 
@@ -532,7 +952,10 @@ void PacketListModel::emitItemHeightChanged(const QModelIndex &ih_index)
 {
     if (!ih_index.isValid()) return;
 
-    PacketListRecord *record = static_cast<PacketListRecord*>(ih_index.internalPointer());
+    // This is a queued slot; look the record up by row rather than
+    // trusting the index's internal pointer, which may have been evicted
+    // from the window in the meantime.
+    PacketListRecord *record = recordFor(ih_index.row());
     if (!record) return;
 
     if (record->lineCount() > max_line_count_) {
@@ -556,7 +979,9 @@ QVariant PacketListModel::data(const QModelIndex &d_index, int role) const
     if (!d_index.isValid())
         return QVariant();
 
-    PacketListRecord *record = static_cast<PacketListRecord*>(d_index.internalPointer());
+    // Look the record up by row; d_index may be a persistent index whose
+    // internal pointer was evicted from the window since it was created.
+    PacketListRecord *record = recordFor(d_index.row());
     if (!record)
         return QVariant();
     const frame_data *fdata = record->frameData();
@@ -656,23 +1081,35 @@ QVariant PacketListModel::headerData(int section, Qt::Orientation orientation,
     return QVariant();
 }
 
+// During a live capture cf_continue_tail pokes us once per read chunk,
+// which can be much more often than the display refreshes. Ingest the
+// staged rows in fixed-size batches on a refresh-rate cadence so each
+// display frame sees at most one (coalesced) insertion.
+static const int flush_interval_ = 16;      // Milliseconds, ~60fps.
+static const int max_flush_rows_ = 10000;   // Rows per batch.
+
 void PacketListModel::flushVisibleRows()
 {
     gint pos = visible_rows_.count();
+    int flush_count = qMin(static_cast<int>(new_visible_rows_.count()), max_flush_rows_);
 
-    if (new_visible_rows_.count() > 0) {
-        emit beginInsertRows(QModelIndex(), pos, pos + new_visible_rows_.count());
-        foreach (PacketListRecord *record, new_visible_rows_) {
-            frame_data *fdata = record->frameData();
-
-            visible_rows_ << record;
+    if (flush_count > 0) {
+        emit beginInsertRows(QModelIndex(), pos, pos + flush_count - 1);
+        for (int row = 0; row < flush_count; row++) {
+            frame_data *fdata = new_visible_rows_.at(row);
+            visible_rows_ << fdata;
             if (number_to_row_.size() <= (int)fdata->num) {
                 number_to_row_.resize(fdata->num + 10000);
             }
             number_to_row_[fdata->num] = visible_rows_.count();
         }
         emit endInsertRows();
-        new_visible_rows_.resize(0);
+        new_visible_rows_.remove(0, flush_count);
+        if (new_visible_rows_.count() > 0) {
+            // More rows than one batch should carry; keep draining at
+            // the same cadence.
+            QTimer::singleShot(flush_interval_, this, SLOT(flushVisibleRows()));
+        }
     }
 }
 
@@ -690,29 +1127,75 @@ void PacketListModel::dissectIdle(bool reset)
 
     idle_dissection_timer_->restart();
 
+    // Serve the rows the view has asked for first (the viewport and the
+    // minimap overlay range), then fall back to the linear sweep.
+    // Already-colorized rows cost only a flag check, so re-prioritizing
+    // the same range as the user scrolls is cheap.
+    int colorized_count = 0;
+    while (idle_dissection_timer_->elapsed() < idle_dissection_interval_
+           && priority_first_ <= priority_last_) {
+        if (ensureRowColorized(priority_first_))
+            colorized_count++;
+        priority_first_++;
+    }
+
     int first = idle_dissection_row_;
     while (idle_dissection_timer_->elapsed() < idle_dissection_interval_
            && idle_dissection_row_ < physical_rows_.count()) {
-        ensureRowColorized(idle_dissection_row_);
+        if (ensureRowColorized(idle_dissection_row_))
+            colorized_count++;
         idle_dissection_row_++;
 //        if (idle_dissection_row_ % 1000 == 0) qDebug() << "=di row" << idle_dissection_row_;
     }
 
-    if (idle_dissection_row_ < physical_rows_.count()) {
+    if (idle_dissection_row_ < physical_rows_.count() ||
+        priority_first_ <= priority_last_) {
         QTimer::singleShot(idle_dissection_interval_, this, SLOT(dissectIdle()));
     } else {
         idle_dissection_timer_->invalidate();
     }
 
-    // report colorization progress
-    emit bgColorizationProgress(first+1, idle_dissection_row_+1);
+    // Report colorization progress, but only when a row actually got a
+    // color; otherwise a view prioritizing an already-colorized range
+    // (e.g. the minimap redrawing) would ping-pong with the sweep.
+    if (colorized_count > 0)
+        emit bgColorizationProgress(first+1, idle_dissection_row_+1);
+}
+
+void PacketListModel::prioritizeColorization(int first, int last)
+{
+    if (first < 0 || last < first)
+        return;
+
+    priority_first_ = first;
+    priority_last_ = qMin(last, static_cast<int>(visible_rows_.count()) - 1);
+    if (priority_first_ > priority_last_)
+        return;
+
+    if (!idle_dissection_timer_->isValid()) {
+        // The linear sweep has finished (or never ran, e.g. after
+        // resetColorized()); wake it up to service this range.
+        idle_dissection_timer_->restart();
+        QTimer::singleShot(0, this, SLOT(dissectIdle()));
+    }
+}
+
+// Strict ordering by raw capture timestamp with the frame number as tie
+// break; matches frame_data_compare on the absolute time columns when no
+// time references are set.
+static bool frameTimeLessThan(const frame_data *f1, const frame_data *f2)
+{
+    int cmp = nstime_cmp(&f1->abs_ts, &f2->abs_ts);
+    if (cmp != 0) {
+        return cmp < 0;
+    }
+    return f1->num < f2->num;
 }
 
 // XXX Pass in cinfo from packet_list_append so that we can fill in
 // line counts?
 gint PacketListModel::appendPacket(frame_data *fdata)
 {
-    PacketListRecord *record = new PacketListRecord(fdata);
     gint pos = -1;
 
 #ifdef DEBUG_PACKET_LIST_MODEL
@@ -721,14 +1204,34 @@ gint PacketListModel::appendPacket(frame_data *fdata)
     }
 #endif
 
-    physical_rows_ << record;
+    WS_TRACEPOINT1(packet_list_insert, fdata->num);
+    pipeline_stats_record(PIPELINE_STAGE_DISPLAY, 1);
+
+    physical_rows_ << fdata;
+
+    if (time_sorted_valid_) {
+        // Keep the time-sorted companion current. Packets almost always
+        // arrive in time order, so this is normally a plain append; a
+        // straggler from another interface binary-inserts into place.
+        if (time_sorted_rows_.isEmpty() ||
+            !frameTimeLessThan(fdata, time_sorted_rows_.last())) {
+            time_sorted_rows_ << fdata;
+        } else {
+            time_sorted_rows_.insert(
+                    std::upper_bound(time_sorted_rows_.begin(),
+                                     time_sorted_rows_.end(),
+                                     fdata, frameTimeLessThan),
+                    fdata);
+        }
+    }
 
     if (fdata->passed_dfilter || fdata->ref_time) {
-        new_visible_rows_ << record;
+        new_visible_rows_ << fdata;
         if (new_visible_rows_.count() < 2) {
             // This is the first queued packet. Schedule an insertion for
-            // the next UI update.
-            QTimer::singleShot(0, this, SLOT(flushVisibleRows()));
+            // the next display frame; everything staged by then lands in
+            // one batch.
+            QTimer::singleShot(flush_interval_, this, SLOT(flushVisibleRows()));
         }
         pos = visible_rows_.count() + new_visible_rows_.count() - 1;
     }
@@ -746,33 +1249,22 @@ frame_data *PacketListModel::getRowFdata(QModelIndex idx)
 frame_data *PacketListModel::getRowFdata(int row) {
     if (row < 0 || row >= visible_rows_.count())
         return NULL;
-    PacketListRecord *record = visible_rows_[row];
-    if (!record)
-        return NULL;
-    return record->frameData();
+    return visible_rows_[row];
 }
 
-void PacketListModel::ensureRowColorized(int row)
+bool PacketListModel::ensureRowColorized(int row)
 {
-    if (row < 0 || row >= visible_rows_.count())
-        return;
-    PacketListRecord *record = visible_rows_[row];
+    PacketListRecord *record = recordFor(row);
     if (!record)
-        return;
+        return false;
     if (!record->colorized()) {
         record->ensureColorized(cap_file_);
+        return true;
     }
+    return false;
 }
 
 int PacketListModel::visibleIndexOf(frame_data *fdata) const
 {
-    int row = 0;
-    foreach (PacketListRecord *record, visible_rows_) {
-        if (record->frameData() == fdata) {
-            return row;
-        }
-        row++;
-    }
-
-    return -1;
+    return visible_rows_.indexOf(fdata);
 }
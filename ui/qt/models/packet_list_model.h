@@ -20,6 +20,7 @@
 
 #include <QAbstractItemModel>
 #include <QFont>
+#include <QHash>
 #include <QVector>
 
 #include "packet_list_record.h"
@@ -50,7 +51,7 @@ public:
     gint appendPacket(frame_data *fdata);
     frame_data *getRowFdata(QModelIndex idx);
     frame_data *getRowFdata(int row);
-    void ensureRowColorized(int row);
+    bool ensureRowColorized(int row);
     int visibleIndexOf(frame_data *fdata) const;
     /**
      * @brief Invalidate any cached column strings.
@@ -60,6 +61,16 @@ public:
      * @brief Rebuild columns from settings.
      */
     void resetColumns();
+    /**
+     * @brief Recompute columns derived from frame_data (time, cumulative
+     * bytes, ...) without invalidating the dissected columns.
+     */
+    void refreshFrameDataColumns();
+    /**
+     * @brief Drop the time-sorted companion of the physical rows, e.g.
+     * after a time shift changed the raw timestamps underneath it.
+     */
+    void invalidateTimeSortIndex();
     void resetColorized();
     void toggleFrameMark(const QModelIndexList &indeces);
     void setDisplayedFrameMark(gboolean set);
@@ -81,15 +92,66 @@ public slots:
     void sort(int column, Qt::SortOrder order = Qt::AscendingOrder);
     void flushVisibleRows();
     void dissectIdle(bool reset = false);
+    void prioritizeColorization(int first, int last);
 
 private:
     capture_file *cap_file_;
     QList<QString> col_names_;
-    QVector<PacketListRecord *> physical_rows_;
-    QVector<PacketListRecord *> visible_rows_;
-    QVector<PacketListRecord *> new_visible_rows_;
+    QVector<frame_data *> physical_rows_;
+    QVector<frame_data *> visible_rows_;
+    QVector<frame_data *> new_visible_rows_;
     QVector<int> number_to_row_;
 
+    /** Companion copy of physical_rows_ kept in capture-timestamp order
+     * while packets are appended. Live multi-interface captures arrive
+     * mostly but not exactly in time order, so maintaining it costs one
+     * comparison per packet plus the occasional binary insertion, and a
+     * sort on an absolute time column becomes a copy of this vector
+     * instead of a full comparison sort. Invalid (and empty) after the
+     * timestamps themselves change; the next ascending time sort
+     * rebuilds it from its result. */
+    QVector<frame_data *> time_sorted_rows_;
+    bool time_sorted_valid_;
+
+    /** Materialized records for the rows around the viewport. Rows are
+     * plain frame_data pointers; a PacketListRecord (and its cached
+     * column strings) exists only for a sliding window of rows around
+     * the most recent access, so packet list memory stays constant
+     * regardless of the capture size. */
+    mutable QHash<frame_data *, PacketListRecord *> record_window_;
+    mutable int record_window_anchor_;
+    PacketListRecord *recordFor(int row) const;
+    void pruneRecordWindow(int center_row) const;
+
+    /** Cold tier under the record window. When a record is evicted its
+     * cached column strings are serialized into a fill buffer; full
+     * buffers are compressed into segments. A row scrolling back into
+     * view is thawed from here instead of being redissected from disk.
+     * The tier is bounded: once max_frozen_segments_ is reached the
+     * oldest segment is retired and its rows fall back to redissection.
+     */
+    struct FrozenRowRef {
+        int segment;        // Segment id, or -1 for the fill buffer.
+        int offset;         // Byte range in the (uncompressed) buffer.
+        int length;
+    };
+    mutable QHash<frame_data *, FrozenRowRef> frozen_rows_;
+    mutable QVector<QByteArray> frozen_segments_;           // qCompress()ed
+    mutable QVector<QVector<frame_data *> > frozen_segment_rows_;
+    mutable int first_frozen_segment_;  // Id of frozen_segments_.first().
+    mutable QByteArray frozen_fill_buf_;
+    mutable QVector<frame_data *> frozen_fill_rows_;
+    mutable unsigned frozen_data_ver_;  // Column data version of the tier.
+    mutable int thawed_segment_;        // Most recently decompressed segment.
+    mutable QByteArray thawed_buf_;
+    void freezeRecord(frame_data *fdata, PacketListRecord *record) const;
+    bool thawRecord(frame_data *fdata, PacketListRecord *record) const;
+    void sealFrozenFillBuf() const;
+    void dropFrozenRows() const;
+
+    void invalidateRowText(frame_data *fdata);
+    void emitRowsChanged(QList<int> &rows, const QVector<int> &roles);
+
     int max_row_height_; // px
     int max_line_count_;
 
@@ -98,15 +160,21 @@ private:
     static int text_sort_column_;
     static Qt::SortOrder sort_order_;
     static capture_file *sort_cap_file_;
-    static bool recordLessThan(PacketListRecord *r1, PacketListRecord *r2);
+    static bool recordLessThan(frame_data *r1, frame_data *r2);
+    friend class PacketListSortThread;
     static double parseNumericColumn(const QString &val, bool *ok);
 
     QElapsedTimer *idle_dissection_timer_;
     int idle_dissection_row_;
+    /** Row range the view wants colorized ahead of the linear sweep;
+     * empty when priority_first_ > priority_last_. */
+    int priority_first_;
+    int priority_last_;
 
     struct _GStringChunk *string_cache_pool_;
 
     bool isNumericColumn(int column);
+    bool isPureTimeColumn(int column);
 
 private slots:
     void emitItemHeightChanged(const QModelIndex &ih_index);
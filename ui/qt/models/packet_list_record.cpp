@@ -26,9 +26,14 @@
 #include <QStringList>
 
 QMap<int, int> PacketListRecord::cinfo_column_;
+QSet<QString> PacketListRecord::col_text_pool_;
 unsigned PacketListRecord::col_data_ver_ = 1;
 unsigned PacketListRecord::rows_color_ver_ = 1;
 
+// Don't bother interning long strings; they're almost always unique
+// (e.g. Info column detail) and would just bloat the pool.
+static const int max_interned_col_len_ = 64;
+
 PacketListRecord::PacketListRecord(frame_data *frameData) :
     fdata_(frameData),
     lines_(1),
@@ -90,6 +95,92 @@ const QString PacketListRecord::columnString(capture_file *cap_file, int column,
     return col_text_.at(column);
 }
 
+void PacketListRecord::refreshFrameDataColumns(column_info *cinfo)
+{
+    if (!cinfo || col_text_.isEmpty() || data_ver_ != col_data_ver_) {
+        // Nothing is cached, or the whole cache is already stale; the
+        // next columnString() call redissects and refills everything.
+        return;
+    }
+
+    for (int column = 0; column < cinfo->num_cols && column < col_text_.count(); ++column) {
+        if (!col_based_on_frame_data(cinfo, column)) {
+            continue;
+        }
+
+        col_fill_in_frame_data(fdata_, cinfo, column, FALSE);
+
+        QString col_str;
+        if (!get_column_resolved(column) && cinfo->col_expr.col_expr_val[column]) {
+            /* Use the unresolved value in col_expr_val */
+            col_str = QString(cinfo->col_expr.col_expr_val[column]);
+        } else {
+            col_str = QString(cinfo->columns[column].col_data);
+        }
+        col_text_[column] = internColumnString(col_str);
+    }
+}
+
+bool PacketListRecord::freeze(QDataStream &out) const
+{
+    if (col_text_.isEmpty() || data_ver_ != col_data_ver_) {
+        return false;
+    }
+
+    out << col_text_;
+    out << (qint32)lines_;
+    out << colorized_;
+    out << (quint32)color_ver_;
+    out << (quint32)conv_index_;
+    return true;
+}
+
+void PacketListRecord::thaw(QDataStream &in)
+{
+    QStringList cols;
+    qint32 lines;
+    quint32 color_ver, conv_index;
+
+    in >> cols;
+    in >> lines;
+    in >> colorized_;
+    in >> color_ver;
+    in >> conv_index;
+
+    col_text_.clear();
+    foreach (const QString &col_str, cols) {
+        // Re-intern so thawed rows share strings with live ones again.
+        col_text_ << internColumnString(col_str);
+    }
+    lines_ = lines;
+    line_count_changed_ = false;
+    color_ver_ = color_ver;
+    conv_index_ = conv_index;
+    data_ver_ = col_data_ver_;
+}
+
+void PacketListRecord::invalidateAllRecords()
+{
+    col_data_ver_++;
+    // The cached strings are about to be recreated; drop the pool so we
+    // don't keep stale values alive.
+    col_text_pool_.clear();
+}
+
+QString PacketListRecord::internColumnString(const QString &col_str)
+{
+    if (col_str.size() > max_interned_col_len_) {
+        return col_str;
+    }
+
+    QSet<QString>::const_iterator it = col_text_pool_.constFind(col_str);
+    if (it != col_text_pool_.constEnd()) {
+        return *it;
+    }
+    col_text_pool_.insert(col_str);
+    return col_str;
+}
+
 void PacketListRecord::resetColumns(column_info *cinfo)
 {
     invalidateAllRecords();
@@ -301,7 +392,7 @@ void PacketListRecord::cacheColumnStrings(column_info *cinfo)
             col_str = QString(cinfo->columns[column].col_data);
         }
 
-        col_text_ << col_str;
+        col_text_ << internColumnString(col_str);
         col_lines = col_str.count('\n');
         if (col_lines > lines_) {
             lines_ = col_lines;
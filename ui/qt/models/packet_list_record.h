@@ -20,7 +20,9 @@
 #include <epan/packet.h>
 
 #include <QByteArray>
+#include <QDataStream>
 #include <QList>
+#include <QSet>
 #include <QVariant>
 
 struct conversation;
@@ -36,14 +38,36 @@ public:
     void ensureColorized(capture_file *cap_file);
     // Return the string value for a column. Data is cached if possible.
     const QString columnString(capture_file *cap_file, int column, bool colorized = false);
+    // Return the cached string value for a column. Unlike columnString()
+    // this never dissects, so it's safe to call off the main thread for
+    // columns that a previous columnString() call has cached.
+    const QString cachedColumnString(int column) const { return col_text_.value(column); }
     frame_data *frameData() const { return fdata_; }
     // packet_list->col_to_text in gtk/packet_list_store.c
     static int textColumn(int column) { return cinfo_column_.value(column, -1); }
     bool colorized() { return colorized_; }
     unsigned int conversation() { return conv_index_; }
 
+    // Recompute the cached strings for columns that are derived from
+    // frame_data (number, time, length, cumulative bytes) without
+    // redissecting the packet. Use this when timestamps change but the
+    // packet data doesn't, e.g. after a time shift.
+    void refreshFrameDataColumns(column_info *cinfo);
+
+    // Serialize the cached column strings and display state to a stream
+    // so an evicted record can be kept in the model's cold row store.
+    // Returns false (writing nothing) if there's nothing valid to keep.
+    bool freeze(QDataStream &out) const;
+    // Restore state written by freeze(). The caller is responsible for
+    // making sure the frozen data matches the current column data version.
+    void thaw(QDataStream &in);
+
     int columnTextSize(const char *str);
-    static void invalidateAllRecords() { col_data_ver_++; }
+    // Drop this record's cached column strings without touching the
+    // global column data version.
+    void invalidateRecord() { data_ver_ = 0; }
+    static void invalidateAllRecords();
+    static unsigned columnDataVersion() { return col_data_ver_; }
     static void resetColumns(column_info *cinfo);
     static void resetColorization() { rows_color_ver_++; }
 
@@ -54,6 +78,12 @@ private:
     /** The column text for some columns */
     QStringList col_text_;
 
+    /** Pool of interned column strings. Most column values (protocols,
+     * addresses, ports) repeat across many rows; thanks to QString's
+     * implicit sharing, rows with equal values can all share one copy. */
+    static QSet<QString> col_text_pool_;
+    static QString internColumnString(const QString &col_str);
+
     frame_data *fdata_;
     int lines_;
     bool line_count_changed_;
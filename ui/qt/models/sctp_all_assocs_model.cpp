@@ -0,0 +1,93 @@
+/*
+ * sctp_all_assocs_model.cpp
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <ui/qt/models/sctp_all_assocs_model.h>
+
+SCTPAllAssocsModel::SCTPAllAssocsModel(QObject *parent)
+    :QAbstractTableModel(parent)
+{
+}
+
+int SCTPAllAssocsModel::rowCount(const QModelIndex &) const
+{
+    return assocs_.count();
+}
+
+int SCTPAllAssocsModel::columnCount(const QModelIndex &) const
+{
+    return COL_BYTES + 1;
+}
+
+QVariant SCTPAllAssocsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= assocs_.count())
+        return QVariant();
+
+    const sctp_assoc_info_t *assoc = assocs_.at(index.row());
+    if (!assoc)
+        return QVariant();
+
+    // Return numbers, not strings, so a sort proxy orders rows numerically.
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+            case COL_ID:
+                return QVariant::fromValue(assoc->assoc_id);
+            case COL_PORT1:
+                return QVariant::fromValue(assoc->port1);
+            case COL_PORT2:
+                return QVariant::fromValue(assoc->port2);
+            case COL_PACKETS:
+                return QVariant::fromValue(assoc->n_packets);
+            case COL_DATA_CHUNKS:
+                return QVariant::fromValue(assoc->n_data_chunks);
+            case COL_BYTES:
+                return QVariant::fromValue(assoc->n_data_bytes);
+            default:
+                return QVariant();
+        }
+    }
+
+    return QVariant();
+}
+
+QVariant SCTPAllAssocsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    if (orientation == Qt::Horizontal) {
+        switch (section) {
+            case COL_ID:
+                return QString(tr("ID"));
+            case COL_PORT1:
+                return QString(tr("Port 1"));
+            case COL_PORT2:
+                return QString(tr("Port 2"));
+            case COL_PACKETS:
+                return QString(tr("Number of Packets"));
+            case COL_DATA_CHUNKS:
+                return QString(tr("Number of DATA Chunks"));
+            case COL_BYTES:
+                return QString(tr("Number of Bytes"));
+        }
+    }
+
+    return QVariant();
+}
+
+void SCTPAllAssocsModel::setAssocList(GList *assoc_list)
+{
+    beginResetModel();
+    assocs_.clear();
+    for (GList *list = g_list_first(assoc_list); list; list = g_list_next(list)) {
+        assocs_.append((const sctp_assoc_info_t *)list->data);
+    }
+    endResetModel();
+}
@@ -0,0 +1,47 @@
+/*
+ * sctp_all_assocs_model.h
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef SCTP_ALL_ASSOCS_MODEL_H
+#define SCTP_ALL_ASSOCS_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+#include <ui/tap-sctp-analysis.h>
+
+// A thin read-only view over the SCTP tap's association list. Rows are
+// rendered on demand, so large captures don't pay for item widgets.
+class SCTPAllAssocsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    SCTPAllAssocsModel(QObject *parent = 0);
+
+    enum {
+        COL_ID,
+        COL_PORT1,
+        COL_PORT2,
+        COL_PACKETS,
+        COL_DATA_CHUNKS,
+        COL_BYTES
+    };
+
+    virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    virtual int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+    void setAssocList(GList *assoc_list);
+
+private:
+    QVector<const sctp_assoc_info_t *> assocs_;
+};
+
+#endif // SCTP_ALL_ASSOCS_MODEL_H
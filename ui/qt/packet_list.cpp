@@ -44,6 +44,7 @@
 
 #include <ui/qt/utils/color_utils.h>
 #include <ui/qt/widgets/overlay_scroll_bar.h>
+#include <ui/qt/widgets/packet_timeline.h>
 #include "proto_tree.h"
 #include <ui/qt/utils/qt_ui_utils.h>
 #include "wireshark_application.h"
@@ -265,6 +266,10 @@ PacketList::PacketList(QWidget *parent) :
     overlay_sb_ = new OverlayScrollBar(Qt::Vertical, this);
     setVerticalScrollBar(overlay_sb_);
 
+    timeline_ = new PacketTimeline(this);
+    timeline_->hide();
+    connect(timeline_, SIGNAL(goToPacket(int)), this, SLOT(goToPacket(int)));
+
     header()->setSortIndicator(-1, Qt::AscendingOrder);
 
     packet_list_model_ = new PacketListModel(this, cap_file_);
@@ -275,6 +280,7 @@ PacketList::PacketList(QWidget *parent) :
 
     connect(packet_list_model_, SIGNAL(goToPacket(int)), this, SLOT(goToPacket(int)));
     connect(packet_list_model_, SIGNAL(itemHeightChanged(const QModelIndex&)), this, SLOT(updateRowHeights(const QModelIndex&)));
+    connect(packet_list_model_, SIGNAL(bgColorizationProgress(int,int)), this, SLOT(rowsColorized(int,int)));
     connect(wsApp, SIGNAL(addressResolutionChanged()), this, SLOT(redrawVisiblePacketsDontSelectCurrent()));
     connect(wsApp, SIGNAL(columnDataChanged()), this, SLOT(redrawVisiblePacketsDontSelectCurrent()));
 
@@ -545,6 +551,9 @@ void PacketList::selectionChanged (const QItemSelection & selected, const QItemS
 
     related_packet_delegate_.clear();
 
+    // Redraw the timeline's current-packet marker.
+    if (timeline_->isVisibleTo(this)) timeline_->update();
+
     // The previous dissection state has been invalidated by cf_select_packet
     // above, receivers must clear the previous state and apply the updated one.
     emit framesSelected(QList<int>() << row);
@@ -663,7 +672,19 @@ void PacketList::contextMenuEvent(QContextMenuEvent *event)
     }
 
     bool have_filter_expr = !selectedfilter.isEmpty();
-    ctx_menu->addMenu(FilterAction::createFilterMenu(FilterAction::ActionApply, selectedfilter, have_filter_expr, ctx_menu));
+    QMenu *apply_menu = FilterAction::createFilterMenu(FilterAction::ActionApply, selectedfilter, have_filter_expr, ctx_menu);
+
+    // If the filter result cache or the sidecar field postings can tell
+    // us how many frames this filter would display, preview the count in
+    // the menu title; applying it then replays the cached bitmap instead
+    // of rescanning.
+    guint32 preview_matches;
+    if (have_filter_expr && cap_file_ &&
+        cf_filter_preview_count(cap_file_, selectedfilter.toUtf8().constData(), &preview_matches)) {
+        apply_menu->setTitle(tr("%1 (%2 displayed)").arg(apply_menu->title()).arg(preview_matches));
+    }
+
+    ctx_menu->addMenu(apply_menu);
     ctx_menu->addMenu(FilterAction::createFilterMenu(FilterAction::ActionPrepare, selectedfilter, have_filter_expr, ctx_menu));
 
     const char *conv_menu_name = "menuConversationFilter";
@@ -727,6 +748,11 @@ void PacketList::contextMenuEvent(QContextMenuEvent *event)
     action = ctx_menu->addAction(tr("Decode As…"));
     action->setProperty("create_new", QVariant(true));
     connect(action, &QAction::triggered, this, &PacketList::ctxDecodeAsDialog);
+    if (frameData) {
+        action = ctx_menu->addAction(tr("Redissect Up to This Packet"));
+        action->setData(QVariant(frameData->frameNum()));
+        connect(action, &QAction::triggered, this, &PacketList::ctxRedissectToFrame);
+    }
     // "Print" not ported intentionally
     action = window()->findChild<QAction *>("actionViewShowPacketInNewWindow");
     ctx_menu->addAction(action);
@@ -755,6 +781,15 @@ void PacketList::ctxDecodeAsDialog()
     da_dialog->show();
 }
 
+void PacketList::ctxRedissectToFrame()
+{
+    QAction *rd_action = qobject_cast<QAction*>(sender());
+    if (! rd_action || ! cap_file_)
+        return;
+
+    cf_redissect_to_frame(cap_file_, rd_action->data().toUInt());
+}
+
 // Auto scroll if:
 // - We're not at the end
 // - We are capturing
@@ -940,6 +975,23 @@ void PacketList::resizeEvent(QResizeEvent *event)
     QTreeView::resizeEvent(event);
 }
 
+// Reserve a strip below the viewport for the timeline minimap when it
+// has something to show.
+void PacketList::updateGeometries()
+{
+    QTreeView::updateGeometries();
+
+    int timeline_h = timeline_->isVisibleTo(this) ? timeline_->sizeHint().height() : 0;
+    QMargins margins = viewportMargins();
+    if (margins.bottom() != timeline_h) {
+        setViewportMargins(margins.left(), margins.top(), margins.right(), timeline_h);
+    }
+    if (timeline_h > 0) {
+        QRect vp_r = viewport()->geometry();
+        timeline_->setGeometry(vp_r.left(), vp_r.bottom() + 1, vp_r.width(), timeline_h);
+    }
+}
+
 void PacketList::setColumnVisibility()
 {
     set_column_visibility_ = true;
@@ -1195,6 +1247,10 @@ void PacketList::captureFileReadFinished()
     // Invalidating the column strings picks up and request/response
     // tracking changes. We might just want to call it from flushVisibleRows.
     packet_list_model_->invalidateAllColumnStrings();
+
+    timeline_->captureFileReadFinished();
+    timeline_->setVisible(timeline_->hasData());
+    updateGeometries();
 }
 
 void PacketList::freeze()
@@ -1248,6 +1304,10 @@ void PacketList::clear() {
     overlay_sb_->setMarkedPacketImage(overlay);
     create_near_overlay_ = true;
     create_far_overlay_ = true;
+
+    timeline_->clear();
+    timeline_->hide();
+    updateGeometries();
 }
 
 void PacketList::writeRecent(FILE *rf) {
@@ -1511,6 +1571,7 @@ void PacketList::setCaptureFile(capture_file *cf)
     cap_file_ = cf;
     packet_list_model_->setCaptureFile(cf);
     packet_list_header_->setCaptureFile(cf);
+    timeline_->setCaptureFile(cf);
     if (cf) {
         if (columns_changed_) {
             columnsChanged();
@@ -1644,8 +1705,9 @@ void PacketList::markFrame()
 
     packet_list_model_->toggleFrameMark(frames);
 
-    // Make sure the packet list's frame.marked related field text is updated.
-    redrawVisiblePackets();
+    // The model invalidated the affected rows; redissect the current
+    // packet so the detail pane's frame.marked field is updated too.
+    drawCurrentPacket();
 
     create_far_overlay_ = true;
     packets_bar_update();
@@ -1657,8 +1719,9 @@ void PacketList::markAllDisplayedFrames(bool set)
 
     packet_list_model_->setDisplayedFrameMark(set);
 
-    // Make sure the packet list's frame.marked related field text is updated.
-    redrawVisiblePackets();
+    // The model invalidated the affected rows; redissect the current
+    // packet so the detail pane's frame.marked field is updated too.
+    drawCurrentPacket();
 
     create_far_overlay_ = true;
     packets_bar_update();
@@ -1718,7 +1781,12 @@ void PacketList::unsetAllTimeReferences()
 
 void PacketList::applyTimeShift()
 {
-    packet_list_model_->resetColumns();
+    // The raw timestamps changed underneath the model's time-sorted
+    // companion index, so it no longer is sorted.
+    packet_list_model_->invalidateTimeSortIndex();
+    // Only the time-derived columns changed; recompute them from the
+    // shifted frame_data timestamps instead of redissecting every row.
+    packet_list_model_->refreshFrameDataColumns();
     redrawVisiblePackets();
     // XXX emit packetDissectionChanged(); ?
 }
@@ -1927,6 +1995,13 @@ void PacketList::scrollViewChanged(bool at_end)
 // Odd (prime?) numbers resulted in fewer scaling artifacts. A multiplier
 // of 9 washed out colors a little too much.
 //const int height_multiplier_ = 7;
+void PacketList::rowsColorized(int, int)
+{
+    // The model's background sweep colorized more rows; pick the new
+    // colors up on the next overlay timer tick.
+    create_near_overlay_ = true;
+}
+
 void PacketList::drawNearOverlay()
 {
     if (create_near_overlay_) {
@@ -1956,9 +2031,12 @@ void PacketList::drawNearOverlay()
             start += ((double) overlay_sb_->value() / overlay_sb_->maximum()) * (packet_list_model_->rowCount() - o_rows);
         }
         int end = start + o_rows;
+        // Don't block here dissecting every overlay row; ask the model to
+        // colorize the range from its idle sweep instead. Rows that
+        // haven't been colorized yet stay transparent for the moment, and
+        // rowsColorized() queues another overlay pass as results come in.
+        packet_list_model_->prioritizeColorization(start, end - 1);
         for (int row = start; row < end; row++) {
-            packet_list_model_->ensureRowColorized(row);
-
             frame_data *fdata = packet_list_model_->getRowFdata(row);
             const color_t *bgcolor = NULL;
             if (fdata->color_filter) {
@@ -24,6 +24,7 @@
 
 class PacketListHeader;
 class OverlayScrollBar;
+class PacketTimeline;
 
 class QAction;
 class QTimerEvent;
@@ -102,6 +103,7 @@ protected:
     virtual void mouseMoveEvent (QMouseEvent *event) override;
     virtual void resizeEvent(QResizeEvent *event) override;
     virtual void keyPressEvent(QKeyEvent *event) override;
+    void updateGeometries() override;
 
 protected slots:
     void rowsInserted(const QModelIndex &parent, int start, int end) override;
@@ -119,6 +121,7 @@ private:
     int ctx_column_;
     QByteArray column_state_;
     OverlayScrollBar *overlay_sb_;
+    PacketTimeline *timeline_;
     int overlay_timer_id_;
     bool create_near_overlay_;
     bool create_far_overlay_;
@@ -194,8 +197,10 @@ private slots:
     void vScrollBarActionTriggered(int);
     void drawFarOverlay();
     void drawNearOverlay();
+    void rowsColorized(int first, int last);
     void updatePackets(bool redraw);
     void ctxDecodeAsDialog();
+    void ctxRedissectToFrame();
 };
 
 #endif // PACKET_LIST_H
@@ -73,6 +73,11 @@ static const QRgb color_cn_ = 0xbfbfff;
 static const QRgb color_rtp_warn_ = 0xffdbbf;
 static const QRgb color_pt_event_ = 0xefffff;
 
+// Cap on stored graph points per stream; when reached, every other point
+// is dropped and the sampling stride doubles, bounding graph memory for
+// arbitrarily long streams.
+static const int max_graph_points_ = 20000;
+
 enum { rtp_analysis_type_ = 1000 };
 class RtpAnalysisTreeWidgetItem : public QTreeWidgetItem
 {
@@ -719,6 +724,8 @@ void RtpAnalysisDialog::resetStatistics()
         tab->jitter_vals->clear();
         tab->diff_vals->clear();
         tab->delta_vals->clear();
+        tab->packets_seen = 0;
+        tab->graph_stride = 1;
         tab->tree_widget->clear();
     }
 
@@ -731,10 +738,25 @@ void RtpAnalysisDialog::addPacket(tab_info_t *tab, packet_info *pinfo, const _rt
 {
     rtppacket_analyse(&tab->stream.rtp_stats, pinfo, rtpinfo);
     new RtpAnalysisTreeWidgetItem(tab->tree_widget, &tab->stream.rtp_stats, pinfo, rtpinfo);
-    tab->time_vals->append(tab->stream.rtp_stats.time / 1000);
-    tab->jitter_vals->append(tab->stream.rtp_stats.jitter);
-    tab->diff_vals->append(tab->stream.rtp_stats.diff);
-    tab->delta_vals->append(tab->stream.rtp_stats.delta);
+    if ((tab->packets_seen++ % tab->graph_stride) == 0) {
+        tab->time_vals->append(tab->stream.rtp_stats.time / 1000);
+        tab->jitter_vals->append(tab->stream.rtp_stats.jitter);
+        tab->diff_vals->append(tab->stream.rtp_stats.diff);
+        tab->delta_vals->append(tab->stream.rtp_stats.delta);
+        if (tab->time_vals->size() >= max_graph_points_) {
+            // Keep the even-indexed points; they stay on multiples of the
+            // doubled stride, so future appends line up with them.
+            QVector<double> *vals[] = { tab->time_vals, tab->jitter_vals,
+                                        tab->diff_vals, tab->delta_vals };
+            for (QVector<double> *v : vals) {
+                for (int j = 0; j * 2 < v->size(); j++) {
+                    (*v)[j] = (*v)[j * 2];
+                }
+                v->resize((v->size() + 1) / 2);
+            }
+            tab->graph_stride *= 2;
+        }
+    }
 }
 
 void RtpAnalysisDialog::updateStatistics()
@@ -762,6 +784,10 @@ void RtpAnalysisDialog::updateStatistics()
                 .arg(s_calc.max_jitter, 0, 'f', prefs.gui_decimal_places3);
         stats_tables += QString("<tr><th align=\"left\">Mean Jitter</th><td>%1 ms</td></tr>")
                 .arg(s_calc.mean_jitter, 0, 'f', prefs.gui_decimal_places3);
+        stats_tables += QString("<tr><th align=\"left\">Jitter StDev</th><td>%1 ms</td></tr>")
+                .arg(s_calc.stdev_jitter, 0, 'f', prefs.gui_decimal_places3);
+        stats_tables += QString("<tr><th align=\"left\">95th Pct Jitter</th><td>%1 ms</td></tr>")
+                .arg(s_calc.p95_jitter, 0, 'f', prefs.gui_decimal_places3);
         stats_tables += QString("<tr><th align=\"left\">Max Skew</th><td>%1 ms</td></tr>")
                 .arg(s_calc.max_skew, 0, 'f', prefs.gui_decimal_places3);
         stats_tables += QString("<tr><th align=\"left\">RTP Packets</th><td>%1</td></tr>")
@@ -1036,6 +1062,7 @@ void RtpAnalysisDialog::addRtpStreamsPrivate(QVector<rtpstream_id_t *> stream_id
             new_tab->jitter_vals = new QVector<double>();
             new_tab->diff_vals = new QVector<double>();
             new_tab->delta_vals = new QVector<double>();
+            new_tab->graph_stride = 1;
             tabs_ << new_tab;
             cur_tab_no = addTabUI(new_tab);
             tab_hash_.insert(rtpstream_id_to_hash(id), new_tab);
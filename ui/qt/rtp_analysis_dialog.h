@@ -45,6 +45,8 @@ typedef struct {
     QVector<double> *jitter_vals;
     QVector<double> *diff_vals;
     QVector<double> *delta_vals;
+    guint packets_seen;  // packets tapped so far, for graph decimation
+    guint graph_stride;  // store every Nth packet in the graph series
     QTreeWidget *tree_widget;
     QLabel *statistics_label;
     QString *tab_name;
@@ -11,6 +11,7 @@
 #include <ui_sctp_all_assocs_dialog.h>
 #include "sctp_assoc_analyse_dialog.h"
 
+#include <ui/qt/models/sctp_all_assocs_model.h>
 #include <ui/qt/utils/qt_ui_utils.h>
 //#include "wireshark_application.h"
 #include "file.h"
@@ -19,6 +20,7 @@
 #include <QWidget>
 #include <QDir>
 #include <QPushButton>
+#include <QSortFilterProxyModel>
 
 //#include <QDebug>
 
@@ -33,6 +35,10 @@ SCTPAllAssocsDialog::SCTPAllAssocsDialog(QWidget *parent, capture_file *cf) :
             | Qt::WindowMaximizeButtonHint
             | Qt::WindowCloseButtonHint;
     this->setWindowFlags(flags);
+    model_ = new SCTPAllAssocsModel(this);
+    proxy_ = new QSortFilterProxyModel(this);
+    proxy_->setSourceModel(model_);
+    ui->assocList->setModel(proxy_);
     fillTable();
 }
 
@@ -44,15 +50,6 @@ SCTPAllAssocsDialog::~SCTPAllAssocsDialog()
 void SCTPAllAssocsDialog::fillTable()
 {
     const sctp_allassocs_info_t *sctp_assocs;
-    GList *list;
-    const sctp_assoc_info_t* assinfo;
-    int numAssocs;
-
-    ui->assocList->setColumnHidden(0, true);
-    ui->assocList->setColumnWidth(1,  85);
-    ui->assocList->setColumnWidth(2,  85);
-    ui->assocList->setColumnWidth(3,  150);
-    ui->assocList->setColumnWidth(4,  150);
 
     sctp_assocs = sctp_stat_get_info();
     if (sctp_assocs->is_registered == FALSE) {
@@ -60,33 +57,31 @@ void SCTPAllAssocsDialog::fillTable()
         /*  (redissect all packets) */
         cf_retap_packets(cap_file_);
     }
-    numAssocs = 0;
-    ui->assocList->setRowCount(static_cast<int>(g_list_length(sctp_assocs->assoc_info_list)));
-
-    list = g_list_first(sctp_assocs->assoc_info_list);
-
-    while (list) {
-        assinfo = gxx_list_data(const sctp_assoc_info_t*, list);
-        ui->assocList->setItem(numAssocs, 0, new QTableWidgetItem(QString("%1").arg(assinfo->assoc_id)));
-        ui->assocList->setItem(numAssocs, 1, new QTableWidgetItem(QString("%1").arg(assinfo->port1)));
-        ui->assocList->setItem(numAssocs, 2, new QTableWidgetItem(QString("%1").arg(assinfo->port2)));
-        ui->assocList->setItem(numAssocs, 3, new QTableWidgetItem(QString("%1").arg(assinfo->n_packets)));
-        ui->assocList->setItem(numAssocs, 4, new QTableWidgetItem(QString("%1").arg(assinfo->n_data_chunks)));
-        ui->assocList->setItem(numAssocs, 5, new QTableWidgetItem(QString("%1").arg(assinfo->n_data_bytes)));
-        list = gxx_list_next(list);
-        numAssocs++;
-    }
+    model_->setAssocList(sctp_assocs->assoc_info_list);
+
+    ui->assocList->setColumnHidden(SCTPAllAssocsModel::COL_ID, true);
+    ui->assocList->setColumnWidth(SCTPAllAssocsModel::COL_PORT1,  85);
+    ui->assocList->setColumnWidth(SCTPAllAssocsModel::COL_PORT2,  85);
+    ui->assocList->setColumnWidth(SCTPAllAssocsModel::COL_PACKETS,  150);
+    ui->assocList->setColumnWidth(SCTPAllAssocsModel::COL_DATA_CHUNKS,  150);
+
     ui->analyseButton->setEnabled(false);
     ui->setFilterButton->setEnabled(false);
-    connect(ui->assocList, SIGNAL(itemSelectionChanged()), this, SLOT(getSelectedItem()));
+    connect(ui->assocList->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
+            this, SLOT(getSelectedItem()));
  }
 
 void SCTPAllAssocsDialog::getSelectedItem()
 {
+    QModelIndexList selection = ui->assocList->selectionModel()->selectedRows();
+    if (selection.isEmpty())
+        return;
+
     ui->analyseButton->setEnabled(true);
     ui->setFilterButton->setEnabled(true);
     ui->analyseButton->setFocus(Qt::OtherFocusReason);
-    selected_assoc_id = ui->assocList->item(ui->assocList->selectedItems().at(0)->row(), 0)->data(0).toInt();
+    QModelIndex id_idx = selection.at(0).sibling(selection.at(0).row(), SCTPAllAssocsModel::COL_ID);
+    selected_assoc_id = (guint16)ui->assocList->model()->data(id_idx).toUInt();
 }
 
 void SCTPAllAssocsDialog::on_analyseButton_clicked()
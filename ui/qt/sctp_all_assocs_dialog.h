@@ -23,6 +23,9 @@
 #include <QDialog>
 #include <QObject>
 
+class QSortFilterProxyModel;
+class SCTPAllAssocsModel;
+
 namespace Ui {
 class SCTPAllAssocsDialog;
 }
@@ -48,6 +51,8 @@ private slots:
 private:
     Ui::SCTPAllAssocsDialog *ui;
     capture_file *cap_file_;
+    SCTPAllAssocsModel *model_;
+    QSortFilterProxyModel *proxy_;
     guint16 selected_assoc_id;
 
 
@@ -59,43 +59,35 @@ SCTPGraphArwndDialog::~SCTPGraphArwndDialog()
 
 void SCTPGraphArwndDialog::drawArwndGraph(const sctp_assoc_info_t *selected_assoc)
 {
-    GList *listSACK = Q_NULLPTR, *tlist;
+    const sctp_chunk_store_t *sack_store;
     struct sack_chunk_header *sack_header;
     struct nr_sack_chunk_header *nr_sack_header;
-    tsn_t *tsn;
-    guint8 type;
     guint32 arwnd=0;
 
     if (direction == 1) {
-        listSACK = g_list_last(selected_assoc->sack1);
+        sack_store = &selected_assoc->sack_store1;
         startArwnd = selected_assoc->arwnd2;
     } else {
-        listSACK = g_list_last(selected_assoc->sack2);
+        sack_store = &selected_assoc->sack_store2;
         startArwnd = selected_assoc->arwnd1;
     }
     bool detect_max_arwnd = (startArwnd == 0) ? true : false;
 
-    while (listSACK) {
-        tsn = gxx_list_data(tsn_t*, listSACK);
-        tlist = g_list_first(tsn->tsns);
-        while (tlist) {
-            type = gxx_list_data(struct chunk_header *, tlist)->type;
-            if (type == SCTP_SACK_CHUNK_ID) {
-                sack_header = gxx_list_data(struct sack_chunk_header *, tlist);
-                arwnd = g_ntohl(sack_header->a_rwnd);
-            } else if (type == SCTP_NR_SACK_CHUNK_ID) {
-                nr_sack_header = gxx_list_data(struct nr_sack_chunk_header *, tlist);
-                arwnd = g_ntohl(nr_sack_header->a_rwnd);
-            }
-            if (detect_max_arwnd && startArwnd < arwnd) {
-                startArwnd = arwnd;
-            }
-            ya.append(arwnd);
-            xa.append(tsn->secs + tsn->usecs/1000000.0);
-            fa.append(tsn->frame_number);
-            tlist = gxx_list_next(tlist);
+    for (guint n = 0; sack_store->recs && n < sack_store->recs->len; n++) {
+        const sctp_chunk_rec_t *rec = &g_array_index(sack_store->recs, sctp_chunk_rec_t, n);
+        if (rec->type == SCTP_SACK_CHUNK_ID) {
+            sack_header = (struct sack_chunk_header *)(sack_store->bytes->data + rec->offset);
+            arwnd = g_ntohl(sack_header->a_rwnd);
+        } else if (rec->type == SCTP_NR_SACK_CHUNK_ID) {
+            nr_sack_header = (struct nr_sack_chunk_header *)(sack_store->bytes->data + rec->offset);
+            arwnd = g_ntohl(nr_sack_header->a_rwnd);
+        }
+        if (detect_max_arwnd && startArwnd < arwnd) {
+            startArwnd = arwnd;
         }
-        listSACK = gxx_list_previous(listSACK);
+        ya.append(arwnd);
+        xa.append(rec->secs + rec->usecs/1000000.0);
+        fa.append(rec->frame_number);
     }
 
     QCPScatterStyle myScatter;
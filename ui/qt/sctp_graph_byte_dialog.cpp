@@ -59,42 +59,33 @@ SCTPGraphByteDialog::~SCTPGraphByteDialog()
 
 void SCTPGraphByteDialog::drawBytesGraph(const sctp_assoc_info_t *selected_assoc)
 {
-    GList *listTSN = Q_NULLPTR, *tlist = Q_NULLPTR;
-    tsn_t *tsn = Q_NULLPTR;
-    guint8 type;
+    const sctp_chunk_store_t *tsn_store;
     guint32 maxBytes;
     guint64 sumBytes = 0;
 
     if (direction == 1) {
         maxBytes = selected_assoc->n_data_bytes_ep1;
-        listTSN = g_list_last(selected_assoc->tsn1);
+        tsn_store = &selected_assoc->tsn_store1;
     } else {
         maxBytes = selected_assoc->n_data_bytes_ep2;
-        listTSN = g_list_last(selected_assoc->tsn2);
+        tsn_store = &selected_assoc->tsn_store2;
     }
 
 
-    while (listTSN) {
-        tsn = gxx_list_data(tsn_t*, listTSN);
-        tlist = g_list_first(tsn->tsns);
+    for (guint n = 0; tsn_store->recs && n < tsn_store->recs->len; n++) {
+        const sctp_chunk_rec_t *rec = &g_array_index(tsn_store->recs, sctp_chunk_rec_t, n);
         guint16 length;
-        while (tlist)
-        {
-            type = gxx_list_data(struct chunk_header *, tlist)->type;
-            if (type == SCTP_DATA_CHUNK_ID || type == SCTP_I_DATA_CHUNK_ID) {
-                length = g_ntohs(gxx_list_data(struct data_chunk_header *, tlist)->length);
-                if (type == SCTP_DATA_CHUNK_ID)
-                    length -= DATA_CHUNK_HEADER_LENGTH;
-                else
-                    length -= I_DATA_CHUNK_HEADER_LENGTH;
-                sumBytes += length;
-                yb.append(sumBytes);
-                xb.append(tsn->secs + tsn->usecs/1000000.0);
-                fb.append(tsn->frame_number);
-            }
-            tlist = gxx_list_next(tlist);
+        if (rec->type == SCTP_DATA_CHUNK_ID || rec->type == SCTP_I_DATA_CHUNK_ID) {
+            length = g_ntohs(((struct data_chunk_header *)(tsn_store->bytes->data + rec->offset))->length);
+            if (rec->type == SCTP_DATA_CHUNK_ID)
+                length -= DATA_CHUNK_HEADER_LENGTH;
+            else
+                length -= I_DATA_CHUNK_HEADER_LENGTH;
+            sumBytes += length;
+            yb.append(sumBytes);
+            xb.append(rec->secs + rec->usecs/1000000.0);
+            fb.append(rec->frame_number);
         }
-        listTSN = gxx_list_previous(listTSN);
     }
 
 
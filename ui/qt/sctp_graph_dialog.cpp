@@ -65,10 +65,8 @@ SCTPGraphDialog::~SCTPGraphDialog()
 
 void SCTPGraphDialog::drawNRSACKGraph(const sctp_assoc_info_t* selected_assoc)
 {
-    tsn_t *sack = Q_NULLPTR;
-    GList *list = Q_NULLPTR, *tlist = Q_NULLPTR;
+    const sctp_chunk_store_t *sack_store;
     guint16 gap_start=0, gap_end=0, i, numberOf_gaps, numberOf_nr_gaps;
-    guint8 type;
     guint32 tsnumber, j = 0, min_tsn, rel = 0;
     struct nr_sack_chunk_header *nr_sack_header = Q_NULLPTR;
     struct gaps *nr_gap = Q_NULLPTR;
@@ -76,68 +74,60 @@ void SCTPGraphDialog::drawNRSACKGraph(const sctp_assoc_info_t* selected_assoc)
     guint16 total_gaps = 0;
 
     if (direction == 1) {
-        list = g_list_last(selected_assoc->sack1);
+        sack_store = &selected_assoc->sack_store1;
         min_tsn = selected_assoc->min_tsn1;
     } else {
-        list = g_list_last(selected_assoc->sack2);
+        sack_store = &selected_assoc->sack_store2;
         min_tsn = selected_assoc->min_tsn2;
     }
     if (relative) {
         rel = min_tsn;
     }
-    while (list) {
-        sack = gxx_list_data(tsn_t*, list);
-        tlist = g_list_first(sack->tsns);
-        while (tlist) {
-            type = gxx_list_data(struct chunk_header *, tlist)->type;
-            if (type == SCTP_NR_SACK_CHUNK_ID) {
-                nr_sack_header = gxx_list_data(struct nr_sack_chunk_header *, tlist);
-                numberOf_nr_gaps=g_ntohs(nr_sack_header->nr_of_nr_gaps);
-                numberOf_gaps=g_ntohs(nr_sack_header->nr_of_gaps);
-                tsnumber = g_ntohl(nr_sack_header->cum_tsn_ack);
-                total_gaps = numberOf_gaps + numberOf_nr_gaps;
-                /* If the number of nr_gaps is greater than 0 */
-                if (total_gaps > 0) {
-                    nr_gap = &nr_sack_header->gaps[0];
-                    for (i = 0; i < total_gaps; i++) {
-                        gap_start = g_ntohs(nr_gap->start);
-                        gap_end = g_ntohs(nr_gap->end);
-                        for (j = gap_start; j <= gap_end; j++) {
-                            if (i >= numberOf_gaps) {
-                                yn.append(j + tsnumber - rel);
-                                xn.append(sack->secs + sack->usecs/1000000.0);
-                                fn.append(sack->frame_number);
-                            } else {
-                                yg.append(j + tsnumber - rel);
-                                xg.append(sack->secs + sack->usecs/1000000.0);
-                                fg.append(sack->frame_number);
-                            }
+    for (guint n = 0; sack_store->recs && n < sack_store->recs->len; n++) {
+        const sctp_chunk_rec_t *rec = &g_array_index(sack_store->recs, sctp_chunk_rec_t, n);
+        if (rec->type == SCTP_NR_SACK_CHUNK_ID) {
+            nr_sack_header = (struct nr_sack_chunk_header *)(sack_store->bytes->data + rec->offset);
+            numberOf_nr_gaps=g_ntohs(nr_sack_header->nr_of_nr_gaps);
+            numberOf_gaps=g_ntohs(nr_sack_header->nr_of_gaps);
+            tsnumber = rec->tsn;
+            total_gaps = numberOf_gaps + numberOf_nr_gaps;
+            /* If the number of nr_gaps is greater than 0 */
+            if (total_gaps > 0) {
+                nr_gap = &nr_sack_header->gaps[0];
+                for (i = 0; i < total_gaps; i++) {
+                    gap_start = g_ntohs(nr_gap->start);
+                    gap_end = g_ntohs(nr_gap->end);
+                    for (j = gap_start; j <= gap_end; j++) {
+                        if (i >= numberOf_gaps) {
+                            yn.append(j + tsnumber - rel);
+                            xn.append(rec->secs + rec->usecs/1000000.0);
+                            fn.append(rec->frame_number);
+                        } else {
+                            yg.append(j + tsnumber - rel);
+                            xg.append(rec->secs + rec->usecs/1000000.0);
+                            fg.append(rec->frame_number);
                         }
-                        if (i < total_gaps-1)
-                            nr_gap++;
                     }
+                    if (i < total_gaps-1)
+                        nr_gap++;
+                }
 
-                    if (tsnumber>=min_tsn) {
-                        ys.append(j + tsnumber - rel);
-                        xs.append(sack->secs + sack->usecs/1000000.0);
-                        fs.append(sack->frame_number);
-                    }
+                if (tsnumber>=min_tsn) {
+                    ys.append(j + tsnumber - rel);
+                    xs.append(rec->secs + rec->usecs/1000000.0);
+                    fs.append(rec->frame_number);
                 }
             }
-            tlist = gxx_list_next(tlist);
         }
-        list = gxx_list_previous(list);
     }
 }
 
 void SCTPGraphDialog::drawSACKGraph(const sctp_assoc_info_t* selected_assoc)
 {
-    GList *listSACK = Q_NULLPTR, *tlist = Q_NULLPTR;
+    const sctp_chunk_store_t *sack_store;
     guint16 gap_start=0, gap_end=0, nr, dup_nr;
     struct sack_chunk_header *sack_header = Q_NULLPTR;
     struct gaps *gap = Q_NULLPTR;
-    tsn_t *tsn = Q_NULLPTR;
-    guint8 type;
     guint32 tsnumber=0, rel = 0;
     guint32 minTSN;
     guint32 *dup_list = Q_NULLPTR;
@@ -145,58 +135,52 @@ void SCTPGraphDialog::drawSACKGraph(const sctp_assoc_info_t* selected_assoc)
 
     if (direction == 1) {
         minTSN = selected_assoc->min_tsn1;
-        listSACK = g_list_last(selected_assoc->sack1);
+        sack_store = &selected_assoc->sack_store1;
     } else {
         minTSN = selected_assoc->min_tsn2;
-        listSACK = g_list_last(selected_assoc->sack2);
+        sack_store = &selected_assoc->sack_store2;
     }
     if (relative) {
         rel = minTSN;
     }
-    while (listSACK) {
-        tsn = gxx_list_data(tsn_t*, listSACK);
-        tlist = g_list_first(tsn->tsns);
-        while (tlist) {
-            type = gxx_list_data(struct chunk_header *, tlist)->type;
-            if (type == SCTP_SACK_CHUNK_ID) {
-                sack_header = gxx_list_data(struct sack_chunk_header *, tlist);
-                nr=g_ntohs(sack_header->nr_of_gaps);
-                tsnumber = g_ntohl(sack_header->cum_tsn_ack);
-                dup_nr=g_ntohs(sack_header->nr_of_dups);
-                if (nr>0) {  // Gap Reports green
-                    gap = &sack_header->gaps[0];
-                    for (i=0;i<nr; i++) {
-                        gap_start=g_ntohs(gap->start);
-                        gap_end = g_ntohs(gap->end);
-                        for (j=gap_start; j<=gap_end; j++) {
-                            yg.append(j + tsnumber - rel);
-                            xg.append(tsn->secs + tsn->usecs/1000000.0);
-                            fg.append(tsn->frame_number);
-                        }
-                        if (i < nr-1)
-                            gap++;
+    for (guint n = 0; sack_store->recs && n < sack_store->recs->len; n++) {
+        const sctp_chunk_rec_t *rec = &g_array_index(sack_store->recs, sctp_chunk_rec_t, n);
+        if (rec->type == SCTP_SACK_CHUNK_ID) {
+            sack_header = (struct sack_chunk_header *)(sack_store->bytes->data + rec->offset);
+            nr=g_ntohs(sack_header->nr_of_gaps);
+            tsnumber = rec->tsn;
+            dup_nr=g_ntohs(sack_header->nr_of_dups);
+            if (nr>0) {  // Gap Reports green
+                gap = &sack_header->gaps[0];
+                for (i=0;i<nr; i++) {
+                    gap_start=g_ntohs(gap->start);
+                    gap_end = g_ntohs(gap->end);
+                    for (j=gap_start; j<=gap_end; j++) {
+                        yg.append(j + tsnumber - rel);
+                        xg.append(rec->secs + rec->usecs/1000000.0);
+                        fg.append(rec->frame_number);
                     }
+                    if (i < nr-1)
+                        gap++;
                 }
-                if (tsnumber>=minTSN) { // CumTSNAck red
-                    ys.append(tsnumber - rel);
-                    xs.append(tsn->secs + tsn->usecs/1000000.0);
-                    fs.append(tsn->frame_number);
-                }
-                if (dup_nr > 0) { // Duplicates cyan
-                    dup_list = &sack_header->a_rwnd + 2 + nr;
-                    for (i = 0; i < dup_nr; i++) {
-                        tsnumber = g_ntohl(dup_list[i]);
-                        if (tsnumber >= minTSN) {
-                            yd.append(tsnumber - rel);
-                            xd.append(tsn->secs + tsn->usecs/1000000.0);
-                            fd.append(tsn->frame_number);
-                        }
+            }
+            if (tsnumber>=minTSN) { // CumTSNAck red
+                ys.append(tsnumber - rel);
+                xs.append(rec->secs + rec->usecs/1000000.0);
+                fs.append(rec->frame_number);
+            }
+            if (dup_nr > 0) { // Duplicates cyan
+                dup_list = &sack_header->a_rwnd + 2 + nr;
+                for (i = 0; i < dup_nr; i++) {
+                    tsnumber = g_ntohl(dup_list[i]);
+                    if (tsnumber >= minTSN) {
+                        yd.append(tsnumber - rel);
+                        xd.append(rec->secs + rec->usecs/1000000.0);
+                        fd.append(rec->frame_number);
                     }
                 }
             }
-            tlist = gxx_list_next(tlist);
         }
-        listSACK = gxx_list_previous(listSACK);
     }
 
     QCPScatterStyle myScatter;
@@ -260,38 +244,28 @@ void SCTPGraphDialog::drawSACKGraph(const sctp_assoc_info_t* selected_assoc)
 
 void SCTPGraphDialog::drawTSNGraph(const sctp_assoc_info_t* selected_assoc)
 {
-    GList *listTSN = Q_NULLPTR,*tlist = Q_NULLPTR;
-    tsn_t *tsn = Q_NULLPTR;
-    guint8 type;
-    guint32 tsnumber=0, rel = 0, minTSN;
+    const sctp_chunk_store_t *tsn_store;
+    guint32 rel = 0, minTSN;
 
     if (direction == 1) {
-        listTSN = g_list_last(selected_assoc->tsn1);
-         minTSN = selected_assoc->min_tsn1;
+        tsn_store = &selected_assoc->tsn_store1;
+          minTSN = selected_assoc->min_tsn1;
     } else {
-        listTSN = g_list_last(selected_assoc->tsn2);
-         minTSN = selected_assoc->min_tsn2;
+        tsn_store = &selected_assoc->tsn_store2;
+          minTSN = selected_assoc->min_tsn2;
     }
 
     if (relative) {
         rel = minTSN;
      }
 
-    while (listTSN) {
-        tsn = gxx_list_data(tsn_t*, listTSN);
-        tlist = g_list_first(tsn->tsns);
-        while (tlist)
-        {
-            type = gxx_list_data(struct chunk_header *, tlist)->type;
-            if (type == SCTP_DATA_CHUNK_ID || type == SCTP_I_DATA_CHUNK_ID || type == SCTP_FORWARD_TSN_CHUNK_ID) {
-                tsnumber = g_ntohl(gxx_list_data(struct data_chunk_header *, tlist)->tsn);
-                yt.append(tsnumber - rel);
-                xt.append(tsn->secs + tsn->usecs/1000000.0);
-                ft.append(tsn->frame_number);
-            }
-            tlist = gxx_list_next(tlist);
+    for (guint n = 0; tsn_store->recs && n < tsn_store->recs->len; n++) {
+        const sctp_chunk_rec_t *rec = &g_array_index(tsn_store->recs, sctp_chunk_rec_t, n);
+        if (rec->type == SCTP_DATA_CHUNK_ID || rec->type == SCTP_I_DATA_CHUNK_ID || rec->type == SCTP_FORWARD_TSN_CHUNK_ID) {
+            yt.append(rec->tsn - rel);
+            xt.append(rec->secs + rec->usecs/1000000.0);
+            ft.append(rec->frame_number);
         }
-        listTSN = gxx_list_previous(listTSN);
     }
 
     QCPScatterStyle myScatter;
@@ -492,7 +492,9 @@ void SearchFrame::on_findButton_clicked()
         }
     } else {
         /* Search via display filter */
-        found_packet = cf_find_packet_dfilter(cap_file_, dfp, cap_file_->dir);
+        found_packet = cf_find_packet_dfilter(cap_file_, dfp,
+                                              sf_ui_->searchLineEdit->text().toUtf8().constData(),
+                                              cap_file_->dir);
         dfilter_free(dfp);
         if (!found_packet) {
             err_string = tr("No packet matched that filter.");
@@ -137,13 +137,13 @@ int SequenceDiagram::adjacentPacket(bool next)
     return adjacent_packet;
 }
 
-void SequenceDiagram::setData(_seq_analysis_info *sainfo)
+void SequenceDiagram::setData(_seq_analysis_info *sainfo, double first_key)
 {
     data_->clear();
     sainfo_ = sainfo;
     if (!sainfo) return;
 
-    double cur_key = 0.0;
+    double cur_key = first_key;
     QVector<double> key_ticks, val_ticks;
     QVector<QString> key_labels, val_labels, com_labels;
     QFontMetrics com_fm(comment_axis_->tickLabelFont());
@@ -202,7 +202,7 @@ _seq_analysis_item *SequenceDiagram::itemForPosY(int ypos)
 {
     double key_pos = qRound(key_axis_->pixelToCoord(ypos));
 
-    if (key_pos >= 0 && key_pos < data_->size()) {
+    if (data_->contains(key_pos)) {
         return data_->value(key_pos).value;
     }
     return NULL;
@@ -212,7 +212,7 @@ double SequenceDiagram::selectTest(const QPointF &pos, bool, QVariant *) const
 {
     double key_pos = qRound(key_axis_->pixelToCoord(pos.y()));
 
-    if (key_pos >= 0 && key_pos < data_->size()) {
+    if (data_->contains(key_pos)) {
         return 1.0;
     }
 
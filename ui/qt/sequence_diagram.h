@@ -49,7 +49,9 @@ public:
     double selectedKey() { return selected_key_; }
 
     // setters:
-    void setData(struct _seq_analysis_info *sainfo);
+    // first_key is the item ordinal of the first materialized item, so a
+    // windowed item list maps to its place in the full key range.
+    void setData(struct _seq_analysis_info *sainfo, double first_key = 0.0);
 
     // non-property methods:
     struct _seq_analysis_item *itemForPosY(int ypos);
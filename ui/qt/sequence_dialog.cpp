@@ -60,6 +60,12 @@
 static const double min_top_ = -1.0;
 static const double min_left_ = -0.5;
 
+// Materializing an item per packet for a whole large capture costs gigabytes
+// to show a screenful, so we only keep a window of this many items around the
+// visible range. The tap pass still counts every matching packet and collects
+// the node list; scrolling past the window re-taps to materialize a new one.
+static const guint32 window_item_count_ = 10000;
+
 typedef struct {
     int curr_index;
     QComboBox *flow;
@@ -71,6 +77,8 @@ SequenceDialog::SequenceDialog(QWidget &parent, CaptureFile &cf, SequenceInfo *i
     ui(new Ui::SequenceDialog),
     info_(info),
     num_items_(0),
+    window_start_(0),
+    rebuilding_items_(false),
     packet_num_(0),
     sequence_w_(1),
     voipFeaturesEnabled(false)
@@ -335,6 +343,25 @@ void SequenceDialog::yAxisChanged(QCPRange range)
 {
     ui->verticalScrollBar->setValue(qRound(qreal(range.center()*100.0)));
     ui->verticalScrollBar->setPageStep(qRound(qreal(range.size()*100.0)));
+
+    if (rebuilding_items_ || !info_->sainfo() || file_closed_) return;
+    if ((guint32)num_items_ <= window_item_count_) return;
+    if (strcmp(info_->sainfo()->name, "voip") == 0) return;
+
+    // Re-materialize the item window when the view scrolls off of it.
+    guint32 lower = range.lower > 0 ? (guint32)range.lower : 0;
+    guint32 upper = range.upper > 0 ? (guint32)range.upper : 0;
+    if (lower < window_start_ ||
+        (upper >= window_start_ + window_item_count_ &&
+         window_start_ + window_item_count_ < (guint32)num_items_)) {
+        guint32 center = lower / 2 + upper / 2;
+        guint32 start = center > window_item_count_ / 2 ? center - window_item_count_ / 2 : 0;
+        if (start > (guint32)num_items_ - window_item_count_) {
+            start = (guint32)num_items_ - window_item_count_;
+        }
+        regenerateItems(start, window_item_count_);
+        ui->sequencePlot->replot();
+    }
 }
 
 void SequenceDialog::diagramClicked(QMouseEvent *event)
@@ -464,7 +491,18 @@ void SequenceDialog::exportDiagram()
         } else if (extension.compare(ascii_filter) == 0 && !file_closed_ && info_->sainfo()) {
             FILE  *outfile = ws_fopen(file_name.toUtf8().constData(), "w");
             if (outfile != NULL) {
+                bool windowed = (guint32)num_items_ > window_item_count_ &&
+                        strcmp(info_->sainfo()->name, "voip") != 0;
+                guint32 saved_start = window_start_;
+                if (windowed) {
+                    // The dump walks the item list, so materialize all of it,
+                    // not just the current window.
+                    regenerateItems(0, 0);
+                }
                 sequence_analysis_dump_to_file(outfile, info_->sainfo(), 0);
+                if (windowed) {
+                    regenerateItems(saved_start, window_item_count_);
+                }
                 save_ok = true;
                 fclose(outfile);
             } else {
@@ -489,30 +527,7 @@ void SequenceDialog::fillDiagram()
     if (strcmp(info_->sainfo()->name, "voip") == 0) {
         seq_diagram_->setData(info_->sainfo());
     } else {
-        seq_diagram_->clearData();
-        sequence_analysis_list_free(info_->sainfo());
-
-        register_analysis_t* analysis = sequence_analysis_find_by_name(info_->sainfo()->name);
-        if (analysis != NULL)
-        {
-            GString *error_string;
-            const char *filter = NULL;
-            if (ui->displayFilterCheckBox->checkState() == Qt::Checked)
-                filter = cap_file_.capFile()->dfilter;
-
-            error_string = register_tap_listener(sequence_analysis_get_tap_listener_name(analysis), info_->sainfo(), filter, sequence_analysis_get_tap_flags(analysis),
-                                       NULL, sequence_analysis_get_packet_func(analysis), NULL, NULL);
-            if (error_string) {
-                report_failure("Sequence dialog - tap registration failed: %s", error_string->str);
-                g_string_free(error_string, TRUE);
-            }
-
-            cf_retap_packets(cap_file_.capFile());
-            remove_tap_listener(info_->sainfo());
-
-            num_items_ = sequence_analysis_get_nodes(info_->sainfo());
-            seq_diagram_->setData(info_->sainfo());
-        }
+        regenerateItems(0, window_item_count_);
     }
 
     sequence_w_ = one_em_ * 15; // Arbitrary
@@ -524,6 +539,47 @@ void SequenceDialog::fillDiagram()
     sp->setFocus();
 }
 
+void SequenceDialog::regenerateItems(guint32 window_start, guint32 window_count)
+{
+    if (!info_->sainfo() || file_closed_ || rebuilding_items_) return;
+
+    register_analysis_t* analysis = sequence_analysis_find_by_name(info_->sainfo()->name);
+    if (analysis == NULL) return;
+
+    rebuilding_items_ = true;
+
+    seq_diagram_->clearData();
+    sequence_analysis_list_free(info_->sainfo());
+    info_->sainfo()->window_start = window_start;
+    info_->sainfo()->window_count = window_count;
+
+    GString *error_string;
+    const char *filter = NULL;
+    if (ui->displayFilterCheckBox->checkState() == Qt::Checked)
+        filter = cap_file_.capFile()->dfilter;
+
+    error_string = register_tap_listener(sequence_analysis_get_tap_listener_name(analysis), info_->sainfo(), filter, sequence_analysis_get_tap_flags(analysis),
+                               NULL, sequence_analysis_get_packet_func(analysis), NULL, NULL);
+    if (error_string) {
+        report_failure("Sequence dialog - tap registration failed: %s", error_string->str);
+        g_string_free(error_string, TRUE);
+    }
+
+    cf_retap_packets(cap_file_.capFile());
+    remove_tap_listener(info_->sainfo());
+
+    num_items_ = sequence_analysis_get_nodes(info_->sainfo());
+    if (window_count > 0) {
+        // A windowed pass counts every matching item, not just the
+        // materialized ones. Ranges and scroll bars cover the full capture.
+        num_items_ = info_->sainfo()->items_seen;
+    }
+    window_start_ = window_start;
+    seq_diagram_->setData(info_->sainfo(), window_start);
+
+    rebuilding_items_ = false;
+}
+
 void SequenceDialog::panAxes(int x_pixels, int y_pixels)
 {
     // We could simplify this quite a bit if we set the scroll bar values instead.
@@ -109,6 +109,8 @@ private:
     SequenceDiagram *seq_diagram_;
     SequenceInfo *info_;
     int num_items_;
+    guint32 window_start_;
+    bool rebuilding_items_;
     guint32 packet_num_;
     double one_em_;
     int sequence_w_;
@@ -125,6 +127,7 @@ private:
 
     void zoomXAxis(bool in);
     void panAxes(int x_pixels, int y_pixels);
+    void regenerateItems(guint32 window_start, guint32 window_count);
     void resetAxes(bool keep_lower = false);
     void goToAdjacentPacket(bool next);
 
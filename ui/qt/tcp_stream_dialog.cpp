@@ -74,8 +74,14 @@ const QString sequence_number_label_ = QObject::tr("Sequence Number (B)");
 const QString time_s_label_ = QObject::tr("Time (s)");
 const QString window_size_label_ = QObject::tr("Window Size (B)");
 
+// Bars per pixel column above which QCPErrorBarsNotSelectable::draw()
+// switches from the stock per-bar painter to a min/max envelope per column.
+const int lod_bars_per_column_ = 2;
+
 QCPErrorBarsNotSelectable::QCPErrorBarsNotSelectable(QCPAxis *keyAxis, QCPAxis *valueAxis) :
-    QCPErrorBars(keyAxis, valueAxis)
+    QCPErrorBars(keyAxis, valueAxis),
+    lod_generation_(1),
+    lod_cached_generation_(0)
 {
 }
 
@@ -91,6 +97,106 @@ double QCPErrorBarsNotSelectable::selectTest(const QPointF &pos, bool onlySelect
     return -1.0;
 }
 
+void QCPErrorBarsNotSelectable::setData(const QVector<double> &error)
+{
+    lod_generation_++;
+    QCPErrorBars::setData(error);
+}
+
+void QCPErrorBarsNotSelectable::draw(QCPPainter *painter)
+{
+    QCPAxis *key_axis = mKeyAxis.data();
+    QCPAxis *value_axis = mValueAxis.data();
+
+    // The envelope below assumes value-error bars sorted by key along a
+    // horizontal key axis, which is all the tcptrace graph produces;
+    // bail out to the stock painter for anything else.
+    if (!mDataPlottable || !key_axis || !value_axis
+        || mDataContainer->isEmpty()
+        || !mDataPlottable->interface1D()->sortKeyIsMainKey()
+        || key_axis->orientation() != Qt::Horizontal
+        || mErrorType != etValueError) {
+        QCPErrorBars::draw(painter);
+        return;
+    }
+
+    QCPErrorBarsDataContainer::const_iterator begin, end;
+    getVisibleDataBounds(begin, end, QCPDataRange(0, dataCount()));
+    const QRect axis_rect = key_axis->axisRect()->rect();
+    const int width = axis_rect.width();
+    if (width <= 0 || end - begin <= width * lod_bars_per_column_) {
+        QCPErrorBars::draw(painter);
+        return;
+    }
+
+    // Dense view: collapse each pixel column to one backbone spanning
+    // the column's min/max error extent.  At this density that's what
+    // the per-bar painter resolves to anyway, at a fraction of the
+    // cost.  The lines only change when the data or the view does, so
+    // they are kept across the replots that the tracer and rubber band
+    // trigger on every mouse move.
+    if (lod_cached_generation_ != lod_generation_
+        || lod_rect_ != axis_rect
+        || lod_key_range_ != key_axis->range()
+        || lod_value_range_ != value_axis->range()) {
+        const int left = axis_rect.left();
+        QVector<double> col_top(width, 0.0);
+        QVector<double> col_bottom(width, 0.0);
+        QVector<bool> col_used(width, false);
+
+        for (QCPErrorBarsDataContainer::const_iterator it = begin; it != end; ++it) {
+            const int index = int(it - mDataContainer->constBegin());
+            const QPointF center = mDataPlottable->interface1D()->dataPixelPosition(index);
+            if (qIsNaN(center.x()) || qIsNaN(center.y()))
+                continue;
+            const int col = int(center.x()) - left;
+            if (col < 0 || col >= width)
+                continue;
+            const double center_coord = value_axis->pixelToCoord(center.y());
+            double top = center.y();
+            double bottom = center.y();
+            if (!qIsNaN(it->errorPlus)) {
+                const double p = value_axis->coordToPixel(center_coord + it->errorPlus);
+                top = qMin(top, p);
+                bottom = qMax(bottom, p);
+            }
+            if (!qIsNaN(it->errorMinus)) {
+                const double p = value_axis->coordToPixel(center_coord - it->errorMinus);
+                top = qMin(top, p);
+                bottom = qMax(bottom, p);
+            }
+            if (!col_used[col]) {
+                col_used[col] = true;
+                col_top[col] = top;
+                col_bottom[col] = bottom;
+            } else {
+                col_top[col] = qMin(col_top[col], top);
+                col_bottom[col] = qMax(col_bottom[col], bottom);
+            }
+        }
+
+        lod_lines_.clear();
+        for (int col = 0; col < width; col++) {
+            if (!col_used[col])
+                continue;
+            const double x = left + col + 0.5;
+            lod_lines_.append(QLineF(x, col_top[col], x, col_bottom[col]));
+        }
+        lod_cached_generation_ = lod_generation_;
+        lod_rect_ = axis_rect;
+        lod_key_range_ = key_axis->range();
+        lod_value_range_ = value_axis->range();
+    }
+
+    applyDefaultAntialiasingHint(painter);
+    painter->setBrush(Qt::NoBrush);
+    QPen pen = mPen;
+    if (pen.capStyle() == Qt::SquareCap)
+        pen.setCapStyle(Qt::FlatCap);
+    painter->setPen(pen);
+    painter->drawLines(lod_lines_);
+}
+
 TCPStreamDialog::TCPStreamDialog(QWidget *parent, capture_file *cf, tcp_graph_type graph_type) :
     GeometryStateDialog(parent),
     ui(new Ui::TCPStreamDialog),
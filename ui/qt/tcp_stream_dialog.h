@@ -41,6 +41,23 @@ public:
     virtual ~QCPErrorBarsNotSelectable();
 
     virtual double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details = 0) const Q_DECL_OVERRIDE;
+
+    // Not virtual in QCPErrorBars; call through this class so the
+    // level-of-detail cache below notices the new data.
+    void setData(const QVector<double> &error);
+
+protected:
+    virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
+
+private:
+    // Cached min/max envelope, one line per pixel column, used instead
+    // of per-bar drawing when the visible range is dense.  See draw().
+    QVector<QLineF> lod_lines_;
+    QCPRange lod_key_range_;
+    QCPRange lod_value_range_;
+    QRect lod_rect_;
+    unsigned lod_generation_;
+    unsigned lod_cached_generation_;
 };
 
 class TCPStreamDialog : public GeometryStateDialog
@@ -80,12 +97,12 @@ private:
     QCPGraph *tput_graph_;
     QCPGraph *goodput_graph_;
     QCPGraph *seg_graph_;
-    QCPErrorBars *seg_eb_;
+    QCPErrorBarsNotSelectable *seg_eb_;
     QCPGraph *ack_graph_;
     QCPGraph *sack_graph_;
-    QCPErrorBars *sack_eb_;
+    QCPErrorBarsNotSelectable *sack_eb_;
     QCPGraph *sack2_graph_;
-    QCPErrorBars *sack2_eb_;
+    QCPErrorBarsNotSelectable *sack2_eb_;
     QCPGraph *rwin_graph_;
     QCPGraph *dup_ack_graph_;
     QCPGraph *zero_win_graph_;
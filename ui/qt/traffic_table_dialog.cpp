@@ -343,7 +343,8 @@ TrafficTableTreeWidget::TrafficTableTreeWidget(QWidget *parent, register_ct_t *t
     QTreeWidget(parent),
     table_(table),
     hash_(),
-    resolve_names_(false)
+    resolve_names_(false),
+    sort_pending_(false)
 {
     setRootIsDecorated(false);
     sortByColumn(0, Qt::AscendingOrder);
@@ -351,6 +352,31 @@ TrafficTableTreeWidget::TrafficTableTreeWidget(QWidget *parent, register_ct_t *t
     connect(wsApp, SIGNAL(addressResolutionChanged()), this, SLOT(updateItemsForSettingChange()));
 }
 
+void TrafficTableTreeWidget::pauseSorting()
+{
+    setSortingEnabled(false);
+}
+
+void TrafficTableTreeWidget::resumeSorting()
+{
+    if (!isVisible()) {
+        // No point in sorting rows nobody can see; showEvent() picks
+        // this up when the tree becomes visible again.
+        sort_pending_ = true;
+        return;
+    }
+    setSortingEnabled(true);
+}
+
+void TrafficTableTreeWidget::showEvent(QShowEvent *event)
+{
+    if (sort_pending_) {
+        sort_pending_ = false;
+        setSortingEnabled(true);
+    }
+    QTreeWidget::showEvent(event);
+}
+
 QList<QVariant> TrafficTableTreeWidget::rowData(int row) const
 {
     QList<QVariant> row_data;
@@ -74,9 +74,19 @@ protected:
     int resizeThreshold() const { return 200; }
     void contextMenuEvent(QContextMenuEvent *event);
 
+    // Wrappers around setSortingEnabled() for updateItems(). Re-sorting
+    // a large tree on every tap update tick is expensive, so while the
+    // tree isn't visible (hidden dialog or background tab) the re-sort
+    // is deferred until it's shown.
+    void pauseSorting();
+    void resumeSorting();
+    virtual void showEvent(QShowEvent *event);
+
 private:
     virtual void updateItems() {}
 
+    bool sort_pending_;
+
 private slots:
     // Updates all items
     void updateItemsForSettingChange();
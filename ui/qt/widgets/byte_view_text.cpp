@@ -199,6 +199,7 @@ void ByteViewText::updateByteViewSettings()
 {
     row_width_ = recent.gui_bytes_view == BYTES_HEX ? 16 : 8;
 
+    invalidateLineCache();
     updateContextMenu();
     updateScrollbars();
     viewport()->update();
@@ -236,7 +237,6 @@ void ByteViewText::paintEvent(QPaintEvent *)
     int leading = fontMetrics().leading();
     painter.save();
 
-    x_pos_to_column_.clear();
     while ((int) (row_y + line_height_) < widget_height && offset < (int) data_.count()) {
         drawLine(&painter, offset, row_y);
         offset += row_width_;
@@ -342,11 +342,30 @@ void ByteViewText::contextMenuEvent(QContextMenuEvent *event)
 
 const int ByteViewText::separator_interval_ = DataPrinter::separatorInterval();
 
+// Upper bound on cached lines. Scrolling through a large reassembled
+// payload shouldn't pin a copy of every line of it in memory; at this
+// size the cache tops out around a megabyte and still covers many
+// screenfuls either side of the viewport.
+const int ByteViewText::max_cached_lines_ = 10000;
+
 void ByteViewText::updateLayoutMetrics()
 {
-    font_width_  = stringWidth("M");
+    int font_width  = stringWidth("M");
     // We might want to match ProtoTree::rowHeight.
-    line_height_ = fontMetrics().height();
+    int line_height = fontMetrics().height();
+
+    if (font_width != font_width_ || line_height != line_height_) {
+        font_width_ = font_width;
+        line_height_ = line_height;
+        invalidateLineCache();
+    }
+}
+
+void ByteViewText::invalidateLineCache()
+{
+    line_cache_.clear();
+    // The pixel to byte offset vector is rebuilt along with the lines.
+    x_pos_to_column_.clear();
 }
 
 int ByteViewText::stringWidth(const QString &line)
@@ -358,26 +377,32 @@ int ByteViewText::stringWidth(const QString &line)
 #endif
 }
 
-// Draw a line of byte view text for a given offset.
-// Text highlighting is handled using QTextLayout::FormatRange.
-void ByteViewText::drawLine(QPainter *painter, const int offset, const int row_y)
+// Build (or fetch) the text of the byte view line starting at a given
+// offset. The non-selection parts of a line never change for a given
+// display configuration, so cached lines survive repaints; selection,
+// hover and marking are applied on top of them at draw time.
+const ByteViewText::CachedLine &ByteViewText::cachedLine(const int offset)
 {
-    if (isEmpty()) {
-        return;
+    QHash<int, CachedLine>::const_iterator cl_it = line_cache_.constFind(offset);
+    if (cl_it != line_cache_.constEnd()) {
+        return cl_it.value();
+    }
+
+    if (line_cache_.size() >= max_cached_lines_) {
+        line_cache_.clear();
     }
 
-    // Build our pixel to byte offset vector the first time through.
+    // Build our pixel to byte offset vector along with the first line.
     bool build_x_pos = x_pos_to_column_.empty() ? true : false;
     int tvb_len = data_.count();
     int max_tvb_pos = qMin(offset + row_width_, tvb_len) - 1;
-    QList<QTextLayout::FormatRange> fmt_list;
 
     static const guchar hexchars[16] = {
         '0', '1', '2', '3', '4', '5', '6', '7',
         '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
 
-    QString line;
-    HighlightMode offset_mode = ModeOffsetNormal;
+    CachedLine cl;
+    QString &line = cl.text;
 
     // Offset.
     if (show_offset_) {
@@ -402,7 +427,9 @@ void ByteViewText::drawLine(QPainter *painter, const int offset, const int row_y
             /* insert a space every separator_interval_ bytes */
             if ((tvb_pos != offset) && ((tvb_pos % separator_interval_) == 0)) {
                 line += ' ';
-                x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset - 1, font_width_);
+                if (build_x_pos) {
+                    x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset - 1, font_width_);
+                }
             }
 
             switch (recent.gui_bytes_view) {
@@ -420,24 +447,11 @@ void ByteViewText::drawLine(QPainter *painter, const int offset, const int row_y
             if (build_x_pos) {
                 x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset, stringWidth(line) - x_pos_to_column_.size() + slop);
             }
-            if (tvb_pos == hovered_byte_offset_ || tvb_pos == marked_byte_offset_) {
-                int ho_len = recent.gui_bytes_view == BYTES_HEX ? 2 : 8;
-                QRect ho_rect = painter->boundingRect(QRect(), Qt::AlignHCenter|Qt::AlignVCenter, line.right(ho_len));
-                ho_rect.moveRight(stringWidth(line));
-                ho_rect.moveTop(row_y);
-                hover_outlines_.append(ho_rect);
-            }
         }
         line += QString(ascii_start - line.length(), ' ');
         if (build_x_pos) {
             x_pos_to_column_ += QVector<int>().fill(-1, stringWidth(line) - x_pos_to_column_.size());
         }
-
-        addHexFormatRange(fmt_list, proto_start_, proto_len_, offset, max_tvb_pos, ModeProtocol);
-        if (addHexFormatRange(fmt_list, field_start_, field_len_, offset, max_tvb_pos, ModeField)) {
-            offset_mode = ModeOffsetField;
-        }
-        addHexFormatRange(fmt_list, field_a_start_, field_a_len_, offset, max_tvb_pos, ModeField);
     }
 
     // ASCII
@@ -466,7 +480,7 @@ void ByteViewText::drawLine(QPainter *painter, const int offset, const int row_y
                 line += c;
                 if (in_non_printable) {
                     in_non_printable = false;
-                    addAsciiFormatRange(fmt_list, np_start, np_len, offset, max_tvb_pos, ModeNonPrintable);
+                    cl.np_runs.append(qMakePair(np_start, np_len));
                 }
             } else {
                 line += UTF8_MIDDLE_DOT;
@@ -481,15 +495,39 @@ void ByteViewText::drawLine(QPainter *painter, const int offset, const int row_y
             if (build_x_pos) {
                 x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset, stringWidth(line) - x_pos_to_column_.size());
             }
-            if (tvb_pos == hovered_byte_offset_ || tvb_pos == marked_byte_offset_) {
-                QRect ho_rect = painter->boundingRect(QRect(), 0, line.right(1));
-                ho_rect.moveRight(stringWidth(line));
-                ho_rect.moveTop(row_y);
-                hover_outlines_.append(ho_rect);
-            }
         }
         if (in_non_printable) {
-            addAsciiFormatRange(fmt_list, np_start, np_len, offset, max_tvb_pos, ModeNonPrintable);
+            cl.np_runs.append(qMakePair(np_start, np_len));
+        }
+    }
+
+    return line_cache_.insert(offset, cl).value();
+}
+
+// Draw a line of byte view text for a given offset.
+// Text highlighting is handled using QTextLayout::FormatRange.
+void ByteViewText::drawLine(QPainter *painter, const int offset, const int row_y)
+{
+    if (isEmpty()) {
+        return;
+    }
+
+    const CachedLine &cl = cachedLine(offset);
+    int max_tvb_pos = qMin(offset + row_width_, (int) data_.count()) - 1;
+    QList<QTextLayout::FormatRange> fmt_list;
+    HighlightMode offset_mode = ModeOffsetNormal;
+
+    if (show_hex_) {
+        addHexFormatRange(fmt_list, proto_start_, proto_len_, offset, max_tvb_pos, ModeProtocol);
+        if (addHexFormatRange(fmt_list, field_start_, field_len_, offset, max_tvb_pos, ModeField)) {
+            offset_mode = ModeOffsetField;
+        }
+        addHexFormatRange(fmt_list, field_a_start_, field_a_len_, offset, max_tvb_pos, ModeField);
+    }
+
+    if (show_ascii_) {
+        for (int i = 0; i < cl.np_runs.size(); i++) {
+            addAsciiFormatRange(fmt_list, cl.np_runs[i].first, cl.np_runs[i].second, offset, max_tvb_pos, ModeNonPrintable);
         }
         addAsciiFormatRange(fmt_list, proto_start_, proto_len_, offset, max_tvb_pos, ModeProtocol);
         if (addAsciiFormatRange(fmt_list, field_start_, field_len_, offset, max_tvb_pos, ModeField)) {
@@ -501,9 +539,39 @@ void ByteViewText::drawLine(QPainter *painter, const int offset, const int row_y
     // XXX Fields won't be highlighted if neither hex nor ascii are enabled.
     addFormatRange(fmt_list, 0, offsetChars(), offset_mode);
 
+    // Outline the hovered or marked byte if it's on this line. Its
+    // position follows from the fixed line geometry (the same math as
+    // addHexFormatRange and addAsciiFormatRange), so the cached text
+    // doesn't have to be rebuilt when the hover moves.
+    int active_byte = marked_byte_offset_ >= 0 ? marked_byte_offset_ : hovered_byte_offset_;
+    if (active_byte >= offset && active_byte <= max_tvb_pos) {
+        int col = active_byte - offset;
+        if (show_hex_) {
+            int chars_per_byte = recent.gui_bytes_view == BYTES_HEX ? 2 : 8;
+            int end_chars = offsetChars() + 1
+                    + (col / separator_interval_)
+                    + (col * (chars_per_byte + 1))
+                    + chars_per_byte;
+            QRect ho_rect = painter->boundingRect(QRect(), Qt::AlignHCenter|Qt::AlignVCenter,
+                                                  cl.text.mid(end_chars - chars_per_byte, chars_per_byte));
+            ho_rect.moveRight(stringWidth(cl.text.left(end_chars)));
+            ho_rect.moveTop(row_y);
+            hover_outlines_.append(ho_rect);
+        }
+        if (show_ascii_) {
+            int end_chars = offsetChars() + DataPrinter::hexChars() + 3
+                    + (col / separator_interval_)
+                    + col + 1;
+            QRect ho_rect = painter->boundingRect(QRect(), 0, cl.text.mid(end_chars - 1, 1));
+            ho_rect.moveRight(stringWidth(cl.text.left(end_chars)));
+            ho_rect.moveTop(row_y);
+            hover_outlines_.append(ho_rect);
+        }
+    }
+
     layout_->clearLayout();
     layout_->clearFormats();
-    layout_->setText(line);
+    layout_->setText(cl.text);
     layout_->setFormats(fmt_list.toVector());
     layout_->beginLayout();
     QTextLine tl = layout_->createLine();
@@ -16,8 +16,9 @@
 
 #include <QAbstractScrollArea>
 #include <QFont>
-#include <QVector>
+#include <QHash>
 #include <QMenu>
+#include <QPair>
 #include <QSize>
 #include <QString>
 #include <QTextLayout>
@@ -77,6 +78,20 @@ private:
     QTextLayout *layout_;
     const QByteArray data_;
 
+    // A rendered line of text. The text for a line depends only on the
+    // data and the display settings, not on the current selection or
+    // hover, so it's built once and reused across repaints. The
+    // non-printable byte runs found while building the ASCII section are
+    // kept alongside the text so drawLine can reapply their format
+    // without rescanning the bytes.
+    struct CachedLine {
+        QString text;
+        QVector<QPair<int, int> > np_runs; // Non-printable runs: offset, length
+    };
+    QHash<int, CachedLine> line_cache_;
+    const CachedLine &cachedLine(int offset);
+    void invalidateLineCache();
+
     void updateLayoutMetrics();
     int stringWidth(const QString &line);
     void drawLine(QPainter *painter, const int offset, const int row_y);
@@ -98,6 +113,7 @@ private:
     const QByteArray printableData() { return data_; }
 
     static const int separator_interval_;
+    static const int max_cached_lines_;
 
     // Colors
     QColor offset_normal_fg_;
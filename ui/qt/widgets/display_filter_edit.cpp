@@ -520,24 +520,35 @@ void DisplayFilterEdit::buildCompletionList(const QString &field_word)
         protocol_t *protocol = find_protocol_by_id(proto_id);
         if (!proto_is_protocol_enabled(protocol)) continue;
 
-        const QString pfname = proto_get_protocol_filter_name(proto_id);
-        field_list << pfname;
-
-        // Add fields only if we're past the protocol name and only for the
-        // current protocol.
-        if (field_dots > pfname.count('.')) {
-            void *field_cookie;
-            const QByteArray fw_ba = field_word.toUtf8(); // or toLatin1 or toStdString?
-            const char *fw_utf8 = fw_ba.constData();
-            gsize fw_len = (gsize) strlen(fw_utf8);
-            for (header_field_info *hfinfo = proto_get_first_protocol_field(proto_id, &field_cookie); hfinfo; hfinfo = proto_get_next_protocol_field(proto_id, &field_cookie)) {
-                if (hfinfo->same_name_prev_id != -1) continue; // Ignore duplicate names.
-
-                if (!g_ascii_strncasecmp(fw_utf8, hfinfo->abbrev, fw_len)) {
-                    if ((gsize) strlen(hfinfo->abbrev) != fw_len) field_list << hfinfo->abbrev;
-                }
+        field_list << proto_get_protocol_filter_name(proto_id);
+    }
+
+    // Add fields only if we're past a protocol name, and only the ones
+    // matching what was typed so far. The prefix index saves us from
+    // walking all 200k+ registered fields on every keystroke.
+    if (field_dots > 0) {
+        const QByteArray fw_ba = field_word.toUtf8(); // or toLatin1 or toStdString?
+        const char *fw_utf8 = fw_ba.constData();
+        gsize fw_len = (gsize) strlen(fw_utf8);
+        GPtrArray *matches = proto_registrar_get_abbrev_matches(fw_utf8);
+
+        for (guint i = 0; i < matches->len; i++) {
+            header_field_info *hfinfo = (header_field_info *) g_ptr_array_index(matches, i);
+
+            if (hfinfo->parent == -1) continue; // Protocols were added above.
+            if ((gsize) strlen(hfinfo->abbrev) == fw_len) continue; // Exactly what was typed.
+
+            protocol_t *protocol = find_protocol_by_id(hfinfo->parent);
+            if (!proto_is_protocol_enabled(protocol)) continue;
+
+            // Only complete past the protocol name ("tcp." gets fields,
+            // "tcp" doesn't).
+            const QString pfname = proto_get_protocol_filter_name(hfinfo->parent);
+            if (field_dots > pfname.count('.')) {
+                field_list << hfinfo->abbrev;
             }
         }
+        g_ptr_array_free(matches, TRUE);
     }
     field_list.sort();
 
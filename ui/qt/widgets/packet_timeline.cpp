@@ -0,0 +1,182 @@
+/* packet_timeline.cpp
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <ui/qt/widgets/packet_timeline.h>
+
+#include <epan/frame_data_sequence.h>
+
+#include <wsutil/nstime.h>
+
+#include <QMouseEvent>
+#include <QPainter>
+
+// The density pyramid, coarsest first. Levels whose bin count would
+// exceed max_level_bins_ for the capture's time span are not built, so
+// memory stays bounded for very long captures.
+static const double level_bin_secs_[] = { 1.0, 0.1, 0.01 };
+static const int max_level_bins_ = 2000000;
+
+PacketTimeline::PacketTimeline(QWidget *parent) :
+    QWidget(parent),
+    cap_file_(NULL),
+    start_secs_(0.0),
+    span_secs_(0.0)
+{
+}
+
+void PacketTimeline::setCaptureFile(capture_file *cf)
+{
+    cap_file_ = cf;
+    if (!cf) clear();
+}
+
+void PacketTimeline::captureFileReadFinished()
+{
+    levels_.clear();
+
+    if (!cap_file_ || cap_file_->state != FILE_READ_DONE ||
+            cap_file_->count < 1 || !cap_file_->provider.frames) {
+        update();
+        return;
+    }
+
+    frame_data *first_frame = frame_data_sequence_find(cap_file_->provider.frames, 1);
+    frame_data *last_frame = frame_data_sequence_find(cap_file_->provider.frames, cap_file_->count);
+    if (!first_frame || !last_frame) {
+        update();
+        return;
+    }
+
+    start_secs_ = nstime_to_sec(&first_frame->abs_ts);
+    span_secs_ = nstime_to_sec(&last_frame->abs_ts) - start_secs_;
+    if (span_secs_ <= 0.0) span_secs_ = 0.001;
+
+    for (unsigned level = 0; level < G_N_ELEMENTS(level_bin_secs_); level++) {
+        int nbins = (int)(span_secs_ / level_bin_secs_[level]) + 1;
+        if (nbins > max_level_bins_) break;
+
+        TimelineLevel tl;
+        tl.bin_secs = level_bin_secs_[level];
+        tl.counts.fill(0, nbins);
+        tl.first_frame.fill(0, nbins);
+        levels_.append(tl);
+    }
+    if (levels_.isEmpty()) {
+        update();
+        return;
+    }
+
+    // A single pass over the frame table fills every level.
+    for (guint32 num = 1; num <= cap_file_->count; num++) {
+        frame_data *fdata = frame_data_sequence_find(cap_file_->provider.frames, num);
+        double t = nstime_to_sec(&fdata->abs_ts) - start_secs_;
+
+        for (int level = 0; level < levels_.size(); level++) {
+            TimelineLevel &tl = levels_[level];
+            int bin = (int)(t / tl.bin_secs);
+            if (bin < 0) bin = 0;
+            if (bin >= tl.counts.size()) bin = tl.counts.size() - 1;
+            tl.counts[bin]++;
+            if (tl.first_frame[bin] == 0) tl.first_frame[bin] = num;
+        }
+    }
+
+    update();
+}
+
+void PacketTimeline::clear()
+{
+    levels_.clear();
+    update();
+}
+
+QSize PacketTimeline::sizeHint() const
+{
+    return QSize(0, fontMetrics().height() * 2);
+}
+
+// Pick the finest level that still has at least one bin per pixel, so
+// each drawn column aggregates whole bins. Short captures fall back to
+// the finest level we have.
+const PacketTimeline::TimelineLevel *PacketTimeline::levelForWidth(int width) const
+{
+    for (int level = levels_.size() - 1; level > 0; level--) {
+        if (levels_[level].counts.size() >= width) {
+            return &levels_[level];
+        }
+    }
+    return levels_.isEmpty() ? NULL : &levels_[levels_.size() - 1];
+}
+
+void PacketTimeline::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    int w = width();
+    int h = height();
+
+    painter.fillRect(rect(), palette().base());
+    painter.setPen(palette().mid().color());
+    painter.drawLine(0, 0, w, 0);
+
+    const TimelineLevel *tl = levelForWidth(w);
+    if (!tl || w < 1) return;
+
+    int nbins = tl->counts.size();
+    QVector<guint64> column_counts(w, 0);
+    guint64 max_count = 0;
+
+    for (int x = 0; x < w; x++) {
+        int bin_lo = (int)((gint64)x * nbins / w);
+        int bin_hi = (int)((gint64)(x + 1) * nbins / w);
+        if (bin_hi <= bin_lo) bin_hi = bin_lo + 1;
+        for (int bin = bin_lo; bin < bin_hi && bin < nbins; bin++) {
+            column_counts[x] += tl->counts[bin];
+        }
+        if (column_counts[x] > max_count) max_count = column_counts[x];
+    }
+    if (max_count < 1) return;
+
+    painter.setPen(palette().highlight().color());
+    for (int x = 0; x < w; x++) {
+        if (column_counts[x] < 1) continue;
+        int bar_h = (int)(column_counts[x] * (guint64)(h - 2) / max_count);
+        if (bar_h < 1) bar_h = 1;
+        painter.drawLine(x, h - 1, x, h - 1 - bar_h);
+    }
+
+    // Mark the selected packet's place in time.
+    if (cap_file_ && cap_file_->current_frame) {
+        double t = nstime_to_sec(&cap_file_->current_frame->abs_ts) - start_secs_;
+        int x = (int)(t / span_secs_ * w);
+        if (x < 0) x = 0;
+        if (x >= w) x = w - 1;
+        painter.setPen(palette().text().color());
+        painter.drawLine(x, 1, x, h - 1);
+    }
+}
+
+void PacketTimeline::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) return;
+
+    const TimelineLevel *tl = levelForWidth(width());
+    if (!tl || width() < 1) return;
+
+    int nbins = tl->counts.size();
+    int bin = (int)((gint64)event->pos().x() * nbins / width());
+    if (bin < 0) bin = 0;
+
+    // Seek to the first packet at or after the clicked time.
+    for (; bin < nbins; bin++) {
+        if (tl->first_frame[bin] != 0) {
+            emit goToPacket((int)tl->first_frame[bin]);
+            return;
+        }
+    }
+}
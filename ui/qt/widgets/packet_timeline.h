@@ -0,0 +1,64 @@
+/* packet_timeline.h
+ * A capture overview strip for the packet list: packet density over time
+ * at pre-computed multi-resolution levels, with click-to-seek.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __PACKET_TIMELINE_H__
+#define __PACKET_TIMELINE_H__
+
+#include <config.h>
+
+#include <glib.h>
+
+#include "cfile.h"
+
+#include <QVector>
+#include <QWidget>
+
+class PacketTimeline : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PacketTimeline(QWidget *parent = 0);
+
+    void setCaptureFile(capture_file *cf);
+    // Build the density pyramid from the frame table. Call when the
+    // capture file has been fully read.
+    void captureFileReadFinished();
+    void clear();
+    bool hasData() const { return !levels_.isEmpty(); }
+
+    QSize sizeHint() const override;
+
+signals:
+    void goToPacket(int packet);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    // One pyramid level: packet counts and the first frame number of each
+    // fixed-duration time bin.
+    struct TimelineLevel {
+        double bin_secs;
+        QVector<guint32> counts;
+        QVector<guint32> first_frame;
+    };
+
+    const TimelineLevel *levelForWidth(int width) const;
+
+    capture_file *cap_file_;
+    QVector<TimelineLevel> levels_;
+    double start_secs_;
+    double span_secs_;
+};
+
+#endif // __PACKET_TIMELINE_H__
@@ -24,7 +24,9 @@
 #include "epan/column-utils.h"
 #include "epan/disabled_protos.h"
 #include "epan/ftypes/ftypes.h"
+#include "epan/packet.h"
 #include "epan/prefs.h"
+#include "epan/prefs-int.h"
 #include "epan/proto.h"
 #include "epan/tap.h"
 #include "epan/timestamp.h"
@@ -375,6 +377,9 @@ void WiresharkApplication::setConfigurationProfile(const gchar *profile_name, bo
 
     gboolean prev_capture_no_interface_load;
     gboolean prev_capture_no_extcap;
+    guint prev_proto_hash;
+    guint prev_heur_hash;
+    unsigned int changed_flags;
 
     /* First check if profile exists */
     if (!profile_exists(profile_name, FALSE)) {
@@ -412,6 +417,8 @@ void WiresharkApplication::setConfigurationProfile(const gchar *profile_name, bo
 
     prev_capture_no_interface_load = prefs.capture_no_interface_load;
     prev_capture_no_extcap = prefs.capture_no_extcap;
+    prev_proto_hash = proto_enabled_state_hash();
+    prev_heur_hash = heur_dissectors_enabled_state_hash();
 
     /* Get the current geometry, before writing it to disk */
     emit profileChanging();
@@ -445,7 +452,7 @@ void WiresharkApplication::setConfigurationProfile(const gchar *profile_name, bo
     tap_update_timer_.setInterval(prefs.tap_update_interval);
 
     prefs_to_capture_opts();
-    prefs_apply_all();
+    changed_flags = prefs_apply_all();
 #ifdef HAVE_LIBPCAP
     update_local_interfaces();
 #endif
@@ -474,7 +481,21 @@ void WiresharkApplication::setConfigurationProfile(const gchar *profile_name, bo
     }
 
     emit localInterfaceListChanged();
-    emit packetDissectionChanged();
+
+    /* Only redissect if the new profile can actually dissect the capture
+       differently: a preference with a dissection or field effect
+       changed, or the set of enabled protocols or heuristic dissectors
+       did.  Switching between cosmetically different profiles keeps the
+       current dissection. */
+    if ((changed_flags & (PREF_EFFECT_DISSECTION | PREF_EFFECT_FIELDS)) ||
+        prev_proto_hash != proto_enabled_state_hash() ||
+        prev_heur_hash != heur_dissectors_enabled_state_hash()) {
+        emit packetDissectionChanged();
+    } else {
+        /* Redissection recolors as a side effect; without it the
+           reloaded coloring rules have to be applied explicitly. */
+        emit colorsChanged();
+    }
 
     /* Write recent_common file to ensure last used profile setting is stored. */
     write_recent();
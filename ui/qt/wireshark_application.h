@@ -186,6 +186,7 @@ signals:
     void displayFilterListChanged();
     void filterExpressionsChanged();
     void packetDissectionChanged();
+    void colorsChanged();
     void preferencesChanged();
     void addressResolutionChanged();
     void columnDataChanged();
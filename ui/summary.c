@@ -26,6 +26,12 @@
 
 #define HASH_BUF_SIZE (1024 * 1024)
 
+/* Running per-frame aggregates; see the comments in summary.h.  Only
+   the per-frame tally members of the summary_tally are used. */
+struct summary_stats_live {
+    summary_tally st;
+};
+
 static void
 tally_frame_data(frame_data *cur_frame, summary_tally *sum_tally)
 {
@@ -49,11 +55,20 @@ tally_frame_data(frame_data *cur_frame, summary_tally *sum_tally)
         cur_time = nstime_to_sec(&cur_frame->abs_ts);
 
         sum_tally->packet_count_ts++;
-        if (cur_time < sum_tally->start_time) {
+        /*
+         * If this is the first time-stamped packet, it starts and
+         * stops the capture as far as we know at this point.
+         */
+        if (sum_tally->packet_count_ts == 1){
             sum_tally->start_time = cur_time;
-        }
-        if (cur_time > sum_tally->stop_time){
             sum_tally->stop_time = cur_time;
+        } else {
+            if (cur_time < sum_tally->start_time) {
+                sum_tally->start_time = cur_time;
+            }
+            if (cur_time > sum_tally->stop_time){
+                sum_tally->stop_time = cur_time;
+            }
         }
         if (cur_frame->passed_dfilter){
             sum_tally->filtered_count_ts++;
@@ -61,7 +76,7 @@ tally_frame_data(frame_data *cur_frame, summary_tally *sum_tally)
              * If we've seen one filtered packet, this is the first
              * one.
              */
-            if (sum_tally->filtered_count == 1){
+            if (sum_tally->filtered_count_ts == 1){
                 sum_tally->filtered_start= cur_time;
                 sum_tally->filtered_stop = cur_time;
             } else {
@@ -79,7 +94,7 @@ tally_frame_data(frame_data *cur_frame, summary_tally *sum_tally)
              * If we've seen one marked packet, this is the first
              * one.
              */
-            if (sum_tally->marked_count == 1){
+            if (sum_tally->marked_count_ts == 1){
                 sum_tally->marked_start= cur_time;
                 sum_tally->marked_stop = cur_time;
             } else {
@@ -106,7 +121,7 @@ hash_to_str(const unsigned char *hash, size_t length, char *str) {
 void
 summary_fill_in(capture_file *cf, summary_tally *st)
 {
-    frame_data    *first_frame, *cur_frame;
+    frame_data    *cur_frame;
     guint32        framenum;
     iface_summary_info iface;
     guint i;
@@ -141,13 +156,33 @@ summary_fill_in(capture_file *cf, summary_tally *st)
 
     /* initialize the tally */
     if (cf->count != 0) {
-        first_frame = frame_data_sequence_find(cf->provider.frames, 1);
-        st->start_time = nstime_to_sec(&first_frame->abs_ts);
-        st->stop_time = nstime_to_sec(&first_frame->abs_ts);
+        if (cf->sstats_live != NULL) {
+            /* The aggregates were maintained while the frames were
+               loaded; read them instead of walking the whole frame
+               table.  The marked and ignored counts are authoritative
+               on the capture_file itself. */
+            const summary_tally *live = &cf->sstats_live->st;
 
-        for (framenum = 1; framenum <= cf->count; framenum++) {
-            cur_frame = frame_data_sequence_find(cf->provider.frames, framenum);
-            tally_frame_data(cur_frame, st);
+            st->bytes             = live->bytes;
+            st->packet_count_ts   = live->packet_count_ts;
+            st->start_time        = live->start_time;
+            st->stop_time         = live->stop_time;
+            st->filtered_count    = live->filtered_count;
+            st->filtered_count_ts = live->filtered_count_ts;
+            st->filtered_bytes    = live->filtered_bytes;
+            st->filtered_start    = live->filtered_start;
+            st->filtered_stop     = live->filtered_stop;
+            st->marked_count_ts   = live->marked_count_ts;
+            st->marked_bytes      = live->marked_bytes;
+            st->marked_start      = live->marked_start;
+            st->marked_stop       = live->marked_stop;
+            st->marked_count      = cf->marked_count;
+            st->ignored_count     = cf->ignored_count;
+        } else {
+            for (framenum = 1; framenum <= cf->count; framenum++) {
+                cur_frame = frame_data_sequence_find(cf->provider.frames, framenum);
+                tally_frame_data(cur_frame, st);
+            }
         }
     }
 
@@ -238,6 +273,82 @@ summary_fill_in(capture_file *cf, summary_tally *st)
     gcry_md_close(hd);
 }
 
+void
+summary_stats_live_reset(capture_file *cf)
+{
+    summary_stats_live_invalidate(cf);
+
+    cf->sstats_live = g_new0(struct summary_stats_live, 1);
+}
+
+void
+summary_stats_live_invalidate(capture_file *cf)
+{
+    if (cf->sstats_live == NULL)
+        return;
+
+    g_free(cf->sstats_live);
+    cf->sstats_live = NULL;
+}
+
+void
+summary_stats_live_add(capture_file *cf, frame_data *fdata)
+{
+    if (cf->sstats_live == NULL)
+        return;
+
+    tally_frame_data(fdata, &cf->sstats_live->st);
+}
+
+void
+summary_stats_live_mark(capture_file *cf, frame_data *fdata, gboolean marked)
+{
+    summary_tally *st;
+    double cur_time;
+
+    if (cf->sstats_live == NULL)
+        return;
+
+    st = &cf->sstats_live->st;
+    if (marked) {
+        st->marked_count++;
+        st->marked_bytes += fdata->pkt_len;
+        if (fdata->has_ts) {
+            cur_time = nstime_to_sec(&fdata->abs_ts);
+            st->marked_count_ts++;
+            if (st->marked_count_ts == 1) {
+                st->marked_start = cur_time;
+                st->marked_stop = cur_time;
+            } else {
+                if (cur_time < st->marked_start) {
+                    st->marked_start = cur_time;
+                }
+                if (cur_time > st->marked_stop) {
+                    st->marked_stop = cur_time;
+                }
+            }
+        }
+    } else {
+        st->marked_count--;
+        st->marked_bytes -= fdata->pkt_len;
+        if (fdata->has_ts) {
+            cur_time = nstime_to_sec(&fdata->abs_ts);
+            st->marked_count_ts--;
+            if (st->marked_count_ts == 0) {
+                st->marked_start = 0;
+                st->marked_stop = 0;
+            } else if (cur_time <= st->marked_start ||
+                       cur_time >= st->marked_stop) {
+                /* This may have been the earliest or latest marked
+                   frame; a running minimum or maximum can't be shrunk,
+                   so give up and let summary_fill_in() walk the frame
+                   table. */
+                summary_stats_live_invalidate(cf);
+            }
+        }
+    }
+}
+
 #ifdef HAVE_LIBPCAP
 void
 summary_fill_in_capture(capture_file *cf,capture_options *capture_opts, summary_tally *st)
@@ -74,6 +74,38 @@ typedef struct _summary_tally {
 extern void
 summary_fill_in(capture_file *cf, summary_tally *st);
 
+/*
+ * Incrementally maintained per-frame aggregates.
+ *
+ * file.c restarts this accumulator whenever a pass over every frame
+ * begins (initial load, refiltering, redissection) and feeds it each
+ * frame as the frame's filter result is settled, so the byte totals,
+ * time bounds and filtered/marked tallies summary_fill_in() needs are
+ * running sums.  While the accumulator is alive, summary_fill_in()
+ * reads them instead of walking the whole frame table, so the capture
+ * file properties dialog opens in constant time regardless of the
+ * number of frames.
+ */
+
+/** Restart the accumulator; a pass over every frame is beginning. */
+extern void
+summary_stats_live_reset(capture_file *cf);
+
+/** Account for one frame whose display filter result is settled. */
+extern void
+summary_stats_live_add(capture_file *cf, frame_data *fdata);
+
+/** Account for a frame being marked or unmarked. */
+extern void
+summary_stats_live_mark(capture_file *cf, frame_data *fdata, gboolean marked);
+
+/** Drop the accumulator; the aggregates can no longer be kept in step
+ * with the frames (e.g. a pass was aborted, or the timestamps were
+ * shifted).  summary_fill_in() then falls back to walking the frame
+ * table. */
+extern void
+summary_stats_live_invalidate(capture_file *cf);
+
 #ifdef HAVE_LIBPCAP
 extern void
 summary_fill_in_capture(capture_file *cf, capture_options *capture_opts, summary_tally *st);
@@ -158,6 +158,109 @@ get_dyn_pt_clock_rate(const gchar *payload_type_str)
 
 #define TIMESTAMP_DIFFERENCE(v1,v2) ((gint64)v2-(gint64)v1)
 
+/****************************************************************************/
+/* P-square streaming quantile estimator (Jain & Chlamtac, CACM 1985).
+ * Five markers track the minimum, the p/2, p and (1+p)/2 quantiles and the
+ * maximum; marker heights are nudged towards their desired positions with
+ * a piecewise-parabolic prediction as observations arrive. Memory use is
+ * constant regardless of stream length.
+ */
+void
+p2_quantile_init(p2_quantile_t *p2, double p)
+{
+    memset(p2, 0, sizeof *p2);
+    p2->p = p;
+}
+
+void
+p2_quantile_add(p2_quantile_t *p2, double value)
+{
+    int i, k;
+
+    if (p2->count < 5) {
+        /* First five observations: insertion sort into the marker heights. */
+        i = p2->count++;
+        while (i > 0 && p2->q[i-1] > value) {
+            p2->q[i] = p2->q[i-1];
+            i--;
+        }
+        p2->q[i] = value;
+        if (p2->count == 5) {
+            for (i = 0; i < 5; i++) {
+                p2->n[i] = i + 1;
+            }
+            p2->n_des[0] = 1.0;
+            p2->n_des[1] = 1.0 + 2.0 * p2->p;
+            p2->n_des[2] = 1.0 + 4.0 * p2->p;
+            p2->n_des[3] = 3.0 + 2.0 * p2->p;
+            p2->n_des[4] = 5.0;
+        }
+        return;
+    }
+
+    /* Find the cell the observation falls into, widening the extreme
+     * markers if it falls outside them. */
+    if (value < p2->q[0]) {
+        p2->q[0] = value;
+        k = 0;
+    } else if (value >= p2->q[4]) {
+        p2->q[4] = value;
+        k = 3;
+    } else {
+        for (k = 0; k < 3; k++) {
+            if (value < p2->q[k+1])
+                break;
+        }
+    }
+
+    for (i = k + 1; i < 5; i++) {
+        p2->n[i] += 1.0;
+    }
+    p2->count++;
+
+    p2->n_des[1] += p2->p / 2.0;
+    p2->n_des[2] += p2->p;
+    p2->n_des[3] += (1.0 + p2->p) / 2.0;
+    p2->n_des[4] += 1.0;
+
+    /* Adjust the inner markers towards their desired positions. */
+    for (i = 1; i <= 3; i++) {
+        double d = p2->n_des[i] - p2->n[i];
+
+        if ((d >= 1.0 && p2->n[i+1] - p2->n[i] > 1.0) ||
+            (d <= -1.0 && p2->n[i-1] - p2->n[i] < -1.0)) {
+            double sign = (d >= 0.0) ? 1.0 : -1.0;
+            double qn;
+
+            /* Piecewise-parabolic prediction */
+            qn = p2->q[i] + sign / (p2->n[i+1] - p2->n[i-1]) *
+                ((p2->n[i] - p2->n[i-1] + sign) * (p2->q[i+1] - p2->q[i]) / (p2->n[i+1] - p2->n[i]) +
+                 (p2->n[i+1] - p2->n[i] - sign) * (p2->q[i] - p2->q[i-1]) / (p2->n[i] - p2->n[i-1]));
+            if (p2->q[i-1] < qn && qn < p2->q[i+1]) {
+                p2->q[i] = qn;
+            } else {
+                /* Prediction left the bracket; fall back to linear. */
+                int j = (sign > 0.0) ? i + 1 : i - 1;
+                p2->q[i] += sign * (p2->q[j] - p2->q[i]) / (p2->n[j] - p2->n[i]);
+            }
+            p2->n[i] += sign;
+        }
+    }
+}
+
+double
+p2_quantile_estimate(const p2_quantile_t *p2)
+{
+    if (p2->count == 0)
+        return 0.0;
+    if (p2->count < 5) {
+        /* Too few observations for the markers; the heights are still a
+         * sorted sample, so read the quantile from it directly. */
+        return p2->q[(guint32)(p2->p * (p2->count - 1) + 0.5)];
+    }
+    return p2->q[2];
+}
+
 /****************************************************************************/
 void
 rtppacket_analyse(tap_rtp_stat_t *statinfo,
@@ -211,6 +314,9 @@ rtppacket_analyse(tap_rtp_stat_t *statinfo,
         statinfo->min_jitter = -1;
         statinfo->max_jitter = 0;
         statinfo->diff = 0;
+        statinfo->delta_m2 = 0;
+        statinfo->jitter_m2 = 0;
+        p2_quantile_init(&statinfo->jitter_p2, 0.95);
 
         statinfo->total_nr++;
         statinfo->flags |= STAT_FLAG_FIRST;
@@ -475,7 +581,11 @@ rtppacket_analyse(tap_rtp_stat_t *statinfo,
          * handled, that logic increments total_nr from 0 to 1; here, it is
          * always >=1 .
          */
+        double prev_mean_delta = statinfo->mean_delta;
         statinfo->mean_delta = (statinfo->mean_delta*(statinfo->total_nr-1) + statinfo->delta) / statinfo->total_nr;
+        /* Welford's online variance update; with the running mean above
+         * this keeps the delta distribution in constant memory. */
+        statinfo->delta_m2 += (statinfo->delta - prev_mean_delta) * (statinfo->delta - statinfo->mean_delta);
 
         if (clock_rate != 0) {
             /* Maximum and mean jitter calculation */
@@ -494,7 +604,10 @@ rtppacket_analyse(tap_rtp_stat_t *statinfo,
              * handled, that logic increments total_nr from 0 to 1; here, it is
              * always >=1 .
              */
+            double prev_mean_jitter = statinfo->mean_jitter;
             statinfo->mean_jitter = (statinfo->mean_jitter*(statinfo->total_nr-1) + current_diff) / statinfo->total_nr;
+            statinfo->jitter_m2 += (current_diff - prev_mean_jitter) * (current_diff - statinfo->mean_jitter);
+            p2_quantile_add(&statinfo->jitter_p2, statinfo->jitter);
 
             /* Minimum jitter calculation */
             if (statinfo->min_jitter == -1 ) {
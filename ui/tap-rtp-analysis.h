@@ -39,6 +39,19 @@ typedef struct _bw_history_item {
 
 #define BUFF_BW 300
 
+/* State of the P-square algorithm (Jain & Chlamtac, 1985): a streaming
+ * estimator of a single quantile that keeps five markers instead of the
+ * observations themselves, so memory stays constant however long the
+ * stream runs.
+ */
+typedef struct _p2_quantile {
+    double          p;        /**< quantile to track, e.g. 0.95 */
+    double          q[5];     /**< marker heights */
+    double          n[5];     /**< marker positions */
+    double          n_des[5]; /**< desired marker positions */
+    guint32         count;    /**< observations seen so far */
+} p2_quantile_t;
+
 typedef struct _tap_rtp_stat_t {
     gboolean        first_packet; /**< do not use in code that is called after rtppacket_analyse */
                                /* use (flags & STAT_FLAG_FIRST) instead */
@@ -73,6 +86,9 @@ typedef struct _tap_rtp_stat_t {
     double          max_jitter;
     double          max_skew;
     double          mean_jitter;
+    double          delta_m2;   /**< Welford variance accumulator for delta */
+    double          jitter_m2;  /**< Welford variance accumulator for jitter */
+    p2_quantile_t   jitter_p2;  /**< streaming 95th percentile of jitter */
     guint32         max_nr;
     guint16         start_seq_nr;
     guint16         stop_seq_nr;
@@ -114,6 +130,11 @@ extern void rtppacket_analyse(tap_rtp_stat_t *statinfo,
                               const packet_info *pinfo,
                               const struct _rtp_info *rtpinfo);
 
+/* streaming quantile estimator (P-square algorithm, constant memory) */
+extern void p2_quantile_init(p2_quantile_t *p2, double p);
+extern void p2_quantile_add(p2_quantile_t *p2, double value);
+extern double p2_quantile_estimate(const p2_quantile_t *p2);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -477,6 +477,16 @@ void rtpstream_info_calculate(const rtpstream_info_t *strinfo, rtpstream_info_ca
         calc->min_jitter = strinfo->rtp_stats.min_jitter;
         calc->max_jitter = strinfo->rtp_stats.max_jitter;
         calc->mean_jitter = strinfo->rtp_stats.mean_jitter;
+        /* Sample variance needs at least two deltas; total_nr counts the
+         * first packet too, which contributes no delta. */
+        if (strinfo->rtp_stats.total_nr > 2) {
+                calc->stdev_delta = sqrt(strinfo->rtp_stats.delta_m2 / (strinfo->rtp_stats.total_nr - 2));
+                calc->stdev_jitter = sqrt(strinfo->rtp_stats.jitter_m2 / (strinfo->rtp_stats.total_nr - 2));
+        } else {
+                calc->stdev_delta = 0.0;
+                calc->stdev_jitter = 0.0;
+        }
+        calc->p95_jitter = p2_quantile_estimate(&strinfo->rtp_stats.jitter_p2);
         calc->max_skew = strinfo->rtp_stats.max_skew;
         calc->problem = strinfo->problem;
         sumt = strinfo->rtp_stats.sumt;
@@ -62,6 +62,9 @@ typedef struct _rtpstream_info_calc {
     double max_jitter;
     double max_skew;
     double mean_jitter;
+    double stdev_delta;
+    double stdev_jitter;
+    double p95_jitter;   /* streaming 95th percentile jitter estimate */
     gboolean problem; /* Indication that RTP stream contains something unusual -GUI should indicate it somehow */
     double clock_drift_ms;
     double freq_drift_hz;
@@ -44,18 +44,46 @@ free_first(gpointer data, gpointer user_data _U_)
 }
 
 static void
-tsn_free(gpointer data)
+chunk_store_init(sctp_chunk_store_t *store)
 {
-    tsn_t *tsn;
+    store->bytes = g_byte_array_new();
+    store->recs  = g_array_new(FALSE, FALSE, sizeof(sctp_chunk_rec_t));
+}
 
-    tsn = (tsn_t *) data;
-    if (tsn->tsns != NULL)
+static void
+chunk_store_clear(sctp_chunk_store_t *store)
+{
+    if (store->bytes != NULL)
+    {
+        g_byte_array_free(store->bytes, TRUE);
+        store->bytes = NULL;
+    }
+    if (store->recs != NULL)
     {
-        g_list_free_full(tsn->tsns, g_free);
+        g_array_free(store->recs, TRUE);
+        store->recs = NULL;
     }
-    free_address(&tsn->src);
-    free_address(&tsn->dst);
-    g_free(tsn);
+}
+
+/* Append a copy of the first length bytes of the chunk to the store,
+ * together with the metadata record describing it.
+ */
+static void
+chunk_store_add(sctp_chunk_store_t *store, tvbuff_t *tvb, guint32 length,
+                guint32 frame_number, guint32 secs, guint32 usecs, guint32 tsnumber)
+{
+    sctp_chunk_rec_t rec;
+
+    rec.frame_number = frame_number;
+    rec.secs   = secs;
+    rec.usecs  = usecs;
+    rec.offset = store->bytes->len;
+    rec.length = length;
+    rec.tsn    = tsnumber;
+    rec.type   = tvb_get_guint8(tvb, 0);
+    g_byte_array_set_size(store->bytes, rec.offset + length);
+    tvb_memcpy(tvb, store->bytes->data + rec.offset, 0, length);
+    g_array_append_val(store->recs, rec);
 }
 
 static void
@@ -112,41 +140,22 @@ reset(void *arg)
             info->frame_numbers = NULL;
         }
 
-        if (info->tsn1 != NULL)
-        {
-            g_list_free_full(info->tsn1, tsn_free);
-            info->tsn1 = NULL;
-        }
-
-        if (info->tsn2 != NULL)
-        {
-            g_list_free_full(info->tsn2, tsn_free);
-            info->tsn2 = NULL;
-        }
-
-        if (info->sack1 != NULL)
-        {
-            g_list_free_full(info->sack1, tsn_free);
-            info->sack1 = NULL;
-        }
-
-        if (info->sack2 != NULL)
-        {
-            g_list_free_full(info->sack2, tsn_free);
-            info->sack2 = NULL;
-        }
+        chunk_store_clear(&info->tsn_store1);
+        chunk_store_clear(&info->tsn_store2);
+        chunk_store_clear(&info->sack_store1);
+        chunk_store_clear(&info->sack_store2);
 
         if (info->sort_tsn1 != NULL)
-            g_ptr_array_free(info->sort_tsn1, TRUE);
+            g_array_free(info->sort_tsn1, TRUE);
 
         if (info->sort_tsn2 != NULL)
-            g_ptr_array_free(info->sort_tsn2, TRUE);
+            g_array_free(info->sort_tsn2, TRUE);
 
         if (info->sort_sack1 != NULL)
-            g_ptr_array_free(info->sort_sack1, TRUE);
+            g_array_free(info->sort_sack1, TRUE);
 
         if (info->sort_sack2 != NULL)
-            g_ptr_array_free(info->sort_sack2, TRUE);
+            g_array_free(info->sort_sack2, TRUE);
 
         if (info->min_max != NULL)
         {
@@ -330,19 +339,16 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
     sctp_error_info_t *error = NULL;
     guint16 type, length = 0;
     address *store = NULL;
-    tsn_t *tsn = NULL;
-    tsn_t *sack = NULL;
-    guint8 *t_s_n = NULL;
-    gboolean sackchunk = FALSE;
     gboolean datachunk = FALSE;
     gboolean forwardchunk = FALSE;
-    struct tsn_sort *tsn_s;
+    struct tsn_sort tsn_s;
     int i;
     guint8 idx = 0;
-    gboolean tsn_used = FALSE;
-    gboolean sack_used = FALSE;
+    guint32 secs, usecs;
 
     framenumber = pinfo->num;
+    secs  = (guint32)pinfo->rel_ts.secs;
+    usecs = (guint32)pinfo->rel_ts.nsecs/1000;
 
     type = sctp_info->ip_src.type;
 
@@ -437,10 +443,14 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
             info->max_window1       = 0;
             info->max_window2       = 0;
             info->min_max           = NULL;
-            info->sort_tsn1         = g_ptr_array_new_with_free_func(g_free);
-            info->sort_tsn2         = g_ptr_array_new_with_free_func(g_free);
-            info->sort_sack1        = g_ptr_array_new_with_free_func(g_free);
-            info->sort_sack2        = g_ptr_array_new_with_free_func(g_free);
+            info->sort_tsn1         = g_array_new(FALSE, FALSE, sizeof(struct tsn_sort));
+            info->sort_tsn2         = g_array_new(FALSE, FALSE, sizeof(struct tsn_sort));
+            info->sort_sack1        = g_array_new(FALSE, FALSE, sizeof(struct tsn_sort));
+            info->sort_sack2        = g_array_new(FALSE, FALSE, sizeof(struct tsn_sort));
+            chunk_store_init(&info->tsn_store1);
+            chunk_store_init(&info->tsn_store2);
+            chunk_store_init(&info->sack_store1);
+            chunk_store_init(&info->sack_store2);
             info->dir1              = g_new0(sctp_init_collision_t, 1);
             info->dir1->init_min_tsn = 0xffffffff;
             info->dir1->initack_min_tsn = 0xffffffff;
@@ -456,48 +466,27 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
             }
             info->addr_chunk_count = NULL;
 
-            if (((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_INIT_CHUNK_ID) ||
-                    ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_INIT_ACK_CHUNK_ID) ||
-                    ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_DATA_CHUNK_ID) ||
+            if (((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_DATA_CHUNK_ID) ||
                     ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_I_DATA_CHUNK_ID) ||
                     ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_SACK_CHUNK_ID) ||
                     ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_NR_SACK_CHUNK_ID) ||
                     ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_FORWARD_TSN_CHUNK_ID))
             {
-                tsn = g_new0(tsn_t, 1);
-                copy_address(&tsn->src, &tmp_info.src);
-                copy_address(&tsn->dst, &tmp_info.dst);
-
-                sack = g_new0(tsn_t, 1);
-                copy_address(&sack->src, &tmp_info.src);
-                copy_address(&sack->dst, &tmp_info.dst);
-                sack->secs=tsn->secs   = (guint32)pinfo->rel_ts.secs;
-                sack->usecs=tsn->usecs = (guint32)pinfo->rel_ts.nsecs/1000;
-
-                if (((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_DATA_CHUNK_ID) ||
-                        ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_I_DATA_CHUNK_ID) ||
-                        ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_SACK_CHUNK_ID) ||
-                        ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_NR_SACK_CHUNK_ID) ||
-                        ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_FORWARD_TSN_CHUNK_ID))
+                if (secs < info->min_secs)
                 {
-                    if (tsn->secs < info->min_secs)
-                    {
-                        info->min_secs  = tsn->secs;
-                        info->min_usecs = tsn->usecs;
-                    }
-                    else if (tsn->secs == info->min_secs && tsn->usecs < info->min_usecs)
-                        info->min_usecs = tsn->usecs;
-
-                    if (tsn->secs > info->max_secs)
-                    {
-                        info->max_secs  = tsn->secs;
-                        info->max_usecs = tsn->usecs;
-                    }
-                    else if (tsn->secs == info->max_secs && tsn->usecs > info->max_usecs)
-                        info->max_usecs = tsn->usecs;
+                    info->min_secs  = secs;
+                    info->min_usecs = usecs;
                 }
+                else if (secs == info->min_secs && usecs < info->min_usecs)
+                    info->min_usecs = usecs;
 
-                sack->frame_number = tsn->frame_number = pinfo->num;
+                if (secs > info->max_secs)
+                {
+                    info->max_secs  = secs;
+                    info->max_usecs = usecs;
+                }
+                else if (secs == info->max_secs && usecs > info->max_usecs)
+                    info->max_usecs = usecs;
             }
             if ((tvb_get_guint8(sctp_info->tvb[0],0) == SCTP_INIT_CHUNK_ID) || (tvb_get_guint8(sctp_info->tvb[0],0) == SCTP_INIT_ACK_CHUNK_ID))
             {
@@ -564,17 +553,6 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
             }
             else
             {
-                if (((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_INIT_CHUNK_ID) &&
-                        ((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_INIT_ACK_CHUNK_ID) &&
-                        ((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_DATA_CHUNK_ID) &&
-                        ((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_I_DATA_CHUNK_ID) &&
-                        ((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_SACK_CHUNK_ID) &&
-                        ((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_NR_SACK_CHUNK_ID) &&
-                        ((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_FORWARD_TSN_CHUNK_ID))
-                {
-                    tsn = g_new0(tsn_t, 1);
-                    sack = g_new0(tsn_t, 1);
-                }
                 for (chunk_number = 0; chunk_number < sctp_info->number_of_tvbs; chunk_number++)
                 {
                     idx = tvb_get_guint8(sctp_info->tvb[0],0);
@@ -621,49 +599,38 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
                                 info->n_forward_chunks_ep1++;
                             info->max_tsn1 = tsnumber;
                         }
-                        if (tsn->first_tsn == 0)
-                            tsn->first_tsn = tsnumber;
-                        if (datachunk)
-                        {
-                            t_s_n = (guint8 *)g_malloc(16);
-                            tvb_memcpy(sctp_info->tvb[chunk_number], (guint8 *)(t_s_n),0, 16);
-                        }
-                        else
-                        {
-                            t_s_n = (guint8 *)g_malloc(length);
-                            tvb_memcpy(sctp_info->tvb[chunk_number], (guint8 *)(t_s_n),0, length);
-                        }
-                        tsn->tsns = g_list_append(tsn->tsns, t_s_n);
-                        tsn_s = g_new(struct tsn_sort, 1);
-                        tsn_s->tsnumber = tsnumber;
-                        tsn_s->secs     = tsn->secs = (guint32)pinfo->rel_ts.secs;
-                        tsn_s->usecs    = tsn->usecs = (guint32)pinfo->rel_ts.nsecs/1000;
-                        tsn_s->offset   = 0;
-                        tsn_s->framenumber = framenumber;
+                        chunk_store_add(&info->tsn_store1, sctp_info->tvb[chunk_number],
+                                        datachunk ? 16 : length,
+                                        framenumber, secs, usecs, tsnumber);
+                        tsn_s.tsnumber = tsnumber;
+                        tsn_s.secs     = secs;
+                        tsn_s.usecs    = usecs;
+                        tsn_s.offset   = 0;
+                        tsn_s.framenumber = framenumber;
                         if (datachunk)
                             if (tvb_get_guint8(sctp_info->tvb[chunk_number],0) == SCTP_DATA_CHUNK_ID) {
-                                tsn_s->length   = length - DATA_CHUNK_HEADER_LENGTH;
+                                tsn_s.length   = length - DATA_CHUNK_HEADER_LENGTH;
                             } else {
-                                tsn_s->length   = length - I_DATA_CHUNK_HEADER_LENGTH;
+                                tsn_s.length   = length - I_DATA_CHUNK_HEADER_LENGTH;
                             }
                             else
-                                tsn_s->length   = length;
-                        if (tsn->secs < info->min_secs)
+                                tsn_s.length   = length;
+                        if (secs < info->min_secs)
                         {
-                            info->min_secs  = tsn->secs;
-                            info->min_usecs = tsn->usecs;
+                            info->min_secs  = secs;
+                            info->min_usecs = usecs;
                         }
-                        else if (tsn->secs == info->min_secs && tsn->usecs < info->min_usecs)
-                            info->min_usecs = tsn->usecs;
+                        else if (secs == info->min_secs && usecs < info->min_usecs)
+                            info->min_usecs = usecs;
 
-                        if (tsn->secs > info->max_secs)
+                        if (secs > info->max_secs)
                         {
-                            info->max_secs  = tsn->secs;
-                            info->max_usecs = tsn->usecs;
+                            info->max_secs  = secs;
+                            info->max_usecs = usecs;
                         }
-                        else if (tsn->secs == info->max_secs && tsn->usecs > info->max_usecs)
-                            info->max_usecs = tsn->usecs;
-                        g_ptr_array_add(info->sort_tsn1, tsn_s);
+                        else if (secs == info->max_secs && usecs > info->max_usecs)
+                            info->max_usecs = usecs;
+                        g_array_append_val(info->sort_tsn1, tsn_s);
                         info->n_array_tsn1++;
                     }
                     if ((tvb_get_guint8(sctp_info->tvb[chunk_number],0) == SCTP_SACK_CHUNK_ID) ||
@@ -675,37 +642,32 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
                         if (tsnumber > info->max_tsn2)
                             info->max_tsn2 = tsnumber;
                         length = tvb_get_ntohs(sctp_info->tvb[chunk_number], CHUNK_LENGTH_OFFSET);
-                        if (sack->first_tsn == 0)
-                            sack->first_tsn = tsnumber;
-                        t_s_n = (guint8 *)g_malloc(length);
-                        tvb_memcpy(sctp_info->tvb[chunk_number], (guint8 *)(t_s_n),0, length);
-                        sack->tsns = g_list_append(sack->tsns, t_s_n);
-                        sackchunk = TRUE;
-                        tsn_s = g_new(struct tsn_sort, 1);
-                        tsn_s->tsnumber = tsnumber;
-                        tsn_s->secs     = tsn->secs = (guint32)pinfo->rel_ts.secs;
-                        tsn_s->usecs    = tsn->usecs = (guint32)pinfo->rel_ts.nsecs/1000;
-                        tsn_s->offset   = 0;
-                        tsn_s->framenumber = framenumber;
-                        tsn_s->length   =  tvb_get_ntohl(sctp_info->tvb[chunk_number], SACK_CHUNK_ADV_REC_WINDOW_CREDIT_OFFSET);
-                        if (tsn_s->length > info->max_window1)
-                            info->max_window1 = tsn_s->length;
-                        if (tsn->secs < info->min_secs)
+                        chunk_store_add(&info->sack_store2, sctp_info->tvb[chunk_number],
+                                        length, framenumber, secs, usecs, tsnumber);
+                        tsn_s.tsnumber = tsnumber;
+                        tsn_s.secs     = secs;
+                        tsn_s.usecs    = usecs;
+                        tsn_s.offset   = 0;
+                        tsn_s.framenumber = framenumber;
+                        tsn_s.length   =  tvb_get_ntohl(sctp_info->tvb[chunk_number], SACK_CHUNK_ADV_REC_WINDOW_CREDIT_OFFSET);
+                        if (tsn_s.length > info->max_window1)
+                            info->max_window1 = tsn_s.length;
+                        if (secs < info->min_secs)
                         {
-                            info->min_secs  = tsn->secs;
-                            info->min_usecs = tsn->usecs;
+                            info->min_secs  = secs;
+                            info->min_usecs = usecs;
                         }
-                        else if (tsn->secs == info->min_secs && tsn->usecs < info->min_usecs)
-                            info->min_usecs = tsn->usecs;
+                        else if (secs == info->min_secs && usecs < info->min_usecs)
+                            info->min_usecs = usecs;
 
-                        if (tsn->secs > info->max_secs)
+                        if (secs > info->max_secs)
                         {
-                            info->max_secs  = tsn->secs;
-                            info->max_usecs = tsn->usecs;
+                            info->max_secs  = secs;
+                            info->max_usecs = usecs;
                         }
-                        else if (tsn->secs == info->max_secs && tsn->usecs > info->max_usecs)
-                            info->max_usecs = tsn->usecs;
-                        g_ptr_array_add(info->sort_sack2, tsn_s);
+                        else if (secs == info->max_secs && usecs > info->max_usecs)
+                            info->max_usecs = usecs;
+                        g_array_append_val(info->sort_sack2, tsn_s);
                         info->n_sack_chunks_ep2++;
                     }
                 }
@@ -724,14 +686,6 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
                     info = add_address(store, info, 1);
                 number = pinfo->num;
                 info->frame_numbers=g_list_prepend(info->frame_numbers, GUINT_TO_POINTER(number));
-                if (datachunk || forwardchunk) {
-                    info->tsn1 = g_list_prepend(info->tsn1, tsn);
-                    tsn_used = TRUE;
-                }
-                if (sackchunk == TRUE) {
-                    info->sack2 = g_list_prepend(info->sack2, sack);
-                    sack_used = TRUE;
-                }
                 sctp_tapinfo_struct.assoc_info_list = g_list_append(sctp_tapinfo_struct.assoc_info_list, info);
             }
             else
@@ -770,48 +724,27 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
         } else if (info->verification_tag2 == 0 && info->verification_tag1 != sctp_info->verification_tag) {
             info->verification_tag2 = sctp_info->verification_tag;
         }
-        if (((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_INIT_CHUNK_ID) ||
-                ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_INIT_ACK_CHUNK_ID) ||
-                ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_DATA_CHUNK_ID) ||
+        if (((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_DATA_CHUNK_ID) ||
                 ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_I_DATA_CHUNK_ID) ||
                 ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_SACK_CHUNK_ID) ||
                 ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_NR_SACK_CHUNK_ID) ||
                 ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_FORWARD_TSN_CHUNK_ID))
         {
-
-            tsn = g_new0(tsn_t, 1);
-            copy_address(&tsn->src, &tmp_info.src);
-            copy_address(&tsn->dst, &tmp_info.dst);
-
-            sack = g_new0(tsn_t, 1);
-            copy_address(&sack->src, &tmp_info.src);
-            copy_address(&sack->dst, &tmp_info.dst);
-            sack->secs=tsn->secs = (guint32)pinfo->rel_ts.secs;
-            sack->usecs=tsn->usecs = (guint32)pinfo->rel_ts.nsecs/1000;
-
-            if (((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_DATA_CHUNK_ID) ||
-                    ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_I_DATA_CHUNK_ID) ||
-                    ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_SACK_CHUNK_ID) ||
-                    ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_NR_SACK_CHUNK_ID) ||
-                    ((tvb_get_guint8(sctp_info->tvb[0],0)) == SCTP_FORWARD_TSN_CHUNK_ID))
+            if (secs < info->min_secs)
             {
-                if (tsn->secs < info->min_secs)
-                {
-                    info->min_secs  = tsn->secs;
-                    info->min_usecs = tsn->usecs;
-                }
-                else if (tsn->secs == info->min_secs && tsn->usecs < info->min_usecs)
-                    info->min_usecs = tsn->usecs;
+                info->min_secs  = secs;
+                info->min_usecs = usecs;
+            }
+            else if (secs == info->min_secs && usecs < info->min_usecs)
+                info->min_usecs = usecs;
 
-                if (tsn->secs > info->max_secs)
-                {
-                    info->max_secs  = tsn->secs;
-                    info->max_usecs = tsn->usecs;
-                }
-                else if (tsn->secs == info->max_secs && tsn->usecs > info->max_usecs)
-                    info->max_usecs = tsn->usecs;
+            if (secs > info->max_secs)
+            {
+                info->max_secs  = secs;
+                info->max_usecs = usecs;
             }
-            sack->frame_number = tsn->frame_number = pinfo->num;
+            else if (secs == info->max_secs && usecs > info->max_usecs)
+                info->max_usecs = usecs;
         }
         number = pinfo->num;
         info->frame_numbers=g_list_prepend(info->frame_numbers, GUINT_TO_POINTER(number));
@@ -859,8 +792,6 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
                 info->instream2 = tvb_get_ntohs(sctp_info->tvb[0],INIT_CHUNK_NUMBER_OF_INBOUND_STREAMS_OFFSET);
                 info->outstream2 = tvb_get_ntohs(sctp_info->tvb[0],INIT_CHUNK_NUMBER_OF_OUTBOUND_STREAMS_OFFSET);
                 info->arwnd2 = tvb_get_ntohl(sctp_info->tvb[0],INIT_CHUNK_ADV_REC_WINDOW_CREDIT_OFFSET);
-                info->tsn2 = g_list_prepend(info->tsn2, tsn);
-                tsn_used = TRUE;
             }
             else if (info->direction == 1)
             {
@@ -871,8 +802,6 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
                 info->instream1 = tvb_get_ntohs(sctp_info->tvb[0],INIT_CHUNK_NUMBER_OF_INBOUND_STREAMS_OFFSET);
                 info->outstream1 = tvb_get_ntohs(sctp_info->tvb[0],INIT_CHUNK_NUMBER_OF_OUTBOUND_STREAMS_OFFSET);
                 info->arwnd1 = tvb_get_ntohl(sctp_info->tvb[0],INIT_CHUNK_ADV_REC_WINDOW_CREDIT_OFFSET);
-                info->tsn1 = g_list_prepend(info->tsn1, tsn);
-                tsn_used = TRUE;
             }
 
             idx = tvb_get_guint8(sctp_info->tvb[0],0);
@@ -943,22 +872,6 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
         }
         else
         {
-            if (((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_INIT_ACK_CHUNK_ID) &&
-                    ((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_DATA_CHUNK_ID) &&
-                    ((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_I_DATA_CHUNK_ID) &&
-                    ((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_SACK_CHUNK_ID) &&
-                    ((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_NR_SACK_CHUNK_ID) &&
-                    ((tvb_get_guint8(sctp_info->tvb[0],0)) != SCTP_FORWARD_TSN_CHUNK_ID))
-            {
-                if (!sack)
-                    sack = g_new0(tsn_t, 1);
-                sack->tsns = NULL;
-                sack->first_tsn = 0;
-                if (!tsn)
-                    tsn = g_new0(tsn_t, 1);
-                tsn->tsns = NULL;
-                tsn->first_tsn = 0;
-            }
             for (chunk_number = 0; chunk_number < sctp_info->number_of_tvbs; chunk_number++)
             {
                 idx = tvb_get_guint8(sctp_info->tvb[chunk_number],0);
@@ -977,15 +890,11 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
                     datachunk = TRUE;
                 if (tvb_get_guint8(sctp_info->tvb[chunk_number],0) == SCTP_FORWARD_TSN_CHUNK_ID)
                     forwardchunk = TRUE;
-                if ((datachunk || forwardchunk) && tsn != NULL)
+                if (datachunk || forwardchunk)
                 {
                     tsnumber = tvb_get_ntohl((sctp_info->tvb)[chunk_number], DATA_CHUNK_TSN_OFFSET);
-                    if (tsn->first_tsn == 0)
-                        tsn->first_tsn = tsnumber;
                     if (datachunk)
                     {
-                        t_s_n = (guint8 *)g_malloc(16);
-                        tvb_memcpy(sctp_info->tvb[chunk_number], (guint8 *)(t_s_n),0, 16);
                         if (tvb_get_guint8(sctp_info->tvb[chunk_number],0) == SCTP_DATA_CHUNK_ID) {
                             length=tvb_get_ntohs(sctp_info->tvb[chunk_number], CHUNK_LENGTH_OFFSET)-DATA_CHUNK_HEADER_LENGTH;
                         } else {
@@ -997,35 +906,31 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
                     else
                     {
                         length=tvb_get_ntohs(sctp_info->tvb[chunk_number], CHUNK_LENGTH_OFFSET);
-                        t_s_n = (guint8 *)g_malloc(length);
-                        tvb_memcpy(sctp_info->tvb[chunk_number], (guint8 *)(t_s_n),0, length);
                         info->n_forward_chunks++;
                     }
-                    tsn->tsns = g_list_append(tsn->tsns, t_s_n);
 
-                    tsn_s = g_new0(struct tsn_sort, 1);
-                    tsn_s->tsnumber = tsnumber;
-                    tsn_s->secs  = tsn->secs = (guint32)pinfo->rel_ts.secs;
-                    tsn_s->usecs = tsn->usecs = (guint32)pinfo->rel_ts.nsecs/1000;
-                    tsn_s->offset = 0;
-                    tsn_s->framenumber = framenumber;
-                    tsn_s->length = length;
+                    tsn_s.tsnumber = tsnumber;
+                    tsn_s.secs  = secs;
+                    tsn_s.usecs = usecs;
+                    tsn_s.offset = 0;
+                    tsn_s.framenumber = framenumber;
+                    tsn_s.length = length;
 
-                    if (tsn->secs < info->min_secs)
+                    if (secs < info->min_secs)
                     {
-                        info->min_secs  = tsn->secs;
-                        info->min_usecs = tsn->usecs;
+                        info->min_secs  = secs;
+                        info->min_usecs = usecs;
                     }
-                    else if (tsn->secs == info->min_secs && tsn->usecs < info->min_usecs)
-                        info->min_usecs = tsn->usecs;
+                    else if (secs == info->min_secs && usecs < info->min_usecs)
+                        info->min_usecs = usecs;
 
-                    if (tsn->secs > info->max_secs)
+                    if (secs > info->max_secs)
                     {
-                        info->max_secs  = tsn->secs;
-                        info->max_usecs = tsn->usecs;
+                        info->max_secs  = secs;
+                        info->max_usecs = usecs;
                     }
-                    else if (tsn->secs == info->max_secs && tsn->usecs > info->max_usecs)
-                        info->max_usecs = tsn->usecs;
+                    else if (secs == info->max_secs && usecs > info->max_usecs)
+                        info->max_usecs = usecs;
 
                     if (info->direction == 1)
                     {
@@ -1079,7 +984,10 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
                             }
                         }
 
-                        g_ptr_array_add(info->sort_tsn1, tsn_s);
+                        chunk_store_add(&info->tsn_store1, sctp_info->tvb[chunk_number],
+                                        datachunk ? 16 : length,
+                                        framenumber, secs, usecs, tsnumber);
+                        g_array_append_val(info->sort_tsn1, tsn_s);
                         info->n_array_tsn1++;
                     }
                     else if (info->direction == 2)
@@ -1145,47 +1053,41 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
                             }
                         }
 
-                        g_ptr_array_add(info->sort_tsn2, tsn_s);
+                        chunk_store_add(&info->tsn_store2, sctp_info->tvb[chunk_number],
+                                        datachunk ? 16 : length,
+                                        framenumber, secs, usecs, tsnumber);
+                        g_array_append_val(info->sort_tsn2, tsn_s);
                         info->n_array_tsn2++;
                     }
                 }
-                else if (((tvb_get_guint8(sctp_info->tvb[chunk_number],0) == SCTP_SACK_CHUNK_ID) ||
-                            (tvb_get_guint8(sctp_info->tvb[chunk_number],0) == SCTP_NR_SACK_CHUNK_ID)) &&
-                        sack != NULL)
+                else if ((tvb_get_guint8(sctp_info->tvb[chunk_number],0) == SCTP_SACK_CHUNK_ID) ||
+                            (tvb_get_guint8(sctp_info->tvb[chunk_number],0) == SCTP_NR_SACK_CHUNK_ID))
                 {
                     tsnumber = tvb_get_ntohl((sctp_info->tvb)[chunk_number], SACK_CHUNK_CUMULATIVE_TSN_ACK_OFFSET);
                     length = tvb_get_ntohs(sctp_info->tvb[chunk_number], CHUNK_LENGTH_OFFSET);
 
-                    if (sack->first_tsn == 0)
-                        sack->first_tsn = tsnumber;
-
-                    t_s_n = (guint8 *)g_malloc(length);
-                    tvb_memcpy(sctp_info->tvb[chunk_number], (guint8 *)(t_s_n),0, length);
-                    sack->tsns = g_list_append(sack->tsns, t_s_n);
-                    sackchunk = TRUE;
-                    tsn_s = g_new0(struct tsn_sort, 1);
-                    tsn_s->tsnumber = tsnumber;
-                    tsn_s->secs   = tsn->secs = (guint32)pinfo->rel_ts.secs;
-                    tsn_s->usecs  = tsn->usecs = (guint32)pinfo->rel_ts.nsecs/1000;
-                    tsn_s->offset = 0;
-                    tsn_s->framenumber = framenumber;
-                    tsn_s->length = tvb_get_ntohl(sctp_info->tvb[chunk_number], SACK_CHUNK_ADV_REC_WINDOW_CREDIT_OFFSET);
-
-                    if (tsn->secs < info->min_secs)
+                    tsn_s.tsnumber = tsnumber;
+                    tsn_s.secs   = secs;
+                    tsn_s.usecs  = usecs;
+                    tsn_s.offset = 0;
+                    tsn_s.framenumber = framenumber;
+                    tsn_s.length = tvb_get_ntohl(sctp_info->tvb[chunk_number], SACK_CHUNK_ADV_REC_WINDOW_CREDIT_OFFSET);
+
+                    if (secs < info->min_secs)
                     {
-                        info->min_secs  = tsn->secs;
-                        info->min_usecs = tsn->usecs;
+                        info->min_secs  = secs;
+                        info->min_usecs = usecs;
                     }
-                    else if (tsn->secs == info->min_secs && tsn->usecs < info->min_usecs)
-                        info->min_usecs = tsn->usecs;
+                    else if (secs == info->min_secs && usecs < info->min_usecs)
+                        info->min_usecs = usecs;
 
-                    if (tsn->secs > info->max_secs)
+                    if (secs > info->max_secs)
                     {
-                        info->max_secs  = tsn->secs;
-                        info->max_usecs = tsn->usecs;
+                        info->max_secs  = secs;
+                        info->max_usecs = usecs;
                     }
-                    else if (tsn->secs == info->max_secs && tsn->usecs > info->max_usecs)
-                        info->max_usecs = tsn->usecs;
+                    else if (secs == info->max_secs && usecs > info->max_usecs)
+                        info->max_usecs = usecs;
 
 
                     if (info->direction == 2)
@@ -1194,9 +1096,11 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
                             info->min_tsn1 = tsnumber;
                         if(tsnumber > info->max_tsn1)
                             info->max_tsn1 = tsnumber;
-                        if (tsn_s->length > info->max_window1)
-                            info->max_window1 = tsn_s->length;
-                        g_ptr_array_add(info->sort_sack1, tsn_s);
+                        if (tsn_s.length > info->max_window1)
+                            info->max_window1 = tsn_s.length;
+                        chunk_store_add(&info->sack_store1, sctp_info->tvb[chunk_number],
+                                        length, framenumber, secs, usecs, tsnumber);
+                        g_array_append_val(info->sort_sack1, tsn_s);
                         info->n_sack_chunks_ep1++;
                     }
                     else if (info->direction == 1)
@@ -1205,40 +1109,22 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
                             info->min_tsn2 = tsnumber;
                         if(tsnumber > info->max_tsn2)
                             info->max_tsn2 = tsnumber;
-                        if (tsn_s->length > info->max_window2)
-                            info->max_window2 = tsn_s->length;
-                        g_ptr_array_add(info->sort_sack2, tsn_s);
+                        if (tsn_s.length > info->max_window2)
+                            info->max_window2 = tsn_s.length;
+                        chunk_store_add(&info->sack_store2, sctp_info->tvb[chunk_number],
+                                        length, framenumber, secs, usecs, tsnumber);
+                        g_array_append_val(info->sort_sack2, tsn_s);
                         info->n_sack_chunks_ep2++;
                     }
                 }
             }
         }
 
-        if (datachunk || forwardchunk)
-        {
-            if (info->direction == 1)
-                info->tsn1 = g_list_prepend(info->tsn1, tsn);
-            else if (info->direction == 2)
-                info->tsn2 = g_list_prepend(info->tsn2, tsn);
-            tsn_used = TRUE;
-        }
-        if (sackchunk == TRUE)
-        {
-            if (info->direction == 1)
-                info->sack2 = g_list_prepend(info->sack2, sack);
-            else if(info->direction == 2)
-                info->sack1 = g_list_prepend(info->sack1, sack);
-            sack_used = TRUE;
-        }
         info->n_tvbs += sctp_info->number_of_tvbs;
         sctp_tapinfo_struct.sum_tvbs += sctp_info->number_of_tvbs;
         info = calc_checksum(sctp_info, info);
         info->n_packets++;
     }
-    if (tsn && !tsn_used)
-        tsn_free(tsn);
-    if (sack && !sack_used)
-        tsn_free(sack);
     free_address(&tmp_info.src);
     free_address(&tmp_info.dst);
     return TAP_PACKET_REDRAW;
@@ -136,15 +136,25 @@ extern "C" {
  */
 #define MAX_SCTP_CHUNK_TYPE 256
 
-typedef struct _tsn {
+typedef struct _sctp_chunk_rec {
 	guint32	 frame_number;
-	guint32	 secs;		/* Absolute seconds */
+	guint32	 secs;		/* Relative seconds */
 	guint32	 usecs;
-	address	 src;
-	address	 dst;
-	guint32	 first_tsn;
-	GList	*tsns;
-} tsn_t;
+	guint32	 offset;	/* Offset of the raw chunk in the store's bytes */
+	guint32	 length;	/* Number of raw bytes stored */
+	guint32	 tsn;		/* TSN or cumulative TSN ack, host byte order */
+	guint8	 type;
+} sctp_chunk_rec_t;
+
+/* Per-direction chunk storage: the raw chunk copies live concatenated in
+ * one growable buffer and are described by an array of fixed-size records
+ * in capture order, so graph series can be computed with a sequential
+ * array scan instead of walking nested lists of small allocations.
+ */
+typedef struct _sctp_chunk_store {
+	GByteArray *bytes;
+	GArray	   *recs;	/* sctp_chunk_rec_t */
+} sctp_chunk_store_t;
 
 typedef struct _sctp_tmp_info {
 	guint16 assoc_id;
@@ -251,14 +261,14 @@ typedef struct _sctp_assoc_info {
 	sctp_init_collision_t *dir2;
 	GSList	  *min_max;
 	GList	  *frame_numbers;
-	GList	  *tsn1;
-	GPtrArray *sort_tsn1;
-	GPtrArray *sort_sack1;
-	GList	  *sack1;
-	GList	  *tsn2;
-	GPtrArray *sort_tsn2;
-	GPtrArray *sort_sack2;
-	GList	  *sack2;
+	sctp_chunk_store_t tsn_store1;
+	GArray	  *sort_tsn1;	/* struct tsn_sort */
+	GArray	  *sort_sack1;
+	sctp_chunk_store_t sack_store1;
+	sctp_chunk_store_t tsn_store2;
+	GArray	  *sort_tsn2;
+	GArray	  *sort_sack2;
+	sctp_chunk_store_t sack_store2;
 	gboolean   check_address;
 	GList*	   error_info_list;
 	/* The array is initialized to MAX_SCTP_CHUNK_TYPE
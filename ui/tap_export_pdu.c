@@ -42,7 +42,17 @@ export_pdu_packet(void *tapdata, packet_info *pinfo, epan_dissect_t *edt, const
 
     memset(&rec, 0, sizeof rec);
     buffer_len = exp_pdu_data->tvb_captured_length + exp_pdu_data->tlv_buffer_len;
-    packet_buf = (guint8 *)g_malloc(buffer_len);
+
+    /* Reuse one write buffer across packets, growing it geometrically;
+     * a fresh allocation per PDU is measurable when millions of PDUs
+     * are exported. */
+    if ((guint32)buffer_len > exp_pdu_tap_data->pkt_buf_size) {
+        exp_pdu_tap_data->pkt_buf_size = MAX((guint32)buffer_len,
+                                             exp_pdu_tap_data->pkt_buf_size * 2);
+        exp_pdu_tap_data->pkt_buf = (guint8 *)g_realloc(exp_pdu_tap_data->pkt_buf,
+                                                        exp_pdu_tap_data->pkt_buf_size);
+    }
+    packet_buf = exp_pdu_tap_data->pkt_buf;
 
     if(exp_pdu_data->tlv_buffer_len > 0){
         memcpy(packet_buf, exp_pdu_data->tlv_buffer, exp_pdu_data->tlv_buffer_len);
@@ -77,8 +87,6 @@ export_pdu_packet(void *tapdata, packet_info *pinfo, epan_dissect_t *edt, const
         status = TAP_PACKET_FAILED;
     }
 
-    g_free(packet_buf);
-
     return status;
 }
 
@@ -190,6 +198,10 @@ exp_pdu_close(exp_pdu_t *exp_pdu_tap_data, int *err, gchar **err_info)
     wtap_block_array_free(exp_pdu_tap_data->shb_hdrs);
     wtap_free_idb_info(exp_pdu_tap_data->idb_inf);
 
+    g_free(exp_pdu_tap_data->pkt_buf);
+    exp_pdu_tap_data->pkt_buf = NULL;
+    exp_pdu_tap_data->pkt_buf_size = 0;
+
     remove_tap_listener(exp_pdu_tap_data);
     return status;
 }
@@ -202,6 +214,8 @@ exp_pdu_pre_open(const char *tap_name, const char *filter, exp_pdu_t *exp_pdu_ta
 
     /* XXX: can we always assume WTAP_ENCAP_WIRESHARK_UPPER_PDU? */
     exp_pdu_tap_data->pkt_encap = WTAP_ENCAP_WIRESHARK_UPPER_PDU;
+    exp_pdu_tap_data->pkt_buf = NULL;
+    exp_pdu_tap_data->pkt_buf_size = 0;
 
     /* Register this tap listener now */
     error_string = register_tap_listener(tap_name,             /* The name of the tap we want to listen to */
@@ -61,6 +61,205 @@ const char *endp_column_titles[ENDP_NUM_GEO_COLUMNS] = {
 const char *endp_conn_title = "Connection";
 
 #ifdef HAVE_MAXMINDDB
+/* Above this many endpoints, pre-cluster server-side on a fixed geographic
+ * grid instead of handing the browser one feature per endpoint; with very
+ * large captures the browser-side clusterer in ipmap.html becomes unusable. */
+#define MAP_CLUSTER_THRESHOLD 50000
+
+/* Grid cell edge in degrees. Half a degree keeps the worst case at a few
+ * thousand populated cells while still separating metropolitan areas. */
+#define MAP_CLUSTER_CELL_DEG 0.5
+
+typedef struct {
+    guint64 endpoints;
+    guint64 packets;
+    guint64 bytes;
+    double  sum_lat;
+    double  sum_lon;
+} map_cluster_t;
+
+/* Key of the grid cell containing the given coordinates. */
+static guint
+map_cluster_key(double lat, double lon)
+{
+    guint lat_idx = (guint)((lat + 90.0) / MAP_CLUSTER_CELL_DEG);
+    guint lon_idx = (guint)((lon + 180.0) / MAP_CLUSTER_CELL_DEG);
+
+    return (lat_idx << 16) | lon_idx;
+}
+
+/* Look up the GeoIP result for an endpoint, filling in its printable
+ * address. Returns NULL if the address has no usable coordinates. */
+static const mmdb_lookup_t *
+host_geoip_lookup(const hostlist_talker_t *host, char *addr, size_t addr_size)
+{
+    const mmdb_lookup_t *result = NULL;
+
+    if (host->myaddress.type == AT_IPv4) {
+        const ws_in4_addr *ip4 = (const ws_in4_addr *)host->myaddress.data;
+        result = maxmind_db_lookup_ipv4(ip4);
+        ws_inet_ntop4(ip4, addr, (guint)addr_size);
+    } else if (host->myaddress.type == AT_IPv6) {
+        const ws_in6_addr *ip6 = (const ws_in6_addr *)host->myaddress.data;
+        result = maxmind_db_lookup_ipv6(ip6);
+        ws_inet_ntop6(ip6, addr, (guint)addr_size);
+    }
+    if (!maxmind_db_has_coords(result)) {
+        /* result could be NULL if the caller did not trigger a lookup
+         * before. result->found could be FALSE if no MMDB entry exists. */
+        return NULL;
+    }
+    return result;
+}
+
+/* Emit one feature per resolved endpoint. Returns the feature count. */
+static size_t
+write_map_endpoints(json_dumper *dumper, hostlist_talker_t *const *hosts)
+{
+    size_t count = 0;
+    const hostlist_talker_t *host;
+    for (hostlist_talker_t *const *iter = hosts; (host = *iter) != NULL; ++iter) {
+        char addr[WS_INET6_ADDRSTRLEN];
+        const mmdb_lookup_t *result = host_geoip_lookup(host, addr, sizeof(addr));
+        if (!result) {
+            continue;
+        }
+
+        ++count;
+        json_dumper_begin_object(dumper);
+
+        json_dumper_set_member_name(dumper, "type");
+        json_dumper_value_string(dumper, "Feature");
+
+        json_dumper_set_member_name(dumper, "geometry");
+        {
+            json_dumper_begin_object(dumper);
+            json_dumper_set_member_name(dumper, "type");
+            json_dumper_value_string(dumper, "Point");
+            json_dumper_set_member_name(dumper, "coordinates");
+            json_dumper_begin_array(dumper);
+            json_dumper_value_double(dumper, result->longitude);
+            json_dumper_value_double(dumper, result->latitude);
+            json_dumper_end_array(dumper);     // end coordinates
+        }
+        json_dumper_end_object(dumper);    // end geometry
+
+        json_dumper_set_member_name(dumper, "properties");
+        json_dumper_begin_object(dumper);
+        {
+            json_dumper_set_member_name(dumper, "ip");
+            json_dumper_value_string(dumper, addr);
+            if (result->as_number && result->as_org) {
+                json_dumper_set_member_name(dumper, "autonomous_system_number");
+                json_dumper_value_anyf(dumper, "%u", result->as_number);
+                json_dumper_set_member_name(dumper, "autonomous_system_organization");
+                json_dumper_value_string(dumper, result->as_org);
+            }
+            if (result->city) {
+                json_dumper_set_member_name(dumper, "city");
+                json_dumper_value_string(dumper, result->city);
+            }
+            if (result->country) {
+                json_dumper_set_member_name(dumper, "country");
+                json_dumper_value_string(dumper, result->country);
+            }
+            if (result->accuracy) {
+                json_dumper_set_member_name(dumper, "radius");
+                json_dumper_value_anyf(dumper, "%u", result->accuracy);
+            }
+            json_dumper_set_member_name(dumper, "packets");
+            json_dumper_value_anyf(dumper, "%" G_GUINT64_FORMAT, host->rx_frames + host->tx_frames);
+            json_dumper_set_member_name(dumper, "bytes");
+            json_dumper_value_anyf(dumper, "%" G_GUINT64_FORMAT, host->rx_bytes + host->tx_bytes);
+        }
+        json_dumper_end_object(dumper);    // end properties
+
+        json_dumper_end_object(dumper);
+    }
+    return count;
+}
+
+/* Emit one aggregate feature per populated grid cell, placed at the mean
+ * position of the endpoints it covers. ipmap.html shows the title and
+ * description properties as-is, so pre-clustered output needs no
+ * browser-side support. Returns the feature count. */
+static size_t
+write_map_clusters(json_dumper *dumper, hostlist_talker_t *const *hosts)
+{
+    GHashTable *cells = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    GHashTableIter cell_iter;
+    gpointer cell_value;
+    size_t count = 0;
+    const hostlist_talker_t *host;
+
+    for (hostlist_talker_t *const *iter = hosts; (host = *iter) != NULL; ++iter) {
+        char addr[WS_INET6_ADDRSTRLEN];
+        const mmdb_lookup_t *result = host_geoip_lookup(host, addr, sizeof(addr));
+        map_cluster_t *cluster;
+        guint key;
+
+        if (!result) {
+            continue;
+        }
+        key = map_cluster_key(result->latitude, result->longitude);
+        cluster = (map_cluster_t *)g_hash_table_lookup(cells, GUINT_TO_POINTER(key));
+        if (!cluster) {
+            cluster = g_new0(map_cluster_t, 1);
+            g_hash_table_insert(cells, GUINT_TO_POINTER(key), cluster);
+        }
+        cluster->endpoints++;
+        cluster->packets += host->rx_frames + host->tx_frames;
+        cluster->bytes += host->rx_bytes + host->tx_bytes;
+        cluster->sum_lat += result->latitude;
+        cluster->sum_lon += result->longitude;
+    }
+
+    g_hash_table_iter_init(&cell_iter, cells);
+    while (g_hash_table_iter_next(&cell_iter, NULL, &cell_value)) {
+        const map_cluster_t *cluster = (const map_cluster_t *)cell_value;
+        char *text;
+
+        ++count;
+        json_dumper_begin_object(dumper);
+
+        json_dumper_set_member_name(dumper, "type");
+        json_dumper_value_string(dumper, "Feature");
+
+        json_dumper_set_member_name(dumper, "geometry");
+        {
+            json_dumper_begin_object(dumper);
+            json_dumper_set_member_name(dumper, "type");
+            json_dumper_value_string(dumper, "Point");
+            json_dumper_set_member_name(dumper, "coordinates");
+            json_dumper_begin_array(dumper);
+            json_dumper_value_double(dumper, cluster->sum_lon / (double)cluster->endpoints);
+            json_dumper_value_double(dumper, cluster->sum_lat / (double)cluster->endpoints);
+            json_dumper_end_array(dumper);      // end coordinates
+        }
+        json_dumper_end_object(dumper);     // end geometry
+
+        json_dumper_set_member_name(dumper, "properties");
+        json_dumper_begin_object(dumper);
+        {
+            json_dumper_set_member_name(dumper, "title");
+            text = g_strdup_printf("%" G_GUINT64_FORMAT " endpoints", cluster->endpoints);
+            json_dumper_value_string(dumper, text);
+            g_free(text);
+            json_dumper_set_member_name(dumper, "description");
+            text = g_strdup_printf("Packets: %" G_GUINT64_FORMAT "\nBytes: %" G_GUINT64_FORMAT,
+                                   cluster->packets, cluster->bytes);
+            json_dumper_value_string(dumper, text);
+            g_free(text);
+        }
+        json_dumper_end_object(dumper);     // end properties
+
+        json_dumper_end_object(dumper);
+    }
+    g_hash_table_destroy(cells);
+
+    return count;
+}
+
 gboolean
 write_endpoint_geoip_map(FILE *fp, gboolean json_only, hostlist_talker_t *const *hosts, gchar **err_str)
 {
@@ -130,77 +329,18 @@ write_endpoint_geoip_map(FILE *fp, gboolean json_only, hostlist_talker_t *const
     json_dumper_set_member_name(&dumper, "features");
     json_dumper_begin_array(&dumper);
 
-    /* Append map data. */
-    size_t count = 0;
-    const hostlist_talker_t *host;
-    for (hostlist_talker_t *const *iter = hosts; (host = *iter) != NULL; ++iter) {
-        char addr[WS_INET6_ADDRSTRLEN];
-        const mmdb_lookup_t *result = NULL;
-        if (host->myaddress.type == AT_IPv4) {
-            const ws_in4_addr *ip4 = (const ws_in4_addr *)host->myaddress.data;
-            result = maxmind_db_lookup_ipv4(ip4);
-            ws_inet_ntop4(ip4, addr, sizeof(addr));
-        } else if (host->myaddress.type == AT_IPv6) {
-            const ws_in6_addr *ip6 = (const ws_in6_addr *)host->myaddress.data;
-            result = maxmind_db_lookup_ipv6(ip6);
-            ws_inet_ntop6(ip6, addr, sizeof(addr));
-        }
-        if (!maxmind_db_has_coords(result)) {
-            // result could be NULL if the caller did not trigger a lookup
-            // before. result->found could be FALSE if no MMDB entry exists.
-            continue;
-        }
-
-        ++count;
-        json_dumper_begin_object(&dumper);
-
-        json_dumper_set_member_name(&dumper, "type");
-        json_dumper_value_string(&dumper, "Feature");
-
-        json_dumper_set_member_name(&dumper, "geometry");
-        {
-            json_dumper_begin_object(&dumper);
-            json_dumper_set_member_name(&dumper, "type");
-            json_dumper_value_string(&dumper, "Point");
-            json_dumper_set_member_name(&dumper, "coordinates");
-            json_dumper_begin_array(&dumper);
-            json_dumper_value_double(&dumper, result->longitude);
-            json_dumper_value_double(&dumper, result->latitude);
-            json_dumper_end_array(&dumper);     // end coordinates
-        }
-        json_dumper_end_object(&dumper);    // end geometry
-
-        json_dumper_set_member_name(&dumper, "properties");
-        json_dumper_begin_object(&dumper);
-        {
-            json_dumper_set_member_name(&dumper, "ip");
-            json_dumper_value_string(&dumper, addr);
-            if (result->as_number && result->as_org) {
-                json_dumper_set_member_name(&dumper, "autonomous_system_number");
-                json_dumper_value_anyf(&dumper, "%u", result->as_number);
-                json_dumper_set_member_name(&dumper, "autonomous_system_organization");
-                json_dumper_value_string(&dumper, result->as_org);
-            }
-            if (result->city) {
-                json_dumper_set_member_name(&dumper, "city");
-                json_dumper_value_string(&dumper, result->city);
-            }
-            if (result->country) {
-                json_dumper_set_member_name(&dumper, "country");
-                json_dumper_value_string(&dumper, result->country);
-            }
-            if (result->accuracy) {
-                json_dumper_set_member_name(&dumper, "radius");
-                json_dumper_value_anyf(&dumper, "%u", result->accuracy);
-            }
-            json_dumper_set_member_name(&dumper, "packets");
-            json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, host->rx_frames + host->tx_frames);
-            json_dumper_set_member_name(&dumper, "bytes");
-            json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, host->rx_bytes + host->tx_bytes);
-        }
-        json_dumper_end_object(&dumper);    // end properties
+    /* Append map data. Past a certain size, pre-cluster the endpoints on a
+     * geographic grid; the browser-side clusterer doesn't cope with captures
+     * holding hundreds of thousands of endpoints. */
+    size_t n_hosts = 0;
+    for (hostlist_talker_t *const *iter = hosts; *iter != NULL; ++iter)
+        ++n_hosts;
 
-        json_dumper_end_object(&dumper);
+    size_t count;
+    if (n_hosts > MAP_CLUSTER_THRESHOLD) {
+        count = write_map_clusters(&dumper, hosts);
+    } else {
+        count = write_map_endpoints(&dumper, hosts);
     }
 
     json_dumper_end_array(&dumper);     // end features
@@ -65,12 +65,21 @@ typedef struct blf_log_container {
     unsigned char  *real_data;        /* cache for decompressed data */
 } blf_log_container_t;
 
+/* Decompressed log containers are kept in a small sliding window so that
+ * reading a multi-gigabyte compressed file does not keep every container
+ * resident. Reads are mostly sequential, so a handful of containers is
+ * enough to cover objects straddling container boundaries. */
+#define BLF_MAX_RESIDENT_CONTAINERS 4
+
 typedef struct blf_data {
     gint64  start_of_last_obj;
     gint64  current_real_seek_pos;
 
     guint   current_log_container;
     GArray *log_containers;
+
+    guint   resident_containers[BLF_MAX_RESIDENT_CONTAINERS];
+    guint   num_resident_containers;
 } blf_t;
 
 typedef struct blf_params {
@@ -320,16 +329,32 @@ blf_get_num_prev_leftover_bytes(blf_t *blf_data) {
 gboolean
 blf_find_logcontainer_for_address(blf_t *blf_data, gint64 pos, blf_log_container_t **container, gint *container_index) {
     blf_log_container_t *tmp;
+    guint left;
+    guint right;
+    guint mid;
 
-    if (blf_data == NULL || blf_data->log_containers == NULL) {
+    if (blf_data == NULL || blf_data->log_containers == NULL || blf_data->log_containers->len == 0) {
         return FALSE;
     }
 
-    for (guint i = 0; i < blf_data->log_containers->len; i++) {
-        tmp = &g_array_index(blf_data->log_containers, blf_log_container_t, i);
-        if (tmp->real_start_pos <= pos && pos < tmp->real_start_pos + (gint64)tmp->real_length) {
+    /* The containers were appended in file order during the initial scan,
+     * so their real positions are sorted and we can binary search. */
+    left = 0;
+    right = blf_data->log_containers->len - 1;
+
+    while (left <= right) {
+        mid = left + (right - left) / 2;
+        tmp = &g_array_index(blf_data->log_containers, blf_log_container_t, mid);
+        if (pos < tmp->real_start_pos) {
+            if (mid == 0) {
+                break;
+            }
+            right = mid - 1;
+        } else if (pos >= tmp->real_start_pos + (gint64)tmp->real_length) {
+            left = mid + 1;
+        } else {
             *container = tmp;
-            *container_index = i;
+            *container_index = mid;
             return TRUE;
         }
     }
@@ -337,6 +362,30 @@ blf_find_logcontainer_for_address(blf_t *blf_data, gint64 pos, blf_log_container
     return FALSE;
 }
 
+/* Remember that a container holds decompressed data and, if the sliding
+ * window is full, evict the oldest resident container's buffer. */
+static void
+blf_mark_container_resident(blf_t *blf_data, guint index_log_container) {
+    blf_log_container_t *evicted;
+
+    for (guint i = 0; i < blf_data->num_resident_containers; i++) {
+        if (blf_data->resident_containers[i] == index_log_container) {
+            return;
+        }
+    }
+
+    if (blf_data->num_resident_containers == BLF_MAX_RESIDENT_CONTAINERS) {
+        evicted = &g_array_index(blf_data->log_containers, blf_log_container_t, blf_data->resident_containers[0]);
+        g_free(evicted->real_data);
+        evicted->real_data = NULL;
+        memmove(&blf_data->resident_containers[0], &blf_data->resident_containers[1],
+                (BLF_MAX_RESIDENT_CONTAINERS - 1) * sizeof(blf_data->resident_containers[0]));
+        blf_data->num_resident_containers--;
+    }
+
+    blf_data->resident_containers[blf_data->num_resident_containers++] = index_log_container;
+}
+
 gboolean
 blf_pull_logcontainer_into_memory(blf_params_t *params, guint index_log_container) {
     blf_t *blf_data = params->blf_data;
@@ -368,6 +417,7 @@ blf_pull_logcontainer_into_memory(blf_params_t *params, guint index_log_containe
         unsigned char *compressed_data = g_try_malloc0((gsize)tmp.infile_length);
         guint64 data_length = (unsigned int)tmp.infile_length - (tmp.infile_data_start - tmp.infile_start_pos);
         if (!wtap_read_bytes_or_eof(params->fh, compressed_data, (unsigned int)data_length, &err, &err_info)) {
+            g_free(compressed_data);
             ws_debug("blf_pull_logcontainer_into_memory: cannot read compressed data");
             return FALSE;
         }
@@ -387,9 +437,11 @@ blf_pull_logcontainer_into_memory(blf_params_t *params, guint index_log_containe
         inflateInit(&infstream);
         inflate(&infstream, Z_NO_FLUSH);
         inflateEnd(&infstream);
+        g_free(compressed_data);
 
         tmp.real_data = buf;
         g_array_index(blf_data->log_containers, blf_log_container_t, index_log_container) = tmp;
+        blf_mark_container_resident(blf_data, index_log_container);
         return TRUE;
 #else
         return FALSE;
@@ -1506,6 +1558,7 @@ blf_open(wtap *wth, int *err, gchar **err_info) {
     blf->log_containers = NULL;
     blf->current_log_container = 0;
     blf->current_real_seek_pos = 0;
+    blf->num_resident_containers = 0;
 
     /* embed in params */
     params.blf_data = blf;
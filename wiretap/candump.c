@@ -95,7 +95,8 @@ candump_write_packet(wtap_rec *rec, Buffer *buf, const msg_t *msg)
 }
 
 static gboolean
-candump_parse(FILE_T fh, msg_t *msg, gint64 *offset, int *err, char **err_info)
+candump_parse(candump_parser_t *parser, FILE_T fh, msg_t *msg, gint64 *offset,
+              int *err, char **err_info)
 {
     candump_state_t state = {0};
     gboolean        ok;
@@ -117,7 +118,7 @@ candump_parse(FILE_T fh, msg_t *msg, gint64 *offset, int *err, char **err_info)
         candump_debug_printf("%s: Starting parser at offset %" PRIi64 "\n", G_STRFUNC, seek_off);
 #endif
         state.file_bytes_read = 0;
-        ok = run_candump_parser(&state, err, err_info);
+        ok = run_candump_parser(parser, &state, err, err_info);
 
         /* Rewind the file to the offset we have finished parsing */
         if (file_seek(fh, seek_off + state.file_bytes_read, SEEK_SET, err) == -1)
@@ -146,11 +147,34 @@ candump_parse(FILE_T fh, msg_t *msg, gint64 *offset, int *err, char **err_info)
     return TRUE;
 }
 
+static void
+candump_close(wtap *wth)
+{
+    candump_priv_t *priv = (candump_priv_t *)wth->priv;
+
+    candump_parser_free(priv->parser);
+
+    /* wth->priv itself is freed by the caller */
+}
+
 wtap_open_return_val
 candump_open(wtap *wth, int *err, char **err_info)
 {
-    if (!candump_parse(wth->fh, NULL, NULL, err, err_info))
+    candump_parser_t *parser;
+    candump_priv_t   *priv;
+
+    parser = candump_parser_new();
+    if (!parser)
+    {
+        *err      = errno;
+        *err_info = g_strdup(g_strerror(errno));
+
+        return WTAP_OPEN_ERROR;
+    }
+
+    if (!candump_parse(parser, wth->fh, NULL, NULL, err, err_info))
     {
+        candump_parser_free(parser);
         g_free(*err_info);
 
         *err      = 0;
@@ -165,18 +189,24 @@ candump_open(wtap *wth, int *err, char **err_info)
 
     if (file_seek(wth->fh, 0, SEEK_SET, err) == -1)
     {
+        candump_parser_free(parser);
+
         *err      = errno;
         *err_info = g_strdup(g_strerror(errno));
 
         return WTAP_OPEN_ERROR;
     }
 
-    wth->priv              = NULL;
+    priv         = g_new0(candump_priv_t, 1);
+    priv->parser = parser;
+
+    wth->priv              = priv;
     wth->file_type_subtype = candump_file_type_subtype;
     wth->file_encap        = WTAP_ENCAP_WIRESHARK_UPPER_PDU;
     wth->file_tsprec       = WTAP_TSPREC_USEC;
     wth->subtype_read      = candump_read;
     wth->subtype_seek_read = candump_seek_read;
+    wth->subtype_close     = candump_close;
 
     return WTAP_OPEN_MINE;
 }
@@ -185,13 +215,14 @@ static gboolean
 candump_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err, gchar **err_info,
              gint64 *data_offset)
 {
-    msg_t msg;
+    candump_priv_t *priv = (candump_priv_t *)wth->priv;
+    msg_t           msg;
 
 #ifdef CANDUMP_DEBUG
     candump_debug_printf("%s: Try reading at offset %" PRIi64 "\n", G_STRFUNC, file_tell(wth->fh));
 #endif
 
-    if (!candump_parse(wth->fh, &msg, data_offset, err, err_info))
+    if (!candump_parse(priv->parser, wth->fh, &msg, data_offset, err, err_info))
         return FALSE;
 
 #ifdef CANDUMP_DEBUG
@@ -207,7 +238,8 @@ static gboolean
 candump_seek_read(wtap *wth , gint64 seek_off, wtap_rec *rec,
                   Buffer *buf, int *err, gchar **err_info)
 {
-    msg_t msg;
+    candump_priv_t *priv = (candump_priv_t *)wth->priv;
+    msg_t           msg;
 
 #ifdef CANDUMP_DEBUG
     candump_debug_printf("%s: Read at offset %" PRIi64 "\n", G_STRFUNC, seek_off);
@@ -221,7 +253,7 @@ candump_seek_read(wtap *wth , gint64 seek_off, wtap_rec *rec,
         return FALSE;
     }
 
-    if (!candump_parse(wth->random_fh, &msg, NULL, err, err_info))
+    if (!candump_parse(priv->parser, wth->random_fh, &msg, NULL, err, err_info))
         return FALSE;
 
     candump_write_packet(rec, buf, &msg);
@@ -37,9 +37,10 @@ typedef struct {
     gint64 v1;
 } token_t;
 
+typedef struct candump_parser candump_parser_t;
+
 typedef struct {
-    wtap *tmp_file;
-    char *tmp_filename;
+    candump_parser_t *parser;
 } candump_priv_t;
 
 typedef struct {
@@ -56,8 +57,15 @@ typedef struct {
     token_t token;
 } candump_state_t;
 
+candump_parser_t *
+candump_parser_new(void);
+
+void
+candump_parser_free(candump_parser_t *parser);
+
 gboolean
-run_candump_parser(candump_state_t *state, int *err, gchar **err_info);
+run_candump_parser(candump_parser_t *parser, candump_state_t *state,
+                   int *err, gchar **err_info);
 
 #ifdef CANDUMP_DEBUG
 #include <stdio.h>
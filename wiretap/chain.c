@@ -0,0 +1,300 @@
+/* Read a set of capture files as one virtual, concatenated capture.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#define WS_LOG_DOMAIN LOG_DOMAIN_WIRETAP
+
+#include <string.h>
+
+#include "chain.h"
+#include "wtap-int.h"
+#include "wtap_opttypes.h"
+#include "file_wrappers.h"
+
+#include <wsutil/wslog.h>
+#include <wsutil/ws_assert.h>
+
+/*
+ * Seek offsets handed out for the virtual capture pack the member file
+ * index into bits 62..48 and the offset within the member into bits
+ * 47..0, keeping the packed value non-negative.  That bounds a set at
+ * 32767 files of up to 256 TiB each.
+ */
+#define CHAIN_OFFSET_BITS   48
+#define CHAIN_OFFSET_MASK   ((G_GINT64_CONSTANT(1) << CHAIN_OFFSET_BITS) - 1)
+#define CHAIN_MAX_MEMBERS   0x7fffU
+
+/*
+ * Upper bound on the number of member files kept open for random
+ * access.  Revisiting a record of a closed member reopens it, so this
+ * only bounds memory, not what can be read; scrolling around a loaded
+ * virtual capture touches a few neighbouring members at a time, so a
+ * small cache avoids almost all reopens.
+ */
+#define CHAIN_MAX_OPEN_RANDOM   8
+
+typedef struct chain_member_s {
+    char    *filename;
+    wtap    *rnd;           /* random-access handle, or NULL if not open */
+    guint64  lru_gen;       /* counter value at last random access */
+} chain_member_t;
+
+typedef struct chain_s {
+    chain_member_t  *members;
+    guint            n_members;
+    guint            cur;           /* member the sequential read is in */
+    wtap            *seq;           /* sequential handle for members[cur], or NULL */
+    guint            n_open_rnd;    /* members with an open random-access handle */
+    guint64          lru_counter;
+} chain_t;
+
+/*
+ * Mirror interface descriptions the given member has seen so far into
+ * the virtual capture's table, so that per-packet interface IDs resolve
+ * to names and time stamp resolutions there.  The members of a file set
+ * declare the same interfaces in the same order, so later members add
+ * nothing beyond what the first one already did.
+ */
+static void
+chain_mirror_interface_data(wtap *wth, wtap *member)
+{
+    guint i;
+
+    for (i = wth->interface_data->len; i < member->interface_data->len; i++) {
+        wtap_block_t idb = wtap_block_make_copy(g_array_index(member->interface_data,
+                                                              wtap_block_t, i));
+        g_array_append_val(wth->interface_data, idb);
+    }
+}
+
+static gboolean
+chain_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err, gchar **err_info,
+           gint64 *data_offset)
+{
+    chain_t *chain = (chain_t *)wth->priv;
+    gint64 member_off;
+
+    for (;;) {
+        if (chain->seq == NULL) {
+            if (chain->cur >= chain->n_members) {
+                /* Past the last member - EOF for the whole set. */
+                *err = 0;
+                return FALSE;
+            }
+            chain->seq = wtap_open_offline(chain->members[chain->cur].filename,
+                                           WTAP_TYPE_AUTO, err, err_info,
+                                           FALSE);
+            if (chain->seq == NULL)
+                return FALSE;
+            /*
+             * Alias the member's stream, so that the progress reporting
+             * callers do through wtap_read_so_far() and wtap_file_size()
+             * tracks the file we're actually in.  The member owns the
+             * stream; the alias is cleared before the member is closed.
+             */
+            wth->fh = chain->seq->fh;
+        }
+        if (wtap_read(chain->seq, rec, buf, err, err_info, &member_off))
+            break;
+        if (*err != 0)
+            return FALSE;       /* read error within this member */
+        /* EOF on this member; drop its reader state and move along. */
+        ws_debug("chain: member %u done, advancing", chain->cur);
+        wth->fh = NULL;
+        wtap_close(chain->seq);
+        chain->seq = NULL;
+        chain->cur++;
+    }
+
+    if (member_off > CHAIN_OFFSET_MASK) {
+        *err = WTAP_ERR_INTERNAL;
+        *err_info = g_strdup_printf("chain: offset %" G_GINT64_MODIFIER "d in \"%s\" is too large to pack into a seek offset",
+                                    member_off,
+                                    chain->members[chain->cur].filename);
+        return FALSE;
+    }
+    chain_mirror_interface_data(wth, chain->seq);
+    *data_offset = ((gint64)chain->cur << CHAIN_OFFSET_BITS) | member_off;
+    return TRUE;
+}
+
+/*
+ * Return an open random-access handle for the given member, opening it
+ * if need be and evicting the least recently used member's handle if
+ * we're at the open-handle limit.
+ */
+static wtap *
+chain_open_random(chain_t *chain, guint idx, int *err, gchar **err_info)
+{
+    chain_member_t *member = &chain->members[idx];
+
+    if (member->rnd == NULL) {
+        if (chain->n_open_rnd >= CHAIN_MAX_OPEN_RANDOM) {
+            chain_member_t *victim = NULL;
+            guint i;
+
+            for (i = 0; i < chain->n_members; i++) {
+                if (chain->members[i].rnd != NULL &&
+                    (victim == NULL || chain->members[i].lru_gen < victim->lru_gen)) {
+                    victim = &chain->members[i];
+                }
+            }
+            ws_assert(victim != NULL);
+            ws_debug("chain: evicting \"%s\" to open member %u",
+                     victim->filename, idx);
+            wtap_close(victim->rnd);
+            victim->rnd = NULL;
+            chain->n_open_rnd--;
+        }
+        member->rnd = wtap_open_offline(member->filename, WTAP_TYPE_AUTO,
+                                        err, err_info, TRUE);
+        if (member->rnd == NULL)
+            return NULL;
+        chain->n_open_rnd++;
+    }
+    member->lru_gen = ++chain->lru_counter;
+    return member->rnd;
+}
+
+static gboolean
+chain_seek_read(wtap *wth, gint64 seek_off, wtap_rec *rec, Buffer *buf,
+                int *err, gchar **err_info)
+{
+    chain_t *chain = (chain_t *)wth->priv;
+    guint idx = (guint)(seek_off >> CHAIN_OFFSET_BITS);
+    wtap *member;
+
+    if (idx >= chain->n_members) {
+        *err = WTAP_ERR_INTERNAL;
+        *err_info = g_strdup_printf("chain: seek offset refers to member %u of a %u-file set",
+                                    idx, chain->n_members);
+        return FALSE;
+    }
+    member = chain_open_random(chain, idx, err, err_info);
+    if (member == NULL)
+        return FALSE;
+    return wtap_seek_read(member, seek_off & CHAIN_OFFSET_MASK, rec, buf,
+                          err, err_info);
+}
+
+static void
+chain_sequential_close(wtap *wth)
+{
+    chain_t *chain = (chain_t *)wth->priv;
+
+    /*
+     * wth->fh aliases the current member's stream, which the member
+     * owns; clear the alias so wtap_sequential_close() doesn't close
+     * it a second time.
+     */
+    wth->fh = NULL;
+    if (chain->seq != NULL) {
+        wtap_close(chain->seq);
+        chain->seq = NULL;
+    }
+}
+
+static void
+chain_close(wtap *wth)
+{
+    chain_t *chain = (chain_t *)wth->priv;
+    guint i;
+
+    /* wtap_close() has already done the sequential close. */
+    for (i = 0; i < chain->n_members; i++) {
+        if (chain->members[i].rnd != NULL)
+            wtap_close(chain->members[i].rnd);
+        g_free(chain->members[i].filename);
+    }
+    g_free(chain->members);
+    /* The chain_t itself is wth->priv and is freed by wtap_close(). */
+}
+
+wtap *
+wtap_chain_open_offline(const char *const *filenames, guint n_files,
+                        int *err, gchar **err_info, guint *err_fileno)
+{
+    chain_t *chain;
+    wtap *wth;
+    wtap *first;
+    guint i;
+
+    *err_fileno = 0;
+    if (n_files < 1 || n_files > CHAIN_MAX_MEMBERS) {
+        *err = WTAP_ERR_INTERNAL;
+        *err_info = g_strdup_printf("chain: %u files is outside the supported range of 1 to %u",
+                                    n_files, CHAIN_MAX_MEMBERS);
+        return NULL;
+    }
+
+    /*
+     * Open the first member now; it determines the file type,
+     * encapsulation, snapshot length and time stamp precision the
+     * virtual capture reports, and sequential reading starts in it.
+     * The other members are only opened when reading reaches them.
+     */
+    first = wtap_open_offline(filenames[0], WTAP_TYPE_AUTO, err, err_info,
+                              FALSE);
+    if (first == NULL)
+        return NULL;
+
+    chain = g_new0(chain_t, 1);
+    chain->members = g_new0(chain_member_t, n_files);
+    chain->n_members = n_files;
+    for (i = 0; i < n_files; i++)
+        chain->members[i].filename = g_strdup(filenames[i]);
+    chain->cur = 0;
+    chain->seq = first;
+
+    wth = g_new0(wtap, 1);
+    g_mutex_init(&wth->read_mtx);
+    wth->fh = first->fh;        /* alias; see chain_read() */
+    wth->random_fh = NULL;
+    wth->file_type_subtype = wtap_file_type_subtype(first);
+    wth->snapshot_length = wtap_snapshot_length(first);
+    wth->file_encap = wtap_file_encap(first);
+    wth->file_tsprec = wtap_file_tsprec(first);
+    wth->pathname = g_strdup(filenames[0]);
+    wth->priv = chain;
+    wth->subtype_read = chain_read;
+    wth->subtype_seek_read = chain_seek_read;
+    wth->subtype_sequential_close = chain_sequential_close;
+    wth->subtype_close = chain_close;
+
+    /*
+     * The section and interface description blocks of the virtual
+     * capture are copies of those of the first member; chain_read()
+     * mirrors further interface descriptions as members declare them.
+     */
+    wth->shb_hdrs = g_array_new(FALSE, FALSE, sizeof(wtap_block_t));
+    for (i = 0; i < first->shb_hdrs->len; i++) {
+        wtap_block_t shb = wtap_block_make_copy(g_array_index(first->shb_hdrs,
+                                                              wtap_block_t, i));
+        g_array_append_val(wth->shb_hdrs, shb);
+    }
+    wth->interface_data = g_array_new(FALSE, FALSE, sizeof(wtap_block_t));
+    chain_mirror_interface_data(wth, first);
+    wth->next_interface_data = 0;
+
+    return wth;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local Variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
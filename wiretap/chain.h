@@ -0,0 +1,79 @@
+/* chain.h
+ * Definitions for routines for reading a set of capture files as one
+ * virtual, concatenated capture.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __CHAIN_H__
+#define __CHAIN_H__
+
+#include "wiretap/wtap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Open a list of capture files as a single virtual capture.
+ *
+ * The files are presented, in the order given, as one seamless sequence
+ * of records behind an ordinary wtap handle; wtap_read() walks the member
+ * files in turn and wtap_seek_read() works on any record of any member.
+ * This is intended for browsing multi-file capture sets (ring buffers,
+ * "multiple files" captures) without merging them to a temporary file
+ * and without the memory cost of holding more than a few files' worth
+ * of reader state at a time:
+ *
+ *  - member files are only opened when the read position reaches them
+ *    (sequential) or when a record in them is revisited (random access);
+ *
+ *  - at most a small, fixed number of member files are kept open for
+ *    random access; the least recently used member is closed, and all
+ *    of its reader state discarded, when the limit is reached.
+ *
+ * The seek offsets handed out for the virtual capture encode the member
+ * file in their upper bits, so the set is limited to 32767 files and to
+ * members smaller than 256 TiB - comfortable bounds for ring buffers.
+ *
+ * The members are expected to be homogeneous, as the files of a ring
+ * buffer are: the virtual capture reports the file type, encapsulation,
+ * snapshot length and time stamp precision of the first member, and
+ * per-packet interface IDs are resolved against the interface
+ * descriptions the members (identically) declare.  The handle is
+ * read-only; to persist the set as one file, merge it with wiretap's
+ * merge routines instead.
+ *
+ * @param filenames array of member file names, in presentation order
+ * @param n_files number of entries in filenames; must be at least 1
+ * @param err wiretap error, if failed
+ * @param err_info wiretap error string, if failed
+ * @param err_fileno set to the index of the file being opened on failure
+ * @return a wtap handle on success, NULL on failure
+ */
+WS_DLL_PUBLIC wtap *
+wtap_chain_open_offline(const char *const *filenames, guint n_files,
+                        int *err, gchar **err_info, guint *err_fileno);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __CHAIN_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local Variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
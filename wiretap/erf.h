@@ -32,6 +32,12 @@ struct erf_private {
   guint64 implicit_host_id;
   guint64 capture_gentime;
   guint64 host_gentime;
+  /*
+   * Scratch list of the anchor mappings seen in the record currently being
+   * read, reused from record to record so reading doesn't allocate and free
+   * an array per record.
+   */
+  GPtrArray* anchor_mappings_to_update;
 };
 
 #define MIN_RECORDS_FOR_ERF_CHECK 3
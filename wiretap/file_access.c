@@ -463,6 +463,114 @@ struct open_info *open_routines = NULL;
 /* this points to the first OPEN_INFO_HEURISTIC type in the array */
 static guint heuristic_open_routine_idx = 0;
 
+/*
+ * Magic-number prefilter for the OPEN_INFO_MAGIC open routines.
+ *
+ * Most magic-number formats can be definitively ruled out by looking at
+ * a few bytes at a fixed offset near the beginning of the file.  Rather
+ * than letting every open routine read and seek for itself just to say
+ * "not mine", wtap_open_offline() reads the first bytes once and skips
+ * routines whose declared signature can't possibly match.
+ *
+ * A routine may declare more than one signature (byte-order variants,
+ * format generations); it is skipped only if every one of its
+ * signatures definitively mismatches.  Routines with no entry here
+ * (MIME files, the XML-based formats, Lua readers, ...) are always
+ * tried.  The prefilter never *selects* a format - the open routines
+ * still run, in the usual order, and do the real validation - so a
+ * signature listed here must be a necessary condition for its open
+ * routine to succeed, as checked by that routine itself.
+ */
+#define OPEN_MAGIC_PREFIX_SIZE	24
+
+struct open_info_magic {
+	wtap_open_routine_t open_routine;
+	guint offset;		/* offset of the signature in the file */
+	guint len;		/* number of significant bytes */
+	const guint8 magic[20];	/* offset + len must fit in the prefix */
+};
+
+static const struct open_info_magic open_info_magics[] = {
+	{ libpcap_open,    0,  4, { 0xa1, 0xb2, 0xc3, 0xd4 } },
+	{ libpcap_open,    0,  4, { 0xd4, 0xc3, 0xb2, 0xa1 } },
+	{ libpcap_open,    0,  4, { 0xa1, 0xb2, 0xcd, 0x34 } },
+	{ libpcap_open,    0,  4, { 0x34, 0xcd, 0xb2, 0xa1 } },
+	{ libpcap_open,    0,  4, { 0xa1, 0xb2, 0x3c, 0x4d } },
+	{ libpcap_open,    0,  4, { 0x4d, 0x3c, 0xb2, 0xa1 } },
+	{ libpcap_open,    0,  4, { 0x1c, 0x00, 0x01, 0xac } },
+	{ libpcap_open,    0,  4, { 0xac, 0x01, 0x00, 0x1c } },
+	{ libpcap_open,    0,  4, { 0x1c, 0x00, 0x01, 0xab } },
+	{ libpcap_open,    0,  4, { 0xab, 0x01, 0x00, 0x1c } },
+	/* The SHB type is the same in both byte orders. */
+	{ pcapng_open,     0,  4, { 0x0a, 0x0d, 0x0d, 0x0a } },
+	{ ngsniffer_open,  0, 17, { 'T', 'R', 'S', 'N', 'I', 'F', 'F', ' ',
+				    'd', 'a', 't', 'a', ' ', ' ', ' ', ' ',
+				    0x1a } },
+	{ snoop_open,      0,  8, { 's', 'n', 'o', 'o', 'p', 0, 0, 0 } },
+	/* Common prefix of the "iptrace 1.0" and "iptrace 2.0" headers. */
+	{ iptrace_open,    0,  8, { 'i', 'p', 't', 'r', 'a', 'c', 'e', ' ' } },
+	{ netmon_open,     0,  4, { 'R', 'T', 'S', 'S' } },
+	{ netmon_open,     0,  4, { 'G', 'M', 'B', 'U' } },
+	{ netxray_open,    0,  4, { 'V', 'L', 0, 0 } },
+	{ netxray_open,    0,  4, { 'X', 'C', 'P', 0 } },
+	/* Bytes 1 and 2 of the RADCOM magic vary, so don't check them. */
+	{ radcom_open,     3,  5, { 0x34, 0x12, 0x66, 0x22, 0x88 } },
+	{ nettl_open,      0, 12, { 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+				    0x00, 0x00, 0x00, 0x07, 0xd0, 0x00 } },
+	{ nettl_open,      0, 12, { 0x54, 0x52, 0x00, 0x64, 0x00, 0x00,
+				    0x00, 0x00, 0x00, 0x00, 0x00, 0x80 } },
+	{ visual_open,     0,  4, { 5, 'V', 'N', 'F' } },
+	{ _5views_open,    0,  4, { 0xaa, 0xaa, 0xaa, 0xaa } },
+	{ observer_open,   0, 17, { 'O', 'b', 's', 'e', 'r', 'v', 'e', 'r',
+				    'P', 'k', 't', 'B', 'u', 'f', 'f', 'e',
+				    'r' } },
+	{ peektagged_open, 0,  4, { 0x7f, 'v', 'e', 'r' } },
+	{ capsa_open,      0,  4, { 'c', 'p', 's', 'e' } },
+	{ k12_open,        0,  8, { 0x00, 0x00, 0x02, 0x00, 0x12, 0x05,
+				    0x00, 0x10 } },
+	{ catapult_dct2000_open,
+			   0, 18, { 'S', 'e', 's', 's', 'i', 'o', 'n', ' ',
+				    'T', 'r', 'a', 'n', 's', 'c', 'r', 'i',
+				    'p', 't' } },
+	{ aethra_open,     0,  5, { 'V', '0', '2', '0', '8' } },
+	{ btsnoop_open,    0,  8, { 'b', 't', 's', 'n', 'o', 'o', 'p', 0 } },
+	{ eyesdn_open,     0,  6, { 'E', 'y', 'e', 'S', 'D', 'N' } },
+	/* TNEF_SIGNATURE, little-endian. */
+	{ tnef_open,       0,  4, { 0x78, 0x9f, 0x3e, 0x22 } },
+	{ blf_open,        0,  4, { 'L', 'O', 'G', 'G' } },
+	{ mplog_open,      0,  6, { 'M', 'P', 'C', 'S', 'I', 'I' } },
+	{ dpa400_open,     0,  4, { 'D', 'B', 'F', 'R' } },
+	{ mp4_open,        4,  4, { 'f', 't', 'y', 'p' } },
+};
+
+/*
+ * Can the file whose first bytes are in "prefix" possibly be handled by
+ * this open routine?  Returns FALSE only if the routine has at least one
+ * declared signature and the prefix definitively mismatches all of them.
+ */
+static gboolean
+open_routine_magic_possible(wtap_open_routine_t open_routine,
+    const guint8 *prefix, gint prefix_len)
+{
+	gboolean have_signature = FALSE;
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS(open_info_magics); i++) {
+		const struct open_info_magic *im = &open_info_magics[i];
+
+		if (im->open_routine != open_routine)
+			continue;
+		have_signature = TRUE;
+		if (prefix_len < 0 || (guint)prefix_len < im->offset + im->len) {
+			/* Not enough bytes to rule this signature out. */
+			return TRUE;
+		}
+		if (memcmp(prefix + im->offset, im->magic, im->len) == 0)
+			return TRUE;
+	}
+	return !have_signature;
+}
+
 static void
 set_heuristic_routine(void)
 {
@@ -770,6 +878,8 @@ wtap_open_offline(const char *filename, unsigned int type, int *err, char **err_
 	gboolean use_stdin = FALSE;
 	gchar *extension;
 	wtap_block_t shb;
+	guint8 magic_prefix[OPEN_MAGIC_PREFIX_SIZE];
+	gint magic_prefix_len;
 
 	*err = 0;
 	*err_info = NULL;
@@ -834,6 +944,7 @@ wtap_open_offline(const char *filename, unsigned int type, int *err, char **err_
 
 	errno = ENOMEM;
 	wth = g_new0(wtap, 1);
+	g_mutex_init(&wth->read_mtx);
 
 	/* Open the file */
 	errno = WTAP_ERR_CANT_OPEN;
@@ -946,8 +1057,23 @@ wtap_open_offline(const char *filename, unsigned int type, int *err, char **err_
 		}
 	}
 
+	/*
+	 * Read the first few bytes of the file once, so the magic-number
+	 * prefilter can rule formats out without every open routine
+	 * re-reading and seeking for itself.  A short read just means
+	 * fewer formats can be ruled out, and a read error will be hit
+	 * again, and properly reported, by the first open routine.
+	 */
+	magic_prefix_len = file_read(magic_prefix, sizeof magic_prefix, wth->fh);
+
 	/* Try all file types that support magic numbers */
 	for (i = 0; i < heuristic_open_routine_idx; i++) {
+		/* Skip file types whose declared magic number can't match
+		   the bytes we read. */
+		if (!open_routine_magic_possible(open_routines[i].open_routine,
+		    magic_prefix, magic_prefix_len))
+			continue;
+
 		/* Seek back to the beginning of the file; the open routine
 		   for the previous file type may have left the file
 		   position somewhere other than the beginning, and the
@@ -1161,6 +1287,98 @@ success:
 	return wth;
 }
 
+gboolean
+wtap_probe_file(const char *filename, guint32 max_records, double max_seconds,
+    wtap_probe_info *info, int *err, gchar **err_info)
+{
+	wtap *wth;
+	wtap_rec rec;
+	Buffer buf;
+	gint64 data_offset = 0;
+	gint64 scan_start;
+	gboolean hit_budget = FALSE;
+
+	memset(info, 0, sizeof *info);
+	info->file_type_subtype = WTAP_FILE_TYPE_SUBTYPE_UNKNOWN;
+
+	wth = wtap_open_offline(filename, WTAP_TYPE_AUTO, err, err_info, FALSE);
+	if (wth == NULL)
+		return FALSE;
+
+	info->file_type_subtype = wtap_file_type_subtype(wth);
+	info->file_size = wtap_file_size(wth, err);
+	*err = 0;
+
+	if (max_records == 0) {
+		/* Identification only; nothing was scanned, so nothing
+		 * can be said about the records. */
+		wtap_close(wth);
+		return TRUE;
+	}
+
+	/* Only the record metadata matters here; let the file reader
+	 * seek past the packet data where the format allows it. */
+	wtap_set_skip_packet_data(wth, TRUE);
+
+	scan_start = g_get_monotonic_time();
+	wtap_rec_init(&rec);
+	ws_buffer_init(&buf, 1514);
+	while (wtap_read(wth, &rec, &buf, err, err_info, &data_offset)) {
+		if (rec.presence_flags & WTAP_HAS_TS) {
+			if (!info->have_times) {
+				info->start_time = rec.ts;
+				info->stop_time = rec.ts;
+				info->have_times = TRUE;
+			}
+			if (nstime_cmp(&rec.ts, &info->start_time) < 0)
+				info->start_time = rec.ts;
+			if (nstime_cmp(&rec.ts, &info->stop_time) > 0)
+				info->stop_time = rec.ts;
+		}
+
+		switch (rec.rec_type) {
+
+		case REC_TYPE_PACKET:
+		case REC_TYPE_FT_SPECIFIC_EVENT:
+		case REC_TYPE_FT_SPECIFIC_REPORT:
+		case REC_TYPE_SYSCALL:
+		case REC_TYPE_SYSTEMD_JOURNAL_EXPORT:
+			info->data_records++;
+			break;
+		}
+
+		info->records++;
+		if (info->records >= max_records ||
+		    (max_seconds > 0 && (info->records % 1000) == 0 &&
+		     (double)(g_get_monotonic_time() - scan_start) / G_USEC_PER_SEC >= max_seconds)) {
+			hit_budget = TRUE;
+			break;
+		}
+	}
+	wtap_rec_cleanup(&rec);
+	ws_buffer_free(&buf);
+
+	/*
+	 * An EOF ends the loop with *err still zero; anything non-zero
+	 * is a read error that ended the scan early, which we report to
+	 * the caller alongside what was scanned up to that point.
+	 */
+	info->scan_complete = (*err == 0 && !hit_budget);
+	if (info->scan_complete) {
+		info->est_data_records = info->data_records;
+	} else if (data_offset > 0 && info->file_size > data_offset) {
+		/* Assume the rest of the file looks like the part we
+		 * scanned. */
+		info->est_data_records = (guint32)((double)info->data_records *
+		    (double)info->file_size / (double)data_offset);
+	} else {
+		info->est_data_records = info->data_records;
+	}
+
+	wtap_close(wth);
+	return TRUE;
+}
+
 /*
  * Given the pathname of the file we just closed with wtap_fdclose(), attempt
  * to reopen that file and assign the new file descriptor(s) to the sequential
@@ -23,11 +23,19 @@
 #include <wsutil/file_util.h>
 #include <wsutil/ws_assert.h>
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
 #ifdef HAVE_ZLIB
 #define ZLIB_CONST
 #include <zlib.h>
 #endif /* HAVE_ZLIB */
 
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif /* HAVE_ZSTD */
+
 /*
  * See RFC 1952:
  *
@@ -54,6 +62,9 @@ static struct compression_type {
 } compression_types[] = {
 #ifdef HAVE_ZLIB
     { WTAP_GZIP_COMPRESSED, "gz", "gzip compressed" },
+#endif
+#ifdef HAVE_ZSTD
+    { WTAP_ZSTD_COMPRESSED, "zst", "zstd compressed" },
 #endif
     { WTAP_UNCOMPRESSED, NULL, NULL }
 };
@@ -61,10 +72,7 @@ static struct compression_type {
 wtap_compression_type
 wtap_get_compression_type(wtap *wth)
 {
-	gboolean is_compressed;
-
-	is_compressed = file_iscompressed((wth->fh == NULL) ? wth->random_fh : wth->fh);
-	return is_compressed ? WTAP_GZIP_COMPRESSED : WTAP_UNCOMPRESSED;
+	return file_get_compression_type((wth->fh == NULL) ? wth->random_fh : wth->fh);
 }
 
 const char *
@@ -112,7 +120,10 @@ typedef enum {
     UNCOMPRESSED,  /* uncompressed - copy input directly */
 #ifdef HAVE_ZLIB
     ZLIB,          /* decompress a zlib stream */
-    GZIP_AFTER_HEADER
+    GZIP_AFTER_HEADER,
+#endif
+#ifdef HAVE_ZSTD
+    ZSTD           /* decompress a zstd frame */
 #endif
 } compression_t;
 
@@ -136,6 +147,16 @@ struct wtap_reader {
     gint64 raw;                 /* where the raw data started, for seeking */
     compression_t compression;  /* type of compression, if any */
     gboolean is_compressed;     /* FALSE if completely uncompressed, TRUE otherwise */
+    wtap_compression_type compression_type; /* external compression type of the file */
+
+    /* Zero-copy delivery of uncompressed data.  When the underlying file
+       is a regular file that we managed to map into memory, uncompressed
+       data is served by pointing the output buffer directly into the
+       mapping rather than by read()ing and copying; out_base keeps the
+       malloc'ed output buffer so it can be restored (and freed). */
+    unsigned char *mapped;      /* base of the file mapping, or NULL */
+    gint64 mapped_size;         /* size of the file mapping */
+    unsigned char *out_base;    /* malloc'ed output buffer */
 
     /* seek request */
     gint64 skip;                /* amount to skip (already rewound if backwards) */
@@ -149,6 +170,9 @@ struct wtap_reader {
     /* zlib inflate stream */
     z_stream strm;              /* stream structure in-place (not a pointer) */
     gboolean dont_check_crc;    /* TRUE if we aren't supposed to check the CRC */
+#endif
+#ifdef HAVE_ZSTD
+    ZSTD_DStream *zstd_dstream; /* zstd decompression stream */
 #endif
     /* fast seeking */
     GPtrArray *fast_seek;
@@ -643,6 +667,56 @@ DIAG_ON(cast-qual)
 }
 #endif
 
+#ifdef HAVE_ZSTD
+static void
+zstd_read(FILE_T state, unsigned char *buf, unsigned int count)
+{
+    ZSTD_outBuffer output = {buf, count, 0};
+
+    /* fill the output buffer up to the end of the frame or an error */
+    for (;;) {
+        ZSTD_inBuffer input;
+        size_t ret;
+
+        /* get more input for ZSTD_decompressStream() */
+        if (state->in.avail == 0 && fill_in_buffer(state) == -1)
+            break;
+        if (state->in.avail == 0) {
+            /* EOF in the middle of a frame */
+            state->err = WTAP_ERR_SHORT_READ;
+            state->err_info = NULL;
+            break;
+        }
+
+        input.src = state->in.next;
+        input.size = state->in.avail;
+        input.pos = 0;
+
+        /* decompress and handle errors */
+        ret = ZSTD_decompressStream(state->zstd_dstream, &output, &input);
+        state->in.next += input.pos;
+        state->in.avail -= (guint)input.pos;
+        if (ZSTD_isError(ret)) {
+            state->err = WTAP_ERR_DECOMPRESS;
+            state->err_info = ZSTD_getErrorName(ret);
+            break;
+        }
+        if (ret == 0) {
+            /* End of frame; look for another frame header (zstd files
+               may be a concatenation of frames), once have is 0. */
+            state->compression = UNKNOWN;
+            break;
+        }
+        if (output.pos == output.size)
+            break;
+    }
+
+    /* update available output */
+    state->out.next = buf;
+    state->out.avail = (guint)output.pos;
+}
+#endif
+
 static int
 gz_head(FILE_T state)
 {
@@ -768,6 +842,7 @@ gz_head(FILE_T state)
                 state->strm.adler = crc32(0L, Z_NULL, 0);
                 state->compression = ZLIB;
                 state->is_compressed = TRUE;
+                state->compression_type = WTAP_GZIP_COMPRESSED;
 #ifdef Z_BLOCK
                 if (state->fast_seek) {
                     struct zlib_cur_seek_point *cur = g_new(struct zlib_cur_seek_point,1);
@@ -805,6 +880,25 @@ gz_head(FILE_T state)
             state->in.next--;
         }
     }
+#ifdef HAVE_ZSTD
+    /* Look for the 4-byte zstd frame magic, 28 B5 2F FD (the little-endian
+       encoding of 0xFD2FB528).  Unlike the gzip case we don't consume it;
+       ZSTD_decompressStream() parses the whole frame, magic included. */
+    while (state->in.avail < 4 && !state->eof) {
+        if (fill_in_buffer(state) == -1)
+            return -1;
+    }
+    if (state->in.avail >= 4 &&
+        state->in.next[0] == 0x28 && state->in.next[1] == 0xb5 &&
+        state->in.next[2] == 0x2f && state->in.next[3] == 0xfd) {
+        /* set up for decompression */
+        ZSTD_initDStream(state->zstd_dstream);
+        state->compression = ZSTD;
+        state->is_compressed = TRUE;
+        state->compression_type = WTAP_ZSTD_COMPRESSED;
+        return 0;
+    }
+#endif /* HAVE_ZSTD */
 #ifdef HAVE_LIBXZ
     /* { 0xFD, '7', 'z', 'X', 'Z', 0x00 } */
     /* FD 37 7A 58 5A 00 */
@@ -842,6 +936,37 @@ fill_out_buffer(FILE_T state)
             return 0;
     }
     if (state->compression == UNCOMPRESSED) {           /* straight copy */
+        if (state->mapped != NULL) {
+            /* Zero copy: point the output buffer directly at the file
+               mapping.  state->raw_pos is the offset of the next raw
+               byte to deliver; serve in bounded chunks so offsets
+               within the buffer keep fitting in a guint. */
+            gint64 left = state->mapped_size - state->raw_pos;
+
+            if (left > 0) {
+                state->out.buf = state->mapped + state->raw_pos;
+                state->out.next = state->out.buf;
+                state->out.avail = (guint)MIN(left, G_GINT64_CONSTANT(0x40000000));
+                state->raw_pos += state->out.avail;
+                return 0;
+            }
+            /* We've run off the end of the mapping.  That's not
+               necessarily the end of the file - the file may have grown
+               since we mapped it, e.g. a capture file still being
+               written to - so don't declare EOF here; fall through to
+               the buffered path and read() whatever was appended.
+               The mapped path never read()s, so the file offset is
+               stale; seek to the next raw byte, and point the output
+               buffer back at the malloc'ed buffer, as buf_read()
+               writes into it. */
+            if (ws_lseek64(state->fd, state->raw_pos, SEEK_SET) == -1) {
+                state->err = errno;
+                state->err_info = NULL;
+                return -1;
+            }
+            state->out.buf = state->out_base;
+            buf_reset(&state->out);
+        }
         if (buf_read(state, &state->out) < 0)
             return -1;
     }
@@ -849,6 +974,11 @@ fill_out_buffer(FILE_T state)
     else if (state->compression == ZLIB) {      /* decompress */
         zlib_read(state, state->out.buf, state->size << 1);
     }
+#endif
+#ifdef HAVE_ZSTD
+    else if (state->compression == ZSTD) {      /* decompress */
+        zstd_read(state, state->out.buf, state->size << 1);
+    }
 #endif
     return 0;
 }
@@ -892,6 +1022,10 @@ gz_skip(FILE_T state, gint64 len)
 static void
 gz_reset(FILE_T state)
 {
+    /* The output buffer may have been pointed into the file mapping;
+       restore the malloc'ed buffer, as gz_head() and the decompressors
+       write into it. */
+    state->out.buf = state->out_base;
     buf_reset(&state->out);       /* no output data available */
     state->eof = FALSE;           /* not at end of file */
     state->compression = UNKNOWN; /* look for gzip header */
@@ -946,6 +1080,7 @@ file_fdopen(int fd)
 
     /* we don't yet know whether it's compressed */
     state->is_compressed = FALSE;
+    state->compression_type = WTAP_UNCOMPRESSED;
 
     /* save the current position for rewinding (only if reading) */
     state->start = ws_lseek64(state->fd, 0, SEEK_CUR);
@@ -977,6 +1112,7 @@ file_fdopen(int fd)
     state->out.buf = (unsigned char *)g_try_malloc(((gsize)want) << 1);
     state->out.next = state->out.buf;
     state->out.avail = 0;
+    state->out_base = state->out.buf;
     state->size = want;
     if (state->in.buf == NULL || state->out.buf == NULL) {
         g_free(state->out.buf);
@@ -986,6 +1122,27 @@ file_fdopen(int fd)
         return NULL;
     }
 
+#ifdef HAVE_SYS_MMAN_H
+    /* If this is a non-empty regular file, try to map it so uncompressed
+       data can be served without read()ing and copying.  Failure just
+       means we fall back to buffered reads, as does reading from a pipe
+       or any other non-mappable descriptor. */
+    {
+        ws_statb64 statb;
+
+        if (ws_fstat64(fd, &statb) >= 0 && S_ISREG(statb.st_mode) &&
+            statb.st_size > 0 &&
+            (guint64)statb.st_size <= (guint64)(G_MAXSIZE / 2)) {
+            void *map = mmap(NULL, (size_t)statb.st_size, PROT_READ,
+                             MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED) {
+                state->mapped = (unsigned char *)map;
+                state->mapped_size = statb.st_size;
+            }
+        }
+    }
+#endif
+
 #ifdef HAVE_ZLIB
     /* allocate inflate memory */
     state->strm.zalloc = Z_NULL;
@@ -1004,6 +1161,21 @@ file_fdopen(int fd)
     /* for now, assume we should check the crc */
     state->dont_check_crc = FALSE;
 #endif
+
+#ifdef HAVE_ZSTD
+    /* allocate the zstd decompression stream */
+    state->zstd_dstream = ZSTD_createDStream();
+    if (state->zstd_dstream == NULL) {
+#ifdef HAVE_ZLIB
+        inflateEnd(&(state->strm));
+#endif
+        g_free(state->out.buf);
+        g_free(state->in.buf);
+        g_free(state);
+        errno = ENOMEM;
+        return NULL;
+    }
+#endif
     /* return stream */
     return state;
 }
@@ -1382,6 +1554,12 @@ file_iscompressed(FILE_T stream)
     return stream->is_compressed;
 }
 
+wtap_compression_type
+file_get_compression_type(FILE_T stream)
+{
+    return stream->compression_type;
+}
+
 int
 file_read(void *buf, unsigned int len, FILE_T file)
 {
@@ -1650,9 +1828,18 @@ file_close(FILE_T file)
 #ifdef HAVE_ZLIB
         inflateEnd(&(file->strm));
 #endif
-        g_free(file->out.buf);
+#ifdef HAVE_ZSTD
+        ZSTD_freeDStream(file->zstd_dstream);
+#endif
+        /* file->out.buf may point into the mapping; free the malloc'ed
+           buffer. */
+        g_free(file->out_base);
         g_free(file->in.buf);
     }
+#ifdef HAVE_SYS_MMAN_H
+    if (file->mapped != NULL)
+        munmap(file->mapped, (size_t)file->mapped_size);
+#endif
     g_free(file->fast_seek_cur);
     file->err = 0;
     file->err_info = NULL;
@@ -1667,6 +1854,33 @@ file_close(FILE_T file)
 }
 
 #ifdef HAVE_ZLIB
+/* When writing on a multi-core machine, we carve the uncompressed stream
+   into fixed-size chunks and compress each chunk as an independent gzip
+   member on a pool of worker threads, writing the members out in
+   submission order.  A concatenation of gzip members is itself a valid
+   gzip stream - this is the same trick pigz uses - and both zlib and our
+   own reader handle it. */
+#define GZW_CHUNK_SIZE (1024 * 1024)
+
+/* Worst case for deflate is a series of stored blocks: 5 bytes of block
+   header per 16K of input, plus the gzip header and trailer. */
+#define GZW_OUT_BOUND (GZW_CHUNK_SIZE + (GZW_CHUNK_SIZE >> 11) + 64)
+
+/* A chunk moving through the parallel compressor.  Jobs circulate from
+   the free queue (filled by the thread calling gzwfile_write()) to the
+   compression queue (drained by the workers) to the done queue (drained
+   by the writing thread, which puts them back on the free queue). */
+struct gzw_job {
+    unsigned seq;           /* submission order, for in-order writing */
+    unsigned char *in;      /* GZW_CHUNK_SIZE bytes of uncompressed data */
+    guint in_len;           /* amount of uncompressed data in "in" */
+    unsigned char *out;     /* GZW_OUT_BOUND bytes for the gzip member */
+    guint out_len;          /* size of the compressed member in "out" */
+    gboolean quit;          /* sentinel telling a thread to exit */
+    int err;                /* error code from compressing this chunk */
+    const char *err_info;   /* additional error information string */
+};
+
 /* internal gzip file state data structure for writing */
 struct wtap_writer {
     int fd;                 /* file descriptor */
@@ -1682,8 +1896,314 @@ struct wtap_writer {
     const char *err_info;   /* additional error information string for some errors */
     /* zlib deflate stream */
     z_stream strm;          /* stream structure in-place (not a pointer) */
+    /* parallel compression state; workers is NULL on the serial path */
+    GThread **workers;      /* compression worker threads */
+    guint n_workers;
+    GThread *writer;        /* thread writing members out in order */
+    GAsyncQueue *free_q;    /* idle jobs */
+    GAsyncQueue *comp_q;    /* jobs waiting for a worker */
+    GAsyncQueue *done_q;    /* compressed jobs waiting to be written */
+    struct gzw_job *jobs;   /* the job array, for freeing */
+    guint n_jobs;
+    struct gzw_job **pending; /* writer-side reorder window, n_jobs wide */
+    struct gzw_job *cur;    /* chunk currently being filled, if any */
+    unsigned next_seq;      /* sequence number for the next chunk */
+    GMutex err_mtx;         /* guards err/err_info against the threads */
 };
 
+/* Record an error from one of the compression or writing threads.  The
+   first error wins, as in the serial path. */
+static void
+gzw_record_err(GZWFILE_T state, int err, const char *err_info)
+{
+    g_mutex_lock(&state->err_mtx);
+    if (state->err == Z_OK) {
+        state->err = err;
+        state->err_info = err_info;
+    }
+    g_mutex_unlock(&state->err_mtx);
+}
+
+/* Compression worker: pop chunks, deflate each one into a complete gzip
+   member, and hand them to the writing thread.  Each worker has its own
+   deflate stream, reset for every chunk. */
+static gpointer
+gzw_compress_worker(gpointer data)
+{
+    GZWFILE_T state = (GZWFILE_T)data;
+    struct gzw_job *job;
+    z_stream strm;
+    gboolean strm_ok;
+    int ret;
+
+    memset(&strm, 0, sizeof strm);
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    strm_ok = (deflateInit2(&strm, state->level, Z_DEFLATED,
+                            15 + 16, 8, state->strategy) == Z_OK);
+
+    for (;;) {
+        job = (struct gzw_job *)g_async_queue_pop(state->comp_q);
+        if (job->quit)
+            break;
+        if (!strm_ok) {
+            /* This means "not enough memory". */
+            job->err = ENOMEM;
+            job->out_len = 0;
+        } else {
+            (void)deflateReset(&strm);
+            strm.next_in = job->in;
+            strm.avail_in = job->in_len;
+            strm.next_out = job->out;
+            strm.avail_out = GZW_OUT_BOUND;
+            ret = deflate(&strm, Z_FINISH);
+            if (ret != Z_STREAM_END) {
+                /* The output buffer is sized for the worst case, so
+                   this "shouldn't happen". */
+                job->err = WTAP_ERR_INTERNAL;
+                job->err_info = "deflate() didn't finish a chunk";
+                job->out_len = 0;
+            } else
+                job->out_len = GZW_OUT_BOUND - strm.avail_out;
+        }
+        g_async_queue_push(state->done_q, job);
+    }
+    if (strm_ok)
+        (void)deflateEnd(&strm);
+    return NULL;
+}
+
+/* Writing thread: collect compressed chunks, which finish in any order,
+   and write them to the file in submission order.  After an error, keep
+   recycling jobs so gzwfile_write() never blocks on an empty free queue,
+   but stop writing. */
+static gpointer
+gzw_write_worker(gpointer data)
+{
+    GZWFILE_T state = (GZWFILE_T)data;
+    struct gzw_job *job;
+    unsigned next_seq = 0;
+    gboolean failed = FALSE;
+    ssize_t got;
+
+    for (;;) {
+        job = (struct gzw_job *)g_async_queue_pop(state->done_q);
+        if (job->quit)
+            break;
+        /* At most n_jobs chunks are ever in flight, so seq % n_jobs
+           can't collide within the reorder window. */
+        state->pending[job->seq % state->n_jobs] = job;
+        while ((job = state->pending[next_seq % state->n_jobs]) != NULL) {
+            state->pending[next_seq % state->n_jobs] = NULL;
+            next_seq++;
+            if (job->err != 0) {
+                gzw_record_err(state, job->err, job->err_info);
+                failed = TRUE;
+            } else if (!failed && job->out_len != 0) {
+                got = ws_write(state->fd, job->out, job->out_len);
+                if (got < 0) {
+                    gzw_record_err(state, errno, NULL);
+                    failed = TRUE;
+                } else if ((guint)got != job->out_len) {
+                    gzw_record_err(state, WTAP_ERR_SHORT_WRITE, NULL);
+                    failed = TRUE;
+                }
+            }
+            job->err = 0;
+            job->err_info = NULL;
+            g_async_queue_push(state->free_q, job);
+        }
+    }
+    return NULL;
+}
+
+/* Set up the parallel compressor.  Return -1 without touching state->err
+   if it's not worth it (one core) or we can't get the chunk buffers, in
+   which case the caller falls back to the serial path; return 0 on
+   success. */
+static int
+gz_parallel_init(GZWFILE_T state)
+{
+    guint i;
+
+    state->n_workers = MIN(g_get_num_processors(), 8);
+    if (state->n_workers < 2)
+        return -1;
+
+    /* Enough jobs to keep every worker busy while the writing thread
+       catches up; roughly 2 MB of buffer per job. */
+    state->n_jobs = 2 * state->n_workers + 2;
+    state->jobs = g_try_new0(struct gzw_job, state->n_jobs);
+    if (state->jobs == NULL)
+        return -1;
+    for (i = 0; i < state->n_jobs; i++) {
+        state->jobs[i].in = (unsigned char *)g_try_malloc(GZW_CHUNK_SIZE);
+        state->jobs[i].out = (unsigned char *)g_try_malloc(GZW_OUT_BOUND);
+        if (state->jobs[i].in == NULL || state->jobs[i].out == NULL) {
+            for (; ; i--) {
+                g_free(state->jobs[i].out);
+                g_free(state->jobs[i].in);
+                if (i == 0)
+                    break;
+            }
+            g_free(state->jobs);
+            state->jobs = NULL;
+            return -1;
+        }
+    }
+
+    state->pending = g_new0(struct gzw_job *, state->n_jobs);
+    state->free_q = g_async_queue_new();
+    state->comp_q = g_async_queue_new();
+    state->done_q = g_async_queue_new();
+    g_mutex_init(&state->err_mtx);
+    for (i = 0; i < state->n_jobs; i++)
+        g_async_queue_push(state->free_q, &state->jobs[i]);
+    state->cur = NULL;
+    state->next_seq = 0;
+
+    state->writer = g_thread_new("gzwfile_writer", gzw_write_worker, state);
+    state->workers = g_new(GThread *, state->n_workers);
+    for (i = 0; i < state->n_workers; i++)
+        state->workers[i] = g_thread_new("gzwfile_deflate",
+                                         gzw_compress_worker, state);
+    return 0;
+}
+
+/* Hand the chunk being filled to the workers. */
+static void
+gz_parallel_submit(GZWFILE_T state)
+{
+    state->cur->seq = state->next_seq++;
+    g_async_queue_push(state->comp_q, state->cur);
+    state->cur = NULL;
+}
+
+/* Wait until every in-flight chunk has been compressed and written: all
+   jobs are home when we can pop the whole pool off the free queue.  The
+   chunk being filled, if any, must have been submitted or put back
+   first. */
+static void
+gz_parallel_drain(GZWFILE_T state)
+{
+    struct gzw_job **held;
+    guint i;
+
+    held = g_new(struct gzw_job *, state->n_jobs);
+    for (i = 0; i < state->n_jobs; i++)
+        held[i] = (struct gzw_job *)g_async_queue_pop(state->free_q);
+    for (i = 0; i < state->n_jobs; i++)
+        g_async_queue_push(state->free_q, held[i]);
+    g_free(held);
+}
+
+/* Buffer len bytes from buf into chunks, submitting each chunk to the
+   workers as it fills.  Returns the number of bytes accepted; errors
+   from the threads surface on a later call, just as errors for data
+   buffered by the serial path do. */
+static unsigned
+gz_parallel_write(GZWFILE_T state, const void *buf, guint len)
+{
+    guint put = len;
+    guint n;
+
+    while (len != 0) {
+        if (state->cur == NULL) {
+            state->cur = (struct gzw_job *)g_async_queue_pop(state->free_q);
+            state->cur->in_len = 0;
+        }
+        n = GZW_CHUNK_SIZE - state->cur->in_len;
+        if (n > len)
+            n = len;
+        memcpy(state->cur->in + state->cur->in_len, buf, n);
+        state->cur->in_len += n;
+        state->pos += n;
+        buf = (const char *)buf + n;
+        len -= n;
+        if (state->cur->in_len == GZW_CHUNK_SIZE)
+            gz_parallel_submit(state);
+    }
+    return put;
+}
+
+/* Flush the parallel compressor: submit the partial chunk, if any, as a
+   (short) gzip member of its own and wait for everything to reach the
+   file.  Returns -1 if a thread reported an error; returns 0 on
+   success. */
+static int
+gz_parallel_flush(GZWFILE_T state)
+{
+    int err;
+
+    if (state->cur != NULL) {
+        if (state->cur->in_len != 0)
+            gz_parallel_submit(state);
+        else {
+            g_async_queue_push(state->free_q, state->cur);
+            state->cur = NULL;
+        }
+    }
+    gz_parallel_drain(state);
+    g_mutex_lock(&state->err_mtx);
+    err = state->err;
+    g_mutex_unlock(&state->err_mtx);
+    return err != Z_OK ? -1 : 0;
+}
+
+/* Flush out all data written, shut the thread pool down, free memory,
+   and close the file.  Returns a Wiretap error on failure; returns 0 on
+   success. */
+static int
+gz_parallel_close(GZWFILE_T state)
+{
+    struct gzw_job quit_job;
+    guint i;
+    int ret = 0;
+
+    /* If nothing was ever submitted, write a single empty member so the
+       file is still a valid gzip stream, as the serial path does. */
+    if (state->cur == NULL && state->next_seq == 0) {
+        state->cur = (struct gzw_job *)g_async_queue_pop(state->free_q);
+        state->cur->in_len = 0;
+        gz_parallel_submit(state);
+    }
+    if (gz_parallel_flush(state) == -1) {
+        g_mutex_lock(&state->err_mtx);
+        ret = state->err;
+        g_mutex_unlock(&state->err_mtx);
+    }
+
+    memset(&quit_job, 0, sizeof quit_job);
+    quit_job.quit = TRUE;
+    for (i = 0; i < state->n_workers; i++)
+        g_async_queue_push(state->comp_q, &quit_job);
+    for (i = 0; i < state->n_workers; i++)
+        g_thread_join(state->workers[i]);
+    g_async_queue_push(state->done_q, &quit_job);
+    g_thread_join(state->writer);
+
+    /* the threads are gone; no more locking needed */
+    if (ret == 0 && state->err != Z_OK)
+        ret = state->err;
+    for (i = 0; i < state->n_jobs; i++) {
+        g_free(state->jobs[i].out);
+        g_free(state->jobs[i].in);
+    }
+    g_free(state->jobs);
+    g_free(state->pending);
+    g_free(state->workers);
+    g_async_queue_unref(state->free_q);
+    g_async_queue_unref(state->comp_q);
+    g_async_queue_unref(state->done_q);
+    g_mutex_clear(&state->err_mtx);
+    state->err = Z_OK;
+    if (ws_close(state->fd) == -1 && ret == 0)
+        ret = errno;
+    g_free(state);
+    return ret;
+}
+
 GZWFILE_T
 gzwfile_open(const char *path)
 {
@@ -1724,6 +2244,7 @@ gzwfile_fdopen(int fd)
     state->err_info = NULL;         /* clear additional error information */
     state->pos = 0;                 /* no uncompressed data yet */
     state->strm.avail_in = 0;       /* no input data yet */
+    state->workers = NULL;          /* no thread pool unless we start one */
 
     /* return stream */
     return state;
@@ -1854,16 +2375,25 @@ gzwfile_write(GZWFILE_T state, const void *buf, guint len)
     strm = &(state->strm);
 
     /* check that there's no error */
-    if (state->err != Z_OK)
+    if (gzwfile_geterr(state) != Z_OK)
         return 0;
 
     /* if len is zero, avoid unnecessary operations */
     if (len == 0)
         return 0;
 
-    /* allocate memory if this is the first time through */
-    if (state->size == 0 && gz_init(state) == -1)
-        return 0;
+    /* set up the compressor if this is the first time through; prefer
+       the parallel compressor, falling back to in-line deflate on a
+       single-core machine or if we can't get the chunk buffers */
+    if (state->size == 0) {
+        if (gz_parallel_init(state) == 0)
+            state->size = state->want;  /* mark state as initialized */
+        else if (gz_init(state) == -1)
+            return 0;
+    }
+
+    if (state->workers != NULL)
+        return gz_parallel_write(state, buf, len);
 
     /* for small len, copy to input buffer, otherwise compress directly */
     if (len < state->size) {
@@ -1918,9 +2448,12 @@ int
 gzwfile_flush(GZWFILE_T state)
 {
     /* check that there's no error */
-    if (state->err != Z_OK)
+    if (gzwfile_geterr(state) != Z_OK)
         return -1;
 
+    if (state->workers != NULL)
+        return gz_parallel_flush(state);
+
     /* compress remaining data with Z_SYNC_FLUSH */
     gz_comp(state, Z_SYNC_FLUSH);
     if (state->err != Z_OK)
@@ -1935,6 +2468,9 @@ gzwfile_close(GZWFILE_T state)
 {
     int ret = 0;
 
+    if (state->workers != NULL)
+        return gz_parallel_close(state);
+
     /* flush, free memory, and close file */
     if (gz_comp(state, Z_FINISH) == -1 && ret == 0)
         ret = state->err;
@@ -1951,6 +2487,15 @@ gzwfile_close(GZWFILE_T state)
 int
 gzwfile_geterr(GZWFILE_T state)
 {
+    int err;
+
+    if (state->workers != NULL) {
+        /* the writing thread may be recording an error right now */
+        g_mutex_lock(&state->err_mtx);
+        err = state->err;
+        g_mutex_unlock(&state->err_mtx);
+        return err;
+    }
     return state->err;
 }
 #endif
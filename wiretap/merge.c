@@ -204,21 +204,147 @@ merge_select_frame_type(int in_file_count, merge_in_file_t in_files[])
 }
 
 /*
- * returns TRUE if first argument is earlier than second
+ * A binary min-heap over the input files that currently have a record
+ * available, with the file whose record should be written next at the
+ * top.  This makes picking the next record O(log n) in the number of
+ * input files rather than O(n); with many inputs (e.g. a large set of
+ * ring-buffer files) the per-record rescan of every file dominates the
+ * merge, and the heap removes it.
+ */
+typedef struct {
+    int     *files;     /* indices into in_files[], heap-ordered */
+    guint    count;     /* number of entries in use */
+    gboolean primed;    /* TRUE once every file has been read from */
+    int      last;      /* file whose record was most recently returned */
+} merge_record_heap_t;
+
+static merge_record_heap_t *
+merge_record_heap_new(guint in_file_count)
+{
+    merge_record_heap_t *heap = g_new(merge_record_heap_t, 1);
+
+    heap->files  = g_new(int, in_file_count);
+    heap->count  = 0;
+    heap->primed = FALSE;
+    heap->last   = -1;
+    return heap;
+}
+
+static void
+merge_record_heap_free(merge_record_heap_t *heap)
+{
+    if (heap != NULL) {
+        g_free(heap->files);
+        g_free(heap);
+    }
+}
+
+/*
+ * Returns TRUE if file a's current record should be written before file
+ * b's.  Records with no time stamp are treated as earlier than all other
+ * records; yes, this means you won't get a chronological merge of those
+ * records, but you obviously *can't* get that.  Ties are broken so that
+ * the order matches what the old linear scan over the files produced.
  */
 static gboolean
-is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
+record_is_before(merge_in_file_t in_files[], int a, int b)
 {
-    if (l->secs > r->secs) {  /* left is later */
-        return FALSE;
-    } else if (l->secs < r->secs) { /* left is earlier */
-        return TRUE;
-    } else if (l->nsecs > r->nsecs) { /* tv_sec equal, l.usec later */
-        return FALSE;
+    wtap_rec *rec_a = &in_files[a].rec;
+    wtap_rec *rec_b = &in_files[b].rec;
+    gboolean  a_has_ts = (rec_a->presence_flags & WTAP_HAS_TS) != 0;
+    gboolean  b_has_ts = (rec_b->presence_flags & WTAP_HAS_TS) != 0;
+    int       cmp;
+
+    if (!a_has_ts || !b_has_ts) {
+        if (a_has_ts != b_has_ts)
+            return !a_has_ts;
+        /* Neither record has a time stamp; take them in file order. */
+        return a < b;
     }
-    /* either one < two or one == two
-     * either way, return one
+    cmp = nstime_cmp(&rec_a->ts, &rec_b->ts);
+    if (cmp != 0)
+        return cmp < 0;
+    /*
+     * Equal time stamps.  The linear scan kept looking on a tie, so the
+     * last file with the earliest time stamp won; preserve that.
      */
+    return a > b;
+}
+
+static void
+record_heap_push(merge_record_heap_t *heap, merge_in_file_t in_files[],
+                 int file)
+{
+    guint child = heap->count++;
+
+    heap->files[child] = file;
+    while (child > 0) {
+        guint parent = (child - 1) / 2;
+
+        if (!record_is_before(in_files, heap->files[child],
+                              heap->files[parent]))
+            break;
+        heap->files[child]  = heap->files[parent];
+        heap->files[parent] = file;
+        child = parent;
+    }
+}
+
+/*
+ * Remove and return the top of the heap, or -1 if it's empty.
+ */
+static int
+record_heap_pop(merge_record_heap_t *heap, merge_in_file_t in_files[])
+{
+    int   top, moved;
+    guint parent, child;
+
+    if (heap->count == 0)
+        return -1;
+    top = heap->files[0];
+    moved = heap->files[--heap->count];
+    heap->files[0] = moved;
+    parent = 0;
+    for (;;) {
+        child = 2 * parent + 1;
+        if (child >= heap->count)
+            break;
+        if (child + 1 < heap->count &&
+            record_is_before(in_files, heap->files[child + 1],
+                             heap->files[child]))
+            child++;
+        if (!record_is_before(in_files, heap->files[child], moved))
+            break;
+        heap->files[parent] = heap->files[child];
+        heap->files[child]  = moved;
+        parent = child;
+    }
+    return top;
+}
+
+/*
+ * Read the next record from an input file into its slot in in_files[]
+ * and, if one is available, push the file onto the heap.  Returns FALSE
+ * on a read error.
+ */
+static gboolean
+merge_fill_in_file(merge_record_heap_t *heap, merge_in_file_t in_files[],
+                   int i, int *err, gchar **err_info)
+{
+    gint64 data_offset;
+
+    if (!wtap_read(in_files[i].wth, &in_files[i].rec,
+                   &in_files[i].frame_buffer, err, err_info,
+                   &data_offset)) {
+        if (*err != 0) {
+            in_files[i].state = GOT_ERROR;
+            return FALSE;
+        }
+        in_files[i].state = AT_EOF;
+    } else {
+        in_files[i].state = RECORD_PRESENT;
+        record_heap_push(heap, in_files, i);
+    }
     return TRUE;
 }
 
@@ -236,6 +362,8 @@ is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
  *
  * @param in_file_count number of entries in in_files
  * @param in_files input file array
+ * @param heap heap of files with a record available, from
+ * merge_record_heap_new()
  * @param err wiretap error, if failed
  * @param err_info wiretap error string, if failed
  * @return pointer to merge_in_file_t for file from which that packet
@@ -244,69 +372,45 @@ is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
  */
 static merge_in_file_t *
 merge_read_packet(int in_file_count, merge_in_file_t in_files[],
-                  int *err, gchar **err_info)
+                  merge_record_heap_t *heap, int *err, gchar **err_info)
 {
     int i;
-    int ei = -1;
-    nstime_t tv = NSTIME_INIT_MAX;
-    wtap_rec *rec;
-
-    /*
-     * Make sure we have a record available from each file that's not at
-     * EOF, and search for the record with the earliest time stamp or
-     * with no time stamp (those records are treated as earlier than
-     * all other records).  Yes, this means you won't get a chronological
-     * merge of those records, but you obviously *can't* get that.
-     */
-    for (i = 0; i < in_file_count; i++) {
-        gint64 data_offset;
-
-        if (in_files[i].state == RECORD_NOT_PRESENT) {
-            /*
-             * No packet available, and we haven't seen an error or EOF yet,
-             * so try to read the next packet.
-             */
-            if (!wtap_read(in_files[i].wth, &in_files[i].rec,
-                           &in_files[i].frame_buffer, err, err_info,
-                           &data_offset)) {
-                if (*err != 0) {
-                    in_files[i].state = GOT_ERROR;
-                    return &in_files[i];
-                }
-                in_files[i].state = AT_EOF;
-            } else
-                in_files[i].state = RECORD_PRESENT;
-        }
+    int ei;
 
-        if (in_files[i].state == RECORD_PRESENT) {
-            rec = &in_files[i].rec;
-            if (!(rec->presence_flags & WTAP_HAS_TS)) {
-                /*
-                 * No time stamp.  Pick this record, and stop looking.
-                 */
-                ei = i;
-                break;
-            }
-            if (is_earlier(&rec->ts, &tv)) {
-                /*
-                 * This record's time stamp is earlier than any of the
-                 * records we've seen so far.  Pick it, for now, but
-                 * keep looking.
-                 */
-                tv = rec->ts;
-                ei = i;
-            }
+    if (!heap->primed) {
+        /*
+         * First call; read an initial record from every input file to
+         * seed the heap.
+         */
+        for (i = 0; i < in_file_count; i++) {
+            if (!merge_fill_in_file(heap, in_files, i, err, err_info))
+                return &in_files[i];
         }
+        heap->primed = TRUE;
+    } else if (heap->last != -1) {
+        /*
+         * Now that the caller is done with the record we returned on the
+         * previous call, replace it with the next record from the same
+         * file.  We can't do that any earlier, as the read would reuse
+         * the record and frame buffer the caller was still using.
+         */
+        i = heap->last;
+        heap->last = -1;
+        if (!merge_fill_in_file(heap, in_files, i, err, err_info))
+            return &in_files[i];
     }
 
+    ei = record_heap_pop(heap, in_files);
     if (ei == -1) {
         /* All the streams are at EOF.  Return an EOF indication. */
         *err = 0;
         return NULL;
     }
 
-    /* We'll need to read another packet from this file. */
+    /* We'll need to read another packet from this file, once the caller
+     * has consumed this one. */
     in_files[ei].state = RECORD_NOT_PRESENT;
+    heap->last = ei;
 
     /* Count this packet. */
     in_files[ei].packet_num++;
@@ -845,6 +949,7 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
 {
     merge_result        status = MERGE_OK;
     merge_in_file_t    *in_file;
+    merge_record_heap_t *record_heap = merge_record_heap_new(in_file_count);
     int                 count = 0;
     gboolean            stop_flag = FALSE;
     wtap_rec *rec,      snap_rec;
@@ -857,8 +962,8 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
                                                err_info);
         }
         else {
-            in_file = merge_read_packet(in_file_count, in_files, err,
-                                        err_info);
+            in_file = merge_read_packet(in_file_count, in_files, record_heap,
+                                        err, err_info);
         }
 
         if (in_file == NULL) {
@@ -947,6 +1052,8 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
         }
     }
 
+    merge_record_heap_free(record_heap);
+
     if (cb)
         cb->callback_func(MERGE_EVENT_DONE, count, in_files, in_file_count, cb->data);
 
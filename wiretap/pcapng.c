@@ -1559,7 +1559,8 @@ static gboolean
 pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh,
                          const section_info_t *section_info,
                          wtapng_block_t *wblock,
-                         int *err, gchar **err_info, gboolean enhanced)
+                         int *err, gchar **err_info, gboolean enhanced,
+                         gboolean skip_data)
 {
     guint block_read;
     guint opt_cont_buf_len;
@@ -1740,17 +1741,29 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh,
     wblock->rec->ts.secs = (time_t)(ts / iface_info.time_units_per_second);
     wblock->rec->ts.nsecs = (int)(((ts % iface_info.time_units_per_second) * 1000000000) / iface_info.time_units_per_second);
 
-    /* "(Enhanced) Packet Block" read capture data */
-    if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
-                                packet.cap_len - pseudo_header_len, err, err_info))
-        return FALSE;
-    block_read += packet.cap_len - pseudo_header_len;
-
-    /* jump over potential padding bytes at end of the packet data */
-    if (padding != 0) {
-        if (!wtap_read_bytes(fh, NULL, padding, err, err_info))
+    if (skip_data) {
+        /*
+         * The caller doesn't want the packet data, so seek past it and
+         * any padding; for an uncompressed file that avoids even reading
+         * the data.
+         */
+        if (file_seek(fh, packet.cap_len - pseudo_header_len + padding,
+                      SEEK_CUR, err) == -1)
+            return FALSE;
+        block_read += packet.cap_len - pseudo_header_len + padding;
+    } else {
+        /* "(Enhanced) Packet Block" read capture data */
+        if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
+                                    packet.cap_len - pseudo_header_len, err, err_info))
             return FALSE;
-        block_read += padding;
+        block_read += packet.cap_len - pseudo_header_len;
+
+        /* jump over potential padding bytes at end of the packet data */
+        if (padding != 0) {
+            if (!wtap_read_bytes(fh, NULL, padding, err, err_info))
+                return FALSE;
+            block_read += padding;
+        }
     }
 
     /* FCS length default */
@@ -1782,9 +1795,10 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh,
         wtap_block_add_uint64_option(wblock->block, OPT_PKT_DROPCOUNT, (guint64)packet.drops_count);
     }
 
-    pcap_read_post_process(FALSE, iface_info.wtap_encap,
-                           wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
-                           section_info->byte_swapped, fcslen);
+    if (!skip_data)
+        pcap_read_post_process(FALSE, iface_info.wtap_encap,
+                               wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
+                               section_info->byte_swapped, fcslen);
 
     /*
      * We return these to the caller in pcapng_read().
@@ -1808,7 +1822,8 @@ static gboolean
 pcapng_read_simple_packet_block(FILE_T fh, pcapng_block_header_t *bh,
                                 const section_info_t *section_info,
                                 wtapng_block_t *wblock,
-                                int *err, gchar **err_info)
+                                int *err, gchar **err_info,
+                                gboolean skip_data)
 {
     interface_info_t iface_info;
     pcapng_simple_packet_block_t spb;
@@ -1921,20 +1936,31 @@ pcapng_read_simple_packet_block(FILE_T fh, pcapng_block_header_t *bh,
 
     memset((void *)&wblock->rec->rec_header.packet_header.pseudo_header, 0, sizeof(union wtap_pseudo_header));
 
-    /* "Simple Packet Block" read capture data */
-    if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
-                                simple_packet.cap_len, err, err_info))
-        return FALSE;
-
-    /* jump over potential padding bytes at end of the packet data */
-    if ((simple_packet.cap_len % 4) != 0) {
-        if (!wtap_read_bytes(fh, NULL, 4 - (simple_packet.cap_len % 4), err, err_info))
+    if (skip_data) {
+        /*
+         * The caller doesn't want the packet data, so seek past it and
+         * any padding; for an uncompressed file that avoids even reading
+         * the data.
+         */
+        if (file_seek(fh, simple_packet.cap_len + padding, SEEK_CUR,
+                      err) == -1)
             return FALSE;
-    }
+    } else {
+        /* "Simple Packet Block" read capture data */
+        if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
+                                    simple_packet.cap_len, err, err_info))
+            return FALSE;
+
+        /* jump over potential padding bytes at end of the packet data */
+        if ((simple_packet.cap_len % 4) != 0) {
+            if (!wtap_read_bytes(fh, NULL, 4 - (simple_packet.cap_len % 4), err, err_info))
+                return FALSE;
+        }
 
-    pcap_read_post_process(FALSE, iface_info.wtap_encap,
-                           wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
-                           section_info->byte_swapped, iface_info.fcslen);
+        pcap_read_post_process(FALSE, iface_info.wtap_encap,
+                               wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
+                               section_info->byte_swapped, iface_info.fcslen);
+    }
 
     /*
      * We return these to the caller in pcapng_read().
@@ -2885,15 +2911,18 @@ pcapng_read_block(wtap *wth, FILE_T fh, pcapng_t *pn,
                     return FALSE;
                 break;
             case(BLOCK_TYPE_PB):
-                if (!pcapng_read_packet_block(fh, &bh, section_info, wblock, err, err_info, FALSE))
+                if (!pcapng_read_packet_block(fh, &bh, section_info, wblock, err, err_info, FALSE,
+                                              wth->skip_packet_data && fh == wth->fh))
                     return FALSE;
                 break;
             case(BLOCK_TYPE_SPB):
-                if (!pcapng_read_simple_packet_block(fh, &bh, section_info, wblock, err, err_info))
+                if (!pcapng_read_simple_packet_block(fh, &bh, section_info, wblock, err, err_info,
+                                                     wth->skip_packet_data && fh == wth->fh))
                     return FALSE;
                 break;
             case(BLOCK_TYPE_EPB):
-                if (!pcapng_read_packet_block(fh, &bh, section_info, wblock, err, err_info, TRUE))
+                if (!pcapng_read_packet_block(fh, &bh, section_info, wblock, err, err_info, TRUE,
+                                              wth->skip_packet_data && fh == wth->fh))
                     return FALSE;
                 break;
             case(BLOCK_TYPE_NRB):
@@ -3388,26 +3417,29 @@ pcapng_seek_read(wtap *wth, gint64 seek_off,
     ws_assert(pcapng->sections->len >= 1);
 
     /*
-     * Now scan backwards through the array to find the first section
-     * that begins at or before the offset of the block we're reading.
-     *
-     * Yes, that's O(n) in the number of blocks, but we're unlikely to
-     * have many blocks and pretty unlikely to have more than one.
+     * Binary-search the array for the last section that begins at or
+     * before the offset of the block we're reading.  The sections are
+     * added in the order in which they appear in the file, so the array
+     * is sorted by shb_off; files produced by merging many captures can
+     * have a fair number of sections, and this is done for every random
+     * access, so don't scan the array linearly.
      */
-    guint section_number = pcapng->sections->len - 1;
-    for (;;) {
+    guint low = 0, high = pcapng->sections->len - 1;
+    while (low < high) {
+        guint mid = low + (high - low + 1) / 2;
         section_info = &g_array_index(pcapng->sections, section_info_t,
-                                      section_number);
+                                      mid);
         if (section_info->shb_off <= seek_off)
-            break;
-
-        /*
-         * If that's section 0, something's wrong; that section should
-         * have an offset of 0.
-         */
-        ws_assert(section_number != 0);
-        section_number--;
+            low = mid;
+        else
+            high = mid - 1;
     }
+    section_info = &g_array_index(pcapng->sections, section_info_t, low);
+    /*
+     * If no section begins at or before the offset, something's wrong;
+     * section 0 should have an offset of 0.
+     */
+    ws_assert(section_info->shb_off <= seek_off);
 
     wblock.frame_buffer = buf;
     wblock.rec = rec;
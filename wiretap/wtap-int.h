@@ -28,6 +28,9 @@ int wtap_fstat(wtap *wth, ws_statb64 *statb, int *err);
 
 typedef gboolean (*subtype_read_func)(struct wtap*, wtap_rec *,
                                       Buffer *, int *, char **, gint64 *);
+typedef guint (*subtype_read_batch_func)(struct wtap*, wtap_rec *,
+                                         Buffer *, guint, int *, char **,
+                                         gint64 *);
 typedef gboolean (*subtype_seek_read_func)(struct wtap*, gint64, wtap_rec *,
                                            Buffer *, int *, char **);
 
@@ -37,6 +40,11 @@ typedef gboolean (*subtype_seek_read_func)(struct wtap*, gint64, wtap_rec *,
 struct wtap {
     FILE_T                      fh;
     FILE_T                      random_fh;              /**< Secondary FILE_T for random access */
+    GMutex                      read_mtx;               /**< Serializes reads on fh and random_fh; the two
+                                                             handles share mutable state such as the fast
+                                                             seek table and format-private data, so
+                                                             wtap_read() and wtap_seek_read() must not run
+                                                             concurrently on the same wtap */
     gboolean                    ispipe;                 /**< TRUE if the file is a pipe */
     int                         file_type_subtype;
     guint                       snapshot_length;
@@ -52,6 +60,7 @@ struct wtap {
     void                        *wslua_data;    /* this one holds wslua state info and is not free'd */
 
     subtype_read_func           subtype_read;
+    subtype_read_batch_func     subtype_read_batch;     /**< Optional; see wtap_read_batch() */
     subtype_seek_read_func      subtype_seek_read;
     void                        (*subtype_sequential_close)(struct wtap*);
     void                        (*subtype_close)(struct wtap*);
@@ -74,6 +83,8 @@ struct wtap {
     wtap_new_ipv4_callback_t    add_new_ipv4;
     wtap_new_ipv6_callback_t    add_new_ipv6;
     wtap_new_secrets_callback_t add_new_secrets;
+    gboolean                    skip_packet_data;       /**< TRUE if the caller only wants record metadata;
+                                                             see wtap_set_skip_packet_data() */
     GPtrArray                   *fast_seek;
 };
 
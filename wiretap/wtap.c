@@ -1454,6 +1454,8 @@ wtap_close(wtap *wth)
 	wtap_block_array_free(wth->interface_data);
 	wtap_block_array_free(wth->dsbs);
 
+	g_mutex_clear(&wth->read_mtx);
+
 	g_free(wth);
 }
 
@@ -1473,6 +1475,11 @@ void wtap_set_cb_new_ipv6(wtap *wth, wtap_new_ipv6_callback_t add_new_ipv6) {
 		wth->add_new_ipv6 = add_new_ipv6;
 }
 
+void wtap_set_skip_packet_data(wtap *wth, gboolean skip_packet_data) {
+	if (wth)
+		wth->skip_packet_data = skip_packet_data;
+}
+
 void wtap_set_cb_new_secrets(wtap *wth, wtap_new_secrets_callback_t add_new_secrets) {
 	/* Is a valid wth given that supports DSBs? */
 	if (!wth || !wth->dsbs)
@@ -1519,8 +1526,8 @@ wtap_init_rec(wtap *wth, wtap_rec *rec)
 	rec->block_was_modified = FALSE;
 }
 
-gboolean
-wtap_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err,
+static gboolean
+wtap_read_unlocked(wtap *wth, wtap_rec *rec, Buffer *buf, int *err,
 	gchar **err_info, gint64 *offset)
 {
 	/*
@@ -1568,6 +1575,59 @@ wtap_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err,
 	return TRUE;	/* success */
 }
 
+gboolean
+wtap_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err,
+	gchar **err_info, gint64 *offset)
+{
+	gboolean ret;
+
+	/*
+	 * Sequential and random reads share mutable state - the fast
+	 * seek table, format-private data such as the pcapng section
+	 * table - so they must not run concurrently on the same wtap;
+	 * a caller may well read ahead on one thread while another
+	 * thread seeks and reads already-visited records.
+	 */
+	g_mutex_lock(&wth->read_mtx);
+	ret = wtap_read_unlocked(wth, rec, buf, err, err_info, offset);
+	g_mutex_unlock(&wth->read_mtx);
+	return ret;
+}
+
+guint
+wtap_read_batch(wtap *wth, wtap_rec *recs, Buffer *bufs, guint max_records,
+	int *err, gchar **err_info, gint64 *offsets)
+{
+	guint n;
+
+	*err = 0;
+	*err_info = NULL;
+
+	g_mutex_lock(&wth->read_mtx);
+
+	/*
+	 * File formats with per-call setup costs worth amortizing can
+	 * provide a batched reader; for the rest, looping the one-record
+	 * path here still spares the caller a state transition per record.
+	 */
+	if (wth->subtype_read_batch != NULL) {
+		for (n = 0; n < max_records; n++)
+			wtap_init_rec(wth, &recs[n]);
+		n = wth->subtype_read_batch(wth, recs, bufs, max_records,
+		    err, err_info, offsets);
+		g_mutex_unlock(&wth->read_mtx);
+		return n;
+	}
+
+	for (n = 0; n < max_records; n++) {
+		if (!wtap_read_unlocked(wth, &recs[n], &bufs[n], err,
+		    err_info, &offsets[n]))
+			break;
+	}
+	g_mutex_unlock(&wth->read_mtx);
+	return n;
+}
+
 /*
  * Read a given number of bytes from a file into a buffer or, if
  * buf is NULL, just discard them.
@@ -1654,7 +1714,12 @@ wtap_read_packet_bytes(FILE_T fh, Buffer *buf, guint length, int *err,
 gint64
 wtap_read_so_far(wtap *wth)
 {
-	return file_tell_raw(wth->fh);
+	gint64 so_far;
+
+	g_mutex_lock(&wth->read_mtx);
+	so_far = file_tell_raw(wth->fh);
+	g_mutex_unlock(&wth->read_mtx);
+	return so_far;
 }
 
 /* Perform global/initial initialization */
@@ -1690,8 +1755,14 @@ wtap_seek_read(wtap *wth, gint64 seek_off, wtap_rec *rec, Buffer *buf,
 
 	*err = 0;
 	*err_info = NULL;
-	if (!wth->subtype_seek_read(wth, seek_off, rec, buf, err, err_info))
+
+	/* See wtap_read() for why reads must be serialized. */
+	g_mutex_lock(&wth->read_mtx);
+	if (!wth->subtype_seek_read(wth, seek_off, rec, buf, err, err_info)) {
+		g_mutex_unlock(&wth->read_mtx);
 		return FALSE;
+	}
+	g_mutex_unlock(&wth->read_mtx);
 
 	/*
 	 * Is this a packet record?
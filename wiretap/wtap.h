@@ -1681,6 +1681,44 @@ WS_DLL_PUBLIC
 struct wtap* wtap_open_offline(const char *filename, unsigned int type, int *err,
     gchar **err_info, gboolean do_random);
 
+/** Results of wtap_probe_file(). */
+typedef struct wtap_probe_info {
+    int      file_type_subtype; /**< One of WTAP_FILE_TYPE_SUBTYPE_ values */
+    gint64   file_size;         /**< Size of the file, in bytes */
+    guint32  records;           /**< Number of records scanned */
+    guint32  data_records;      /**< Data records among the scanned records */
+    gboolean scan_complete;     /**< TRUE if every record in the file was scanned */
+    guint32  est_data_records;  /**< data_records if the scan completed, otherwise
+                                     a file-size-based estimate */
+    gboolean have_times;        /**< TRUE if a scanned record had a time stamp */
+    nstime_t start_time;        /**< Earliest time stamp scanned */
+    nstime_t stop_time;         /**< Latest time stamp scanned */
+} wtap_probe_info;
+
+/**
+ * One-shot, bounded probe of a capture file's format and contents,
+ * for previews and type listings.  The file is opened without a random
+ * access stream, its record metadata is scanned with the packet data
+ * skipped, and it is closed again before this returns, so the cost is
+ * bounded even on slow remote file systems.
+ *
+ * @param filename Name of the file to probe
+ * @param max_records Stop scanning after this many records; 0 means
+ * don't scan records at all (identify the format only)
+ * @param max_seconds Stop scanning after (roughly) this much wall-clock
+ * time; 0 means no time bound
+ * @param[out] info Filled in with the probe results
+ * @param[out] err set as for wtap_open_offline() if the probe fails;
+ * set non-zero, with the probe succeeding, if a read error ended the
+ * scan early
+ * @param[out] err_info for some errors, a string giving more details of
+ * the error
+ * @return TRUE if the file was identified, FALSE on open failure
+ */
+WS_DLL_PUBLIC
+gboolean wtap_probe_file(const char *filename, guint32 max_records,
+    double max_seconds, wtap_probe_info *info, int *err, gchar **err_info);
+
 /**
  * If we were compiled with zlib and we're at EOF, unset EOF so that
  * wtap_read/gzread has a chance to succeed. This is necessary if
@@ -1709,6 +1747,20 @@ typedef void (*wtap_new_secrets_callback_t)(guint32 secrets_type, const void *se
 WS_DLL_PUBLIC
 void wtap_set_cb_new_secrets(wtap *wth, wtap_new_secrets_callback_t add_new_secrets);
 
+/**
+ * Tell the file reader that the caller only needs the record metadata -
+ * time stamps, lengths, interface IDs and the like - not the packet
+ * data, as when scanning a file for statistics.  File formats that
+ * support this skip over the packet data when reading sequentially,
+ * seeking past it if the underlying file is uncompressed, instead of
+ * copying it into the caller's buffer; the buffer contents for those
+ * records are undefined.  Other file formats ignore this and deliver
+ * the packet data as usual.  Currently pcapng-only.  This has no effect
+ * on wtap_seek_read(), which always delivers the packet data.
+ */
+WS_DLL_PUBLIC
+void wtap_set_skip_packet_data(wtap *wth, gboolean skip_packet_data);
+
 /** Read the next record in the file, filling in *phdr and *buf.
  *
  * @wth a wtap * returned by a call that opened a file for reading.
@@ -1728,6 +1780,32 @@ WS_DLL_PUBLIC
 gboolean wtap_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err,
     gchar **err_info, gint64 *offset);
 
+/** Read up to max_records records in one call, for callers that scan
+ * files at high record rates and want to amortize the per-call overhead
+ * of wtap_read() across a batch.
+ *
+ * @wth a wtap * returned by a call that opened a file for reading.
+ * @recs an array of max_records wtap_rec, each initialized with
+ * wtap_rec_init(), filled in with information about the records.
+ * @bufs an array of max_records Buffers, each initialized with
+ * ws_buffer_init(), filled in with data from the records.
+ * @max_records the size of the recs, bufs and offsets arrays.
+ * @param err a positive "errno" value, or a negative number indicating
+ * the type of error, if the batch ended on a read failure; 0 if it
+ * ended at the end of the file.
+ * @param err_info for some errors, a string giving more details of
+ * the error
+ * @param offsets an array of max_records gint64, set to the offsets in
+ * the file that should be used on calls to wtap_seek_read() to reread
+ * the records that were read.
+ * @return the number of records read, possibly 0.  A short count means
+ * the batch ended at the end of the file or on an error; look at *err
+ * to tell the two apart, as after wtap_read().
+ */
+WS_DLL_PUBLIC
+guint wtap_read_batch(wtap *wth, wtap_rec *recs, Buffer *bufs,
+    guint max_records, int *err, gchar **err_info, gint64 *offsets);
+
 /** Read the record at a specified offset in a capture file, filling in
  * *phdr and *buf.
  *
@@ -1761,7 +1839,8 @@ void wtap_rec_cleanup(wtap_rec *rec);
  */
 typedef enum {
     WTAP_UNCOMPRESSED,
-    WTAP_GZIP_COMPRESSED
+    WTAP_GZIP_COMPRESSED,
+    WTAP_ZSTD_COMPRESSED
 } wtap_compression_type;
 
 WS_DLL_PUBLIC
@@ -42,6 +42,7 @@
 #include <glib.h>
 
 #include <wsutil/epochs.h>
+#include <wsutil/ws_tracepoints.h>
 
 #include "pcapio.h"
 
@@ -188,6 +189,14 @@ write_to_file(FILE* pfile, const guint8* data, size_t data_length,
         return TRUE;
 }
 
+/* Records no bigger than this are gathered into one contiguous buffer
+   and written with a single fwrite() call, instead of one call per
+   header, data, padding and trailer.  At capture rates of hundreds of
+   thousands of packets per second the per-call stdio locking shows up
+   in profiles; virtually all records fit, and bigger ones just take the
+   multi-write path. */
+#define WRITE_GATHER_SIZE 4096
+
 /* Writing pcap files */
 
 /* Write the file header to a dump file.
@@ -221,10 +230,23 @@ libpcap_write_packet(FILE* pfile,
 {
         struct pcaprec_hdr rec_hdr;
 
+        WS_TRACEPOINT2(capture_write, caplen, len);
+
         rec_hdr.ts_sec = (guint32)sec; /* Y2.038K issue in pcap format.... */
         rec_hdr.ts_usec = usec;
         rec_hdr.incl_len = caplen;
         rec_hdr.orig_len = len;
+
+        /* Write header and data with one fwrite() call if they fit. */
+        if (sizeof(rec_hdr) + caplen <= WRITE_GATHER_SIZE) {
+                guint8 gather[WRITE_GATHER_SIZE];
+
+                memcpy(gather, &rec_hdr, sizeof(rec_hdr));
+                memcpy(gather + sizeof(rec_hdr), pd, caplen);
+                return write_to_file(pfile, gather, sizeof(rec_hdr) + caplen,
+                                     bytes_written, err);
+        }
+
         if (!write_to_file(pfile, (const guint8*)&rec_hdr, sizeof(rec_hdr), bytes_written, err))
                 return FALSE;
 
@@ -559,6 +581,8 @@ pcapng_write_enhanced_packet_block(FILE* pfile,
         guint8 i;
         guint8 pad_len = 0;
 
+        WS_TRACEPOINT2(capture_write, caplen, len);
+
         block_total_length = (guint32)(sizeof(struct epb) +
                                        ADD_PADDING(caplen) +
                                        sizeof(guint32));
@@ -581,14 +605,37 @@ pcapng_write_enhanced_packet_block(FILE* pfile,
         epb.timestamp_low = (guint32)(timestamp & 0xffffffff);
         epb.captured_len = caplen;
         epb.packet_len = len;
+        if(caplen % 4) {
+            pad_len = 4 - (caplen % 4);
+        }
+
+        /*
+         * If we have no options to write and the whole block fits in the
+         * gather buffer, write the block header, packet data, padding and
+         * block total length with one fwrite() call.
+         */
+        if(!comment && flags == 0 && options_length==0 &&
+           block_total_length <= WRITE_GATHER_SIZE){
+            guint8 gather[WRITE_GATHER_SIZE];
+            guint32 gather_len = 0;
+
+            memcpy(gather, &epb, sizeof(struct epb));
+            gather_len += (guint32)sizeof(struct epb);
+            memcpy(gather + gather_len, pd, caplen);
+            gather_len += caplen;
+            if (pad_len) {
+                memset(gather + gather_len, 0, pad_len);
+                gather_len += pad_len;
+            }
+            memcpy(gather + gather_len, &block_total_length, sizeof(guint32));
+            gather_len += (guint32)sizeof(guint32);
+            return write_to_file(pfile, gather, gather_len, bytes_written, err);
+        }
+
         if (!write_to_file(pfile, (const guint8*)&epb, sizeof(struct epb), bytes_written, err))
                 return FALSE;
         if (!write_to_file(pfile, pd, caplen, bytes_written, err))
                 return FALSE;
-        /* Use more efficient write in case of no "extras" */
-        if(caplen % 4) {
-            pad_len = 4 - (caplen % 4);
-        }
         /*
          * If we have no options to write, just write out the padding and
          * the block total length with one fwrite() call.
@@ -15,8 +15,25 @@
 
 #include "config.h"
 
+/* see bug 10798: there is a bug in the compiler the buildbots use for Mac OSX
+   and SSE4.2, so we're not going to use SSE4.2 with Mac OSX right now, for
+   older Mac OSX compilers.
+ */
+#ifdef __APPLE__
+#if defined(__clang__) && (__clang_major__ >= 6)
+/* allow HAVE_SSE4_2 to be used for clang 6.0+ case because we know it works */
+#else
+/* don't allow it otherwise, for Mac OSX */
+#undef HAVE_SSE4_2
+#endif
+#endif
+
 #include <glib.h>
 #include <wsutil/crc32.h>
+#include "crc32_int.h"
+#ifdef HAVE_SSE4_2
+#include "ws_cpuid.h"
+#endif
 
 #define CRC32_ACCUMULATE(c,d,table) (c=(c>>8)^(table)[(c^(d))&0xFF])
 
@@ -365,11 +382,28 @@ crc32_ccitt_table_lookup (guchar pos)
 	return crc32_ccitt_table[pos];
 }
 
+#ifdef HAVE_SSE4_2
+/* -1 = not probed yet; probe with cpuid once rather than per call. */
+static int crc32c_have_sse42 = -1;
+
+static gboolean
+crc32c_use_sse42(void)
+{
+	if (crc32c_have_sse42 < 0)
+		crc32c_have_sse42 = ws_cpuid_sse42() ? 1 : 0;
+	return crc32c_have_sse42 == 1;
+}
+#endif
+
 guint32
 crc32c_calculate(const void *buf, int len, guint32 crc)
 {
 	const guint8 *p = (const guint8 *)buf;
 	crc = CRC32C_SWAP(crc);
+#ifdef HAVE_SSE4_2
+	if (crc32c_use_sse42())
+		return CRC32C_SWAP(crc32c_sse42_calculate(buf, len, crc));
+#endif
 	while (len-- > 0) {
 		CRC32C(crc, *p++);
 	}
@@ -380,6 +414,11 @@ guint32
 crc32c_calculate_no_swap(const void *buf, int len, guint32 crc)
 {
 	const guint8 *p = (const guint8 *)buf;
+
+#ifdef HAVE_SSE4_2
+	if (crc32c_use_sse42())
+		return crc32c_sse42_calculate(buf, len, crc);
+#endif
 	while (len-- > 0) {
 		CRC32C(crc, *p++);
 	}
@@ -0,0 +1,79 @@
+/* crc32c_sse42.c
+ * CRC-32C (Castagnoli) computed with the SSE4.2 crc32 instruction
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#ifdef HAVE_SSE4_2
+
+#include <glib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <nmmintrin.h>
+
+#include <wsutil/crc32.h>
+#include "crc32_int.h"
+
+/*
+ * The crc32 instruction performs exactly the bit-reflected CRC-32C
+ * update that the table-driven loop in crc32.c does, so the hardware
+ * and table implementations can be mixed freely; the caller takes
+ * care of any seed/result byte swapping, as with the table version.
+ */
+guint32
+crc32c_sse42_calculate(const void *buf, int len, guint32 crc)
+{
+	const guint8 *p = (const guint8 *)buf;
+
+	/* Step up to an 8-byte boundary so the wide loads below are
+	   naturally aligned. */
+	while (len > 0 && ((uintptr_t)p & 7) != 0) {
+		crc = _mm_crc32_u8(crc, *p++);
+		len--;
+	}
+
+#if defined(__x86_64__) || defined(_M_X64)
+	while (len >= 8) {
+		guint64 chunk;
+
+		memcpy(&chunk, p, 8);
+		crc = (guint32)_mm_crc32_u64(crc, chunk);
+		p += 8;
+		len -= 8;
+	}
+#endif
+	while (len >= 4) {
+		guint32 chunk;
+
+		memcpy(&chunk, p, 4);
+		crc = _mm_crc32_u32(crc, chunk);
+		p += 4;
+		len -= 4;
+	}
+	while (len-- > 0)
+		crc = _mm_crc32_u8(crc, *p++);
+
+	return crc;
+}
+
+#endif /* HAVE_SSE4_2 */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
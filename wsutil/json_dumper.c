@@ -45,11 +45,50 @@ enum json_dumper_change {
     JSON_DUMPER_FINISH,
 };
 
+/*
+ * Output is batched into a buffer and written out to the file in large
+ * chunks; per-token fputc()/fputs() calls (each paying for stream locking)
+ * otherwise dominate the cost of dumping large documents.
+ */
+#define JSON_DUMPER_FLUSH_THRESHOLD (1024 * 1024)
+
+static void
+json_flush_buffer(json_dumper *dumper)
+{
+    if (dumper->output_buf && dumper->output_buf->len > 0) {
+        fwrite(dumper->output_buf->str, 1, dumper->output_buf->len, dumper->output_file);
+        g_string_truncate(dumper->output_buf, 0);
+    }
+}
+
+static GString *
+json_output_buf(json_dumper *dumper)
+{
+    if (!dumper->output_buf) {
+        dumper->output_buf = g_string_sized_new(4096);
+    } else if (dumper->output_buf->len >= JSON_DUMPER_FLUSH_THRESHOLD) {
+        json_flush_buffer(dumper);
+    }
+    return dumper->output_buf;
+}
+
+static inline void
+json_putc(json_dumper *dumper, char c)
+{
+    g_string_append_c(json_output_buf(dumper), c);
+}
+
+static inline void
+json_puts(json_dumper *dumper, const char *str)
+{
+    g_string_append(json_output_buf(dumper), str);
+}
+
 static void
-json_puts_string(FILE *fp, const char *str, gboolean dot_to_underscore)
+json_puts_string(json_dumper *dumper, const char *str, gboolean dot_to_underscore)
 {
     if (!str) {
-        fputs("null", fp);
+        json_puts(dumper, "null");
         return;
     }
 
@@ -58,25 +97,38 @@ json_puts_string(FILE *fp, const char *str, gboolean dot_to_underscore)
         "u0010", "u0011", "u0012", "u0013", "u0014", "u0015", "u0016", "u0017", "u0018", "u0019", "u001a", "u001b", "u001c", "u001d", "u001e", "u001f"
     };
 
-    fputc('"', fp);
+    GString *buf = json_output_buf(dumper);
+    int start = 0;
+
+    g_string_append_c(buf, '"');
     for (int i = 0; str[i]; i++) {
-        if ((guint)str[i] < 0x20) {
-            fputc('\\', fp);
-            fputs(json_cntrl[(guint)str[i]], fp);
-        } else if (i > 0 && str[i - 1] == '<' && str[i] == '/') {
-            // Convert </script> to <\/script> to avoid breaking web pages.
-            fputs("\\/", fp);
-        } else {
-            if (str[i] == '\\' || str[i] == '"') {
-                fputc('\\', fp);
+        guchar c = (guchar)str[i];
+        if (c < 0x20 || c == '\\' || c == '"' ||
+            (i > 0 && c == '/' && str[i - 1] == '<') ||
+            (dot_to_underscore && c == '.')) {
+            /* Copy the preceding run of plain characters in one go. */
+            if (i > start) {
+                g_string_append_len(buf, str + start, i - start);
+            }
+            if (c < 0x20) {
+                g_string_append_c(buf, '\\');
+                g_string_append(buf, json_cntrl[c]);
+            } else if (c == '/') {
+                // Convert </script> to <\/script> to avoid breaking web pages.
+                g_string_append(buf, "\\/");
+            } else if (dot_to_underscore && c == '.') {
+                g_string_append_c(buf, '_');
+            } else {
+                g_string_append_c(buf, '\\');
+                g_string_append_c(buf, c);
             }
-            if (dot_to_underscore && str[i] == '.')
-                fputc('_', fp);
-            else
-                fputc(str[i], fp);
+            start = i + 1;
         }
     }
-    fputc('"', fp);
+    if (str[start]) {
+        g_string_append(buf, str + start);
+    }
+    g_string_append_c(buf, '"');
 }
 
 /**
@@ -103,6 +155,7 @@ json_dumper_bad(json_dumper *dumper, enum json_dumper_change change,
         /* Console output can be slow, disable log calls to speed up fuzzing. */
         return;
     }
+    json_flush_buffer(dumper);
     fflush(dumper->output_file);
     ws_error("Bad json_dumper state: %s; change=%d type=%d depth=%d prev/curr/next state=%02x %02x %02x",
             what, change, type, dumper->current_depth, states[0], states[1], states[2]);
@@ -170,12 +223,12 @@ json_dumper_check_state(json_dumper *dumper, enum json_dumper_change change, enu
 }
 
 static void
-print_newline_indent(const json_dumper *dumper, int depth)
+print_newline_indent(json_dumper *dumper, int depth)
 {
     if ((dumper->flags & JSON_DUMPER_FLAGS_PRETTY_PRINT)) {
-        fputc('\n', dumper->output_file);
+        json_putc(dumper, '\n');
         for (int i = 0; i < depth; i++) {
-            fputs("  ", dumper->output_file);
+            json_puts(dumper, "  ");
         }
     }
 }
@@ -211,7 +264,7 @@ prepare_token(json_dumper *dumper)
     }
 
     if (dumper->state[dumper->current_depth]) {
-        fputc(',', dumper->output_file);
+        json_putc(dumper, ',');
     }
     print_newline_indent(dumper, dumper->current_depth);
 }
@@ -221,13 +274,13 @@ prepare_token(json_dumper *dumper)
  * necessary, it is preceded by newline and indentation).
  */
 static void
-finish_token(const json_dumper *dumper, char close_char)
+finish_token(json_dumper *dumper, char close_char)
 {
     // if the object/array was non-empty, add a newline and indentation.
     if (dumper->state[dumper->current_depth]) {
         print_newline_indent(dumper, dumper->current_depth - 1);
     }
-    fputc(close_char, dumper->output_file);
+    json_putc(dumper, close_char);
 }
 
 void
@@ -238,7 +291,7 @@ json_dumper_begin_object(json_dumper *dumper)
     }
 
     prepare_token(dumper);
-    fputc('{', dumper->output_file);
+    json_putc(dumper, '{');
 
     dumper->state[dumper->current_depth] = JSON_DUMPER_TYPE_OBJECT;
     ++dumper->current_depth;
@@ -253,10 +306,10 @@ json_dumper_set_member_name(json_dumper *dumper, const char *name)
     }
 
     prepare_token(dumper);
-    json_puts_string(dumper->output_file, name, dumper->flags & JSON_DUMPER_DOT_TO_UNDERSCORE);
-    fputc(':', dumper->output_file);
+    json_puts_string(dumper, name, dumper->flags & JSON_DUMPER_DOT_TO_UNDERSCORE);
+    json_putc(dumper, ':');
     if ((dumper->flags & JSON_DUMPER_FLAGS_PRETTY_PRINT)) {
-        fputc(' ', dumper->output_file);
+        json_putc(dumper, ' ');
     }
 
     dumper->state[dumper->current_depth - 1] |= JSON_DUMPER_HAS_NAME;
@@ -282,7 +335,7 @@ json_dumper_begin_array(json_dumper *dumper)
     }
 
     prepare_token(dumper);
-    fputc('[', dumper->output_file);
+    json_putc(dumper, '[');
 
     dumper->state[dumper->current_depth] = JSON_DUMPER_TYPE_ARRAY;
     ++dumper->current_depth;
@@ -309,7 +362,7 @@ json_dumper_value_string(json_dumper *dumper, const char *value)
     }
 
     prepare_token(dumper);
-    json_puts_string(dumper->output_file, value, FALSE);
+    json_puts_string(dumper, value, FALSE);
 
     dumper->state[dumper->current_depth] = JSON_DUMPER_TYPE_VALUE;
 }
@@ -324,9 +377,9 @@ json_dumper_value_double(json_dumper *dumper, double value)
     prepare_token(dumper);
     gchar buffer[G_ASCII_DTOSTR_BUF_SIZE] = { 0 };
     if (isfinite(value) && g_ascii_dtostr(buffer, G_ASCII_DTOSTR_BUF_SIZE, value) && buffer[0]) {
-        fputs(buffer, dumper->output_file);
+        json_puts(dumper, buffer);
     } else {
-        fputs("null", dumper->output_file);
+        json_puts(dumper, "null");
     }
 
     dumper->state[dumper->current_depth] = JSON_DUMPER_TYPE_VALUE;
@@ -340,7 +393,7 @@ json_dumper_value_va_list(json_dumper *dumper, const char *format, va_list ap)
     }
 
     prepare_token(dumper);
-    vfprintf(dumper->output_file, format, ap);
+    g_string_append_vprintf(json_output_buf(dumper), format, ap);
 
     dumper->state[dumper->current_depth] = JSON_DUMPER_TYPE_VALUE;
 }
@@ -362,7 +415,12 @@ json_dumper_finish(json_dumper *dumper)
         return FALSE;
     }
 
-    fputc('\n', dumper->output_file);
+    json_putc(dumper, '\n');
+    json_flush_buffer(dumper);
+    if (dumper->output_buf) {
+        g_string_free(dumper->output_buf, TRUE);
+        dumper->output_buf = NULL;
+    }
     dumper->state[0] = 0;
     return TRUE;
 }
@@ -379,7 +437,7 @@ json_dumper_begin_base64(json_dumper *dumper)
 
     prepare_token(dumper);
 
-    fputc('"', dumper->output_file);
+    json_putc(dumper, '"');
 
     dumper->state[dumper->current_depth] = JSON_DUMPER_TYPE_BASE64;
     ++dumper->current_depth;
@@ -399,7 +457,7 @@ json_dumper_write_base64(json_dumper* dumper, const guchar *data, size_t len)
     while (len > 0) {
         gsize chunk_size = len < CHUNK_SIZE ? len : CHUNK_SIZE;
         gsize output_size = g_base64_encode_step(data, chunk_size, FALSE, buf, &dumper->base64_state, &dumper->base64_save);
-        fwrite(buf, 1, output_size, dumper->output_file);
+        g_string_append_len(json_output_buf(dumper), buf, output_size);
         data += chunk_size;
         len -= chunk_size;
     }
@@ -418,9 +476,9 @@ json_dumper_end_base64(json_dumper *dumper)
     gsize wrote;
 
     wrote = g_base64_encode_close(FALSE, buf, &dumper->base64_state, &dumper->base64_save);
-    fwrite(buf, 1, wrote, dumper->output_file);
+    g_string_append_len(json_output_buf(dumper), buf, wrote);
 
-    fputc('"', dumper->output_file);
+    json_putc(dumper, '"');
 
     --dumper->current_depth;
 }
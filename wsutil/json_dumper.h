@@ -59,6 +59,10 @@ typedef struct json_dumper {
     int     current_depth;
     gint    base64_state;
     gint    base64_save;
+    /** Output batching buffer, allocated on first use. Data is written out
+     * to output_file when the buffer grows large enough and when
+     * json_dumper_finish() is called, which also releases the buffer. */
+    GString *output_buf;
     guint8  state[JSON_DUMPER_MAX_DEPTH];
 } json_dumper;
 
@@ -0,0 +1,143 @@
+/* pipeline_stats.c
+ * Per-stage counters for the capture-to-display pipeline
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <glib.h>
+
+#include "pipeline_stats.h"
+
+/*
+ * Stage latency is measured with per-stage checkpoint rings: every
+ * crossing appends (cumulative count, timestamp), and a downstream
+ * stage looks up when the upstream stage passed the packet it's about
+ * to pass itself. A bounded ring keeps the memory constant; if a
+ * stage falls more than CHECKPOINT_RING crossings behind, the oldest
+ * surviving checkpoint is used and the reported latency becomes a
+ * lower bound - which is fine, since by then the latency is the story.
+ */
+#define CHECKPOINT_RING 1024
+
+typedef struct {
+	guint64 cum_count;
+	guint64 usecs;
+} checkpoint_t;
+
+typedef struct {
+	pipeline_stage_stat_t stat;
+	checkpoint_t	ring[CHECKPOINT_RING];
+	guint64		appended;	/* checkpoints written so far */
+	guint64		cursor;		/* downstream search position */
+} stage_state_t;
+
+static gboolean      collecting;
+static stage_state_t stage_states[PIPELINE_NUM_STAGES];
+
+void
+pipeline_stats_set_enabled(gboolean enable)
+{
+	collecting = enable;
+}
+
+gboolean
+pipeline_stats_enabled(void)
+{
+	return collecting;
+}
+
+void
+pipeline_stats_reset(void)
+{
+	memset(stage_states, 0, sizeof stage_states);
+}
+
+void
+pipeline_stats_snapshot(pipeline_stage_stat_t stats[PIPELINE_NUM_STAGES])
+{
+	guint i;
+
+	for (i = 0; i < PIPELINE_NUM_STAGES; i++)
+		stats[i] = stage_states[i].stat;
+}
+
+void
+pipeline_stats_record(pipeline_stage_e stage, guint32 count)
+{
+	stage_state_t *st, *prev;
+	checkpoint_t  *cp;
+	guint64        now, lag;
+	int            p;
+
+	if (!collecting || count == 0)
+		return;
+	if ((guint)stage >= PIPELINE_NUM_STAGES)
+		return;
+
+	now = (guint64)g_get_monotonic_time();
+	st = &stage_states[stage];
+	st->stat.packets += count;
+	if (st->stat.first_usecs == 0)
+		st->stat.first_usecs = now;
+	st->stat.last_usecs = now;
+
+	cp = &st->ring[st->appended % CHECKPOINT_RING];
+	cp->cum_count = st->stat.packets;
+	cp->usecs = now;
+	st->appended++;
+
+	/* Latency vs the nearest upstream stage that's instrumented in
+	   this process. */
+	for (p = (int)stage - 1; p >= 0; p--) {
+		if (stage_states[p].stat.packets != 0)
+			break;
+	}
+	if (p < 0)
+		return;
+	prev = &stage_states[p];
+	if (prev->stat.packets < st->stat.packets) {
+		/* The upstream stage hasn't recorded this packet, so
+		   the crossing order isn't what we assume (e.g.
+		   collection was enabled mid-stream). No sample. */
+		return;
+	}
+
+	/* Find the first upstream checkpoint that covers our cumulative
+	   count. The targets only grow, so the cursor only moves
+	   forward and the search is O(1) amortized. */
+	if (prev->cursor + CHECKPOINT_RING < prev->appended)
+		prev->cursor = prev->appended - CHECKPOINT_RING;
+	while (prev->cursor < prev->appended &&
+	    prev->ring[prev->cursor % CHECKPOINT_RING].cum_count < st->stat.packets)
+		prev->cursor++;
+	if (prev->cursor >= prev->appended)
+		return;
+
+	cp = &prev->ring[prev->cursor % CHECKPOINT_RING];
+	lag = (now > cp->usecs) ? now - cp->usecs : 0;
+	st->stat.lag_usecs_sum += lag;
+	if (lag > st->stat.lag_usecs_max)
+		st->stat.lag_usecs_max = lag;
+	st->stat.lag_samples++;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
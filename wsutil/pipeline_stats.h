@@ -0,0 +1,88 @@
+/* pipeline_stats.h
+ * Per-stage counters for the capture-to-display pipeline
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __PIPELINE_STATS_H__
+#define __PIPELINE_STATS_H__
+
+#include <glib.h>
+#include "ws_symbol_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Lightweight per-stage counters for locating backpressure between the
+ * stages a packet passes through on its way to the screen. Each
+ * instrumented stage boundary calls pipeline_stats_record() with the
+ * number of packets that just crossed it; the module keeps, per stage,
+ * the cumulative packet count plus the latency of each crossing
+ * relative to when the previous instrumented stage passed the same
+ * packet.
+ *
+ * The counters only cover stages that run in the calling process:
+ * dumpcap's write stage is in a different process and is covered by the
+ * USDT tracepoints (see ws_tracepoints.h) instead. Collection is off by
+ * default and costs one predictable branch per crossing while off.
+ */
+
+typedef enum {
+	PIPELINE_STAGE_DELIVER,	/**< sync pipe announced new packets */
+	PIPELINE_STAGE_DISSECT,	/**< dissection engine entered a frame */
+	PIPELINE_STAGE_DISPLAY,	/**< frame reached the packet list or output */
+	PIPELINE_NUM_STAGES
+} pipeline_stage_e;
+
+typedef struct _pipeline_stage_stat_t {
+	guint64	packets;	/**< packets that crossed this stage so far */
+	guint64	first_usecs;	/**< monotonic time of the first crossing */
+	guint64	last_usecs;	/**< monotonic time of the latest crossing */
+	guint64	lag_usecs_sum;	/**< summed latency vs the previous stage */
+	guint64	lag_usecs_max;	/**< worst latency vs the previous stage */
+	guint64	lag_samples;	/**< crossings the lag figures cover */
+} pipeline_stage_stat_t;
+
+/** Turn collection on or off. Counters accumulated so far are kept;
+ * use pipeline_stats_reset() to discard them.
+ */
+WS_DLL_PUBLIC void pipeline_stats_set_enabled(gboolean enable);
+
+/** Is collection currently enabled? */
+WS_DLL_PUBLIC gboolean pipeline_stats_enabled(void);
+
+/** Discard all accumulated counters. */
+WS_DLL_PUBLIC void pipeline_stats_reset(void);
+
+/** Copy the accumulated counters, one element per stage, into stats. */
+WS_DLL_PUBLIC void pipeline_stats_snapshot(pipeline_stage_stat_t stats[PIPELINE_NUM_STAGES]);
+
+/** Record that count packets just crossed the given stage boundary.
+ * For use by the instrumented stage boundaries, not by dissectors.
+ */
+WS_DLL_PUBLIC void pipeline_stats_record(pipeline_stage_e stage, guint32 count);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PIPELINE_STATS_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
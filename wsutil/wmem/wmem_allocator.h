@@ -41,6 +41,11 @@ struct _wmem_allocator_t {
     void                        *private_data;
     enum _wmem_allocator_type_t  type;
     gboolean                     in_scope;
+
+    /* Bytes requested from this allocator since it was created or since
+     * the last wmem_free_all(); individual frees don't decrement it.
+     * See wmem_allocator_bytes_allocated(). */
+    guint64                      bytes_allocated;
 };
 
 #ifdef __cplusplus
@@ -28,9 +28,32 @@
 static gboolean do_override = FALSE;
 static wmem_allocator_type_t override_type;
 
+/* Running total of bytes requested from wmem_alloc() and wmem_realloc(),
+ * maintained only while tracking is on. Realloc counts the full new size
+ * since we don't know the old one; the total is an upper bound on the
+ * bytes requested, not a live-memory figure. */
+static gboolean track_allocations = FALSE;
+static guint64  bytes_allocated;
+
+void
+wmem_track_allocations(gboolean enable)
+{
+    track_allocations = enable;
+}
+
+guint64
+wmem_bytes_allocated(void)
+{
+    return bytes_allocated;
+}
+
 void *
 wmem_alloc(wmem_allocator_t *allocator, const size_t size)
 {
+    if (G_UNLIKELY(track_allocations)) {
+        bytes_allocated += size;
+    }
+
     if (allocator == NULL) {
         return g_malloc(size);
     }
@@ -41,6 +64,8 @@ wmem_alloc(wmem_allocator_t *allocator, const size_t size)
         return NULL;
     }
 
+    allocator->bytes_allocated += size;
+
     return allocator->walloc(allocator->private_data, size);
 }
 
@@ -79,10 +104,14 @@ void *
 wmem_realloc(wmem_allocator_t *allocator, void *ptr, const size_t size)
 {
     if (allocator == NULL) {
+        if (G_UNLIKELY(track_allocations)) {
+            bytes_allocated += size;
+        }
         return g_realloc(ptr, size);
     }
 
     if (ptr == NULL) {
+        /* wmem_alloc() does the tracking */
         return wmem_alloc(allocator, size);
     }
 
@@ -93,6 +122,12 @@ wmem_realloc(wmem_allocator_t *allocator, void *ptr, const size_t size)
 
     ASSERT(allocator->in_scope);
 
+    if (G_UNLIKELY(track_allocations)) {
+        bytes_allocated += size;
+    }
+
+    allocator->bytes_allocated += size;
+
     return allocator->wrealloc(allocator->private_data, ptr, size);
 }
 
@@ -102,6 +137,13 @@ wmem_free_all_real(wmem_allocator_t *allocator, gboolean final)
     wmem_call_callbacks(allocator,
             final ? WMEM_CB_DESTROY_EVENT : WMEM_CB_FREE_EVENT);
     allocator->free_all(allocator->private_data);
+    allocator->bytes_allocated = 0;
+}
+
+guint64
+wmem_allocator_bytes_allocated(wmem_allocator_t *allocator)
+{
+    return allocator->bytes_allocated;
 }
 
 void
@@ -142,6 +184,7 @@ wmem_allocator_new(const wmem_allocator_type_t type)
     allocator->type      = real_type;
     allocator->callbacks = NULL;
     allocator->in_scope  = TRUE;
+    allocator->bytes_allocated = 0;
 
     switch (real_type) {
         case WMEM_ALLOCATOR_SIMPLE:
@@ -222,6 +222,41 @@ WS_DLL_PUBLIC
 gboolean
 wmem_in_scope(wmem_allocator_t *allocator);
 
+/** Turn tracking of allocation volume on or off. While on, every call to
+ * wmem_alloc() or wmem_realloc() (in any pool) adds the requested size to a
+ * running total. Off by default; the extra cost while on is one predictable
+ * branch and an addition per allocation.
+ *
+ * @param enable TRUE to count allocations from now on, FALSE to stop.
+ */
+WS_DLL_PUBLIC
+void
+wmem_track_allocations(gboolean enable);
+
+/** Fetch the running total of bytes requested while tracking was on. The
+ * counter is never reset; callers interested in a delta should sample it
+ * twice and subtract.
+ *
+ * @return Total bytes requested from wmem while tracking was enabled.
+ */
+WS_DLL_PUBLIC
+guint64
+wmem_bytes_allocated(void);
+
+/** Fetch the bytes requested from one allocator since it was created or
+ * since its last wmem_free_all(). Individual frees don't decrement the
+ * counter, so for a long-lived pool such as the file scope this is an
+ * upper bound on the live memory it holds, and it only grows while a
+ * capture stays open.
+ *
+ * @param allocator The allocator to report on.
+ * @return Bytes requested from the allocator since creation or the last
+ * wmem_free_all().
+ */
+WS_DLL_PUBLIC
+guint64
+wmem_allocator_bytes_allocated(wmem_allocator_t *allocator);
+
 /** @} */
 
 #ifdef __cplusplus
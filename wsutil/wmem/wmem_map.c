@@ -18,7 +18,7 @@
 #include "wmem_map_int.h"
 #include "wmem_user_cb.h"
 
-static guint32 x; /* Used for universal integer hashing (see the HASH macro) */
+static guint32 x; /* Used for universal integer hashing (see wmem_map_hash_key) */
 
 /* Used for the wmem_strong_hash() function */
 static guint32 preseed;
@@ -35,11 +35,17 @@ wmem_init_hashing(void)
     postseed = g_random_int();
 }
 
-typedef struct _wmem_map_item_t {
+/* A table slot. The table is open-addressed with robin-hood probing, so
+ * keys and values are stored inline and a lookup usually touches a single
+ * cache line instead of chasing a chain of separately-allocated items.
+ * The scrambled hash is cached in the slot so that probing and growing
+ * never call the user's hash function again; the value 0 marks an empty
+ * slot (wmem_map_hash_key never returns 0). */
+typedef struct _wmem_map_slot_t {
     const void *key;
-    void *value;
-    struct _wmem_map_item_t *next;
-} wmem_map_item_t;
+    void       *value;
+    guint32     hash;
+} wmem_map_slot_t;
 
 struct _wmem_map_t {
     guint count; /* number of items stored */
@@ -50,7 +56,7 @@ struct _wmem_map_t {
      * logarithms is expensive. */
     size_t capacity;
 
-    wmem_map_item_t **table;
+    wmem_map_slot_t *table;
 
     GHashFunc  hash_func;
     GEqualFunc eql_func;
@@ -70,18 +76,32 @@ struct _wmem_map_t {
  * do the 2^x operation. */
 #define CAPACITY(MAP) (((size_t)1) << (MAP)->capacity)
 
+/* The home bucket of a scrambled hash; the top bits follow from universal
+ * hashing (see wmem_map_hash_key). */
+#define BUCKET(MAP, HASH) ((size_t)((HASH) >> (32 - (MAP)->capacity)))
+
+/* How far the entry in slot I has been displaced from its home bucket. */
+#define DISTANCE(MAP, I, HASH) \
+    (((I) + CAPACITY(MAP) - BUCKET(MAP, HASH)) & (CAPACITY(MAP) - 1))
+
 /* Efficient universal integer hashing:
  * https://en.wikipedia.org/wiki/Universal_hashing#Avoiding_modular_arithmetic
  */
-#define HASH(MAP, KEY) \
-    ((guint32)(((MAP)->hash_func(KEY) * x) >> (32 - (MAP)->capacity)))
+static inline guint32
+wmem_map_hash_key(wmem_map_t *map, const void *key)
+{
+    guint32 hash = (guint32)(map->hash_func(key)) * x;
+
+    /* 0 marks an empty slot */
+    return hash ? hash : 1;
+}
 
 static void
 wmem_map_init_table(wmem_map_t *map)
 {
     map->count     = 0;
     map->capacity  = WMEM_MAP_DEFAULT_CAPACITY;
-    map->table     = wmem_alloc0_array(map->data_allocator, wmem_map_item_t*, CAPACITY(map));
+    map->table     = wmem_alloc0_array(map->data_allocator, wmem_map_slot_t, CAPACITY(map));
 }
 
 wmem_map_t *
@@ -151,12 +171,79 @@ wmem_map_new_autoreset(wmem_allocator_t *metadata_scope, wmem_allocator_t *data_
     return map;
 }
 
+/* Find the slot holding the given key, or NULL if it is not in the map.
+ * The robin-hood invariant lets the probe stop as soon as it reaches a
+ * slot whose entry sits closer to its own home bucket than the probe has
+ * travelled: the key would have displaced that entry on insert. */
+static wmem_map_slot_t *
+wmem_map_find(wmem_map_t *map, const void *key, const guint32 hash)
+{
+    const size_t mask = CAPACITY(map) - 1;
+    size_t i = BUCKET(map, hash);
+    size_t dist = 0;
+    wmem_map_slot_t *slot;
+
+    for (;;) {
+        slot = &map->table[i];
+        if (slot->hash == 0 || DISTANCE(map, i, slot->hash) < dist) {
+            return NULL;
+        }
+        if (slot->hash == hash && map->eql_func(key, slot->key)) {
+            return slot;
+        }
+        i = (i + 1) & mask;
+        dist++;
+    }
+}
+
+/* Insert an entry known not to be in the map yet, stealing the slot of
+ * any entry that sits closer to its home bucket than we are (and then
+ * finding a new home for that entry in turn). The caller must ensure
+ * the table has a free slot. */
+static void
+wmem_map_place(wmem_map_t *map, guint32 hash, const void *key, void *value)
+{
+    const size_t mask = CAPACITY(map) - 1;
+    size_t i = BUCKET(map, hash);
+    size_t dist = 0;
+    size_t slot_dist;
+    wmem_map_slot_t *slot;
+
+    for (;;) {
+        slot = &map->table[i];
+        if (slot->hash == 0) {
+            slot->hash  = hash;
+            slot->key   = key;
+            slot->value = value;
+            return;
+        }
+        slot_dist = DISTANCE(map, i, slot->hash);
+        if (slot_dist < dist) {
+            /* Evict the better-placed entry and keep probing to find a
+             * new home for it instead. */
+            guint32     tmp_hash  = slot->hash;
+            const void *tmp_key   = slot->key;
+            void       *tmp_value = slot->value;
+
+            slot->hash  = hash;
+            slot->key   = key;
+            slot->value = value;
+
+            hash  = tmp_hash;
+            key   = tmp_key;
+            value = tmp_value;
+            dist  = slot_dist;
+        }
+        i = (i + 1) & mask;
+        dist++;
+    }
+}
+
 static inline void
 wmem_map_grow(wmem_map_t *map)
 {
-    wmem_map_item_t **old_table, *cur, *nxt;
-    size_t            old_cap, i;
-    guint             slot;
+    wmem_map_slot_t *old_table;
+    size_t           old_cap, i;
 
     /* store the old table and capacity */
     old_table = map->table;
@@ -165,17 +252,14 @@ wmem_map_grow(wmem_map_t *map)
     /* double the size (capacity is base-2 logarithm, so this just means
      * increment it) and allocate new table */
     map->capacity++;
-    map->table = wmem_alloc0_array(map->data_allocator, wmem_map_item_t*, CAPACITY(map));
+    map->table = wmem_alloc0_array(map->data_allocator, wmem_map_slot_t, CAPACITY(map));
 
-    /* copy all the elements over from the old table */
+    /* copy all the elements over from the old table; the cached hash
+     * makes this a flat pass that never calls the hash function */
     for (i=0; i<old_cap; i++) {
-        cur = old_table[i];
-        while (cur) {
-            nxt              = cur->next;
-            slot             = HASH(map, cur->key);
-            cur->next        = map->table[slot];
-            map->table[slot] = cur;
-            cur              = nxt;
+        if (old_table[i].hash != 0) {
+            wmem_map_place(map, old_table[i].hash, old_table[i].key,
+                    old_table[i].value);
         }
     }
 
@@ -186,7 +270,8 @@ wmem_map_grow(wmem_map_t *map)
 void *
 wmem_map_insert(wmem_map_t *map, const void *key, void *value)
 {
-    wmem_map_item_t **item;
+    guint32 hash;
+    wmem_map_slot_t *slot;
     void *old_val;
 
     /* Make sure we have a table */
@@ -194,34 +279,27 @@ wmem_map_insert(wmem_map_t *map, const void *key, void *value)
         wmem_map_init_table(map);
     }
 
-    /* get a pointer to the slot */
-    item = &(map->table[HASH(map, key)]);
+    hash = wmem_map_hash_key(map, key);
 
-    /* check existing items in that slot */
-    while (*item) {
-        if (map->eql_func(key, (*item)->key)) {
-            /* replace and return old value for this key */
-            old_val = (*item)->value;
-            (*item)->value = value;
-            return old_val;
-        }
-        item = &((*item)->next);
+    /* check if we already have this key */
+    slot = wmem_map_find(map, key, hash);
+    if (slot) {
+        /* replace and return old value for this key */
+        old_val = slot->value;
+        slot->value = value;
+        return old_val;
     }
 
-    /* insert new item */
-    (*item) = wmem_new(map->data_allocator, wmem_map_item_t);
-
-    (*item)->key   = key;
-    (*item)->value = value;
-    (*item)->next  = NULL;
-
-    map->count++;
-
-    /* increase size if we are over-full */
-    if (map->count >= CAPACITY(map)) {
+    /* grow first if we would exceed a 3/4 load factor, so probe
+     * sequences stay short */
+    if (map->count + 1 > CAPACITY(map) - (CAPACITY(map) >> 2)) {
         wmem_map_grow(map);
     }
 
+    /* insert new item */
+    wmem_map_place(map, hash, key, value);
+    map->count++;
+
     /* no previous entry, return NULL */
     return NULL;
 }
@@ -229,85 +307,93 @@ wmem_map_insert(wmem_map_t *map, const void *key, void *value)
 gboolean
 wmem_map_contains(wmem_map_t *map, const void *key)
 {
-    wmem_map_item_t *item;
-
     /* Make sure we have a table */
     if (map->table == NULL) {
         return FALSE;
     }
 
-    /* find correct slot */
-    item = map->table[HASH(map, key)];
-
-    /* scan list of items in this slot for the correct value */
-    while (item) {
-        if (map->eql_func(key, item->key)) {
-            return TRUE;
-        }
-        item = item->next;
-    }
-
-    return FALSE;
+    return wmem_map_find(map, key, wmem_map_hash_key(map, key)) != NULL;
 }
 
 void *
 wmem_map_lookup(wmem_map_t *map, const void *key)
 {
-    wmem_map_item_t *item;
+    wmem_map_slot_t *slot;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
         return NULL;
     }
 
-    /* find correct slot */
-    item = map->table[HASH(map, key)];
-
-    /* scan list of items in this slot for the correct value */
-    while (item) {
-        if (map->eql_func(key, item->key)) {
-            return item->value;
-        }
-        item = item->next;
-    }
+    slot = wmem_map_find(map, key, wmem_map_hash_key(map, key));
 
-    return NULL;
+    return slot ? slot->value : NULL;
 }
 
 gboolean
 wmem_map_lookup_extended(wmem_map_t *map, const void *key, const void **orig_key, void **value)
 {
-    wmem_map_item_t *item;
+    wmem_map_slot_t *slot;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
         return FALSE;
     }
 
-    /* find correct slot */
-    item = map->table[HASH(map, key)];
+    slot = wmem_map_find(map, key, wmem_map_hash_key(map, key));
+    if (slot == NULL) {
+        return FALSE;
+    }
+
+    if (orig_key) {
+        *orig_key = slot->key;
+    }
+    if (value) {
+        *value = slot->value;
+    }
+    return TRUE;
+}
 
-    /* scan list of items in this slot for the correct value */
-    while (item) {
-        if (map->eql_func(key, item->key)) {
-            if (orig_key) {
-                *orig_key = item->key;
-            }
-            if (value) {
-                *value = item->value;
-            }
-            return TRUE;
+/* Remove an entry, backward-shifting the displaced entries that follow it
+ * so no tombstones are needed and probe sequences stay contiguous.
+ * Returns FALSE if the key was not in the map. */
+static gboolean
+wmem_map_extract(wmem_map_t *map, const void *key, void **value)
+{
+    const size_t mask = CAPACITY(map) - 1;
+    wmem_map_slot_t *slot, *next;
+    size_t i, j;
+
+    slot = wmem_map_find(map, key, wmem_map_hash_key(map, key));
+    if (slot == NULL) {
+        return FALSE;
+    }
+
+    if (value) {
+        *value = slot->value;
+    }
+
+    i = (size_t)(slot - map->table);
+    for (;;) {
+        j = (i + 1) & mask;
+        next = &map->table[j];
+        if (next->hash == 0 || DISTANCE(map, j, next->hash) == 0) {
+            break;
         }
-        item = item->next;
+        map->table[i] = *next;
+        i = j;
     }
+    map->table[i].hash  = 0;
+    map->table[i].key   = NULL;
+    map->table[i].value = NULL;
 
-    return FALSE;
+    map->count--;
+    return TRUE;
 }
 
 void *
 wmem_map_remove(wmem_map_t *map, const void *key)
 {
-    wmem_map_item_t **item, *tmp;
     void *value;
 
     /* Make sure we have a table */
@@ -315,21 +401,8 @@ wmem_map_remove(wmem_map_t *map, const void *key)
         return NULL;
     }
 
-    /* get a pointer to the slot */
-    item = &(map->table[HASH(map, key)]);
-
-    /* check the items in that slot */
-    while (*item) {
-        if (map->eql_func(key, (*item)->key)) {
-            /* found it */
-            tmp     = (*item);
-            value   = tmp->value;
-            (*item) = tmp->next;
-            wmem_free(map->data_allocator, tmp);
-            map->count--;
-            return value;
-        }
-        item = &((*item)->next);
+    if (wmem_map_extract(map, key, &value)) {
+        return value;
     }
 
     /* didn't find it */
@@ -339,37 +412,20 @@ wmem_map_remove(wmem_map_t *map, const void *key)
 gboolean
 wmem_map_steal(wmem_map_t *map, const void *key)
 {
-    wmem_map_item_t **item, *tmp;
-
     /* Make sure we have a table */
     if (map->table == NULL) {
         return FALSE;
     }
 
-    /* get a pointer to the slot */
-    item = &(map->table[HASH(map, key)]);
-
-    /* check the items in that slot */
-    while (*item) {
-        if (map->eql_func(key, (*item)->key)) {
-            /* found it */
-            tmp     = (*item);
-            (*item) = tmp->next;
-            map->count--;
-            return TRUE;
-        }
-        item = &((*item)->next);
-    }
-
-    /* didn't find it */
-    return FALSE;
+    /* entries are stored inline, so stealing is removal without
+     * returning the value */
+    return wmem_map_extract(map, key, NULL);
 }
 
 wmem_list_t*
 wmem_map_get_keys(wmem_allocator_t *list_allocator, wmem_map_t *map)
 {
     size_t capacity, i;
-    wmem_map_item_t *cur;
     wmem_list_t* list = wmem_list_new(list_allocator);
 
     if (map->table != NULL) {
@@ -377,10 +433,8 @@ wmem_map_get_keys(wmem_allocator_t *list_allocator, wmem_map_t *map)
 
         /* copy all the elements into the list over from table */
         for (i=0; i<capacity; i++) {
-            cur = map->table[i];
-            while (cur) {
-                wmem_list_prepend(list, (void*)cur->key);
-                cur = cur->next;
+            if (map->table[i].hash != 0) {
+                wmem_list_prepend(list, (void*)map->table[i].key);
             }
         }
     }
@@ -391,8 +445,7 @@ wmem_map_get_keys(wmem_allocator_t *list_allocator, wmem_map_t *map)
 void
 wmem_map_foreach(wmem_map_t *map, GHFunc foreach_func, gpointer user_data)
 {
-    wmem_map_item_t *cur;
-    unsigned i;
+    size_t i;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
@@ -400,10 +453,9 @@ wmem_map_foreach(wmem_map_t *map, GHFunc foreach_func, gpointer user_data)
     }
 
     for (i = 0; i < CAPACITY(map); i++) {
-        cur = map->table[i];
-        while (cur) {
-            foreach_func((gpointer)cur->key, (gpointer)cur->value, user_data);
-            cur = cur->next;
+        if (map->table[i].hash != 0) {
+            foreach_func((gpointer)map->table[i].key,
+                    (gpointer)map->table[i].value, user_data);
         }
     }
 }
@@ -85,7 +85,10 @@ wmem_strbuf_new(wmem_allocator_t *allocator, const gchar *str)
     strbuf = wmem_strbuf_sized_new(allocator, alloc_len, 0);
 
     if (str && len > 0) {
-        (void) g_strlcpy(strbuf->str, str, alloc_len);
+        /* length already known from the strlen above; no need to walk
+         * the source again with g_strlcpy */
+        memcpy(strbuf->str, str, len);
+        strbuf->str[len] = '\0';
         strbuf->len = len;
     }
 
@@ -142,9 +145,15 @@ wmem_strbuf_append(wmem_strbuf_t *strbuf, const gchar *str)
 
     wmem_strbuf_grow(strbuf, append_len);
 
-    (void) g_strlcpy(&strbuf->str[strbuf->len], str, strbuf->max_len ? WMEM_STRBUF_RAW_ROOM(strbuf) : append_len+1);
+    /* the length is already known, so copy the bytes directly instead of
+     * walking the source a second time with g_strlcpy */
+    if (strbuf->max_len) {
+        append_len = MIN(append_len, WMEM_STRBUF_ROOM(strbuf));
+    }
 
-    strbuf->len = MIN(strbuf->len + append_len, strbuf->alloc_len - 1);
+    memcpy(&strbuf->str[strbuf->len], str, append_len);
+    strbuf->len += append_len;
+    strbuf->str[strbuf->len] = '\0';
 }
 
 void
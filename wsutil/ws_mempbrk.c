@@ -32,6 +32,13 @@ ws_mempbrk_compile(ws_mempbrk_pattern* pattern, const gchar *needles)
 {
     const gchar *n = needles;
     while (*n) {
+        if (!pattern->patt[(int)*n]) {
+            /* Record the distinct needles, so small patterns can be
+               run through memchr() instead of a byte-at-a-time loop. */
+            if (pattern->n_needles < WS_MEMPBRK_MAX_MEMCHR_NEEDLES)
+                pattern->needles[pattern->n_needles] = (guint8)*n;
+            pattern->n_needles++;
+        }
         pattern->patt[(int)*n] = 1;
         n++;
     }
@@ -60,6 +67,44 @@ ws_mempbrk_portable_exec(const guint8* haystack, size_t haystacklen, const ws_me
 }
 
 
+/*
+ * Scan for a small number of needles by running the C library's
+ * memchr() - which is vectorized on effectively every platform - once
+ * per needle and taking the earliest hit.  The scan is done in bounded
+ * chunks so that, with several needles, we never run far past the
+ * first match.
+ */
+#define MEMCHR_CHUNK 256
+
+static const guint8 *
+ws_mempbrk_memchr_exec(const guint8* haystack, size_t haystacklen, const ws_mempbrk_pattern* pattern, guchar *found_needle)
+{
+    while (haystacklen > 0) {
+        size_t chunklen = haystacklen;
+        const guint8 *best = NULL;
+        guint i;
+
+        if (pattern->n_needles > 1 && chunklen > MEMCHR_CHUNK)
+            chunklen = MEMCHR_CHUNK;
+
+        for (i = 0; i < pattern->n_needles; i++) {
+            const guint8 *p = (const guint8 *)memchr(haystack,
+                pattern->needles[i], best ? (size_t)(best - haystack) : chunklen);
+            if (p != NULL)
+                best = p;
+        }
+        if (best != NULL) {
+            if (found_needle)
+                *found_needle = *best;
+            return best;
+        }
+        haystack += chunklen;
+        haystacklen -= chunklen;
+    }
+
+    return NULL;
+}
+
 WS_DLL_PUBLIC const guint8 *
 ws_mempbrk_exec(const guint8* haystack, size_t haystacklen, const ws_mempbrk_pattern* pattern, guchar *found_needle)
 {
@@ -68,6 +113,10 @@ ws_mempbrk_exec(const guint8* haystack, size_t haystacklen, const ws_mempbrk_pat
         return ws_mempbrk_sse42_exec(haystack, haystacklen, pattern, found_needle);
 #endif
 
+    if (pattern->n_needles != 0 &&
+        pattern->n_needles <= WS_MEMPBRK_MAX_MEMCHR_NEEDLES)
+        return ws_mempbrk_memchr_exec(haystack, haystacklen, pattern, found_needle);
+
     return ws_mempbrk_portable_exec(haystack, haystacklen, pattern, found_needle);
 }
 
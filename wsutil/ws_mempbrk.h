@@ -16,6 +16,12 @@
 #include <emmintrin.h>
 #endif
 
+/** Patterns with no more than this many distinct needles can be run
+ * through the memchr()-based scan loop, which is vectorized by the C
+ * library on effectively every platform.
+ */
+#define WS_MEMPBRK_MAX_MEMCHR_NEEDLES 3
+
 /** The pattern object used for ws_mempbrk_exec().
  */
 typedef struct {
@@ -24,6 +30,8 @@ typedef struct {
     gboolean use_sse42;
     __m128i mask;
 #endif
+    guint n_needles;    /* number of distinct needles */
+    guint8 needles[WS_MEMPBRK_MAX_MEMCHR_NEEDLES];
 } ws_mempbrk_pattern;
 
 /** Compile the pattern for the needles to find using ws_mempbrk_exec().
@@ -0,0 +1,59 @@
+/* ws_tracepoints.h
+ * Static tracepoints for the capture-to-display pipeline
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __WS_TRACEPOINTS_H__
+#define __WS_TRACEPOINTS_H__
+
+/*
+ * USDT-style tracepoints at pipeline stage boundaries (capture write,
+ * sync pipe delivery, dissection entry, packet list insert), so system
+ * tracers such as perf, bpftrace or SystemTap can follow a packet
+ * through all of the processes involved without recompiling them with
+ * logging.
+ *
+ * The macros compile to nothing unless the build enables them with
+ * -DENABLE_TRACEPOINTS on a system that has <sys/sdt.h> (the
+ * systemtap-sdt-dev package on Debian-style systems). When enabled,
+ * each WS_TRACEPOINT*() expands to a single nop plus an ELF note that
+ * tracers attach to; there's no library dependency and no runtime cost
+ * until a tracer arms the probe. All probes use the provider name
+ * "wireshark".
+ */
+
+#if defined(ENABLE_TRACEPOINTS) && defined(HAVE_SYS_SDT_H)
+
+#include <sys/sdt.h>
+
+#define WS_TRACEPOINT(name)		DTRACE_PROBE(wireshark, name)
+#define WS_TRACEPOINT1(name, a)		DTRACE_PROBE1(wireshark, name, a)
+#define WS_TRACEPOINT2(name, a, b)	DTRACE_PROBE2(wireshark, name, a, b)
+
+#else /* !(ENABLE_TRACEPOINTS && HAVE_SYS_SDT_H) */
+
+#define WS_TRACEPOINT(name)		do { } while (0)
+#define WS_TRACEPOINT1(name, a)		do { } while (0)
+#define WS_TRACEPOINT2(name, a, b)	do { } while (0)
+
+#endif /* ENABLE_TRACEPOINTS && HAVE_SYS_SDT_H */
+
+#endif /* __WS_TRACEPOINTS_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
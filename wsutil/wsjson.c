@@ -26,9 +26,6 @@ gboolean
 json_validate(const guint8 *buf, const size_t len)
 {
     gboolean ret = TRUE;
-    /* We expect no more than 1024 tokens */
-    guint max_tokens = 1024;
-    jsmntok_t* t;
     jsmn_parser p;
     int rcode;
 
@@ -48,18 +45,12 @@ json_validate(const guint8 *buf, const size_t len)
         return FALSE;
     }
 
-    t = g_new0(jsmntok_t, max_tokens);
-
-    if (!t)
-        return FALSE;
-
+    /* A null token array makes jsmn validate and count tokens without
+     * storing them, so arbitrarily large documents need no memory. */
     jsmn_init(&p);
-    rcode = jsmn_parse(&p, buf, len, t, max_tokens);
+    rcode = jsmn_parse(&p, buf, len, NULL, 0);
     if (rcode < 0) {
         switch (rcode) {
-            case JSMN_ERROR_NOMEM:
-                ws_debug("not enough tokens were provided");
-                break;
             case JSMN_ERROR_INVAL:
                 ws_debug("invalid character inside JSON string");
                 break;
@@ -74,7 +65,6 @@ json_validate(const guint8 *buf, const size_t len)
         ret = FALSE;
     }
 
-    g_free(t);
     return ret;
 }
 